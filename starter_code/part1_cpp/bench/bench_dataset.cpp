@@ -0,0 +1,473 @@
+/**
+ * @file bench_dataset.cpp
+ * @brief Benchmark: the full pipeline over a manifest of mesh files
+ *
+ * Each mesh of the manifest is loaded (load_mesh()) and unwrapped with
+ * default parameters and split UV output: a few warm-up calls, then
+ * timed repetitions. Per UnwrapStats stage the fastest and the median
+ * repetition are kept, and the mesh is checked against the
+ * characteristics its manifest line expects. Results go to stdout as a
+ * table and optionally to JSON and CSV files with a fixed key and column
+ * order, so runs of two commits can be diffed. The exit status is 1 if
+ * any mesh fails to load or unwrap or misses an expectation.
+ *
+ * Manifest: one mesh per line, '#' starts a comment.
+ *
+ *   <path> [key=value ...]
+ *
+ * The path (no spaces) is relative to the manifest's directory unless
+ * absolute. Keys:
+ *   name=                display name (default: the file name)
+ *   triangles=N          expected triangle count
+ *   islands=N or N:M     expected island count, or an inclusive range
+ *   max_stretch_l2=      upper bound of UnwrapResult::stretch_l2
+ *   max_angle_distortion= upper bound of UnwrapResult::angle_distortion
+ *   max_overlap=         upper bound of UnwrapResult::overlap
+ *   min_coverage=        lower bound of UnwrapResult::coverage
+ *   max_degenerate=N     most faces the metrics may skip (default 0: a
+ *                        collapsed face always fails the mesh)
+ *   angle_threshold=, min_island_faces=, max_chart_faces=
+ *                        UnwrapParams fields for this mesh
+ *   uv_output=split|shared  UnwrapParams::uv_output (default split, so
+ *                        the metrics measure each chart rather than the
+ *                        seam vertices islands share)
+ *
+ * The result and island caches are turned off, so every repetition
+ * solves. test_data/bench_manifest.txt lists the test meshes.
+ *
+ * Usage: bench_dataset <manifest> [--warmup N] [--reps N] [--threads N]
+ *                      [--label TEXT] [--json FILE] [--csv FILE]
+ *        (defaults: 1 warm-up, 5 repetitions, one thread per core)
+ */
+
+#include "mesh.h"
+#include "mesh_formats.h"
+#include "unwrap.h"
+#include "unwrap_cache.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#define MAX_LINE 4096
+
+/** One manifest line: the mesh, its expectations and parameter overrides */
+struct DatasetEntry {
+    std::string name;
+    std::string path;
+    int line;
+    int triangles;               // -1 = not checked
+    int min_islands, max_islands;
+    double max_stretch_l2;       // < 0 = not checked
+    double max_angle_distortion;
+    double max_overlap;
+    double min_coverage;
+    int max_degenerate;
+    double angle_threshold;      // < 0 = default
+    int min_island_faces;
+    int max_chart_faces;
+    int uv_output;
+};
+
+// Timed fields of UnwrapStats, in output order
+static const struct {
+    const char* name;
+    long long UnwrapStats::*field;
+} STAGES[] = {
+    {"total", &UnwrapStats::total_ns},
+    {"topology", &UnwrapStats::topology_ns},
+    {"seams", &UnwrapStats::seams_ns},
+    {"islands", &UnwrapStats::islands_ns},
+    {"lscm", &UnwrapStats::lscm_ns},
+    {"lscm_assembly", &UnwrapStats::lscm_assembly_ns},
+    {"lscm_factor", &UnwrapStats::lscm_factor_ns},
+    {"lscm_solve", &UnwrapStats::lscm_solve_ns},
+    {"packing", &UnwrapStats::packing_ns},
+    {"metrics", &UnwrapStats::metrics_ns},
+    {"peak_bytes", &UnwrapStats::peak_bytes},
+};
+static const int NUM_STAGES = (int)(sizeof(STAGES) / sizeof(STAGES[0]));
+
+struct DatasetResult {
+    const DatasetEntry* entry;
+    bool ok;                     // loaded and unwrapped
+    std::vector<std::string> failures;
+    int triangles, vertices;
+    int islands, degenerate;
+    float stretch_l2, stretch_linf, angle_distortion, overlap, coverage;
+    int solved_islands, peak_island_faces;
+    long long matrix_nonzeros, factor_nonzeros, solver_iterations;
+    long long min[NUM_STAGES];
+    long long median[NUM_STAGES];
+};
+
+static std::string directory_of(const char* path) {
+    const char* slash = strrchr(path, '/');
+#ifdef _WIN32
+    const char* backslash = strrchr(path, '\\');
+    if (backslash && (!slash || backslash > slash)) slash = backslash;
+#endif
+    return slash ? std::string(path, slash + 1 - path) : std::string();
+}
+
+static bool parse_number(const char* text, double* out) {
+    char* end = NULL;
+    *out = strtod(text, &end);
+    return end != text && *end == '\0';
+}
+
+static bool parse_int(const char* text, int* out) {
+    char* end = NULL;
+    long value = strtol(text, &end, 10);
+    *out = (int)value;
+    return end != text && *end == '\0';
+}
+
+static bool parse_entry_option(DatasetEntry* entry, const char* key, const char* value) {
+    if (strcmp(key, "name") == 0) {
+        entry->name = value;
+        return true;
+    }
+    if (strcmp(key, "triangles") == 0) return parse_int(value, &entry->triangles);
+    if (strcmp(key, "islands") == 0) {
+        const char* colon = strchr(value, ':');
+        if (!colon) {
+            if (!parse_int(value, &entry->min_islands)) return false;
+            entry->max_islands = entry->min_islands;
+            return true;
+        }
+        std::string low(value, colon - value);
+        return parse_int(low.c_str(), &entry->min_islands) && parse_int(colon + 1, &entry->max_islands);
+    }
+    if (strcmp(key, "max_stretch_l2") == 0) return parse_number(value, &entry->max_stretch_l2);
+    if (strcmp(key, "max_angle_distortion") == 0) return parse_number(value, &entry->max_angle_distortion);
+    if (strcmp(key, "max_overlap") == 0) return parse_number(value, &entry->max_overlap);
+    if (strcmp(key, "min_coverage") == 0) return parse_number(value, &entry->min_coverage);
+    if (strcmp(key, "max_degenerate") == 0) return parse_int(value, &entry->max_degenerate);
+    if (strcmp(key, "angle_threshold") == 0) return parse_number(value, &entry->angle_threshold);
+    if (strcmp(key, "min_island_faces") == 0) return parse_int(value, &entry->min_island_faces);
+    if (strcmp(key, "max_chart_faces") == 0) return parse_int(value, &entry->max_chart_faces);
+    if (strcmp(key, "uv_output") == 0) {
+        if (strcmp(value, "split") == 0) entry->uv_output = UV_OUTPUT_SPLIT_VERTICES;
+        else if (strcmp(value, "shared") == 0) entry->uv_output = UV_OUTPUT_SHARED;
+        else return false;
+        return true;
+    }
+    return false;
+}
+
+/** Read the manifest; false (with a message) on a line it cannot parse */
+static bool read_manifest(const char* path, std::vector<DatasetEntry>* entries) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "bench_dataset: cannot open %s\n", path);
+        return false;
+    }
+    std::string base = directory_of(path);
+    char line[MAX_LINE];
+    int number = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), file)) {
+        number++;
+        char* comment = strchr(line, '#');
+        if (comment) *comment = '\0';
+        char* token = strtok(line, " \t\r\n");
+        if (!token) continue;
+
+        DatasetEntry entry;
+        entry.path = token[0] == '/' || base.empty() ? std::string(token) : base + token;
+        const char* file_name = strrchr(entry.path.c_str(), '/');
+        entry.name = file_name ? file_name + 1 : entry.path;
+        entry.line = number;
+        entry.triangles = -1;
+        entry.min_islands = -1;
+        entry.max_islands = -1;
+        entry.max_stretch_l2 = -1.0;
+        entry.max_angle_distortion = -1.0;
+        entry.max_overlap = -1.0;
+        entry.min_coverage = -1.0;
+        entry.max_degenerate = 0;
+        entry.angle_threshold = -1.0;
+        entry.min_island_faces = -1;
+        entry.max_chart_faces = -1;
+        entry.uv_output = UV_OUTPUT_SPLIT_VERTICES;
+        while ((token = strtok(NULL, " \t\r\n")) != NULL) {
+            char* equals = strchr(token, '=');
+            if (equals) *equals = '\0';
+            if (!equals || !parse_entry_option(&entry, token, equals + 1)) {
+                fprintf(stderr, "bench_dataset: %s:%d: bad option '%s'\n", path, number, token);
+                ok = false;
+                break;
+            }
+        }
+        entries->push_back(entry);
+    }
+    fclose(file);
+    return ok;
+}
+
+static long long median_of(std::vector<long long> values) {
+    std::sort(values.begin(), values.end());
+    size_t n = values.size();
+    return n % 2 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+}
+
+static void add_failure(DatasetResult* result, const char* format, double actual, double expected) {
+    char text[128];
+    snprintf(text, sizeof(text), format, actual, expected);
+    result->failures.push_back(text);
+}
+
+static void run_entry(const DatasetEntry& entry, int warmup, int reps, int threads, DatasetResult* result) {
+    memset(result->min, 0, sizeof(result->min));
+    memset(result->median, 0, sizeof(result->median));
+    result->entry = &entry;
+    result->ok = false;
+    Mesh* mesh = load_mesh(entry.path.c_str());
+    if (!mesh) {
+        result->failures.push_back("cannot load " + entry.path);
+        return;
+    }
+    result->triangles = mesh->num_triangles;
+    result->vertices = mesh->num_vertices;
+
+    UnwrapParams params;
+    unwrap_params_default(&params);
+    params.num_threads = threads;
+    params.uv_output = entry.uv_output;
+    if (entry.angle_threshold >= 0.0) params.angle_threshold = (float)entry.angle_threshold;
+    if (entry.min_island_faces >= 0) params.min_island_faces = entry.min_island_faces;
+    if (entry.max_chart_faces >= 0) params.max_chart_faces = entry.max_chart_faces;
+
+    std::vector<std::vector<long long> > samples(NUM_STAGES);
+    for (int run = 0; run < warmup + reps; run++) {
+        UnwrapResult* unwrap_result = NULL;
+        Mesh* unwrapped = unwrap_mesh(mesh, &params, &unwrap_result);
+        if (!unwrapped) {
+            result->failures.push_back("unwrap failed");
+            free_mesh(mesh);
+            return;
+        }
+        if (run >= warmup) {
+            const UnwrapStats& stats = unwrap_result->stats;
+            for (int s = 0; s < NUM_STAGES; s++) samples[s].push_back(stats.*STAGES[s].field);
+        }
+        if (run == warmup + reps - 1) {
+            // The outcome does not change between runs; keep the last
+            result->islands = unwrap_result->num_islands;
+            result->degenerate = unwrap_result->num_degenerate_faces;
+            result->stretch_l2 = unwrap_result->stretch_l2;
+            result->stretch_linf = unwrap_result->stretch_linf;
+            result->angle_distortion = unwrap_result->angle_distortion;
+            result->overlap = unwrap_result->overlap;
+            result->coverage = unwrap_result->coverage;
+            result->solved_islands = unwrap_result->stats.num_solved_islands;
+            result->peak_island_faces = unwrap_result->stats.peak_island_faces;
+            result->matrix_nonzeros = unwrap_result->stats.matrix_nonzeros;
+            result->factor_nonzeros = unwrap_result->stats.factor_nonzeros;
+            result->solver_iterations = unwrap_result->stats.solver_iterations;
+        }
+        free_unwrap_result(unwrap_result);
+        free_mesh(unwrapped);
+    }
+    free_mesh(mesh);
+    for (int s = 0; s < NUM_STAGES; s++) {
+        result->min[s] = *std::min_element(samples[s].begin(), samples[s].end());
+        result->median[s] = median_of(samples[s]);
+    }
+    result->ok = true;
+
+    if (entry.triangles >= 0 && result->triangles != entry.triangles) {
+        add_failure(result, "triangles %.0f, expected %.0f", result->triangles, entry.triangles);
+    }
+    if (entry.min_islands >= 0 && (result->islands < entry.min_islands || result->islands > entry.max_islands)) {
+        char text[128];
+        snprintf(text, sizeof(text), "islands %d, expected %d:%d", result->islands, entry.min_islands,
+                 entry.max_islands);
+        result->failures.push_back(text);
+    }
+    if (result->degenerate > entry.max_degenerate) {
+        add_failure(result, "%.0f degenerate faces, at most %.0f", result->degenerate, entry.max_degenerate);
+    }
+    // Written so a NaN metric fails too
+    if (entry.max_stretch_l2 >= 0.0 && !(result->stretch_l2 <= entry.max_stretch_l2)) {
+        add_failure(result, "stretch_l2 %g above %g", result->stretch_l2, entry.max_stretch_l2);
+    }
+    if (entry.max_angle_distortion >= 0.0 && !(result->angle_distortion <= entry.max_angle_distortion)) {
+        add_failure(result, "angle_distortion %g above %g", result->angle_distortion, entry.max_angle_distortion);
+    }
+    if (entry.max_overlap >= 0.0 && !(result->overlap <= entry.max_overlap)) {
+        add_failure(result, "overlap %g above %g", result->overlap, entry.max_overlap);
+    }
+    if (entry.min_coverage >= 0.0 && !(result->coverage >= entry.min_coverage)) {
+        add_failure(result, "coverage %g below %g", result->coverage, entry.min_coverage);
+    }
+}
+
+/** s as a JSON string literal */
+static std::string json_string(const std::string& s) {
+    std::string out = "\"";
+    for (size_t i = 0; i < s.size(); i++) {
+        unsigned char c = (unsigned char)s[i];
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += (char)c;
+        } else if (c < 0x20) {
+            char escape[8];
+            snprintf(escape, sizeof(escape), "\\u%04x", c);
+            out += escape;
+        } else {
+            out += (char)c;
+        }
+    }
+    return out + "\"";
+}
+
+/** A metric as a JSON number; +inf (nothing measured) and NaN become null */
+static std::string json_number(double value) {
+    if (!std::isfinite(value)) return "null";
+    char text[32];
+    snprintf(text, sizeof(text), "%.6g", value);
+    return text;
+}
+
+static const char* status_of(const DatasetResult& result) {
+    return !result.ok ? "error" : result.failures.empty() ? "pass" : "fail";
+}
+
+static bool write_json(const char* path, const char* manifest, const char* label, int warmup, int reps,
+                       int threads, const std::vector<DatasetResult>& results) {
+    FILE* out = fopen(path, "w");
+    if (!out) return false;
+    fprintf(out, "{\n  \"label\": %s,\n  \"manifest\": %s,\n", json_string(label).c_str(),
+            json_string(manifest).c_str());
+    fprintf(out, "  \"threads\": %d,\n  \"warmup\": %d,\n  \"repetitions\": %d,\n  \"meshes\": [", threads, warmup,
+            reps);
+    for (size_t i = 0; i < results.size(); i++) {
+        const DatasetResult& r = results[i];
+        fprintf(out, "%s\n    {\n      \"name\": %s,\n      \"path\": %s,\n      \"status\": \"%s\",\n",
+                i ? "," : "", json_string(r.entry->name).c_str(), json_string(r.entry->path).c_str(), status_of(r));
+        fprintf(out, "      \"failures\": [");
+        for (size_t f = 0; f < r.failures.size(); f++) {
+            fprintf(out, "%s%s", f ? ", " : "", json_string(r.failures[f]).c_str());
+        }
+        fprintf(out, "]");
+        if (r.ok) {
+            fprintf(out, ",\n      \"triangles\": %d,\n      \"vertices\": %d,\n      \"islands\": %d,\n",
+                    r.triangles, r.vertices, r.islands);
+            fprintf(out, "      \"quality\": {\"stretch_l2\": %s, \"stretch_linf\": %s, "
+                    "\"angle_distortion\": %s, \"overlap\": %s, \"coverage\": %s, \"degenerate_faces\": %d},\n",
+                    json_number(r.stretch_l2).c_str(), json_number(r.stretch_linf).c_str(),
+                    json_number(r.angle_distortion).c_str(), json_number(r.overlap).c_str(),
+                    json_number(r.coverage).c_str(), r.degenerate);
+            fprintf(out, "      \"counters\": {\"solved_islands\": %d, \"peak_island_faces\": %d, "
+                    "\"matrix_nonzeros\": %lld, \"factor_nonzeros\": %lld, \"solver_iterations\": %lld},\n",
+                    r.solved_islands, r.peak_island_faces, r.matrix_nonzeros, r.factor_nonzeros,
+                    r.solver_iterations);
+            fprintf(out, "      \"stages\": {");
+            for (int s = 0; s < NUM_STAGES; s++) {
+                fprintf(out, "%s\n        \"%s\": {\"min\": %lld, \"median\": %lld}", s ? "," : "", STAGES[s].name,
+                        r.min[s], r.median[s]);
+            }
+            fprintf(out, "\n      }");
+        }
+        fprintf(out, "\n    }");
+    }
+    fprintf(out, "\n  ]\n}\n");
+    return fclose(out) == 0;
+}
+
+static bool write_csv(const char* path, const char* label, const std::vector<DatasetResult>& results) {
+    FILE* out = fopen(path, "w");
+    if (!out) return false;
+    fprintf(out, "label,name,status,triangles,vertices,islands,stretch_l2,stretch_linf,angle_distortion,"
+            "overlap,coverage,degenerate_faces");
+    for (int s = 0; s < NUM_STAGES; s++) fprintf(out, ",%s_min,%s_median", STAGES[s].name, STAGES[s].name);
+    fprintf(out, "\n");
+    for (size_t i = 0; i < results.size(); i++) {
+        const DatasetResult& r = results[i];
+        // Names and labels are written as they are: keep commas out of them
+        fprintf(out, "%s,%s,%s", label, r.entry->name.c_str(), status_of(r));
+        if (r.ok) {
+            fprintf(out, ",%d,%d,%d,%.6g,%.6g,%.6g,%.6g,%.6g,%d", r.triangles, r.vertices, r.islands, r.stretch_l2,
+                    r.stretch_linf, r.angle_distortion, r.overlap, r.coverage, r.degenerate);
+            for (int s = 0; s < NUM_STAGES; s++) fprintf(out, ",%lld,%lld", r.min[s], r.median[s]);
+        } else {
+            for (int c = 0; c < 9 + 2 * NUM_STAGES; c++) fprintf(out, ",");
+        }
+        fprintf(out, "\n");
+    }
+    return fclose(out) == 0;
+}
+
+int main(int argc, char** argv) {
+    const char* manifest = NULL;
+    const char* json_path = NULL;
+    const char* csv_path = NULL;
+    const char* label = "";
+    int warmup = 1, reps = 5, threads = 0;
+    for (int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--warmup") == 0 && has_value) {
+            warmup = std::max(0, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--reps") == 0 && has_value) {
+            reps = std::max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--threads") == 0 && has_value) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--label") == 0 && has_value) {
+            label = argv[++i];
+        } else if (strcmp(argv[i], "--json") == 0 && has_value) {
+            json_path = argv[++i];
+        } else if (strcmp(argv[i], "--csv") == 0 && has_value) {
+            csv_path = argv[++i];
+        } else if (argv[i][0] != '-' && !manifest) {
+            manifest = argv[i];
+        } else {
+            manifest = NULL;
+            break;
+        }
+    }
+    if (!manifest) {
+        fprintf(stderr, "usage: bench_dataset <manifest> [--warmup N] [--reps N] [--threads N] "
+                        "[--label TEXT] [--json FILE] [--csv FILE]\n");
+        return 2;
+    }
+    std::vector<DatasetEntry> entries;
+    if (!read_manifest(manifest, &entries)) return 2;
+
+    unwrap_cache_configure(NULL, 0);
+    unwrap_island_cache_configure(0, 0);
+
+    std::vector<DatasetResult> results(entries.size());
+    int failed = 0;
+    printf("%-24s %9s %7s %10s %10s %12s %12s  %s\n", "mesh", "triangles", "islands", "stretch", "angle",
+           "total ms", "lscm ms", "status");
+    for (size_t i = 0; i < entries.size(); i++) {
+        DatasetResult& r = results[i];
+        run_entry(entries[i], warmup, reps, threads, &r);
+        if (!r.ok || !r.failures.empty()) failed++;
+        if (r.ok) {
+            printf("%-24s %9d %7d %10.4f %10.4f %12.3f %12.3f  %s\n", entries[i].name.c_str(), r.triangles,
+                   r.islands, r.stretch_l2, r.angle_distortion, r.median[0] * 1e-6, r.median[4] * 1e-6,
+                   status_of(r));
+        } else {
+            printf("%-24s %9s %7s %10s %10s %12s %12s  %s\n", entries[i].name.c_str(), "-", "-", "-", "-", "-", "-",
+                   status_of(r));
+        }
+        for (size_t f = 0; f < r.failures.size(); f++) printf("    %s\n", r.failures[f].c_str());
+    }
+
+    if (json_path && !write_json(json_path, manifest, label, warmup, reps, threads, results)) {
+        fprintf(stderr, "bench_dataset: cannot write %s\n", json_path);
+        return 2;
+    }
+    if (csv_path && !write_csv(csv_path, label, results)) {
+        fprintf(stderr, "bench_dataset: cannot write %s\n", csv_path);
+        return 2;
+    }
+    printf("%d of %d meshes passed\n", (int)entries.size() - failed, (int)entries.size());
+    return failed ? 1 : 0;
+}
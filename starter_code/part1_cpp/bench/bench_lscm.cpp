@@ -0,0 +1,331 @@
+/**
+ * @file bench_lscm.cpp
+ * @brief Benchmark: LSCM solver backends
+ *
+ * Times lscm_parameterize_with_options() with every compiled-in backend
+ * on the test meshes (whole mesh as one island) and on a synthetic open
+ * grid, and reports the factor fill-in (direct) or iteration count (CG).
+ * Then compares double, float and refined-float precision for SimplicialLDLT
+ * and CG: time, the resulting stretch and the largest UV deviation from
+ * the double solve, and the fill-reducing orderings for SimplicialLDLT and
+ * SparseLU: factor size, the first solve (ordering and symbolic analysis
+ * included) and a repeated one through a plan (numeric factorisation only).
+ * Last, on a grid with shuffled vertices and faces (a scanner-like
+ * layout), the island vertex orders: assembly, factorisation and solve
+ * times per order, and build_topology() before and after reorder_mesh().
+ *
+ * Usage: bench_lscm [grid_side]   (default 999 -> 1M vertices)
+ */
+
+#include "mesh.h"
+#include "lscm.h"
+#include "unwrap.h"
+#include "topology.h"
+#include "mesh_reorder.h"
+#include "mesh_generators.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#ifndef TEST_DATA_DIR
+#define TEST_DATA_DIR "../test_data/meshes/"
+#endif
+
+static const struct {
+    LscmSolver solver;
+    const char* name;
+} SOLVERS[] = {
+    {LSCM_SOLVER_LU, "lu"},
+    {LSCM_SOLVER_LDLT, "ldlt"},
+    {LSCM_SOLVER_LLT, "llt"},
+    {LSCM_SOLVER_CHOLMOD, "cholmod"},
+    {LSCM_SOLVER_PARDISO, "pardiso"},
+    {LSCM_SOLVER_CG, "cg"},
+    {LSCM_SOLVER_MULTIGRID, "multigrid"},
+    {LSCM_SOLVER_CUDA_CG, "cuda_cg"},
+};
+
+static void bench_mesh(const char* name, const Mesh* mesh) {
+    std::vector<int> faces(mesh->num_triangles);
+    for (int i = 0; i < mesh->num_triangles; i++) faces[i] = i;
+
+    printf("\n%s: %d vertices, %d triangles\n", name, mesh->num_vertices, mesh->num_triangles);
+    printf("%-10s %12s %16s %8s\n", "solver", "seconds", "factor nnz", "iters");
+
+    for (size_t s = 0; s < sizeof(SOLVERS) / sizeof(SOLVERS[0]); s++) {
+        if (!lscm_solver_available(SOLVERS[s].solver)) continue;
+
+        LscmOptions options;
+        lscm_options_default(&options);
+        options.solver = SOLVERS[s].solver;
+        LscmReport report = {};
+
+        auto start = std::chrono::steady_clock::now();
+        float* uvs = lscm_parameterize_with_options(mesh, faces.data(), mesh->num_triangles,
+                                                    &options, &report);
+        auto end = std::chrono::steady_clock::now();
+
+        if (!uvs) {
+            printf("%-10s %12s\n", SOLVERS[s].name, "failed");
+            continue;
+        }
+        free(uvs);
+        printf("%-10s %12.4f %16lld %8d\n", SOLVERS[s].name,
+               std::chrono::duration<double>(end - start).count(), report.factor_nonzeros,
+               report.iterations);
+    }
+
+    // Repeated solve of the same connectivity: only the first pays for
+    // the ordering and symbolic factorisation
+    LscmPlan* plan = lscm_plan_create(0);
+    LscmOptions options;
+    lscm_options_default(&options);
+    options.solver = LSCM_SOLVER_LDLT;
+    options.plan = plan;
+    for (int rep = 0; rep < 2; rep++) {
+        auto start = std::chrono::steady_clock::now();
+        float* uvs = lscm_parameterize_with_options(mesh, faces.data(), mesh->num_triangles, &options, NULL);
+        auto end = std::chrono::steady_clock::now();
+        free(uvs);
+        printf("%-10s %12.4f\n", rep == 0 ? "ldlt/plan" : "ldlt/warm",
+               std::chrono::duration<double>(end - start).count());
+    }
+    lscm_plan_free(plan);
+}
+
+static const struct {
+    LscmPrecision precision;
+    const char* name;
+} PRECISIONS[] = {
+    {LSCM_PRECISION_DOUBLE, "double"},
+    {LSCM_PRECISION_FLOAT, "float"},
+    {LSCM_PRECISION_FLOAT_REFINED, "refined"},
+};
+
+static void bench_precision(const Mesh* mesh) {
+    std::vector<int> faces(mesh->num_triangles);
+    for (int i = 0; i < mesh->num_triangles; i++) faces[i] = i;
+    int capacity = mesh->num_triangles * 3;
+
+    printf("%-10s %-8s %12s %10s %10s %12s\n", "solver", "prec", "seconds", "L2", "angle", "max |duv|");
+    const LscmSolver solvers[] = {LSCM_SOLVER_LDLT, LSCM_SOLVER_CG};
+    for (size_t s = 0; s < sizeof(solvers) / sizeof(solvers[0]); s++) {
+        std::vector<float> reference;
+        for (size_t p = 0; p < sizeof(PRECISIONS) / sizeof(PRECISIONS[0]); p++) {
+            LscmOptions options;
+            lscm_options_default(&options);
+            options.solver = solvers[s];
+            options.precision = PRECISIONS[p].precision;
+
+            std::vector<float> local(capacity * 2);
+            std::vector<int> order(capacity);
+            auto start = std::chrono::steady_clock::now();
+            int n = lscm_parameterize_into(mesh, faces.data(), mesh->num_triangles, &options, NULL,
+                                           local.data(), order.data(), NULL);
+            auto end = std::chrono::steady_clock::now();
+            if (n < 0) {
+                printf("%-10s %-8s %12s\n", SOLVERS[s == 0 ? 1 : 5].name, PRECISIONS[p].name, "failed");
+                continue;
+            }
+
+            // Stretch of the island's map, in mesh vertex order
+            std::vector<float> uvs(mesh->num_vertices * 2, 0.0f);
+            for (int i = 0; i < n; i++) {
+                uvs[order[i] * 2 + 0] = local[i * 2 + 0];
+                uvs[order[i] * 2 + 1] = local[i * 2 + 1];
+            }
+            Mesh mapped = *mesh;
+            mapped.uvs = uvs.data();
+            UnwrapResult result;
+            memset(&result, 0, sizeof(result));
+            result.num_islands = 1;
+            compute_quality_metrics(&mapped, &result);
+
+            if (p == 0) reference = uvs;
+            float deviation = 0.0f;
+            for (size_t i = 0; i < uvs.size(); i++) deviation = std::max(deviation, fabsf(uvs[i] - reference[i]));
+
+            printf("%-10s %-8s %12.4f %10.6f %10.6f %12.3e\n", SOLVERS[s == 0 ? 1 : 5].name, PRECISIONS[p].name,
+                   std::chrono::duration<double>(end - start).count(), result.stretch_l2,
+                   result.angle_distortion, deviation);
+        }
+    }
+}
+
+static const struct {
+    LscmOrdering ordering;
+    const char* name;
+} ORDERINGS[] = {
+    {LSCM_ORDERING_AMD, "amd"},
+    {LSCM_ORDERING_COLAMD, "colamd"},
+    {LSCM_ORDERING_METIS, "metis"},
+    {LSCM_ORDERING_NATURAL, "natural"},
+};
+
+static void bench_ordering(const Mesh* mesh) {
+    std::vector<int> faces(mesh->num_triangles);
+    for (int i = 0; i < mesh->num_triangles; i++) faces[i] = i;
+
+    printf("%-10s %-8s %16s %12s %12s\n", "solver", "ordering", "factor nnz", "first s", "repeat s");
+    const LscmSolver solvers[] = {LSCM_SOLVER_LDLT, LSCM_SOLVER_LU};
+    for (size_t s = 0; s < sizeof(solvers) / sizeof(solvers[0]); s++) {
+        for (size_t o = 0; o < sizeof(ORDERINGS) / sizeof(ORDERINGS[0]); o++) {
+            if (!lscm_ordering_available(ORDERINGS[o].ordering)) continue;
+
+            LscmPlan* plan = lscm_plan_create(0);
+            LscmOptions options;
+            lscm_options_default(&options);
+            options.solver = solvers[s];
+            options.ordering = ORDERINGS[o].ordering;
+            options.plan = plan;
+            double seconds[2] = {0.0, 0.0};
+            LscmReport report;
+            memset(&report, 0, sizeof(report));
+            bool ok = true;
+            for (int rep = 0; rep < 2 && ok; rep++) {
+                auto start = std::chrono::steady_clock::now();
+                float* uvs = lscm_parameterize_with_options(mesh, faces.data(), mesh->num_triangles, &options,
+                                                            &report);
+                auto end = std::chrono::steady_clock::now();
+                ok = uvs != NULL;
+                free(uvs);
+                seconds[rep] = std::chrono::duration<double>(end - start).count();
+            }
+            lscm_plan_free(plan);
+
+            const char* solver_name = SOLVERS[s == 0 ? 1 : 0].name;
+            if (!ok) {
+                printf("%-10s %-8s %16s\n", solver_name, ORDERINGS[o].name, "failed");
+                continue;
+            }
+            printf("%-10s %-8s %16lld %12.4f %12.4f\n", solver_name, ORDERINGS[o].name, report.factor_nonzeros,
+                   seconds[0], seconds[1]);
+        }
+    }
+}
+
+/** Copy of mesh with vertices and faces in a fixed pseudo-random order */
+static Mesh* shuffled_copy(const Mesh* mesh) {
+    int V = mesh->num_vertices;
+    int F = mesh->num_triangles;
+    std::vector<int> vertex_order(V), face_order(F), remap(V);
+    for (int i = 0; i < V; i++) vertex_order[i] = i;
+    for (int i = 0; i < F; i++) face_order[i] = i;
+    uint32_t state = 12345;
+    auto next = [&state](int bound) {
+        state = state * 1664525u + 1013904223u;
+        return (int)((uint64_t)state * (uint32_t)bound >> 32);
+    };
+    for (int i = V - 1; i > 0; i--) std::swap(vertex_order[i], vertex_order[next(i + 1)]);
+    for (int i = F - 1; i > 0; i--) std::swap(face_order[i], face_order[next(i + 1)]);
+    for (int i = 0; i < V; i++) remap[vertex_order[i]] = i;
+
+    Mesh* out = (Mesh*)malloc(sizeof(Mesh));
+    out->num_vertices = V;
+    out->num_triangles = F;
+    out->vertices = (float*)malloc((size_t)V * 3 * sizeof(float));
+    out->triangles = (int*)malloc((size_t)F * 3 * sizeof(int));
+    out->uvs = NULL;
+    for (int i = 0; i < V; i++) memcpy(&out->vertices[i * 3], &mesh->vertices[vertex_order[i] * 3], 3 * sizeof(float));
+    for (int i = 0; i < F; i++) {
+        for (int k = 0; k < 3; k++) out->triangles[i * 3 + k] = remap[mesh->triangles[face_order[i] * 3 + k]];
+    }
+    return out;
+}
+
+static const struct {
+    VertexOrder order;
+    const char* name;
+} VERTEX_ORDERS[] = {
+    {VERTEX_ORDER_INPUT, "input"},
+    {VERTEX_ORDER_RCM, "rcm"},
+    {VERTEX_ORDER_MORTON, "morton"},
+};
+
+static void bench_vertex_order(const Mesh* mesh) {
+    Mesh* shuffled = shuffled_copy(mesh);
+    std::vector<int> faces(shuffled->num_triangles);
+    for (int i = 0; i < shuffled->num_triangles; i++) faces[i] = i;
+
+    printf("\nshuffled grid: %d vertices, %d triangles\n", shuffled->num_vertices, shuffled->num_triangles);
+    printf("%-10s %-8s %12s %12s %12s %12s\n", "solver", "order", "assembly s", "factor s", "solve s", "total s");
+    const LscmSolver solvers[] = {LSCM_SOLVER_LDLT, LSCM_SOLVER_CG};
+    const char* solver_names[] = {"ldlt", "cg"};
+    for (size_t s = 0; s < sizeof(solvers) / sizeof(solvers[0]); s++) {
+        for (size_t o = 0; o < sizeof(VERTEX_ORDERS) / sizeof(VERTEX_ORDERS[0]); o++) {
+            LscmOptions options;
+            lscm_options_default(&options);
+            options.solver = solvers[s];
+            options.vertex_order = VERTEX_ORDERS[o].order;
+            LscmReport report;
+            memset(&report, 0, sizeof(report));
+            auto start = std::chrono::steady_clock::now();
+            float* uvs = lscm_parameterize_with_options(shuffled, faces.data(), shuffled->num_triangles, &options,
+                                                        &report);
+            auto end = std::chrono::steady_clock::now();
+            if (!uvs) {
+                printf("%-10s %-8s %12s\n", solver_names[s], VERTEX_ORDERS[o].name, "failed");
+                continue;
+            }
+            free(uvs);
+            printf("%-10s %-8s %12.4f %12.4f %12.4f %12.4f\n", solver_names[s], VERTEX_ORDERS[o].name,
+                   report.assembly_ns * 1e-9, report.factor_ns * 1e-9, report.solve_ns * 1e-9,
+                   std::chrono::duration<double>(end - start).count());
+        }
+    }
+
+    // Whole-mesh reorder pays for itself if the adjacency passes after it get faster
+    for (size_t o = 0; o < sizeof(VERTEX_ORDERS) / sizeof(VERTEX_ORDERS[0]); o++) {
+        auto start = std::chrono::steady_clock::now();
+        Mesh* reordered = reorder_mesh(shuffled, VERTEX_ORDERS[o].order, NULL, NULL);
+        auto mid = std::chrono::steady_clock::now();
+        TopologyInfo* topo = build_topology(reordered);
+        auto end = std::chrono::steady_clock::now();
+        printf("reorder %-8s %10.4f s, build_topology %10.4f s\n", VERTEX_ORDERS[o].name,
+               std::chrono::duration<double>(mid - start).count(), std::chrono::duration<double>(end - mid).count());
+        free_topology(topo);
+        free_mesh(reordered);
+    }
+    free_mesh(shuffled);
+}
+
+int main(int argc, char** argv) {
+    int side = argc > 1 ? atoi(argv[1]) : 999;
+
+    const char* meshes[] = {"01_cube.obj", "02_cylinder.obj", "03_sphere.obj", "04_torus.obj"};
+    for (size_t i = 0; i < sizeof(meshes) / sizeof(meshes[0]); i++) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s%s", TEST_DATA_DIR, meshes[i]);
+        Mesh* mesh = load_obj(path);
+        if (!mesh) continue;
+        bench_mesh(meshes[i], mesh);
+        bench_precision(mesh);
+        bench_ordering(mesh);
+        free_mesh(mesh);
+    }
+
+    if (side > 0) {
+        Mesh* grid = gen_grid(side, side);
+        bench_mesh("grid", grid);
+        bench_precision(grid);
+        bench_ordering(grid);
+        free_mesh(grid);
+
+        // Holes give the irregular boundaries of scan meshes, where the
+        // orderings differ most
+        Mesh* holes = gen_grid_with_holes(side / 2, side / 2, 8);
+        bench_mesh("grid with holes", holes);
+        bench_ordering(holes);
+        free_mesh(holes);
+
+        Mesh* locality = gen_grid(side / 2, side / 2);
+        bench_vertex_order(locality);
+        free_mesh(locality);
+    }
+    return 0;
+}
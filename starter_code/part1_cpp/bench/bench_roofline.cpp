@@ -0,0 +1,281 @@
+/**
+ * @file bench_roofline.cpp
+ * @brief Benchmark: roofline of the LSCM stages
+ *
+ * Measures the machine's roofs first: memory bandwidth with a STREAM
+ * triad over arrays well past the last-level cache, and double-precision
+ * throughput with independent multiply-add chains, each on one core and
+ * on all of them. Then solves open grids of growing size as one island
+ * with SimplicialLDLT through a plan and, per stage, puts the model's
+ * flops and bytes against the measured time:
+ *
+ *   assembly   ~140 flops per face (edges, frame, coefficients, 9 blocks
+ *              and their 36 scatters); reads the faces and their vertices,
+ *              clears and writes A and b
+ *   ordering   the first factorisation minus a repeated one (AMD and the
+ *              symbolic analysis); integer work over A's pattern
+ *   factor     sum of c_j (c_j + 3) over the factor's columns, c_j the
+ *              column count; reads A, writes L
+ *   solve      two triangular sweeps and the diagonal, 4 nnz(L) + n;
+ *              reads L twice
+ *
+ * The column counts come from an Eigen SimplicialLDLT with AMD on a
+ * matrix of the same pattern (the grid's 2x2 vertex blocks); its nnz(L)
+ * is printed next to the library's so the model can be checked. Bytes are
+ * compulsory traffic, each array touched once, so the arithmetic
+ * intensities are upper bounds and the GB/s lower bounds. Times are the
+ * best of several runs. An island solve runs on one core, so its stages
+ * are compared with the one-core roofs; the ridge point is where the
+ * bandwidth roof meets the compute roof, and a stage whose intensity lies
+ * left of it cannot be compute-bound. The smallest grid stays in cache,
+ * where a stage can run past the DRAM roof.
+ *
+ * The probes are compiled with this target's flags, not the library's
+ * (UVUNWRAP_NATIVE_ARCH applies only to uvunwrap).
+ *
+ * Usage: bench_roofline [grid_side] [runs]   (default 512 -> 263k vertices, 3 runs)
+ */
+
+#include "mesh.h"
+#include "lscm.h"
+#include "mesh_generators.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+
+// Triad arrays: 3 x 64 MiB, well past any last-level cache
+static const size_t STREAM_ELEMENTS = (size_t)1 << 23;
+static const int STREAM_RUNS = 5;
+// Independent accumulators per thread: enough to hide the add latency
+// and fill the vector lanes
+static const int FLOP_LANES = 32;
+static const long long FLOP_STEPS = 20000000;
+static const double ASSEMBLY_FLOPS_PER_FACE = 140.0;
+
+static double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/** Run body(thread) on num_threads threads and return the wall time */
+template <typename Body>
+static double timed_parallel(int num_threads, Body body) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 1; t < num_threads; t++) threads.emplace_back(body, t);
+    body(0);
+    for (size_t t = 0; t < threads.size(); t++) threads[t].join();
+    return seconds_since(start);
+}
+
+/** STREAM triad a = b + s c in GB/s (24 bytes per element, as STREAM counts) */
+static double probe_bandwidth(int num_threads) {
+    std::vector<double> a(STREAM_ELEMENTS), b(STREAM_ELEMENTS, 1.0), c(STREAM_ELEMENTS, 2.0);
+    size_t chunk = (STREAM_ELEMENTS + num_threads - 1) / num_threads;
+    auto first_touch = [&](int t) {
+        size_t begin = std::min(STREAM_ELEMENTS, t * chunk), end = std::min(STREAM_ELEMENTS, begin + chunk);
+        for (size_t i = begin; i < end; i++) a[i] = 0.0;
+    };
+    timed_parallel(num_threads, first_touch);
+
+    double best = 1e30;
+    for (int run = 0; run < STREAM_RUNS; run++) {
+        const double s = 3.0;
+        auto triad = [&](int t) {
+            size_t begin = std::min(STREAM_ELEMENTS, t * chunk), end = std::min(STREAM_ELEMENTS, begin + chunk);
+            double* pa = a.data();
+            const double* pb = b.data();
+            const double* pc = c.data();
+            for (size_t i = begin; i < end; i++) pa[i] = pb[i] + s * pc[i];
+        };
+        best = std::min(best, timed_parallel(num_threads, triad));
+    }
+    volatile double sink = a[STREAM_ELEMENTS / 2];
+    (void)sink;
+    return 24.0 * (double)STREAM_ELEMENTS / best * 1e-9;
+}
+
+/** Multiply-add chains x = x m + a in GFLOP/s (2 flops per step and lane) */
+static double probe_flops(int num_threads) {
+    std::vector<double> results(num_threads);
+    double best = 1e30;
+    for (int run = 0; run < 3; run++) {
+        auto chains = [&](int t) {
+            double x[FLOP_LANES];
+            for (int j = 0; j < FLOP_LANES; j++) x[j] = 1.0 + j * 1e-3;
+            const double m = 0.9999999, add = 1e-7;
+            for (long long s = 0; s < FLOP_STEPS; s++) {
+                for (int j = 0; j < FLOP_LANES; j++) x[j] = x[j] * m + add;
+            }
+            double sum = 0.0;
+            for (int j = 0; j < FLOP_LANES; j++) sum += x[j];
+            results[t] = sum;
+        };
+        best = std::min(best, timed_parallel(num_threads, chains));
+    }
+    volatile double sink = results[0];
+    (void)sink;
+    return 2.0 * FLOP_LANES * (double)FLOP_STEPS * num_threads / best * 1e-9;
+}
+
+struct FactorModel {
+    long long nonzeros;          // strictly lower entries of L
+    double flops;
+};
+
+/** Column counts of an AMD-ordered LDLT of the mesh's 2x2 vertex-block pattern */
+static FactorModel factor_model(const Mesh* mesh) {
+    typedef Eigen::SparseMatrix<double> SpMat;
+    int n = mesh->num_vertices * 2;
+    std::vector<Eigen::Triplet<double> > entries;
+    entries.reserve((size_t)mesh->num_triangles * 36 + n);
+    // A graph Laplacian plus the identity: positive definite, with LSCM's pattern
+    for (int f = 0; f < mesh->num_triangles; f++) {
+        const int* tri = &mesh->triangles[f * 3];
+        for (int k = 0; k < 3; k++) {
+            for (int l = 0; l < 3; l++) {
+                for (int p = 0; p < 2; p++) {
+                    for (int q = 0; q < 2; q++) {
+                        double value = p != q ? 0.0 : k == l ? 2.0 : -1.0;
+                        entries.push_back(Eigen::Triplet<double>(2 * tri[k] + p, 2 * tri[l] + q, value));
+                    }
+                }
+            }
+        }
+    }
+    for (int i = 0; i < n; i++) entries.push_back(Eigen::Triplet<double>(i, i, 1.0));
+    SpMat A(n, n);
+    A.setFromTriplets(entries.begin(), entries.end());
+
+    Eigen::SimplicialLDLT<SpMat, Eigen::Lower, Eigen::AMDOrdering<int> > ldlt(A);
+    FactorModel model = {0, 0.0};
+    if (ldlt.info() != Eigen::Success) return model;
+    const SpMat& L = ldlt.matrixL().nestedExpression();
+    for (int j = 0; j < L.outerSize(); j++) {
+        long long count = 0;
+        for (SpMat::InnerIterator it(L, j); it; ++it) count += it.row() > j;
+        model.nonzeros += count;
+        model.flops += (double)count * (double)(count + 3);
+    }
+    return model;
+}
+
+struct StageTimes {
+    long long assembly_ns;
+    long long ordering_ns;
+    long long factor_ns;
+    long long solve_ns;
+    LscmReport report;
+};
+
+/** Best of runs plan-warm solves, plus the ordering from the first (cold) one */
+static bool measure_stages(const Mesh* mesh, int runs, StageTimes* out) {
+    std::vector<int> faces(mesh->num_triangles);
+    for (int i = 0; i < mesh->num_triangles; i++) faces[i] = i;
+    LscmPlan* plan = lscm_plan_create(0);
+    LscmOptions options;
+    lscm_options_default(&options);
+    options.solver = LSCM_SOLVER_LDLT;
+    options.plan = plan;
+
+    long long cold_factor_ns = 0;
+    bool ok = true;
+    for (int run = 0; run <= runs && ok; run++) {
+        LscmReport report;
+        memset(&report, 0, sizeof(report));
+        float* uvs = lscm_parameterize_with_options(mesh, faces.data(), mesh->num_triangles, &options, &report);
+        ok = uvs != NULL && report.solver == LSCM_SOLVER_LDLT;
+        free(uvs);
+        if (run == 0) {
+            cold_factor_ns = report.factor_ns;
+            out->report = report;
+            continue;
+        }
+        if (run == 1 || report.assembly_ns < out->assembly_ns) out->assembly_ns = report.assembly_ns;
+        if (run == 1 || report.factor_ns < out->factor_ns) out->factor_ns = report.factor_ns;
+        if (run == 1 || report.solve_ns < out->solve_ns) out->solve_ns = report.solve_ns;
+        out->report = report;
+    }
+    lscm_plan_free(plan);
+    out->ordering_ns = std::max(0LL, cold_factor_ns - out->factor_ns);
+    return ok;
+}
+
+struct Roofs {
+    double gflops;
+    double gbytes;
+};
+
+static void print_stage(const char* name, long long ns, double flops, double bytes, const Roofs& roofs) {
+    double seconds = std::max(ns, 1LL) * 1e-9;
+    double gflops = flops / seconds * 1e-9;
+    double gbytes = bytes / seconds * 1e-9;
+    double intensity = flops / bytes;
+    // The roofline's attainable rate at this intensity, and the roof that sets it
+    double attainable = std::min(roofs.gflops, intensity * roofs.gbytes);
+    bool memory_bound = intensity * roofs.gbytes < roofs.gflops;
+    double of_roof = flops > 0.0 ? gflops / attainable : gbytes / roofs.gbytes;
+    printf("%-9s %10.3f %10.2f %10.2f %8.3f %9.3f %8.2f %8.1f%% %8.1f%% %8.1f%%  %s\n", name, ns * 1e-6,
+           flops * 1e-6, bytes * 1e-6, intensity, gflops, gbytes, 100.0 * gflops / roofs.gflops,
+           100.0 * gbytes / roofs.gbytes, 100.0 * of_roof,
+           flops <= 0.0 ? "integer" : memory_bound ? "bandwidth" : "compute");
+}
+
+static void bench_grid(int side, int runs, const Roofs& roofs) {
+    Mesh* mesh = gen_grid(side, side);
+    StageTimes times;
+    memset(&times, 0, sizeof(times));
+    if (!measure_stages(mesh, runs, &times)) {
+        printf("\ngrid %d: LDLT solve failed\n", side);
+        free_mesh(mesh);
+        return;
+    }
+    FactorModel model = factor_model(mesh);
+
+    double F = mesh->num_triangles;
+    double n = 2.0 * mesh->num_vertices;
+    double nnz_a = (double)times.report.matrix_nonzeros;
+    double nnz_l = (double)model.nonzeros;
+
+    printf("\ngrid %d: %d vertices, %d triangles, nnz(A) %lld, nnz(L) %lld (model %lld)\n", side,
+           mesh->num_vertices, mesh->num_triangles, times.report.matrix_nonzeros, times.report.factor_nonzeros,
+           model.nonzeros);
+    printf("%-9s %10s %10s %10s %8s %9s %8s %9s %9s %9s  %s\n", "stage", "ms", "MFLOP", "MB", "flop/B",
+           "GFLOP/s", "GB/s", "flops", "bandwidth", "of roof", "bound");
+    // faces (4 B per index, twice: mesh and local), 3 vertices, A cleared
+    // then written, b written
+    print_stage("assembly", times.assembly_ns, F * ASSEMBLY_FLOPS_PER_FACE,
+                F * (24.0 + 36.0) + nnz_a * 16.0 + n * 8.0, roofs);
+    // A's pattern read, permutation and elimination tree written
+    print_stage("ordering", times.ordering_ns, 0.0, nnz_a * 4.0 + n * 12.0, roofs);
+    print_stage("factor", times.factor_ns, model.flops, (nnz_a + nnz_l) * 12.0 + n * 8.0, roofs);
+    // L forward and back, D, b, x and the permutation both ways
+    print_stage("solve", times.solve_ns, 4.0 * nnz_l + n, nnz_l * 24.0 + n * 40.0, roofs);
+    free_mesh(mesh);
+}
+
+int main(int argc, char** argv) {
+    int side = argc > 1 ? atoi(argv[1]) : 512;
+    int runs = argc > 2 ? std::max(1, atoi(argv[2])) : 3;
+    int cores = (int)std::max(1u, std::thread::hardware_concurrency());
+
+    Roofs one = {probe_flops(1), probe_bandwidth(1)};
+    Roofs all = {cores > 1 ? probe_flops(cores) : one.gflops, cores > 1 ? probe_bandwidth(cores) : one.gbytes};
+    printf("roofs       %12s %12s %14s\n", "GFLOP/s", "GB/s", "ridge flop/B");
+    printf("1 core      %12.2f %12.2f %14.3f\n", one.gflops, one.gbytes, one.gflops / one.gbytes);
+    if (cores > 1) printf("%-2d cores    %12.2f %12.2f %14.3f\n", cores, all.gflops, all.gbytes, all.gflops / all.gbytes);
+    printf("(stages are one island on one core: %% of the 1-core roofs)\n");
+
+    // Small enough to stay in cache, then past it
+    const int sides[] = {side / 8, side / 2, side};
+    for (size_t i = 0; i < sizeof(sides) / sizeof(sides[0]); i++) {
+        if (sides[i] >= 8) bench_grid(sides[i], runs, one);
+    }
+    return 0;
+}
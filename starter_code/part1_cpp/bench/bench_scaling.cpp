@@ -0,0 +1,265 @@
+/**
+ * @file bench_scaling.cpp
+ * @brief Regression benchmark: every pipeline stage must scale like n log n
+ *
+ * Times each stage at about 10k, 100k and 1M triangles and fails if a
+ * step grows faster than n log n by more than SCALING_TOLERANCE. The
+ * meshes are picked so a quadratic path shows up:
+ * - topology, seams and islands on a closed torus;
+ * - metrics and shelf packing on many small islands;
+ * - unwrap_mesh() end to end on many small bumpy islands, which catches
+ *   work done per island over the whole mesh;
+ * - LSCM on one long bumpy strip, whose boundary grows with n, which
+ *   catches work quadratic in the boundary (pin search).
+ *
+ * `bench_scaling --quick` stops at 100k triangles.
+ */
+
+#include "mesh.h"
+#include "topology.h"
+#include "unwrap.h"
+#include "lscm.h"
+#include "mesh_generators.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+
+// Looser than bench_seams: the 1M step falls out of cache, while a
+// quadratic path still grows about 100x per step
+#define SCALING_TOLERANCE 3.0
+#define REPETITIONS 3
+#define MIN_SECONDS 0.25
+
+// Triangles per island of the island meshes: 4 × 4 quads
+#define TILE_QUADS 4
+
+typedef double (*StageFn)(const Mesh* mesh);
+
+static double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/** Best of REPETITIONS runs, fewer once the runs take MIN_SECONDS */
+static double time_stage(StageFn stage, const Mesh* mesh) {
+    double best = 1e30, total = 0.0;
+    for (int rep = 0; rep < REPETITIONS && (rep == 0 || total < MIN_SECONDS); rep++) {
+        double t = stage(mesh);
+        total += t;
+        if (t < best) best = t;
+    }
+    return best;
+}
+
+// ---------------------------------------------------------------------------
+// Meshes
+// ---------------------------------------------------------------------------
+
+/** Torus of about `triangles` triangles */
+static Mesh* make_torus(int triangles) {
+    int n = (int)sqrt(triangles / 2.0);
+    return gen_torus(n, n, 1.0f, 0.3f);
+}
+
+/**
+ * @brief Disconnected TILE_QUADS² patches with bumpy heights and planar
+ *        UVs, about `triangles` triangles in all
+ */
+static Mesh* make_tiles(int triangles) {
+    const int tile_triangles = TILE_QUADS * TILE_QUADS * 2;
+    const int tile_vertices = (TILE_QUADS + 1) * (TILE_QUADS + 1);
+    int side = (int)ceil(sqrt((double)triangles / tile_triangles));
+    int num_tiles = side * side;
+    float uv_scale = 1.0f / (side * 1.25f);  // Islands side by side in [0,1]², as after packing
+    Mesh* mesh = gen_alloc_mesh(num_tiles * tile_vertices, num_tiles * tile_triangles);
+    mesh->uvs = (float*)malloc((size_t)mesh->num_vertices * 2 * sizeof(float));
+
+    for (int tile = 0; tile < num_tiles; tile++) {
+        float ox = (float)(tile % side) * 1.25f, oy = (float)(tile / side) * 1.25f;
+        int base = tile * tile_vertices;
+        for (int j = 0; j <= TILE_QUADS; j++) {
+            for (int i = 0; i <= TILE_QUADS; i++) {
+                int v = base + j * (TILE_QUADS + 1) + i;
+                float x = (float)i / TILE_QUADS, y = (float)j / TILE_QUADS;
+                mesh->vertices[v * 3 + 0] = ox + x;
+                mesh->vertices[v * 3 + 1] = oy + y;
+                mesh->vertices[v * 3 + 2] = 0.2f * gen_noise((unsigned)v, 7u);
+                mesh->uvs[v * 2 + 0] = (ox + x) * uv_scale;
+                mesh->uvs[v * 2 + 1] = (oy + y) * uv_scale;
+            }
+        }
+        int* t = &mesh->triangles[(size_t)tile * tile_triangles * 3];
+        for (int j = 0; j < TILE_QUADS; j++) {
+            for (int i = 0; i < TILE_QUADS; i++) {
+                int v00 = base + j * (TILE_QUADS + 1) + i;
+                int v10 = v00 + 1, v01 = v00 + TILE_QUADS + 1, v11 = v01 + 1;
+                *t++ = v00; *t++ = v10; *t++ = v11;
+                *t++ = v00; *t++ = v11; *t++ = v01;
+            }
+        }
+    }
+    return mesh;
+}
+
+/** Bumpy strip two quads wide: the boundary holds every vertex */
+static Mesh* make_strip(int triangles) {
+    Mesh* mesh = gen_grid(triangles / 4, 2);
+    for (int v = 0; v < mesh->num_vertices; v++) {
+        mesh->vertices[v * 3 + 0] *= triangles / 4;
+        mesh->vertices[v * 3 + 2] = 0.3f * gen_noise((unsigned)v, 11u);
+    }
+    return mesh;
+}
+
+// ---------------------------------------------------------------------------
+// Stages
+// ---------------------------------------------------------------------------
+
+static double stage_topology(const Mesh* mesh) {
+    auto start = std::chrono::steady_clock::now();
+    TopologyInfo* topo = build_topology(mesh);
+    double t = seconds_since(start);
+    free_topology(topo);
+    return t;
+}
+
+static double stage_seams(const Mesh* mesh) {
+    TopologyInfo* topo = build_topology(mesh);
+    auto start = std::chrono::steady_clock::now();
+    int num_seams = 0;
+    int* seams = detect_seams_with_method(mesh, topo, 30.0f, SEAM_METHOD_BFS, &num_seams);
+    double t = seconds_since(start);
+    free(seams);
+    free_topology(topo);
+    return t;
+}
+
+static double stage_islands(const Mesh* mesh) {
+    TopologyInfo* topo = build_topology(mesh);
+    int num_seams = 0;
+    int* seams = detect_seams_with_method(mesh, topo, 30.0f, SEAM_METHOD_BFS, &num_seams);
+    auto start = std::chrono::steady_clock::now();
+    IslandInfo* islands = extract_islands(mesh, topo, seams, num_seams);
+    double t = seconds_since(start);
+    free_islands(islands);
+    free(seams);
+    free_topology(topo);
+    return t;
+}
+
+/** Island id of every face of make_tiles() */
+static std::vector<int> tile_islands(const Mesh* mesh) {
+    std::vector<int> ids(mesh->num_triangles);
+    for (int f = 0; f < mesh->num_triangles; f++) ids[f] = f / (TILE_QUADS * TILE_QUADS * 2);
+    return ids;
+}
+
+static double stage_metrics(const Mesh* mesh) {
+    std::vector<int> ids = tile_islands(mesh);
+    UnwrapResult result;
+    memset(&result, 0, sizeof(result));
+    result.num_islands = ids.back() + 1;
+    result.face_island_ids = ids.data();
+    auto start = std::chrono::steady_clock::now();
+    compute_quality_metrics_ex(mesh, &result, NULL, 1);
+    return seconds_since(start);
+}
+
+static double stage_pack(const Mesh* mesh) {
+    std::vector<int> ids = tile_islands(mesh);
+    UnwrapResult result;
+    memset(&result, 0, sizeof(result));
+    result.num_islands = ids.back() + 1;
+    result.face_island_ids = ids.data();
+    Mesh packed = *mesh;
+    std::vector<float> uvs(mesh->uvs, mesh->uvs + (size_t)mesh->num_vertices * 2);
+    packed.uvs = uvs.data();
+    auto start = std::chrono::steady_clock::now();
+    pack_uv_islands_ex(&packed, &result, 0.002f, PACK_METHOD_SHELF, PACK_ROTATION_90);
+    return seconds_since(start);
+}
+
+static double stage_unwrap(const Mesh* mesh) {
+    UnwrapParams params;
+    unwrap_params_default(&params);
+    params.num_threads = 1;
+    params.pack_method = PACK_METHOD_SHELF;
+    auto start = std::chrono::steady_clock::now();
+    UnwrapResult* result = NULL;
+    Mesh* out = unwrap_mesh(mesh, &params, &result);
+    double t = seconds_since(start);
+    if (!out) fprintf(stderr, "unwrap_mesh failed\n");
+    free_unwrap_result(result);
+    free_mesh(out);
+    return t;
+}
+
+/**
+ * Pinned to SimplicialLDLT: AUTO moves islands past its iterative
+ * threshold to multigrid, and the series should time one algorithm
+ */
+static double stage_lscm(const Mesh* mesh) {
+    std::vector<int> faces(mesh->num_triangles);
+    for (int f = 0; f < mesh->num_triangles; f++) faces[f] = f;
+    LscmOptions options;
+    lscm_options_default(&options);
+    options.solver = LSCM_SOLVER_LDLT;
+    auto start = std::chrono::steady_clock::now();
+    float* uvs = lscm_parameterize_with_options(mesh, faces.data(), mesh->num_triangles, &options, NULL);
+    double t = seconds_since(start);
+    if (!uvs) fprintf(stderr, "lscm_parameterize failed\n");
+    free(uvs);
+    return t;
+}
+
+// ---------------------------------------------------------------------------
+
+static int run_series(const char* name, Mesh* (*make)(int), StageFn stage, const int* sizes, int num_sizes) {
+    int failures = 0;
+    double prev_time = 0.0;
+    int prev_faces = 0;
+
+    printf("\n%-10s %12s %12s %10s %10s\n", name, "triangles", "seconds", "ratio", "allowed");
+    for (int i = 0; i < num_sizes; i++) {
+        Mesh* mesh = make(sizes[i]);
+        double t = time_stage(stage, mesh);
+        int faces = mesh->num_triangles;
+        free_mesh(mesh);
+
+        if (i == 0) {
+            printf("%-10s %12d %12.5f %10s %10s\n", "", faces, t, "-", "-");
+        } else {
+            double n_ratio = (double)faces / prev_faces;
+            double allowed = n_ratio * (log((double)faces) / log((double)prev_faces)) * SCALING_TOLERANCE;
+            double ratio = t / (prev_time > 1e-6 ? prev_time : 1e-6);
+            int ok = ratio <= allowed;
+            printf("%-10s %12d %12.5f %10.2f %10.2f%s\n", "", faces, t, ratio, allowed,
+                   ok ? "" : "  <-- superlinear");
+            if (!ok) failures++;
+        }
+
+        prev_time = t;
+        prev_faces = faces;
+    }
+    return failures;
+}
+
+int main(int argc, char** argv) {
+    bool quick = argc > 1 && strcmp(argv[1], "--quick") == 0;
+    const int sizes[] = {10000, 100000, 1000000};
+    const int num_sizes = quick ? 2 : 3;
+
+    int failures = 0;
+    failures += run_series("topology", make_torus, stage_topology, sizes, num_sizes);
+    failures += run_series("seams", make_torus, stage_seams, sizes, num_sizes);
+    failures += run_series("islands", make_torus, stage_islands, sizes, num_sizes);
+    failures += run_series("metrics", make_tiles, stage_metrics, sizes, num_sizes);
+    failures += run_series("pack", make_tiles, stage_pack, sizes, num_sizes);
+    failures += run_series("unwrap", make_tiles, stage_unwrap, sizes, num_sizes);
+    failures += run_series("lscm", make_strip, stage_lscm, sizes, num_sizes);
+
+    printf("\nPipeline scaling: %s\n", failures == 0 ? "OK" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}
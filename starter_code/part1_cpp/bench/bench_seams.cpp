@@ -0,0 +1,91 @@
+/**
+ * @file bench_seams.cpp
+ * @brief Regression benchmark: detect_seams must scale (near-)linearly
+ *
+ * Times detect_seams (BFS and MST engines) on closed and open synthetic
+ * meshes whose size grows 4× per step and fails if any step grows faster
+ * than n log n by more than a factor of SCALING_TOLERANCE.
+ */
+
+#include "mesh.h"
+#include "topology.h"
+#include "unwrap.h"
+#include "mesh_generators.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+
+#define SCALING_TOLERANCE 2.0
+#define REPETITIONS 3
+
+static double time_detect_seams(const Mesh* mesh, SeamMethod method) {
+    TopologyInfo* topo = build_topology(mesh);
+    double best = 1e30;
+
+    for (int rep = 0; rep < REPETITIONS; rep++) {
+        auto start = std::chrono::steady_clock::now();
+        int num_seams = 0;
+        int* seams = detect_seams_with_method(mesh, topo, 30.0f, method, &num_seams);
+        auto end = std::chrono::steady_clock::now();
+        free(seams);
+
+        double seconds = std::chrono::duration<double>(end - start).count();
+        if (seconds < best) best = seconds;
+    }
+
+    free_topology(topo);
+    return best;
+}
+
+static int run_series(const char* name, Mesh* (*make)(int), SeamMethod method,
+                      const int* sizes, int num_sizes) {
+    int failures = 0;
+    double prev_time = 0.0;
+    int prev_faces = 0;
+
+    printf("\n%-10s %12s %12s %10s\n", name, "triangles", "seconds", "ratio");
+    for (int i = 0; i < num_sizes; i++) {
+        Mesh* mesh = make(sizes[i]);
+        double t = time_detect_seams(mesh, method);
+        int faces = mesh->num_triangles;
+        free_mesh(mesh);
+
+        if (i == 0) {
+            printf("%-10s %12d %12.5f %10s\n", "", faces, t, "-");
+        } else {
+            double n_ratio = (double)faces / prev_faces;
+            double allowed = n_ratio * (log((double)faces) / log((double)prev_faces)) * SCALING_TOLERANCE;
+            double ratio = t / (prev_time > 1e-6 ? prev_time : 1e-6);
+            int ok = ratio <= allowed;
+            printf("%-10s %12d %12.5f %10.2f%s\n", "", faces, t, ratio,
+                   ok ? "" : "  <-- superlinear");
+            if (!ok) failures++;
+        }
+
+        prev_time = t;
+        prev_faces = faces;
+    }
+    return failures;
+}
+
+static Mesh* make_torus(int n) { return gen_torus(n, n, 1.0f, 0.3f); }
+static Mesh* make_grid(int n) { return gen_grid(n, n); }
+
+int main() {
+    // Side lengths double per step -> triangle count grows 4x
+    const int sizes[] = {64, 128, 256};
+    const int num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+
+    int failures = 0;
+    failures += run_series("torus", make_torus, SEAM_METHOD_BFS, sizes, num_sizes);
+    failures += run_series("grid", make_grid, SEAM_METHOD_BFS, sizes, num_sizes);
+    failures += run_series("torus/mst", make_torus, SEAM_METHOD_MST, sizes, num_sizes);
+    failures += run_series("grid/mst", make_grid, SEAM_METHOD_MST, sizes, num_sizes);
+    failures += run_series("torus/cost", make_torus, SEAM_METHOD_COST, sizes, num_sizes);
+    failures += run_series("grid/cost", make_grid, SEAM_METHOD_COST, sizes, num_sizes);
+    failures += run_series("torus/cut", make_torus, SEAM_METHOD_CUT_GRAPH, sizes, num_sizes);
+
+    printf("\nSeam detection scaling: %s\n", failures == 0 ? "OK" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}
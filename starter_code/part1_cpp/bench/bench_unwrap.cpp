@@ -0,0 +1,345 @@
+/**
+ * @file bench_unwrap.cpp
+ * @brief Benchmark: per-stage pipeline timings on synthetic meshes
+ *
+ * Google Benchmark suite over four generated mesh families (icosphere,
+ * torus, grid with holes, noisy scan) from 1k to 10M triangles. Each
+ * pipeline stage is its own benchmark, named "<stage>/<mesh>/<triangles>",
+ * with its inputs prepared outside the timed loop. Stages that need a full
+ * unwrap to set up (LSCM, packing, metrics, coverage at 4096²) stop at
+ * 1M triangles.
+ *
+ * Usage:
+ *   bench_unwrap --benchmark_filter=topology \
+ *                --benchmark_out=bench.json --benchmark_out_format=json
+ */
+
+#include "mesh.h"
+#include "topology.h"
+#include "unwrap.h"
+#include "lscm.h"
+#include "uv_log.h"
+#include "mesh_generators.h"
+#include <benchmark/benchmark.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+enum MeshKind {
+    MESH_ICOSPHERE,
+    MESH_TORUS,
+    MESH_GRID_HOLES,
+    MESH_NOISY_SCAN
+};
+
+static const char* MESH_NAMES[] = {"icosphere", "torus", "grid_holes", "noisy_scan"};
+
+static const char* TEMP_OBJ = "bench_unwrap_tmp.obj";
+
+/** Generate a mesh of the given family with roughly `triangles` triangles */
+static Mesh* generate_mesh(MeshKind kind, int triangles) {
+    switch (kind) {
+        case MESH_ICOSPHERE: {
+            int n = (int)lround(sqrt(triangles / 20.0));
+            return gen_icosphere(n > 1 ? n : 1);
+        }
+        case MESH_TORUS: {
+            int n = (int)lround(sqrt(triangles / 2.0));
+            return gen_torus(n, n, 1.0f, 0.3f);
+        }
+        case MESH_GRID_HOLES: {
+            // Holes remove about 28% of the faces
+            int n = (int)lround(sqrt(triangles / (2.0 * 0.72)));
+            return gen_grid_with_holes(n, n, 4);
+        }
+        case MESH_NOISY_SCAN:
+        default: {
+            int n = (int)lround(sqrt(triangles / (2.0 * 0.99)));
+            return gen_noisy_scan(n, n, 0.01f, 1);
+        }
+    }
+}
+
+/**
+ * @brief Mesh plus lazily built pipeline inputs for the later stages
+ *
+ * Only the most recent fixture is kept, so a 10M-triangle mesh and its
+ * topology are not held while the next size is generated.
+ */
+struct Fixture {
+    MeshKind kind;
+    int size;
+    Mesh* mesh;
+    TopologyInfo* topo;
+    int* seams;
+    int num_seams;
+    IslandInfo* islands;
+    Mesh* unwrapped;           // LSCM without packing
+    UnwrapResult* result;
+
+    Fixture(MeshKind k, int s)
+        : kind(k), size(s), mesh(generate_mesh(k, s)), topo(NULL), seams(NULL),
+          num_seams(0), islands(NULL), unwrapped(NULL), result(NULL) {}
+
+    ~Fixture() {
+        free_unwrap_result(result);
+        free_mesh(unwrapped);
+        free_islands(islands);
+        free(seams);
+        free_topology(topo);
+        free_mesh(mesh);
+    }
+
+    TopologyInfo* topology() {
+        if (!topo) topo = build_topology(mesh);
+        return topo;
+    }
+
+    const int* seam_edges() {
+        if (!seams) seams = detect_seams(mesh, topology(), 30.0f, &num_seams);
+        return seams;
+    }
+
+    IslandInfo* island_info() {
+        if (!islands) islands = extract_islands(mesh, topology(), seam_edges(), num_seams);
+        return islands;
+    }
+
+    Mesh* unwrap() {
+        if (!unwrapped) {
+            UnwrapParams params;
+            unwrap_params_default(&params);
+            params.pack_islands = 0;
+            unwrapped = unwrap_mesh(mesh, &params, &result);
+        }
+        return unwrapped;
+    }
+};
+
+static Fixture* g_fixture = NULL;
+
+static Fixture& fixture(MeshKind kind, int size) {
+    if (!g_fixture || g_fixture->kind != kind || g_fixture->size != size) {
+        delete g_fixture;
+        g_fixture = NULL;
+        g_fixture = new Fixture(kind, size);
+    }
+    return *g_fixture;
+}
+
+static void set_counters(benchmark::State& state, const Mesh* mesh) {
+    state.SetItemsProcessed((int64_t)state.iterations() * mesh->num_triangles);
+    state.counters["triangles"] = mesh->num_triangles;
+    state.counters["vertices"] = mesh->num_vertices;
+}
+
+static void bm_build_topology(benchmark::State& state, MeshKind kind,
+                              TopologyInfo* (*build)(const Mesh*) = build_topology) {
+    Fixture& fx = fixture(kind, (int)state.range(0));
+    for (auto _ : state) {
+        TopologyInfo* topo = build(fx.mesh);
+        benchmark::DoNotOptimize(topo);
+        free_topology(topo);
+    }
+    set_counters(state, fx.mesh);
+}
+
+static void bm_detect_seams(benchmark::State& state, MeshKind kind) {
+    Fixture& fx = fixture(kind, (int)state.range(0));
+    TopologyInfo* topo = fx.topology();
+    int num_seams = 0;
+    for (auto _ : state) {
+        int* seams = detect_seams(fx.mesh, topo, 30.0f, &num_seams);
+        benchmark::DoNotOptimize(seams);
+        free(seams);
+    }
+    set_counters(state, fx.mesh);
+    state.counters["seams"] = num_seams;
+}
+
+static void bm_extract_islands(benchmark::State& state, MeshKind kind) {
+    Fixture& fx = fixture(kind, (int)state.range(0));
+    const int* seams = fx.seam_edges();
+    int num_islands = 0;
+    for (auto _ : state) {
+        IslandInfo* islands = extract_islands(fx.mesh, fx.topo, seams, fx.num_seams);
+        num_islands = islands->num_islands;
+        free_islands(islands);
+    }
+    set_counters(state, fx.mesh);
+    state.counters["islands"] = num_islands;
+}
+
+static void bm_lscm_parameterize(benchmark::State& state, MeshKind kind) {
+    Fixture& fx = fixture(kind, (int)state.range(0));
+    IslandInfo* islands = fx.island_info();
+
+    // Largest island: the solve that dominates a real unwrap
+    int largest = 0;
+    for (int i = 1; i < islands->num_islands; i++) {
+        if (islands->island_face_offsets[i + 1] - islands->island_face_offsets[i] >
+            islands->island_face_offsets[largest + 1] - islands->island_face_offsets[largest]) {
+            largest = i;
+        }
+    }
+    const int* faces = &islands->island_faces[islands->island_face_offsets[largest]];
+    int num_faces = islands->island_face_offsets[largest + 1] - islands->island_face_offsets[largest];
+
+    for (auto _ : state) {
+        float* uvs = lscm_parameterize(fx.mesh, faces, num_faces);
+        if (!uvs) {
+            state.SkipWithError("lscm_parameterize failed");
+            break;
+        }
+        free(uvs);
+    }
+    state.SetItemsProcessed((int64_t)state.iterations() * num_faces);
+    state.counters["island_faces"] = num_faces;
+}
+
+static void bm_pack_uv_islands(benchmark::State& state, MeshKind kind) {
+    Fixture& fx = fixture(kind, (int)state.range(0));
+    Mesh* unwrapped = fx.unwrap();
+    size_t uv_bytes = (size_t)unwrapped->num_vertices * 2 * sizeof(float);
+    std::vector<float> unpacked(unwrapped->uvs, unwrapped->uvs + unwrapped->num_vertices * 2);
+
+    Mesh work = *unwrapped;
+    work.uvs = (float*)malloc(uv_bytes);
+    for (auto _ : state) {
+        state.PauseTiming();
+        memcpy(work.uvs, unpacked.data(), uv_bytes);
+        state.ResumeTiming();
+        pack_uv_islands(&work, fx.result, 0.02f);
+    }
+    free(work.uvs);
+    set_counters(state, fx.mesh);
+    state.counters["islands"] = fx.result->num_islands;
+}
+
+static void bm_quality_metrics(benchmark::State& state, MeshKind kind) {
+    Fixture& fx = fixture(kind, (int)state.range(0));
+    Mesh* unwrapped = fx.unwrap();
+    UnwrapResult metrics = *fx.result;
+    for (auto _ : state) {
+        compute_quality_metrics(unwrapped, &metrics);
+        benchmark::DoNotOptimize(metrics.avg_stretch);
+    }
+    set_counters(state, fx.mesh);
+}
+
+static const int COVERAGE_RESOLUTION = 4096;
+
+static void bm_uv_coverage(benchmark::State& state, MeshKind kind, int resolution = COVERAGE_RESOLUTION,
+                           int backend = COMPUTE_BACKEND_AUTO) {
+    if (!compute_backend_available((ComputeBackend)backend)) {
+        state.SkipWithError("compute backend not available");
+        return;
+    }
+    Fixture& fx = fixture(kind, (int)state.range(0));
+    Mesh* unwrapped = fx.unwrap();
+    Mesh packed = *unwrapped;
+    std::vector<float> uvs(unwrapped->uvs, unwrapped->uvs + unwrapped->num_vertices * 2);
+    packed.uvs = uvs.data();
+    pack_uv_islands(&packed, fx.result, 0.02f);
+
+    float coverage = 0.0f;
+    for (auto _ : state) {
+        UvCoverage* cov = compute_uv_coverage_ex(&packed, fx.result->face_island_ids, fx.result->num_islands,
+                                                 resolution, 0, backend);
+        coverage = cov ? cov->coverage : 0.0f;
+        free_uv_coverage(cov);
+    }
+    set_counters(state, fx.mesh);
+    state.counters["coverage"] = coverage;
+}
+
+static void bm_load_obj(benchmark::State& state, MeshKind kind, Mesh* (*load)(const char*)) {
+    Fixture& fx = fixture(kind, (int)state.range(0));
+    if (save_obj_fast(fx.mesh, TEMP_OBJ) != 0) {
+        state.SkipWithError("cannot write temporary OBJ");
+        return;
+    }
+    for (auto _ : state) {
+        Mesh* mesh = load(TEMP_OBJ);
+        if (!mesh) {
+            state.SkipWithError("load failed");
+            break;
+        }
+        free_mesh(mesh);
+    }
+    remove(TEMP_OBJ);
+    set_counters(state, fx.mesh);
+}
+
+static void bm_save_obj(benchmark::State& state, MeshKind kind, int (*save)(const Mesh*, const char*)) {
+    Fixture& fx = fixture(kind, (int)state.range(0));
+    for (auto _ : state) {
+        if (save(fx.mesh, TEMP_OBJ) != 0) {
+            state.SkipWithError("save failed");
+            break;
+        }
+    }
+    remove(TEMP_OBJ);
+    set_counters(state, fx.mesh);
+}
+
+static const int MAX_SIZE = 10000000;
+static const int MAX_UNWRAP_SIZE = 1000000;
+
+int main(int argc, char** argv) {
+    uv_set_log_level(UV_LOG_SILENT);
+
+    struct Stage {
+        const char* name;
+        int max_size;
+        void (*fn)(benchmark::State&, MeshKind);
+    };
+    static const Stage stages[] = {
+        {"build_topology", MAX_SIZE, [](benchmark::State& s, MeshKind k) { bm_build_topology(s, k); }},
+        {"build_topology_parallel", MAX_SIZE, [](benchmark::State& s, MeshKind k) {
+             bm_build_topology(s, k, [](const Mesh* m) { return build_topology_parallel(m, 0, NULL); });
+         }},
+        {"detect_seams", MAX_SIZE, bm_detect_seams},
+        {"extract_islands", MAX_SIZE, bm_extract_islands},
+        {"lscm_parameterize", MAX_UNWRAP_SIZE, bm_lscm_parameterize},
+        {"pack_uv_islands", MAX_UNWRAP_SIZE, bm_pack_uv_islands},
+        {"compute_quality_metrics", MAX_UNWRAP_SIZE, bm_quality_metrics},
+        {"compute_uv_coverage", MAX_UNWRAP_SIZE, [](benchmark::State& s, MeshKind k) { bm_uv_coverage(s, k); }},
+        // QA-sized grids on each device
+        {"compute_uv_coverage_8k_cpu", MAX_UNWRAP_SIZE, [](benchmark::State& s, MeshKind k) {
+             bm_uv_coverage(s, k, 8192, COMPUTE_BACKEND_CPU);
+         }},
+        {"compute_uv_coverage_8k_cuda", MAX_UNWRAP_SIZE, [](benchmark::State& s, MeshKind k) {
+             bm_uv_coverage(s, k, 8192, COMPUTE_BACKEND_CUDA);
+         }},
+        {"load_obj", MAX_SIZE, [](benchmark::State& s, MeshKind k) { bm_load_obj(s, k, load_obj); }},
+        {"load_obj_fast", MAX_SIZE, [](benchmark::State& s, MeshKind k) { bm_load_obj(s, k, load_obj_fast); }},
+        {"save_obj", MAX_SIZE, [](benchmark::State& s, MeshKind k) { bm_save_obj(s, k, save_obj); }},
+        {"save_obj_fast", MAX_SIZE, [](benchmark::State& s, MeshKind k) { bm_save_obj(s, k, save_obj_fast); }},
+    };
+
+    // Registered mesh-major so consecutive benchmarks share one fixture
+    for (int kind = 0; kind < 4; kind++) {
+        for (int size = 1000; size <= MAX_SIZE; size *= 10) {
+            for (const Stage& stage : stages) {
+                if (size > stage.max_size) continue;
+                std::string name = std::string(stage.name) + "/" + MESH_NAMES[kind];
+                benchmark::RegisterBenchmark(name.c_str(), stage.fn, (MeshKind)kind)
+                    ->Arg(size)
+                    ->Unit(benchmark::kMillisecond)
+                    ->UseRealTime();
+            }
+        }
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    delete g_fixture;
+    return 0;
+}
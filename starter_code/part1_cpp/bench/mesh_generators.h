@@ -0,0 +1,278 @@
+/**
+ * @file mesh_generators.h
+ * @brief Synthetic mesh generators for benchmarks and scaling tests
+ *
+ * Header-only; every generator returns a Mesh allocated with malloc so it
+ * can be released with free_mesh().
+ */
+
+#ifndef MESH_GENERATORS_H
+#define MESH_GENERATORS_H
+
+#include "mesh.h"
+#include <stdlib.h>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static inline Mesh* gen_alloc_mesh(int num_vertices, int num_triangles) {
+    Mesh* mesh = (Mesh*)malloc(sizeof(Mesh));
+    mesh->num_vertices = num_vertices;
+    mesh->vertices = (float*)malloc((size_t)num_vertices * 3 * sizeof(float));
+    mesh->num_triangles = num_triangles;
+    mesh->triangles = (int*)malloc((size_t)num_triangles * 3 * sizeof(int));
+    mesh->uvs = NULL;
+    return mesh;
+}
+
+/**
+ * @brief Flat open grid of nx × ny quads (2 * nx * ny triangles)
+ */
+static inline Mesh* gen_grid(int nx, int ny) {
+    Mesh* mesh = gen_alloc_mesh((nx + 1) * (ny + 1), nx * ny * 2);
+
+    for (int j = 0; j <= ny; j++) {
+        for (int i = 0; i <= nx; i++) {
+            float* p = &mesh->vertices[(j * (nx + 1) + i) * 3];
+            p[0] = (float)i / nx;
+            p[1] = (float)j / ny;
+            p[2] = 0.0f;
+        }
+    }
+
+    int* t = mesh->triangles;
+    for (int j = 0; j < ny; j++) {
+        for (int i = 0; i < nx; i++) {
+            int v00 = j * (nx + 1) + i;
+            int v10 = v00 + 1;
+            int v01 = v00 + nx + 1;
+            int v11 = v01 + 1;
+            *t++ = v00; *t++ = v10; *t++ = v11;
+            *t++ = v00; *t++ = v11; *t++ = v01;
+        }
+    }
+
+    return mesh;
+}
+
+/**
+ * @brief Closed torus with nu × nv quads (2 * nu * nv triangles)
+ * @param major_radius Distance from the centre to the tube centre
+ * @param minor_radius Tube radius
+ */
+static inline Mesh* gen_torus(int nu, int nv, float major_radius, float minor_radius) {
+    Mesh* mesh = gen_alloc_mesh(nu * nv, nu * nv * 2);
+
+    for (int i = 0; i < nu; i++) {
+        double a = 2.0 * M_PI * i / nu;
+        for (int j = 0; j < nv; j++) {
+            double b = 2.0 * M_PI * j / nv;
+            float* p = &mesh->vertices[(i * nv + j) * 3];
+            p[0] = (float)((major_radius + minor_radius * cos(b)) * cos(a));
+            p[1] = (float)((major_radius + minor_radius * cos(b)) * sin(a));
+            p[2] = (float)(minor_radius * sin(b));
+        }
+    }
+
+    int* t = mesh->triangles;
+    for (int i = 0; i < nu; i++) {
+        int i1 = (i + 1) % nu;
+        for (int j = 0; j < nv; j++) {
+            int j1 = (j + 1) % nv;
+            int v00 = i * nv + j;
+            int v10 = i1 * nv + j;
+            int v01 = i * nv + j1;
+            int v11 = i1 * nv + j1;
+            *t++ = v00; *t++ = v10; *t++ = v11;
+            *t++ = v00; *t++ = v11; *t++ = v01;
+        }
+    }
+
+    return mesh;
+}
+
+/**
+ * @brief Drop vertices no triangle references and renumber the rest
+ *
+ * Lets generators cut triangles out of a regular mesh without leaving
+ * isolated vertices behind.
+ */
+static inline void gen_compact_mesh(Mesh* mesh) {
+    int* remap = (int*)malloc((size_t)mesh->num_vertices * sizeof(int));
+    for (int i = 0; i < mesh->num_vertices; i++) remap[i] = -1;
+    for (int i = 0; i < mesh->num_triangles * 3; i++) remap[mesh->triangles[i]] = 0;
+
+    int count = 0;
+    for (int i = 0; i < mesh->num_vertices; i++) {
+        if (remap[i] < 0) continue;
+        remap[i] = count;
+        mesh->vertices[count * 3 + 0] = mesh->vertices[i * 3 + 0];
+        mesh->vertices[count * 3 + 1] = mesh->vertices[i * 3 + 1];
+        mesh->vertices[count * 3 + 2] = mesh->vertices[i * 3 + 2];
+        count++;
+    }
+    for (int i = 0; i < mesh->num_triangles * 3; i++) mesh->triangles[i] = remap[mesh->triangles[i]];
+    mesh->num_vertices = count;
+    free(remap);
+}
+
+/** Deterministic hash noise in [0, 1) */
+static inline float gen_noise(unsigned int x, unsigned int seed) {
+    unsigned int h = x * 0x9E3779B1u ^ seed * 0x85EBCA77u;
+    h ^= h >> 15;
+    h *= 0x2C1B3C6Du;
+    h ^= h >> 12;
+    h *= 0x297A2D39u;
+    h ^= h >> 15;
+    return (float)(h >> 8) / 16777216.0f;
+}
+
+/**
+ * @brief Geodesic icosphere: every icosahedron face split into n² triangles
+ *        (20 * n² triangles, unit radius)
+ */
+static inline Mesh* gen_icosphere(int n) {
+    static const double t = 1.61803398874989484820;
+    static const double corners[12][3] = {
+        {-1, t, 0}, {1, t, 0}, {-1, -t, 0}, {1, -t, 0},
+        {0, -1, t}, {0, 1, t}, {0, -1, -t}, {0, 1, -t},
+        {t, 0, -1}, {t, 0, 1}, {-t, 0, -1}, {-t, 0, 1},
+    };
+    static const int faces[20][3] = {
+        {0, 11, 5}, {0, 5, 1}, {0, 1, 7}, {0, 7, 10}, {0, 10, 11},
+        {1, 5, 9}, {5, 11, 4}, {11, 10, 2}, {10, 7, 6}, {7, 1, 8},
+        {3, 9, 4}, {3, 4, 2}, {3, 2, 6}, {3, 6, 8}, {3, 8, 9},
+        {4, 9, 5}, {2, 4, 11}, {6, 2, 10}, {8, 6, 7}, {9, 8, 1},
+    };
+
+    // Vertex ids: 12 corners, then n - 1 per edge, then the face interiors.
+    // Each face point is (i, j, k) steps towards corners (a, b, c), i + j + k = n.
+    int edge_ids[12][12];
+    int num_edges = 0;
+    for (int a = 0; a < 12; a++) {
+        for (int b = 0; b < 12; b++) edge_ids[a][b] = -1;
+    }
+    for (int f = 0; f < 20; f++) {
+        for (int e = 0; e < 3; e++) {
+            int a = faces[f][e], b = faces[f][(e + 1) % 3];
+            if (a > b) { int tmp = a; a = b; b = tmp; }
+            if (edge_ids[a][b] < 0) edge_ids[a][b] = num_edges++;
+        }
+    }
+    int per_face = (n - 1) * (n - 2) / 2;
+    int num_vertices = 12 + num_edges * (n - 1) + 20 * (per_face > 0 ? per_face : 0);
+    Mesh* mesh = gen_alloc_mesh(num_vertices, 20 * n * n);
+
+    int* ids = (int*)malloc((size_t)(n + 1) * (n + 1) * sizeof(int));
+    int* t_out = mesh->triangles;
+    for (int f = 0; f < 20; f++) {
+        const int a = faces[f][0], b = faces[f][1], c = faces[f][2];
+        int interior = 0;
+        for (int i = 0; i <= n; i++) {
+            for (int j = 0; i + j <= n; j++) {
+                int k = n - i - j;
+                int id;
+                if (i == n) id = a;
+                else if (j == n) id = b;
+                else if (k == n) id = c;
+                else if (k == 0 || i == 0 || j == 0) {
+                    // Edge point: s steps from the lower-numbered end
+                    int p, q, s;
+                    if (k == 0) { p = a; q = b; s = j; }
+                    else if (i == 0) { p = b; q = c; s = k; }
+                    else { p = c; q = a; s = i; }
+                    if (p > q) { int tmp = p; p = q; q = tmp; s = n - s; }
+                    id = 12 + edge_ids[p][q] * (n - 1) + (s - 1);
+                } else {
+                    id = 12 + num_edges * (n - 1) + f * per_face + interior++;
+                }
+                ids[i * (n + 1) + j] = id;
+
+                double x = (i * corners[a][0] + j * corners[b][0] + k * corners[c][0]) / n;
+                double y = (i * corners[a][1] + j * corners[b][1] + k * corners[c][1]) / n;
+                double z = (i * corners[a][2] + j * corners[b][2] + k * corners[c][2]) / n;
+                double len = sqrt(x * x + y * y + z * z);
+                mesh->vertices[id * 3 + 0] = (float)(x / len);
+                mesh->vertices[id * 3 + 1] = (float)(y / len);
+                mesh->vertices[id * 3 + 2] = (float)(z / len);
+            }
+        }
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; i + j < n; j++) {
+                int v0 = ids[i * (n + 1) + j];
+                int v1 = ids[(i + 1) * (n + 1) + j];
+                int v2 = ids[i * (n + 1) + j + 1];
+                *t_out++ = v0; *t_out++ = v1; *t_out++ = v2;
+                if (i + j + 1 < n) {
+                    int v3 = ids[(i + 1) * (n + 1) + j + 1];
+                    *t_out++ = v1; *t_out++ = v3; *t_out++ = v2;
+                }
+            }
+        }
+    }
+    free(ids);
+    return mesh;
+}
+
+/**
+ * @brief Open grid with a lattice of circular holes (about 2 * nx * ny
+ *        triangles less the holes)
+ * @param holes Holes along each axis
+ */
+static inline Mesh* gen_grid_with_holes(int nx, int ny, int holes) {
+    Mesh* mesh = gen_grid(nx, ny);
+    float radius = 0.3f / holes;
+
+    int kept = 0;
+    for (int f = 0; f < mesh->num_triangles; f++) {
+        const int* tri = &mesh->triangles[f * 3];
+        float cx = 0.0f, cy = 0.0f;
+        for (int j = 0; j < 3; j++) {
+            cx += mesh->vertices[tri[j] * 3 + 0] / 3.0f;
+            cy += mesh->vertices[tri[j] * 3 + 1] / 3.0f;
+        }
+        // Distance to the nearest hole centre on the lattice
+        float hx = (floorf(cx * holes) + 0.5f) / holes - cx;
+        float hy = (floorf(cy * holes) + 0.5f) / holes - cy;
+        if (hx * hx + hy * hy < radius * radius) continue;
+        for (int j = 0; j < 3; j++) mesh->triangles[kept * 3 + j] = tri[j];
+        kept++;
+    }
+    mesh->num_triangles = kept;
+    gen_compact_mesh(mesh);
+    return mesh;
+}
+
+/**
+ * @brief Scan-like height field: bumpy surface with vertex jitter and
+ *        randomly dropped triangles, like a raw range-scan mesh
+ * @param dropout Fraction of triangles removed (e.g. 0.01)
+ */
+static inline Mesh* gen_noisy_scan(int nx, int ny, float dropout, unsigned int seed) {
+    Mesh* mesh = gen_grid(nx, ny);
+    float cell = 1.0f / (nx > ny ? nx : ny);
+
+    for (int v = 0; v < mesh->num_vertices; v++) {
+        float* p = &mesh->vertices[v * 3];
+        float x = p[0], y = p[1];
+        p[0] += (gen_noise(v * 3 + 0, seed) - 0.5f) * 0.4f * cell;
+        p[1] += (gen_noise(v * 3 + 1, seed) - 0.5f) * 0.4f * cell;
+        p[2] = 0.15f * sinf(6.0f * x) * cosf(5.0f * y) +
+               0.05f * sinf(23.0f * x + 17.0f * y) +
+               (gen_noise(v * 3 + 2, seed) - 0.5f) * 0.5f * cell;
+    }
+
+    int kept = 0;
+    for (int f = 0; f < mesh->num_triangles; f++) {
+        if (gen_noise(f, seed ^ 0xD5u) < dropout) continue;
+        for (int j = 0; j < 3; j++) mesh->triangles[kept * 3 + j] = mesh->triangles[f * 3 + j];
+        kept++;
+    }
+    mesh->num_triangles = kept;
+    gen_compact_mesh(mesh);
+    return mesh;
+}
+
+#endif /* MESH_GENERATORS_H */
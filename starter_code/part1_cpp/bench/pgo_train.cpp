@@ -0,0 +1,123 @@
+/**
+ * @file pgo_train.cpp
+ * @brief Training workload for profile-guided optimisation builds
+ *
+ * Run by the pgo_training target of a UVUNWRAP_PGO=GENERATE build (see the
+ * pgo-* presets in CMakePresets.json). It parses every test_data OBJ and
+ * unwraps it, plus the benchmark generator meshes, with the parameter
+ * sets the farm uses most, so the profile weighs OBJ parsing, topology
+ * building and LSCM assembly the way production does. Results are only
+ * sanity-checked; the point is the branch and call counts.
+ *
+ * Usage: pgo_train [mesh_dir] [scale]   (scale multiplies the generator sizes, default 1)
+ */
+
+#include "mesh.h"
+#include "unwrap.h"
+#include "lscm.h"
+#include "unwrap_cache.h"
+#include "uv_log.h"
+#include "mesh_generators.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+
+#ifndef TEST_DATA_DIR
+#define TEST_DATA_DIR "../test_data/meshes/"
+#endif
+
+static const char* MESH_NAMES[] = {"01_cube.obj", "02_cylinder.obj", "03_sphere.obj", "04_torus.obj"};
+
+/** Parameter set `variant`, from the default pipeline to the heavier ones */
+static void train_params(int variant, UnwrapParams* params) {
+    unwrap_params_default(params);
+    switch (variant) {
+    case 1:
+        params->seam_method = SEAM_METHOD_MST;
+        params->pack_method = PACK_METHOD_SKYLINE;
+        break;
+    case 2:
+        params->lscm_method = LSCM_METHOD_ABF;
+        params->pack_method = PACK_METHOD_RASTER;
+        break;
+    case 3:
+        params->arap_iterations = 2;
+        params->pack_method = PACK_METHOD_MAXRECTS;
+        break;
+    default:
+        break;
+    }
+}
+static const int NUM_VARIANTS = 4;
+
+/** Unwraps `mesh` with every variant; returns the number of failed calls */
+static int train_mesh(const char* name, const Mesh* mesh) {
+    int failures = 0;
+    for (int v = 0; v < NUM_VARIANTS; v++) {
+        UnwrapParams params;
+        train_params(v, &params);
+        UnwrapResult* result = NULL;
+        Mesh* out = unwrap_mesh(mesh, &params, &result);
+        if (!out) {
+            printf("  %s: variant %d failed\n", name, v);
+            failures++;
+        }
+        if (out) free_mesh(out);
+        if (result) free_unwrap_result(result);
+    }
+    return failures;
+}
+
+int main(int argc, char** argv) {
+    const char* mesh_dir = argc > 1 ? argv[1] : TEST_DATA_DIR;
+    int scale = argc > 2 ? atoi(argv[2]) : 1;
+    if (scale < 1) scale = 1;
+
+    // Cached results would skip the stages being profiled
+    unwrap_cache_configure(NULL, 0);
+    uv_set_log_level(UV_LOG_SILENT);
+
+    auto start = std::chrono::steady_clock::now();
+    int failures = 0, meshes = 0;
+
+    // OBJ parsing is profiled by loading each file a few times
+    for (size_t m = 0; m < sizeof(MESH_NAMES) / sizeof(MESH_NAMES[0]); m++) {
+        char filename[512];
+        snprintf(filename, sizeof(filename), "%s%s", mesh_dir, MESH_NAMES[m]);
+        Mesh* mesh = NULL;
+        for (int rep = 0; rep < 8; rep++) {
+            if (mesh) free_mesh(mesh);
+            mesh = load_obj(filename);
+            if (!mesh) break;
+        }
+        if (!mesh) {
+            printf("  could not load %s\n", filename);
+            failures++;
+            continue;
+        }
+        failures += train_mesh(MESH_NAMES[m], mesh);
+        free_mesh(mesh);
+        meshes++;
+    }
+
+    struct {
+        const char* name;
+        Mesh* mesh;
+    } generated[] = {
+        {"grid", gen_grid(64 * scale, 64 * scale)},
+        {"torus", gen_torus(96 * scale, 48 * scale, 1.0f, 0.3f)},
+        {"icosphere", gen_icosphere(16 * scale)},
+        {"grid_with_holes", gen_grid_with_holes(64 * scale, 64 * scale, 4)},
+        {"noisy_scan", gen_noisy_scan(64 * scale, 64 * scale, 0.05f, 7u)},
+    };
+    for (size_t g = 0; g < sizeof(generated) / sizeof(generated[0]); g++) {
+        failures += train_mesh(generated[g].name, generated[g].mesh);
+        free_mesh(generated[g].mesh);
+        meshes++;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("PGO training: %d meshes x %d parameter sets in %.2f s, %d failed\n",
+           meshes, NUM_VARIANTS, seconds, failures);
+    return failures == 0 ? 0 : 1;
+}
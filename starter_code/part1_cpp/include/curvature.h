@@ -0,0 +1,46 @@
+/**
+ * @file curvature.h
+ * @brief Discrete curvature kernels (corner angles, angular defect)
+ */
+
+#ifndef CURVATURE_H
+#define CURVATURE_H
+
+#include "mesh.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Compute the three corner angles of every triangle
+ *
+ * Triangles are processed in SoA blocks so the angle math vectorises.
+ * angles_out[f*3 + j] is the angle (radians) at corner triangles[f*3 + j].
+ * Corners with a zero-length edge get π/2, matching
+ * compute_vertex_angle_in_triangle().
+ *
+ * @param mesh Input mesh
+ * @param angles_out Output array (3 * num_triangles)
+ * @param num_threads Worker count (0 = choose from mesh size)
+ */
+void compute_corner_angles(const Mesh* mesh, float* angles_out, int num_threads);
+
+/**
+ * @brief Compute angular defect (2π - sum of corner angles) for all vertices
+ *
+ * The corner angles are computed in parallel, then scatter-added in face
+ * order, so the defects are the same for every thread count.
+ *
+ * @param mesh Input mesh
+ * @param defects_out Output array (num_vertices)
+ * @param num_threads Worker count (0 = choose from mesh size)
+ * @return 0 on success, -1 on invalid arguments
+ */
+int compute_angular_defects(const Mesh* mesh, float* defects_out, int num_threads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CURVATURE_H */
@@ -9,6 +9,7 @@
 #define LSCM_H
 
 #include "mesh.h"
+#include "mesh_reorder.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -44,6 +45,387 @@ float* lscm_parameterize(const Mesh* mesh,
                          const int* face_indices,
                          int num_faces);
 
+/**
+ * @brief Sparse solver backend for the reduced LSCM system
+ *
+ * The reduced system (pinned DOFs eliminated) is symmetric positive
+ * definite, so the Cholesky backends apply. CHOLMOD and PARDISO are only
+ * available when the library was configured with UVUNWRAP_WITH_CHOLMOD /
+ * UVUNWRAP_WITH_PARDISO; requesting an unavailable backend falls back to
+ * LSCM_SOLVER_LDLT with a warning.
+ *
+ * LSCM_SOLVER_MULTIGRID targets islands too large to factor: it decimates
+ * the island by edge collapses into levels of about a quarter of the
+ * vertices each and factors only the coarsest. The coarse UVs are
+ * interpolated back up level by level, with a V-cycle correction on each,
+ * as the starting guess; CG preconditioned by the same V-cycle (Gauss-
+ * Seidel smoothing) then finishes on the island. Memory and the cost of
+ * an iteration are linear in the island size, and the coarse levels take
+ * care of the low-frequency error plain CG converges on slowly.
+ *
+ * LSCM_SOLVER_CUDA_CG builds the same hierarchy and full-multigrid start
+ * on the host, then uploads the reduced system once (matrix, right-hand
+ * side and start) and runs Jacobi-preconditioned CG on a CUDA device;
+ * only two scalars per iteration come back. It needs a build with
+ * UVUNWRAP_WITH_CUDA and a device at run time; otherwise, or if the
+ * device fails, the island is solved with LSCM_SOLVER_MULTIGRID.
+ */
+typedef enum {
+    LSCM_SOLVER_AUTO = 0,        /**< CHOLMOD if available, else SimplicialLDLT (default) */
+    LSCM_SOLVER_LDLT = 1,        /**< Eigen::SimplicialLDLT */
+    LSCM_SOLVER_LLT = 2,         /**< Eigen::SimplicialLLT */
+    LSCM_SOLVER_LU = 3,          /**< Eigen::SparseLU (general unsymmetric) */
+    LSCM_SOLVER_CHOLMOD = 4,     /**< SuiteSparse CHOLMOD supernodal LLT */
+    LSCM_SOLVER_PARDISO = 5,     /**< Intel MKL PARDISO LDLT */
+    LSCM_SOLVER_CG = 6,          /**< Preconditioned conjugate gradient (iterative) */
+    LSCM_SOLVER_MULTIGRID = 7,   /**< Edge-collapse hierarchy, V-cycle preconditioned CG (iterative) */
+    LSCM_SOLVER_CUDA_CG = 8      /**< Multigrid start, Jacobi CG on a CUDA device (iterative) */
+} LscmSolver;
+
+/**
+ * @brief Preconditioner for LSCM_SOLVER_CG
+ */
+typedef enum {
+    LSCM_PRECONDITIONER_JACOBI = 0,  /**< Diagonal (Jacobi), cheapest per iteration (default) */
+    LSCM_PRECONDITIONER_ICHOL = 1    /**< Incomplete Cholesky */
+} LscmPreconditioner;
+
+/**
+ * @brief Floating-point precision of the LSCM assembly and solve
+ *
+ * Single precision halves the memory traffic of the factorisation and
+ * the solves. One refinement step (residual in double, correction from
+ * the float factorisation) recovers most of the double-precision
+ * accuracy for one extra solve on well-conditioned islands; very large
+ * islands can be too ill-conditioned for float to converge at all.
+ * CHOLMOD, PARDISO, multigrid and CUDA CG are double only and ignore this;
+ * LSCM_SOLVER_AUTO picks SimplicialLDLT for float modes.
+ */
+typedef enum {
+    LSCM_PRECISION_DOUBLE = 0,         /**< Assemble and solve in double (default) */
+    LSCM_PRECISION_FLOAT = 1,          /**< Assemble and solve in float */
+    LSCM_PRECISION_FLOAT_REFINED = 2   /**< Float solve plus one double-precision refinement step */
+} LscmPrecision;
+
+/**
+ * @brief Fill-reducing ordering of the Eigen direct solvers
+ *
+ * The ordering decides the factor's fill-in, so its memory and the cost
+ * of factorisation and solves. It is computed with the symbolic analysis,
+ * once per island pattern when the solve goes through an LscmPlan.
+ * CHOLMOD and PARDISO use their own orderings and ignore this, as do the
+ * iterative solvers. METIS needs a build with UVUNWRAP_WITH_METIS; other
+ * builds fall back to the AUTO choice with a warning.
+ */
+typedef enum {
+    LSCM_ORDERING_AUTO = 0,      /**< AMD for LDLT and LLT, COLAMD for LU (default) */
+    LSCM_ORDERING_AMD = 1,       /**< Approximate minimum degree */
+    LSCM_ORDERING_COLAMD = 2,    /**< Column approximate minimum degree */
+    LSCM_ORDERING_METIS = 3,     /**< METIS nested dissection */
+    LSCM_ORDERING_NATURAL = 4    /**< Island vertex order, no reordering */
+} LscmOrdering;
+
+/**
+ * @brief How the two pinned vertices of an island are chosen
+ *
+ * Candidates are the island's boundary vertices, or all of its vertices
+ * for a closed island. The same rule applies at every boundary size.
+ */
+typedef enum {
+    LSCM_PIN_AUTO = 0,            /**< LSCM_PIN_DOUBLE_SWEEP (default) */
+    LSCM_PIN_DOUBLE_SWEEP = 1,    /**< Repeated farthest-point sweeps, O(B) */
+    LSCM_PIN_PRINCIPAL_AXIS = 2,  /**< Extremes along the candidates' principal axis, O(B) */
+    LSCM_PIN_FARTHEST_PAIR = 3    /**< Exact farthest pair, O(B^2) */
+} LscmPinMethod;
+
+/**
+ * @brief How an island's conformal map is fixed
+ *
+ * The LSCM energy is invariant under translation, rotation and scale of
+ * the UVs. The pinned method removes that freedom by fixing two vertices,
+ * so the layout depends on which two are chosen. The spectral method
+ * (spectral conformal parameterisation, Mullen et al. 2008) pins nothing:
+ * it takes the smallest nontrivial generalised eigenvector of
+ * L_C x = lambda B x. L_C is the unreduced LSCM matrix and B is the
+ * boundary vertex mass, or the lumped area mass for a closed island.
+ * The eigenvector is found by shift-invert subspace iteration on one
+ * direct factorisation of L_C + sigma B. Spectral solves run in double
+ * and do not use the plan. When an island fails to converge it is
+ * solved pinned instead.
+ *
+ * The ABF++ method (Sheffer et al. 2005) first optimises the corner
+ * angles to be as close to the 3D ones (scaled to sum to 2 pi at interior
+ * vertices) as a flat mesh allows, with Newton steps that each factor
+ * only a Schur complement over the interior vertices (size 2 V) with the
+ * island's direct backend. Pinned LSCM then lays out triangles of those
+ * angles instead of the 3D triangles, which lowers angle distortion on
+ * curved and hard-surface islands. If ABF++ fails the island is solved
+ * with its 3D angles.
+ */
+typedef enum {
+    LSCM_METHOD_PINNED = 0,    /**< Two pinned vertices, see LscmPinMethod (default) */
+    LSCM_METHOD_SPECTRAL = 1,  /**< Pin-free spectral conformal map */
+    LSCM_METHOD_ABF = 2        /**< ABF++ angles, laid out by pinned LSCM */
+} LscmMethod;
+
+/**
+ * @brief Opaque symbolic-factorisation cache ("plan")
+ *
+ * Caches, per island connectivity + pin choice + backend, the system
+ * layout and the direct solver's ordering/symbolic factorisation, so
+ * repeated solves of a deforming mesh only run the numeric factorisation.
+ * A plan may be shared by concurrent solves.
+ */
+typedef struct LscmPlan LscmPlan;
+
+/**
+ * @brief LSCM solve options
+ *
+ * A zero value selects the default for every field. Use
+ * lscm_options_default() to initialise.
+ *
+ * With LSCM_SOLVER_AUTO, islands with more than iterative_threshold
+ * vertices are solved with LSCM_SOLVER_MULTIGRID instead of a direct
+ * factorisation. CG starts from initial_uvs when given (e.g. the previous
+ * unwrap of the same mesh), otherwise from a uniform Tutte embedding of
+ * the island; multigrid ignores initial_uvs.
+ *
+ * arap_iterations > 0 refines each solved island with that many
+ * as-rigid-as-possible local/global iterations (Liu et al. 2008), which
+ * trade some angle preservation for much less area distortion. Each
+ * iteration fits a rotation per triangle and solves the island's
+ * cotangent Laplacian, factored once with the island's direct backend
+ * (SimplicialLDLT for CG and multigrid islands); a plan keeps that
+ * factorisation's symbolic analysis too. arap_time_limit stops an island
+ * after the iteration that exceeds it. Islands that fell back to a
+ * planar projection are not refined.
+ *
+ * should_cancel, when set, is polled at the start of a solve, every few
+ * hundred triangles of assembly and between the iterations of CG,
+ * multigrid, spectral, ABF++ and ARAP. Once it returns nonzero the solve
+ * stops and fails without trying the fallback ladder. A direct
+ * factorisation in progress is not interrupted.
+ *
+ * vertex_order renumbers an island's vertices (Reverse Cuthill-McKee, a
+ * Morton curve or vertex-cache order) and its faces after them before the
+ * system is assembled, so assembly and the iterative solvers walk memory
+ * in order.
+ * UVs and vertices_out are mapped back to the input order; results match
+ * VERTEX_ORDER_INPUT up to round-off, except the pins AUTO picks between
+ * equal candidates may differ.
+ *
+ * Islands of at most 40 vertices solved with LSCM_SOLVER_AUTO in double
+ * precision and without a plan skip the sparse pattern, CSC structure
+ * and symbolic analysis: their reduced system is assembled into a small
+ * fixed-capacity dense matrix and factored with a dense LDLT
+ * (LscmReport::dense). The UVs match the sparse solve up to round-off;
+ * an island whose dense factor is not positive definite takes the sparse
+ * path and its fallback ladder.
+ *
+ * An island of 32768 faces or more is assembled in blocks of 256 faces,
+ * coloured so that blocks of one colour share no vertex; num_threads
+ * workers scatter a colour's blocks at once. Its sums are taken in colour
+ * order whatever num_threads is, so they may differ from a smaller
+ * island's face order by round-off. An island whose face order is too
+ * scattered to colour (e.g. shuffled; see vertex_order) is assembled on
+ * the calling thread.
+ */
+typedef struct {
+    int solver;                  /**< LscmSolver (default LSCM_SOLVER_AUTO) */
+    int iterative_threshold;     /**< AUTO switches to multigrid above this many vertices (0 = 500000, < 0 = never) */
+    int cg_max_iterations;       /**< CG iteration cap (0 = 2000) */
+    double cg_tolerance;         /**< CG relative residual tolerance (0 = 1e-8) */
+    int cg_preconditioner;       /**< LscmPreconditioner (default LSCM_PRECONDITIONER_JACOBI) */
+    const float* initial_uvs;    /**< Optional warm start, per mesh vertex [u,v, ...] (may be NULL) */
+    LscmPlan* plan;              /**< Optional factorisation cache (may be NULL) */
+    int pin_method;              /**< LscmPinMethod (default LSCM_PIN_AUTO) */
+    const int* pinned_vertices;  /**< Optional mesh vertices to pin: an island containing two of
+                                      them pins the first two listed instead of using pin_method */
+    int num_pinned_vertices;     /**< Entries in pinned_vertices */
+    int precision;               /**< LscmPrecision (default LSCM_PRECISION_DOUBLE) */
+    int multigrid_coarse_vertices;  /**< Multigrid: coarsest level size, solved directly (0 = 4000) */
+    int multigrid_smoothing;     /**< Multigrid: Gauss-Seidel sweeps either side of each coarse correction (0 = 1) */
+    int method;                  /**< LscmMethod (default LSCM_METHOD_PINNED) */
+    int arap_iterations;         /**< ARAP refinement iterations per island (0 = off) */
+    double arap_time_limit;      /**< ARAP time budget per island in seconds (0 = none) */
+    int (*should_cancel)(void* user_data);  /**< Optional cancellation poll, may be called from
+                                                 several solves at once (may be NULL) */
+    void* cancel_user_data;      /**< Passed to should_cancel */
+    int ordering;                /**< LscmOrdering (default LSCM_ORDERING_AUTO) */
+    int vertex_order;            /**< VertexOrder of the island's vertices and faces before
+                                      assembly (default VERTEX_ORDER_INPUT) */
+    int num_threads;             /**< Threads assembling an island of 32768 faces or more
+                                      (0 or 1 = the calling thread); the UVs do not depend on it */
+} LscmOptions;
+
+/**
+ * @brief Rung of the fallback ladder an island solve ended on
+ *
+ * When the requested solve fails (factorisation or solve error, CG or
+ * multigrid not reaching cg_tolerance within cg_max_iterations, or a
+ * non-finite result) the island is retried within the
+ * same call: first the system with a tiny Tikhonov term added to its
+ * diagonal, which pins down unknowns the energy leaves free; then that
+ * system with another direct backend; and finally a planar projection,
+ * which cannot fail. Only an island of fewer than 3 vertices fails.
+ */
+typedef enum {
+    LSCM_FALLBACK_NONE = 0,           /**< The requested solve succeeded */
+    LSCM_FALLBACK_REGULARIZED = 1,    /**< (A + lambda I) x = b, lambda = 1e-8 mean |diag(A)|, direct */
+    LSCM_FALLBACK_ALT_SOLVER = 2,     /**< Same system with SparseLU (SimplicialLDLT if LU just failed) */
+    LSCM_FALLBACK_PLANAR = 3          /**< Projection onto the island's area-weighted mean plane */
+} LscmFallback;
+
+/**
+ * @brief Closed-form layout an island got instead of a solve
+ *
+ * With LSCM_SOLVER_AUTO and the pinned method, an island whose LSCM
+ * energy can reach zero is laid out directly: a planar island (every
+ * vertex within 1e-6 of its bounding box diagonal from the plane of its
+ * area-weighted normal) by orthographic projection, a disk with no
+ * angular defect at its interior vertices by unfolding its triangles
+ * across their shared edges. Either layout is only used once every
+ * triangle is verified to keep its edge lengths and orientation, and it is
+ * mapped by the similarity that puts the pins where pinned LSCM puts them,
+ * so the UVs match a solve up to round-off. Nothing is assembled or
+ * factored, and the ARAP pass is skipped since the layout is already
+ * isometric.
+ */
+typedef enum {
+    LSCM_CLOSED_FORM_NONE = 0,      /**< The island was solved */
+    LSCM_CLOSED_FORM_PLANAR = 1,    /**< Projection onto the island's plane */
+    LSCM_CLOSED_FORM_UNFOLDED = 2   /**< Developable disk unfolded edge by edge */
+} LscmClosedForm;
+
+/**
+ * @brief Per-island solve report
+ */
+typedef struct {
+    int solver;                  /**< LscmSolver actually used */
+    long long factor_nonzeros;   /**< Nonzeros in the factor(s), 0 if unknown */
+    int iterations;              /**< CG iterations (0 for direct solvers; V-cycle preconditioned for
+                                      multigrid; subspace iterations for spectral) */
+    double residual;             /**< CG relative residual (0 for direct solvers except after a float
+                                      refinement step; eigen residual for spectral) */
+    int plan_hit;                /**< 1 if the solve reused a cached plan entry */
+    long long matrix_nonzeros;   /**< Nonzeros in the reduced normal matrix A */
+    long long assembly_ns;       /**< Time filling A and b */
+    long long factor_ns;         /**< Numeric factorisation (direct), preconditioner setup (CG), or
+                                      hierarchy build, coarse factorisation and setups (multigrid) */
+    long long solve_ns;          /**< Triangular solves (direct) or CG iterations */
+    int precision;               /**< LscmPrecision actually used */
+    int fallback;                /**< LscmFallback: ladder rung that produced the UVs */
+    int method;                  /**< LscmMethod actually used */
+    int angle_iterations;        /**< ABF++ Newton iterations (0 unless method is LSCM_METHOD_ABF) */
+    long long angle_ns;          /**< Time optimising ABF++ angles */
+    int arap_iterations;         /**< ARAP iterations run (0 when off or skipped) */
+    long long arap_ns;           /**< Time in the ARAP pass, factorisation included */
+    long long peak_bytes;        /**< Solver memory held at once: the island's system, factor(s),
+                                      solve vectors and ARAP pass, from their sizes */
+    int ordering;                /**< LscmOrdering actually used (AUTO for solvers with their own
+                                      ordering or none) */
+    int dense;                   /**< 1 if the island was small enough to be solved as a dense
+                                      system (see LscmOptions) */
+    int closed_form;             /**< LscmClosedForm; the solver fields are zero unless NONE */
+} LscmReport;
+
+/**
+ * @brief Fill options with the default LSCM options
+ * @param options Options to initialise
+ */
+void lscm_options_default(LscmOptions* options);
+
+/**
+ * @brief Create an empty LSCM plan
+ * @param max_entries Cache capacity in islands (0 = 256); the cache is
+ *        cleared when it fills up
+ * @return New plan, free with lscm_plan_free()
+ */
+LscmPlan* lscm_plan_create(int max_entries);
+
+/**
+ * @brief Free an LSCM plan
+ * @param plan Plan to free (may be NULL)
+ */
+void lscm_plan_free(LscmPlan* plan);
+
+/**
+ * @brief Check whether a solver backend was compiled in
+ *
+ * LSCM_SOLVER_CUDA_CG also needs a CUDA device at run time.
+ *
+ * @param solver Backend to query
+ * @return 1 if available, 0 otherwise
+ */
+int lscm_solver_available(LscmSolver solver);
+
+/**
+ * @brief Check whether a fill-reducing ordering was compiled in
+ * @param ordering Ordering to query
+ * @return 1 if available, 0 otherwise
+ */
+int lscm_ordering_available(LscmOrdering ordering);
+
+/**
+ * @brief Parameterize a UV island using LSCM with explicit options
+ * @param mesh Input mesh
+ * @param face_indices Indices of faces in this island
+ * @param num_faces Number of faces in island
+ * @param options Solve options (NULL for defaults)
+ * @param report_out Optional solve report (may be NULL)
+ * @return Array of UVs [u,v, u,v, ...] for vertices in island, or NULL on error or cancellation
+ * @note Caller must free returned array
+ */
+float* lscm_parameterize_with_options(const Mesh* mesh,
+                                      const int* face_indices,
+                                      int num_faces,
+                                      const LscmOptions* options,
+                                      LscmReport* report_out);
+
+/**
+ * @brief Parameterize a UV island into a caller-provided buffer
+ *
+ * Same as lscm_parameterize_with_options() but without allocating the
+ * result, for callers that manage their own scratch memory.
+ *
+ * @param uvs_out Output UVs in local vertex order (first-seen order over
+ *        face_indices); must hold 2 * 3 * num_faces floats
+ * @param vertices_out Optional: mesh vertex index of each local vertex;
+ *        must hold 3 * num_faces ints
+ * @param vertex_remap Optional scratch of mesh->num_vertices ints, all -1;
+ *        restored to -1 on return so it can be reused across islands
+ *        (NULL allocates one per call)
+ * @return Number of island vertices written, or -1 on error or cancellation
+ */
+int lscm_parameterize_into(const Mesh* mesh,
+                           const int* face_indices,
+                           int num_faces,
+                           const LscmOptions* options,
+                           LscmReport* report_out,
+                           float* uvs_out,
+                           int* vertices_out,
+                           int* vertex_remap);
+
+/**
+ * @brief Predict LscmReport::peak_bytes of a solve before running it
+ *
+ * Runs only the fill-reducing ordering and symbolic factorisation of the
+ * island's vertex graph, so schedulers can budget solves by the memory
+ * their factor will take (see UnwrapParams::memory_budget). Covers the
+ * system, factor and solve vectors; ABF++ and ARAP post-passes are not
+ * included.
+ *
+ * @param mesh Input mesh
+ * @param face_indices Indices of faces in this island
+ * @param num_faces Number of faces in island
+ * @param options Solve options (NULL for defaults)
+ * @return Predicted bytes, or 0 for an island too small to solve
+ */
+long long lscm_estimate_peak_bytes(const Mesh* mesh,
+                                   const int* face_indices,
+                                   int num_faces,
+                                   const LscmOptions* options);
+
 /**
  * @brief Helper: Find boundary vertices in an island
  * @param mesh Input mesh
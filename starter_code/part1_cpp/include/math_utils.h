@@ -2,7 +2,8 @@
  * @file math_utils.h
  * @brief Math utilities for vector operations
  *
- * PROVIDED - Implementation in math_utils.cpp
+ * PROVIDED - Implementation in math_utils.cpp (scalar, wrapping the
+ * inline versions in src/vec_math.h) and math_batch.cpp (SoA batches)
  */
 
 #ifndef MATH_UTILS_H
@@ -63,6 +64,68 @@ float compute_vertex_angle_in_triangle(const Mesh* mesh,
                                        int tri_idx,
                                        int vert_idx);
 
+/*
+ * Batch operations on structure-of-arrays data. Blocks of triangles are
+ * gathered into SoA arrays and processed with SSE2, AVX, AVX-512 or NEON
+ * when the library is compiled for them (see math_batch_isa()); results
+ * match the scalar functions above. A UVUNWRAP_MULTI_ISA build carries
+ * AVX2 and AVX-512 copies and uses the widest the CPU supports.
+ */
+
+/**
+ * @brief Edge vectors e1 = p1 - p0 and e2 = p2 - p0 of triangles
+ *        [begin, begin + count) as SoA arrays of count floats
+ */
+void triangle_edges_soa(const Mesh* mesh, int begin, int count,
+                        float* e1x, float* e1y, float* e1z,
+                        float* e2x, float* e2y, float* e2z);
+
+/**
+ * @brief o = a × b for n SoA vectors (o may alias neither a nor b)
+ */
+void vec3_cross_soa(int n,
+                    const float* ax, const float* ay, const float* az,
+                    const float* bx, const float* by, const float* bz,
+                    float* ox, float* oy, float* oz);
+
+/**
+ * @brief out = |v| for n SoA vectors
+ */
+void vec3_length_soa(int n, const float* x, const float* y, const float* z, float* out);
+
+/**
+ * @brief Unnormalised normals (p1 - p0) × (p2 - p0) of triangles
+ *        [begin, begin + count) as SoA arrays
+ */
+void triangle_normals_soa(const Mesh* mesh, int begin, int count,
+                          float* nx, float* ny, float* nz);
+
+/**
+ * @brief Areas of triangles [begin, begin + count)
+ */
+void triangle_areas_batch(const Mesh* mesh, int begin, int count, float* areas);
+
+/**
+ * @brief Lengths of count edges given as vertex pairs
+ * @param edges Vertex indices (edges[2i], edges[2i + 1]) per edge
+ */
+void edge_lengths_batch(const Mesh* mesh, const int* edges, int count, float* lengths);
+
+/**
+ * @brief SIMD path of the batch functions: "avx512", "avx", "sse2", "neon"
+ *        or "scalar"
+ */
+const char* math_batch_isa(void);
+
+/**
+ * @brief Force one of the compiled SIMD paths, e.g. to compare them
+ * @param isa Name as returned by math_batch_isa(), or NULL to go back to
+ *        the widest the CPU supports
+ * @return 0 on success, -1 if that path is not compiled in or the CPU
+ *         cannot run it
+ */
+int math_batch_set_isa(const char* isa);
+
 #ifdef __cplusplus
 }
 #endif
@@ -33,12 +33,29 @@ typedef struct {
 
 /**
  * @brief Load mesh from OBJ file
+ *
+ * Faces may have any number of corners (fan-triangulated), each v,
+ * v/vt, v/vt/vn or v//vn, with absolute or negative (relative) indices.
+ * Lines may be of any length.
+ *
  * @param filename Path to OBJ file
  * @return Newly allocated mesh, or NULL on error
  * @note Caller must free with free_mesh()
  */
 Mesh* load_obj(const char* filename);
 
+/**
+ * @brief Load mesh from OBJ file using a memory-mapped, multi-threaded parser
+ *
+ * Produces the same mesh as load_obj(), parsing newline-aligned chunks
+ * of the file on several threads.
+ *
+ * @param filename Path to OBJ file
+ * @return Newly allocated mesh, or NULL on error
+ * @note Caller must free with free_mesh()
+ */
+Mesh* load_obj_fast(const char* filename);
+
 /**
  * @brief Save mesh to OBJ file
  * @param mesh Mesh to save
@@ -47,6 +64,19 @@ Mesh* load_obj(const char* filename);
  */
 int save_obj(const Mesh* mesh, const char* filename);
 
+/**
+ * @brief Save mesh to OBJ file using buffered, multi-threaded formatting
+ *
+ * Same layout as save_obj(), but floats are written with the shortest
+ * decimal that reads back to the same value, so a save/load round trip
+ * is exact.
+ *
+ * @param mesh Mesh to save
+ * @param filename Output path
+ * @return 0 on success, -1 on error
+ */
+int save_obj_fast(const Mesh* mesh, const char* filename);
+
 /**
  * @brief Free mesh memory
  * @param mesh Mesh to free
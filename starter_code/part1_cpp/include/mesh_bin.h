@@ -0,0 +1,107 @@
+/**
+ * @file mesh_bin.h
+ * @brief Binary mesh + unwrap result container with zero-copy loading
+ *
+ * A versioned little-endian file holding the Mesh arrays and, optionally,
+ * an UnwrapResult. Each section starts on a 64-byte boundary and carries
+ * its own checksum, so an uncompressed file can be mapped and its Mesh
+ * fields pointed straight into the mapping.
+ */
+
+#ifndef MESH_BIN_H
+#define MESH_BIN_H
+
+#include "mesh.h"
+#include "unwrap.h"
+#include "uv_quantize.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Per-section compression
+ *
+ * Sections that do not shrink are stored uncompressed. Compressed
+ * sections are decompressed into heap memory on load.
+ */
+typedef enum {
+    MESH_BIN_COMPRESSION_NONE = 0,  /**< Raw arrays, loaded without copying (default) */
+    MESH_BIN_COMPRESSION_LZ4 = 1,   /**< LZ4 (needs UVUNWRAP_WITH_LZ4) */
+    MESH_BIN_COMPRESSION_ZSTD = 2   /**< Zstandard (needs UVUNWRAP_WITH_ZSTD) */
+} MeshBinCompression;
+
+/**
+ * @brief Loaded binary mesh; owns the mapping its arrays point into
+ */
+typedef struct MeshBin MeshBin;
+
+/**
+ * @brief Check whether a compression codec was compiled in
+ * @return 1 if available, 0 otherwise
+ */
+int mesh_bin_compression_available(MeshBinCompression compression);
+
+/**
+ * @brief Save mesh (and optionally an unwrap result) to a binary file
+ * @param mesh Mesh to save
+ * @param result Unwrap result to store alongside, or NULL
+ * @param filename Output path
+ * @param compression Section compression (unavailable codecs fall back to NONE)
+ * @return 0 on success, -1 on error
+ */
+int save_mesh_bin(const Mesh* mesh,
+                  const UnwrapResult* result,
+                  const char* filename,
+                  MeshBinCompression compression);
+
+/**
+ * @brief save_mesh_bin() with 16-bit UVs
+ *
+ * The UVs are stored quantised (see uv_quantize.h), in half the bytes of
+ * floats, and load_mesh_bin() decodes them back to floats. The per-island
+ * grid takes its islands from result->face_island_ids, which the file
+ * then stores too.
+ *
+ * @param options Quantisation options (NULL = defaults)
+ * @return 0 on success, -1 on error or if quantize_uvs() refuses the UVs
+ */
+int save_mesh_bin_quantized(const Mesh* mesh,
+                            const UnwrapResult* result,
+                            const char* filename,
+                            MeshBinCompression compression,
+                            const UvQuantizeOptions* options);
+
+/**
+ * @brief Load a binary mesh file
+ * @param filename Path to file written by save_mesh_bin()
+ * @param verify Verify section checksums and triangle indices (reads the
+ *        whole file; without it pages are only touched when used)
+ * @return Loaded file, or NULL on error
+ * @note Caller must free with free_mesh_bin()
+ */
+MeshBin* load_mesh_bin(const char* filename, int verify);
+
+/**
+ * @brief Mesh whose arrays point into the loaded file
+ * @note Valid until free_mesh_bin(); do not pass to free_mesh(). The
+ *       mapping is copy-on-write, so the arrays may be modified in memory.
+ */
+Mesh* mesh_bin_mesh(MeshBin* bin);
+
+/**
+ * @brief Unwrap result stored in the file, or NULL if it has none
+ * @note Valid until free_mesh_bin(); do not pass to free_unwrap_result()
+ */
+const UnwrapResult* mesh_bin_result(const MeshBin* bin);
+
+/**
+ * @brief Release a loaded binary mesh and its mapping
+ */
+void free_mesh_bin(MeshBin* bin);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MESH_BIN_H */
@@ -0,0 +1,120 @@
+/**
+ * @file mesh_formats.h
+ * @brief Binary PLY and glTF 2.0 binary (GLB) mesh files
+ *
+ * Both readers map the file and copy each array once into the Mesh:
+ * tightly packed float positions and 32-bit triangle indices go over with
+ * a single memcpy, other layouts through one strided pass. Only
+ * positions, triangles and one UV set are read.
+ *
+ * UVs follow the OBJ convention (v up) in memory. glTF stores v down, so
+ * TEXCOORD_0 is flipped on the way in and out.
+ *
+ * Files are little-endian; on big-endian hosts every function fails.
+ */
+
+#ifndef MESH_FORMATS_H
+#define MESH_FORMATS_H
+
+#include "mesh.h"
+#include "uv_quantize.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Load a binary_little_endian PLY file
+ *
+ * Reads the x, y, z vertex properties (any numeric type), the face
+ * element's vertex_indices (or vertex_index) list, fan-triangulating
+ * polygons, and u/v, s/t or texture_u/texture_v as UVs. Other elements
+ * and properties are skipped.
+ *
+ * @param filename Path to PLY file
+ * @return Newly allocated mesh, or NULL on error (ASCII PLY included)
+ * @note Caller must free with free_mesh()
+ */
+Mesh* load_ply(const char* filename);
+
+/**
+ * @brief Save mesh as binary_little_endian PLY
+ *
+ * Vertices get float x, y, z (and u, v if the mesh has UVs), faces a
+ * uchar/int vertex_indices list.
+ *
+ * @return 0 on success, -1 on error
+ */
+int save_ply(const Mesh* mesh, const char* filename);
+
+/**
+ * @brief Load a GLB file
+ *
+ * Every triangle primitive (mode 4) of every mesh is appended, with node
+ * transforms ignored. Primitives that share a POSITION accessor share
+ * their vertices. TEXCOORD_0 is read when every vertex has one, as float
+ * or normalised unsigned byte or short. Sparse accessors and buffers outside the file are rejected.
+ *
+ * @param filename Path to GLB file
+ * @return Newly allocated mesh, or NULL on error
+ * @note Caller must free with free_mesh()
+ */
+Mesh* load_glb(const char* filename);
+
+/**
+ * @brief Save mesh as a GLB with one triangle primitive
+ *
+ * Float POSITION and TEXCOORD_0 (if the mesh has UVs) and uint32
+ * indices, all in one buffer.
+ *
+ * @return 0 on success, -1 on error
+ */
+int save_glb(const Mesh* mesh, const char* filename);
+
+/**
+ * @brief save_glb() with TEXCOORD_0 as normalised unsigned shorts
+ *
+ * Half the bytes of float UVs, in core glTF 2.0. The UVs must lie in
+ * [0,1]², and only the global grid applies (a per-island grid request
+ * falls back to it); quantize_uvs() checks the grid against
+ * options->texture_size.
+ *
+ * @param options Quantisation options (NULL = defaults)
+ * @return 0 on success, -1 on error, UVs outside [0,1]² or added overlap
+ */
+int save_glb_quantized(const Mesh* mesh, const char* filename, const UvQuantizeOptions* options);
+
+/**
+ * @brief Copy a GLB and give it the mesh's UVs
+ *
+ * The mesh must be source as load_glb() read it, vertex for vertex (an
+ * unwrap with UV_OUTPUT_SHARED keeps that). Its UVs are appended to the
+ * binary chunk as one new bufferView, with one TEXCOORD_0 accessor per
+ * vertex range. Geometry, materials and every other part of the file are
+ * kept as they are.
+ *
+ * @param source GLB the mesh was loaded from
+ * @param mesh Mesh with UVs
+ * @param filename Output path (may not be source)
+ * @return 0 on success, -1 on error or if the vertex count differs
+ */
+int save_glb_uvs(const char* source, const Mesh* mesh, const char* filename);
+
+/**
+ * @brief Load OBJ, PLY or GLB by file extension
+ *
+ * .ply and .glb (any case) go to load_ply() and load_glb(), anything else
+ * to load_obj_fast().
+ */
+Mesh* load_mesh(const char* filename);
+
+/**
+ * @brief Save OBJ, PLY or GLB by file extension (OBJ via save_obj_fast())
+ */
+int save_mesh(const Mesh* mesh, const char* filename);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MESH_FORMATS_H */
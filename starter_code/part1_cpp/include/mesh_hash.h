@@ -0,0 +1,61 @@
+/**
+ * @file mesh_hash.h
+ * @brief Fast content hashes of meshes for result caches
+ *
+ * Non-cryptographic 64-bit hashes in the style of XXH3 (wide multiply-
+ * accumulate over 64-byte stripes), not bit-compatible with xxHash.
+ * Inputs are split into fixed 1 MiB chunks hashed in parallel, so a
+ * hash never depends on the thread count. Values are stable across
+ * platforms of the same endianness.
+ */
+
+#ifndef MESH_HASH_H
+#define MESH_HASH_H
+
+#include "mesh.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Hash a byte buffer
+ * @param data Bytes to hash (may be NULL if size is 0)
+ * @param size Number of bytes
+ * @param seed Seed; different seeds give independent hashes
+ * @param num_threads Worker threads for large buffers (0 = automatic)
+ * @return 64-bit hash
+ */
+uint64_t uv_hash_bytes(const void* data, size_t size, uint64_t seed, int num_threads);
+
+/**
+ * @brief Hash a mesh's geometry and connectivity
+ *
+ * Covers vertex positions, triangles and both counts, but not UVs.
+ *
+ * @param mesh Mesh to hash
+ * @param num_threads Worker threads (0 = automatic)
+ * @return 64-bit hash (0 for NULL)
+ */
+uint64_t uv_mesh_hash(const Mesh* mesh, int num_threads);
+
+/**
+ * @brief Hash a mesh's connectivity only
+ *
+ * Covers triangles and the vertex count, so it stays the same when
+ * vertices move: key for results that depend only on connectivity, such
+ * as LSCM symbolic plans or seam tables.
+ *
+ * @param mesh Mesh to hash
+ * @param num_threads Worker threads (0 = automatic)
+ * @return 64-bit hash (0 for NULL)
+ */
+uint64_t uv_mesh_topology_hash(const Mesh* mesh, int num_threads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MESH_HASH_H */
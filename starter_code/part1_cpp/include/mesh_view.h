@@ -0,0 +1,159 @@
+/**
+ * @file mesh_view.h
+ * @brief Lazily built, memoised analyses of one mesh
+ *
+ * A MeshView wraps an input mesh and builds each analysis (face flags,
+ * topology, adjacency, defects, seams, islands, boundary loops) the first
+ * time something asks for it, then keeps it for every later caller. A
+ * caller that only needs islands from existing seams never pays for seam
+ * detection, and unwrap_mesh_view() reuses whatever an earlier seam or
+ * island query already built instead of rebuilding and discarding it.
+ *
+ * Returned pointers are owned by the view and stay valid until
+ * mesh_view_free(). All functions may be called from several threads at
+ * once; each analysis is built once, under the view's lock.
+ */
+
+#ifndef MESH_VIEW_H
+#define MESH_VIEW_H
+
+#include "mesh.h"
+#include "topology.h"
+#include "unwrap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Opaque view of one mesh with its memoised analyses
+ */
+typedef struct MeshView MeshView;
+
+/**
+ * @brief Number of times each analysis of a view has been built
+ *
+ * Every count is 0 or 1 for the analyses that do not take arguments;
+ * seams count once per distinct (angle, method) and islands once per
+ * distinct seam set asked for.
+ */
+typedef struct {
+    int face_flag_builds;
+    int topology_builds;         /**< Half-edges and TopologyInfo together */
+    int adjacency_builds;
+    int manifold_builds;
+    int seam_builds;
+    int island_builds;
+    int boundary_loop_builds;
+} MeshViewStats;
+
+/**
+ * @brief Create a view of mesh; nothing is built yet
+ * @param mesh Input mesh, borrowed: it must outlive the view and not change
+ * @param num_threads Worker threads of the builds (0 = automatic by mesh size)
+ * @return New view, or NULL on invalid input; free with mesh_view_free()
+ */
+MeshView* mesh_view_create(const Mesh* mesh, int num_threads);
+
+/**
+ * @brief Free a view and every analysis it built
+ * @param view View to free (may be NULL)
+ */
+void mesh_view_free(MeshView* view);
+
+/**
+ * @brief The mesh the view was created on
+ */
+const Mesh* mesh_view_mesh(const MeshView* view);
+
+/**
+ * @brief classify_faces() output (mesh->num_triangles FaceFlag bit sets)
+ * @param num_flagged_out Optional: number of flagged faces
+ * @return Flags, or NULL on error
+ */
+const unsigned char* mesh_view_face_flags(MeshView* view, int* num_flagged_out);
+
+/**
+ * @brief Topology as build_topology() gives it, checked with validate_topology() once
+ *
+ * Built from the same half-edge view unwrap_mesh() uses, with faces that
+ * repeat a corner left unjoined.
+ *
+ * @return Topology, or NULL on error
+ */
+const TopologyInfo* mesh_view_topology(MeshView* view);
+
+/**
+ * @brief build_adjacency() of the view's topology
+ * @return Adjacency, or NULL on error
+ */
+const AdjacencyInfo* mesh_view_adjacency(MeshView* view);
+
+/**
+ * @brief Non-manifold edge and vertex counts as unwrap_mesh() reports them
+ *
+ * Counted on the topology's half-edges, so faces that repeat a corner
+ * are not counted against their neighbours; num_split_vertices is 0.
+ *
+ * @return Report, or NULL on error
+ */
+const ManifoldReport* mesh_view_defects(MeshView* view);
+
+/**
+ * @brief Seams as unwrap_mesh() detects them for angle_threshold and method
+ *
+ * Memoised per (angle_threshold, method) pair.
+ *
+ * @param num_seams_out Output: number of seam edges
+ * @return Ascending seam edge indices into mesh_view_topology(), or NULL on error
+ */
+const int* mesh_view_seams(MeshView* view, float angle_threshold, SeamMethod method, int* num_seams_out);
+
+/**
+ * @brief extract_islands() after cutting the given seams
+ *
+ * The last seam set's islands are kept: asking again with the same edges
+ * (for instance the array mesh_view_seams() returned) is free, other edges
+ * replace them, which invalidates pointers to the previous islands and
+ * boundary loops.
+ *
+ * @param seam_edges Seam edge indices into mesh_view_topology() (may be NULL if num_seams is 0)
+ * @param num_seams Number of seams
+ * @return Islands, or NULL on error
+ */
+const IslandInfo* mesh_view_islands(MeshView* view, const int* seam_edges, int num_seams);
+
+/**
+ * @brief build_boundary_loops() of the islands mesh_view_islands() last returned
+ *
+ * Without islands yet, the loops of the whole mesh as one island.
+ *
+ * @return Loops, or NULL on error
+ */
+const BoundaryLoops* mesh_view_boundary_loops(MeshView* view);
+
+/**
+ * @brief Build counts so far
+ */
+void mesh_view_stats(const MeshView* view, MeshViewStats* stats_out);
+
+/**
+ * @brief unwrap_mesh_ctx() on the view's mesh, sharing its analyses
+ *
+ * Face flags, topology and the seams for params' angle and method are
+ * taken from the view (and built into it if missing), so a later unwrap,
+ * seam query or island query of the same view does not rebuild them.
+ * The output equals unwrap_mesh_ctx() on the same mesh.
+ *
+ * @param ctx Context (NULL = a temporary one, as unwrap_mesh() uses)
+ */
+Mesh* unwrap_mesh_view(UnwrapContext* ctx,
+                       MeshView* view,
+                       const UnwrapParams* params,
+                       UnwrapResult** result_out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MESH_VIEW_H */
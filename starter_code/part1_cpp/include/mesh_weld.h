@@ -0,0 +1,58 @@
+/**
+ * @file mesh_weld.h
+ * @brief Merge coincident vertices of triangle-soup meshes
+ *
+ * Exports that duplicate every triangle's vertices share no edges, so
+ * topology sees each triangle as its own island. Welding merges vertices
+ * that lie within a distance tolerance and remaps the triangles onto the
+ * survivors, in linear time on a parallel spatial hash grid.
+ */
+
+#ifndef MESH_WELD_H
+#define MESH_WELD_H
+
+#include "mesh.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Summary of a weld
+ */
+typedef struct {
+    int num_input_vertices;      /**< Vertices before welding */
+    int num_output_vertices;     /**< Vertices after welding */
+    int num_removed_triangles;   /**< Triangles dropped because welding collapsed two corners */
+} MeshWeldStats;
+
+/**
+ * @brief Weld vertices closer than epsilon
+ *
+ * Vertices are bucketed into a hash grid with cells epsilon wide. Each
+ * vertex is merged into the lowest-indexed vertex within epsilon found in
+ * its 27 neighbouring cells, and merges are followed transitively, so a
+ * chain of close vertices collapses into its first vertex. Survivors keep
+ * their input order; output triangles keep theirs, minus those left with
+ * a repeated corner. UVs, if present, are taken from the survivor.
+ *
+ * @param mesh Input mesh
+ * @param epsilon Distance tolerance (<= 0 merges only bit-identical positions)
+ * @param num_threads Worker threads (0 = automatic by mesh size)
+ * @param remap_out Optional caller buffer of mesh->num_vertices entries,
+ *        filled with the output vertex of each input vertex
+ * @param stats_out Optional summary
+ * @return Newly allocated welded mesh, or NULL on invalid input
+ * @note Caller must free with free_mesh()
+ */
+Mesh* weld_vertices(const Mesh* mesh,
+                    float epsilon,
+                    int num_threads,
+                    int* remap_out,
+                    MeshWeldStats* stats_out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MESH_WELD_H */
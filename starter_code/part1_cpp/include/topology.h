@@ -29,6 +29,65 @@ typedef struct {
                                  f1 = -1 for boundary edges */
 } TopologyInfo;
 
+/**
+ * @brief Per-vertex and per-face adjacency in compressed sparse row form
+ *
+ * Built from a TopologyInfo in one linear pass so later stages can query
+ * neighbours in O(1) instead of scanning all edges or triangles.
+ *
+ * - Faces around vertex v: vert_faces[vert_face_offsets[v] .. vert_face_offsets[v+1])
+ * - Edges around vertex v: vert_edges[vert_edge_offsets[v] .. vert_edge_offsets[v+1])
+ * - Edges of face f: face_edges[f*3 + i] is the edge (tri[i], tri[(i+1)%3])
+ */
+typedef struct {
+    int num_vertices;        /**< Number of vertices */
+    int num_faces;           /**< Number of faces */
+
+    int* vert_face_offsets;  /**< CSR offsets into vert_faces (num_vertices + 1) */
+    int* vert_faces;         /**< Incident faces, ascending per vertex (3 * num_faces) */
+
+    int* vert_edge_offsets;  /**< CSR offsets into vert_edges (num_vertices + 1) */
+    int* vert_edges;         /**< Incident edges, ascending per vertex (2 * num_edges) */
+
+    int* face_edges;         /**< Edge index of each triangle side (3 * num_faces) */
+} AdjacencyInfo;
+
+/**
+ * @brief Ordered island boundary loops in compressed sparse row form
+ *
+ * An edge is on an island's boundary if exactly one of its faces belongs
+ * to the island (open edges and edges between islands). Loops are
+ * grouped by island and follow the face winding:
+ *
+ * - Vertices of loop l: loop_vertices[loop_offsets[l] .. loop_offsets[l+1])
+ * - Loops of island i: island_loop_offsets[i] .. island_loop_offsets[i+1]
+ * - loop_edges[k] is the edge from loop_vertices[k] to the next vertex of
+ *   its loop (wrapping around)
+ */
+typedef struct {
+    int num_loops;             /**< Number of loops */
+    int num_islands;           /**< Number of islands */
+
+    int* loop_offsets;         /**< CSR offsets into loop_vertices / loop_edges (num_loops + 1) */
+    int* loop_vertices;        /**< Loop vertices in walk order */
+    int* loop_edges;           /**< TopologyInfo edge of each loop side (-1 for a side of a
+                                    non-manifold edge beyond its first two faces) */
+    int* loop_islands;         /**< Island of each loop (num_loops) */
+    int* island_loop_offsets;  /**< Loop range of each island (num_islands + 1) */
+} BoundaryLoops;
+
+/**
+ * @brief Edge extraction strategy used by build_topology_with_strategy()
+ *
+ * Both strategies pack each edge into a 64-bit key and produce identical
+ * output; they differ only in how duplicate keys are grouped.
+ */
+typedef enum {
+    TOPOLOGY_BUILD_SORT = 0,     /**< LSD radix sort of all half-edge keys (default) */
+    TOPOLOGY_BUILD_HASH = 1,     /**< Open-addressing hash table, then sort unique edges */
+    TOPOLOGY_BUILD_PARALLEL = 2  /**< The sort strategy on all cores (build_topology_parallel()) */
+} TopologyBuildStrategy;
+
 /**
  * @brief Build topology from mesh
  *
@@ -38,20 +97,176 @@ typedef struct {
  * 3. For each edge, find adjacent faces (1 or 2)
  * 4. Validate using Euler characteristic
  *
+ * Edges are sorted by (v0, v1). face0 is the lowest-index adjacent face.
+ *
  * @param mesh Input mesh
  * @return Newly allocated topology info, or NULL on error
  * @note Caller must free with free_topology()
- *
- * IMPLEMENTATION REQUIRED
+ * @note Equivalent to build_topology_with_strategy(mesh, TOPOLOGY_BUILD_SORT)
  */
 TopologyInfo* build_topology(const Mesh* mesh);
 
+/**
+ * @brief Build topology using an explicit edge extraction strategy
+ * @param mesh Input mesh
+ * @param strategy Edge grouping strategy
+ * @return Newly allocated topology info, or NULL on error
+ * @note Caller must free with free_topology()
+ */
+TopologyInfo* build_topology_with_strategy(const Mesh* mesh,
+                                           TopologyBuildStrategy strategy);
+
+/**
+ * @brief Build topology with the sort strategy on several threads
+ *
+ * Triangles are sliced into one contiguous range per thread; each range
+ * emits its edge keys, histograms them for a parallel stable radix sort,
+ * and writes the edges whose groups start in it. The output is identical
+ * to build_topology() for any thread count.
+ *
+ * Edges shared by more than two faces are non-manifold: as in
+ * build_topology(), edge_faces lists only the lowest and highest of them.
+ * They are counted and logged as a warning instead of passing silently.
+ *
+ * @param mesh Input mesh
+ * @param num_threads Worker threads (0 = automatic by mesh size)
+ * @param num_nonmanifold_edges_out Optional: number of non-manifold edges
+ * @return Newly allocated topology info, or NULL on error
+ * @note Caller must free with free_topology()
+ */
+TopologyInfo* build_topology_parallel(const Mesh* mesh,
+                                      int num_threads,
+                                      int* num_nonmanifold_edges_out);
+
 /**
  * @brief Free topology memory
  * @param topo Topology to free
  */
 void free_topology(TopologyInfo* topo);
 
+/**
+ * @brief Build CSR vertex/face/edge adjacency for a mesh
+ * @param mesh Input mesh
+ * @param topo Topology built from the same mesh
+ * @return Newly allocated adjacency info, or NULL on error
+ * @note Caller must free with free_adjacency()
+ */
+AdjacencyInfo* build_adjacency(const Mesh* mesh, const TopologyInfo* topo);
+
+/**
+ * @brief Free adjacency memory
+ * @param adj Adjacency to free
+ */
+void free_adjacency(AdjacencyInfo* adj);
+
+/**
+ * @brief Extract the ordered boundary loops of every island
+ *
+ * Linear in the mesh size: one pass builds twins from the topology, then
+ * each island's loops are walked from its own faces only.
+ *
+ * @param mesh Input mesh
+ * @param topo Topology built from the same mesh
+ * @param face_island_ids Island id per face (NULL: the whole mesh is island 0)
+ * @param num_islands Number of islands (ids are in [0, num_islands))
+ * @return Newly allocated loops, or NULL on error
+ * @note Caller must free with free_boundary_loops()
+ */
+BoundaryLoops* build_boundary_loops(const Mesh* mesh,
+                                    const TopologyInfo* topo,
+                                    const int* face_island_ids,
+                                    int num_islands);
+
+/**
+ * @brief Free boundary loop memory
+ * @param loops Loops to free
+ */
+void free_boundary_loops(BoundaryLoops* loops);
+
+/**
+ * @brief Counts from check_manifold() and repair_nonmanifold()
+ */
+typedef struct {
+    int num_nonmanifold_edges;     /**< Edges shared by more than two faces */
+    int num_nonmanifold_vertices;  /**< Vertices whose faces form more than one fan
+                                        (bowties and ends of non-manifold edges) */
+    int num_split_vertices;        /**< Vertex copies added by repair_nonmanifold() */
+} ManifoldReport;
+
+/**
+ * @brief Detect non-manifold edges and vertices in one linear pass
+ *
+ * Builds the half-edge view, which counts edges with more than two faces,
+ * then groups each vertex's corners into fans (faces connected through
+ * shared edges around it); a vertex with more than one fan is
+ * non-manifold.
+ *
+ * @param mesh Input mesh
+ * @param report_out Optional counts
+ * @return 1 if manifold, 0 if not, -1 on invalid input
+ */
+int check_manifold(const Mesh* mesh, ManifoldReport* report_out);
+
+/**
+ * @brief Split non-manifold vertices into one vertex per fan
+ *
+ * A vertex's first fan (by lowest corner) keeps its index; every other
+ * fan gets a copy appended after the input vertices, with the same
+ * position and UV. Faces past the first two on a non-manifold edge are
+ * not joined to it, so cutting its endpoints into fans separates them
+ * into manifold edges. Triangles keep their order, and corner c of the
+ * output refers to a copy of the input corner c's vertex.
+ *
+ * @param mesh Input mesh
+ * @param report_out Optional counts (num_split_vertices is the number of copies)
+ * @return Newly allocated mesh (a plain copy if already manifold), or NULL
+ *         on invalid input
+ * @note Caller must free with free_mesh()
+ */
+Mesh* repair_nonmanifold(const Mesh* mesh, ManifoldReport* report_out);
+
+/**
+ * @brief Degeneracy bits per face, as written by classify_faces()
+ *
+ * A face can carry several bits (a repeated corner also has zero area).
+ */
+typedef enum {
+    FACE_FLAG_DUPLICATE_INDEX = 1,  /**< Two corners name the same vertex */
+    FACE_FLAG_ZERO_AREA = 2,        /**< Area below 1e-8, which LSCM cannot use */
+    FACE_FLAG_SLIVER = 4            /**< Height below 1e-5 of the longest edge */
+} FaceFlag;
+
+/**
+ * @brief Flag degenerate faces in one vectorised pass
+ *
+ * The unwrap pipeline runs this first and leaves flagged faces out of
+ * every stage that would fail on them: faces with a repeated corner are
+ * not joined to their neighbours, edges next to a flagged face are never
+ * seams, and LSCM solves each island without its flagged faces, whose
+ * remaining corners then take a neighbouring corner's UV.
+ *
+ * @param mesh Input mesh
+ * @param flags_out Caller buffer of mesh->num_triangles FaceFlag bit sets
+ * @param num_threads Worker threads (0 = automatic by mesh size)
+ * @return Number of flagged faces, or -1 on invalid input
+ */
+int classify_faces(const Mesh* mesh, unsigned char* flags_out, int num_threads);
+
+/**
+ * @brief Edge indices of vertex pairs
+ *
+ * The pairs go into a hash table, then one pass over the topology's
+ * edges resolves them, so the cost is O(num_edges + num_pairs) and the
+ * memory follows num_pairs.
+ *
+ * @param topo Topology
+ * @param edge_vertices Vertex pairs [a,b, a,b, ...] in either order (2 * num_pairs)
+ * @param num_pairs Number of pairs
+ * @param edges_out Caller buffer of num_pairs edge indices, -1 where a pair is not an edge
+ * @return Number of pairs that are edges, or -1 on invalid input
+ */
+int find_topology_edges(const TopologyInfo* topo, const int* edge_vertices, int num_pairs, int* edges_out);
+
 /**
  * @brief Validate topology using Euler characteristic
  * @param mesh Original mesh
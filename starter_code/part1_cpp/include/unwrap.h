@@ -3,6 +3,14 @@
  * @brief Main UV unwrapping API
  *
  * API SKELETON - YOU IMPLEMENT IN unwrap.cpp, seam_detection.cpp, packing.cpp
+ *
+ * Thread safety: every function is reentrant. Calls on different meshes,
+ * results and contexts may run concurrently from any number of threads;
+ * inputs are only read, so several calls may also share one const Mesh or
+ * UnwrapParams. The library keeps no per-call state in globals. The only
+ * process-wide state is the default log sink and level (uv_log.h) and the
+ * result cache (unwrap_cache.h), both synchronised internally; a context
+ * can take its own sink with unwrap_context_set_log_callback().
  */
 
 #ifndef UNWRAP_H
@@ -10,47 +18,365 @@
 
 #include "mesh.h"
 #include "topology.h"
+#include "uv_log.h"
+#include "uv_histogram.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * @brief Seam detection engine
+ */
+typedef enum {
+    SEAM_METHOD_BFS = 0,         /**< Unweighted BFS spanning tree on the dual graph (default) */
+    SEAM_METHOD_MST = 1,         /**< Dihedral/length-weighted minimum spanning tree (Kruskal) */
+    SEAM_METHOD_COST = 2,        /**< Charts merged while predicted solve time + distortion + packing waste drops */
+    SEAM_METHOD_CUT_GRAPH = 3    /**< Shortest-path cut graph through the vertices whose angular defect
+                                      reaches angle_threshold, opened to a disk and pruned */
+} SeamMethod;
+
+/**
+ * @brief Island packing engine
+ */
+typedef enum {
+    PACK_METHOD_SHELF = 0,       /**< Rows of boxes sorted by height, scaled to fit (default) */
+    PACK_METHOD_SKYLINE = 1,     /**< Skyline bottom-left into the smallest square found */
+    PACK_METHOD_MAXRECTS = 2,    /**< MaxRects best-short-side-fit into the smallest square found */
+    PACK_METHOD_RASTER = 3       /**< Island silhouettes on a bit grid into the smallest square found */
+} PackMethod;
+
+/**
+ * @brief Island orientation freedom while packing
+ */
+typedef enum {
+    PACK_ROTATION_NONE = 0,      /**< Keep the LSCM orientation (default) */
+    PACK_ROTATION_90 = 1,        /**< Allow 90° turns of the bounding box */
+    PACK_ROTATION_MIN_AREA = 2   /**< Turn to the minimum-area bounding box, then allow 90° */
+} PackRotation;
+
+/**
+ * @brief Vertex layout of the unwrapped mesh
+ *
+ * UVs are stored per vertex, so with UV_OUTPUT_SHARED a vertex on a seam
+ * (or chart border) gets the UV of the last island containing it and the
+ * other islands' faces there are distorted. UV_OUTPUT_SPLIT_VERTICES
+ * gives every island its own copy of the vertices it uses, so each face
+ * corner keeps its island's UV; UnwrapResult.vertex_remap maps the copies
+ * back to the input vertices.
+ */
+typedef enum {
+    UV_OUTPUT_SHARED = 0,          /**< Output vertices are the input vertices (default) */
+    UV_OUTPUT_SPLIT_VERTICES = 1   /**< One output vertex per (island, input vertex) */
+} UvOutput;
+
+/**
+ * @brief How the topology edge sort, seam candidate sorts and packing's
+ *        island sorts use threads
+ *
+ * The sorts are stable, so every policy gives the same output.
+ */
+typedef enum {
+    SORT_POLICY_AUTO = 0,        /**< Split across num_threads workers when large enough (default) */
+    SORT_POLICY_SEQUENTIAL = 1,  /**< Sort on the calling thread */
+    SORT_POLICY_PARALLEL = 2     /**< Always split across num_threads workers */
+} SortPolicy;
+
+/**
+ * @brief Device that runs the quality metrics and the coverage rasteriser
+ *
+ * The CUDA backend exists in builds with UVUNWRAP_WITH_CUDA and is used
+ * only when a device is found at run time; otherwise, or if the device
+ * fails, the CPU path runs. Coverage, overlap and texel counts match the
+ * CPU exactly; stretch and angle metrics match to round-off.
+ */
+typedef enum {
+    COMPUTE_BACKEND_AUTO = 0,  /**< CUDA for large jobs when a device is present, else CPU (default) */
+    COMPUTE_BACKEND_CPU = 1,   /**< Always the CPU */
+    COMPUTE_BACKEND_CUDA = 2   /**< CUDA whenever a device is present */
+} ComputeBackend;
+
+/**
+ * @brief Reuse of one island's UVs for its copies
+ *
+ * Islands whose faces list the same corners in the same order and whose
+ * edge lengths agree up to one uniform scale (copies of a part moved,
+ * mirrored or scaled) are grouped by a topology and a geometry hash, and
+ * verified edge by edge. Only the first island of each group in solve
+ * order is solved; the others get its UVs, which is what their own solve
+ * would give up to round-off (or, with tied pin candidates, a rotation).
+ * Islands with degenerate faces, and every island when pinned_vertices is
+ * set, are solved on their own. Sessions solve every island.
+ */
+typedef enum {
+    ISLAND_INSTANCING_NONE = 0,    /**< Solve every island (default) */
+    ISLAND_INSTANCING_REUSE = 1,   /**< Copy UVs to instances; pack them like any island */
+    ISLAND_INSTANCING_STACK = 2    /**< Copy UVs and pack each instance onto its representative */
+} IslandInstancing;
+
+/**
+ * @brief How islands are sized relative to each other before packing
+ *
+ * Each island comes out of its solve normalised to the unit square, so
+ * by default a bolt and a hull plate get the same UV size. UNIFORM
+ * scales every island to the same UV length per mesh length (its 3D and
+ * UV areas come from the metrics kernel), times the importance of its
+ * faces when UnwrapParams::face_importance is set, so one texture size
+ * gives every island the same texel density (UnwrapResult::uv_density,
+ * texture_size_for_density()). UDIM packing always scales this way.
+ */
+typedef enum {
+    ISLAND_SCALE_NORMALIZED = 0,   /**< Every island fills the unit square before packing (default) */
+    ISLAND_SCALE_UNIFORM = 1       /**< Every island at the same texel density */
+} IslandScale;
+
+/**
+ * @brief Pipeline stage reported to UnwrapProgress
+ */
+typedef enum {
+    UNWRAP_STAGE_TOPOLOGY = 0,   /**< Face classification and topology */
+    UNWRAP_STAGE_SEAMS = 1,      /**< Seam detection */
+    UNWRAP_STAGE_ISLANDS = 2,    /**< Island extraction and chart splitting */
+    UNWRAP_STAGE_SOLVE = 3,      /**< Island parameterisation */
+    UNWRAP_STAGE_PACKING = 4,    /**< Island packing */
+    UNWRAP_STAGE_METRICS = 5,    /**< Quality metrics */
+    UNWRAP_STAGE_DONE = 6        /**< Finished; fraction is 1 */
+} UnwrapStage;
+
+/**
+ * @brief Progress callback of unwrap_mesh()
+ *
+ * Called when a stage starts and after every island solve. The calls of
+ * one unwrap are serialised (never concurrent) but may come from worker
+ * threads.
+ * Returning nonzero cancels the unwrap, like UnwrapParams::cancel.
+ *
+ * @param stage UnwrapStage
+ * @param islands_done Islands solved so far
+ * @param num_islands Islands to solve (0 until islands are extracted)
+ * @param fraction Estimated fraction of the whole unwrap done, in [0, 1]
+ *        and non-decreasing; the solve stage spans most of it, by faces
+ * @param user_data UnwrapParams::progress_user_data
+ * @return 0 to continue, nonzero to cancel
+ */
+typedef int (*UnwrapProgress)(int stage, int islands_done, int num_islands, float fraction, void* user_data);
+
+/**
+ * @brief Per-face distributions recorded by the quality metrics
+ *
+ * Each non-NULL histogram gets one value per measured face added to what
+ * it already holds, so one set can collect many meshes. Degenerate faces
+ * are not recorded.
+ */
+typedef struct {
+    UvHistogram* stretch;            /**< σmax/σmin of the UV→3D Jacobian */
+    UvHistogram* angle_distortion;   /**< Largest corner angle error (radians) */
+} MetricsHistograms;
+
 /**
  * @brief Unwrapping parameters
+ *
+ * Fields after island_margin are optional: a zero value selects the
+ * default behaviour. Use unwrap_params_default() to initialise.
  */
 typedef struct {
     float angle_threshold;       /**< Seam detection angle threshold (degrees) */
     int min_island_faces;        /**< Minimum island size (merge smaller islands) */
     int pack_islands;            /**< If true, pack islands into [0,1]² */
     float island_margin;         /**< Spacing between islands (e.g., 0.02) */
+    int seam_method;             /**< SeamMethod (default SEAM_METHOD_BFS) */
+    int num_threads;             /**< Island solve workers (0 = one per core) */
+    int solver;                  /**< LscmSolver (default LSCM_SOLVER_AUTO) */
+    int cg_threshold;            /**< AUTO uses CG above this many island vertices (0 = 500000, < 0 = never) */
+    int cg_max_iterations;       /**< CG iteration cap (0 = 2000) */
+    float cg_tolerance;          /**< CG relative residual tolerance (0 = 1e-8) */
+    int cg_preconditioner;       /**< LscmPreconditioner (default Jacobi) */
+    struct LscmPlan* lscm_plan;  /**< Optional LSCM factorisation cache reused across calls (may be NULL) */
+    int pack_method;             /**< PackMethod (default PACK_METHOD_SHELF) */
+    int pack_rotation;           /**< PackRotation (default PACK_ROTATION_NONE) */
+    float texel_density;         /**< UDIM: texels per mesh unit (0 = largest that fits udim_tiles) */
+    int udim_tiles;              /**< UDIM: tile count (0 = as many as texel_density needs) */
+    int udim_resolution;         /**< UDIM: texels per tile side (0 = 1024) */
+    int pin_method;              /**< LscmPinMethod (default LSCM_PIN_AUTO) */
+    const int* pinned_vertices;  /**< Optional vertices to pin, see LscmOptions (may be NULL) */
+    int num_pinned_vertices;     /**< Entries in pinned_vertices */
+    int lscm_precision;          /**< LscmPrecision (default LSCM_PRECISION_DOUBLE) */
+    int max_chart_faces;         /**< Split larger islands into charts of about this many faces (0 = no limit) */
+    float max_chart_angle;       /**< Split islands whose face normals stray further than this many
+                                      degrees from their chart's mean normal (0 = no limit) */
+    int uv_output;               /**< UvOutput (default UV_OUTPUT_SHARED) */
+    int lscm_method;             /**< LscmMethod (default LSCM_METHOD_PINNED) */
+    int arap_iterations;         /**< ARAP refinement iterations per island, see LscmOptions (0 = off) */
+    float arap_time_limit;       /**< ARAP time budget per island in seconds (0 = none) */
+    UnwrapProgress progress;     /**< Optional progress callback of unwrap_mesh() (may be NULL) */
+    void* progress_user_data;    /**< Passed to progress */
+    const volatile int* cancel;  /**< Optional flag: unwrap_mesh() stops soon after another thread
+                                      sets it nonzero (may be NULL) */
+    int sort_policy;             /**< SortPolicy (default SORT_POLICY_AUTO) */
+    long long memory_budget;     /**< Bytes of tracked memory (see UnwrapStats) island solves are started
+                                      under, each predicted by lscm_estimate_peak_bytes(); an island that
+                                      does not fit waits while smaller ones run (0 = no limit) */
+    int lscm_ordering;           /**< LscmOrdering of direct island solves (default LSCM_ORDERING_AUTO) */
+    int vertex_order;            /**< VertexOrder each island is renumbered in before its solve, see
+                                      LscmOptions (default VERTEX_ORDER_INPUT) */
+    int compute_backend;         /**< ComputeBackend of the quality metrics (default COMPUTE_BACKEND_AUTO) */
+    const int* seam_edges;       /**< Optional user seams as vertex pairs [a,b, a,b, ...] (2 * num_seam_edges).
+                                      When set, seam detection is skipped and islands are cut along
+                                      exactly these edges (none if num_seam_edges is 0), closed islands
+                                      then opened as by extract_islands(); pairs that are not edges
+                                      are ignored with a warning (may be NULL) */
+    int num_seam_edges;          /**< Pairs in seam_edges */
+    int island_instancing;       /**< IslandInstancing (default ISLAND_INSTANCING_NONE) */
+    int island_scale;            /**< IslandScale of the [0,1]² packers (default ISLAND_SCALE_NORMALIZED) */
+    const float* face_importance; /**< Optional texel density weight per input face (num_triangles): with
+                                      ISLAND_SCALE_UNIFORM or UDIM packing an island's density is
+                                      proportional to the area-weighted mean of its faces' weights,
+                                      1 where that mean is not positive (may be NULL = all 1) */
+    int output_order;            /**< VertexOrder of the returned mesh (default VERTEX_ORDER_INPUT);
+                                      VERTEX_ORDER_CACHE gives draw-ready vertex-cache order. Result
+                                      arrays follow it; vertex_remap and face_remap lead back */
+    MetricsHistograms* metrics_histograms; /**< Optional histograms the quality metrics add every face to
+                                      (nothing is recorded for a result cache hit); calls running
+                                      at once must not share them (may be NULL) */
 } UnwrapParams;
 
+/**
+ * @brief Per-stage timings and counters of one unwrap call
+ *
+ * Times are wall-clock nanoseconds. The lscm_assembly/factor/solve times
+ * are summed over islands, so with several workers they can exceed
+ * lscm_ns, which is the wall time of the whole island solve stage.
+ *
+ * Memory figures count the buffers that dominate a call: the scratch
+ * arena, topology, seams, the output mesh and, per island, the LSCM
+ * system, factor and solve vectors (LscmReport::peak_bytes, measured from
+ * the sizes of what the solver built). Stage arrays are indexed by
+ * UnwrapStage.
+ */
+typedef struct {
+    long long total_ns;              /**< Whole unwrap call */
+    long long topology_ns;           /**< Topology build and validation */
+    long long seams_ns;              /**< Seam detection */
+    long long islands_ns;            /**< Island extraction */
+    long long lscm_ns;               /**< Island parameterisation stage (wall time) */
+    long long lscm_assembly_ns;      /**< Sum of LSCM system assembly times */
+    long long lscm_factor_ns;        /**< Sum of factorisation / preconditioner setup times */
+    long long lscm_solve_ns;         /**< Sum of triangular solve / CG iteration times */
+    long long packing_ns;            /**< Island packing (0 if disabled) */
+    long long metrics_ns;            /**< Quality metrics */
+    long long matrix_nonzeros;       /**< Sum of nonzeros of the LSCM matrices A */
+    long long factor_nonzeros;       /**< Sum of factor nonzeros, nnz(L + U) for LU (A's plus fill-in
+                                          under UnwrapParams::lscm_ordering; 0 for CG) */
+    long long solver_iterations;     /**< Sum of CG iterations over islands */
+    long long scratch_bytes;         /**< Bytes held by the scratch arena */
+    int peak_island_faces;           /**< Faces in the largest island */
+    int peak_island_vertices;        /**< Vertices in the largest solved island */
+    int num_solved_islands;          /**< Islands that went through LSCM */
+    int num_nonmanifold_edges;       /**< Input edges with more than two faces */
+    int num_nonmanifold_vertices;    /**< Input vertices whose faces form several fans */
+    int num_flagged_faces;           /**< Faces flagged by classify_faces() and left out of seams and LSCM */
+    int num_fallback_islands;        /**< Solved islands whose requested solve failed and a fallback
+                                          (LscmReport::fallback) produced the UVs */
+    long long* island_solve_ns;      /**< LSCM time per island (num_islands; 0 for unsolved islands) */
+    int cache_hit;                   /**< 1 if the output came from the result cache (only total_ns is timed) */
+    long long peak_bytes;            /**< Most tracked memory held at once during the call */
+    long long stage_peak_bytes[UNWRAP_STAGE_DONE]; /**< Peak tracked memory within each stage */
+    long long stage_end_bytes[UNWRAP_STAGE_DONE];  /**< Tracked memory held when each stage finished */
+    long long* island_peak_bytes;    /**< LscmReport::peak_bytes per island (num_islands; 0 for unsolved islands) */
+    int num_memory_waits;            /**< Island solves passed over for others by UnwrapParams::memory_budget */
+    int num_dense_islands;           /**< Solved islands small enough for a dense solve (LscmReport::dense) */
+    int num_closed_form_islands;     /**< Solved islands laid out without a solve (LscmReport::closed_form) */
+    int num_instance_islands;        /**< Islands given a copy's UVs instead of a solve
+                                          (UnwrapParams::island_instancing) */
+    int num_cached_islands;          /**< Solved islands whose UVs came from the island cache
+                                          (unwrap_island_cache_configure()) */
+} UnwrapStats;
+
 /**
  * @brief Unwrapping result metadata
  */
 typedef struct {
     int num_islands;             /**< Number of UV islands */
     int* face_island_ids;        /**< Island ID per face (num_triangles) */
-    float avg_stretch;           /**< Average stretch across all triangles */
-    float max_stretch;           /**< Maximum stretch */
-    float coverage;              /**< Percentage of [0,1]² used */
+    float avg_stretch;           /**< Area-weighted mean of per-face σmax/σmin */
+    float max_stretch;           /**< Maximum per-face σmax/σmin */
+    float coverage;              /**< Fraction of [0,1]² texels covered (rasterised) */
+    int solver_iterations;       /**< Max CG iterations over islands (0 if all solves were direct) */
+    float solver_residual;       /**< Max CG relative residual over islands */
+    UnwrapStats stats;           /**< Stage timings and counters */
+    float stretch_l2;            /**< Sander L2 stretch (1 = isometric up to scale) */
+    float stretch_linf;          /**< Sander L∞ stretch (largest normalised singular value) */
+    float angle_distortion;      /**< Area-weighted mean of the per-face max angle error (radians) */
+    float max_angle_distortion;  /**< Largest angle error over all faces (radians) */
+    int num_degenerate_faces;    /**< Faces skipped by the metrics (degenerate UV or 3D triangle) */
+    float overlap;               /**< Fraction of [0,1]² texels covered by more than one face */
+    int num_tiles;               /**< UDIM tiles used (0 = packed into [0,1]² or not packed) */
+    int* vertex_remap;           /**< UV_OUTPUT_SPLIT_VERTICES or a reordered output: input vertex of
+                                      each output vertex (output num_vertices); NULL otherwise */
+    float uv_density;            /**< UV length per mesh length, sqrt(UV area / 3D area) over the faces the
+                                      metrics measure; every island has it under ISLAND_SCALE_UNIFORM
+                                      or UDIM packing without face_importance */
+    int* face_remap;             /**< UnwrapParams::output_order set: input face of each output face
+                                      (num_triangles); NULL otherwise */
 } UnwrapResult;
 
+/**
+ * @brief Fill params with the default unwrapping parameters
+ *
+ * angle_threshold = 30, min_island_faces = 5, pack_islands = 1,
+ * island_margin = 0.02; every optional field is zero.
+ *
+ * @param params Parameters to initialise
+ */
+void unwrap_params_default(UnwrapParams* params);
+
+/**
+ * @brief UV islands as a CSR island → faces list
+ *
+ * Faces of island i: island_faces[island_face_offsets[i] .. island_face_offsets[i+1]).
+ * Islands are numbered by their lowest face index; faces are ascending
+ * within each island.
+ */
+typedef struct {
+    int num_islands;             /**< Number of UV islands */
+    int* face_island_ids;        /**< Island ID per face (num_triangles) */
+    int* island_face_offsets;    /**< CSR offsets into island_faces (num_islands + 1) */
+    int* island_faces;           /**< Faces grouped by island (num_triangles) */
+} IslandInfo;
+
 /**
  * @brief Main unwrapping function
  *
  * Algorithm:
  * 1. Build mesh topology
  * 2. Detect seams using spanning tree + angular defect
- * 3. Extract UV islands (connected components after seam cuts)
+ * 3. Extract UV islands (connected components after seam cuts), then
+ *    split islands over max_chart_faces / max_chart_angle into charts
  * 4. Parameterize each island using LSCM
  * 5. Pack islands into [0,1]²
  * 6. Compute quality metrics
  *
+ * With params->uv_output = UV_OUTPUT_SPLIT_VERTICES the returned mesh has
+ * seam vertices duplicated per island (see UvOutput); faces keep their
+ * order. params->output_order renumbers the returned mesh's vertices and
+ * faces last, after the metrics, so an exporter can write it as it is;
+ * face_island_ids is given in the new face order. Split and reordered
+ * outputs bypass the result cache.
+ *
+ * Cancellation (params->cancel, or params->progress returning nonzero) is
+ * checked between stages, before every island solve, and inside LSCM
+ * assembly and solver iterations (see LscmOptions::should_cancel). A
+ * cancelled call frees everything it allocated and returns NULL with
+ * *result_out untouched.
+ *
+ * The output does not depend on params->num_threads or on scheduling:
+ * island ids, UVs and every metric are bit-identical for any worker
+ * count, so output hashes can key build caches.
+ *
  * @param mesh Input mesh
  * @param params Unwrapping parameters
  * @param result_out Output metadata (allocated by function)
- * @return New mesh with UVs, or NULL on error
+ * @return New mesh with UVs, or NULL on error or cancellation
  * @note Caller must free result mesh and result_out
  *
  * IMPLEMENTATION REQUIRED
@@ -59,6 +385,105 @@ Mesh* unwrap_mesh(const Mesh* mesh,
                   const UnwrapParams* params,
                   UnwrapResult** result_out);
 
+/**
+ * @brief Opaque reusable unwrap state for batch processing
+ *
+ * Owns an arena for the pipeline's scratch memory (island lists, solve
+ * order, per-island UV buffers). The arena is reset at the start of every
+ * unwrap_mesh_ctx() call and keeps its memory, so after the first mesh of
+ * a batch it only grows when a larger mesh arrives. A context must not be
+ * used by two threads at once; use one context per worker.
+ */
+typedef struct UnwrapContext UnwrapContext;
+
+/**
+ * @brief Context scratch statistics
+ */
+typedef struct {
+    long long scratch_capacity;          /**< Bytes held by the scratch arena */
+    long long scratch_block_allocations; /**< Heap blocks requested over the context's lifetime */
+} UnwrapContextStats;
+
+/**
+ * @brief Create an unwrap context
+ * @return New context, free with unwrap_context_free()
+ */
+UnwrapContext* unwrap_context_create(void);
+
+/**
+ * @brief Free an unwrap context
+ * @param ctx Context to free (may be NULL)
+ */
+void unwrap_context_free(UnwrapContext* ctx);
+
+/**
+ * @brief Query a context's scratch statistics
+ * @param ctx Context
+ * @param stats_out Output statistics
+ */
+void unwrap_context_stats(const UnwrapContext* ctx, UnwrapContextStats* stats_out);
+
+/**
+ * @brief Give a context its own log sink and level
+ *
+ * Messages from unwrap_mesh_ctx() calls on this context, including those
+ * from its island workers, go to callback instead of the process-wide
+ * sink, filtered by level instead of uv_set_log_level(). Calls are
+ * serialised per context.
+ *
+ * @param ctx Context
+ * @param callback Sink, or NULL to use the process-wide sink and level again
+ * @param user_data Passed back to every call
+ * @param level Most verbose UvLogLevel passed to callback
+ */
+void unwrap_context_set_log_callback(UnwrapContext* ctx, UvLogCallback callback, void* user_data, int level);
+
+/**
+ * @brief Placement of worker threads on machines with several NUMA nodes
+ */
+typedef enum {
+    UNWRAP_NUMA_NONE = 0,   /**< Workers run wherever the OS schedules them (default) */
+    UNWRAP_NUMA_SPREAD = 1  /**< Workers pinned to the nodes in contiguous blocks; per-island buffers are
+                                 first touched by the worker that fills them, and each island's solve
+                                 prefers a worker on the node that built its submesh */
+} UnwrapNumaPolicy;
+
+/**
+ * @brief NUMA nodes with CPUs on this machine (1 where the topology is unknown)
+ */
+int unwrap_numa_node_count(void);
+
+/**
+ * @brief Set how a context's calls place their worker threads
+ *
+ * Applies to the threads unwrap_mesh_ctx() starts, never to the calling
+ * thread. With UNWRAP_NUMA_NONE a call keeps the placement of the thread
+ * it runs on, so unwrap_batch() workers pinned to a node keep their
+ * islands there. On a single node, or without thread affinity, every
+ * policy behaves as UNWRAP_NUMA_NONE; the UVs never depend on it.
+ *
+ * @param ctx Context
+ * @param policy UnwrapNumaPolicy
+ */
+void unwrap_context_set_numa(UnwrapContext* ctx, int policy);
+
+/**
+ * @brief unwrap_mesh() drawing pipeline scratch from a reusable context
+ *
+ * Output ownership is the same as unwrap_mesh(): the returned mesh and
+ * result_out are heap-allocated and independent of the context.
+ *
+ * @param ctx Context created with unwrap_context_create()
+ * @param mesh Input mesh
+ * @param params Unwrapping parameters
+ * @param result_out Output metadata (allocated by function)
+ * @return New mesh with UVs, or NULL on error
+ */
+Mesh* unwrap_mesh_ctx(UnwrapContext* ctx,
+                      const Mesh* mesh,
+                      const UnwrapParams* params,
+                      UnwrapResult** result_out);
+
 /**
  * @brief Detect seams for unwrapping
  *
@@ -82,6 +507,49 @@ int* detect_seams(const Mesh* mesh,
                   float angle_threshold,
                   int* num_seams_out);
 
+/**
+ * @brief Detect seams with an explicit seam engine
+ * @param mesh Input mesh
+ * @param topo Topology information
+ * @param angle_threshold Angle threshold in degrees
+ * @param method Seam engine (SEAM_METHOD_BFS is equivalent to detect_seams())
+ * @param num_seams_out Output: number of seams detected
+ * @return Array of seam edge indices (ascending), or NULL on error
+ * @note Caller must free returned array
+ */
+int* detect_seams_with_method(const Mesh* mesh,
+                              const TopologyInfo* topo,
+                              float angle_threshold,
+                              SeamMethod method,
+                              int* num_seams_out);
+
+/**
+ * @brief Extract UV islands after seam cuts
+ *
+ * Union-find over every interior non-seam edge, then one sweep over faces
+ * emits both the per-face island IDs and the CSR face lists. A closed
+ * island (no boundary or seam edge) would collapse under LSCM, so it is
+ * split into charts within 90° of their mean normal, as unwrap_mesh()
+ * does.
+ *
+ * @param mesh Input mesh
+ * @param topo Topology information
+ * @param seam_edges Array of seam edge indices
+ * @param num_seams Number of seams
+ * @return Newly allocated islands, or NULL on error
+ * @note Caller must free with free_islands()
+ */
+IslandInfo* extract_islands(const Mesh* mesh,
+                            const TopologyInfo* topo,
+                            const int* seam_edges,
+                            int num_seams);
+
+/**
+ * @brief Free island memory
+ * @param islands Islands to free (fields may be NULL)
+ */
+void free_islands(IslandInfo* islands);
+
 /**
  * @brief Pack UV islands into [0,1]² texture space
  *
@@ -101,13 +569,215 @@ void pack_uv_islands(Mesh* mesh,
                      const UnwrapResult* result,
                      float margin);
 
+/**
+ * @brief pack_uv_islands() with a choice of engine and rotation
+ *
+ * The skyline, MaxRects and raster engines keep `margin` as the gap
+ * between islands in final [0,1]² units; it is reduced (with a warning)
+ * when the margins alone would take over a quarter of the sheet. The
+ * raster engine packs island silhouettes on a grid of at most 512²
+ * cells and keeps the MaxRects layout when that is no tighter.
+ *
+ * @param mesh Mesh with per-island UVs (modified in place)
+ * @param result Island assignment (num_islands, face_island_ids)
+ * @param margin Spacing between islands
+ * @param method PackMethod
+ * @param rotation PackRotation
+ */
+void pack_uv_islands_ex(Mesh* mesh,
+                        const UnwrapResult* result,
+                        float margin,
+                        int method,
+                        int rotation);
+
+/**
+ * @brief Scale every island to the same texel density (ISLAND_SCALE_UNIFORM)
+ *
+ * Island i is scaled about the origin by w_i * sqrt(A3d_i / Auv_i), its
+ * mesh-to-UV length ratio times its importance w_i (the area-weighted
+ * mean of face_importance over its faces, 1 without it), after which
+ * pack_uv_islands_ex() keeps the ratios. Islands without UV or 3D area
+ * are left as they are. The UVs leave [0,1]², so pack afterwards.
+ *
+ * @param mesh Mesh with per-island UVs (modified in place)
+ * @param result Island assignment (num_islands, face_island_ids)
+ * @param face_importance Weight per face (num_triangles), or NULL
+ */
+void scale_uv_islands_to_density(Mesh* mesh,
+                                 const UnwrapResult* result,
+                                 const float* face_importance);
+
+/**
+ * @brief Texture side that gives at least texels_per_unit texels per mesh unit
+ *
+ * ceil(texels_per_unit / result->uv_density), for islands of importance 1;
+ * with UDIM packing this is the tile resolution.
+ *
+ * @return Texels per side, or 0 when the result has no uv_density
+ */
+int texture_size_for_density(const UnwrapResult* result, float texels_per_unit);
+
+/**
+ * @brief Pack islands across UDIM tiles at a uniform texel density
+ *
+ * Every island is scaled so its UV area per mesh area is the same, then
+ * packed (skyline or MaxRects; the other methods use MaxRects) into unit
+ * tiles. Tile t covers [t % 10, t % 10 + 1] × [t / 10, t / 10 + 1], i.e.
+ * UDIM 1001 + t, and the UVs are written with that offset.
+ *
+ * - texel_density > 0, udim_tiles == 0: tiles are added until every
+ *   island fits; an island larger than a tile is shrunk to fit
+ * - udim_tiles > 0: the density is the largest (at most texel_density,
+ *   if set) at which the islands fit that many tiles, with the fill
+ *   spread evenly over them
+ *
+ * @param mesh Mesh with per-island UVs (modified in place)
+ * @param result Island assignment (num_islands, face_island_ids)
+ * @param params island_margin (in tile units), pack_method, pack_rotation,
+ *               texel_density, udim_tiles, udim_resolution
+ * @return Tiles used (0 on failure)
+ */
+int pack_uv_islands_udim(Mesh* mesh,
+                         const UnwrapResult* result,
+                         const UnwrapParams* params);
+
+/**
+ * @brief Check whether a compute backend can run here
+ * @param backend Backend to query
+ * @return 1 if compiled in and (for CUDA) a device was found, 0 otherwise
+ */
+int compute_backend_available(ComputeBackend backend);
+
+/**
+ * @brief Optional per-face outputs of compute_quality_metrics_ex()
+ *
+ * Each non-NULL array must hold num_triangles floats. Degenerate faces
+ * get 0 in every array.
+ */
+typedef struct {
+    float* stretch;              /**< σmax/σmin of the UV→3D Jacobian */
+    float* stretch_l2;           /**< Sander L2 stretch, normalised by the global area ratio */
+    float* stretch_linf;         /**< Sander L∞ stretch, normalised likewise */
+    float* angle_distortion;     /**< Largest corner angle error (radians) */
+} FaceMetrics;
+
 /**
  * @brief Compute quality metrics for UV mapping
+ *
+ * Fills avg/max_stretch, stretch_l2/linf, angle_distortion,
+ * max_angle_distortion, num_degenerate_faces, and coverage / overlap
+ * rasterised at 1024² with compute_uv_coverage(). When the mesh has faces
+ * but every one is degenerate (e.g. UVs collapsed onto a line), nothing
+ * was measured and the stretch and angle fields are +∞.
+ *
  * @param mesh Mesh with UVs
  * @param result Result structure to fill with metrics
  */
 void compute_quality_metrics(const Mesh* mesh, UnwrapResult* result);
 
+/**
+ * @brief compute_quality_metrics() with per-face output and a thread count
+ *
+ * The aggregates are summed per fixed chunk of faces and the chunks
+ * folded pairwise, so they are the same for every thread count.
+ *
+ * @param mesh Mesh with UVs
+ * @param result Result structure to fill with metrics
+ * @param faces_out Per-face arrays to fill, or NULL
+ * @param num_threads Worker threads (0 = automatic by mesh size)
+ */
+void compute_quality_metrics_ex(const Mesh* mesh,
+                                UnwrapResult* result,
+                                FaceMetrics* faces_out,
+                                int num_threads);
+
+/**
+ * @brief compute_quality_metrics_ex() on a chosen ComputeBackend
+ *
+ * The per-face stretch and angle kernels and the coverage raster run on
+ * the backend; the area-weighted sums are reduced on the CPU in the same
+ * order either way.
+ *
+ * @param backend ComputeBackend (COMPUTE_BACKEND_AUTO as in compute_quality_metrics_ex())
+ */
+void compute_quality_metrics_with_backend(const Mesh* mesh,
+                                          UnwrapResult* result,
+                                          FaceMetrics* faces_out,
+                                          int num_threads,
+                                          int backend);
+
+/**
+ * @brief compute_quality_metrics_with_backend() that also records the
+ *        per-face distributions
+ *
+ * Every chunk of faces fills its own histograms, which are merged into
+ * histograms afterwards, so the workers never share a counter.
+ *
+ * @param histograms Histograms to add the faces to, or NULL
+ */
+void compute_quality_metrics_with_histograms(const Mesh* mesh,
+                                             UnwrapResult* result,
+                                             FaceMetrics* faces_out,
+                                             MetricsHistograms* histograms,
+                                             int num_threads,
+                                             int backend);
+
+/**
+ * @brief Rasterised coverage of [0,1]² (see compute_uv_coverage())
+ */
+typedef struct {
+    int resolution;              /**< Grid side in texels */
+    float coverage;              /**< covered_texels / resolution² */
+    float overlap;               /**< overlap_texels / resolution² */
+    long long covered_texels;    /**< Texel centres inside at least one face */
+    long long overlap_texels;    /**< Texel centres inside two or more faces */
+    int num_islands;             /**< Length of the per-island arrays */
+    long long* island_texels;    /**< Texels drawn per island (overlaps within an island count twice) */
+    float* island_texel_density; /**< sqrt(island_texels / island 3D area): texels per unit length */
+    int backend;                 /**< ComputeBackend that rasterised (CPU or CUDA) */
+} UvCoverage;
+
+/**
+ * @brief Rasterise the UV triangles into a resolution² bit grid
+ *
+ * Texel centres are tested against each face in fixed point with a
+ * top-left tie rule, so faces sharing an edge never overlap each other.
+ * Coverage, overlap and the per-island texel counts come out of the same
+ * pass. The grid is tiled in 64×64 blocks that are rasterised in parallel.
+ * UVs outside [0,1]² are clipped; faces with |u| or |v| > 16 are skipped.
+ *
+ * @param mesh Mesh with UVs
+ * @param face_island_ids Island per face, or NULL to treat the mesh as one island
+ * @param num_islands Number of islands in face_island_ids
+ * @param resolution Grid side in texels (0 = 1024, at most 65536)
+ * @param num_threads Worker threads (0 = automatic by mesh size)
+ * @return Coverage (free with free_uv_coverage()), or NULL on invalid input
+ */
+UvCoverage* compute_uv_coverage(const Mesh* mesh,
+                                const int* face_island_ids,
+                                int num_islands,
+                                int resolution,
+                                int num_threads);
+
+/**
+ * @brief compute_uv_coverage() on a chosen ComputeBackend
+ * @param backend ComputeBackend; AUTO uses CUDA from 4096² texels or
+ *        262144 faces on, when a device is present
+ * @return As compute_uv_coverage(); UvCoverage::backend tells which ran
+ */
+UvCoverage* compute_uv_coverage_ex(const Mesh* mesh,
+                                   const int* face_island_ids,
+                                   int num_islands,
+                                   int resolution,
+                                   int num_threads,
+                                   int backend);
+
+/**
+ * @brief Free a coverage result
+ * @param coverage Coverage to free
+ */
+void free_uv_coverage(UvCoverage* coverage);
+
 /**
  * @brief Free unwrap result
  * @param result Result to free
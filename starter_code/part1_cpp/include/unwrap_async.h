@@ -0,0 +1,201 @@
+/**
+ * @file unwrap_async.h
+ * @brief Non-blocking unwraps on a library-owned worker pool
+ *
+ * unwrap_mesh_async() queues an unwrap and returns at once; a pool
+ * worker runs it and reports the outcome through a callback, or keeps it
+ * for unwrap_task_wait() and unwrap_task_take(). An async server can then
+ * hand thousands of requests to a few pool threads instead of blocking
+ * one executor thread per unwrap.
+ *
+ * The pool starts on the first unwrap_mesh_async() with
+ * unwrap_async_configure()'s worker count. Each worker keeps a warm
+ * UnwrapContext for tasks that bring none, and runs one task at a time;
+ * tasks wait in submission order. A task whose params->num_threads is 0
+ * solves its islands with an equal share of the cores, so the workers
+ * together use the machine once.
+ *
+ * A task is cancelled by unwrap_task_cancel() or by the params' own
+ * cancel flag or progress callback: queued, it never runs; running, it
+ * stops as unwrap_mesh() does. Either way it completes with
+ * UNWRAP_ASYNC_CANCELLED.
+ *
+ * C++20 code can co_await uvunwrap::UnwrapAwaitable (below) instead.
+ */
+
+#ifndef UNWRAP_ASYNC_H
+#define UNWRAP_ASYNC_H
+
+#include "unwrap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Outcome of an async unwrap
+ */
+typedef enum {
+    UNWRAP_ASYNC_PENDING = -1,   /**< Queued or running */
+    UNWRAP_ASYNC_OK = 0,         /**< Unwrapped */
+    UNWRAP_ASYNC_FAILED = 1,     /**< unwrap_mesh() failed */
+    UNWRAP_ASYNC_CANCELLED = 2   /**< Cancelled before or while it ran */
+} UnwrapAsyncStatus;
+
+/**
+ * @brief Handle of one queued unwrap; release with unwrap_task_release()
+ */
+typedef struct UnwrapTask UnwrapTask;
+
+/**
+ * @brief Completion callback, called once per task on a pool thread
+ *
+ * The callback owns mesh and result (free_mesh(), free_unwrap_result()),
+ * which are NULL unless status is UNWRAP_ASYNC_OK. It runs before the task
+ * counts as done, so unwrap_task_wait() returns after it. It should hand
+ * the work back to the caller's executor rather than do it here, since
+ * the pool worker waits for it.
+ *
+ * @param task The task (still valid; the caller's reference is untouched)
+ * @param status UnwrapAsyncStatus
+ * @param user_data Pointer given to unwrap_mesh_async()
+ */
+typedef void (*UnwrapDoneCallback)(UnwrapTask* task, int status, Mesh* mesh, UnwrapResult* result,
+                                   void* user_data);
+
+/**
+ * @brief Set the pool size before the pool starts
+ * @param num_workers Concurrent unwraps (0 = one per 4 cores, at least 1)
+ * @return 0, or -1 if the pool is already running
+ */
+int unwrap_async_configure(int num_workers);
+
+/**
+ * @brief Queue an unwrap
+ *
+ * The params struct is copied, but mesh and the arrays params points to
+ * (pins, seams, importance, the cancel flag) must stay valid until the
+ * task completes.
+ *
+ * @param ctx Context to run on, not to be used elsewhere until the task
+ *        completes, or NULL for the worker's own
+ * @param mesh Input mesh
+ * @param params Unwrapping parameters (NULL = defaults)
+ * @param on_done Completion callback, or NULL to keep the output in the
+ *        task for unwrap_task_take()
+ * @param user_data Passed to on_done
+ * @return New task (NULL on invalid arguments); release it with
+ *         unwrap_task_release() whenever the caller is done with the handle.
+ *         Once the pool has shut down at exit the task has already
+ *         completed, UNWRAP_ASYNC_CANCELLED, when this returns
+ */
+UnwrapTask* unwrap_mesh_async(UnwrapContext* ctx,
+                              const Mesh* mesh,
+                              const UnwrapParams* params,
+                              UnwrapDoneCallback on_done,
+                              void* user_data);
+
+/**
+ * @brief Ask a task to stop; it still completes (UNWRAP_ASYNC_CANCELLED
+ *        unless it had already finished)
+ */
+void unwrap_task_cancel(UnwrapTask* task);
+
+/**
+ * @brief Status of a task without blocking
+ * @return UnwrapAsyncStatus, UNWRAP_ASYNC_PENDING until it completes
+ */
+int unwrap_task_status(const UnwrapTask* task);
+
+/**
+ * @brief Block until a task completes (its callback has returned)
+ * @return Its UnwrapAsyncStatus
+ */
+int unwrap_task_wait(UnwrapTask* task);
+
+/**
+ * @brief Take the output of a completed task that has no callback
+ *
+ * Ownership is as from unwrap_mesh(); a second call returns NULL.
+ *
+ * @param result_out Output metadata
+ * @return The unwrapped mesh, or NULL if the task is pending, failed,
+ *         was cancelled or has a callback
+ */
+Mesh* unwrap_task_take(UnwrapTask* task, UnwrapResult** result_out);
+
+/**
+ * @brief Drop the caller's reference to a task
+ *
+ * A task still queued or running carries on (cancel it first if it is no
+ * longer wanted); output nobody took is freed with the task.
+ */
+void unwrap_task_release(UnwrapTask* task);
+
+#ifdef __cplusplus
+}
+#endif
+
+#if defined(__cplusplus) && defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+#include <coroutine>
+
+namespace uvunwrap {
+
+/** What co_await of an UnwrapAwaitable gives; the caller owns mesh and result */
+struct UnwrapAsyncOutcome {
+    int status;                  /**< UnwrapAsyncStatus */
+    Mesh* mesh;
+    UnwrapResult* result;
+};
+
+/**
+ * @brief C++20 awaitable of unwrap_mesh_async()
+ *
+ *     UnwrapAsyncOutcome out = co_await UnwrapAwaitable(ctx, mesh, &params);
+ *
+ * The coroutine is resumed on the pool thread that finished the unwrap;
+ * schedule back onto your executor before doing more work. Cancel through
+ * params.cancel. Arguments must outlive the co_await, as for
+ * unwrap_mesh_async().
+ */
+class UnwrapAwaitable {
+public:
+    UnwrapAwaitable(UnwrapContext* ctx, const Mesh* mesh, const UnwrapParams* params)
+        : ctx_(ctx), mesh_(mesh), params_(params), task_(nullptr), outcome_{UNWRAP_ASYNC_FAILED, nullptr, nullptr} {}
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> handle) {
+        handle_ = handle;
+        // Nothing of *this may be touched once queued: the callback can
+        // resume (and end) the coroutine before unwrap_mesh_async() returns
+        return unwrap_mesh_async(ctx_, mesh_, params_, &UnwrapAwaitable::done, this) != nullptr;
+    }
+
+    UnwrapAsyncOutcome await_resume() noexcept {
+        if (task_) unwrap_task_release(task_);
+        task_ = nullptr;
+        return outcome_;
+    }
+
+private:
+    static void done(UnwrapTask* task, int status, Mesh* mesh, UnwrapResult* result, void* user_data) {
+        UnwrapAwaitable* self = static_cast<UnwrapAwaitable*>(user_data);
+        self->task_ = task;
+        self->outcome_ = UnwrapAsyncOutcome{status, mesh, result};
+        self->handle_.resume();
+    }
+
+    UnwrapContext* ctx_;
+    const Mesh* mesh_;
+    const UnwrapParams* params_;
+    UnwrapTask* task_;
+    UnwrapAsyncOutcome outcome_;
+    std::coroutine_handle<> handle_;
+};
+
+} // namespace uvunwrap
+
+#endif
+
+#endif /* UNWRAP_ASYNC_H */
@@ -0,0 +1,187 @@
+/**
+ * @file unwrap_batch.h
+ * @brief Unwrap many mesh files in one call with pipelined I/O
+ */
+
+#ifndef UNWRAP_BATCH_H
+#define UNWRAP_BATCH_H
+
+#include "unwrap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Outcome of one file of a batch
+ */
+typedef enum {
+    UNWRAP_BATCH_OK = 0,             /**< Unwrapped and written */
+    UNWRAP_BATCH_LOAD_FAILED = 1,    /**< Input could not be read */
+    UNWRAP_BATCH_UNWRAP_FAILED = 2,  /**< unwrap_mesh() failed */
+    UNWRAP_BATCH_SAVE_FAILED = 3     /**< Output could not be written */
+} UnwrapBatchStatus;
+
+/**
+ * @brief Per-file statistics of a batch
+ *
+ * Metrics are zero unless status is UNWRAP_BATCH_OK.
+ */
+typedef struct {
+    int status;                  /**< UnwrapBatchStatus */
+    int num_vertices;            /**< Input vertices */
+    int num_triangles;           /**< Input triangles */
+    int num_islands;             /**< UV islands */
+    float avg_stretch;           /**< As in UnwrapResult */
+    float max_stretch;           /**< As in UnwrapResult */
+    float coverage;              /**< As in UnwrapResult */
+    float overlap;               /**< As in UnwrapResult */
+    long long load_ns;           /**< Parsing the input */
+    long long unwrap_ns;         /**< unwrap_mesh_ctx() wall time */
+    long long save_ns;           /**< Writing the output */
+} UnwrapBatchFileStats;
+
+/**
+ * @brief Distributions over the files of a batch
+ *
+ * Log-bucket histograms (uv_histogram.h): cheap to keep on, and sets from
+ * several batches, processes or machines combine with
+ * unwrap_batch_histograms_merge(). The stretch and angle histograms take
+ * every measured face of every file that unwrapped; the others take the
+ * files that were written and did not come from the result cache.
+ */
+typedef struct {
+    UvHistogram stretch;         /**< Per-face σmax/σmin */
+    UvHistogram angle_distortion; /**< Per-face largest corner angle error (radians) */
+    UvHistogram island_faces;    /**< Faces per island */
+    UvHistogram load_ns;         /**< Parsing time per file */
+    UvHistogram unwrap_ns;       /**< unwrap_mesh_ctx() wall time per file */
+    UvHistogram save_ns;         /**< Writing time per file */
+    UvHistogram stage_ns[UNWRAP_STAGE_DONE]; /**< Stage times per file (UnwrapStats), by UnwrapStage */
+} UnwrapBatchHistograms;
+
+/**
+ * @brief Empty every histogram of a set
+ */
+void unwrap_batch_histograms_clear(UnwrapBatchHistograms* histograms);
+
+/**
+ * @brief Add the counts of src to dst, histogram by histogram
+ */
+void unwrap_batch_histograms_merge(UnwrapBatchHistograms* dst, const UnwrapBatchHistograms* src);
+
+/**
+ * @brief Write a set as one JSON object of uv_histogram_to_json() objects
+ *
+ * Keys are the field names, with stage_ns as an object keyed by stage
+ * ("topology", "seams", "islands", "solve", "packing", "metrics").
+ *
+ * @return Length of the whole text without the NUL, as uv_histogram_to_json()
+ */
+size_t unwrap_batch_histograms_to_json(const UnwrapBatchHistograms* histograms, char* out, size_t size);
+
+/**
+ * @brief Read a set written by unwrap_batch_histograms_to_json()
+ *
+ * Missing histograms are left empty.
+ *
+ * @return 0 on success, -1 if the text or one of its histograms is malformed
+ */
+int unwrap_batch_histograms_from_json(const char* json, UnwrapBatchHistograms* histograms);
+
+/**
+ * @brief Progress callback, called once per finished file
+ *
+ * Calls are serialised (never concurrent) but come from a library
+ * thread, in completion order rather than input order.
+ *
+ * @param done Files finished so far, including this one
+ * @param total Files in the batch
+ * @param index Input index of the file that finished
+ * @param status Its UnwrapBatchStatus
+ * @param user_data Pointer given to unwrap_batch()
+ */
+typedef void (*UnwrapBatchProgress)(int done, int total, int index, int status, void* user_data);
+
+/**
+ * @brief Options of unwrap_batch_with_options()
+ *
+ * Fill with unwrap_batch_options_default() first, so fields added later
+ * get their defaults.
+ */
+typedef struct {
+    int num_threads;             /**< Compute workers (0 = one per core) */
+    int prefetch;                /**< Parsed inputs queued ahead of the workers (0 = one per worker) */
+    long long memory_budget;     /**< Bytes of input and output meshes the pipeline may hold; the
+                                      reader waits for room before parsing the next file, and one
+                                      file is always admitted (0 = no limit). Island solve memory
+                                      is bounded separately by UnwrapParams::memory_budget */
+    UnwrapBatchProgress progress; /**< Optional callback per finished file (may be NULL) */
+    void* user_data;             /**< Passed to progress */
+    UnwrapBatchHistograms* histograms; /**< Optional distributions the batch adds its files to; each
+                                      worker records into its own set, merged in at the end. The
+                                      params' metrics_histograms is not used (may be NULL) */
+    int numa;                    /**< UnwrapNumaPolicy: UNWRAP_NUMA_SPREAD pins compute worker w to node
+                                      w mod unwrap_numa_node_count() and keeps each file's island
+                                      workers on that node (default UNWRAP_NUMA_NONE) */
+} UnwrapBatchOptions;
+
+/**
+ * @brief Fill options with the defaults (as unwrap_batch() uses them)
+ */
+void unwrap_batch_options_default(UnwrapBatchOptions* options);
+
+/**
+ * @brief Unwrap a list of files, pipelining parsing, solving and writing
+ *
+ * One reader thread parses inputs in order into a bounded queue, compute
+ * workers (each with its own UnwrapContext) unwrap them, and one writer
+ * thread saves the results, so I/O overlaps the solves. While it parses
+ * one file the reader asks the OS to read the next one ahead. Files ending in
+ * ".uvmb" are read and written as mesh_bin (the output carries the
+ * unwrap result), ".ply" and ".glb" through load_mesh() and save_mesh(),
+ * anything else as OBJ.
+ *
+ * Workers take one mesh each while enough files remain; the last files
+ * of the batch are given the idle workers' share as island solve threads.
+ * An explicit params->num_threads is used for every file instead.
+ *
+ * A failing file is recorded and the batch carries on.
+ *
+ * @param inputs Input paths (n)
+ * @param outputs Output paths (n)
+ * @param n Number of files
+ * @param params Unwrapping parameters (NULL = defaults)
+ * @param num_threads Compute workers (0 = one per core)
+ * @param progress Optional callback per finished file (may be NULL)
+ * @param user_data Passed to progress
+ * @param stats_out Optional per-file statistics (n entries, caller-allocated)
+ * @return Number of files that failed, or -1 on invalid arguments
+ */
+int unwrap_batch(const char* const* inputs,
+                 const char* const* outputs,
+                 int n,
+                 const UnwrapParams* params,
+                 int num_threads,
+                 UnwrapBatchProgress progress,
+                 void* user_data,
+                 UnwrapBatchFileStats* stats_out);
+
+/**
+ * @brief unwrap_batch() with a prefetch depth and a memory budget
+ *
+ * @param options Pipeline options (NULL = defaults)
+ * @return Number of files that failed, or -1 on invalid arguments
+ */
+int unwrap_batch_with_options(const char* const* inputs,
+                              const char* const* outputs,
+                              int n,
+                              const UnwrapParams* params,
+                              const UnwrapBatchOptions* options,
+                              UnwrapBatchFileStats* stats_out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UNWRAP_BATCH_H */
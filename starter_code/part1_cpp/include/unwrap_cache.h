@@ -0,0 +1,131 @@
+/**
+ * @file unwrap_cache.h
+ * @brief Persistent on-disk cache of unwrap results and in-memory cache
+ *        of solved islands
+ *
+ * When a cache directory is configured, unwrap_mesh() and
+ * unwrap_mesh_ctx() (and so unwrap_batch()) look up the input first and
+ * store what they compute. Entries are mesh_bin files named by a hash of
+ * the mesh (positions, triangles, existing UVs) and of every parameter
+ * that affects the output; a hit is checked against the stored geometry,
+ * so a hash collision reads as a miss. An mmap'd index shared by all
+ * processes using the directory tracks entry sizes and last use, and the
+ * least recently used entries are evicted to stay within a byte budget.
+ *
+ * Lookups take no lock. Inserts and evictions are serialised by a file
+ * lock on the index, and entries are written to a temporary file and
+ * renamed, so readers never see a partial entry. The CLI, the batch
+ * processor and the Blender add-on can share one directory.
+ *
+ * POSIX only: on Windows unwrap_cache_configure() fails and nothing is
+ * cached.
+ *
+ * The island cache works below that, for meshes that changed in places:
+ * once configured, every island solve first looks for an earlier solve
+ * of the same island, keyed by a hash of its submesh (positions and
+ * triangles in the island's own numbering) and of the solver options,
+ * and takes its UVs instead of calling LSCM. The island's UVs before
+ * packing are what is kept, so a revision that edits one part re-solves
+ * only the islands it touched. Entries live in memory under an LRU byte
+ * budget; islands large enough to be worth a file are also written to the
+ * on-disk cache when one is configured, where later processes find them.
+ * A hit is checked against the stored submesh, like a result cache hit.
+ */
+
+#ifndef UNWRAP_CACHE_H
+#define UNWRAP_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Cache counters
+ */
+typedef struct {
+    long long hits;              /**< Lookups answered from the cache (this process) */
+    long long misses;            /**< Lookups that had to unwrap (this process) */
+    long long stores;            /**< Entries written (this process) */
+    long long evictions;         /**< Entries evicted (this process) */
+    int num_entries;             /**< Entries in the directory now */
+    long long total_bytes;       /**< Bytes of entry files in the directory now */
+    long long max_bytes;         /**< Byte budget */
+} UnwrapCacheStats;
+
+/**
+ * @brief Use a cache directory for every later unwrap
+ *
+ * If this is never called, the UVUNWRAP_CACHE_DIR environment variable
+ * (and UVUNWRAP_CACHE_MAX_BYTES for the budget) configures the cache on
+ * first use, so tools can share a cache without code changes.
+ *
+ * @param directory Cache directory (created if missing), or NULL to
+ *        disable caching
+ * @param max_bytes Budget for entry files (0 = 1 GiB). A smaller budget
+ *        than a directory already holds evicts on the next store.
+ * @return 0 on success, -1 if the directory or index cannot be opened
+ *         (caching is then disabled)
+ */
+int unwrap_cache_configure(const char* directory, long long max_bytes);
+
+/**
+ * @brief Current counters
+ * @param stats_out Output (zeroed if no cache is configured)
+ * @return 0 if a cache is configured, -1 otherwise
+ */
+int unwrap_cache_stats(UnwrapCacheStats* stats_out);
+
+/**
+ * @brief Remove every entry from the configured cache
+ * @return Number of entries removed, or -1 if no cache is configured
+ */
+int unwrap_cache_clear(void);
+
+/**
+ * @brief Island cache counters (this process)
+ */
+typedef struct {
+    long long hits;              /**< Island solves answered from memory */
+    long long disk_hits;         /**< Island solves answered from the on-disk cache */
+    long long misses;            /**< Island solves that ran LSCM */
+    long long stores;            /**< Islands remembered */
+    long long disk_stores;       /**< Islands also written to the on-disk cache */
+    long long evictions;         /**< Islands dropped from memory for the budget */
+    int num_entries;             /**< Islands in memory now */
+    long long total_bytes;       /**< Bytes those entries hold */
+    long long max_bytes;         /**< Memory budget */
+} UnwrapIslandCacheStats;
+
+/**
+ * @brief Remember solved islands for every later unwrap
+ *
+ * If this is never called, UVUNWRAP_ISLAND_CACHE_MAX_BYTES turns the
+ * island cache on with that budget on first use.
+ *
+ * @param max_bytes Memory budget, or 0 to turn the island cache off (its
+ *        entries are dropped)
+ * @param persist_faces Islands of at least this many faces are also kept
+ *        in the on-disk cache while one is configured (0 = 512, < 0 = never)
+ * @return 0 on success, -1 for a negative budget
+ */
+int unwrap_island_cache_configure(long long max_bytes, int persist_faces);
+
+/**
+ * @brief Current island cache counters
+ * @param stats_out Output (zeroed if the island cache is off)
+ * @return 0 if the island cache is on, -1 otherwise
+ */
+int unwrap_island_cache_stats(UnwrapIslandCacheStats* stats_out);
+
+/**
+ * @brief Drop every island from memory (entries on disk go with
+ *        unwrap_cache_clear())
+ * @return Number of islands dropped, or -1 if the island cache is off
+ */
+int unwrap_island_cache_clear(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UNWRAP_CACHE_H */
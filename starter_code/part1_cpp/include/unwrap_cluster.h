@@ -0,0 +1,111 @@
+/**
+ * @file unwrap_cluster.h
+ * @brief Unwrapping one mesh across several machines, sharded by island
+ *
+ * Workers listen on TCP and solve islands. A coordinator runs the usual
+ * pipeline on its own mesh (topology, seams, islands and charts, then
+ * packing and metrics) but ships the island solves: every island becomes
+ * a submesh of its own vertices in first-use order, islands are dealt to
+ * the workers largest first onto the least loaded one, and the UVs come
+ * back for global packing. A worker solves each submesh exactly as the
+ * coordinator would solve the island in place, so the result is bit for
+ * bit that of unwrap_mesh() on one node.
+ *
+ * Islands of a worker that cannot be reached or drops its connection are
+ * solved by the coordinator instead; the worker is not used again by that
+ * cluster. Coordinator and workers must come from the same library build
+ * on machines of the same byte order (records are sent in host order and
+ * UnwrapParams as is, checked by size).
+ *
+ * The protocol has no authentication: run workers on a trusted network.
+ * POSIX only: on Windows every function fails.
+ */
+
+#ifndef UNWRAP_CLUSTER_H
+#define UNWRAP_CLUSTER_H
+
+#include "unwrap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Running worker (listening socket and its connections)
+ */
+typedef struct UnwrapClusterWorker UnwrapClusterWorker;
+
+/**
+ * @brief Coordinator's connections to a set of workers; not to be shared
+ *        by threads
+ */
+typedef struct UnwrapCluster UnwrapCluster;
+
+/**
+ * @brief Listen for coordinators
+ *
+ * @param address "host:port" to bind; an empty host or "*" binds every
+ *        interface, port 0 picks a free one (see unwrap_cluster_worker_port())
+ * @param num_threads Threads solving the islands of a request (0 = auto)
+ * @return Running worker, or NULL if the address cannot be bound
+ */
+UnwrapClusterWorker* unwrap_cluster_worker_start(const char* address, int num_threads);
+
+/**
+ * @brief Stop accepting, drop coordinators, remove the worker
+ * @param worker Worker (may be NULL)
+ */
+void unwrap_cluster_worker_stop(UnwrapClusterWorker* worker);
+
+/**
+ * @brief Port the worker listens on
+ */
+int unwrap_cluster_worker_port(const UnwrapClusterWorker* worker);
+
+/**
+ * @brief Islands the worker has solved so far
+ */
+long long unwrap_cluster_worker_islands(const UnwrapClusterWorker* worker);
+
+/**
+ * @brief Connect to workers
+ *
+ * Workers that do not answer are left out with a warning.
+ *
+ * @param addresses "host:port" of each worker
+ * @param num_addresses Entries in addresses
+ * @return Cluster, or NULL if no worker answered
+ */
+UnwrapCluster* unwrap_cluster_connect(const char* const* addresses, int num_addresses);
+
+/**
+ * @brief Close the connections
+ * @param cluster Cluster (may be NULL)
+ */
+void unwrap_cluster_disconnect(UnwrapCluster* cluster);
+
+/**
+ * @brief Workers still in use (connected and never failed)
+ */
+int unwrap_cluster_num_workers(const UnwrapCluster* cluster);
+
+/**
+ * @brief unwrap_mesh() with the island solves spread over the cluster
+ *
+ * Same parameters and result as unwrap_mesh(), including the result cache
+ * and user pins. A non-NULL lscm_plan asks each worker for a plan of its
+ * own. Progress counts islands as their workers answer; cancelling stops
+ * the pipeline once the outstanding answers have arrived.
+ *
+ * @note Caller must free both returned objects
+ */
+Mesh* unwrap_mesh_distributed(UnwrapCluster* cluster,
+                              const Mesh* mesh,
+                              const UnwrapParams* params,
+                              UnwrapResult** result_out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UNWRAP_CLUSTER_H */
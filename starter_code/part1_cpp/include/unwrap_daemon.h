@@ -0,0 +1,132 @@
+/**
+ * @file unwrap_daemon.h
+ * @brief Long-running unwrap service (uvunwrapd) and its client
+ *
+ * A daemon keeps a pool of warm workers, each with its own UnwrapContext
+ * (scratch arena) and LscmPlan, plus whatever result cache the process
+ * configured (unwrap_cache.h), so a small mesh costs one request over a
+ * Unix domain socket instead of a library load and a cold pipeline.
+ *
+ * Requests name an input and an output file, handled like one file of
+ * unwrap_batch(): ".uvmb" paths are mesh_bin, ".ply" and ".glb" PLY and
+ * GLB, anything else OBJ. For in-memory meshes the client writes a
+ * mesh_bin into shared memory (a private 0700 directory in /dev/shm where
+ * present, else in the temporary directory), the daemon maps it, unwraps
+ * and writes its answer there too, and the client maps that: the arrays
+ * are never parsed or converted on either side.
+ *
+ * A client connection is served by one worker until it disconnects;
+ * connections beyond the worker count wait for a free worker. The client
+ * and the daemon must come from the same library build (the request
+ * carries UnwrapParams as is, checked by size).
+ *
+ * POSIX only: on Windows every function fails.
+ */
+
+#ifndef UNWRAP_DAEMON_H
+#define UNWRAP_DAEMON_H
+
+#include "mesh_bin.h"
+#include "unwrap_batch.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Running daemon (listening socket and worker pool)
+ */
+typedef struct UnwrapDaemon UnwrapDaemon;
+
+/**
+ * @brief Connection to a daemon; not to be shared by threads
+ */
+typedef struct UnwrapDaemonClient UnwrapDaemonClient;
+
+/**
+ * @brief Default socket path: $XDG_RUNTIME_DIR/uvunwrapd.sock, or
+ *        /tmp/uvunwrapd-<uid>.sock without it
+ * @param buffer Output, NUL-terminated
+ * @param size Bytes in buffer
+ * @return 0 on success, -1 if the path does not fit
+ */
+int unwrap_daemon_default_socket(char* buffer, int size);
+
+/**
+ * @brief Listen on a socket and start the worker pool
+ *
+ * A stale socket file at the path is replaced. The socket is made 0600,
+ * so only the daemon's user can connect. Requests run with
+ * num_threads = cores / workers unless they set their own.
+ *
+ * @param socket_path Socket path (NULL = unwrap_daemon_default_socket())
+ * @param num_workers Workers, i.e. clients served at once (0 = one per core)
+ * @return Running daemon, or NULL if the socket cannot be bound
+ */
+UnwrapDaemon* unwrap_daemon_start(const char* socket_path, int num_workers);
+
+/**
+ * @brief Stop accepting, disconnect clients, finish requests in flight,
+ *        remove the socket file and free the daemon
+ * @param daemon Daemon (may be NULL)
+ */
+void unwrap_daemon_stop(UnwrapDaemon* daemon);
+
+/**
+ * @brief Requests the daemon has answered so far
+ */
+long long unwrap_daemon_requests(const UnwrapDaemon* daemon);
+
+/**
+ * @brief Connect to a running daemon
+ * @param socket_path Socket path (NULL = unwrap_daemon_default_socket())
+ * @return Connection, or NULL if no daemon listens there
+ */
+UnwrapDaemonClient* unwrap_daemon_connect(const char* socket_path);
+
+/**
+ * @brief Close a connection and remove its shared-memory directory
+ * @param client Connection (may be NULL)
+ */
+void unwrap_daemon_disconnect(UnwrapDaemonClient* client);
+
+/**
+ * @brief Have the daemon unwrap one file into another
+ *
+ * Paths are opened by the daemon, so relative paths resolve against its
+ * working directory. Pointer fields of params are not sent: progress,
+ * cancel, pinned_vertices, seam_edges and face_importance are ignored,
+ * and a non-NULL lscm_plan asks for the worker's own plan.
+ *
+ * @param params Unwrapping parameters (NULL = defaults)
+ * @param stats_out Optional statistics, as unwrap_batch() reports them
+ * @return UnwrapBatchStatus, or -1 if the connection failed
+ */
+int unwrap_daemon_unwrap_file(UnwrapDaemonClient* client,
+                              const char* input_path,
+                              const char* output_path,
+                              const UnwrapParams* params,
+                              UnwrapBatchFileStats* stats_out);
+
+/**
+ * @brief Have the daemon unwrap a mesh handed over in shared memory
+ *
+ * Same parameter handling as unwrap_daemon_unwrap_file(). The shared
+ * files are unlinked before returning; the answer stays mapped.
+ *
+ * @param stats_out Optional statistics (load and save times are the
+ *        daemon's mapping and writing of the shared files)
+ * @return Unwrapped mesh and its result (mesh_bin_mesh(),
+ *         mesh_bin_result()), or NULL on failure
+ * @note Caller must free with free_mesh_bin()
+ */
+MeshBin* unwrap_daemon_unwrap(UnwrapDaemonClient* client,
+                              const Mesh* mesh,
+                              const UnwrapParams* params,
+                              UnwrapBatchFileStats* stats_out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UNWRAP_DAEMON_H */
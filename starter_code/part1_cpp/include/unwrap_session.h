@@ -0,0 +1,135 @@
+/**
+ * @file unwrap_session.h
+ * @brief Incremental re-unwrapping after seam edits or vertex moves
+ */
+
+#ifndef UNWRAP_SESSION_H
+#define UNWRAP_SESSION_H
+
+#include "unwrap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Opaque incremental unwrap state for one mesh
+ *
+ * Keeps a copy of the mesh, its topology, the current seams, the island
+ * decomposition and each island's LSCM UVs before packing. After edits,
+ * unwrap_session_unwrap() re-extracts islands if the seams changed or,
+ * outside a frame sequence, vertices moved (a linear union-find pass;
+ * closed islands are opened along their normals), solves only islands whose face set changed or
+ * that contain a moved vertex, and repacks everything. A session must not be used by two
+ * threads at once.
+ */
+typedef struct UnwrapSession UnwrapSession;
+
+/**
+ * @brief Create a session with the seams unwrap_mesh() would cut
+ *
+ * Those are params->seam_edges when set (copied, so the array may go
+ * away after this call), and detected seams otherwise.
+ *
+ * @param mesh Mesh to unwrap (copied; triangles are fixed for the session)
+ * @param params Unwrapping parameters (NULL = defaults; copied)
+ * @return New session, or NULL on error; free with unwrap_session_free()
+ */
+UnwrapSession* unwrap_session_create(const Mesh* mesh, const UnwrapParams* params);
+
+/**
+ * @brief Create a session for the frames of a deforming mesh
+ *
+ * A session as from unwrap_session_create() whose solves go through an
+ * LscmPlan (params->lscm_plan, or one the session owns): the first
+ * unwrap (frame 0) chooses every island's pins and fill-reducing
+ * ordering and runs the symbolic factorisations, and later frames only
+ * refresh positions, update the triangles' coefficients and refactor
+ * numerically. Pins staying on the same vertices also keeps the UVs of
+ * consecutive frames aligned. Topology, seams and islands, including the
+ * charts closed islands are opened into, are fixed from frame 0 unless
+ * the seams are edited.
+ *
+ * Islands are then always solved on the sparse path, so a frame's UVs
+ * match unwrap_mesh() with the same plan rather than without one.
+ *
+ * @param mesh Frame 0 (copied; triangles are fixed for the session)
+ * @param params Unwrapping parameters (NULL = defaults; copied)
+ * @param warm_start Nonzero to start iterative solves (LSCM_SOLVER_CG)
+ *        of each island from its UVs in the previous frame
+ * @return New session, or NULL on error; free with unwrap_session_free()
+ */
+UnwrapSession* unwrap_session_create_frames(const Mesh* mesh, const UnwrapParams* params, int warm_start);
+
+/**
+ * @brief Free a session
+ * @param session Session to free (may be NULL)
+ */
+void unwrap_session_free(UnwrapSession* session);
+
+/**
+ * @brief Mark or clear seams on edges given by their end vertices
+ * @param session Session
+ * @param edge_vertices Vertex pairs [a,b, a,b, ...] (2 * num_edges)
+ * @param num_edges Number of pairs
+ * @param is_seam 1 to mark, 0 to clear
+ * @return Number of edges whose seam flag changed, or -1 if a pair is not
+ *         an edge of the mesh (pairs before it are applied)
+ */
+int unwrap_session_set_seams(UnwrapSession* session,
+                             const int* edge_vertices,
+                             int num_edges,
+                             int is_seam);
+
+/**
+ * @brief Current seams
+ * @param session Session
+ * @param edge_vertices_out Optional output vertex pairs (2 * capacity)
+ * @param capacity Pairs edge_vertices_out can hold
+ * @return Total number of seam edges (may exceed capacity)
+ */
+int unwrap_session_get_seams(const UnwrapSession* session, int* edge_vertices_out, int capacity);
+
+/**
+ * @brief Move vertices; islands touching them are solved again
+ * @param session Session
+ * @param indices Vertex indices (count)
+ * @param positions New positions [x,y,z, ...] (3 * count)
+ * @param count Number of vertices
+ * @return 0 on success, -1 on an out-of-range index (earlier ones are applied)
+ */
+int unwrap_session_move_vertices(UnwrapSession* session,
+                                 const int* indices,
+                                 const float* positions,
+                                 int count);
+
+/**
+ * @brief Replace every vertex position, e.g. with the next animation frame
+ *
+ * Vertices whose position is unchanged bit for bit do not count as moved.
+ *
+ * @param session Session
+ * @param positions New positions [x,y,z, ...] (3 * num_vertices)
+ * @return 0 on success, -1 on invalid arguments
+ */
+int unwrap_session_set_frame(UnwrapSession* session, const float* positions);
+
+/**
+ * @brief Unwrap with the session's current seams and positions
+ *
+ * The first call solves every island. Later calls solve only islands
+ * that are new or contain a moved vertex and reuse the others' UVs;
+ * result_out->stats.num_solved_islands counts the islands solved by this
+ * call. Output ownership is the same as unwrap_mesh().
+ *
+ * @param session Session
+ * @param result_out Output metadata (allocated by function)
+ * @return New mesh with UVs, or NULL on error
+ */
+Mesh* unwrap_session_unwrap(UnwrapSession* session, UnwrapResult** result_out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UNWRAP_SESSION_H */
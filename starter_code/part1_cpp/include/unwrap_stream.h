@@ -0,0 +1,65 @@
+/**
+ * @file unwrap_stream.h
+ * @brief Out-of-core unwrapping of binary meshes in bounded-memory chunks
+ */
+
+#ifndef UNWRAP_STREAM_H
+#define UNWRAP_STREAM_H
+
+#include "unwrap.h"
+#include "mesh_bin.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Summary of a streaming unwrap
+ */
+typedef struct {
+    int num_chunks;              /**< Spatial chunks processed */
+    int max_chunk_faces;         /**< Largest chunk (may exceed the budget if one cell does) */
+    int budget_faces;            /**< Faces per chunk allowed by the memory budget */
+    int num_islands;             /**< Islands over all chunks */
+} UnwrapStreamStats;
+
+/**
+ * @brief Unwrap a mesh_bin file chunk by chunk, writing UVs to a new file
+ *
+ * The input is mapped, never loaded whole. Faces are bucketed into a
+ * spatial grid and the cells, in Morton order, are grouped into chunks
+ * whose estimated unwrap working set fits memory_budget. Each chunk is
+ * unwrapped as an independent mesh through one reused UnwrapContext, so
+ * chunk borders become seams: a vertex on a border keeps its index in the
+ * first chunk that uses it and gets a copy per later chunk, appended after
+ * the input vertices, so every face keeps its own chunk's UVs. Within a
+ * chunk the output is UV_OUTPUT_SHARED. The output is written in place
+ * through a mapping as chunks finish.
+ *
+ * With pack_islands set and more than one chunk, chunk k is packed into
+ * UDIM tile k (u offset k % 10, v offset k / 10). A mesh that fits the
+ * budget is unwrapped in one chunk exactly like unwrap_mesh().
+ *
+ * Besides the chunk working set, the call holds 8 bytes per face and 8
+ * per vertex for the partition, the chunk owning each vertex and the
+ * vertex remap.
+ *
+ * @param input_path mesh_bin file to unwrap (uncompressed for out-of-core);
+ *        its checksums and triangle indices are verified on load
+ * @param output_path mesh_bin file to write, with UVs and result sections
+ * @param params Unwrapping parameters (NULL = defaults)
+ * @param memory_budget Per-chunk working-set target in bytes (0 = 1 GiB)
+ * @param stats_out Optional summary
+ * @return 0 on success, -1 on error
+ */
+int unwrap_mesh_bin_streaming(const char* input_path,
+                              const char* output_path,
+                              const UnwrapParams* params,
+                              long long memory_budget,
+                              UnwrapStreamStats* stats_out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UNWRAP_STREAM_H */
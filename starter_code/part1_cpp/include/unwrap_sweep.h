@@ -0,0 +1,81 @@
+/**
+ * @file unwrap_sweep.h
+ * @brief Evaluate many unwrap parameter combinations on one mesh
+ */
+
+#ifndef UNWRAP_SWEEP_H
+#define UNWRAP_SWEEP_H
+
+#include "unwrap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief One parameter combination of a sweep
+ */
+typedef struct {
+    float angle_threshold;       /**< As in UnwrapParams */
+    int min_island_faces;        /**< As in UnwrapParams */
+    float island_margin;         /**< As in UnwrapParams */
+} UnwrapSweepPoint;
+
+/**
+ * @brief Quality of one combination, as unwrap_mesh() would report it
+ */
+typedef struct {
+    int num_islands;             /**< UV islands */
+    float avg_stretch;           /**< As in UnwrapResult */
+    float max_stretch;           /**< As in UnwrapResult */
+    float stretch_l2;            /**< As in UnwrapResult */
+    float stretch_linf;          /**< As in UnwrapResult */
+    float angle_distortion;      /**< As in UnwrapResult */
+    float max_angle_distortion;  /**< As in UnwrapResult */
+    float coverage;              /**< As in UnwrapResult */
+    float overlap;               /**< As in UnwrapResult */
+} UnwrapSweepResult;
+
+/**
+ * @brief How much work a sweep shared between its combinations
+ */
+typedef struct {
+    int num_seam_sets;           /**< Distinct seam sets (one per angle, minus identical ones) */
+    int num_island_solves;       /**< LSCM solves, each reused by every combination sharing it */
+    long long total_ns;          /**< Whole call */
+} UnwrapSweepStats;
+
+/**
+ * @brief Unwrap a mesh under many parameter combinations, sharing the work
+ *
+ * Topology is built once and seams are detected once per distinct
+ * angle_threshold; angles that give the same seams share their islands.
+ * Each island is solved once, for the smallest min_island_faces that
+ * needs it, and every combination then only gathers its islands' UVs,
+ * packs them with its margin and measures the result. Seam detection,
+ * the island solves and the combinations each run in parallel.
+ *
+ * Results equal the metrics of unwrap_mesh() called with base and the
+ * combination's three fields.
+ *
+ * @param mesh Input mesh
+ * @param base Every other parameter (NULL = defaults); base->num_threads
+ *        sets the sweep's workers (0 = one per core)
+ * @param points Combinations to evaluate (n)
+ * @param n Number of combinations
+ * @param results_out Output per combination (n entries, caller-allocated)
+ * @param stats_out Optional sharing statistics
+ * @return 0 on success, -1 on error
+ */
+int unwrap_sweep(const Mesh* mesh,
+                 const UnwrapParams* base,
+                 const UnwrapSweepPoint* points,
+                 int n,
+                 UnwrapSweepResult* results_out,
+                 UnwrapSweepStats* stats_out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UNWRAP_SWEEP_H */
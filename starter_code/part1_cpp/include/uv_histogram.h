@@ -0,0 +1,119 @@
+/**
+ * @file uv_histogram.h
+ * @brief Mergeable log-bucket histograms for fleet statistics
+ *
+ * Positive values fall into fixed buckets: every power-of-two octave from
+ * 2^UV_HISTOGRAM_MIN_EXP to 2^UV_HISTOGRAM_MAX_EXP is split into
+ * UV_HISTOGRAM_SUB_BUCKETS equal-width buckets, so a quantile read back
+ * from the buckets is within half a bucket (about 3%) of the true value.
+ * Smaller values, zero included, share the first bucket and larger ones
+ * the last. Recording a value costs a frexp() and an increment.
+ *
+ * The buckets are the same in every process, so histograms from several
+ * workers or machines merge by adding their counts, in any order, and
+ * give the same quantiles as one histogram fed every value. The JSON form
+ * lists the nonzero buckets only and is read back by uv_histogram_from_json()
+ * for merging on another node.
+ */
+
+#ifndef UV_HISTOGRAM_H
+#define UV_HISTOGRAM_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define UV_HISTOGRAM_MIN_EXP (-20)
+#define UV_HISTOGRAM_MAX_EXP 44
+#define UV_HISTOGRAM_SUB_BUCKETS 16
+/** Underflow bucket, the octave buckets, overflow bucket */
+#define UV_HISTOGRAM_BUCKETS \
+    ((UV_HISTOGRAM_MAX_EXP - UV_HISTOGRAM_MIN_EXP) * UV_HISTOGRAM_SUB_BUCKETS + 2)
+
+/**
+ * @brief Count, sum, range and bucket counts of a stream of values
+ *
+ * Zero-initialised (uv_histogram_clear()) it is an empty histogram.
+ */
+typedef struct {
+    long long count;             /**< Values recorded (NaN and infinities are ignored) */
+    double sum;                  /**< Sum of the values */
+    double min;                  /**< Smallest value (0 while empty) */
+    double max;                  /**< Largest value (0 while empty) */
+    long long buckets[UV_HISTOGRAM_BUCKETS]; /**< Values per bucket, see uv_histogram_bucket() */
+} UvHistogram;
+
+/**
+ * @brief Empty a histogram
+ */
+void uv_histogram_clear(UvHistogram* histogram);
+
+/**
+ * @brief Bucket a value falls into
+ * @return Index in [0, UV_HISTOGRAM_BUCKETS)
+ */
+int uv_histogram_bucket(double value);
+
+/**
+ * @brief Lower bound of a bucket (0 for the underflow bucket)
+ */
+double uv_histogram_bucket_lower(int bucket);
+
+/**
+ * @brief Record one value
+ */
+void uv_histogram_record(UvHistogram* histogram, double value);
+
+/**
+ * @brief Add the counts of src to dst
+ */
+void uv_histogram_merge(UvHistogram* dst, const UvHistogram* src);
+
+/**
+ * @brief Value below which a fraction q of the recorded values lie
+ *
+ * The midpoint of the bucket holding the q-th value, clamped to
+ * [min, max]; q = 0 and q = 1 give min and max exactly.
+ *
+ * @param q Fraction in [0, 1] (clamped)
+ * @return The quantile, or 0 if the histogram is empty
+ */
+double uv_histogram_quantile(const UvHistogram* histogram, double q);
+
+/**
+ * @brief Mean of the recorded values (0 if empty)
+ */
+double uv_histogram_mean(const UvHistogram* histogram);
+
+/**
+ * @brief Write a histogram as a JSON object
+ *
+ * {"count":N,"sum":S,"min":A,"max":B,"mean":M,"p50":..,"p90":..,"p99":..,
+ *  "buckets":[[index,count],...]} with only the nonzero buckets listed.
+ * Output is always NUL-terminated when size > 0, as with snprintf().
+ *
+ * @param out Buffer (may be NULL when size is 0)
+ * @param size Buffer size in bytes
+ * @return Length of the whole text without the NUL, so a return >= size
+ *         means the buffer was too small
+ */
+size_t uv_histogram_to_json(const UvHistogram* histogram, char* out, size_t size);
+
+/**
+ * @brief Read a histogram written by uv_histogram_to_json()
+ *
+ * The derived mean and quantile members are ignored.
+ *
+ * @param json Text of one JSON object
+ * @param histogram Histogram to fill
+ * @return 0 on success, -1 on a syntax error or a bucket out of range
+ */
+int uv_histogram_from_json(const char* json, UvHistogram* histogram);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UV_HISTOGRAM_H */
@@ -0,0 +1,66 @@
+/**
+ * @file uv_log.h
+ * @brief Library log level and message sink
+ *
+ * Progress and diagnostics are routed through one sink instead of going
+ * straight to stdout/stderr. Messages above the current level are dropped
+ * before they are formatted, so a silenced library does no log I/O at all.
+ */
+
+#ifndef UV_LOG_H
+#define UV_LOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Log levels, most severe first
+ */
+typedef enum {
+    UV_LOG_SILENT = 0,           /**< Nothing is logged */
+    UV_LOG_ERROR = 1,            /**< Failed operations */
+    UV_LOG_WARNING = 2,          /**< Fallbacks and suspicious input */
+    UV_LOG_INFO = 3,             /**< One-line summaries per call (loads, saves, unwraps) */
+    UV_LOG_DEBUG = 4             /**< Per-island and per-stage detail */
+} UvLogLevel;
+
+/**
+ * @brief Log sink
+ * @param level UvLogLevel of the message
+ * @param message Formatted message, without a trailing newline
+ * @param user_data Pointer given to uv_set_log_callback()
+ * @note May be called from island worker threads; calls are serialised
+ */
+typedef void (*UvLogCallback)(int level, const char* message, void* user_data);
+
+/**
+ * @brief Set the most verbose level that is logged
+ *
+ * The default is UV_LOG_SILENT in release (NDEBUG) builds and
+ * UV_LOG_INFO otherwise.
+ */
+void uv_set_log_level(int level);
+
+/**
+ * @brief Current log level
+ */
+int uv_get_log_level(void);
+
+/**
+ * @brief Route messages to a callback
+ *
+ * The sink is process-wide; an UnwrapContext can take its own with
+ * unwrap_context_set_log_callback().
+ *
+ * @param callback Sink, or NULL to restore the default (errors and
+ *        warnings to stderr, the rest to stdout)
+ * @param user_data Passed back to every call
+ */
+void uv_set_log_callback(UvLogCallback callback, void* user_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UV_LOG_H */
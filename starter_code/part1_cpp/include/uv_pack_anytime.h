@@ -0,0 +1,112 @@
+/**
+ * @file uv_pack_anytime.h
+ * @brief Packing that answers at once and improves in the background
+ *
+ * uv_pack_start() shelf-packs the islands into the mesh's UVs before it
+ * returns, as pack_uv_islands_ex() would, then keeps searching for a
+ * tighter box layout on worker threads: first the MaxRects (or skyline)
+ * layout pack_uv_islands_ex() gives, then local-search moves on the
+ * order the islands are placed in (swaps, moves and reversed runs),
+ * keeping any order that packs into a smaller square. Every layout that
+ * is better than all before it is published through a callback and can
+ * be copied out with uv_pack_best(), so a UI or a batch slot is never
+ * held up by a slow pack.
+ */
+
+#ifndef UV_PACK_ANYTIME_H
+#define UV_PACK_ANYTIME_H
+
+#include "mesh.h"
+#include "unwrap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Opaque background packing job
+ */
+typedef struct UvPackJob UvPackJob;
+
+/**
+ * @brief Called with each layout better than every earlier one
+ *
+ * Runs on a worker thread; calls are serialised and see strictly
+ * increasing fill. uvs (2 * num_vertices floats) is only valid during
+ * the call.
+ *
+ * @param uvs Packed UVs of every mesh vertex
+ * @param fill Fraction of [0,1]² the islands cover
+ * @param round Search round that found the layout (0 = the engine's own order)
+ */
+typedef void (*UvPackImproved)(const float* uvs, int num_vertices, float fill, int round, void* user_data);
+
+/**
+ * @brief Options of uv_pack_start()
+ */
+typedef struct {
+    float margin;                /**< Gap between islands in [0,1]² units */
+    int method;                  /**< PackMethod of the search: MAXRECTS or SKYLINE (others use MAXRECTS) */
+    int rotation;                /**< PackRotation of both the shelf pack and the search */
+    float time_limit;            /**< Seconds of background search (0 = no limit; needs max_rounds) */
+    int max_rounds;              /**< Layouts tried over all workers (0 = no limit; needs time_limit) */
+    int num_threads;             /**< Search workers (0 = one per core) */
+    unsigned seed;               /**< Seed of the search moves */
+    UvPackImproved on_improved;  /**< Optional callback (may be NULL) */
+    void* user_data;             /**< Passed to on_improved */
+} UvPackOptions;
+
+/**
+ * @brief Fill options with the defaults: margin 0.02, MaxRects, no
+ *        rotation, a 2 second search on every core
+ */
+void uv_pack_options_default(UvPackOptions* options);
+
+/**
+ * @brief Shelf-pack mesh->uvs now and start searching for better layouts
+ *
+ * When this returns, mesh->uvs holds the shelf layout; the mesh is not
+ * touched again, and mesh and result may go away. With a single island
+ * there is nothing to improve and no worker is started.
+ *
+ * @param mesh Mesh with per-island UVs (packed in place)
+ * @param result Island assignment (num_islands, face_island_ids)
+ * @param options Options (NULL = defaults; copied)
+ * @return Job, or NULL on invalid input; free with uv_pack_free()
+ */
+UvPackJob* uv_pack_start(Mesh* mesh, const UnwrapResult* result, const UvPackOptions* options);
+
+/**
+ * @brief Ask the workers to stop after their current layout
+ */
+void uv_pack_cancel(UvPackJob* job);
+
+/**
+ * @brief Wait until the search has finished, by budget or cancellation
+ */
+void uv_pack_wait(UvPackJob* job);
+
+/**
+ * @brief 1 while workers are still searching, 0 once they have stopped
+ */
+int uv_pack_running(const UvPackJob* job);
+
+/**
+ * @brief Copy the best layout so far
+ * @param uvs_out 2 * num_vertices floats, or NULL
+ * @param fill_out Fraction of [0,1]² the islands cover, or NULL
+ * @return Number of improvements published so far (0 = still the shelf layout)
+ */
+int uv_pack_best(UvPackJob* job, float* uvs_out, float* fill_out);
+
+/**
+ * @brief Cancel, wait for and free a job
+ * @param job Job to free (may be NULL)
+ */
+void uv_pack_free(UvPackJob* job);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UV_PACK_ANYTIME_H */
@@ -0,0 +1,101 @@
+/**
+ * @file uv_quantize.h
+ * @brief 16-bit normalised UVs for compact output files
+ *
+ * Each UV component is stored as q = round((uv - offset) / scale * 65535)
+ * in a box of offset and scale. The global grid uses one box for the
+ * whole mesh, [0,1]² whenever the UVs fit in it, so q / 65535 is the UV
+ * exactly as glTF reads normalised unsigned shorts. The per-island grid
+ * gives every island its own box, spending all 16 bits on the island's
+ * extent.
+ *
+ * Rounding moves a vertex by up to half a grid step, which can push
+ * tightly packed islands into each other. quantize_uvs() rasterises the
+ * mesh at the texture resolution before and after and refuses grids that
+ * add overlapping texels.
+ */
+
+#ifndef UV_QUANTIZE_H
+#define UV_QUANTIZE_H
+
+#include "mesh.h"
+#include "unwrap.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Quantisation grid
+ */
+typedef enum {
+    UV_QUANTIZE_GLOBAL = 0,      /**< One box for every vertex (default) */
+    UV_QUANTIZE_PER_ISLAND = 1   /**< One box per island (needs face island ids) */
+} UvQuantizeGrid;
+
+/**
+ * @brief Quantisation options
+ */
+typedef struct {
+    int grid;                    /**< UvQuantizeGrid */
+    int texture_size;            /**< Texture side in texels the overlap check rasterises at
+                                      (default 1024, 0 = no check) */
+} UvQuantizeOptions;
+
+/**
+ * @brief 16-bit UVs and the boxes that decode them
+ *
+ * Vertex v decodes in box b = vertex_box ? vertex_box[v] : 0 as
+ * uv = boxes[b*4 + 0..1] + q / 65535 * boxes[b*4 + 2..3].
+ */
+typedef struct {
+    int num_vertices;
+    uint16_t* uvs;               /**< num_vertices * 2 */
+    int grid;                    /**< UvQuantizeGrid actually used */
+    int num_boxes;               /**< 1 for the global grid, islands for per-island */
+    float* boxes;                /**< offset u, offset v, scale u, scale v per box */
+    int* vertex_box;             /**< Box of each vertex (NULL for the global grid) */
+    float max_error;             /**< Largest |decoded - input| component */
+} QuantizedUvs;
+
+/**
+ * @brief Fill options with the defaults (global grid, 1024² check)
+ */
+void uv_quantize_options_default(UvQuantizeOptions* options);
+
+/**
+ * @brief Quantise a mesh's UVs to 16 bits
+ *
+ * A vertex takes the box of the island of the first face that uses it.
+ * The per-island grid falls back to the global one without island ids.
+ *
+ * @param mesh Mesh with UVs
+ * @param face_island_ids Island per face (UnwrapResult::face_island_ids), or NULL
+ * @param num_islands Number of islands in face_island_ids
+ * @param options Options (NULL = defaults)
+ * @return Quantised UVs (free with free_quantized_uvs()), or NULL if the
+ *         mesh has no UVs or quantising adds overlap at texture_size
+ */
+QuantizedUvs* quantize_uvs(const Mesh* mesh,
+                           const int* face_island_ids,
+                           int num_islands,
+                           const UvQuantizeOptions* options);
+
+/**
+ * @brief Decode quantised UVs
+ * @param quantized Quantised UVs
+ * @param uvs_out Caller buffer of quantized->num_vertices * 2 floats
+ */
+void dequantize_uvs(const QuantizedUvs* quantized, float* uvs_out);
+
+/**
+ * @brief Free quantised UVs
+ */
+void free_quantized_uvs(QuantizedUvs* quantized);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UV_QUANTIZE_H */
@@ -0,0 +1,44 @@
+/**
+ * @file uv_trace.h
+ * @brief Recording the library's profiling zones to a Chrome trace
+ *
+ * Builds configured with UVUNWRAP_TRACE=CHROME time zones per unwrap
+ * stage, per island solve, inside LSCM (assembly, pins, factorisation,
+ * solve, normalise) and in the OBJ reader and writer, and write them as
+ * trace-event JSON for chrome://tracing or ui.perfetto.dev. Worker threads
+ * are named, so gaps in the island schedule show up per thread.
+ *
+ * UVUNWRAP_TRACE=TRACY builds emit the same zones to a connected Tracy
+ * profiler instead and need none of these calls. In other builds the
+ * zones compile away and uv_trace_start() returns 0.
+ */
+
+#ifndef UV_TRACE_H
+#define UV_TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Start recording zones from every thread
+ *
+ * A trace already being recorded is discarded.
+ *
+ * @param path JSON file written by uv_trace_stop()
+ * @return 1 on success, 0 if this build records no Chrome traces or the
+ *         file cannot be created
+ */
+int uv_trace_start(const char* path);
+
+/**
+ * @brief Stop recording and write the trace
+ * @return Number of zones written, or -1 if no trace was being recorded
+ */
+int uv_trace_stop(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UV_TRACE_H */
@@ -0,0 +1,166 @@
+/**
+ * @file uvwrap_native.cpp
+ * @brief pybind11 module: unwrap_mesh on NumPy arrays without copies
+ *
+ * Built with -DUVUNWRAP_WITH_PYTHON=ON and loaded by uvwrap.bindings in
+ * place of its ctypes path when present. Inputs are read in place when
+ * they are already C-contiguous float32 / int32 (other arrays are
+ * converted once), the GIL is released for the whole unwrap, and the
+ * output arrays point straight into the library's buffers, which a
+ * capsule frees when the last array referencing them goes away.
+ *
+ * Parameters arrive as the bytes of bindings.CUnwrapParams, so the
+ * ctypes struct stays the single Python-side definition of UnwrapParams.
+ */
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdexcept>
+#include <string>
+
+#include "mesh.h"
+#include "unwrap.h"
+
+namespace py = pybind11;
+
+namespace {
+
+typedef py::array_t<float, py::array::c_style | py::array::forcecast> FloatArray;
+typedef py::array_t<int, py::array::c_style | py::array::forcecast> IntArray;
+
+void check_rows(const py::array& a, const char* name, py::ssize_t columns) {
+    if (a.ndim() != 2 || a.shape(1) != columns) {
+        throw py::value_error(std::string(name) + " must have shape (n, " +
+                              std::to_string(columns) + ")");
+    }
+}
+
+py::dict stats_dict(const UnwrapResult* r) {
+    const UnwrapStats& s = r->stats;
+    py::dict d;
+    d["total_ns"] = s.total_ns;
+    d["topology_ns"] = s.topology_ns;
+    d["seams_ns"] = s.seams_ns;
+    d["islands_ns"] = s.islands_ns;
+    d["lscm_ns"] = s.lscm_ns;
+    d["lscm_assembly_ns"] = s.lscm_assembly_ns;
+    d["lscm_factor_ns"] = s.lscm_factor_ns;
+    d["lscm_solve_ns"] = s.lscm_solve_ns;
+    d["packing_ns"] = s.packing_ns;
+    d["metrics_ns"] = s.metrics_ns;
+    d["matrix_nonzeros"] = s.matrix_nonzeros;
+    d["factor_nonzeros"] = s.factor_nonzeros;
+    d["solver_iterations"] = s.solver_iterations;
+    d["scratch_bytes"] = s.scratch_bytes;
+    d["peak_island_faces"] = s.peak_island_faces;
+    d["peak_island_vertices"] = s.peak_island_vertices;
+    d["num_solved_islands"] = s.num_solved_islands;
+    d["num_nonmanifold_edges"] = s.num_nonmanifold_edges;
+    d["num_nonmanifold_vertices"] = s.num_nonmanifold_vertices;
+    d["num_flagged_faces"] = s.num_flagged_faces;
+    d["num_fallback_islands"] = s.num_fallback_islands;
+    py::list solve_ns;
+    if (s.island_solve_ns) {
+        for (int i = 0; i < r->num_islands; i++) solve_ns.append(s.island_solve_ns[i]);
+    }
+    d["island_solve_ns"] = solve_ns;
+    d["cache_hit"] = s.cache_hit;
+    d["peak_bytes"] = s.peak_bytes;
+    py::list stage_peak, stage_end;
+    for (int i = 0; i < UNWRAP_STAGE_DONE; i++) {
+        stage_peak.append(s.stage_peak_bytes[i]);
+        stage_end.append(s.stage_end_bytes[i]);
+    }
+    d["stage_peak_bytes"] = stage_peak;
+    d["stage_end_bytes"] = stage_end;
+    py::list island_peak;
+    if (s.island_peak_bytes) {
+        for (int i = 0; i < r->num_islands; i++) island_peak.append(s.island_peak_bytes[i]);
+    }
+    d["island_peak_bytes"] = island_peak;
+    d["num_memory_waits"] = s.num_memory_waits;
+    return d;
+}
+
+/** Same keys as the dict bindings.unwrap() builds on the ctypes path */
+py::dict result_dict(const UnwrapResult* r) {
+    py::dict d;
+    d["num_islands"] = r->num_islands;
+    d["avg_stretch"] = r->avg_stretch;
+    d["max_stretch"] = r->max_stretch;
+    d["coverage"] = r->coverage;
+    d["overlap"] = r->overlap;
+    d["num_tiles"] = r->num_tiles;
+    d["solver_iterations"] = r->solver_iterations;
+    d["solver_residual"] = r->solver_residual;
+    d["stretch_l2"] = r->stretch_l2;
+    d["stretch_linf"] = r->stretch_linf;
+    d["angle_distortion"] = r->angle_distortion;
+    d["max_angle_distortion"] = r->max_angle_distortion;
+    d["stats"] = stats_dict(r);
+    return d;
+}
+
+/**
+ * (vertices, triangles, uvs, face_island_ids, result) for one mesh
+ *
+ * context is an UnwrapContext* as an integer (0 = none), as ctypes hands
+ * out the handles of bindings.UnwrapContext.
+ */
+py::tuple unwrap(FloatArray vertices, IntArray triangles, py::buffer params, uintptr_t context) {
+    check_rows(vertices, "vertices", 3);
+    check_rows(triangles, "triangles", 3);
+
+    py::buffer_info info = params.request();
+    if (info.size * info.itemsize != (py::ssize_t)sizeof(UnwrapParams)) {
+        throw py::value_error("params must be a CUnwrapParams matching unwrap.h");
+    }
+    UnwrapParams p;
+    memcpy(&p, info.ptr, sizeof(p));
+
+    Mesh in;
+    in.vertices = const_cast<float*>(vertices.data());
+    in.num_vertices = (int)vertices.shape(0);
+    in.triangles = const_cast<int*>(triangles.data());
+    in.num_triangles = (int)triangles.shape(0);
+    in.uvs = NULL;
+
+    Mesh* out;
+    UnwrapResult* result = NULL;
+    {
+        py::gil_scoped_release release;
+        UnwrapContext* ctx = reinterpret_cast<UnwrapContext*>(context);
+        out = ctx ? unwrap_mesh_ctx(ctx, &in, &p, &result) : unwrap_mesh(&in, &p, &result);
+    }
+    if (!out) {
+        free_unwrap_result(result);
+        throw std::runtime_error("UV unwrapping failed");
+    }
+
+    py::capsule mesh_owner(out, [](void* m) { free_mesh(static_cast<Mesh*>(m)); });
+    py::capsule result_owner(result, [](void* r) { free_unwrap_result(static_cast<UnwrapResult*>(r)); });
+
+    py::ssize_t nv = out->num_vertices;
+    py::ssize_t nt = out->num_triangles;
+    py::array_t<float> out_vertices({nv, (py::ssize_t)3}, out->vertices, mesh_owner);
+    py::array_t<int> out_triangles({nt, (py::ssize_t)3}, out->triangles, mesh_owner);
+    py::array_t<float> out_uvs({nv, (py::ssize_t)2}, out->uvs, mesh_owner);
+    py::array_t<int> island_ids({nt}, result->face_island_ids, result_owner);
+    py::dict d = result_dict(result);
+    if (result->vertex_remap) d["vertex_remap"] = py::array_t<int>({nv}, result->vertex_remap, result_owner);
+    if (result->face_remap) d["face_remap"] = py::array_t<int>({nt}, result->face_remap, result_owner);
+
+    return py::make_tuple(out_vertices, out_triangles, out_uvs, island_ids, d);
+}
+
+} // namespace
+
+PYBIND11_MODULE(_uvwrap_native, m) {
+    m.doc() = "Zero-copy NumPy front end of the uvunwrap library";
+    m.def("unwrap", &unwrap,
+          py::arg("vertices"), py::arg("triangles"), py::arg("params"), py::arg("context") = 0,
+          "Unwrap a mesh with the GIL released; returns "
+          "(vertices, triangles, uvs, face_island_ids, result)");
+}
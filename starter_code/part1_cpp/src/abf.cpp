@@ -0,0 +1,294 @@
+/**
+ * @file abf.cpp
+ * @brief ABF++ angle-based flattening
+ *
+ * Unknowns are the 3F corner angles alpha and the multipliers of the
+ * constraints: one triangle sum per face, and a planarity and a length
+ * constraint per interior vertex. The length (sine law) constraint is
+ * taken in log form, sum log sin(next) - sum log sin(prev) = 0, whose
+ * gradient is just +-cot(alpha) and which does not under- or overflow at
+ * high valence.
+ *
+ * Newton's system uses the energy Hessian diag(w) for the angle block
+ * (constraint curvature dropped, as in ABF++). With J1 the triangle rows
+ * and J2 the vertex rows, eliminating d alpha and then d lambda1 leaves
+ *
+ *   S = sum_t G_t (L_t^-1 - L_t^-1 1 1^T L_t^-1 / D_t) G_t^T
+ *
+ * where G_t is the 6 x 3 slice of J2 for face t (rows: planarity and
+ * length of its three vertices), L_t its angle weights and D_t the sum of
+ * their inverses. S has the vertex adjacency pattern in 2 x 2 blocks, so
+ * it is assembled into a fixed CSC pattern and factored with the same
+ * direct backends as LSCM; the symbolic analysis is reused by every
+ * iteration. S changes little once the angles settle, so the step after
+ * a factorisation reuses it (a chord step), and S is only factored again
+ * when a chord step fails to cut the residual enough.
+ */
+
+#include "abf.h"
+#include "direct_solver.h"
+#include "lscm_cancel.h"
+#include "vec_math.h"
+#include <math.h>
+#include <algorithm>
+
+namespace uvunwrap {
+
+namespace {
+
+const int ABF_MAX_ITERATIONS = 20;
+const double ABF_TOLERANCE = 1e-6;
+// Refactor S after a chord step that cut the residual by less than this
+const double ABF_REFACTOR_RATIO = 0.1;
+// Target angles are clamped as in ABF++, so needle triangles do not get
+// huge weights; optimised angles are only kept off 0 and pi
+const double ABF_MIN_BETA = 3.0 * M_PI / 180.0;
+const double ABF_MAX_BETA = 175.0 * M_PI / 180.0;
+const double ABF_MIN_ANGLE = 1e-6;
+
+/** 3D angle at corner k of a mesh triangle, robust for thin triangles */
+double corner_angle(const Mesh* mesh, const int* tri, int k) {
+    Vec3 p = vertex_position(mesh, tri[k]);
+    Vec3 a = sub(vertex_position(mesh, tri[(k + 1) % 3]), p);
+    Vec3 b = sub(vertex_position(mesh, tri[(k + 2) % 3]), p);
+    return atan2((double)length(cross(a, b)), (double)dot(a, b));
+}
+
+} // namespace
+
+bool abf_flatten(const Mesh* mesh,
+                 const int* face_indices,
+                 const int* local_tris,
+                 int num_faces,
+                 int n,
+                 const std::vector<int>& boundary_vertices,
+                 const LscmOptions* options,
+                 LscmSolver backend,
+                 std::vector<float>& frames_out,
+                 AbfStats* stats) {
+    int num_corners = 3 * num_faces;
+
+    // Interior vertices get the planarity (row 2i) and length (row 2i + 1)
+    // constraints
+    std::vector<int> interior(n, 0);
+    for (int c = 0; c < num_corners; c++) interior[local_tris[c]] = 1;
+    for (size_t k = 0; k < boundary_vertices.size(); k++) interior[boundary_vertices[k]] = 0;
+    int num_interior = 0;
+    for (int v = 0; v < n; v++) interior[v] = interior[v] ? num_interior++ : -1;
+    int rows = 2 * num_interior;
+
+    // Targets: 3D angles, scaled to sum to 2 pi around interior vertices
+    std::vector<double> beta(num_corners), weight(num_corners), alpha(num_corners);
+    std::vector<double> angle_sum(n, 0.0);
+    for (int t = 0; t < num_faces; t++) {
+        const int* tri = &mesh->triangles[face_indices[t] * 3];
+        for (int k = 0; k < 3; k++) {
+            beta[3 * t + k] = corner_angle(mesh, tri, k);
+            angle_sum[local_tris[3 * t + k]] += beta[3 * t + k];
+        }
+    }
+    for (int c = 0; c < num_corners; c++) {
+        int v = local_tris[c];
+        if (interior[v] >= 0 && angle_sum[v] > 0.0) beta[c] *= 2.0 * M_PI / angle_sum[v];
+        beta[c] = std::min(std::max(beta[c], ABF_MIN_BETA), ABF_MAX_BETA);
+        weight[c] = 1.0 / (beta[c] * beta[c]);
+        alpha[c] = beta[c];
+    }
+
+    // CSC pattern of S from each face's interior vertex pairs, then the
+    // value slot of every face's (k, p) x (l, q) entry (-1 if either
+    // vertex is on the boundary)
+    Eigen::SparseMatrix<double> S(rows, rows);
+    std::vector<int> slots((size_t)num_faces * 36, -1);
+    {
+        std::vector<Eigen::Triplet<double> > triplets;
+        triplets.reserve((size_t)num_faces * 36);
+        for (int t = 0; t < num_faces; t++) {
+            const int* tri = &local_tris[3 * t];
+            for (int l = 0; l < 3; l++) {
+                if (interior[tri[l]] < 0) continue;
+                for (int k = 0; k < 3; k++) {
+                    if (interior[tri[k]] < 0) continue;
+                    for (int q = 0; q < 2; q++) {
+                        for (int p = 0; p < 2; p++) {
+                            triplets.push_back(Eigen::Triplet<double>(2 * interior[tri[k]] + p,
+                                                                      2 * interior[tri[l]] + q, 0.0));
+                        }
+                    }
+                }
+            }
+        }
+        S.setFromTriplets(triplets.begin(), triplets.end());
+        S.makeCompressed();
+        const int* outer = S.outerIndexPtr();
+        const int* inner = S.innerIndexPtr();
+        for (int t = 0; t < num_faces; t++) {
+            const int* tri = &local_tris[3 * t];
+            for (int a = 0; a < 6; a++) {
+                if (interior[tri[a / 2]] < 0) continue;
+                int row = 2 * interior[tri[a / 2]] + a % 2;
+                for (int b = 0; b < 6; b++) {
+                    if (interior[tri[b / 2]] < 0) continue;
+                    int col = 2 * interior[tri[b / 2]] + b % 2;
+                    slots[(size_t)t * 36 + a * 6 + b] =
+                        (int)(std::lower_bound(inner + outer[col], inner + outer[col + 1], row) - inner);
+                }
+            }
+        }
+    }
+
+    std::unique_ptr<DirectSolver<double> > direct = create_direct_solver(backend);
+    std::vector<double> lambda_tri(num_faces, 0.0), c_tri(num_faces), r_tri(num_faces);
+    std::vector<double> cot(num_corners), grad(num_corners);
+    Eigen::VectorXd lambda(rows), c_vert(rows), rhs(rows), d_lambda(rows);
+    lambda.setZero();
+    long long nonzeros = 0;
+    int iterations = 0, factorizations = 0;
+    double residual = 0.0, previous_residual = 0.0;
+    bool refactor = true;
+
+    for (;; iterations++) {
+        // Constraints and gradient of the Lagrangian
+        c_vert.setZero();
+        for (int t = 0; t < num_faces; t++) {
+            const int* tri = &local_tris[3 * t];
+            c_tri[t] = alpha[3 * t] + alpha[3 * t + 1] + alpha[3 * t + 2] - M_PI;
+            for (int j = 0; j < 3; j++) {
+                int c = 3 * t + j;
+                int at = interior[tri[j]];
+                int next_of = interior[tri[(j + 2) % 3]];  // corner j is next for this vertex...
+                int prev_of = interior[tri[(j + 1) % 3]];  // ...and prev for this one
+                double log_sin = log(sin(alpha[c]));
+                cot[c] = 1.0 / tan(alpha[c]);
+                double g = weight[c] * (alpha[c] - beta[c]) + lambda_tri[t];
+                if (at >= 0) {
+                    c_vert[2 * at] += alpha[c];
+                    g += lambda[2 * at];
+                }
+                if (next_of >= 0) {
+                    c_vert[2 * next_of + 1] += log_sin;
+                    g += cot[c] * lambda[2 * next_of + 1];
+                }
+                if (prev_of >= 0) {
+                    c_vert[2 * prev_of + 1] -= log_sin;
+                    g -= cot[c] * lambda[2 * prev_of + 1];
+                }
+                grad[c] = g;
+            }
+        }
+        for (int i = 0; i < num_interior; i++) c_vert[2 * i] -= 2.0 * M_PI;
+
+        residual = rows > 0 ? c_vert.cwiseAbs().maxCoeff() : 0.0;
+        for (int t = 0; t < num_faces; t++) residual = std::max(residual, fabs(c_tri[t]));
+        for (int c = 0; c < num_corners; c++) residual = std::max(residual, fabs(grad[c]));
+        if (!(residual == residual)) return false;
+        if (residual < ABF_TOLERANCE || iterations == ABF_MAX_ITERATIONS) break;
+        if (lscm_cancelled(options)) return false;
+        if (iterations > 0) refactor = !refactor && residual > ABF_REFACTOR_RATIO * previous_residual;
+        previous_residual = residual;
+
+        // Schur complement S (when refactoring) and its right-hand side
+        double* values = S.valuePtr();
+        if (refactor) std::fill(values, values + S.nonZeros(), 0.0);
+        rhs = c_vert;
+        for (int t = 0; t < num_faces; t++) {
+            const int* tri = &local_tris[3 * t];
+            double inv[3], G[6][3] = {{0.0}};
+            double d = 0.0, r1 = c_tri[t];
+            for (int j = 0; j < 3; j++) {
+                int c = 3 * t + j;
+                inv[j] = 1.0 / weight[c];
+                d += inv[j];
+                r1 -= inv[j] * grad[c];
+                G[2 * j][j] = 1.0;
+                G[2 * ((j + 2) % 3) + 1][j] = cot[c];
+                G[2 * ((j + 1) % 3) + 1][j] = -cot[c];
+            }
+            r_tri[t] = r1;
+
+            // M = L^-1 - m m^T / D with m = L^-1 1, then G M G^T
+            double M[3][3];
+            for (int i = 0; i < 3; i++) {
+                for (int j = 0; j < 3; j++) M[i][j] = (i == j ? inv[i] : 0.0) - inv[i] * inv[j] / d;
+            }
+            double GM[6][3], e[6];
+            for (int a = 0; a < 6; a++) {
+                e[a] = 0.0;
+                for (int j = 0; j < 3; j++) {
+                    GM[a][j] = G[a][0] * M[0][j] + G[a][1] * M[1][j] + G[a][2] * M[2][j];
+                    e[a] += G[a][j] * inv[j];
+                }
+            }
+            const int* slot = &slots[(size_t)t * 36];
+            for (int a = 0; a < 6; a++) {
+                int v = interior[tri[a / 2]];
+                if (v < 0) continue;
+                double g_inv = 0.0;
+                for (int j = 0; j < 3; j++) g_inv += G[a][j] * inv[j] * grad[3 * t + j];
+                rhs[2 * v + a % 2] -= g_inv + e[a] * r1 / d;
+                for (int b = 0; b < 6 && refactor; b++) {
+                    if (slot[a * 6 + b] < 0) continue;
+                    values[slot[a * 6 + b]] += GM[a][0] * G[b][0] + GM[a][1] * G[b][1] + GM[a][2] * G[b][2];
+                }
+            }
+        }
+
+        if (rows > 0) {
+            long long factor_ns = 0;
+            if (refactor && !direct->factorize(S, &nonzeros, &factor_ns)) return false;
+            factorizations += refactor;
+            if (!direct->solve(rhs, d_lambda)) return false;
+        }
+
+        // Back substitution: triangle multipliers, then angles
+        for (int t = 0; t < num_faces; t++) {
+            const int* tri = &local_tris[3 * t];
+            double gt[3] = {0.0, 0.0, 0.0};
+            for (int j = 0; j < 3; j++) {
+                int c = 3 * t + j;
+                int at = interior[tri[j]];
+                int next_of = interior[tri[(j + 2) % 3]];
+                int prev_of = interior[tri[(j + 1) % 3]];
+                if (at >= 0) gt[j] += d_lambda[2 * at];
+                if (next_of >= 0) gt[j] += cot[c] * d_lambda[2 * next_of + 1];
+                if (prev_of >= 0) gt[j] -= cot[c] * d_lambda[2 * prev_of + 1];
+            }
+            double d = 0.0, e_dl = 0.0;
+            for (int j = 0; j < 3; j++) {
+                double inv = 1.0 / weight[3 * t + j];
+                d += inv;
+                e_dl += inv * gt[j];
+            }
+            double d_tri = (r_tri[t] - e_dl) / d;
+            lambda_tri[t] += d_tri;
+            for (int j = 0; j < 3; j++) {
+                int c = 3 * t + j;
+                alpha[c] += (-grad[c] - d_tri - gt[j]) / weight[c];
+                alpha[c] = std::min(std::max(alpha[c], ABF_MIN_ANGLE), M_PI - ABF_MIN_ANGLE);
+            }
+        }
+        if (rows > 0) lambda += d_lambda;
+    }
+
+    // Each face laid out with its angles by the sine law
+    frames_out.resize((size_t)num_faces * 3);
+    for (int t = 0; t < num_faces; t++) {
+        const int* tri = &mesh->triangles[face_indices[t] * 3];
+        const double* a = &alpha[3 * t];
+        double x1 = length(sub(vertex_position(mesh, tri[1]), vertex_position(mesh, tri[0])));
+        double l02 = x1 * sin(a[1]) / sin(a[2]);
+        frames_out[3 * t + 0] = (float)x1;
+        frames_out[3 * t + 1] = (float)(l02 * cos(a[0]));
+        frames_out[3 * t + 2] = (float)(l02 * sin(a[0]));
+    }
+
+    if (stats) {
+        stats->iterations = iterations;
+        stats->factorizations = factorizations;
+        stats->residual = residual;
+        stats->factor_nonzeros = nonzeros;
+    }
+    return true;
+}
+
+} // namespace uvunwrap
@@ -0,0 +1,56 @@
+/**
+ * @file abf.h
+ * @brief Internal ABF++ angle optimisation for LSCM_METHOD_ABF
+ *
+ * Not part of the public API; see LSCM_METHOD_ABF in lscm.h. Indices are
+ * island-local, as in lscm.cpp.
+ */
+
+#ifndef UVUNWRAP_ABF_H
+#define UVUNWRAP_ABF_H
+
+#include "lscm.h"
+#include <vector>
+
+namespace uvunwrap {
+
+struct AbfStats {
+    int iterations;             /**< Newton iterations run */
+    int factorizations;         /**< Schur complement factorisations (chord steps reuse one) */
+    double residual;            /**< Max-norm of the gradient and constraints at the end */
+    long long factor_nonzeros;  /**< Nonzeros in the last Schur complement factor */
+};
+
+/**
+ * @brief Flatten an island in angle space (ABF++, Sheffer et al. 2005)
+ *
+ * Minimises sum w (alpha - beta)^2 over the corner angles, with
+ * w = 1 / beta^2, subject to triangle sums of pi and, at each interior
+ * vertex, an angle sum of 2 pi and the sine-law closure. Each Newton step
+ * eliminates the angles and the triangle multipliers, so only the Schur
+ * complement over the 2 V_interior vertex multipliers is factored.
+ *
+ * @param local_tris Island triangles over local vertices [0, n)
+ * @param boundary_vertices Local vertices on the island boundary
+ * @param options Polled for cancellation between Newton steps (may be NULL)
+ * @param backend Direct backend for the Schur complement (not CG / multigrid)
+ * @param frames_out Per face (x1, x2, y2): the triangle with the optimised
+ *        angles in its local frame (vertices (0, 0), (x1, 0), (x2, y2)),
+ *        edge 01 at its 3D length
+ * @return false if a factorisation fails, the angles stop being finite or
+ *         the solve is cancelled
+ */
+bool abf_flatten(const Mesh* mesh,
+                 const int* face_indices,
+                 const int* local_tris,
+                 int num_faces,
+                 int n,
+                 const std::vector<int>& boundary_vertices,
+                 const LscmOptions* options,
+                 LscmSolver backend,
+                 std::vector<float>& frames_out,
+                 AbfStats* stats);
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_ABF_H */
@@ -0,0 +1,235 @@
+/**
+ * @file arap.cpp
+ * @brief As-rigid-as-possible UV refinement (local/global)
+ *
+ * Energy: sum over triangles and their edges (k, l) of
+ * cot(opposite angle) |(u_k - u_l) - R_t (x_k - x_l)|^2, with x the
+ * triangle laid out in its own plane. For fixed rotations the UVs solve
+ * L u = sum_t R_t q_t, where L is the cotangent Laplacian and q_t,k =
+ * sum_l cot (x_k - x_l) is a per-corner constant of the rest shape, so
+ * the right-hand side is one 2x2 rotation per corner. A proximal term
+ * eps (u - u_previous) makes L + eps I definite without pinning a vertex;
+ * since the q sum to zero per triangle it also keeps the island's mean
+ * UV, and any vertex that only degenerate triangles touch, in place.
+ */
+
+#include "arap.h"
+#include "lscm_cancel.h"
+#include "simd.h"
+#include "parallel.h"
+#include "memory_meter.h"
+#include "timer.h"
+#include "vec_math.h"
+#include <math.h>
+#include <vector>
+
+namespace uvunwrap {
+
+namespace {
+
+const int ARAP_MIN_FACES_PER_THREAD = 16384;
+const int ROTATION_BLOCK = 256;
+// Relative to the mean diagonal of L
+const double ARAP_PROXIMAL_WEIGHT = 1e-8;
+// Triangles below the LSCM area threshold have no rest shape
+const double ARAP_MIN_AREA = 1e-8;
+
+/**
+ * @brief Closest rotations of a block of triangle Jacobians
+ *
+ * With the rest triangle at (0, 0), (x1, 0), (x2, y2) and UV edges
+ * (du1, dv1), (du2, dv2) from corner 0, the Jacobian is
+ * [a b; c d] = [du1 du2; dv1 dv2] [1/x1 -x2/(x1 y2); 0 1/y2]. Its closest
+ * rotation is the angle of (a + d, c - b), which is the 2x2 polar
+ * decomposition (flipped triangles included) without an SVD. The scalar
+ * tail repeats the same float operations.
+ */
+void block_rotations(int n,
+                     const float* du1_, const float* dv1_, const float* du2_, const float* dv2_,
+                     const float* inv_x1_, const float* shear_, const float* inv_y2_,
+                     float* cos_out, float* sin_out) {
+    typedef Lanes::V V;
+    const V zero = Lanes::set1(0.0f), one = Lanes::set1(1.0f), tiny = Lanes::set1(1e-20f);
+
+    int i = 0;
+    for (; i + Lanes::N <= n; i += Lanes::N) {
+        V du1 = Lanes::load(du1_ + i), dv1 = Lanes::load(dv1_ + i);
+        V du2 = Lanes::load(du2_ + i), dv2 = Lanes::load(dv2_ + i);
+        V inv_x1 = Lanes::load(inv_x1_ + i), shear = Lanes::load(shear_ + i), inv_y2 = Lanes::load(inv_y2_ + i);
+        V a = Lanes::mul(du1, inv_x1);
+        V b = Lanes::mul(Lanes::sub(du2, Lanes::mul(du1, shear)), inv_y2);
+        V c = Lanes::mul(dv1, inv_x1);
+        V d = Lanes::mul(Lanes::sub(dv2, Lanes::mul(dv1, shear)), inv_y2);
+        V p = Lanes::add(a, d), q = Lanes::sub(c, b);
+        V norm2 = Lanes::add(Lanes::mul(p, p), Lanes::mul(q, q));
+        Lanes::M small = Lanes::lt(norm2, tiny);
+        V inv = Lanes::div(one, Lanes::sqrt(Lanes::select(small, one, norm2)));
+        Lanes::store(cos_out + i, Lanes::select(small, one, Lanes::mul(p, inv)));
+        Lanes::store(sin_out + i, Lanes::select(small, zero, Lanes::mul(q, inv)));
+    }
+    for (; i < n; i++) {
+        float a = du1_[i] * inv_x1_[i];
+        float b = (du2_[i] - du1_[i] * shear_[i]) * inv_y2_[i];
+        float c = dv1_[i] * inv_x1_[i];
+        float d = (dv2_[i] - dv1_[i] * shear_[i]) * inv_y2_[i];
+        float p = a + d, q = c - b;
+        float norm2 = p * p + q * q;
+        bool small = norm2 < 1e-20f;
+        float inv = 1.0f / sqrtf(small ? 1.0f : norm2);
+        cos_out[i] = small ? 1.0f : p * inv;
+        sin_out[i] = small ? 0.0f : q * inv;
+    }
+}
+
+} // namespace
+
+int arap_refine(const Mesh* mesh,
+                const int* face_indices,
+                const int* local_tris,
+                int num_faces,
+                int n,
+                const LscmOptions* options,
+                LscmSolver backend,
+                int max_iterations,
+                long long time_limit_ns,
+                std::unique_ptr<DirectSolver<double> >& solver,
+                float* uvs,
+                long long* factor_ns_out,
+                long long* bytes_out) {
+    long long start = now_ns();
+    if (max_iterations <= 0 || num_faces <= 0 || n <= 0) return 0;
+
+    // Rest shape: Jacobian terms for the local step, q per corner and the
+    // cotangent Laplacian for the global step
+    std::vector<float> inv_x1(num_faces, 0.0f), shear(num_faces, 0.0f), inv_y2(num_faces, 0.0f);
+    std::vector<double> q((size_t)num_faces * 6, 0.0);
+    std::vector<Eigen::Triplet<double> > triplets;
+    triplets.reserve((size_t)num_faces * 12);
+    for (int t = 0; t < num_faces; t++) {
+        const int* tri = &mesh->triangles[face_indices[t] * 3];
+        Vec3 p0 = vertex_position(mesh, tri[0]);
+        Vec3 e1 = sub(vertex_position(mesh, tri[1]), p0);
+        Vec3 e2 = sub(vertex_position(mesh, tri[2]), p0);
+        double x1 = length(e1);
+        double cross_len = length(cross(e1, e2));
+        // Degenerate triangles keep zero weights, so the pattern (and a
+        // plan's symbolic analysis) does not depend on the vertex positions
+        bool valid = x1 > 0.0 && 0.5 * cross_len >= ARAP_MIN_AREA;
+        double x2 = valid ? dot(e1, e2) / x1 : 0.0;
+        double y2 = valid ? cross_len / x1 : 0.0;
+        if (valid) {
+            inv_x1[t] = (float)(1.0 / x1);
+            shear[t] = (float)(x2 / x1);
+            inv_y2[t] = (float)(1.0 / y2);
+        }
+
+        double X[3][2] = {{0.0, 0.0}, {x1, 0.0}, {x2, y2}};
+        for (int m = 0; m < 3; m++) {
+            // cot of the angle at m weighs the opposite edge (k, l)
+            int k = (m + 1) % 3, l = (m + 2) % 3;
+            double ax = X[k][0] - X[m][0], ay = X[k][1] - X[m][1];
+            double bx = X[l][0] - X[m][0], by = X[l][1] - X[m][1];
+            double w = valid ? (ax * bx + ay * by) / cross_len : 0.0;
+            int vk = local_tris[3 * t + k], vl = local_tris[3 * t + l];
+            triplets.push_back(Eigen::Triplet<double>(vk, vk, w));
+            triplets.push_back(Eigen::Triplet<double>(vl, vl, w));
+            triplets.push_back(Eigen::Triplet<double>(vk, vl, -w));
+            triplets.push_back(Eigen::Triplet<double>(vl, vk, -w));
+            for (int dim = 0; dim < 2; dim++) {
+                q[t * 6 + k * 2 + dim] += w * (X[k][dim] - X[l][dim]);
+                q[t * 6 + l * 2 + dim] += w * (X[l][dim] - X[k][dim]);
+            }
+        }
+    }
+    Eigen::SparseMatrix<double> L(n, n);
+    L.setFromTriplets(triplets.begin(), triplets.end());
+    triplets.clear();
+    triplets.shrink_to_fit();
+    double mean_diag = L.diagonal().cwiseAbs().mean();
+    double eps = ARAP_PROXIMAL_WEIGHT * (mean_diag > 0.0 ? mean_diag : 1.0);
+    for (int i = 0; i < n; i++) L.coeffRef(i, i) += eps;
+    L.makeCompressed();
+
+    if (!solver) solver = create_direct_solver(backend);
+    long long nonzeros = 0, factor_ns = 0;
+    bool factored = solver->factorize(L, &nonzeros, &factor_ns);
+    if (factor_ns_out) *factor_ns_out = factor_ns;
+    if (bytes_out) {
+        // The corner lists, rotations and four solution vectors come next
+        *bytes_out = sparse_bytes(L) + factor_bytes(nonzeros, sizeof(double)) + vector_bytes(inv_x1) * 3 +
+                     vector_bytes(q) + (long long)(n + 1 + 3 * num_faces) * (long long)sizeof(int) +
+                     (long long)num_faces * 2 * (long long)sizeof(float) + (long long)n * 6 * (long long)sizeof(double);
+    }
+    if (!factored) return -1;
+
+    // Corners of each vertex (CSR), so the right-hand side is gathered
+    // per vertex without write conflicts
+    std::vector<int> corner_offsets(n + 1, 0), corners((size_t)num_faces * 3);
+    for (int c = 0; c < 3 * num_faces; c++) corner_offsets[local_tris[c] + 1]++;
+    for (int v = 0; v < n; v++) corner_offsets[v + 1] += corner_offsets[v];
+    {
+        std::vector<int> fill(corner_offsets.begin(), corner_offsets.end() - 1);
+        for (int c = 0; c < 3 * num_faces; c++) corners[fill[local_tris[c]]++] = c;
+    }
+
+    Eigen::VectorXd u(n), v(n), rhs_u(n), rhs_v(n);
+    for (int i = 0; i < n; i++) {
+        u[i] = uvs[2 * i];
+        v[i] = uvs[2 * i + 1];
+    }
+    std::vector<float> rot_cos(num_faces), rot_sin(num_faces);
+    int threads = choose_thread_count(num_faces, 0, ARAP_MIN_FACES_PER_THREAD);
+
+    int iterations = 0;
+    while (iterations < max_iterations && !lscm_cancelled(options)) {
+        // Local step
+        parallel_for_ranges(num_faces, threads, [&](int, int begin, int end) {
+            float du1[ROTATION_BLOCK], dv1[ROTATION_BLOCK], du2[ROTATION_BLOCK], dv2[ROTATION_BLOCK];
+            for (int block = begin; block < end; block += ROTATION_BLOCK) {
+                int count = end - block < ROTATION_BLOCK ? end - block : ROTATION_BLOCK;
+                for (int i = 0; i < count; i++) {
+                    const int* tri = &local_tris[3 * (block + i)];
+                    du1[i] = (float)(u[tri[1]] - u[tri[0]]);
+                    dv1[i] = (float)(v[tri[1]] - v[tri[0]]);
+                    du2[i] = (float)(u[tri[2]] - u[tri[0]]);
+                    dv2[i] = (float)(v[tri[2]] - v[tri[0]]);
+                }
+                block_rotations(count, du1, dv1, du2, dv2, &inv_x1[block], &shear[block], &inv_y2[block],
+                                &rot_cos[block], &rot_sin[block]);
+            }
+        });
+
+        // Global step: gather R_t q per vertex, then two solves
+        parallel_for_ranges(n, threads, [&](int, int begin, int end) {
+            for (int i = begin; i < end; i++) {
+                double su = eps * u[i], sv = eps * v[i];
+                for (int k = corner_offsets[i]; k < corner_offsets[i + 1]; k++) {
+                    int c = corners[k];
+                    int t = c / 3;
+                    double qx = q[2 * c], qy = q[2 * c + 1];
+                    su += rot_cos[t] * qx - rot_sin[t] * qy;
+                    sv += rot_sin[t] * qx + rot_cos[t] * qy;
+                }
+                rhs_u[i] = su;
+                rhs_v[i] = sv;
+            }
+        });
+        Eigen::VectorXd next_u, next_v;
+        if (!solver->solve(rhs_u, next_u) || !solver->solve(rhs_v, next_v) ||
+            !next_u.allFinite() || !next_v.allFinite()) {
+            break;
+        }
+        u.swap(next_u);
+        v.swap(next_v);
+        iterations++;
+        if (time_limit_ns > 0 && now_ns() - start >= time_limit_ns) break;
+    }
+
+    for (int i = 0; i < n; i++) {
+        uvs[2 * i] = (float)u[i];
+        uvs[2 * i + 1] = (float)v[i];
+    }
+    return iterations;
+}
+
+} // namespace uvunwrap
@@ -0,0 +1,57 @@
+/**
+ * @file arap.h
+ * @brief Internal ARAP post-pass for LscmOptions::arap_iterations
+ *
+ * Not part of the public API. Indices are island-local, as in lscm.cpp.
+ */
+
+#ifndef UVUNWRAP_ARAP_H
+#define UVUNWRAP_ARAP_H
+
+#include "lscm.h"
+#include "direct_solver.h"
+#include <memory>
+
+namespace uvunwrap {
+
+/**
+ * @brief Local/global as-rigid-as-possible refinement of island UVs
+ *        (Liu et al. 2008)
+ *
+ * The local step fits each triangle's closest rotation to its current
+ * Jacobian (closed-form 2x2 polar decomposition, vectorised with Lanes
+ * and split across threads for large islands). The global step solves
+ * the cotangent Laplacian (plus a tiny proximal term, so no vertex is
+ * pinned) for the UVs that best match the rotated 3D triangles. It only
+ * depends on the rest shape, so it is factored once and every iteration
+ * is two triangular solves.
+ *
+ * @param options Polled for cancellation between iterations (may be NULL)
+ * @param uvs In/out per local vertex [u, v, ...], not normalised
+ * @param max_iterations Local/global iterations to run
+ * @param time_limit_ns Stop after the iteration that crosses this (<= 0 = no limit)
+ * @param solver Laplacian factorisation: created with backend when empty,
+ *        otherwise refactored in place, so a plan entry keeps the symbolic
+ *        analysis across calls
+ * @param factor_ns_out Optional factorisation time
+ * @param bytes_out Optional: bytes of the Laplacian, its factor and the
+ *        per-face and per-vertex scratch
+ * @return Iterations run, or -1 if the Laplacian cannot be factored (uvs unchanged)
+ */
+int arap_refine(const Mesh* mesh,
+                const int* face_indices,
+                const int* local_tris,
+                int num_faces,
+                int n,
+                const LscmOptions* options,
+                LscmSolver backend,
+                int max_iterations,
+                long long time_limit_ns,
+                std::unique_ptr<DirectSolver<double> >& solver,
+                float* uvs,
+                long long* factor_ns_out,
+                long long* bytes_out);
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_ARAP_H */
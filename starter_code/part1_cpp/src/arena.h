@@ -0,0 +1,152 @@
+/**
+ * @file arena.h
+ * @brief Internal bump allocator for per-mesh pipeline scratch
+ *
+ * Not part of the public API. Allocations are never freed individually;
+ * reset() releases everything at once and keeps the memory, merging all
+ * blocks into one so a second pass of the same size needs no heap calls.
+ * An attached MemoryMeter is charged for every block the arena holds.
+ */
+
+#ifndef UVUNWRAP_ARENA_H
+#define UVUNWRAP_ARENA_H
+
+#include "memory_meter.h"
+#include <stdlib.h>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace uvunwrap {
+
+class Arena {
+public:
+    explicit Arena(size_t min_block_size = 64 * 1024)
+        : min_block_size_(min_block_size), used_(0), block_allocations_(0), meter_(NULL) {}
+
+    ~Arena() {
+        set_meter(NULL);
+        release();
+    }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * @brief Allocate bytes aligned to align (a power of two)
+     */
+    void* allocate(size_t bytes, size_t align = alignof(std::max_align_t)) {
+        if (!blocks_.empty()) {
+            size_t offset = (used_ + align - 1) & ~(align - 1);
+            if (offset + bytes <= blocks_.back().size) {
+                used_ = offset + bytes;
+                return blocks_.back().data + offset;
+            }
+        }
+
+        // Blocks come from malloc, so offset 0 is suitably aligned
+        size_t size = bytes > min_block_size_ ? bytes : min_block_size_;
+        if (!blocks_.empty() && size < blocks_.back().size * 2) size = blocks_.back().size * 2;
+        add_block(size);
+        used_ = bytes;
+        return blocks_.back().data;
+    }
+
+    template <typename T>
+    T* alloc_array(size_t count) {
+        return static_cast<T*>(allocate(count * sizeof(T) + (count == 0), alignof(T)));
+    }
+
+    /**
+     * @brief Release every allocation, keeping the memory for reuse
+     */
+    void reset() {
+        if (blocks_.size() > 1) {
+            size_t total = 0;
+            for (size_t i = 0; i < blocks_.size(); i++) total += blocks_[i].size;
+            release();
+            add_block(total);
+        }
+        used_ = 0;
+    }
+
+    /** Bytes currently reserved from the heap */
+    size_t capacity() const {
+        size_t total = 0;
+        for (size_t i = 0; i < blocks_.size(); i++) total += blocks_[i].size;
+        return total;
+    }
+
+    /**
+     * @brief Account the arena's blocks to meter from now on (NULL detaches)
+     *
+     * The blocks already held are charged at once and released from the
+     * previous meter.
+     */
+    void set_meter(MemoryMeter* meter) {
+        long long held = (long long)capacity();
+        if (meter_) meter_->release(held);
+        meter_ = meter;
+        if (meter_) meter_->charge(held);
+    }
+
+    /** Number of heap blocks requested over the arena's lifetime */
+    long long block_allocations() const { return block_allocations_; }
+
+private:
+    struct Block {
+        char* data;
+        size_t size;
+    };
+
+    void add_block(size_t size) {
+        char* data = (char*)malloc(size);
+        if (!data) throw std::bad_alloc();
+        Block block = {data, size};
+        blocks_.push_back(block);
+        block_allocations_++;
+        if (meter_) meter_->charge((long long)size);
+    }
+
+    void release() {
+        if (meter_) meter_->release((long long)capacity());
+        for (size_t i = 0; i < blocks_.size(); i++) free(blocks_[i].data);
+        blocks_.clear();
+        used_ = 0;
+    }
+
+    std::vector<Block> blocks_;
+    size_t min_block_size_;
+    size_t used_;
+    long long block_allocations_;
+    MemoryMeter* meter_;
+};
+
+/**
+ * @brief STL allocator drawing from an Arena (deallocate is a no-op)
+ */
+template <typename T>
+struct ArenaAllocator {
+    typedef T value_type;
+
+    Arena* arena;
+
+    explicit ArenaAllocator(Arena* a) : arena(a) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t n) { return arena->alloc_array<T>(n); }
+    void deallocate(T*, size_t) {}
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+};
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T> >;
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_ARENA_H */
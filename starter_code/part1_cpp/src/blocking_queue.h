@@ -0,0 +1,58 @@
+/**
+ * @file blocking_queue.h
+ * @brief Internal bounded queue shared by the batch pipeline and the daemon
+ *
+ * Not part of the public API.
+ */
+
+#ifndef UVUNWRAP_BLOCKING_QUEUE_H
+#define UVUNWRAP_BLOCKING_QUEUE_H
+
+#include <stddef.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace uvunwrap {
+
+/** Bounded multi-producer / multi-consumer queue; pop fails once closed and drained */
+template <typename T>
+class BlockingQueue {
+public:
+    explicit BlockingQueue(size_t capacity) : capacity_(capacity), closed_(false) {}
+
+    void push(const T& item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [&]() { return items_.size() < capacity_; });
+        items_.push_back(item);
+        not_empty_.notify_one();
+    }
+
+    bool pop(T* out) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [&]() { return !items_.empty() || closed_; });
+        if (items_.empty()) return false;
+        *out = items_.front();
+        items_.pop_front();
+        not_full_.notify_one();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        not_empty_.notify_all();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::deque<T> items_;
+    size_t capacity_;
+    bool closed_;
+};
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_BLOCKING_QUEUE_H */
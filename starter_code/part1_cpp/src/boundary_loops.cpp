@@ -0,0 +1,177 @@
+/**
+ * @file boundary_loops.cpp
+ * @brief Ordered island boundary loops on the half-edge view
+ *
+ * Boundary sides of an island are found from its own faces (no twin, or
+ * the twin's face is in another island). From the side a->b the next
+ * boundary side is reached by pivoting around b: step to the other side
+ * of the current face that touches b, cross its twin, repeat until a
+ * boundary side turns up. Each pivot visits one face of b's fan, so a
+ * whole island costs O(faces + boundary sides * log) with no edge map.
+ */
+
+#include "topology.h"
+#include "half_edge.h"
+#include "logging.h"
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+namespace uvunwrap {
+
+namespace {
+
+inline bool on_boundary(const HalfEdgeMesh& he, const int* face_island, int island, int h) {
+    int t = he.twin[h];
+    if (t < 0) return true;
+    return face_island && face_island[HalfEdgeMesh::face(t)] != island;
+}
+
+/**
+ * @brief Boundary side following h once the walk has reached vertex b
+ *
+ * Works for either side direction, so a face with flipped winding does
+ * not derail the walk.
+ *
+ * @return Half-edge touching b, or -1 if none turns up within max_steps
+ */
+int pivot_to_boundary(const HalfEdgeMesh& he, const int* face_island, int island,
+                      int h, int b, int max_steps) {
+    int g = he.target(h) == b ? HalfEdgeMesh::next(h) : HalfEdgeMesh::prev(h);
+    for (int step = 0; step < max_steps; step++) {
+        if (on_boundary(he, face_island, island, g)) return g;
+        int t = he.twin[g];
+        g = he.origin(t) == b ? HalfEdgeMesh::prev(t) : HalfEdgeMesh::next(t);
+    }
+    return -1;
+}
+
+int* copy_array(const std::vector<int>& values) {
+    int* out = (int*)malloc((values.empty() ? 1 : values.size()) * sizeof(int));
+    if (!values.empty()) memcpy(out, values.data(), values.size() * sizeof(int));
+    return out;
+}
+
+} // namespace
+
+void island_boundary_loops(const HalfEdgeMesh& he,
+                           const int* face_island,
+                           const int* faces,
+                           int num_faces,
+                           std::vector<int>& loop_offsets,
+                           std::vector<int>& loop_vertices,
+                           std::vector<int>& loop_half_edges) {
+    loop_offsets.assign(1, 0);
+    loop_vertices.clear();
+    loop_half_edges.clear();
+    if (!faces || num_faces <= 0) return;
+
+    int island = face_island ? face_island[faces[0]] : 0;
+    std::vector<int> sides;
+    for (int i = 0; i < num_faces; i++) {
+        for (int k = 0; k < 3; k++) {
+            int h = faces[i] * 3 + k;
+            if (on_boundary(he, face_island, island, h)) sides.push_back(h);
+        }
+    }
+    std::sort(sides.begin(), sides.end());
+
+    std::vector<char> visited(sides.size(), 0);
+    for (size_t start = 0; start < sides.size(); start++) {
+        if (visited[start]) continue;
+
+        size_t pos = start;
+        int h = sides[start];
+        int from = he.origin(h);
+        int to = he.target(h);
+        for (;;) {
+            visited[pos] = 1;
+            loop_vertices.push_back(from);
+            loop_half_edges.push_back(h);
+
+            int g = pivot_to_boundary(he, face_island, island, h, to, num_faces);
+            if (g < 0) break;
+            pos = std::lower_bound(sides.begin(), sides.end(), g) - sides.begin();
+            if (pos == sides.size() || sides[pos] != g || visited[pos]) break;
+
+            from = to;
+            to = he.origin(g) == from ? he.target(g) : he.origin(g);
+            h = g;
+        }
+        loop_offsets.push_back((int)loop_vertices.size());
+    }
+}
+
+} // namespace uvunwrap
+
+BoundaryLoops* build_boundary_loops(const Mesh* mesh,
+                                    const TopologyInfo* topo,
+                                    const int* face_island_ids,
+                                    int num_islands) {
+    if (!mesh || !topo) return NULL;
+    if (!face_island_ids) num_islands = 1;
+    if (num_islands < 0) return NULL;
+
+    uvunwrap::HalfEdgeMesh he;
+    if (!uvunwrap::half_edges_from_topology(mesh, topo, &he)) {
+        LOG_ERROR("build_boundary_loops: Topology does not match the mesh");
+        return NULL;
+    }
+
+    // Faces grouped by island (counting sort, ascending within each island)
+    int F = mesh->num_triangles;
+    std::vector<int> face_offsets(num_islands + 1, 0);
+    for (int f = 0; f < F; f++) {
+        int id = face_island_ids ? face_island_ids[f] : 0;
+        if (id < 0 || id >= num_islands) {
+            LOG_ERROR("build_boundary_loops: Face %d has island %d outside [0, %d)", f, id, num_islands);
+            return NULL;
+        }
+        face_offsets[id + 1]++;
+    }
+    for (int i = 0; i < num_islands; i++) face_offsets[i + 1] += face_offsets[i];
+    std::vector<int> faces(F);
+    std::vector<int> cursor(face_offsets.begin(), face_offsets.end() - 1);
+    for (int f = 0; f < F; f++) {
+        faces[cursor[face_island_ids ? face_island_ids[f] : 0]++] = f;
+    }
+
+    std::vector<int> offsets(1, 0), vertices, edges, islands;
+    std::vector<int> island_offsets(num_islands + 1, 0);
+    std::vector<int> local_offsets, local_vertices, local_half_edges;
+    for (int i = 0; i < num_islands; i++) {
+        uvunwrap::island_boundary_loops(he, face_island_ids, faces.data() + face_offsets[i],
+                                        face_offsets[i + 1] - face_offsets[i],
+                                        local_offsets, local_vertices, local_half_edges);
+        int base = (int)vertices.size();
+        for (size_t l = 1; l < local_offsets.size(); l++) {
+            offsets.push_back(base + local_offsets[l]);
+            islands.push_back(i);
+        }
+        vertices.insert(vertices.end(), local_vertices.begin(), local_vertices.end());
+        for (int h : local_half_edges) edges.push_back(he.edge[h]);
+        island_offsets[i + 1] = (int)islands.size();
+    }
+
+    BoundaryLoops* loops = (BoundaryLoops*)malloc(sizeof(BoundaryLoops));
+    loops->num_loops = (int)islands.size();
+    loops->num_islands = num_islands;
+    loops->loop_offsets = uvunwrap::copy_array(offsets);
+    loops->loop_vertices = uvunwrap::copy_array(vertices);
+    loops->loop_edges = uvunwrap::copy_array(edges);
+    loops->loop_islands = uvunwrap::copy_array(islands);
+    loops->island_loop_offsets = uvunwrap::copy_array(island_offsets);
+    return loops;
+}
+
+void free_boundary_loops(BoundaryLoops* loops) {
+    if (!loops) return;
+
+    free(loops->loop_offsets);
+    free(loops->loop_vertices);
+    free(loops->loop_edges);
+    free(loops->loop_islands);
+    free(loops->island_loop_offsets);
+    free(loops);
+}
@@ -0,0 +1,327 @@
+/**
+ * @file chart_split.cpp
+ * @brief Lloyd clustering of oversized islands into charts
+ *
+ * Every per-face array is indexed by global face, and islands own
+ * disjoint face sets, so islands are segmented in parallel without any
+ * per-island remap or locking. Labels are combined and renumbered in one
+ * final sweep over the faces.
+ */
+
+#include "chart_split.h"
+#include "triangle_geometry.h"
+#include "vec_math.h"
+#include "parallel.h"
+#include "logging.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <queue>
+#include <vector>
+
+namespace uvunwrap {
+
+namespace {
+
+// Proxy/seed updates per clustering round
+const int LLOYD_ITERATIONS = 3;
+// Rounds that add seeds to charts still over budget
+const int MAX_SPLIT_ROUNDS = 8;
+// Weight of hop distance (in expected chart radii) against normal deviation
+const float COMPACTNESS = 0.5f;
+// Widest normal cone of a chart cut from a closed island: within 90° of
+// its mean normal a chart is a height field over its mean plane, so it
+// cannot close up again
+const float CLOSED_ISLAND_COS_LIMIT = 0.0f;
+
+struct Candidate {
+    float cost;
+    int face;
+    int chart;
+    int hops;
+    bool operator>(const Candidate& o) const { return cost > o.cost || (cost == o.cost && face > o.face); }
+};
+
+/** Per-face data shared by all islands; each island touches only its faces */
+struct FaceData {
+    std::vector<Vec3> normal;    /**< Unit normal (zero for degenerate faces) */
+    std::vector<float> area;
+    std::vector<int> label;      /**< Chart within the island */
+    std::vector<int> hops;       /**< Dual-graph distance from the chart seed */
+};
+
+class IslandSegmenter {
+public:
+    IslandSegmenter(const HalfEdgeMesh& he, const int* face_island, int island,
+                    const int* faces, int count, FaceData& data)
+        : he_(he), face_island_(face_island), island_(island),
+          faces_(faces), count_(count), data_(data) {}
+
+    /** Segment into charts of at most max_faces and normal cones within cos_limit */
+    int run(int max_faces, float cos_limit) {
+        int k = max_faces > 0 ? (count_ + max_faces - 1) / max_faces : 1;
+        if (k < 2) k = 2;
+        radius_ = sqrtf((float)count_ / (float)k);
+        if (radius_ < 1.0f) radius_ = 1.0f;
+        initial_seeds(k);
+
+        for (int round = 0; round < MAX_SPLIT_ROUNDS; round++) {
+            proxies_.resize(seeds_.size());
+            for (size_t c = 0; c < seeds_.size(); c++) proxies_[c] = data_.normal[seeds_[c]];
+            grow();
+            for (int it = 0; it < LLOYD_ITERATIONS; it++) {
+                update_proxies();
+                reseed();
+                grow();
+            }
+            update_proxies();
+            if (!split_over_budget(max_faces, cos_limit)) break;
+        }
+        return (int)seeds_.size();
+    }
+
+private:
+    bool in_island(int f) const { return face_island_[f] == island_; }
+
+    float deviation(int f, int chart) const { return 1.0f - dot(data_.normal[f], proxies_[chart]); }
+
+    /** Seeds evenly spaced along a breadth-first order of the island */
+    void initial_seeds(int k) {
+        std::vector<int> order;
+        order.reserve(count_);
+        for (int i = 0; i < count_; i++) data_.label[faces_[i]] = -1;
+        order.push_back(faces_[0]);
+        data_.label[faces_[0]] = 0;
+        for (size_t q = 0; q < order.size(); q++) {
+            int f = order[q];
+            for (int s = 0; s < 3; s++) {
+                int t = he_.twin[3 * f + s];
+                if (t < 0) continue;
+                int g = HalfEdgeMesh::face(t);
+                if (!in_island(g) || data_.label[g] >= 0) continue;
+                data_.label[g] = 0;
+                order.push_back(g);
+            }
+        }
+        int reached = (int)order.size();
+        if (k > reached) k = reached;
+        seeds_.clear();
+        for (int c = 0; c < k; c++) seeds_.push_back(order[(size_t)(2 * c + 1) * reached / (2 * k)]);
+    }
+
+    /** Flood every chart from its seed, cheapest face first */
+    void grow() {
+        for (int i = 0; i < count_; i++) data_.label[faces_[i]] = -1;
+        sizes_.assign(seeds_.size(), 0);
+        std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate> > heap;
+        for (size_t c = 0; c < seeds_.size(); c++) heap.push(Candidate{0.0f, seeds_[c], (int)c, 0});
+        while (!heap.empty()) {
+            Candidate top = heap.top();
+            heap.pop();
+            if (data_.label[top.face] >= 0) continue;
+            data_.label[top.face] = top.chart;
+            data_.hops[top.face] = top.hops;
+            sizes_[top.chart]++;
+            for (int s = 0; s < 3; s++) {
+                int t = he_.twin[3 * top.face + s];
+                if (t < 0) continue;
+                int g = HalfEdgeMesh::face(t);
+                if (!in_island(g) || data_.label[g] >= 0) continue;
+                float cost = deviation(g, top.chart) + COMPACTNESS * (float)(top.hops + 1) / radius_;
+                heap.push(Candidate{cost, g, top.chart, top.hops + 1});
+            }
+        }
+    }
+
+    /** Area-weighted mean normal of every chart */
+    void update_proxies() {
+        std::vector<Vec3> sums(seeds_.size(), Vec3{0.0f, 0.0f, 0.0f});
+        for (int i = 0; i < count_; i++) {
+            int f = faces_[i];
+            int c = data_.label[f];
+            if (c >= 0) sums[c] = add(sums[c], scale(data_.normal[f], data_.area[f]));
+        }
+        for (size_t c = 0; c < seeds_.size(); c++) {
+            Vec3 n = normalize(sums[c]);
+            proxies_[c] = length(n) > 0.0f ? n : data_.normal[seeds_[c]];
+        }
+    }
+
+    /** Move each seed to its chart's face closest to the proxy, nearest the old seed on ties */
+    void reseed() {
+        std::vector<float> best(seeds_.size(), INFINITY);
+        for (int i = 0; i < count_; i++) {
+            int f = faces_[i];
+            int c = data_.label[f];
+            if (c < 0) continue;
+            float cost = deviation(f, c) + COMPACTNESS * (float)data_.hops[f] / radius_;
+            if (cost < best[c]) {
+                best[c] = cost;
+                seeds_[c] = f;
+            }
+        }
+    }
+
+    /**
+     * @brief Add a seed to every chart over budget: its worst face by
+     *        normal deviation, or its farthest face if only too large
+     * @return true if any seed was added
+     */
+    bool split_over_budget(int max_faces, float cos_limit) {
+        size_t num_charts = seeds_.size();
+        std::vector<float> worst_dev(num_charts, -1.0f);
+        std::vector<int> worst_dev_face(num_charts, -1);
+        std::vector<int> farthest(num_charts, -1);
+        for (int i = 0; i < count_; i++) {
+            int f = faces_[i];
+            int c = data_.label[f];
+            if (c < 0) continue;
+            float d = deviation(f, c);
+            if (d > worst_dev[c]) {
+                worst_dev[c] = d;
+                worst_dev_face[c] = f;
+            }
+            if (farthest[c] < 0 || data_.hops[f] > data_.hops[farthest[c]]) farthest[c] = f;
+        }
+        bool added = false;
+        for (size_t c = 0; c < num_charts; c++) {
+            int extra = -1;
+            if (cos_limit > -1.0f && 1.0f - worst_dev[c] < cos_limit) extra = worst_dev_face[c];
+            else if (max_faces > 0 && sizes_[c] > max_faces) extra = farthest[c];
+            if (extra < 0 || extra == seeds_[c]) continue;
+            seeds_.push_back(extra);
+            added = true;
+        }
+        return added;
+    }
+
+    const HalfEdgeMesh& he_;
+    const int* face_island_;
+    int island_;
+    const int* faces_;
+    int count_;
+    FaceData& data_;
+    float radius_ = 1.0f;
+    std::vector<int> seeds_;
+    std::vector<Vec3> proxies_;
+    std::vector<int> sizes_;
+};
+
+} // namespace
+
+int split_islands_into_charts(const Mesh* mesh,
+                              const HalfEdgeMesh& he,
+                              int max_faces,
+                              float max_angle,
+                              int num_threads,
+                              Arena& arena,
+                              bool arena_output,
+                              IslandInfo* islands,
+                              const TriangleGeometry* geometry) {
+    bool by_angle = max_angle > 0.0f && max_angle < 180.0f;
+    int F = mesh->num_triangles;
+    int num_islands = islands->num_islands;
+
+    // A closed island has no boundary for LSCM to open it along: with
+    // only its two pins fixed, v solves to 0 and every face collapses
+    std::vector<unsigned char> closed(num_islands, 1);
+    for (int f = 0; f < F; f++) {
+        int island = islands->face_island_ids[f];
+        if (island < 0 || !closed[island]) continue;
+        for (int s = 0; s < 3; s++) {
+            int t = he.twin[3 * f + s];
+            if (t < 0 || islands->face_island_ids[HalfEdgeMesh::face(t)] != island) closed[island] = 0;
+        }
+    }
+    bool any_closed = false;
+    for (int i = 0; i < num_islands; i++) {
+        int count = islands->island_face_offsets[i + 1] - islands->island_face_offsets[i];
+        if (count < 2) closed[i] = 0;
+        any_closed = any_closed || closed[i];
+    }
+    if (max_faces <= 0 && !by_angle && !any_closed) return 0;
+    float cos_limit = by_angle ? cosf(max_angle * (float)M_PI / 180.0f) : -2.0f;
+
+    FaceData data;
+    data.normal.resize(F);
+    data.area.resize(F);
+    data.label.assign(F, 0);
+    data.hops.assign(F, 0);
+    bool cached = geometry && (geometry->parts & GEOMETRY_NORMALS);
+    int threads = choose_thread_count(F, num_threads, 65536);
+    parallel_for_ranges(F, threads, [&](int, int begin, int end) {
+        for (int f = begin; f < end; f++) {
+            Vec3 n = cached ? Vec3{geometry->nx[f], geometry->ny[f], geometry->nz[f]} : face_normal(mesh, f);
+            data.area[f] = cached ? geometry->area[f] : 0.5f * length(n);
+            data.normal[f] = normalize(n);
+        }
+    });
+
+    // Islands over the face budget, or whose normals leave the cone
+    // around their mean, and closed ones; largest first so the big ones
+    // start early
+    std::vector<int> oversized;
+    for (int i = 0; i < num_islands; i++) {
+        const int* faces = &islands->island_faces[islands->island_face_offsets[i]];
+        int count = islands->island_face_offsets[i + 1] - islands->island_face_offsets[i];
+        if (count < 2) continue;
+        bool split = closed[i] || (max_faces > 0 && count > max_faces);
+        if (!split && by_angle) {
+            Vec3 sum = Vec3{0.0f, 0.0f, 0.0f};
+            for (int j = 0; j < count; j++) sum = add(sum, scale(data.normal[faces[j]], data.area[faces[j]]));
+            Vec3 mean = normalize(sum);
+            for (int j = 0; j < count && !split; j++) split = dot(data.normal[faces[j]], mean) < cos_limit;
+        }
+        if (split) oversized.push_back(i);
+    }
+    if (oversized.empty()) return 0;
+    std::sort(oversized.begin(), oversized.end(), [&](int a, int b) {
+        int ca = islands->island_face_offsets[a + 1] - islands->island_face_offsets[a];
+        int cb = islands->island_face_offsets[b + 1] - islands->island_face_offsets[b];
+        return ca != cb ? ca > cb : a < b;
+    });
+
+    std::vector<int> num_charts(num_islands, 1);
+    int workers = resolve_thread_count(num_threads);
+    parallel_for_dynamic((int)oversized.size(), workers, [&](int, int k) {
+        int island = oversized[k];
+        int begin = islands->island_face_offsets[island];
+        IslandSegmenter segmenter(he, islands->face_island_ids, island, &islands->island_faces[begin],
+                                  islands->island_face_offsets[island + 1] - begin, data);
+        num_charts[island] = segmenter.run(max_faces, closed[island] ? std::max(cos_limit, CLOSED_ISLAND_COS_LIMIT)
+                                                                      : cos_limit);
+    });
+
+    // Renumber (island, chart) pairs by lowest face, as extract_islands() does
+    std::vector<int> base(num_islands + 1, 0);
+    for (int i = 0; i < num_islands; i++) base[i + 1] = base[i] + num_charts[i];
+    std::vector<int> new_id(base[num_islands], -1);
+    std::vector<int> counts;
+    for (int f = 0; f < F; f++) {
+        int key = base[islands->face_island_ids[f]] + std::max(data.label[f], 0);
+        if (new_id[key] < 0) {
+            new_id[key] = (int)counts.size();
+            counts.push_back(0);
+        }
+        islands->face_island_ids[f] = new_id[key];
+        counts[new_id[key]]++;
+    }
+
+    int num_charts_total = (int)counts.size();
+    int* offsets = arena_output
+                       ? arena.alloc_array<int>(num_charts_total + 1)
+                       : (int*)realloc(islands->island_face_offsets, (num_charts_total + 1) * sizeof(int));
+    offsets[0] = 0;
+    for (int c = 0; c < num_charts_total; c++) offsets[c + 1] = offsets[c] + counts[c];
+    for (int c = 0; c < num_charts_total; c++) counts[c] = offsets[c];
+    for (int f = 0; f < F; f++) islands->island_faces[counts[islands->face_island_ids[f]]++] = f;
+    islands->island_face_offsets = offsets;
+    islands->num_islands = num_charts_total;
+
+    LOG_INFO("Split %d oversized islands: %d islands -> %d charts",
+             (int)oversized.size(), num_islands, num_charts_total);
+    return (int)oversized.size();
+}
+
+} // namespace uvunwrap
@@ -0,0 +1,58 @@
+/**
+ * @file chart_split.h
+ * @brief Internal chart segmentation of oversized islands
+ *
+ * Not part of the public API; driven by UnwrapParams.max_chart_faces and
+ * max_chart_angle between island extraction and LSCM, and always run on
+ * closed islands, which LSCM cannot open.
+ */
+
+#ifndef UVUNWRAP_CHART_SPLIT_H
+#define UVUNWRAP_CHART_SPLIT_H
+
+#include "unwrap.h"
+#include "half_edge.h"
+#include "arena.h"
+
+namespace uvunwrap {
+
+/**
+ * @brief Split islands over the face or normal-cone budget, and closed
+ *        islands, into charts
+ *
+ * Each oversized island is segmented by Lloyd clustering on face normals
+ * (D-Charts style): charts grow from seeds across the island's half-edge
+ * twins, cheapest face first by normal deviation from the chart's proxy
+ * normal plus a hop-distance compactness term; proxies and seeds are then
+ * re-centred and the growth repeated. A chart still over budget gets an
+ * extra seed and the clustering reruns, for a bounded number of rounds.
+ * Charts are connected by construction. An island without boundary
+ * edges is split whatever the budgets, into charts within 90° of their
+ * mean normal. Islands are split in parallel.
+ *
+ * On return islands is renumbered with the same conventions as
+ * extract_islands() (by lowest face, faces ascending). face_island_ids
+ * and island_faces are rewritten in place; island_face_offsets is
+ * replaced, from the arena when arena_output is set and with realloc
+ * otherwise.
+ *
+ * @param max_faces Face budget per chart (<= 0: no limit)
+ * @param max_angle Largest angle in degrees between a face normal and its
+ *        chart's mean normal (<= 0: no limit)
+ * @param num_threads Worker threads (0 = one per core)
+ * @param geometry Optional cache whose face normals and areas are used
+ * @return Number of islands that were split
+ */
+int split_islands_into_charts(const Mesh* mesh,
+                              const HalfEdgeMesh& he,
+                              int max_faces,
+                              float max_angle,
+                              int num_threads,
+                              Arena& arena,
+                              bool arena_output,
+                              IslandInfo* islands,
+                              const TriangleGeometry* geometry = NULL);
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_CHART_SPLIT_H */
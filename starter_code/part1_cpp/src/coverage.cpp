@@ -0,0 +1,318 @@
+/**
+ * @file coverage.cpp
+ * @brief Rasterised UV coverage, overlap and per-island texel density
+ *
+ * The [0,1]² square is split into 64×64-texel tiles. A tile row is one
+ * uint64_t, so a tile is two 64-word bitplanes: `occupied` (covered by at
+ * least one face) and `overlap` (covered twice or more). Faces are first
+ * binned to the tiles their bounding box touches, then each tile is
+ * rasterised independently (faces are snapped again there rather than
+ * stored, keeping memory at one int per tile reference) — tiles are the unit of parallel work and no
+ * two threads ever write the same word.
+ *
+ * Rasterisation samples texel centres against the three edge functions
+ * in 24.8 fixed point, so the result is exact and independent of the
+ * order faces are drawn. A top-left style tie rule assigns texel centres
+ * on a shared edge to exactly one of the two faces, which keeps adjacent
+ * faces of a closed chart from counting as overlap.
+ *
+ * With the CUDA backend (UVUNWRAP_WITH_CUDA) the binning stays here and
+ * the device rasterises the tiles, one thread per tile row; the face and
+ * row math is shared through coverage_raster.h.
+ */
+
+#include "unwrap.h"
+#include "coverage_raster.h"
+#include "gpu_backend.h"
+#include "parallel.h"
+#include "logging.h"
+#include <limits.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+using uvunwrap::EdgeSetup;
+using uvunwrap::RasterFace;
+using uvunwrap::TILE_BITS;
+using uvunwrap::TILE_SIZE;
+
+namespace {
+
+const int DEFAULT_RESOLUTION = 1024;
+const int MAX_RESOLUTION = 65536;
+const int MIN_FACES_PER_THREAD = 16384;
+
+// COMPUTE_BACKEND_AUTO sends a call to the GPU from this many texels or
+// faces on; below it the upload costs more than the CPU raster
+const long long GPU_MIN_TEXELS = 4096LL * 4096;
+const int GPU_MIN_FACES = 1 << 18;
+
+inline int popcount64(uint64_t v) {
+    return __builtin_popcountll(v);
+}
+
+/** Rasterise the binned tiles in parallel; each worker keeps its own totals and island counts */
+void rasterise_on_cpu(const Mesh* mesh, const int* face_island_ids, int num_islands, int resolution, int tiles_x,
+                      int num_threads, const std::vector<size_t>& tile_offsets, const std::vector<int>& tile_faces,
+                      long long* covered_out, long long* overlapped_out, long long* island_texels_out) {
+    int F = mesh->num_triangles;
+    int num_tiles = tiles_x * tiles_x;
+    int raster_threads = uvunwrap::choose_thread_count(num_tiles, num_threads, 1);
+    if (num_threads <= 0 && F < MIN_FACES_PER_THREAD) raster_threads = 1;
+    std::vector<long long> covered(raster_threads, 0), overlapped(raster_threads, 0);
+    std::vector<std::vector<long long> > island_texels(raster_threads,
+                                                       std::vector<long long>(num_islands, 0));
+
+    uvunwrap::parallel_for_dynamic(num_tiles, raster_threads, [&](int t, int tile) {
+        size_t begin = tile_offsets[tile], end = tile_offsets[tile + 1];
+        if (begin == end) return;
+
+        uint64_t occupied[TILE_SIZE], overlap[TILE_SIZE];
+        memset(occupied, 0, sizeof(occupied));
+        memset(overlap, 0, sizeof(overlap));
+        long long* texels = island_texels[t].data();
+
+        int tile_x0 = (tile % tiles_x) * TILE_SIZE;
+        int tile_y0 = (tile / tiles_x) * TILE_SIZE;
+        int tile_x1 = std::min(tile_x0 + TILE_SIZE, resolution) - 1;
+        int tile_y1 = std::min(tile_y0 + TILE_SIZE, resolution) - 1;
+
+        for (size_t i = begin; i < end; i++) {
+            int f = tile_faces[i];
+            RasterFace face;
+            EdgeSetup edges;
+            if (!uvunwrap::snap_face(mesh, f, resolution, face)) continue;
+            uvunwrap::setup_edges(face, edges);
+            int island = face_island_ids ? face_island_ids[f] : 0;
+            if (island < 0 || island >= num_islands) island = -1;
+
+            long long count = 0;
+            int y0 = std::max(face.y0, tile_y0), y1 = std::min(face.y1, tile_y1);
+            for (int y = y0; y <= y1; y++) {
+                long long lo, hi;
+                uvunwrap::row_span(edges, y, &lo, &hi);
+                lo = std::max(lo, (long long)tile_x0);
+                hi = std::min(hi, (long long)tile_x1);
+                if (lo > hi) continue;
+
+                int a = (int)lo - tile_x0, b = (int)hi - tile_x0;
+                uint64_t mask = uvunwrap::span_mask(a, b);
+                int row = y - tile_y0;
+                overlap[row] |= occupied[row] & mask;
+                occupied[row] |= mask;
+                count += b - a + 1;
+            }
+            if (island >= 0) texels[island] += count;
+        }
+
+        long long c = 0, o = 0;
+        for (int row = 0; row < TILE_SIZE; row++) {
+            c += popcount64(occupied[row]);
+            o += popcount64(overlap[row]);
+        }
+        covered[t] += c;
+        overlapped[t] += o;
+    });
+
+    for (int t = 0; t < raster_threads; t++) {
+        *covered_out += covered[t];
+        *overlapped_out += overlapped[t];
+        for (int i = 0; i < num_islands; i++) island_texels_out[i] += island_texels[t][i];
+    }
+}
+
+/**
+ * @brief Rasterise the binned tiles with the CUDA backend
+ *
+ * The device walks each tile's faces in the same order as the CPU, so
+ * its bitplanes, and every count, are exact. Returns false (and leaves
+ * the outputs alone) when the device fails.
+ */
+bool rasterise_on_gpu(const Mesh* mesh, const int* face_island_ids, int num_islands, int resolution, int tiles_x,
+                      int num_threads, const std::vector<size_t>& tile_offsets, const std::vector<int>& tile_faces,
+                      long long* covered, long long* overlapped, long long* island_texels) {
+    int F = mesh->num_triangles;
+    std::vector<EdgeSetup> edges(F);
+    std::vector<int> rows((size_t)F * 2, 0);
+    std::vector<int> islands(F, -1);
+    int threads = uvunwrap::choose_thread_count(F, num_threads, MIN_FACES_PER_THREAD);
+    uvunwrap::parallel_for_ranges(F, threads, [&](int, int begin, int end) {
+        RasterFace face;
+        for (int f = begin; f < end; f++) {
+            if (!uvunwrap::snap_face(mesh, f, resolution, face)) continue;
+            uvunwrap::setup_edges(face, edges[f]);
+            rows[(size_t)f * 2 + 0] = face.y0;
+            rows[(size_t)f * 2 + 1] = face.y1;
+            int island = face_island_ids ? face_island_ids[f] : 0;
+            islands[f] = island >= 0 && island < num_islands ? island : -1;
+        }
+    });
+
+    uvunwrap::GpuRasterJob job;
+    job.resolution = resolution;
+    job.tiles_x = tiles_x;
+    job.num_tiles = tiles_x * tiles_x;
+    job.num_faces = F;
+    job.num_islands = num_islands;
+    job.tile_offsets = tile_offsets.data();
+    job.tile_faces = tile_faces.data();
+    job.num_refs = tile_offsets.back();
+    job.edges = edges.data();
+    job.face_rows = rows.data();
+    job.face_islands = islands.data();
+    return uvunwrap::gpu_rasterise(job, covered, overlapped, island_texels);
+}
+
+} // namespace
+
+int compute_backend_available(ComputeBackend backend) {
+    switch (backend) {
+        case COMPUTE_BACKEND_AUTO:
+        case COMPUTE_BACKEND_CPU:
+            return 1;
+        case COMPUTE_BACKEND_CUDA:
+            return uvunwrap::gpu_available() ? 1 : 0;
+        default:
+            return 0;
+    }
+}
+
+UvCoverage* compute_uv_coverage_ex(const Mesh* mesh,
+                                   const int* face_island_ids,
+                                   int num_islands,
+                                   int resolution,
+                                   int num_threads,
+                                   int backend) {
+    if (!mesh || !mesh->uvs || !mesh->triangles) return NULL;
+    if (resolution <= 0) resolution = DEFAULT_RESOLUTION;
+    if (resolution > MAX_RESOLUTION) {
+        LOG_ERROR("compute_uv_coverage: resolution %d exceeds %d", resolution, MAX_RESOLUTION);
+        return NULL;
+    }
+    if (!face_island_ids || num_islands < 1) num_islands = 1;
+
+    int F = mesh->num_triangles;
+    int tiles_x = (resolution + TILE_SIZE - 1) / TILE_SIZE;
+    int num_tiles = tiles_x * tiles_x;
+
+    // Count tile references per thread
+    int bin_threads = uvunwrap::choose_thread_count(F, num_threads, MIN_FACES_PER_THREAD);
+    std::vector<std::vector<int> > thread_counts(bin_threads, std::vector<int>(num_tiles, 0));
+    uvunwrap::parallel_for_ranges(F, bin_threads, [&](int t, int begin, int end) {
+        std::vector<int>& counts = thread_counts[t];
+        RasterFace face;
+        for (int f = begin; f < end; f++) {
+            if (!uvunwrap::snap_face(mesh, f, resolution, face)) continue;
+            for (int ty = face.y0 >> TILE_BITS; ty <= face.y1 >> TILE_BITS; ty++) {
+                for (int tx = face.x0 >> TILE_BITS; tx <= face.x1 >> TILE_BITS; tx++) {
+                    counts[ty * tiles_x + tx]++;
+                }
+            }
+        }
+    });
+
+    // CSR tile → faces. Offsets run tile-major then thread, so every tile
+    // lists its faces in ascending order
+    std::vector<size_t> tile_offsets(num_tiles + 1, 0);
+    size_t total_refs = 0;
+    for (int tile = 0; tile < num_tiles; tile++) {
+        tile_offsets[tile] = total_refs;
+        for (int t = 0; t < bin_threads; t++) {
+            int c = thread_counts[t][tile];
+            thread_counts[t][tile] = (int)(total_refs - tile_offsets[tile]);
+            total_refs += c;
+        }
+    }
+    tile_offsets[num_tiles] = total_refs;
+
+    std::vector<int> tile_faces(total_refs > 0 ? total_refs : 1);
+    uvunwrap::parallel_for_ranges(F, bin_threads, [&](int t, int begin, int end) {
+        std::vector<int>& cursor = thread_counts[t];
+        RasterFace face;
+        for (int f = begin; f < end; f++) {
+            if (!uvunwrap::snap_face(mesh, f, resolution, face)) continue;
+            for (int ty = face.y0 >> TILE_BITS; ty <= face.y1 >> TILE_BITS; ty++) {
+                for (int tx = face.x0 >> TILE_BITS; tx <= face.x1 >> TILE_BITS; tx++) {
+                    int tile = ty * tiles_x + tx;
+                    tile_faces[tile_offsets[tile] + cursor[tile]++] = f;
+                }
+            }
+        }
+    });
+
+    UvCoverage* out = (UvCoverage*)calloc(1, sizeof(UvCoverage));
+    out->resolution = resolution;
+    out->num_islands = num_islands;
+    out->island_texels = (long long*)calloc(num_islands, sizeof(long long));
+    out->island_texel_density = (float*)calloc(num_islands, sizeof(float));
+    out->backend = COMPUTE_BACKEND_CPU;
+
+    bool big = (long long)resolution * resolution >= GPU_MIN_TEXELS || F >= GPU_MIN_FACES;
+    bool try_gpu = backend == COMPUTE_BACKEND_CUDA || (backend == COMPUTE_BACKEND_AUTO && big);
+    if (try_gpu && uvunwrap::gpu_available()) {
+        if (rasterise_on_gpu(mesh, face_island_ids, num_islands, resolution, tiles_x, num_threads, tile_offsets,
+                             tile_faces, &out->covered_texels, &out->overlap_texels, out->island_texels)) {
+            out->backend = COMPUTE_BACKEND_CUDA;
+        } else {
+            LOG_WARNING("compute_uv_coverage: GPU rasterisation failed, using the CPU");
+        }
+    } else if (backend == COMPUTE_BACKEND_CUDA) {
+        LOG_DEBUG("compute_uv_coverage: no CUDA device, using the CPU");
+    }
+
+    if (out->backend == COMPUTE_BACKEND_CPU) {
+        rasterise_on_cpu(mesh, face_island_ids, num_islands, resolution, tiles_x, num_threads, tile_offsets,
+                         tile_faces, &out->covered_texels, &out->overlap_texels, out->island_texels);
+    }
+
+    double total_texels = (double)resolution * resolution;
+    out->coverage = (float)(out->covered_texels / total_texels);
+    out->overlap = (float)(out->overlap_texels / total_texels);
+
+    // Texel density: texels per unit of 3D length, sqrt(texels / area)
+    std::vector<double> island_area(num_islands, 0.0);
+    if (mesh->vertices) {
+        for (int f = 0; f < F; f++) {
+            int island = face_island_ids ? face_island_ids[f] : 0;
+            if (island < 0 || island >= num_islands) continue;
+            const int* tri = &mesh->triangles[(size_t)f * 3];
+            const float* p0 = &mesh->vertices[(size_t)tri[0] * 3];
+            const float* p1 = &mesh->vertices[(size_t)tri[1] * 3];
+            const float* p2 = &mesh->vertices[(size_t)tri[2] * 3];
+            double e1[3] = {(double)p1[0] - p0[0], (double)p1[1] - p0[1], (double)p1[2] - p0[2]};
+            double e2[3] = {(double)p2[0] - p0[0], (double)p2[1] - p0[1], (double)p2[2] - p0[2]};
+            double cx = e1[1] * e2[2] - e1[2] * e2[1];
+            double cy = e1[2] * e2[0] - e1[0] * e2[2];
+            double cz = e1[0] * e2[1] - e1[1] * e2[0];
+            island_area[island] += 0.5 * sqrt(cx * cx + cy * cy + cz * cz);
+        }
+    }
+    for (int i = 0; i < num_islands; i++) {
+        out->island_texel_density[i] =
+            island_area[i] > 0.0 ? (float)sqrt(out->island_texels[i] / island_area[i]) : 0.0f;
+    }
+
+    LOG_DEBUG("UV coverage at %d²: %.2f%% covered, %lld overlapping texels (%s)",
+              resolution, out->coverage * 100, out->overlap_texels,
+              out->backend == COMPUTE_BACKEND_CUDA ? "CUDA" : "CPU");
+    return out;
+}
+
+UvCoverage* compute_uv_coverage(const Mesh* mesh,
+                                const int* face_island_ids,
+                                int num_islands,
+                                int resolution,
+                                int num_threads) {
+    return compute_uv_coverage_ex(mesh, face_island_ids, num_islands, resolution, num_threads,
+                                  COMPUTE_BACKEND_AUTO);
+}
+
+void free_uv_coverage(UvCoverage* coverage) {
+    if (!coverage) return;
+    free(coverage->island_texels);
+    free(coverage->island_texel_density);
+    free(coverage);
+}
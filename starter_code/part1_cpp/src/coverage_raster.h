@@ -0,0 +1,161 @@
+/**
+ * @file coverage_raster.h
+ * @brief Internal fixed-point triangle setup and row spans of the coverage rasteriser
+ *
+ * Not part of the public API. Shared by coverage.cpp and the CUDA
+ * backend, so both rasterise every face to exactly the same texels.
+ */
+
+#ifndef UVUNWRAP_COVERAGE_RASTER_H
+#define UVUNWRAP_COVERAGE_RASTER_H
+
+#include "gpu_backend.h"
+#include "mesh.h"
+#include <limits.h>
+#include <math.h>
+
+namespace uvunwrap {
+
+const int TILE_BITS = 6;
+const int TILE_SIZE = 1 << TILE_BITS;          // texels per tile side (one uint64_t row)
+const int SUBPIXEL_BITS = 8;
+const long long SUBPIXEL = 1LL << SUBPIXEL_BITS;
+
+// UVs beyond this are treated as garbage: keeps the fixed-point edge
+// functions inside int64 at the largest resolution
+const float MAX_UV_EXTENT = 16.0f;
+
+/** Face snapped to fixed point, counter-clockwise */
+struct RasterFace {
+    long long x[3], y[3];
+    int x0, y0, x1, y1;        // inclusive texel bounds clipped to the grid
+};
+
+UV_HOST_DEVICE inline long long floor_div(long long a, long long b) {
+    // b > 0
+    return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+/**
+ * floor(a / b) for b > 0 via a double divide, corrected to the exact
+ * integer result (64-bit idiv in the per-row span loop is the hot spot)
+ */
+UV_HOST_DEVICE inline long long floor_div_fast(long long a, long long b) {
+    long long q = (long long)((double)a / (double)b);
+    while (q * b > a) q--;
+    while ((q + 1) * b <= a) q++;
+    return q;
+}
+
+/** llround() without the libm call */
+inline long long round_fixed(double v) {
+    return v >= 0.0 ? (long long)(v + 0.5) : -(long long)(0.5 - v);
+}
+
+inline bool snap_face(const Mesh* mesh, int f, int resolution, RasterFace& out) {
+    const int* tri = &mesh->triangles[(size_t)f * 3];
+    double scale = (double)resolution * SUBPIXEL;
+    for (int k = 0; k < 3; k++) {
+        const float* uv = &mesh->uvs[(size_t)tri[k] * 2];
+        if (!(fabsf(uv[0]) <= MAX_UV_EXTENT && fabsf(uv[1]) <= MAX_UV_EXTENT)) return false;
+        out.x[k] = round_fixed(uv[0] * scale);
+        out.y[k] = round_fixed(uv[1] * scale);
+    }
+
+    long long area = (out.x[1] - out.x[0]) * (out.y[2] - out.y[0]) -
+                     (out.y[1] - out.y[0]) * (out.x[2] - out.x[0]);
+    if (area == 0) return false;
+    if (area < 0) {
+        long long t = out.x[1];
+        out.x[1] = out.x[2];
+        out.x[2] = t;
+        t = out.y[1];
+        out.y[1] = out.y[2];
+        out.y[2] = t;
+    }
+
+    // Texel x is sampled at (x + 0.5) / resolution
+    long long min_x = out.x[0], max_x = out.x[0], min_y = out.y[0], max_y = out.y[0];
+    for (int k = 1; k < 3; k++) {
+        min_x = out.x[k] < min_x ? out.x[k] : min_x;
+        max_x = out.x[k] > max_x ? out.x[k] : max_x;
+        min_y = out.y[k] < min_y ? out.y[k] : min_y;
+        max_y = out.y[k] > max_y ? out.y[k] : max_y;
+    }
+    long long tx0 = floor_div(min_x - SUBPIXEL / 2, SUBPIXEL);
+    long long tx1 = floor_div(max_x - SUBPIXEL / 2, SUBPIXEL);
+    long long ty0 = floor_div(min_y - SUBPIXEL / 2, SUBPIXEL);
+    long long ty1 = floor_div(max_y - SUBPIXEL / 2, SUBPIXEL);
+    tx0 = tx0 > 0 ? tx0 : 0;
+    ty0 = ty0 > 0 ? ty0 : 0;
+    tx1 = tx1 + 1 < resolution - 1 ? tx1 + 1 : resolution - 1;
+    ty1 = ty1 + 1 < resolution - 1 ? ty1 + 1 : resolution - 1;
+    if (tx0 > tx1 || ty0 > ty1) return false;
+
+    out.x0 = (int)tx0;
+    out.y0 = (int)ty0;
+    out.x1 = (int)tx1;
+    out.y1 = (int)ty1;
+    return true;
+}
+
+/**
+ * @brief Edge functions of a face, set up once per rasterised face
+ *
+ * Edge a→b keeps a texel centre P when cross(b - a, P - a) >= 0, or > 0
+ * for "exclusive" edges. An edge is inclusive iff dy > 0 || (dy == 0 &&
+ * dx < 0); its reverse is then exclusive, so a centre on an edge shared
+ * by two faces lands in exactly one of them.
+ *
+ * With px = x * S + S / 2 the test is dy * S * x <= k(y), where
+ * k(y) = k0 + y * dk; rows bound x from the right when dy > 0 and from
+ * the left when dy < 0.
+ */
+struct EdgeSetup {
+    long long k0[3], dk[3], div[3];
+    int sign[3];               // sign of dy
+};
+
+UV_HOST_DEVICE inline void setup_edges(const RasterFace& face, EdgeSetup& out) {
+    for (int e = 0; e < 3; e++) {
+        long long ax = face.x[e], ay = face.y[e];
+        long long bx = face.x[(e + 1) % 3], by = face.y[(e + 1) % 3];
+        long long dx = bx - ax, dy = by - ay;
+        long long bias = (dy > 0 || (dy == 0 && dx < 0)) ? 0 : 1;
+        // k(y) = dx * (y * S + S / 2 - ay) + dy * ax - bias - dy * S / 2
+        out.k0[e] = dx * (SUBPIXEL / 2 - ay) + dy * ax - bias - dy * (SUBPIXEL / 2);
+        out.dk[e] = dx * SUBPIXEL;
+        out.div[e] = (dy < 0 ? -dy : dy) * SUBPIXEL;
+        out.sign[e] = dy > 0 ? 1 : (dy < 0 ? -1 : 0);
+    }
+}
+
+/** Texel span [*lo, *hi] of row y inside a face (empty if lo > hi) */
+UV_HOST_DEVICE inline void row_span(const EdgeSetup& edges, int y, long long* lo, long long* hi) {
+    long long left = LLONG_MIN / 4, right = LLONG_MAX / 4;
+    for (int e = 0; e < 3; e++) {
+        long long k = edges.k0[e] + (long long)y * edges.dk[e];
+        if (edges.sign[e] > 0) {
+            long long r = floor_div_fast(k, edges.div[e]);
+            right = r < right ? r : right;
+        } else if (edges.sign[e] < 0) {
+            long long l = -floor_div_fast(k, edges.div[e]);
+            left = l > left ? l : left;
+        } else if (k < 0) {
+            *lo = 1;
+            *hi = 0;
+            return;
+        }
+    }
+    *lo = left;
+    *hi = right;
+}
+
+/** Bits a..b (0 <= a <= b < TILE_SIZE) of a tile row */
+UV_HOST_DEVICE inline unsigned long long span_mask(int a, int b) {
+    return (b == TILE_SIZE - 1 ? ~0ULL : ((1ULL << (b + 1)) - 1)) & ~((1ULL << a) - 1);
+}
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_COVERAGE_RASTER_H */
@@ -0,0 +1,90 @@
+/**
+ * @file curvature.cpp
+ * @brief Batched corner angle and angular defect kernels
+ *
+ * Algorithm:
+ * 1. Gather a block of triangles into SoA edge-vector arrays
+ * 2. Compute all three corner angles of the block with branch-free math
+ * 3. Scatter-add the angles into the defects serially in face order, so
+ *    each vertex sums its angles in the same order for any thread count
+ */
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include "curvature.h"
+#include "parallel.h"
+#include "triangle_geometry.h"
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#define ANGLE_BLOCK 64
+#define MIN_TRIANGLES_PER_THREAD 16384
+
+/**
+ * @brief Compute corner angles for triangles [begin, end) into out (3 per tri)
+ */
+static void corner_angles_range(const Mesh* mesh, int begin, int end, float* out) {
+    float e01x[ANGLE_BLOCK], e01y[ANGLE_BLOCK], e01z[ANGLE_BLOCK];
+    float e12x[ANGLE_BLOCK], e12y[ANGLE_BLOCK], e12z[ANGLE_BLOCK];
+    float e20x[ANGLE_BLOCK], e20y[ANGLE_BLOCK], e20z[ANGLE_BLOCK];
+
+    const float* P = mesh->vertices;
+    const int* T = mesh->triangles;
+
+    for (int block = begin; block < end; block += ANGLE_BLOCK) {
+        int n = end - block < ANGLE_BLOCK ? end - block : ANGLE_BLOCK;
+
+        // Gather: edge vectors in SoA form
+        for (int i = 0; i < n; i++) {
+            const int* tri = &T[(block + i) * 3];
+            const float* p0 = &P[tri[0] * 3];
+            const float* p1 = &P[tri[1] * 3];
+            const float* p2 = &P[tri[2] * 3];
+            e01x[i] = p1[0] - p0[0]; e01y[i] = p1[1] - p0[1]; e01z[i] = p1[2] - p0[2];
+            e12x[i] = p2[0] - p1[0]; e12y[i] = p2[1] - p1[1]; e12z[i] = p2[2] - p1[2];
+            e20x[i] = p0[0] - p2[0]; e20y[i] = p0[1] - p2[1]; e20z[i] = p0[2] - p2[2];
+        }
+
+        // Angle at corner k is between (p[k+1]-p[k]) and (p[k-1]-p[k])
+        float* o = &out[(block - begin) * 3];
+        for (int i = 0; i < n; i++) {
+            o[i * 3 + 0] = uvunwrap::corner_angle(e01x[i], e01y[i], e01z[i], -e20x[i], -e20y[i], -e20z[i]);
+            o[i * 3 + 1] = uvunwrap::corner_angle(e12x[i], e12y[i], e12z[i], -e01x[i], -e01y[i], -e01z[i]);
+            o[i * 3 + 2] = uvunwrap::corner_angle(e20x[i], e20y[i], e20z[i], -e12x[i], -e12y[i], -e12z[i]);
+        }
+    }
+}
+
+void compute_corner_angles(const Mesh* mesh, float* angles_out, int num_threads) {
+    if (!mesh || !angles_out || mesh->num_triangles <= 0) return;
+
+    int F = mesh->num_triangles;
+    int threads = uvunwrap::choose_thread_count(F, num_threads, MIN_TRIANGLES_PER_THREAD);
+
+    uvunwrap::parallel_for_ranges(F, threads, [&](int, int begin, int end) {
+        corner_angles_range(mesh, begin, end, &angles_out[(size_t)begin * 3]);
+    });
+}
+
+int compute_angular_defects(const Mesh* mesh, float* defects_out, int num_threads) {
+    if (!mesh || !defects_out) return -1;
+
+    int V = mesh->num_vertices;
+    int F = mesh->num_triangles;
+    memset(defects_out, 0, (size_t)V * sizeof(float));
+
+    // The angles are the work; the scatter is one add per corner
+    std::vector<float> angles((size_t)F * 3);
+    compute_corner_angles(mesh, angles.data(), num_threads);
+    for (size_t i = 0; i < angles.size(); i++) {
+        defects_out[mesh->triangles[i]] += angles[i];
+    }
+
+    const float two_pi = (float)(2.0 * M_PI);
+    for (int v = 0; v < V; v++) {
+        defects_out[v] = two_pi - defects_out[v];
+    }
+
+    return 0;
+}
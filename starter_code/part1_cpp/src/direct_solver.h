@@ -0,0 +1,189 @@
+/**
+ * @file direct_solver.h
+ * @brief Internal sparse direct solver backends shared by LSCM and ABF++
+ *
+ * Not part of the public API. Wraps the Eigen, CHOLMOD and PARDISO
+ * factorisations behind one interface that keeps its symbolic analysis
+ * across numeric factorisations of the same pattern.
+ */
+
+#ifndef UVUNWRAP_DIRECT_SOLVER_H
+#define UVUNWRAP_DIRECT_SOLVER_H
+
+#include "lscm.h"
+#include "timer.h"
+#include "trace.h"
+#include "logging.h"
+#include <memory>
+
+#include <Eigen/Sparse>
+#include <Eigen/SparseLU>
+#include <Eigen/SparseCholesky>
+#ifdef UVUNWRAP_HAVE_CHOLMOD
+#include <Eigen/CholmodSupport>
+#endif
+#ifdef UVUNWRAP_HAVE_PARDISO
+#include <Eigen/PardisoSupport>
+#endif
+#ifdef UVUNWRAP_HAVE_METIS
+#include <Eigen/MetisSupport>
+#endif
+
+namespace uvunwrap {
+
+// Fill-in of the factor, for the report
+template <typename Solver>
+inline long long factor_nonzeros(const Solver& solver) {
+    return (long long)solver.matrixL().nestedExpression().nonZeros();
+}
+
+template <typename Scalar, typename Ordering>
+inline long long factor_nonzeros(const Eigen::SparseLU<Eigen::SparseMatrix<Scalar>, Ordering>& solver) {
+    return (long long)solver.nnzL() + (long long)solver.nnzU();
+}
+
+#ifdef UVUNWRAP_HAVE_PARDISO
+inline long long factor_nonzeros(const Eigen::PardisoLDLT<Eigen::SparseMatrix<double> >&) {
+    return 0;
+}
+#endif
+
+// Bytes of a compressed matrix's values, indices and outer offsets
+template <typename Scalar>
+inline long long sparse_bytes(const Eigen::SparseMatrix<Scalar>& M) {
+    return (long long)M.nonZeros() * (long long)(sizeof(Scalar) + sizeof(int)) +
+           (long long)(M.outerSize() + 1) * (long long)sizeof(int);
+}
+
+// The same for a factor of `nonzeros` entries (supernodal LU stores about as much)
+inline long long factor_bytes(long long nonzeros, size_t scalar_size) {
+    return nonzeros * (long long)(scalar_size + sizeof(int));
+}
+
+/**
+ * @brief Direct sparse solver in Scalar that keeps its symbolic analysis
+ *
+ * The ordering and symbolic factorisation are computed on the first
+ * factorize(); later calls with the same pattern only run the numeric
+ * factorisation. solve() may be called repeatedly on one factorisation
+ * (iterative refinement does).
+ */
+template <typename Scalar>
+class DirectSolver {
+public:
+    typedef Eigen::SparseMatrix<Scalar> Matrix;
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1> Vector;
+
+    virtual ~DirectSolver() {}
+    virtual bool factorize(const Matrix& A, long long* nonzeros_out, long long* factor_ns_out) = 0;
+    virtual bool solve(const Vector& b, Vector& x) = 0;
+};
+
+template <typename Solver>
+class EigenDirectSolver : public DirectSolver<typename Solver::Scalar> {
+public:
+    typedef DirectSolver<typename Solver::Scalar> Base;
+
+    EigenDirectSolver() : analyzed_(false) {}
+
+    bool factorize(const typename Base::Matrix& A, long long* nonzeros_out,
+                   long long* factor_ns_out) override {
+        UV_TRACE_ZONE("factorize");
+        long long start = now_ns();
+        if (!analyzed_) {
+            solver_.analyzePattern(A);
+            analyzed_ = true;
+        }
+        solver_.factorize(A);
+        *factor_ns_out = now_ns() - start;
+        if (solver_.info() != Eigen::Success) {
+            LOG_ERROR("LSCM: Decomposition failed");
+            return false;
+        }
+        *nonzeros_out = factor_nonzeros(solver_);
+        return true;
+    }
+
+    bool solve(const typename Base::Vector& b, typename Base::Vector& x) override {
+        UV_TRACE_ZONE("triangular solve");
+        x = solver_.solve(b);
+        if (solver_.info() != Eigen::Success) {
+            LOG_ERROR("LSCM: Solve failed");
+            return false;
+        }
+        return true;
+    }
+
+private:
+    Solver solver_;
+    bool analyzed_;
+};
+
+template <typename Scalar, template <typename> class Ordering>
+std::unique_ptr<DirectSolver<Scalar> > create_ordered_direct_solver(LscmSolver solver) {
+    typedef Eigen::SparseMatrix<Scalar> SpMat;
+    typedef Ordering<int> Order;
+    typedef std::unique_ptr<DirectSolver<Scalar> > Ptr;
+
+    switch (solver) {
+        case LSCM_SOLVER_LLT:
+            return Ptr(new EigenDirectSolver<Eigen::SimplicialLLT<SpMat, Eigen::Lower, Order> >());
+        case LSCM_SOLVER_LU:
+            return Ptr(new EigenDirectSolver<Eigen::SparseLU<SpMat, Order> >());
+        case LSCM_SOLVER_LDLT:
+        default:
+            return Ptr(new EigenDirectSolver<Eigen::SimplicialLDLT<SpMat, Eigen::Lower, Order> >());
+    }
+}
+
+/**
+ * @brief Create an Eigen-native direct solver (LLT, LU or LDLT) in Scalar
+ *
+ * ordering must be compiled in (lscm_ordering_available()); AUTO keeps
+ * Eigen's defaults, AMD for the Cholesky solvers and COLAMD for LU.
+ */
+template <typename Scalar>
+std::unique_ptr<DirectSolver<Scalar> > create_eigen_direct_solver(LscmSolver solver,
+                                                                  LscmOrdering ordering = LSCM_ORDERING_AUTO) {
+    switch (ordering) {
+        case LSCM_ORDERING_AMD:
+            return create_ordered_direct_solver<Scalar, Eigen::AMDOrdering>(solver);
+        case LSCM_ORDERING_COLAMD:
+            return create_ordered_direct_solver<Scalar, Eigen::COLAMDOrdering>(solver);
+#ifdef UVUNWRAP_HAVE_METIS
+        case LSCM_ORDERING_METIS:
+            return create_ordered_direct_solver<Scalar, Eigen::MetisOrdering>(solver);
+#endif
+        case LSCM_ORDERING_NATURAL:
+            return create_ordered_direct_solver<Scalar, Eigen::NaturalOrdering>(solver);
+        default:
+            return solver == LSCM_SOLVER_LU ? create_ordered_direct_solver<Scalar, Eigen::COLAMDOrdering>(solver)
+                                            : create_ordered_direct_solver<Scalar, Eigen::AMDOrdering>(solver);
+    }
+}
+
+/**
+ * @brief Create the double-precision direct solver for a (resolved,
+ *        non-CG) backend; CHOLMOD and PARDISO ignore ordering
+ */
+inline std::unique_ptr<DirectSolver<double> > create_direct_solver(LscmSolver solver,
+                                                                   LscmOrdering ordering = LSCM_ORDERING_AUTO) {
+    switch (solver) {
+#ifdef UVUNWRAP_HAVE_CHOLMOD
+        case LSCM_SOLVER_CHOLMOD:
+            return std::unique_ptr<DirectSolver<double> >(
+                new EigenDirectSolver<Eigen::CholmodSupernodalLLT<Eigen::SparseMatrix<double> > >());
+#endif
+#ifdef UVUNWRAP_HAVE_PARDISO
+        case LSCM_SOLVER_PARDISO:
+            return std::unique_ptr<DirectSolver<double> >(
+                new EigenDirectSolver<Eigen::PardisoLDLT<Eigen::SparseMatrix<double> > >());
+#endif
+        default:
+            return create_eigen_direct_solver<double>(solver, ordering);
+    }
+}
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_DIRECT_SOLVER_H */
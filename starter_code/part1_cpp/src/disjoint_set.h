@@ -0,0 +1,52 @@
+/**
+ * @file disjoint_set.h
+ * @brief Internal union-find used by seam detection and island extraction
+ */
+
+#ifndef UVUNWRAP_DISJOINT_SET_H
+#define UVUNWRAP_DISJOINT_SET_H
+
+#include <vector>
+#include <memory>
+#include <utility>
+
+namespace uvunwrap {
+
+/**
+ * @brief Disjoint-set forest with path halving and union by size
+ * @tparam Alloc Allocator for the parent/size arrays
+ */
+template <typename Alloc = std::allocator<int> >
+struct BasicDisjointSet {
+    std::vector<int, Alloc> parent;
+    std::vector<int, Alloc> size;
+
+    explicit BasicDisjointSet(int n, const Alloc& alloc = Alloc())
+        : parent(n, 0, alloc), size(n, 1, alloc) {
+        for (int i = 0; i < n; i++) parent[i] = i;
+    }
+
+    int find(int x) {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    }
+
+    bool unite(int a, int b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) return false;
+        if (size[a] < size[b]) std::swap(a, b);
+        parent[b] = a;
+        size[a] += size[b];
+        return true;
+    }
+};
+
+typedef BasicDisjointSet<> DisjointSet;
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_DISJOINT_SET_H */
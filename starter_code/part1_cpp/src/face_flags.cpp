@@ -0,0 +1,133 @@
+/**
+ * @file face_flags.cpp
+ * @brief Degenerate face classification
+ *
+ * Faces are processed in blocks: edge vectors are gathered into SoA
+ * arrays, Lanes compute the squared cross product and squared edge
+ * lengths, and the zero-area and sliver tests compare squares so no
+ * square root is needed. The scalar tail repeats the same float
+ * operations, so a face gets the same flags whichever path sees it.
+ */
+
+#include "topology.h"
+#include "simd.h"
+#include "parallel.h"
+#include "logging.h"
+#include <vector>
+
+namespace {
+
+const int MIN_FACES_PER_THREAD = 65536;
+const int FLAG_BLOCK = 256;
+
+// Zero area: 0.5 |e1 x e2| < 1e-8, the threshold LSCM assembly uses
+const float MAX_ZERO_CROSS2 = 4.0e-16f;
+// Sliver: height / longest edge = |e1 x e2| / L^2 < 1e-5
+const float SLIVER_RATIO2 = 1.0e-10f;
+
+/**
+ * @brief Zero-area and sliver tests of a block (1.0 where the test holds)
+ */
+void block_tests(int n,
+                 const float* ax_, const float* ay_, const float* az_,
+                 const float* bx_, const float* by_, const float* bz_,
+                 float* zero_area, float* sliver) {
+    using uvunwrap::Lanes;
+    typedef Lanes::V V;
+    const V zero = Lanes::set1(0.0f), one = Lanes::set1(1.0f);
+    const V max_cross2 = Lanes::set1(MAX_ZERO_CROSS2), ratio2 = Lanes::set1(SLIVER_RATIO2);
+
+    int i = 0;
+    for (; i + Lanes::N <= n; i += Lanes::N) {
+        V ax = Lanes::load(ax_ + i), ay = Lanes::load(ay_ + i), az = Lanes::load(az_ + i);
+        V bx = Lanes::load(bx_ + i), by = Lanes::load(by_ + i), bz = Lanes::load(bz_ + i);
+        V cx = Lanes::sub(Lanes::mul(ay, bz), Lanes::mul(az, by));
+        V cy = Lanes::sub(Lanes::mul(az, bx), Lanes::mul(ax, bz));
+        V cz = Lanes::sub(Lanes::mul(ax, by), Lanes::mul(ay, bx));
+        V cross2 = Lanes::add(Lanes::add(Lanes::mul(cx, cx), Lanes::mul(cy, cy)), Lanes::mul(cz, cz));
+
+        V dx = Lanes::sub(bx, ax), dy = Lanes::sub(by, ay), dz = Lanes::sub(bz, az);
+        V la = Lanes::add(Lanes::add(Lanes::mul(ax, ax), Lanes::mul(ay, ay)), Lanes::mul(az, az));
+        V lb = Lanes::add(Lanes::add(Lanes::mul(bx, bx), Lanes::mul(by, by)), Lanes::mul(bz, bz));
+        V ld = Lanes::add(Lanes::add(Lanes::mul(dx, dx), Lanes::mul(dy, dy)), Lanes::mul(dz, dz));
+        V longest = Lanes::select(Lanes::lt(la, lb), lb, la);
+        longest = Lanes::select(Lanes::lt(longest, ld), ld, longest);
+
+        Lanes::store(zero_area + i, Lanes::select(Lanes::lt(cross2, max_cross2), one, zero));
+        V bound = Lanes::mul(ratio2, Lanes::mul(longest, longest));
+        Lanes::store(sliver + i, Lanes::select(Lanes::lt(cross2, bound), one, zero));
+    }
+    for (; i < n; i++) {
+        float ax = ax_[i], ay = ay_[i], az = az_[i];
+        float bx = bx_[i], by = by_[i], bz = bz_[i];
+        float cx = ay * bz - az * by;
+        float cy = az * bx - ax * bz;
+        float cz = ax * by - ay * bx;
+        float cross2 = (cx * cx + cy * cy) + cz * cz;
+
+        float dx = bx - ax, dy = by - ay, dz = bz - az;
+        float la = (ax * ax + ay * ay) + az * az;
+        float lb = (bx * bx + by * by) + bz * bz;
+        float ld = (dx * dx + dy * dy) + dz * dz;
+        float longest = la < lb ? lb : la;
+        longest = longest < ld ? ld : longest;
+
+        zero_area[i] = cross2 < MAX_ZERO_CROSS2 ? 1.0f : 0.0f;
+        sliver[i] = cross2 < SLIVER_RATIO2 * (longest * longest) ? 1.0f : 0.0f;
+    }
+}
+
+} // namespace
+
+int classify_faces(const Mesh* mesh, unsigned char* flags_out, int num_threads) {
+    if (!mesh || !flags_out || mesh->num_triangles < 0 ||
+        (mesh->num_triangles > 0 && (!mesh->triangles || !mesh->vertices))) {
+        LOG_ERROR("classify_faces: Invalid mesh");
+        return -1;
+    }
+    int F = mesh->num_triangles;
+    int V = mesh->num_vertices;
+    for (int c = 0; c < 3 * F; c++) {
+        if (mesh->triangles[c] < 0 || mesh->triangles[c] >= V) {
+            LOG_ERROR("classify_faces: Triangle %d references vertex %d of %d", c / 3, mesh->triangles[c], V);
+            return -1;
+        }
+    }
+
+    int threads = uvunwrap::choose_thread_count(F, num_threads, MIN_FACES_PER_THREAD);
+    std::vector<int> range_flagged(threads, 0);
+    const float* P = mesh->vertices;
+    uvunwrap::parallel_for_ranges(F, threads, [&](int t, int begin, int end) {
+        float ax[FLAG_BLOCK], ay[FLAG_BLOCK], az[FLAG_BLOCK];
+        float bx[FLAG_BLOCK], by[FLAG_BLOCK], bz[FLAG_BLOCK];
+        float zero_area[FLAG_BLOCK], sliver[FLAG_BLOCK];
+        int flagged = 0;
+        for (int block = begin; block < end; block += FLAG_BLOCK) {
+            int n = end - block < FLAG_BLOCK ? end - block : FLAG_BLOCK;
+            for (int i = 0; i < n; i++) {
+                const int* tri = &mesh->triangles[(block + i) * 3];
+                const float* p0 = &P[tri[0] * 3];
+                const float* p1 = &P[tri[1] * 3];
+                const float* p2 = &P[tri[2] * 3];
+                ax[i] = p1[0] - p0[0]; ay[i] = p1[1] - p0[1]; az[i] = p1[2] - p0[2];
+                bx[i] = p2[0] - p0[0]; by[i] = p2[1] - p0[1]; bz[i] = p2[2] - p0[2];
+            }
+            block_tests(n, ax, ay, az, bx, by, bz, zero_area, sliver);
+            for (int i = 0; i < n; i++) {
+                const int* tri = &mesh->triangles[(block + i) * 3];
+                unsigned char flags = 0;
+                if (tri[0] == tri[1] || tri[1] == tri[2] || tri[2] == tri[0]) flags |= FACE_FLAG_DUPLICATE_INDEX;
+                if (zero_area[i] != 0.0f) flags |= FACE_FLAG_ZERO_AREA;
+                if (sliver[i] != 0.0f) flags |= FACE_FLAG_SLIVER;
+                flags_out[block + i] = flags;
+                if (flags) flagged++;
+            }
+        }
+        range_flagged[t] = flagged;
+    });
+
+    int num_flagged = 0;
+    for (int t = 0; t < threads; t++) num_flagged += range_flagged[t];
+    if (num_flagged > 0) LOG_DEBUG("classify_faces: %d of %d faces degenerate", num_flagged, F);
+    return num_flagged;
+}
@@ -0,0 +1,368 @@
+/**
+ * @file gpu_backend.cu
+ * @brief CUDA coverage rasteriser, per-face metric and CG kernels
+ *
+ * Built only with UVUNWRAP_WITH_CUDA. Every entry point reports failure
+ * instead of aborting, so a missing driver, an out-of-memory device or a
+ * kernel fault sends the caller back to its CPU path.
+ *
+ * Coverage: the host bins faces to 64×64 tiles as on the CPU; the device
+ * runs one block per tile and one thread per tile row. A thread walks the
+ * tile's faces in ascending order and owns its row's two bitplane words,
+ * so no word is shared and the bitplanes equal the CPU's. Totals and
+ * per-island texel counts are integer atomics and therefore exact.
+ *
+ * Metrics: one thread per face runs face_metrics() on the face's float
+ * vertices and UVs, widened to double as metrics.cpp does; the host
+ * reduces the per-face values.
+ *
+ * CG: one thread per matrix row. The sparse product is fused with the
+ * p.Ap reduction and the x / r update with the r.r and r.M^-1 r ones, so
+ * an iteration is three kernels and two small downloads; block sums are
+ * combined with double atomics (sm_60 and later).
+ */
+
+#include "gpu_backend.h"
+#include "coverage_raster.h"
+#include "metrics_face.h"
+#include "lscm_cancel.h"
+#include "logging.h"
+#include <cuda_runtime.h>
+#include <mutex>
+#include <vector>
+
+namespace uvunwrap {
+
+namespace {
+
+const int METRICS_THREADS = 256;
+const int CG_THREADS = 256;
+
+/** Logs a failed CUDA call; true when it succeeded */
+bool cuda_ok(cudaError_t status, const char* what) {
+    if (status == cudaSuccess) return true;
+    LOG_WARNING("CUDA: %s failed: %s", what, cudaGetErrorString(status));
+    return false;
+}
+
+/** Device allocation released on scope exit */
+template <typename T>
+struct DeviceBuffer {
+    T* ptr = nullptr;
+
+    DeviceBuffer() = default;
+    DeviceBuffer(const DeviceBuffer&) = delete;
+    DeviceBuffer& operator=(const DeviceBuffer&) = delete;
+    ~DeviceBuffer() {
+        if (ptr) cudaFree(ptr);
+    }
+
+    bool alloc(size_t count) {
+        return cuda_ok(cudaMalloc((void**)&ptr, (count > 0 ? count : 1) * sizeof(T)), "cudaMalloc");
+    }
+
+    bool upload(const T* host, size_t count) {
+        if (!alloc(count)) return false;
+        return count == 0 || cuda_ok(cudaMemcpy(ptr, host, count * sizeof(T), cudaMemcpyHostToDevice), "upload");
+    }
+
+    bool download(T* host, size_t count) const {
+        return count == 0 || cuda_ok(cudaMemcpy(host, ptr, count * sizeof(T), cudaMemcpyDeviceToHost), "download");
+    }
+};
+
+__global__ void raster_tiles_kernel(int resolution, int tiles_x,
+                                    const size_t* tile_offsets, const int* tile_faces,
+                                    const EdgeSetup* edges, const int* face_rows, const int* face_islands,
+                                    unsigned long long* totals, unsigned long long* island_texels) {
+    int tile = blockIdx.x;
+    size_t begin = tile_offsets[tile], end = tile_offsets[tile + 1];
+    if (begin == end) return;
+
+    int tile_x0 = (tile % tiles_x) * TILE_SIZE;
+    int tile_y0 = (tile / tiles_x) * TILE_SIZE;
+    int tile_x1 = min(tile_x0 + TILE_SIZE, resolution) - 1;
+    int y = tile_y0 + (int)threadIdx.x;
+    if (y >= resolution) return;
+
+    unsigned long long occupied = 0, overlap = 0;
+    // Runs of faces of one island are flushed with a single atomic
+    int run_island = -1;
+    unsigned long long run = 0;
+    for (size_t i = begin; i < end; i++) {
+        int f = tile_faces[i];
+        if (y < face_rows[2 * f] || y > face_rows[2 * f + 1]) continue;
+        long long lo, hi;
+        row_span(edges[f], y, &lo, &hi);
+        lo = lo > tile_x0 ? lo : tile_x0;
+        hi = hi < tile_x1 ? hi : tile_x1;
+        if (lo > hi) continue;
+
+        int a = (int)lo - tile_x0, b = (int)hi - tile_x0;
+        unsigned long long mask = span_mask(a, b);
+        overlap |= occupied & mask;
+        occupied |= mask;
+
+        int island = face_islands[f];
+        if (island != run_island) {
+            if (run_island >= 0 && run > 0) atomicAdd(&island_texels[run_island], run);
+            run_island = island;
+            run = 0;
+        }
+        run += (unsigned long long)(b - a + 1);
+    }
+    if (run_island >= 0 && run > 0) atomicAdd(&island_texels[run_island], run);
+    if (occupied) atomicAdd(&totals[0], (unsigned long long)__popcll(occupied));
+    if (overlap) atomicAdd(&totals[1], (unsigned long long)__popcll(overlap));
+}
+
+__global__ void face_metrics_kernel(int num_faces, const float* vertices, const float* uvs, const int* triangles,
+                                    double* area_3d, double* area_uv, double* ratio, double* l2_sq,
+                                    double* sigma_max, double* angle, int* valid) {
+    int f = blockIdx.x * blockDim.x + threadIdx.x;
+    if (f >= num_faces) return;
+
+    const int* tri = &triangles[(size_t)f * 3];
+    const float* p0 = &vertices[(size_t)tri[0] * 3];
+    const float* p1 = &vertices[(size_t)tri[1] * 3];
+    const float* p2 = &vertices[(size_t)tri[2] * 3];
+    const float* t0 = &uvs[(size_t)tri[0] * 2];
+    const float* t1 = &uvs[(size_t)tri[1] * 2];
+    const float* t2 = &uvs[(size_t)tri[2] * 2];
+    FaceMetricValues m = face_metrics((double)p1[0] - p0[0], (double)p1[1] - p0[1], (double)p1[2] - p0[2],
+                                      (double)p2[0] - p0[0], (double)p2[1] - p0[1], (double)p2[2] - p0[2],
+                                      (double)t1[0] - t0[0], (double)t1[1] - t0[1],
+                                      (double)t2[0] - t0[0], (double)t2[1] - t0[1]);
+    area_3d[f] = m.area_3d;
+    area_uv[f] = m.area_uv;
+    ratio[f] = m.ratio;
+    l2_sq[f] = m.l2_sq;
+    sigma_max[f] = m.sigma_max;
+    angle[f] = m.angle;
+    valid[f] = m.valid;
+}
+
+/** Adds v over the block into *out; every thread of the block must call it */
+__device__ void block_sum(double v, double* shared, double* out) {
+    shared[threadIdx.x] = v;
+    __syncthreads();
+    for (int s = blockDim.x / 2; s > 0; s >>= 1) {
+        if ((int)threadIdx.x < s) shared[threadIdx.x] += shared[threadIdx.x + s];
+        __syncthreads();
+    }
+    if (threadIdx.x == 0 && shared[0] != 0.0) atomicAdd(out, shared[0]);
+    __syncthreads();
+}
+
+__device__ double row_dot(const int* outer, const int* inner, const double* values, const double* v, int i) {
+    double s = 0.0;
+    for (int k = outer[i]; k < outer[i + 1]; k++) s += values[k] * v[inner[k]];
+    return s;
+}
+
+/** inv_diag = 1 / diag(A), r = b - A x, p = inv_diag r; sums[1] += r.r, sums[2] += r.p */
+__global__ void cg_start_kernel(int n, const int* outer, const int* inner, const double* values,
+                                const double* b, const double* x, double* inv_diag, double* r, double* p,
+                                double* sums) {
+    __shared__ double shared[CG_THREADS];
+    int i = blockIdx.x * blockDim.x + threadIdx.x;
+    double rr = 0.0, rz = 0.0;
+    if (i < n) {
+        double d = 0.0;
+        for (int k = outer[i]; k < outer[i + 1]; k++) {
+            if (inner[k] == i) d = values[k];
+        }
+        inv_diag[i] = d != 0.0 ? 1.0 / d : 0.0;
+        r[i] = b[i] - row_dot(outer, inner, values, x, i);
+        p[i] = inv_diag[i] * r[i];
+        rr = r[i] * r[i];
+        rz = r[i] * p[i];
+    }
+    block_sum(rr, shared, &sums[1]);
+    block_sum(rz, shared, &sums[2]);
+}
+
+/** Ap = A p; sums[0] += p.Ap */
+__global__ void cg_product_kernel(int n, const int* outer, const int* inner, const double* values,
+                                  const double* p, double* Ap, double* sums) {
+    __shared__ double shared[CG_THREADS];
+    int i = blockIdx.x * blockDim.x + threadIdx.x;
+    double pAp = 0.0;
+    if (i < n) {
+        Ap[i] = row_dot(outer, inner, values, p, i);
+        pAp = p[i] * Ap[i];
+    }
+    block_sum(pAp, shared, &sums[0]);
+}
+
+/** x += alpha p, r -= alpha Ap; sums[1] += r.r, sums[2] += r.M^-1 r */
+__global__ void cg_update_kernel(int n, double alpha, const double* p, const double* Ap, const double* inv_diag,
+                                 double* x, double* r, double* sums) {
+    __shared__ double shared[CG_THREADS];
+    int i = blockIdx.x * blockDim.x + threadIdx.x;
+    double rr = 0.0, rz = 0.0;
+    if (i < n) {
+        x[i] += alpha * p[i];
+        r[i] -= alpha * Ap[i];
+        rr = r[i] * r[i];
+        rz = rr * inv_diag[i];
+    }
+    block_sum(rr, shared, &sums[1]);
+    block_sum(rz, shared, &sums[2]);
+}
+
+/** p = M^-1 r + beta p */
+__global__ void cg_direction_kernel(int n, double beta, const double* inv_diag, const double* r, double* p) {
+    int i = blockIdx.x * blockDim.x + threadIdx.x;
+    if (i < n) p[i] = inv_diag[i] * r[i] + beta * p[i];
+}
+
+} // namespace
+
+bool gpu_available() {
+    static std::once_flag probed;
+    static bool available = false;
+    std::call_once(probed, [] {
+        int count = 0;
+        cudaError_t status = cudaGetDeviceCount(&count);
+        available = status == cudaSuccess && count > 0;
+        if (available) {
+            cudaDeviceProp prop;
+            if (cudaGetDeviceProperties(&prop, 0) == cudaSuccess) LOG_INFO("CUDA: using %s", prop.name);
+        } else {
+            // Clear the sticky error a missing driver leaves behind
+            cudaGetLastError();
+        }
+    });
+    return available;
+}
+
+bool gpu_rasterise(const GpuRasterJob& job, long long* covered, long long* overlapped, long long* island_texels) {
+    DeviceBuffer<size_t> offsets;
+    DeviceBuffer<int> faces, rows, islands;
+    DeviceBuffer<EdgeSetup> edges;
+    DeviceBuffer<unsigned long long> totals, texels;
+    size_t F = (size_t)job.num_faces;
+    if (!offsets.upload(job.tile_offsets, (size_t)job.num_tiles + 1) ||
+        !faces.upload(job.tile_faces, job.num_refs) ||
+        !edges.upload(job.edges, F) ||
+        !rows.upload(job.face_rows, F * 2) ||
+        !islands.upload(job.face_islands, F) ||
+        !totals.alloc(2) || !texels.alloc((size_t)job.num_islands) ||
+        !cuda_ok(cudaMemset(totals.ptr, 0, 2 * sizeof(unsigned long long)), "cudaMemset") ||
+        !cuda_ok(cudaMemset(texels.ptr, 0, (size_t)job.num_islands * sizeof(unsigned long long)), "cudaMemset")) {
+        return false;
+    }
+
+    raster_tiles_kernel<<<job.num_tiles, TILE_SIZE>>>(job.resolution, job.tiles_x, offsets.ptr, faces.ptr,
+                                                      edges.ptr, rows.ptr, islands.ptr, totals.ptr, texels.ptr);
+    if (!cuda_ok(cudaGetLastError(), "raster kernel launch") ||
+        !cuda_ok(cudaDeviceSynchronize(), "raster kernel")) {
+        return false;
+    }
+
+    unsigned long long host_totals[2];
+    std::vector<unsigned long long> host_texels((size_t)job.num_islands);
+    if (!totals.download(host_totals, 2) || !texels.download(host_texels.data(), host_texels.size())) return false;
+
+    *covered += (long long)host_totals[0];
+    *overlapped += (long long)host_totals[1];
+    for (int i = 0; i < job.num_islands; i++) island_texels[i] += (long long)host_texels[i];
+    return true;
+}
+
+bool gpu_face_metrics(const Mesh* mesh, const GpuFaceMetrics& out) {
+    size_t V = (size_t)mesh->num_vertices;
+    size_t F = (size_t)mesh->num_triangles;
+    if (F == 0) return true;
+
+    DeviceBuffer<float> vertices, uvs;
+    DeviceBuffer<int> triangles, valid;
+    DeviceBuffer<double> area_3d, area_uv, ratio, l2_sq, sigma_max, angle;
+    if (!vertices.upload(mesh->vertices, V * 3) || !uvs.upload(mesh->uvs, V * 2) ||
+        !triangles.upload(mesh->triangles, F * 3) ||
+        !area_3d.alloc(F) || !area_uv.alloc(F) || !ratio.alloc(F) || !l2_sq.alloc(F) ||
+        !sigma_max.alloc(F) || !angle.alloc(F) || !valid.alloc(F)) {
+        return false;
+    }
+
+    int blocks = (int)((F + METRICS_THREADS - 1) / METRICS_THREADS);
+    face_metrics_kernel<<<blocks, METRICS_THREADS>>>((int)F, vertices.ptr, uvs.ptr, triangles.ptr, area_3d.ptr,
+                                                     area_uv.ptr, ratio.ptr, l2_sq.ptr, sigma_max.ptr, angle.ptr,
+                                                     valid.ptr);
+    if (!cuda_ok(cudaGetLastError(), "metrics kernel launch") ||
+        !cuda_ok(cudaDeviceSynchronize(), "metrics kernel")) {
+        return false;
+    }
+
+    return area_3d.download(out.area_3d, F) && area_uv.download(out.area_uv, F) &&
+           ratio.download(out.ratio, F) && l2_sq.download(out.l2_sq, F) &&
+           sigma_max.download(out.sigma_max, F) && angle.download(out.angle, F) &&
+           valid.download(out.valid, F);
+}
+
+bool gpu_pcg(int size, const int* outer, const int* inner, const double* values, const double* b, double* x,
+             int max_iterations, double tolerance, const LscmOptions* options,
+             int* iterations_out, double* residual_out) {
+    size_t n = (size_t)size;
+    size_t nnz = (size_t)outer[size];
+    *iterations_out = 0;
+    *residual_out = 0.0;
+    double b_norm2 = 0.0;
+    for (size_t i = 0; i < n; i++) b_norm2 += b[i] * b[i];
+    if (b_norm2 == 0.0) {
+        for (size_t i = 0; i < n; i++) x[i] = 0.0;
+        return true;
+    }
+
+    // The one upload: matrix, right-hand side and start
+    DeviceBuffer<int> d_outer, d_inner;
+    DeviceBuffer<double> d_values, d_b, d_x, d_r, d_p, d_Ap, d_inv_diag, d_sums;
+    if (!d_outer.upload(outer, n + 1) || !d_inner.upload(inner, nnz) || !d_values.upload(values, nnz) ||
+        !d_b.upload(b, n) || !d_x.upload(x, n) ||
+        !d_r.alloc(n) || !d_p.alloc(n) || !d_Ap.alloc(n) || !d_inv_diag.alloc(n) || !d_sums.alloc(3)) {
+        return false;
+    }
+
+    int blocks = (int)((n + CG_THREADS - 1) / CG_THREADS);
+    double sums[3] = {0.0, 0.0, 0.0};
+    auto reduce = [&](int first, int count) {
+        return cuda_ok(cudaGetLastError(), "CG kernel launch") &&
+               cuda_ok(cudaMemcpy(&sums[first], d_sums.ptr + first, count * sizeof(double), cudaMemcpyDeviceToHost),
+                       "CG reduction");
+    };
+    auto clear = [&](int first, int count) {
+        return cuda_ok(cudaMemset(d_sums.ptr + first, 0, count * sizeof(double)), "cudaMemset");
+    };
+
+    if (!clear(0, 3)) return false;
+    cg_start_kernel<<<blocks, CG_THREADS>>>(size, d_outer.ptr, d_inner.ptr, d_values.ptr, d_b.ptr, d_x.ptr,
+                                            d_inv_diag.ptr, d_r.ptr, d_p.ptr, d_sums.ptr);
+    if (!reduce(1, 2)) return false;
+    double residual = sqrt(sums[1] / b_norm2);
+    double rz = sums[2];
+    int iterations = 0;
+    while (residual > tolerance && iterations < max_iterations) {
+        if (lscm_cancelled(options)) return false;
+        if (!clear(0, 3)) return false;
+        cg_product_kernel<<<blocks, CG_THREADS>>>(size, d_outer.ptr, d_inner.ptr, d_values.ptr, d_p.ptr, d_Ap.ptr,
+                                                  d_sums.ptr);
+        if (!reduce(0, 1)) return false;
+        double alpha = rz / sums[0];
+        cg_update_kernel<<<blocks, CG_THREADS>>>(size, alpha, d_p.ptr, d_Ap.ptr, d_inv_diag.ptr, d_x.ptr, d_r.ptr,
+                                                 d_sums.ptr);
+        if (!reduce(1, 2)) return false;
+        iterations++;
+        residual = sqrt(sums[1] / b_norm2);
+        if (residual <= tolerance) break;
+        double beta = sums[2] / rz;
+        rz = sums[2];
+        cg_direction_kernel<<<blocks, CG_THREADS>>>(size, beta, d_inv_diag.ptr, d_r.ptr, d_p.ptr);
+    }
+    if (!cuda_ok(cudaGetLastError(), "CG kernel launch") || !d_x.download(x, n)) return false;
+    *iterations_out = iterations;
+    *residual_out = residual;
+    return true;
+}
+
+} // namespace uvunwrap
@@ -0,0 +1,107 @@
+/**
+ * @file gpu_backend.h
+ * @brief Internal interface of the optional CUDA metrics, coverage and CG backend
+ *
+ * Not part of the public API. Built with UVUNWRAP_WITH_CUDA
+ * (gpu_backend.cu); without it the entry points are inline stubs that
+ * report no device, so every caller keeps its CPU path. The kernels share
+ * their per-face and per-row math with the CPU code through
+ * coverage_raster.h and metrics_face.h, which is what keeps the two
+ * backends' results identical (coverage) or equal to round-off (metrics).
+ */
+
+#ifndef UVUNWRAP_GPU_BACKEND_H
+#define UVUNWRAP_GPU_BACKEND_H
+
+#include "mesh.h"
+#include "lscm.h"
+#include <stddef.h>
+
+#ifdef __CUDACC__
+#define UV_HOST_DEVICE __host__ __device__
+#else
+#define UV_HOST_DEVICE
+#endif
+
+namespace uvunwrap {
+
+struct EdgeSetup;
+
+/** Tile-binned faces of one compute_uv_coverage() call, in host memory */
+struct GpuRasterJob {
+    int resolution;
+    int tiles_x;
+    int num_tiles;
+    int num_faces;
+    int num_islands;
+    const size_t* tile_offsets;    // num_tiles + 1, CSR into tile_faces
+    const int* tile_faces;         // faces of each tile, ascending
+    size_t num_refs;
+    const EdgeSetup* edges;        // per face (only binned faces are read)
+    const int* face_rows;          // per face: first and last texel row
+    const int* face_islands;       // per face: island, or -1 to count nowhere
+};
+
+/** Per-face values of compute_quality_metrics_ex(), as the CPU kernels produce them */
+struct GpuFaceMetrics {
+    double* area_3d;
+    double* area_uv;
+    double* ratio;
+    double* l2_sq;
+    double* sigma_max;
+    double* angle;
+    int* valid;
+};
+
+#ifdef UVUNWRAP_HAVE_CUDA
+
+/** A CUDA device is present and usable (probed once) */
+bool gpu_available();
+
+/**
+ * @brief Rasterise the binned tiles on the device
+ * @param island_texels num_islands entries, added to
+ * @return false on any CUDA error (outputs untouched); the caller falls back
+ */
+bool gpu_rasterise(const GpuRasterJob& job, long long* covered, long long* overlapped, long long* island_texels);
+
+/**
+ * @brief Per-face stretch and angle values of every face of mesh
+ * @param out Arrays of mesh->num_triangles entries
+ * @return false on any CUDA error; the caller falls back
+ */
+bool gpu_face_metrics(const Mesh* mesh, const GpuFaceMetrics& out);
+
+/**
+ * @brief Jacobi-preconditioned CG on a symmetric matrix, on the device
+ *
+ * The compressed matrix (CSC of a symmetric matrix, so also its CSR), b
+ * and the start x are uploaded once; each iteration downloads only its
+ * two reduction scalars. Stops at ||b - A x|| / ||b|| <= tolerance or
+ * max_iterations, polling options->should_cancel every iteration.
+ *
+ * @param x Start on entry, last iterate on return (also when not converged)
+ * @return false on a CUDA error or cancellation (x untouched on error)
+ */
+bool gpu_pcg(int size, const int* outer, const int* inner, const double* values, const double* b, double* x,
+             int max_iterations, double tolerance, const LscmOptions* options,
+             int* iterations_out, double* residual_out);
+
+#else
+
+inline bool gpu_available() { return false; }
+
+inline bool gpu_rasterise(const GpuRasterJob&, long long*, long long*, long long*) { return false; }
+
+inline bool gpu_face_metrics(const Mesh*, const GpuFaceMetrics&) { return false; }
+
+inline bool gpu_pcg(int, const int*, const int*, const double*, const double*, double*, int, double,
+                    const LscmOptions*, int*, double*) {
+    return false;
+}
+
+#endif
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_GPU_BACKEND_H */
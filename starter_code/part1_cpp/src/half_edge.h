@@ -0,0 +1,135 @@
+/**
+ * @file half_edge.h
+ * @brief Internal index-based half-edge view of a triangle mesh
+ *
+ * Not part of the public API. Half-edge h = 3 * f + k runs from corner k
+ * of triangle f to corner (k + 1) % 3, so face, next and prev are
+ * arithmetic and the origin array is the mesh's own triangle array; only
+ * twin and the undirected edge index are stored (SoA, 32-bit). Edge
+ * indices follow TopologyInfo order, so seams found on either agree.
+ */
+
+#ifndef UVUNWRAP_HALF_EDGE_H
+#define UVUNWRAP_HALF_EDGE_H
+
+#include "topology.h"
+#include "unwrap.h"
+#include <stddef.h>
+#include <vector>
+
+namespace uvunwrap {
+
+struct TriangleGeometry;
+
+struct HalfEdgeMesh {
+    int num_vertices;
+    int num_faces;
+    int num_edges;
+    int num_nonmanifold_edges;         /**< Edges with more than two faces */
+    const int* vertex;                 /**< Origin vertex per half-edge (the mesh's triangles, 3F) */
+    std::vector<int> twin;             /**< Opposite half-edge, -1 on the boundary (3F) */
+    std::vector<int> edge;             /**< Undirected edge index (3F; -1 if built from a
+                                            TopologyInfo and the face is not one of the edge's two) */
+    std::vector<int> edge_half_edges;  /**< [h0, h1] per edge: the sides in face0 and face1,
+                                            h1 = -1 on the boundary (2E) */
+
+    static int face(int h) { return h / 3; }
+    static int next(int h) { return h % 3 == 2 ? h - 2 : h + 1; }
+    static int prev(int h) { return h % 3 == 0 ? h + 2 : h - 1; }
+    int origin(int h) const { return vertex[h]; }
+    int target(int h) const { return vertex[next(h)]; }
+};
+
+/**
+ * @brief Build from a mesh in linear time (radix sort of edge keys)
+ *
+ * A non-manifold edge pairs the sides of its lowest and highest face, the
+ * same two faces TopologyInfo lists; the faces between keep twin = -1.
+ * Such edges are counted in num_nonmanifold_edges and logged.
+ *
+ * @param num_threads Worker threads (0 = automatic by mesh size); the
+ *        result does not depend on it
+ * @param face_flags Optional classify_faces() output: faces with
+ *        FACE_FLAG_DUPLICATE_INDEX keep twin = -1 on every side (their
+ *        sides would otherwise pair with each other) and are listed on
+ *        an edge only when no other face is
+ * @param sort_policy SortPolicy of the edge key sort (AUTO: the same split
+ *        as the rest of the build)
+ * @return false on invalid input
+ */
+bool build_half_edge_mesh(const Mesh* mesh, HalfEdgeMesh* out, int num_threads,
+                          const unsigned char* face_flags = NULL,
+                          int sort_policy = SORT_POLICY_AUTO);
+
+/**
+ * @brief Build from an existing TopologyInfo of the same mesh, O(E)
+ * @return false on invalid input
+ */
+bool half_edges_from_topology(const Mesh* mesh, const TopologyInfo* topo, HalfEdgeMesh* out);
+
+/**
+ * @brief TopologyInfo with the same content build_topology() gives
+ * @note Caller must free with free_topology()
+ */
+TopologyInfo* topology_from_half_edges(const HalfEdgeMesh& he, int num_threads);
+
+/**
+ * @brief Group every vertex's corners into fans (faces joined by twins)
+ *
+ * corner_fan[h] is the fan of the corner at origin(h), fans numbered by
+ * their lowest corner; fan_vertex lists each fan's vertex. Linear up to
+ * the union-find's inverse Ackermann factor.
+ *
+ * @param num_nonmanifold_vertices_out Optional: vertices with more than one fan
+ * @return Number of fans
+ */
+int label_vertex_fans(const HalfEdgeMesh& he,
+                      std::vector<int>& corner_fan,
+                      std::vector<int>& fan_vertex,
+                      int* num_nonmanifold_vertices_out);
+
+/**
+ * @brief detect_seams_with_method() on a prebuilt half-edge view
+ *
+ * topo and he describe the same mesh. Edges next to a face flagged in
+ * the optional classify_faces() output are never seams: such a face has
+ * no usable normal, and it is better carried inside its neighbour's chart.
+ * The candidate sorts follow sort_policy on up to num_threads workers.
+ * The MST engine reads the face normals of geometry when it holds them.
+ */
+int* detect_seams_half_edge(const Mesh* mesh,
+                            const TopologyInfo* topo,
+                            const HalfEdgeMesh& he,
+                            float angle_threshold,
+                            int seam_method,
+                            int* num_seams_out,
+                            const unsigned char* face_flags = NULL,
+                            int sort_policy = SORT_POLICY_AUTO,
+                            int num_threads = 0,
+                            const TriangleGeometry* geometry = NULL);
+
+/**
+ * @brief Ordered boundary loops of one island in O(island size)
+ *
+ * A side is on the island boundary if it has no twin or its twin's face
+ * belongs to another island. Each loop is walked by pivoting around
+ * vertices through twins, without any per-island map; for consistently
+ * oriented faces it follows the face winding.
+ *
+ * @param face_island Island id per face (NULL: one island, only open sides count)
+ * @param faces The island's faces
+ * @param loop_offsets CSR offsets, num_loops + 1 entries
+ * @param loop_vertices Loop vertices in walk order
+ * @param loop_half_edges Side from loop_vertices[i] to the next vertex of its loop
+ */
+void island_boundary_loops(const HalfEdgeMesh& he,
+                           const int* face_island,
+                           const int* faces,
+                           int num_faces,
+                           std::vector<int>& loop_offsets,
+                           std::vector<int>& loop_vertices,
+                           std::vector<int>& loop_half_edges);
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_HALF_EDGE_H */
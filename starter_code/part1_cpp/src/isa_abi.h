@@ -0,0 +1,27 @@
+/**
+ * @file isa_abi.h
+ * @brief Internal namespace tag for code built per instruction set
+ *
+ * Not part of the public API. With UVUNWRAP_MULTI_ISA some sources are
+ * compiled several times with different -m flags. Inline functions they
+ * share through headers (simd.h, vec_math.h) would then be emitted once
+ * per copy under one symbol, and the linker could keep an AVX-512 body
+ * for every caller. Headers open UVUNWRAP_ISA_ABI as an inline namespace
+ * instead, so each instruction set gets its own symbols without changing
+ * any source.
+ */
+
+#ifndef UVUNWRAP_ISA_ABI_H
+#define UVUNWRAP_ISA_ABI_H
+
+#if defined(__AVX512F__)
+#define UVUNWRAP_ISA_ABI abi_avx512
+#elif defined(__AVX2__)
+#define UVUNWRAP_ISA_ABI abi_avx2
+#elif defined(__AVX__)
+#define UVUNWRAP_ISA_ABI abi_avx
+#else
+#define UVUNWRAP_ISA_ABI abi_base
+#endif
+
+#endif /* UVUNWRAP_ISA_ABI_H */
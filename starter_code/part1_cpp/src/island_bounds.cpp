@@ -0,0 +1,167 @@
+/**
+ * @file island_bounds.cpp
+ * @brief Per-island axis-aligned and minimum-area bounding boxes
+ *
+ * A worker copies an island's UVs out of the interleaved mesh array into
+ * its own u and v buffers once; the min/max reduction then runs on whole
+ * lanes, and the hull reads the same buffers. Lane minima are taken with
+ * lt/select, the scalar `a < b ? a : b` per lane, so the box does not
+ * depend on the lane width.
+ */
+
+#include "island_bounds.h"
+#include "simd.h"
+#include "parallel.h"
+#include "trace.h"
+#include <float.h>
+#include <math.h>
+#include <algorithm>
+
+namespace uvunwrap {
+
+namespace {
+
+const int MIN_VERTICES_PER_THREAD = 32768;
+
+/** Island-local SoA buffers of one worker */
+struct BoundsScratch {
+    std::vector<float> u, v;
+    std::vector<HullPoint> hull;
+};
+
+} // namespace
+
+void uv_bounds(const float* u, const float* v, int n, IslandBox* box) {
+    float min_u = FLT_MAX, max_u = -FLT_MAX, min_v = FLT_MAX, max_v = -FLT_MAX;
+    int i = 0;
+    if (n >= Lanes::N) {
+        typedef Lanes::V V;
+        V lo_u = Lanes::load(u), hi_u = lo_u, lo_v = Lanes::load(v), hi_v = lo_v;
+        for (i = Lanes::N; i + Lanes::N <= n; i += Lanes::N) {
+            V a = Lanes::load(u + i), b = Lanes::load(v + i);
+            lo_u = Lanes::select(Lanes::lt(a, lo_u), a, lo_u);
+            hi_u = Lanes::select(Lanes::lt(hi_u, a), a, hi_u);
+            lo_v = Lanes::select(Lanes::lt(b, lo_v), b, lo_v);
+            hi_v = Lanes::select(Lanes::lt(hi_v, b), b, hi_v);
+        }
+        float lanes[4][Lanes::N];
+        Lanes::store(lanes[0], lo_u);
+        Lanes::store(lanes[1], hi_u);
+        Lanes::store(lanes[2], lo_v);
+        Lanes::store(lanes[3], hi_v);
+        for (int k = 0; k < Lanes::N; k++) {
+            min_u = lanes[0][k] < min_u ? lanes[0][k] : min_u;
+            max_u = lanes[1][k] > max_u ? lanes[1][k] : max_u;
+            min_v = lanes[2][k] < min_v ? lanes[2][k] : min_v;
+            max_v = lanes[3][k] > max_v ? lanes[3][k] : max_v;
+        }
+    }
+    for (; i < n; i++) {
+        min_u = u[i] < min_u ? u[i] : min_u;
+        max_u = u[i] > max_u ? u[i] : max_u;
+        min_v = v[i] < min_v ? v[i] : min_v;
+        max_v = v[i] > max_v ? v[i] : max_v;
+    }
+    box->min_u = min_u;
+    box->max_u = max_u;
+    box->min_v = min_v;
+    box->max_v = max_v;
+}
+
+void convex_hull(const float* u, const float* v, int n, std::vector<HullPoint>& hull) {
+    std::vector<HullPoint> pts((size_t)(n > 0 ? n : 0));
+    for (int k = 0; k < n; k++) {
+        pts[k].x = u[k];
+        pts[k].y = v[k];
+    }
+    hull.clear();
+    if (pts.size() < 3) {
+        hull = pts;
+        return;
+    }
+
+    std::sort(pts.begin(), pts.end(), [](const HullPoint& a, const HullPoint& b) {
+        return a.x < b.x || (a.x == b.x && a.y < b.y);
+    });
+    auto cross = [](const HullPoint& o, const HullPoint& a, const HullPoint& b) {
+        return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+    };
+    hull.resize(2 * pts.size());
+    size_t k = 0;
+    for (size_t i = 0; i < pts.size(); i++) {
+        while (k >= 2 && cross(hull[k - 2], hull[k - 1], pts[i]) <= 0) k--;
+        hull[k++] = pts[i];
+    }
+    for (size_t i = pts.size() - 1, t = k + 1; i > 0; i--) {
+        while (k >= t && cross(hull[k - 2], hull[k - 1], pts[i - 1]) <= 0) k--;
+        hull[k++] = pts[i - 1];
+    }
+    hull.resize(k > 1 ? k - 1 : k);
+}
+
+double min_area_angle(const std::vector<HullPoint>& hull) {
+    if (hull.size() < 3) return 0.0;
+
+    double best_area = DBL_MAX, best_angle = 0.0;
+    for (size_t i = 0; i < hull.size(); i++) {
+        const HullPoint& a = hull[i];
+        const HullPoint& b = hull[(i + 1) % hull.size()];
+        double len = sqrt((b.x - a.x) * (b.x - a.x) + (b.y - a.y) * (b.y - a.y));
+        if (len <= 0.0) continue;
+        double ex = (b.x - a.x) / len, ey = (b.y - a.y) / len;
+        double min_s = DBL_MAX, max_s = -DBL_MAX, min_t = DBL_MAX, max_t = -DBL_MAX;
+        for (const HullPoint& p : hull) {
+            double s = p.x * ex + p.y * ey, t = -p.x * ey + p.y * ex;
+            min_s = std::min(min_s, s);
+            max_s = std::max(max_s, s);
+            min_t = std::min(min_t, t);
+            max_t = std::max(max_t, t);
+        }
+        double area = (max_s - min_s) * (max_t - min_t);
+        if (area < best_area) {
+            best_area = area;
+            best_angle = -atan2(ey, ex);
+        }
+    }
+    return best_angle;
+}
+
+void island_boxes(const float* uvs, const int* vertex_offsets, const int* vertices, int num_islands,
+                  bool min_area, int num_threads, IslandBox* boxes) {
+    if (num_islands <= 0) return;
+    UV_TRACE_ZONE("island boxes");
+    int threads = choose_thread_count(vertex_offsets[num_islands], num_threads, MIN_VERTICES_PER_THREAD);
+    std::vector<BoundsScratch> scratch((size_t)threads);
+
+    parallel_for_dynamic(num_islands, threads, [&](int worker, int i) {
+        BoundsScratch& s = scratch[worker];
+        const int* first = vertices + vertex_offsets[i];
+        int n = vertex_offsets[i + 1] - vertex_offsets[i];
+        s.u.resize((size_t)n);
+        s.v.resize((size_t)n);
+        for (int k = 0; k < n; k++) {
+            s.u[k] = uvs[first[k] * 2 + 0];
+            s.v[k] = uvs[first[k] * 2 + 1];
+        }
+
+        IslandBox& box = boxes[i];
+        uv_bounds(s.u.data(), s.v.data(), n, &box);
+        box.angle = 0.0;
+        if (min_area && n >= 3) {
+            convex_hull(s.u.data(), s.v.data(), n, s.hull);
+            box.angle = min_area_angle(s.hull);
+        }
+        if (box.angle != 0.0) {
+            // The box the island will have once turned, without writing it
+            double c = cos(box.angle), sn = sin(box.angle);
+            for (int k = 0; k < n; k++) {
+                double u = s.u[k], w = s.v[k];
+                s.u[k] = (float)(c * u - sn * w);
+                s.v[k] = (float)(sn * u + c * w);
+            }
+            uv_bounds(s.u.data(), s.v.data(), n, &box);
+        }
+    });
+}
+
+} // namespace uvunwrap
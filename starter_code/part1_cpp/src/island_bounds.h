@@ -0,0 +1,68 @@
+/**
+ * @file island_bounds.h
+ * @brief Internal per-island bounding boxes for the packers
+ *
+ * Not part of the public API; used by packing.cpp. Each island's UVs are
+ * gathered into island-local SoA buffers, reduced to an axis-aligned box
+ * with Lanes (simd.h), and optionally turned into the orientation of the
+ * minimum-area box through the convex hull. Islands are independent, so
+ * they are spread over worker threads.
+ */
+
+#ifndef UVUNWRAP_ISLAND_BOUNDS_H
+#define UVUNWRAP_ISLAND_BOUNDS_H
+
+#include <vector>
+
+namespace uvunwrap {
+
+/** Box of one island; an island without vertices keeps min = FLT_MAX, max = -FLT_MAX */
+struct IslandBox {
+    float min_u, max_u, min_v, max_v;
+    double angle;  /**< Turn to the minimum-area box, radians (0 unless asked for); the box is the turned one */
+};
+
+/** Convex hull vertex */
+struct HullPoint {
+    double x, y;
+};
+
+/**
+ * @brief Axis-aligned box of n points given as SoA coordinates
+ *
+ * Gives exactly the box scalar min/max comparisons do.
+ */
+void uv_bounds(const float* u, const float* v, int n, IslandBox* box);
+
+/**
+ * @brief Convex hull of n points (Andrew's monotone chain)
+ *
+ * Counter-clockwise from the lowest-leftmost point, collinear points
+ * dropped; fewer than three points when the input is degenerate.
+ */
+void convex_hull(const float* u, const float* v, int n, std::vector<HullPoint>& hull);
+
+/**
+ * @brief Angle that turns a hull to its minimum-area bounding box
+ *
+ * The optimal box has a side on a hull edge, so only the edge directions
+ * are tried (rotating calipers). 0 for hulls of fewer than three points.
+ */
+double min_area_angle(const std::vector<HullPoint>& hull);
+
+/**
+ * @brief Boxes of every island of a CSR vertex list
+ * @param uvs Interleaved mesh UVs
+ * @param vertex_offsets num_islands + 1 offsets into vertices
+ * @param vertices Vertex indices of each island, back to back
+ * @param min_area Also compute IslandBox::angle and give the box of the
+ *        island turned by it (turned as transform_islands() does)
+ * @param num_threads Worker threads (0 = automatic by vertex count)
+ * @param boxes Output, num_islands entries
+ */
+void island_boxes(const float* uvs, const int* vertex_offsets, const int* vertices, int num_islands,
+                  bool min_area, int num_threads, IslandBox* boxes);
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_ISLAND_BOUNDS_H */
@@ -0,0 +1,328 @@
+/**
+ * @file island_cache.cpp
+ * @brief Memo of solved islands, in memory and optionally on disk
+ *
+ * Entries are kept in a list ordered by last use, most recent first, with
+ * a hash map from key to list node; one mutex covers both, held only to
+ * copy an entry in or out. An entry holds the island's positions and
+ * triangles so a hit is verified, and its UVs by local vertex. On disk an
+ * island is a mesh_bin entry of the result cache (the submesh with its
+ * UVs, no result) under its own key, sharing that cache's index and
+ * budget.
+ */
+
+#include "unwrap_cache.h"
+#include "island_cache.h"
+#include "result_cache.h"
+#include "mesh_hash.h"
+#include "logging.h"
+#include <stdlib.h>
+#include <string.h>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+/** Bump when the same island would solve differently, to orphan old entries */
+const uint64_t ISLAND_KEY_VERSION = 1;
+
+/** Smallest island written to disk by default: below it a file costs more than the solve */
+const int DEFAULT_PERSIST_FACES = 512;
+
+/** Bookkeeping charged per entry on top of its arrays */
+const long long ENTRY_OVERHEAD_BYTES = 128;
+
+/** Everything in LscmOptions that changes an island's UVs (not plans or cancellation) */
+struct IslandKeyParams {
+    int32_t solver;
+    int32_t iterative_threshold;
+    int32_t cg_max_iterations;
+    double cg_tolerance;
+    int32_t cg_preconditioner;
+    int32_t pin_method;
+    int32_t precision;
+    int32_t multigrid_coarse_vertices;
+    int32_t multigrid_smoothing;
+    int32_t method;
+    int32_t arap_iterations;
+    double arap_time_limit;
+    int32_t ordering;
+    int32_t vertex_order;
+    int32_t solver_backends;     /**< AUTO resolves differently per build */
+};
+
+struct IslandEntry {
+    uint64_t key;
+    std::vector<float> positions;
+    std::vector<int> triangles;
+    std::vector<float> uvs;      // 2 per local vertex
+    LscmReport report;
+    long long bytes;
+};
+
+bool same_island(const Mesh* island, const float* positions, const int* triangles, int num_vertices,
+                 int num_triangles) {
+    return num_vertices == island->num_vertices && num_triangles == island->num_triangles &&
+           memcmp(positions, island->vertices, (size_t)num_vertices * 3 * sizeof(float)) == 0 &&
+           memcmp(triangles, island->triangles, (size_t)num_triangles * 3 * sizeof(int)) == 0;
+}
+
+/** Identity numbering of the stored UVs */
+int emit_uvs(const float* uvs, int num_vertices, float* uvs_out, int* vertices_out) {
+    memcpy(uvs_out, uvs, (size_t)num_vertices * 2 * sizeof(float));
+    for (int i = 0; i < num_vertices; i++) vertices_out[i] = i;
+    return num_vertices;
+}
+
+class IslandCache {
+public:
+    IslandCache(long long max_bytes, int persist_faces)
+        : max_bytes_(max_bytes), persist_faces_(persist_faces == 0 ? DEFAULT_PERSIST_FACES : persist_faces),
+          total_bytes_(0), hits_(0), disk_hits_(0), misses_(0), stores_(0), disk_stores_(0), evictions_(0) {}
+
+    int lookup(uint64_t key, const Mesh* island, float* uvs_out, int* vertices_out, LscmReport* report_out) {
+        {
+            std::lock_guard<std::mutex> guard(mutex_);
+            auto it = index_.find(key);
+            if (it != index_.end()) {
+                const IslandEntry& entry = *it->second;
+                if (same_island(island, entry.positions.data(), entry.triangles.data(),
+                                (int)entry.positions.size() / 3, (int)entry.triangles.size() / 3)) {
+                    entries_.splice(entries_.begin(), entries_, it->second);
+                    *report_out = entry.report;
+                    hits_++;
+                    return emit_uvs(entry.uvs.data(), island->num_vertices, uvs_out, vertices_out);
+                }
+                LOG_WARNING("island cache: entry %016llx does not match its island", (unsigned long long)key);
+            }
+        }
+        if (persists(island)) {
+            MeshBin* bin = uvunwrap::result_cache_load_entry(key);
+            const Mesh* stored = mesh_bin_mesh(bin);
+            if (stored && stored->uvs &&
+                same_island(island, stored->vertices, stored->triangles, stored->num_vertices,
+                            stored->num_triangles)) {
+                memset(report_out, 0, sizeof(LscmReport));
+                insert(key, island, stored->uvs, *report_out);
+                int n = emit_uvs(stored->uvs, island->num_vertices, uvs_out, vertices_out);
+                free_mesh_bin(bin);
+                std::lock_guard<std::mutex> guard(mutex_);
+                disk_hits_++;
+                return n;
+            }
+            free_mesh_bin(bin);
+        }
+        std::lock_guard<std::mutex> guard(mutex_);
+        misses_++;
+        return 0;
+    }
+
+    void store(uint64_t key, const Mesh* island, const float* uvs, const int* vertices, int num_verts,
+               const LscmReport* report) {
+        // Kept by local vertex, so only a solve that placed every one of them
+        int n = island->num_vertices;
+        if (num_verts != n) return;
+        std::vector<float> local((size_t)n * 2);
+        std::vector<unsigned char> seen((size_t)n, 0);
+        for (int i = 0; i < n; i++) {
+            int v = vertices[i];
+            if (v < 0 || v >= n || seen[v]) return;
+            seen[v] = 1;
+            local[(size_t)v * 2 + 0] = uvs[i * 2 + 0];
+            local[(size_t)v * 2 + 1] = uvs[i * 2 + 1];
+        }
+
+        LscmReport kept = *report;
+        kept.assembly_ns = 0;
+        kept.factor_ns = 0;
+        kept.solve_ns = 0;
+        kept.angle_ns = 0;
+        kept.arap_ns = 0;
+        kept.peak_bytes = 0;
+        kept.plan_hit = 0;
+        insert(key, island, local.data(), kept);
+
+        if (persists(island)) {
+            Mesh stored = *island;
+            stored.uvs = local.data();
+            if (uvunwrap::result_cache_save_entry(key, &stored)) {
+                std::lock_guard<std::mutex> guard(mutex_);
+                disk_stores_++;
+            }
+        }
+    }
+
+    int clear() {
+        std::lock_guard<std::mutex> guard(mutex_);
+        int removed = (int)entries_.size();
+        entries_.clear();
+        index_.clear();
+        total_bytes_ = 0;
+        return removed;
+    }
+
+    void stats(UnwrapIslandCacheStats* out) {
+        std::lock_guard<std::mutex> guard(mutex_);
+        out->hits = hits_;
+        out->disk_hits = disk_hits_;
+        out->misses = misses_;
+        out->stores = stores_;
+        out->disk_stores = disk_stores_;
+        out->evictions = evictions_;
+        out->num_entries = (int)entries_.size();
+        out->total_bytes = total_bytes_;
+        out->max_bytes = max_bytes_;
+    }
+
+private:
+    bool persists(const Mesh* island) const {
+        return persist_faces_ > 0 && island->num_triangles >= persist_faces_;
+    }
+
+    void insert(uint64_t key, const Mesh* island, const float* uvs, const LscmReport& report) {
+        IslandEntry entry;
+        entry.key = key;
+        entry.positions.assign(island->vertices, island->vertices + (size_t)island->num_vertices * 3);
+        entry.triangles.assign(island->triangles, island->triangles + (size_t)island->num_triangles * 3);
+        entry.uvs.assign(uvs, uvs + (size_t)island->num_vertices * 2);
+        entry.report = report;
+        entry.bytes = ENTRY_OVERHEAD_BYTES + (long long)island->num_vertices * 5 * (long long)sizeof(float) +
+                      (long long)island->num_triangles * 3 * (long long)sizeof(int);
+        if (entry.bytes > max_bytes_) return;
+
+        std::lock_guard<std::mutex> guard(mutex_);
+        auto it = index_.find(key);
+        if (it != index_.end()) {
+            total_bytes_ -= it->second->bytes;
+            entries_.erase(it->second);
+            index_.erase(it);
+        }
+        total_bytes_ += entry.bytes;
+        entries_.push_front(std::move(entry));
+        index_[key] = entries_.begin();
+        stores_++;
+        while (total_bytes_ > max_bytes_) {
+            const IslandEntry& oldest = entries_.back();
+            total_bytes_ -= oldest.bytes;
+            index_.erase(oldest.key);
+            entries_.pop_back();
+            evictions_++;
+        }
+    }
+
+    long long max_bytes_;
+    int persist_faces_;
+    std::mutex mutex_;
+    std::list<IslandEntry> entries_;  // most recently used first
+    std::unordered_map<uint64_t, std::list<IslandEntry>::iterator> index_;
+    long long total_bytes_;
+    long long hits_;
+    long long disk_hits_;
+    long long misses_;
+    long long stores_;
+    long long disk_stores_;
+    long long evictions_;
+};
+
+std::mutex g_config_mutex;
+std::shared_ptr<IslandCache> g_cache;
+bool g_configured = false;
+
+std::shared_ptr<IslandCache> current_cache() {
+    std::lock_guard<std::mutex> guard(g_config_mutex);
+    if (!g_configured) {
+        g_configured = true;
+        const char* budget = getenv("UVUNWRAP_ISLAND_CACHE_MAX_BYTES");
+        if (budget && atoll(budget) > 0) g_cache = std::make_shared<IslandCache>(atoll(budget), 0);
+    }
+    return g_cache;
+}
+
+} // namespace
+
+namespace uvunwrap {
+
+uint64_t island_cache_key(const Mesh* island, const LscmOptions* options) {
+    if (!current_cache()) return 0;
+
+    IslandKeyParams p;
+    memset(&p, 0, sizeof(p));
+    p.solver = options->solver;
+    p.iterative_threshold = options->iterative_threshold;
+    p.cg_max_iterations = options->cg_max_iterations;
+    p.cg_tolerance = options->cg_tolerance;
+    p.cg_preconditioner = options->cg_preconditioner;
+    p.pin_method = options->pin_method;
+    p.precision = options->precision;
+    p.multigrid_coarse_vertices = options->multigrid_coarse_vertices;
+    p.multigrid_smoothing = options->multigrid_smoothing;
+    p.method = options->method;
+    p.arap_iterations = options->arap_iterations;
+    p.arap_time_limit = options->arap_time_limit;
+    p.ordering = options->ordering;
+    p.vertex_order = options->vertex_order;
+    p.solver_backends = lscm_solver_available(LSCM_SOLVER_CHOLMOD) |
+                        lscm_solver_available(LSCM_SOLVER_PARDISO) << 1 |
+                        lscm_ordering_available(LSCM_ORDERING_METIS) << 2;
+
+    // Only CG starts from the existing UVs; elsewhere they would tie every
+    // island to the previous packing of the whole mesh
+    uint64_t parts[4];
+    parts[0] = uv_hash_bytes(&p, sizeof(p), ISLAND_KEY_VERSION, 1);
+    parts[1] = uv_mesh_hash(island, 1);
+    parts[2] = options->initial_uvs && options->solver == LSCM_SOLVER_CG
+                   ? uv_hash_bytes(options->initial_uvs, (size_t)island->num_vertices * 2 * sizeof(float),
+                                   ISLAND_KEY_VERSION, 1)
+                   : 0;
+    parts[3] = options->pinned_vertices
+                   ? uv_hash_bytes(options->pinned_vertices,
+                                   (size_t)options->num_pinned_vertices * sizeof(int), ISLAND_KEY_VERSION, 1) | 1
+                   : 0;
+    uint64_t key = uv_hash_bytes(parts, sizeof(parts), ISLAND_KEY_VERSION, 1);
+    return key == 0 ? 1 : key;
+}
+
+int island_cache_lookup(uint64_t key, const Mesh* island, float* uvs_out, int* vertices_out,
+                        LscmReport* report_out) {
+    if (key == 0) return 0;
+    std::shared_ptr<IslandCache> cache = current_cache();
+    return cache ? cache->lookup(key, island, uvs_out, vertices_out, report_out) : 0;
+}
+
+void island_cache_store(uint64_t key, const Mesh* island, const float* uvs, const int* vertices, int num_verts,
+                        const LscmReport* report) {
+    if (key == 0 || num_verts <= 0) return;
+    std::shared_ptr<IslandCache> cache = current_cache();
+    if (cache) cache->store(key, island, uvs, vertices, num_verts, report);
+}
+
+} // namespace uvunwrap
+
+int unwrap_island_cache_configure(long long max_bytes, int persist_faces) {
+    if (max_bytes < 0) return -1;
+    std::lock_guard<std::mutex> guard(g_config_mutex);
+    g_configured = true;
+    if (max_bytes > 0) {
+        g_cache = std::make_shared<IslandCache>(max_bytes, persist_faces);
+    } else {
+        g_cache.reset();
+    }
+    return 0;
+}
+
+int unwrap_island_cache_stats(UnwrapIslandCacheStats* stats_out) {
+    std::shared_ptr<IslandCache> cache = current_cache();
+    if (stats_out) {
+        memset(stats_out, 0, sizeof(*stats_out));
+        if (cache) cache->stats(stats_out);
+    }
+    return cache ? 0 : -1;
+}
+
+int unwrap_island_cache_clear(void) {
+    std::shared_ptr<IslandCache> cache = current_cache();
+    return cache ? cache->clear() : -1;
+}
@@ -0,0 +1,43 @@
+/**
+ * @file island_cache.h
+ * @brief Internal hooks the island solves use to reach the island cache
+ *
+ * Not part of the public API; see unwrap_cache.h. Every function works on
+ * the compact submesh of one island (IslandMeshes::view()), in its local
+ * vertex numbering.
+ */
+
+#ifndef UVUNWRAP_ISLAND_CACHE_H
+#define UVUNWRAP_ISLAND_CACHE_H
+
+#include "mesh.h"
+#include "lscm.h"
+#include <stdint.h>
+
+namespace uvunwrap {
+
+/**
+ * @brief Key of one island solve: the submesh and everything in options
+ *        that changes its UVs
+ * @param options The island's options, pins and initial_uvs already local
+ * @return The key, or 0 when the island cache is off
+ */
+uint64_t island_cache_key(const Mesh* island, const LscmOptions* options);
+
+/**
+ * @brief UVs an earlier solve of the same island gave
+ * @param uvs_out, vertices_out One entry per island vertex
+ * @param report_out That solve's report with its timings and memory
+ *        zeroed (all zero for an island read from disk)
+ * @return Vertices written, or 0 on a miss
+ */
+int island_cache_lookup(uint64_t key, const Mesh* island, float* uvs_out, int* vertices_out,
+                        LscmReport* report_out);
+
+/** Remember a solve of island (vertices local); no-op for key 0 or a partial solve */
+void island_cache_store(uint64_t key, const Mesh* island, const float* uvs, const int* vertices, int num_verts,
+                        const LscmReport* report);
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_ISLAND_CACHE_H */
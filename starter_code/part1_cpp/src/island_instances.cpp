@@ -0,0 +1,157 @@
+/**
+ * @file island_instances.cpp
+ * @brief Detection of islands that are copies of one another
+ *
+ * Kitbashed assets repeat the same part (bolts, tiles, windows) many
+ * times, each copy an island of its own with the same triangles in the
+ * same order. LSCM only sees a triangle's shape through its edge lengths
+ * and the corner order, and normalises every island to the unit square,
+ * so copies moved, mirrored or scaled solve to the same UVs.
+ */
+
+#include "island_instances.h"
+#include <math.h>
+#include <stdint.h>
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+namespace uvunwrap {
+
+namespace {
+
+// Edge lengths of copies agree to this fraction of the longest edge
+const double EDGE_TOLERANCE = 1e-6;
+
+/** Island triangles in first-seen local numbering, and their edge lengths */
+struct IslandShape {
+    int num_verts;
+    std::vector<int> local_tris;
+    std::vector<double> lengths;
+    double longest;
+    double signature;  /**< Mean edge length over the longest: the same for copies */
+};
+
+void island_shape(const Mesh* mesh, const int* faces, int num_faces, std::unordered_map<int, int>& remap,
+                  IslandShape& shape) {
+    remap.clear();
+    shape.local_tris.resize((size_t)num_faces * 3);
+    shape.lengths.resize((size_t)num_faces * 3);
+    shape.longest = 0.0;
+    for (int i = 0; i < num_faces; i++) {
+        const int* tri = &mesh->triangles[faces[i] * 3];
+        for (int k = 0; k < 3; k++) {
+            std::pair<std::unordered_map<int, int>::iterator, bool> it =
+                remap.insert(std::make_pair(tri[k], (int)remap.size()));
+            shape.local_tris[i * 3 + k] = it.first->second;
+            const float* a = &mesh->vertices[tri[k] * 3];
+            const float* b = &mesh->vertices[tri[(k + 1) % 3] * 3];
+            double dx = (double)b[0] - a[0], dy = (double)b[1] - a[1], dz = (double)b[2] - a[2];
+            double length = sqrt(dx * dx + dy * dy + dz * dz);
+            shape.lengths[i * 3 + k] = length;
+            shape.longest = std::max(shape.longest, length);
+        }
+    }
+    shape.num_verts = (int)remap.size();
+    double sum = 0.0;
+    for (size_t i = 0; i < shape.lengths.size(); i++) sum += shape.lengths[i];
+    shape.signature = shape.longest > 0.0 ? sum / (shape.longest * (double)shape.lengths.size()) : 0.0;
+}
+
+uint64_t topology_hash(const IslandShape& shape) {
+    uint64_t h = 1469598103934665603ULL;
+    h = (h ^ (uint32_t)shape.num_verts) * 1099511628211ULL;
+    for (size_t i = 0; i < shape.local_tris.size(); i++) {
+        h = (h ^ (uint32_t)shape.local_tris[i]) * 1099511628211ULL;
+    }
+    return h;
+}
+
+bool same_shape(const IslandShape& a, const IslandShape& b) {
+    if (!(a.longest > 0.0) || !(b.longest > 0.0)) return false;
+    if (!(fabs(a.signature - b.signature) <= EDGE_TOLERANCE)) return false;
+    if (a.num_verts != b.num_verts || a.local_tris != b.local_tris) return false;
+    double scale = a.longest / b.longest;
+    for (size_t i = 0; i < a.lengths.size(); i++) {
+        if (!(fabs(a.lengths[i] - b.lengths[i] * scale) <= EDGE_TOLERANCE * a.longest)) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int find_island_instances(const Mesh* mesh,
+                          const int* candidates,
+                          int num_candidates,
+                          const int* const* faces,
+                          const int* num_faces,
+                          int* instance_of) {
+    std::unordered_map<int, int> remap;
+    IslandShape shape;
+    // Islands are bucketed by topology hash; rounding the geometry into a
+    // hash would split copies whose lengths straddle a rounding step, so
+    // the scale-free signature is compared within a bucket instead.
+    // (hash, position in candidates): sorting keeps candidate order within a hash
+    std::vector<std::pair<uint64_t, int> > keys((size_t)num_candidates);
+    for (int c = 0; c < num_candidates; c++) {
+        int island = candidates[c];
+        instance_of[island] = -1;
+        island_shape(mesh, faces[island], num_faces[island], remap, shape);
+        keys[c] = std::make_pair(topology_hash(shape), c);
+    }
+    std::sort(keys.begin(), keys.end());
+
+    int num_instances = 0;
+    std::vector<IslandShape> representatives;
+    std::vector<int> representative_ids;
+    for (size_t begin = 0; begin < keys.size();) {
+        size_t end = begin + 1;
+        while (end < keys.size() && keys[end].first == keys[begin].first) end++;
+        if (end - begin > 1) {
+            // Usually one class per bucket; other geometry starts another
+            representatives.clear();
+            representative_ids.clear();
+            for (size_t k = begin; k < end; k++) {
+                int island = candidates[keys[k].second];
+                island_shape(mesh, faces[island], num_faces[island], remap, shape);
+                size_t r = 0;
+                while (r < representatives.size() && !same_shape(representatives[r], shape)) r++;
+                if (r < representatives.size()) {
+                    instance_of[island] = representative_ids[r];
+                    num_instances++;
+                } else {
+                    representatives.push_back(shape);
+                    representative_ids.push_back(island);
+                }
+            }
+        }
+        begin = end;
+    }
+    return num_instances;
+}
+
+int copy_instance_uvs(const Mesh* mesh,
+                      const int* representative_faces,
+                      const int* instance_faces,
+                      int num_faces,
+                      const float* uvs,
+                      const int* vertices,
+                      int num_verts,
+                      float* uvs_out,
+                      int* vertices_out) {
+    std::unordered_map<int, int> corresponding;
+    corresponding.reserve((size_t)num_verts);
+    for (int i = 0; i < num_faces; i++) {
+        const int* from = &mesh->triangles[representative_faces[i] * 3];
+        const int* to = &mesh->triangles[instance_faces[i] * 3];
+        for (int k = 0; k < 3; k++) corresponding.insert(std::make_pair(from[k], to[k]));
+    }
+    for (int i = 0; i < num_verts; i++) {
+        vertices_out[i] = corresponding[vertices[i]];
+        uvs_out[2 * i + 0] = uvs[2 * i + 0];
+        uvs_out[2 * i + 1] = uvs[2 * i + 1];
+    }
+    return num_verts;
+}
+
+} // namespace uvunwrap
@@ -0,0 +1,65 @@
+/**
+ * @file island_instances.h
+ * @brief Internal detection of islands that are copies of one another
+ *
+ * Not part of the public API; used by unwrap_mesh_ctx() for
+ * UnwrapParams::island_instancing.
+ */
+
+#ifndef UVUNWRAP_ISLAND_INSTANCES_H
+#define UVUNWRAP_ISLAND_INSTANCES_H
+
+#include "mesh.h"
+
+namespace uvunwrap {
+
+/**
+ * @brief Group candidate islands into classes of copies
+ *
+ * Two islands are copies when their faces, listed in island order, have
+ * the same corners in first-seen vertex numbering (bucketed by a hash of
+ * that topology) and the same edge lengths up to one uniform scale
+ * (screened by a scale-free length signature, then checked edge by edge),
+ * so any rigid motion, mirror or scale of a part matches. Such islands
+ * have the same LSCM system, so one solve serves the whole class.
+ *
+ * @param candidates Island ids to consider; the first of each class in
+ *        this order becomes its representative
+ * @param faces Face list of each island (indexed by island id)
+ * @param num_faces Face count of each island
+ * @param instance_of Output, indexed by island id and only written for
+ *        candidates: the representative, or -1 for a representative or an
+ *        island without copies
+ * @return Number of candidates that are instances
+ */
+int find_island_instances(const Mesh* mesh,
+                          const int* candidates,
+                          int num_candidates,
+                          const int* const* faces,
+                          const int* num_faces,
+                          int* instance_of);
+
+/**
+ * @brief Give an instance its representative's solved UVs
+ *
+ * Corners of the two face lists correspond one to one, so each solved
+ * vertex of the representative maps to the instance vertex at the same
+ * corners.
+ *
+ * @param uvs, vertices, num_verts The representative's solve output
+ * @param uvs_out, vertices_out The instance's buffers (num_verts entries)
+ * @return num_verts
+ */
+int copy_instance_uvs(const Mesh* mesh,
+                      const int* representative_faces,
+                      const int* instance_faces,
+                      int num_faces,
+                      const float* uvs,
+                      const int* vertices,
+                      int num_verts,
+                      float* uvs_out,
+                      int* vertices_out);
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_ISLAND_INSTANCES_H */
@@ -0,0 +1,149 @@
+/**
+ * @file island_mesh.cpp
+ * @brief Compact per-island submeshes (see island_mesh.h)
+ */
+
+#include "island_mesh.h"
+#include "parallel.h"
+#include <string.h>
+#include <type_traits>
+
+namespace uvunwrap {
+
+namespace {
+
+// Islands per worker before the build goes parallel
+const int ISLANDS_PER_THREAD = 64;
+
+} // namespace
+
+void IslandMeshes::build(const Mesh* mesh, int num_islands, const int* const* faces, const int* num_faces,
+                         int num_threads) {
+    int V = mesh->num_vertices;
+    int threads = choose_thread_count(num_islands, num_threads, ISLANDS_PER_THREAD);
+    vertex_offsets_.assign((size_t)num_islands + 1, 0);
+    num_faces_.assign(num_faces, num_faces + num_islands);
+    nodes_.assign((size_t)num_islands, 0);
+
+    // 1. Vertices per island. A stamp holds the last island that saw the
+    //    vertex, so it needs no clearing between islands
+    std::vector<std::vector<int> > stamps((size_t)threads);
+    parallel_for_dynamic(num_islands, threads, [&](int t, int island) {
+        std::vector<int>& stamp = stamps[t];
+        if (stamp.empty()) stamp.assign((size_t)V, -1);
+        int count = 0;
+        for (int i = 0; i < num_faces[island]; i++) {
+            const int* tri = &mesh->triangles[faces[island][i] * 3];
+            for (int j = 0; j < 3; j++) {
+                if (stamp[tri[j]] == island) continue;
+                stamp[tri[j]] = island;
+                count++;
+            }
+        }
+        vertex_offsets_[island + 1] = count;
+    });
+
+    index_offsets_.resize((size_t)num_islands);
+    size_t narrow = 0, wide_indices = 0;
+    for (int island = 0; island < num_islands; island++) {
+        vertex_offsets_[island + 1] += vertex_offsets_[island];
+        size_t count = (size_t)num_faces[island] * 3;
+        if (wide(island)) {
+            index_offsets_[island] = wide_indices;
+            wide_indices += count;
+        } else {
+            index_offsets_[island] = narrow;
+            narrow += count;
+        }
+    }
+    vertices_.resize((size_t)vertex_offsets_[num_islands]);
+    positions_.resize(vertices_.size() * 3);
+    indices16_.resize(narrow);
+    indices32_.resize(wide_indices);
+
+    // 2. Number each island's vertices in first-use order and write its
+    //    positions and local triangles
+    std::vector<std::vector<int> > locals((size_t)threads);
+    for (size_t t = 0; t < stamps.size(); t++) {
+        if (!stamps[t].empty()) stamps[t].assign((size_t)V, -1);
+    }
+    parallel_for_dynamic(num_islands, threads, [&](int t, int island) {
+        std::vector<int>& stamp = stamps[t];
+        std::vector<int>& local = locals[t];
+        if (stamp.empty()) stamp.assign((size_t)V, -1);
+        if (local.empty()) local.resize((size_t)V);
+        int base = vertex_offsets_[island];
+        int n = 0;
+        nodes_[island] = numa_current_node();
+        auto fill = [&](auto* tris) {
+            typedef typename std::remove_pointer<decltype(tris)>::type Index;
+            for (int i = 0; i < num_faces[island]; i++) {
+                const int* tri = &mesh->triangles[faces[island][i] * 3];
+                for (int j = 0; j < 3; j++) {
+                    int v = tri[j];
+                    if (stamp[v] != island) {
+                        stamp[v] = island;
+                        local[v] = n;
+                        vertices_[base + n] = v;
+                        memcpy(&positions_[(size_t)(base + n) * 3], &mesh->vertices[(size_t)v * 3],
+                               3 * sizeof(float));
+                        n++;
+                    }
+                    tris[i * 3 + j] = (Index)local[v];
+                }
+            }
+        };
+        if (wide(island)) {
+            fill(indices32_.data() + index_offsets_[island]);
+        } else {
+            fill(indices16_.data() + index_offsets_[island]);
+        }
+    });
+}
+
+void IslandMeshes::view(int island, std::vector<int>& tris, Mesh* out) const {
+    int count = num_faces(island) * 3;
+    tris.resize((size_t)count);
+    with_triangles(island, [&](const auto* local) {
+        for (int i = 0; i < count; i++) tris[i] = (int)local[i];
+    });
+    out->vertices = const_cast<float*>(positions(island));
+    out->num_vertices = num_vertices(island);
+    out->triangles = tris.data();
+    out->num_triangles = num_faces(island);
+    out->uvs = NULL;
+}
+
+void IslandMeshes::gather_uvs(int island, const float* uvs, std::vector<float>& out) const {
+    int n = num_vertices(island);
+    const int* global = vertices(island);
+    out.resize((size_t)n * 2);
+    for (int i = 0; i < n; i++) {
+        out[i * 2 + 0] = uvs[global[i] * 2 + 0];
+        out[i * 2 + 1] = uvs[global[i] * 2 + 1];
+    }
+}
+
+void IslandMeshes::local_pins(int island, const int* pins, int num_pins, int mesh_vertices, int* remap,
+                              std::vector<int>& out) const {
+    out.clear();
+    if (!pins || num_pins <= 0) return;
+    int n = num_vertices(island);
+    const int* global = vertices(island);
+    for (int i = 0; i < n; i++) remap[global[i]] = i;
+    for (int p = 0; p < num_pins; p++) {
+        int v = pins[p];
+        if (v >= 0 && v < mesh_vertices && remap[v] >= 0) out.push_back(remap[v]);
+    }
+    for (int i = 0; i < n; i++) remap[global[i]] = -1;
+}
+
+long long IslandMeshes::bytes() const {
+    return (long long)(vertex_offsets_.capacity() * sizeof(int) + vertices_.capacity() * sizeof(int) +
+                       positions_.capacity() * sizeof(float) +
+                       (num_faces_.capacity() + nodes_.capacity()) * sizeof(int) +
+                       index_offsets_.capacity() * sizeof(size_t) + indices16_.capacity() * sizeof(uint16_t) +
+                       indices32_.capacity() * sizeof(uint32_t));
+}
+
+} // namespace uvunwrap
@@ -0,0 +1,102 @@
+/**
+ * @file island_mesh.h
+ * @brief Internal compact submeshes of every island of a mesh
+ *
+ * Not part of the public API. All islands share a few contiguous arrays:
+ * each island's vertices (mesh indices, in the order its faces first use
+ * them), their interleaved xyz positions, and its triangles in
+ * island-local indices, 16-bit for islands of up to 65536 vertices and
+ * 32-bit above. Everything is gathered in one pass after island
+ * extraction; a stage then streams one dense block per island instead of
+ * gathering through the whole mesh, and the local numbering is the one
+ * lscm_solve() gives the island in place, so solving the submesh gives the
+ * same UVs.
+ */
+
+#ifndef UVUNWRAP_ISLAND_MESH_H
+#define UVUNWRAP_ISLAND_MESH_H
+
+#include "mesh.h"
+#include "numa.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace uvunwrap {
+
+class IslandMeshes {
+public:
+    /** Largest island that stores 16-bit triangles */
+    static const int MAX_NARROW_VERTICES = 65536;
+
+    IslandMeshes() {}
+
+    /**
+     * @brief Build the submeshes of num_islands face lists
+     *
+     * Islands may share mesh vertices; each gets copies of its own.
+     * An island of no faces is empty.
+     */
+    void build(const Mesh* mesh, int num_islands, const int* const* faces, const int* num_faces,
+               int num_threads);
+
+    int num_islands() const { return (int)vertex_offsets_.size() - 1; }
+    int num_vertices(int island) const { return vertex_offsets_[island + 1] - vertex_offsets_[island]; }
+    int num_faces(int island) const { return num_faces_[island]; }
+
+    /** Mesh vertex of each local vertex */
+    const int* vertices(int island) const { return vertices_.data() + vertex_offsets_[island]; }
+
+    /** xyz of each local vertex */
+    const float* positions(int island) const { return positions_.data() + (size_t)vertex_offsets_[island] * 3; }
+
+    bool wide(int island) const { return num_vertices(island) > MAX_NARROW_VERTICES; }
+
+    /** NUMA node of the worker that wrote the island's arrays (first touch put them there) */
+    int node(int island) const { return nodes_[island]; }
+
+    /** Calls fn(tris) with the island's 3 * num_faces local indices, uint16_t* or uint32_t* */
+    template <typename Fn>
+    void with_triangles(int island, Fn&& fn) const {
+        if (wide(island)) {
+            fn(indices32_.data() + index_offsets_[island]);
+        } else {
+            fn(indices16_.data() + index_offsets_[island]);
+        }
+    }
+
+    /**
+     * @brief Mesh view of one island for code that takes a Mesh
+     *
+     * Triangles are widened into tris; out->uvs is left NULL.
+     */
+    void view(int island, std::vector<int>& tris, Mesh* out) const;
+
+    /** Gather per-vertex mesh UVs into out (2 per local vertex) */
+    void gather_uvs(int island, const float* uvs, std::vector<float>& out) const;
+
+    /**
+     * @brief Local indices of the pins that lie in the island, in pin order
+     * @param remap All -1 scratch of mesh->num_vertices entries, restored
+     */
+    void local_pins(int island, const int* pins, int num_pins, int mesh_vertices, int* remap,
+                    std::vector<int>& out) const;
+
+    /** Bytes held by the arrays */
+    long long bytes() const;
+
+private:
+    // The per-island runs are first touched by the worker that fills them
+    std::vector<int> vertex_offsets_;
+    FirstTouchVector<int> vertices_;
+    FirstTouchVector<float> positions_;
+    std::vector<int> num_faces_;
+    std::vector<int> nodes_;
+    std::vector<size_t> index_offsets_;  // into indices32_ if wide(), else indices16_
+    FirstTouchVector<uint16_t> indices16_;
+    FirstTouchVector<uint32_t> indices32_;
+};
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_ISLAND_MESH_H */
@@ -0,0 +1,72 @@
+/**
+ * @file island_solver.h
+ * @brief Internal hook that hands the island solves of unwrap_mesh to
+ *        someone else (the cluster coordinator)
+ *
+ * Not part of the public API. Topology, seams, islands, packing and
+ * metrics stay in the calling process; only the per-island LSCM solves
+ * move. Every island must come back exactly as lscm_parameterize_into()
+ * would have produced it here, so the output matches a local run.
+ */
+
+#ifndef UVUNWRAP_ISLAND_SOLVER_H
+#define UVUNWRAP_ISLAND_SOLVER_H
+
+#include "unwrap.h"
+#include "mesh_view.h"
+#include "lscm.h"
+#include "island_mesh.h"
+#include <functional>
+
+namespace uvunwrap {
+
+/**
+ * @brief The islands of one unwrap call to solve
+ *
+ * order lists the count islands to solve, largest first. Every other
+ * array is indexed by island id: faces and num_faces are the faces to
+ * solve (degenerate ones already left out); uvs and vertices have room for
+ * 3 * num_faces vertices; num_verts, reports and solve_ns are outputs,
+ * num_verts -1 for an island that failed. meshes holds the compact
+ * submesh of every island to solve.
+ */
+struct IslandSolveBatch {
+    int count;
+    const int* order;
+    const int* const* faces;
+    const int* num_faces;
+    float* const* uvs;
+    int* const* vertices;
+    int* num_verts;
+    LscmReport* reports;
+    long long* solve_ns;
+    const IslandMeshes* meshes;
+};
+
+class IslandSolver {
+public:
+    virtual ~IslandSolver() {}
+
+    /**
+     * @brief Solve every island of the batch
+     * @param options The options a local solve would use (initial_uvs and
+     *        pinned_vertices are indexed by mesh vertex)
+     * @param island_done Called once per finished island, from any thread;
+     *        returns true once the call is cancelled
+     */
+    virtual void solve(const Mesh* mesh, const UnwrapParams* params, const LscmOptions* options,
+                       const IslandSolveBatch& batch, const std::function<bool(int)>& island_done) = 0;
+};
+
+/**
+ * @brief unwrap_mesh_ctx() with the island solves handed to solver
+ *        (NULL = solved on the context's own threads)
+ * @param view Optional MeshView of mesh whose face flags, topology and
+ *        seams are used (and memoised) instead of building throwaway ones
+ */
+Mesh* unwrap_mesh_with_solver(UnwrapContext* ctx, const Mesh* mesh, const UnwrapParams* params,
+                              IslandSolver* solver, UnwrapResult** result_out, MeshView* view = NULL);
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_ISLAND_SOLVER_H */
@@ -0,0 +1,128 @@
+/**
+ * @file island_transform.cpp
+ * @brief One gather, transform and scatter per island
+ *
+ * A worker copies an island's UVs into its own u and v buffers, applying
+ * the minimum-area turn on the way (it needs double), runs the float
+ * steps on whole lanes and scatters the result back. The build turns off
+ * FMA contraction here, so the lanes round exactly as the per-step loops
+ * they replace did.
+ */
+
+#include "island_transform.h"
+#include "simd.h"
+#include "parallel.h"
+#include "trace.h"
+#include <math.h>
+#include <vector>
+
+namespace uvunwrap {
+
+namespace {
+
+const int MIN_VERTICES_PER_THREAD = 32768;
+
+typedef Lanes::V V;
+
+/** Island-local SoA buffers of one worker */
+struct TransformScratch {
+    std::vector<float> u, v;
+};
+
+/** Steps 2 and 3 of IslandTransform on n SoA points */
+void transform_run(const IslandTransform& t, float* u, float* v, int n) {
+    bool tiled = t.tile_u != 0.0f || t.tile_v != 0.0f;
+    int i = 0;
+    V min_u = Lanes::set1(t.min_u), min_v = Lanes::set1(t.min_v), height = Lanes::set1(t.height);
+    V add_u = Lanes::set1(t.add_u), add_v = Lanes::set1(t.add_v);
+    V sub_u = Lanes::set1(t.sub_u), sub_v = Lanes::set1(t.sub_v);
+    V scale = Lanes::set1(t.scale), tile_u = Lanes::set1(t.tile_u), tile_v = Lanes::set1(t.tile_v);
+    for (; i + Lanes::N <= n; i += Lanes::N) {
+        V x = Lanes::load(u + i), y = Lanes::load(v + i);
+        if (t.rotate_90) {
+            V lx = Lanes::sub(x, min_u), ly = Lanes::sub(y, min_v);
+            x = Lanes::add(min_u, Lanes::sub(height, ly));
+            y = Lanes::add(min_v, lx);
+        }
+        x = Lanes::mul(Lanes::sub(Lanes::add(x, add_u), sub_u), scale);
+        y = Lanes::mul(Lanes::sub(Lanes::add(y, add_v), sub_v), scale);
+        if (tiled) {
+            x = Lanes::add(x, tile_u);
+            y = Lanes::add(y, tile_v);
+        }
+        Lanes::store(u + i, x);
+        Lanes::store(v + i, y);
+    }
+    for (; i < n; i++) {
+        float x = u[i], y = v[i];
+        if (t.rotate_90) {
+            float lx = x - t.min_u, ly = y - t.min_v;
+            x = t.min_u + (t.height - ly);
+            y = t.min_v + lx;
+        }
+        x = ((x + t.add_u) - t.sub_u) * t.scale;
+        y = ((y + t.add_v) - t.sub_v) * t.scale;
+        if (tiled) {
+            x += t.tile_u;
+            y += t.tile_v;
+        }
+        u[i] = x;
+        v[i] = y;
+    }
+}
+
+} // namespace
+
+IslandTransform identity_transform() {
+    IslandTransform t;
+    t.angle = 0.0;
+    t.rotate_90 = false;
+    t.min_u = t.min_v = t.height = 0.0f;
+    t.add_u = t.add_v = 0.0f;
+    t.sub_u = t.sub_v = 0.0f;
+    t.scale = 1.0f;
+    t.tile_u = t.tile_v = 0.0f;
+    return t;
+}
+
+void transform_islands(float* uvs, const int* vertex_offsets, const int* vertices, int num_islands,
+                       const IslandTransform* transforms, int num_threads) {
+    if (num_islands <= 0) return;
+    UV_TRACE_ZONE("island transforms");
+    int threads = choose_thread_count(vertex_offsets[num_islands], num_threads, MIN_VERTICES_PER_THREAD);
+    std::vector<TransformScratch> scratch((size_t)threads);
+
+    parallel_for_dynamic(num_islands, threads, [&](int worker, int i) {
+        TransformScratch& s = scratch[worker];
+        const IslandTransform& t = transforms[i];
+        const int* first = vertices + vertex_offsets[i];
+        int n = vertex_offsets[i + 1] - vertex_offsets[i];
+        bool moves = t.rotate_90 || t.add_u != 0.0f || t.add_v != 0.0f || t.sub_u != 0.0f || t.sub_v != 0.0f ||
+                     t.scale != 1.0f || t.tile_u != 0.0f || t.tile_v != 0.0f;
+        if (n <= 0 || (!moves && t.angle == 0.0)) return;
+        s.u.resize((size_t)n);
+        s.v.resize((size_t)n);
+        if (t.angle != 0.0) {
+            double c = cos(t.angle), sn = sin(t.angle);
+            for (int k = 0; k < n; k++) {
+                double u = uvs[first[k] * 2 + 0], w = uvs[first[k] * 2 + 1];
+                s.u[k] = (float)(c * u - sn * w);
+                s.v[k] = (float)(sn * u + c * w);
+            }
+        } else {
+            for (int k = 0; k < n; k++) {
+                s.u[k] = uvs[first[k] * 2 + 0];
+                s.v[k] = uvs[first[k] * 2 + 1];
+            }
+        }
+
+        if (moves) transform_run(t, s.u.data(), s.v.data(), n);
+
+        for (int k = 0; k < n; k++) {
+            uvs[first[k] * 2 + 0] = s.u[k];
+            uvs[first[k] * 2 + 1] = s.v[k];
+        }
+    });
+}
+
+} // namespace uvunwrap
@@ -0,0 +1,55 @@
+/**
+ * @file island_transform.h
+ * @brief Internal fused write of packed island UVs
+ *
+ * Not part of the public API; used by packing.cpp. The packers only
+ * compute where each island goes; transform_islands() then moves every
+ * island's vertices there in one gather, SIMD transform and scatter per
+ * island, islands spread over worker threads, instead of one pass over
+ * the UVs per step (minimum-area turn, 90° turn, offset, sheet scale).
+ */
+
+#ifndef UVUNWRAP_ISLAND_TRANSFORM_H
+#define UVUNWRAP_ISLAND_TRANSFORM_H
+
+namespace uvunwrap {
+
+/**
+ * @brief Where the vertices of one island go
+ *
+ * Applied in order to each (u, v):
+ * 1. turn by angle about the origin, in double (skipped when 0);
+ * 2. if rotate_90, turn 90° counter-clockwise inside the box at
+ *    (min_u, min_v) whose height before the turn is height;
+ * 3. u' = ((u + add_u) - sub_u) * scale + tile_u, likewise for v (the
+ *    tile term is skipped when both tile offsets are 0).
+ * Each step rounds as the scalar float expression does.
+ */
+struct IslandTransform {
+    double angle;
+    bool rotate_90;
+    float min_u, min_v, height;
+    float add_u, add_v;
+    float sub_u, sub_v;
+    float scale;
+    float tile_u, tile_v;
+};
+
+/** The identity: no turn, no offset, scale 1 */
+IslandTransform identity_transform();
+
+/**
+ * @brief Transform every island of a CSR vertex list in place
+ * @param uvs Interleaved mesh UVs
+ * @param vertex_offsets num_islands + 1 offsets into vertices
+ * @param vertices Vertex indices of each island, back to back; an index
+ *        may appear in one island only
+ * @param transforms num_islands transforms
+ * @param num_threads Worker threads (0 = automatic by vertex count)
+ */
+void transform_islands(float* uvs, const int* vertex_offsets, const int* vertices, int num_islands,
+                       const IslandTransform* transforms, int num_threads);
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_ISLAND_TRANSFORM_H */
@@ -0,0 +1,383 @@
+/**
+ * @file json.cpp
+ * @brief JSON parser and writer (see json.h)
+ *
+ * Strict RFC 8259 syntax. Numbers are converted without the C locale
+ * functions, so a host locale with a decimal comma does not change them.
+ */
+
+#include "json.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace uvunwrap {
+
+namespace {
+
+/** Nesting depth past which a document is rejected instead of recursing */
+const int JSON_MAX_DEPTH = 256;
+
+void append_utf8(unsigned code, std::string* out) {
+    if (code < 0x80) {
+        out->push_back((char)code);
+    } else if (code < 0x800) {
+        out->push_back((char)(0xC0 | (code >> 6)));
+        out->push_back((char)(0x80 | (code & 0x3F)));
+    } else if (code < 0x10000) {
+        out->push_back((char)(0xE0 | (code >> 12)));
+        out->push_back((char)(0x80 | ((code >> 6) & 0x3F)));
+        out->push_back((char)(0x80 | (code & 0x3F)));
+    } else {
+        out->push_back((char)(0xF0 | (code >> 18)));
+        out->push_back((char)(0x80 | ((code >> 12) & 0x3F)));
+        out->push_back((char)(0x80 | ((code >> 6) & 0x3F)));
+        out->push_back((char)(0x80 | (code & 0x3F)));
+    }
+}
+
+void write_string(const std::string& s, std::string* out) {
+    static const char HEX[] = "0123456789abcdef";
+    out->push_back('"');
+    for (size_t i = 0; i < s.size(); i++) {
+        unsigned char c = (unsigned char)s[i];
+        switch (c) {
+            case '"': out->append("\\\""); break;
+            case '\\': out->append("\\\\"); break;
+            case '\n': out->append("\\n"); break;
+            case '\r': out->append("\\r"); break;
+            case '\t': out->append("\\t"); break;
+            default:
+                if (c < 0x20) {
+                    out->append("\\u00");
+                    out->push_back(HEX[c >> 4]);
+                    out->push_back(HEX[c & 15]);
+                } else {
+                    out->push_back((char)c);
+                }
+        }
+    }
+    out->push_back('"');
+}
+
+} // namespace
+
+class JsonParser {
+public:
+    JsonParser(const char* text, size_t size) : begin_(text), p_(text), end_(text + size) {}
+
+    bool document(JsonValue* out, std::string* error) {
+        bool ok = value(out, 0);
+        skip_space();
+        if (ok && p_ != end_) ok = fail("trailing characters");
+        if (!ok && error) {
+            char where[64];
+            snprintf(where, sizeof(where), " at offset %zu", (size_t)(p_ - begin_));
+            *error = error_ + where;
+        }
+        return ok;
+    }
+
+private:
+    const char* begin_;
+    const char* p_;
+    const char* end_;
+    std::string error_;
+
+    bool fail(const char* message) {
+        if (error_.empty()) error_ = message;
+        return false;
+    }
+
+    void skip_space() {
+        while (p_ < end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r')) p_++;
+    }
+
+    bool literal(const char* word) {
+        size_t n = strlen(word);
+        if ((size_t)(end_ - p_) < n || memcmp(p_, word, n) != 0) return fail("invalid literal");
+        p_ += n;
+        return true;
+    }
+
+    bool value(JsonValue* out, int depth) {
+        if (depth > JSON_MAX_DEPTH) return fail("nesting too deep");
+        skip_space();
+        if (p_ == end_) return fail("unexpected end");
+        switch (*p_) {
+            case '{': return object(out, depth);
+            case '[': return array(out, depth);
+            case '"':
+                out->type_ = JsonValue::STRING;
+                return string(&out->text_);
+            case 't':
+                *out = JsonValue::boolean(true);
+                return literal("true");
+            case 'f':
+                *out = JsonValue::boolean(false);
+                return literal("false");
+            case 'n':
+                *out = JsonValue();
+                return literal("null");
+            default:
+                return number(out);
+        }
+    }
+
+    bool object(JsonValue* out, int depth) {
+        *out = JsonValue::object();
+        p_++;
+        skip_space();
+        if (p_ < end_ && *p_ == '}') {
+            p_++;
+            return true;
+        }
+        for (;;) {
+            skip_space();
+            if (p_ == end_ || *p_ != '"') return fail("expected a member name");
+            out->members_.push_back(std::make_pair(std::string(), JsonValue()));
+            if (!string(&out->members_.back().first)) return false;
+            skip_space();
+            if (p_ == end_ || *p_ != ':') return fail("expected ':'");
+            p_++;
+            if (!value(&out->members_.back().second, depth + 1)) return false;
+            skip_space();
+            if (p_ < end_ && *p_ == ',') {
+                p_++;
+            } else if (p_ < end_ && *p_ == '}') {
+                p_++;
+                return true;
+            } else {
+                return fail("expected ',' or '}'");
+            }
+        }
+    }
+
+    bool array(JsonValue* out, int depth) {
+        *out = JsonValue::array();
+        p_++;
+        skip_space();
+        if (p_ < end_ && *p_ == ']') {
+            p_++;
+            return true;
+        }
+        for (;;) {
+            out->items_.push_back(JsonValue());
+            if (!value(&out->items_.back(), depth + 1)) return false;
+            skip_space();
+            if (p_ < end_ && *p_ == ',') {
+                p_++;
+            } else if (p_ < end_ && *p_ == ']') {
+                p_++;
+                return true;
+            } else {
+                return fail("expected ',' or ']'");
+            }
+        }
+    }
+
+    bool hex4(unsigned* out) {
+        if (end_ - p_ < 4) return fail("short \\u escape");
+        unsigned code = 0;
+        for (int i = 0; i < 4; i++) {
+            char c = *p_++;
+            int digit = c >= '0' && c <= '9' ? c - '0'
+                      : c >= 'a' && c <= 'f' ? c - 'a' + 10
+                      : c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+            if (digit < 0) return fail("bad \\u escape");
+            code = code * 16 + (unsigned)digit;
+        }
+        *out = code;
+        return true;
+    }
+
+    bool string(std::string* out) {
+        p_++;
+        out->clear();
+        for (;;) {
+            if (p_ == end_) return fail("unterminated string");
+            char c = *p_++;
+            if (c == '"') return true;
+            if ((unsigned char)c < 0x20) return fail("control character in string");
+            if (c != '\\') {
+                out->push_back(c);
+                continue;
+            }
+            if (p_ == end_) return fail("unterminated string");
+            c = *p_++;
+            switch (c) {
+                case '"': out->push_back('"'); break;
+                case '\\': out->push_back('\\'); break;
+                case '/': out->push_back('/'); break;
+                case 'b': out->push_back('\b'); break;
+                case 'f': out->push_back('\f'); break;
+                case 'n': out->push_back('\n'); break;
+                case 'r': out->push_back('\r'); break;
+                case 't': out->push_back('\t'); break;
+                case 'u': {
+                    unsigned code;
+                    if (!hex4(&code)) return false;
+                    if (code >= 0xD800 && code < 0xDC00 && end_ - p_ >= 6 && p_[0] == '\\' && p_[1] == 'u') {
+                        const char* save = p_;
+                        p_ += 2;
+                        unsigned low;
+                        if (!hex4(&low)) return false;
+                        if (low >= 0xDC00 && low < 0xE000) {
+                            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                        } else {
+                            p_ = save;
+                        }
+                    }
+                    append_utf8(code, out);
+                    break;
+                }
+                default:
+                    return fail("bad escape");
+            }
+        }
+    }
+
+    bool number(JsonValue* out) {
+        const char* start = p_;
+        bool negative = false;
+        if (p_ < end_ && *p_ == '-') {
+            negative = true;
+            p_++;
+        }
+        if (p_ == end_ || *p_ < '0' || *p_ > '9') return fail("unexpected character");
+        double mantissa = 0.0;
+        int exponent = 0;
+        if (*p_ == '0') {
+            p_++;
+        } else {
+            for (; p_ < end_ && *p_ >= '0' && *p_ <= '9'; p_++) mantissa = mantissa * 10.0 + (*p_ - '0');
+        }
+        if (p_ < end_ && *p_ == '.') {
+            p_++;
+            if (p_ == end_ || *p_ < '0' || *p_ > '9') return fail("bad number");
+            for (; p_ < end_ && *p_ >= '0' && *p_ <= '9'; p_++) {
+                mantissa = mantissa * 10.0 + (*p_ - '0');
+                exponent--;
+            }
+        }
+        if (p_ < end_ && (*p_ == 'e' || *p_ == 'E')) {
+            p_++;
+            bool exp_negative = false;
+            if (p_ < end_ && (*p_ == '-' || *p_ == '+')) exp_negative = *p_++ == '-';
+            if (p_ == end_ || *p_ < '0' || *p_ > '9') return fail("bad number");
+            int e = 0;
+            for (; p_ < end_ && *p_ >= '0' && *p_ <= '9'; p_++) {
+                if (e < 100000) e = e * 10 + (*p_ - '0');
+            }
+            exponent += exp_negative ? -e : e;
+        }
+        double value = exponent == 0 ? mantissa : mantissa * pow(10.0, exponent);
+        out->type_ = JsonValue::NUMBER;
+        out->number_ = negative ? -value : value;
+        out->text_.assign(start, p_);
+        return true;
+    }
+};
+
+JsonValue JsonValue::boolean(bool value) {
+    JsonValue v;
+    v.type_ = BOOLEAN;
+    v.boolean_ = value;
+    return v;
+}
+
+JsonValue JsonValue::number(double value) {
+    JsonValue v;
+    v.type_ = NUMBER;
+    v.number_ = value;
+    char buffer[40];
+    if (value == floor(value) && fabs(value) < 9007199254740992.0) {
+        snprintf(buffer, sizeof(buffer), "%lld", (long long)value);
+    } else {
+        snprintf(buffer, sizeof(buffer), "%.9g", value);
+        // The decimal separator follows the C locale
+        for (char* c = buffer; *c; c++) {
+            if (*c == ',') *c = '.';
+        }
+    }
+    v.text_ = buffer;
+    return v;
+}
+
+JsonValue JsonValue::string(const std::string& value) {
+    JsonValue v;
+    v.type_ = STRING;
+    v.text_ = value;
+    return v;
+}
+
+JsonValue JsonValue::array() {
+    JsonValue v;
+    v.type_ = ARRAY;
+    return v;
+}
+
+JsonValue JsonValue::object() {
+    JsonValue v;
+    v.type_ = OBJECT;
+    return v;
+}
+
+int JsonValue::as_int(int fallback) const {
+    if (type_ != NUMBER || number_ != floor(number_) || number_ < -2147483648.0 || number_ > 2147483647.0) {
+        return fallback;
+    }
+    return (int)number_;
+}
+
+const JsonValue* JsonValue::find(const char* key) const {
+    for (size_t i = 0; i < members_.size(); i++) {
+        if (members_[i].first == key) return &members_[i].second;
+    }
+    return NULL;
+}
+
+JsonValue* JsonValue::find(const char* key) {
+    return const_cast<JsonValue*>(static_cast<const JsonValue*>(this)->find(key));
+}
+
+JsonValue& JsonValue::member(const char* key) {
+    JsonValue* existing = find(key);
+    if (existing) return *existing;
+    members_.push_back(std::make_pair(std::string(key), JsonValue()));
+    return members_.back().second;
+}
+
+bool JsonValue::parse(const char* text, size_t size, JsonValue* out, std::string* error) {
+    JsonParser parser(text, size);
+    return parser.document(out, error);
+}
+
+void JsonValue::write(std::string* out) const {
+    switch (type_) {
+        case NUL: out->append("null"); break;
+        case BOOLEAN: out->append(boolean_ ? "true" : "false"); break;
+        case NUMBER: out->append(text_); break;
+        case STRING: write_string(text_, out); break;
+        case ARRAY:
+            out->push_back('[');
+            for (size_t i = 0; i < items_.size(); i++) {
+                if (i) out->push_back(',');
+                items_[i].write(out);
+            }
+            out->push_back(']');
+            break;
+        case OBJECT:
+            out->push_back('{');
+            for (size_t i = 0; i < members_.size(); i++) {
+                if (i) out->push_back(',');
+                write_string(members_[i].first, out);
+                out->push_back(':');
+                members_[i].second.write(out);
+            }
+            out->push_back('}');
+            break;
+    }
+}
+
+} // namespace uvunwrap
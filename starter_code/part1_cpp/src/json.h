@@ -0,0 +1,78 @@
+/**
+ * @file json.h
+ * @brief Internal JSON document tree for the glTF reader and writer
+ *
+ * Not part of the public API. Objects keep their members in file order and
+ * numbers keep their source text, so a parsed document is written back
+ * unchanged apart from the edits made to it.
+ */
+
+#ifndef UVUNWRAP_JSON_H
+#define UVUNWRAP_JSON_H
+
+#include <stddef.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace uvunwrap {
+
+class JsonValue {
+public:
+    enum Type { NUL, BOOLEAN, NUMBER, STRING, ARRAY, OBJECT };
+
+    JsonValue() : type_(NUL), boolean_(false), number_(0.0) {}
+
+    static JsonValue boolean(bool value);
+    static JsonValue number(double value);
+    static JsonValue string(const std::string& value);
+    static JsonValue array();
+    static JsonValue object();
+
+    Type type() const { return type_; }
+    bool is_number() const { return type_ == NUMBER; }
+    bool is_string() const { return type_ == STRING; }
+    bool is_array() const { return type_ == ARRAY; }
+    bool is_object() const { return type_ == OBJECT; }
+
+    double as_number(double fallback = 0.0) const { return type_ == NUMBER ? number_ : fallback; }
+    /** Number as an int, or fallback if it is not a whole number in int range */
+    int as_int(int fallback = -1) const;
+    bool as_bool(bool fallback = false) const { return type_ == BOOLEAN ? boolean_ : fallback; }
+    const std::string& as_string() const { return text_; }
+
+    /** Array items (empty for other types) */
+    size_t size() const { return items_.size(); }
+    const JsonValue& operator[](size_t i) const { return items_[i]; }
+    JsonValue& operator[](size_t i) { return items_[i]; }
+    void push_back(const JsonValue& value) { items_.push_back(value); }
+
+    /** Object member, or NULL */
+    const JsonValue* find(const char* key) const;
+    JsonValue* find(const char* key);
+    /** Object member, added at the end if missing */
+    JsonValue& member(const char* key);
+
+    /**
+     * @brief Parse a whole document
+     * @return false on a syntax error, with its offset in error
+     */
+    static bool parse(const char* text, size_t size, JsonValue* out, std::string* error);
+
+    /** Compact text of the value */
+    void write(std::string* out) const;
+
+private:
+    friend class JsonParser;
+
+    Type type_;
+    bool boolean_;
+    double number_;
+    std::string text_;  // STRING: decoded value; NUMBER: source text
+    std::vector<JsonValue> items_;
+    std::vector<std::pair<std::string, JsonValue> > members_;
+};
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_JSON_H */
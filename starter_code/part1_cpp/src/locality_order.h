@@ -0,0 +1,40 @@
+/**
+ * @file locality_order.h
+ * @brief Internal vertex and face permutations for cache locality
+ *
+ * Not part of the public API. Shared by reorder_mesh() and the per-island
+ * reorder in LSCM. Permutations are given new -> old: entry k is the old
+ * index of the element placed at k.
+ */
+
+#ifndef UVUNWRAP_LOCALITY_ORDER_H
+#define UVUNWRAP_LOCALITY_ORDER_H
+
+#include "mesh.h"
+
+namespace uvunwrap {
+
+/**
+ * @brief Vertex permutation of [0, n) for a VertexOrder
+ *
+ * @param tris num_faces triangles over [0, n)
+ * @param vertices Mesh vertex of each of the n vertices, for positions
+ *        (NULL: vertex i is mesh vertex i)
+ * @param new_to_old Output, n entries
+ * @return false for VERTEX_ORDER_INPUT or an unknown order (nothing written)
+ */
+bool locality_vertex_order(int order, const Mesh* mesh, const int* vertices, const int* tris, int num_faces,
+                           int n, int* new_to_old);
+
+/**
+ * @brief Face permutation following a vertex renumbering: faces by their
+ *        lowest new corner, ties in input order
+ *
+ * @param old_to_new New index of each vertex
+ * @param new_to_old Output, num_faces entries
+ */
+void locality_face_order(const int* tris, int num_faces, int n, const int* old_to_new, int* new_to_old);
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_LOCALITY_ORDER_H */
@@ -0,0 +1,66 @@
+/**
+ * @file logging.cpp
+ * @brief Log level and sink behind uv_log.h
+ */
+
+#include "logging.h"
+#include <stdarg.h>
+#include <stdio.h>
+
+namespace uvunwrap {
+
+#ifdef NDEBUG
+std::atomic<int> g_log_level(UV_LOG_SILENT);
+#else
+std::atomic<int> g_log_level(UV_LOG_INFO);
+#endif
+
+namespace {
+
+std::mutex g_sink_mutex;
+UvLogCallback g_callback = NULL;
+void* g_user_data = NULL;
+
+} // namespace
+
+void log_message(int level, const char* format, ...) {
+    char buffer[1024];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+
+    LogSink* sink = current_log_sink();
+    if (sink) {
+        std::lock_guard<std::mutex> lock(sink->mutex);
+        if (sink->callback) sink->callback(level, buffer, sink->user_data);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(g_sink_mutex);
+    if (g_callback) {
+        g_callback(level, buffer, g_user_data);
+    } else {
+        FILE* stream = level <= UV_LOG_WARNING ? stderr : stdout;
+        fputs(buffer, stream);
+        fputc('\n', stream);
+    }
+}
+
+} // namespace uvunwrap
+
+void uv_set_log_level(int level) {
+    if (level < UV_LOG_SILENT) level = UV_LOG_SILENT;
+    if (level > UV_LOG_DEBUG) level = UV_LOG_DEBUG;
+    uvunwrap::g_log_level.store(level, std::memory_order_relaxed);
+}
+
+int uv_get_log_level(void) {
+    return uvunwrap::g_log_level.load(std::memory_order_relaxed);
+}
+
+void uv_set_log_callback(UvLogCallback callback, void* user_data) {
+    std::lock_guard<std::mutex> lock(uvunwrap::g_sink_mutex);
+    uvunwrap::g_callback = callback;
+    uvunwrap::g_user_data = user_data;
+}
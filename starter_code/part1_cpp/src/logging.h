@@ -0,0 +1,74 @@
+/**
+ * @file logging.h
+ * @brief Internal log macros over the uv_log.h sink
+ *
+ * Not part of the public API. The level check is one relaxed atomic load;
+ * the arguments are only evaluated and formatted when it passes.
+ *
+ * A call can route its messages to its own sink (an UnwrapContext's) with
+ * a ScopedLogSink. The sink is per thread, so the helpers that start
+ * workers (parallel.h, task_graph.h) hand theirs on to every worker.
+ */
+
+#ifndef UVUNWRAP_LOGGING_H
+#define UVUNWRAP_LOGGING_H
+
+#include "uv_log.h"
+#include <atomic>
+#include <mutex>
+
+namespace uvunwrap {
+
+extern std::atomic<int> g_log_level;
+
+/** Log destination that replaces the process-wide one for a scope */
+struct LogSink {
+    UvLogCallback callback = NULL;
+    void* user_data = NULL;
+    int level = UV_LOG_SILENT;
+    std::mutex mutex;            /**< Serialises callback calls across workers */
+};
+
+/** Sink installed on this thread, or NULL for the process-wide one */
+inline LogSink*& current_log_sink() {
+    static thread_local LogSink* sink = NULL;
+    return sink;
+}
+
+/** Installs a sink on this thread for its lifetime (NULL keeps the current one) */
+class ScopedLogSink {
+public:
+    explicit ScopedLogSink(LogSink* sink) : saved_(current_log_sink()) {
+        if (sink) current_log_sink() = sink;
+    }
+    ~ScopedLogSink() { current_log_sink() = saved_; }
+    ScopedLogSink(const ScopedLogSink&) = delete;
+    ScopedLogSink& operator=(const ScopedLogSink&) = delete;
+
+private:
+    LogSink* saved_;
+};
+
+inline bool log_enabled(int level) {
+    const LogSink* sink = current_log_sink();
+    return level <= (sink ? sink->level : g_log_level.load(std::memory_order_relaxed));
+}
+
+#if defined(__GNUC__)
+__attribute__((format(printf, 2, 3)))
+#endif
+void log_message(int level, const char* format, ...);
+
+} // namespace uvunwrap
+
+#define UV_LOG(level, ...) \
+    do { \
+        if (uvunwrap::log_enabled(level)) uvunwrap::log_message(level, __VA_ARGS__); \
+    } while (0)
+
+#define LOG_ERROR(...) UV_LOG(UV_LOG_ERROR, __VA_ARGS__)
+#define LOG_WARNING(...) UV_LOG(UV_LOG_WARNING, __VA_ARGS__)
+#define LOG_INFO(...) UV_LOG(UV_LOG_INFO, __VA_ARGS__)
+#define LOG_DEBUG(...) UV_LOG(UV_LOG_DEBUG, __VA_ARGS__)
+
+#endif /* UVUNWRAP_LOGGING_H */
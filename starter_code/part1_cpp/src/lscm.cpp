@@ -21,24 +21,78 @@
 
 #include "lscm.h"
 #include "math_utils.h"
+#include "vec_math.h"
+#include "timer.h"
+#include "trace.h"
+#include "logging.h"
+#include "half_edge.h"
+#include "lscm_pins.h"
+#include "lscm_closed_form.h"
+#include "lscm_hierarchy.h"
+#include "direct_solver.h"
+#include "abf.h"
+#include "arap.h"
+#include "lscm_cancel.h"
+#include "memory_meter.h"
+#include "locality_order.h"
+#include "triangle_geometry.h"
+#include "gpu_backend.h"
+#include "parallel.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
 #include <float.h>
-#include <map>
+#include <string.h>
 #include <vector>
-#include <set>
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <stdint.h>
 
 // Eigen library for sparse matrices
 #include <Eigen/Sparse>
-#include <Eigen/SparseLU>
-// Alternative: #include <Eigen/IterativeLinearSolvers>
+#include <Eigen/IterativeLinearSolvers>
+#include <Eigen/Dense>
 
-// Helper to compute triangle area and local coordinates
-static double compute_triangle_area(const Vec3& p0, const Vec3& p1, const Vec3& p2) {
-    Vec3 e1 = vec3_sub(p1, p0);
-    Vec3 e2 = vec3_sub(p2, p0);
-    return 0.5 * vec3_length(vec3_cross(e1, e2));
+using uvunwrap::DirectSolver;
+using uvunwrap::create_direct_solver;
+using uvunwrap::create_eigen_direct_solver;
+
+/**
+ * @brief Ordered boundary loops of a triangle list, O(size)
+ *
+ * Twins come from the radix-sorted half-edge build over just these
+ * triangles, so no edge map is needed. Each loop is rotated to start at
+ * its smallest vertex.
+ */
+static void triangle_boundary_loops(const int* tris, int num_faces, int num_vertices,
+                                    std::vector<int>& loop_offsets,
+                                    std::vector<int>& loop_vertices) {
+    loop_offsets.assign(1, 0);
+    loop_vertices.clear();
+
+    Mesh part;
+    memset(&part, 0, sizeof(part));
+    part.triangles = (int*)tris;
+    part.num_triangles = num_faces;
+    part.num_vertices = num_vertices;
+    uvunwrap::HalfEdgeMesh he;
+    if (!uvunwrap::build_half_edge_mesh(&part, &he, 1)) return;
+
+    std::vector<int> faces(num_faces);
+    for (int i = 0; i < num_faces; i++) faces[i] = i;
+    std::vector<int> loop_half_edges;
+    uvunwrap::island_boundary_loops(he, NULL, faces.data(), num_faces,
+                                    loop_offsets, loop_vertices, loop_half_edges);
+
+    for (size_t l = 0; l + 1 < loop_offsets.size(); l++) {
+        std::vector<int>::iterator begin = loop_vertices.begin() + loop_offsets[l];
+        std::vector<int>::iterator end = loop_vertices.begin() + loop_offsets[l + 1];
+        std::rotate(begin, std::min_element(begin, end), end);
+    }
 }
 
 int find_boundary_vertices(const Mesh* mesh,
@@ -47,42 +101,20 @@ int find_boundary_vertices(const Mesh* mesh,
                           int** boundary_out) {
     if (!mesh || !face_indices || num_faces == 0) return 0;
 
-    // Count edge recurrence to find boundary edges
-    // Key: Edge (v0 < v1), Value: count
-    std::map<std::pair<int, int>, int> edge_counts;
-
+    std::vector<int> tris((size_t)num_faces * 3);
     for (int i = 0; i < num_faces; i++) {
-        int f = face_indices[i];
-        int v0 = mesh->triangles[f*3 + 0];
-        int v1 = mesh->triangles[f*3 + 1];
-        int v2 = mesh->triangles[f*3 + 2];
-
-        int vs[3] = {v0, v1, v2};
-        for (int j = 0; j < 3; j++) {
-            int a = vs[j];
-            int b = vs[(j+1)%3];
-            if (a > b) std::swap(a, b);
-            edge_counts[{a, b}]++;
-        }
+        memcpy(&tris[i * 3], &mesh->triangles[face_indices[i] * 3], 3 * sizeof(int));
     }
+    std::vector<int> loop_offsets, boundary_verts;
+    triangle_boundary_loops(tris.data(), num_faces, mesh->num_vertices, loop_offsets, boundary_verts);
 
-    std::set<int> boundary_verts;
-    for (auto const& item : edge_counts) {
-        const std::pair<int, int>& edge = item.first;
-        int count = item.second;
-        if (count == 1) {
-            boundary_verts.insert(edge.first);
-            boundary_verts.insert(edge.second);
-        }
-    }
+    std::sort(boundary_verts.begin(), boundary_verts.end());
+    boundary_verts.erase(std::unique(boundary_verts.begin(), boundary_verts.end()), boundary_verts.end());
 
     int num_boundary = boundary_verts.size();
     if (num_boundary > 0) {
         *boundary_out = (int*)malloc(num_boundary * sizeof(int));
-        int idx = 0;
-        for (int v : boundary_verts) {
-            (*boundary_out)[idx++] = v;
-        }
+        memcpy(*boundary_out, boundary_verts.data(), num_boundary * sizeof(int));
     } else {
         *boundary_out = NULL;
     }
@@ -126,375 +158,2363 @@ void normalize_uvs_to_unit_square(float* uvs, int num_verts) {
     }
 }
 
-float* lscm_parameterize(const Mesh* mesh,
-                         const int* face_indices,
-                         int num_faces) {
-    if (!mesh || !face_indices || num_faces == 0) return NULL;
+/**
+ * @brief Sparsity pattern of the LSCM normal matrix for one island
+ *
+ * Vertex j's neighbours (itself included) are nbrs[nbr_offsets[j] ..
+ * nbr_offsets[j+1]), ascending. DOF columns 2j and 2j+1 each hold rows
+ * 2i, 2i+1 for every neighbour i, so every 2x2 vertex block is stored.
+ * corner_slots[t*9 + k*3 + l] is the position of vertex tri[k] in the
+ * neighbour list of tri[l] for triangle t.
+ */
+struct LscmPattern {
+    std::vector<int> nbr_offsets;
+    std::vector<int> nbrs;
+    std::vector<int> corner_slots;
+};
 
-    printf("LSCM parameterizing %d faces...\n", num_faces);
+/** Vertex adjacency (itself included, ascending) of local triangles, in CSR form */
+static void vertex_neighbours(const int* local_tris, int num_faces, int n,
+                              std::vector<int>& nbr_offsets, std::vector<int>& nbrs) {
+    // Collect (vertex, neighbour) pairs from every triangle, then sort/unique
+    std::vector<std::vector<int> > lists(n);
+    for (int t = 0; t < num_faces; t++) {
+        const int* tri = &local_tris[t * 3];
+        for (int k = 0; k < 3; k++) {
+            for (int l = 0; l < 3; l++) {
+                lists[tri[l]].push_back(tri[k]);
+            }
+        }
+    }
 
-    // STEP 1: Local vertex mapping
-    std::map<int, int> global_to_local;
-    std::vector<int> local_to_global;
-    
-    for (int i = 0; i < num_faces; i++) {
-        int f = face_indices[i];
-        for (int j = 0; j < 3; j++) {
-            int v_global = mesh->triangles[f*3 + j];
-            if (global_to_local.find(v_global) == global_to_local.end()) {
-                global_to_local[v_global] = local_to_global.size();
-                local_to_global.push_back(v_global);
+    nbr_offsets.assign(n + 1, 0);
+    for (int j = 0; j < n; j++) {
+        std::vector<int>& list = lists[j];
+        std::sort(list.begin(), list.end());
+        list.erase(std::unique(list.begin(), list.end()), list.end());
+        nbr_offsets[j + 1] = nbr_offsets[j] + (int)list.size();
+    }
+
+    nbrs.resize(nbr_offsets[n]);
+    for (int j = 0; j < n; j++) {
+        std::copy(lists[j].begin(), lists[j].end(), nbrs.begin() + nbr_offsets[j]);
+    }
+}
+
+static void build_lscm_pattern(const int* local_tris, int num_faces, int n,
+                               LscmPattern& pattern) {
+    vertex_neighbours(local_tris, num_faces, n, pattern.nbr_offsets, pattern.nbrs);
+
+    pattern.corner_slots.resize((size_t)num_faces * 9);
+    for (int t = 0; t < num_faces; t++) {
+        const int* tri = &local_tris[t * 3];
+        for (int k = 0; k < 3; k++) {
+            for (int l = 0; l < 3; l++) {
+                const int* begin = &pattern.nbrs[pattern.nbr_offsets[tri[l]]];
+                const int* end = &pattern.nbrs[0] + pattern.nbr_offsets[tri[l] + 1];
+                pattern.corner_slots[t * 9 + k * 3 + l] = (int)(std::lower_bound(begin, end, tri[k]) - begin);
             }
         }
     }
+}
 
-    int n = local_to_global.size();
-    printf("  Island has %d vertices\n", n);
+// Triangles per batch of the coefficient precompute
+static const int COEFF_BLOCK = 256;
 
-    if (n < 3) {
-        fprintf(stderr, "LSCM: Island too small (%d vertices)\n", n);
-        return NULL;
+/**
+ * @brief sqrt(area)-weighted LSCM coefficients of one triangle
+ *
+ * The triangle is projected into a local orthonormal frame; for vertex k,
+ * W_k = ((x[k-1] - x[k+1]) + i (y[k-1] - y[k+1])) / (2 area), and the
+ * Cauchy-Riemann residual is Sum W_k (u_k + i v_k).
+ */
+struct TriangleCoefficients {
+    double re[3], im[3];
+};
+
+/**
+ * @brief Coefficients of triangles face_indices[0 .. n) (n <= COEFF_BLOCK)
+ *
+ * Gathers the edge vectors into SoA arrays, projects them with
+ * triangle_frames_soa() and derives the weighted coefficients in double.
+ * valid[t] is 0 for degenerate triangles, which contribute nothing.
+ * frames, when given, replaces the projection with (x1, x2, y2) per
+ * triangle, e.g. the layout of ABF++ angles.
+ */
+static void triangle_lscm_coefficients(const Mesh* mesh, const int* face_indices, int n,
+                                       const float* frames,
+                                       TriangleCoefficients* out, unsigned char* valid) {
+    float e1x[COEFF_BLOCK], e1y[COEFF_BLOCK], e1z[COEFF_BLOCK];
+    float e2x[COEFF_BLOCK], e2y[COEFF_BLOCK], e2z[COEFF_BLOCK];
+    float x1[COEFF_BLOCK], x2[COEFF_BLOCK], y2[COEFF_BLOCK];
+
+    if (frames) {
+        for (int t = 0; t < n; t++) {
+            x1[t] = frames[3 * t + 0];
+            x2[t] = frames[3 * t + 1];
+            y2[t] = frames[3 * t + 2];
+        }
+    } else {
+        const float* P = mesh->vertices;
+        for (int t = 0; t < n; t++) {
+            const int* tri = &mesh->triangles[face_indices[t] * 3];
+            const float* p0 = &P[tri[0] * 3];
+            const float* p1 = &P[tri[1] * 3];
+            const float* p2 = &P[tri[2] * 3];
+            e1x[t] = p1[0] - p0[0]; e1y[t] = p1[1] - p0[1]; e1z[t] = p1[2] - p0[2];
+            e2x[t] = p2[0] - p0[0]; e2y[t] = p2[1] - p0[1]; e2z[t] = p2[2] - p0[2];
+        }
+        uvunwrap::triangle_frames_soa(n, e1x, e1y, e1z, e2x, e2y, e2z, x1, x2, y2);
     }
 
-    // STEP 2: Build sparse matrix
-    // We are solving Ax = 0 roughly (energy minimization).
-    // The energy is sum of squared conformal violation.
-    // Referencing LSCM paper / standard implementation:
-    // Variables are (u, v).
-    // It's often formulated as a complex number problem or 2n x 2n system.
-    // We'll use the 2n implementation.
-    // Reference: "Least Squares Conformal Maps for Automatic Texture Atlas Generation", Levy et al.
-    
-    typedef Eigen::Triplet<double> T;
-    std::vector<T> triplets;
-    
-    // Reserve estimation
-    triplets.reserve(num_faces * 9 * 4); // rough guess relative to faces
+    for (int t = 0; t < n; t++) {
+        double x[3] = {0.0, x1[t], x2[t]};
+        double y[3] = {0.0, 0.0, y2[t]};
 
-    // For each triangle, project to local 2D and add terms
-    for (int i = 0; i < num_faces; i++) {
-        int f = face_indices[i];
-        int v0_g = mesh->triangles[f*3 + 0];
-        int v1_g = mesh->triangles[f*3 + 1];
-        int v2_g = mesh->triangles[f*3 + 2];
-        
-        int idx[3] = {global_to_local[v0_g], global_to_local[v1_g], global_to_local[v2_g]};
-        
-        Vec3 p0 = get_vertex_position(mesh, v0_g);
-        Vec3 p1 = get_vertex_position(mesh, v1_g);
-        Vec3 p2 = get_vertex_position(mesh, v2_g);
-        
-        // Project to local 2D
-        // Origin at p0
-        // X axis along p1-p0
-        Vec3 x_axis = vec3_normalize(vec3_sub(p1, p0));
-        Vec3 z_axis = vec3_normalize(vec3_cross(vec3_sub(p1, p0), vec3_sub(p2, p0)));
-        Vec3 y_axis = vec3_cross(z_axis, x_axis);
-        
-        Vec2 l0 = {0, 0};
-        Vec2 l1 = {vec3_length(vec3_sub(p1, p0)), 0};
-        Vec2 l2 = {vec3_dot(vec3_sub(p2, p0), x_axis), vec3_dot(vec3_sub(p2, p0), y_axis)};
-        
-        double area = 0.5 * (l1.x * l2.y - l1.y * l2.x); // Should be > 0 if winding is correct
-        if (abs(area) < 1e-8) continue;
-        
-        // W = i * area / Sqrt(area) ? No.
-        // The standard LSCM coeff for triangle (0,1,2):
-        // M = 1/sqrt(Area) * ...
-        // We use the gradient formulation.
-        // Grad u = [du/dx, du/dy]
-        // Conformality: du/dx = dv/dy, du/dy = -dv/dx
-        // Min int ||grad u - (-grad v_perp)||^2
-        
-        // Using formula from Levy et al (simplified):
-        // W_j = (x, y) coordinates
-        // ... I'll follow standard coefficients based on cotangents or local coords.
-        // Let's use local coords (x,y) of the triangle.
-        
-    // double s = 1.0 / sqrt(2.0 * area); // Normalization factor (unused in gradient formulation)
-
-        
-        // Coefficients for each vertex in the linear combination for gradients
-        // For vertex k in triangle, the complex coeff is ???
-        // Let's rely on the explicit matrix assembly form.
-        // M * [u0 v0 ... un vn]^T = 0
-        // M has 2 rows per triangle approx? No, M is 2n x 2n.
-        // Wait, LSCM usually minimizes E = X^T A X. So A is symmetric?
-        // Or E = || M U ||^2 -> U^T M^T M U = 0
-        
-        // Implementation approach:
-        // We write the conformality condition for each triangle as a linear eq.
-        // For triangle T, we want (u1-u0) + i(v1-v0) = Z * ((u2-u0)+i(v2-v0))
-        // where Z is complex ratio relating p0, p1, p2.
-        
-        // Alternative: Use local gradients.
-        // For triangle with local coords (x0,y0), (x1,y1), (x2,y2).
-        // W_0 = (x2-x1) + i(y2-y1) / 2A
-        // W_1 = (x0-x2) + i(y0-y2) / 2A
-        // W_2 = (x1-x0) + i(y1-y0) / 2A
-        // Condition: Sum W_j * (u_j + i v_j) = 0
-        // Real part: Sum (Re(W_j)u_j - Im(W_j)v_j) = 0
-        // Imag part: Sum (Im(W_j)u_j + Re(W_j)v_j) = 0
-        
-        // Correct.
-        // double x[] = {l0.x, l1.x, l2.x};
-        // double y[] = {l0.y, l1.y, l2.y};
-        
-        // Re(W_0) = (x[2]-x[1])/(2*area); Im(W_0) = (y[2]-y[1])/(2*area);
-        // ...
-        
-        // But we want to construct the matrix A where we solve A x = b (with locks).
-        
-        // Matrix M where M * U = 0. Size 2F x 2V?
-        // Energy is ||M U||^2. We minimize U^T M^T M U.
-        // The system to solve is M^T M U = 0 (subject to constraints).
-        // Let's build M directly.
-        // Rows: 2 per triangle (Real and Imag equations).
-        // Cols: 2 per vertex (u and v indices).
-        
-        double x[] = {l0.x, l1.x, l2.x};
-        double y[] = {l0.y, l1.y, l2.y};
-        
+        double area = 0.5 * (x[1] * y[2] - y[1] * x[2]);
+        valid[t] = fabs(area) >= 1e-8;
+        if (!valid[t]) continue;
+
+        // Weight by sqrt(area) so the energy approximates the integral:
+        // W_k * sqrt(area) = (x[k-1] - x[k+1] + i ...) / (2 sqrt(area))
+        double scale = 0.5 / sqrt(area);
         for (int k = 0; k < 3; k++) {
-            int prev = (k+2)%3;
-            int next = (k+1)%3;
-            
-            double re_W = (x[prev] - x[next]) / (2.0 * area); // Re(W_k)
-            double im_W = (y[prev] - y[next]) / (2.0 * area); // Im(W_k)
-            
-            // Equation 1 (Real): Sum Re(W)*u - Im(W)*v = 0
-            // Row 2*i. Cols: u_idx, v_idx.
-            // Coeffs: re_W for u_k, -im_W for v_k
-            
-            // Equation 2 (Imag): Sum Im(W)*u + Re(W)*v = 0
-            // Row 2*i+1. Cols: u_idx, v_idx.
-            // Coeffs: im_W for u_k, re_W for v_k
-            
-            int u_idx = idx[k] * 2;
-            int v_idx = idx[k] * 2 + 1;
-            
-            // Weight by sqrt(area) to make energy = integral?
-            // Yes, multiply equations by sqrt(area).
-            // Then effective coeffs are divided by 2*sqrt(area) instead of 2*area.
-            
-            double factor = sqrt(area);
-            re_W *= factor;
-            im_W *= factor;
-            
-            // Add to M (which is huge, F*2 rows, V*2 cols)
-            // But we actually need M^T M.
-            // Constructing M^T M directly is hard locally? 
-            // Often easier to build M, then M^T * M.
-            // But M is very sparse.
-            
-            // We use row index base = i * 2.
-            int row_r = i * 2;
-            int row_i = i * 2 + 1;
-            
-            triplets.push_back(T(row_r, u_idx, re_W));
-            triplets.push_back(T(row_r, v_idx, -im_W));
-            
-            triplets.push_back(T(row_i, u_idx, im_W));
-            triplets.push_back(T(row_i, v_idx, re_W));
+            int prev = (k + 2) % 3;
+            int next = (k + 1) % 3;
+            out[t].re[k] = (x[prev] - x[next]) * scale;
+            out[t].im[k] = (y[prev] - y[next]) * scale;
         }
     }
-    
-    // Assemble M
-    Eigen::SparseMatrix<double> M(2 * num_faces, 2 * n);
-    M.setFromTriplets(triplets.begin(), triplets.end());
-    
-    // Compute A = M^T * M
-    Eigen::SparseMatrix<double> A = M.transpose() * M;
-    
-    // STEP 3: Boundary conditions
-    // Fix two vertices to resolve translation/rotation/scale ambiguity (conformal map).
-    // Find vertices to pin.
-    int pinned_idx1 = 0;
-    int pinned_idx2 = n - 1; // Default
-    
-    int* boundary_verts = NULL;
-    int num_boundary = find_boundary_vertices(mesh, face_indices, num_faces, &boundary_verts);
-    if (num_boundary >= 2) {
-        // Find two farthest boundary vertices
-        float max_dist = -1.0f;
-        for (int i = 0; i < num_boundary; i++) {
-            for (int k = i + 1; k < num_boundary; k++) {
-                // Approximate distance using local array index diff or just pick first/mid
-                // Using 3D distance
-                Vec3 p1 = get_vertex_position(mesh, local_to_global[global_to_local[boundary_verts[i]]]);
-                Vec3 p2 = get_vertex_position(mesh, local_to_global[global_to_local[boundary_verts[k]]]);
-                float d = vec3_length(vec3_sub(p1, p2));
-                if (d > max_dist) {
-                    max_dist = d;
-                    pinned_idx1 = global_to_local[boundary_verts[i]];
-                    pinned_idx2 = global_to_local[boundary_verts[k]];
+}
+
+/**
+ * @brief Reduced LSCM system layout for one island and pin choice
+ *
+ * dof_remap maps each of the 2n DOFs to its index among the free unknowns,
+ * or -1 if it is pinned. Because the remap is monotonic the reduced CSC
+ * pattern of A is the full pattern with the pinned rows and columns
+ * removed. entry_pos[4*e + 2*q + p] is the value index of (row 2i+p,
+ * col 2j+q) for the e-th neighbour entry (i in nbrs(j)), or -1 if either
+ * DOF is pinned. Everything here depends only on connectivity and pins,
+ * so it can be reused while the geometry changes.
+ */
+struct LscmSystem {
+    LscmPattern pattern;
+    std::vector<int> dof_remap;
+    std::vector<double> pin_values;
+    bool pinned;                         /**< Some DOF is eliminated (both pin indices were given) */
+    int num_free;
+    std::vector<int> entry_pos;
+    Eigen::SparseMatrix<double> A;
+    Eigen::SparseMatrix<float> A_float;  /**< A's pattern in float, set up by the first float solve */
+    int colour_chunk;                    /**< Faces per assembly chunk, a multiple of COEFF_BLOCK */
+    std::vector<int> colour_offsets;     /**< Assembly colours (empty = serial assembly): colour c */
+    std::vector<int> colour_chunks;      /**< holds chunks colour_chunks[colour_offsets[c] .. [c+1]) */
+};
+
+// Islands of at least this many faces are assembled by colour, see
+// colour_assembly_chunks()
+static const int COLOURED_ASSEMBLY_MIN_FACES = 32768;
+// Chunks an island is cut into for colouring: enough for every core in
+// each colour, few enough that a chunk's entries stay together in A
+static const int ASSEMBLY_CHUNKS = 128;
+
+/**
+ * @brief Colour the island's face chunks for parallel assembly
+ *
+ * The faces are cut into about ASSEMBLY_CHUNKS runs of whole
+ * COEFF_BLOCKs. Chunks of one colour share no island vertex, so their
+ * 2x2 blocks land in disjoint entries of A and b and can be scattered by
+ * several threads without atomics. The vertices are the island's own,
+ * already split along its seams: faces either side of a cut never
+ * conflict. Chunks are coloured greedily in order; a vertex's colours so
+ * far are a 64-bit mask. An island below COLOURED_ASSEMBLY_MIN_FACES, or
+ * one whose face order is too scattered for 64 colours, gets none and is
+ * assembled serially. The chunks depend only on the face count, never on
+ * a thread count.
+ */
+static void colour_assembly_chunks(const int* local_tris, int num_faces, int n, LscmSystem& system) {
+    system.colour_offsets.clear();
+    system.colour_chunks.clear();
+    if (num_faces < COLOURED_ASSEMBLY_MIN_FACES) return;
+
+    int blocks_per_chunk = std::max(1, num_faces / (ASSEMBLY_CHUNKS * COEFF_BLOCK));
+    int chunk = blocks_per_chunk * COEFF_BLOCK;
+    int num_chunks = (num_faces + chunk - 1) / chunk;
+    std::vector<uint64_t> vertex_colours(n, 0);
+    std::vector<int> chunk_colour(num_chunks);
+    int num_colours = 0;
+    for (int c = 0; c < num_chunks; c++) {
+        int begin = c * chunk * 3;
+        int end = std::min(num_faces, (c + 1) * chunk) * 3;
+        uint64_t used = 0;
+        for (int i = begin; i < end; i++) used |= vertex_colours[local_tris[i]];
+        if (~used == 0) return;
+        int colour = __builtin_ctzll(~used);
+        for (int i = begin; i < end; i++) vertex_colours[local_tris[i]] |= (uint64_t)1 << colour;
+        chunk_colour[c] = colour;
+        num_colours = std::max(num_colours, colour + 1);
+    }
+
+    system.colour_chunk = chunk;
+    system.colour_offsets.assign(num_colours + 1, 0);
+    for (int c = 0; c < num_chunks; c++) system.colour_offsets[chunk_colour[c] + 1]++;
+    for (int k = 0; k < num_colours; k++) system.colour_offsets[k + 1] += system.colour_offsets[k];
+    system.colour_chunks.resize(num_chunks);
+    std::vector<int> next(system.colour_offsets.begin(), system.colour_offsets.end() - 1);
+    for (int c = 0; c < num_chunks; c++) system.colour_chunks[next[chunk_colour[c]]++] = c;
+    LOG_DEBUG("LSCM: %d assembly chunks in %d colours", num_chunks, num_colours);
+}
+
+/**
+ * @brief Build the pattern, DOF remap and CSC structure of the reduced system
+ *
+ * Pins (u1, v1) = (0, 0) and (u2, v2) = (1, 0) to fix translation,
+ * rotation and scale. Pinned DOFs are eliminated from the unknowns rather
+ * than kept as identity rows, so the reduced system is SPD. Negative pin
+ * indices pin nothing: A is then the full 2n x 2n L_C and b = 0.
+ */
+static void build_lscm_system(const int* local_tris, int num_faces, int n,
+                              int pinned_idx1, int pinned_idx2,
+                              LscmSystem& system) {
+    build_lscm_pattern(local_tris, num_faces, n, system.pattern);
+    colour_assembly_chunks(local_tris, num_faces, n, system);
+    const LscmPattern& pattern = system.pattern;
+
+    system.dof_remap.assign(2 * n, 0);
+    system.pin_values.assign(2 * n, 0.0);
+    system.pinned = pinned_idx1 >= 0 && pinned_idx2 >= 0;
+    if (system.pinned) {
+        system.dof_remap[pinned_idx1 * 2 + 0] = -1;
+        system.dof_remap[pinned_idx1 * 2 + 1] = -1;
+        system.dof_remap[pinned_idx2 * 2 + 0] = -1;
+        system.dof_remap[pinned_idx2 * 2 + 1] = -1;
+        system.pin_values[pinned_idx2 * 2 + 0] = 1.0;
+    }
+
+    int num_free = 0;
+    for (int i = 0; i < 2 * n; i++) {
+        if (system.dof_remap[i] >= 0) system.dof_remap[i] = num_free++;
+    }
+    system.num_free = num_free;
+
+    const int* dof_remap = system.dof_remap.data();
+    int num_blocks = pattern.nbr_offsets[n];
+    system.entry_pos.assign((size_t)num_blocks * 4, -1);
+
+    Eigen::SparseMatrix<double>& A = system.A;
+    A.resize(num_free, num_free);
+    A.resizeNonZeros(num_blocks * 4);
+    int* outer = A.outerIndexPtr();
+    int* inner = A.innerIndexPtr();
+
+    int nnz = 0;
+    for (int j = 0; j < n; j++) {
+        for (int q = 0; q < 2; q++) {
+            int col = dof_remap[2 * j + q];
+            if (col < 0) continue;
+            outer[col] = nnz;
+            for (int e = pattern.nbr_offsets[j]; e < pattern.nbr_offsets[j + 1]; e++) {
+                for (int p = 0; p < 2; p++) {
+                    int row = dof_remap[2 * pattern.nbrs[e] + p];
+                    if (row < 0) continue;
+                    inner[nnz] = row;
+                    system.entry_pos[4 * e + 2 * q + p] = nnz++;
                 }
             }
         }
-        // Optimize: brute force on boundary is O(B^2), OK for small boundaries.
-        // Cap B?
-        if (num_boundary > 200) {
-           pinned_idx1 = global_to_local[boundary_verts[0]];
-           pinned_idx2 = global_to_local[boundary_verts[num_boundary/2]];
+    }
+    outer[num_free] = nnz;
+    A.resizeNonZeros(nnz);
+}
+
+/** Give A_float the pattern of A (once per system) */
+static void prepare_float_matrix(LscmSystem& system) {
+    if (system.A_float.rows() == system.A.rows() && system.A_float.nonZeros() == system.A.nonZeros()) {
+        return;
+    }
+    system.A_float = system.A.cast<float>();
+}
+
+/**
+ * @brief Pin policies of assemble_lscm()
+ *
+ * dof(i) is DOF i's index among the unknowns (-1 if pinned) and value(i)
+ * its pinned value. With FreeDofs nothing is pinned (the full 2n x 2n
+ * system of the spectral mode), so every triangle takes the all-free
+ * path without a per-triangle test.
+ */
+struct FreeDofs {
+    static const bool pinned = false;
+    bool all_free(const int*) const { return true; }
+    int dof(int i) const { return i; }
+    double value(int) const { return 0.0; }
+};
+
+struct PinnedDofs {
+    static const bool pinned = true;
+    const int* dof_remap;
+    const double* pin_values;
+
+    bool all_free(const int* tri) const {
+        bool free = true;
+        for (int k = 0; k < 3; k++) {
+            free = free && dof_remap[2 * tri[k]] >= 0 && dof_remap[2 * tri[k] + 1] >= 0;
         }
-        free(boundary_verts);
-    } else {
-        // Closed mesh or weird case. Just pick 0 and largest distance from 0.
-        float max_dist = -1;
-        Vec3 p0 = get_vertex_position(mesh, local_to_global[pinned_idx1]);
-        for(int i=1; i<n; i++) {
-            Vec3 p = get_vertex_position(mesh, local_to_global[i]);
-            float d = vec3_length(vec3_sub(p0, p));
-            if(d > max_dist) {
-                max_dist = d;
-                pinned_idx2 = i;
+        return free;
+    }
+    int dof(int i) const { return dof_remap[i]; }
+    double value(int i) const { return pin_values[i]; }
+};
+
+/**
+ * @brief Sinks of assemble_lscm(): where the 2x2 blocks of a triangle go
+ *
+ * add_free_triangle() takes a triangle none of whose DOFs is pinned;
+ * add() one entry (row, col) of the block of corners (k, l), rows 2k+p and
+ * columns 2l+q; add_rhs() a pinned column's contribution to b[row].
+ * SparseSink scatters into the CSC values of an LscmSystem's matrix
+ * through its precomputed slots, in Scalar.
+ */
+template <typename Scalar>
+struct SparseSink {
+    const LscmSystem& system;
+    Scalar* values;
+    Eigen::Matrix<Scalar, Eigen::Dynamic, 1>& b;
+
+    void add_free_triangle(int t, const int* tri, const double* a, const double* im) {
+        const LscmPattern& pattern = system.pattern;
+        const int* entry_pos = system.entry_pos.data();
+        for (int l = 0; l < 3; l++) {
+            const int* slots = &pattern.corner_slots[t * 9 + l];
+            int base = pattern.nbr_offsets[tri[l]];
+            for (int k = 0; k < 3; k++) {
+                double c = a[k] * a[l] + im[k] * im[l];
+                double d = im[k] * a[l] - a[k] * im[l];
+                const int* pos = &entry_pos[4 * (base + slots[k * 3])];
+                values[pos[0]] += (Scalar)c;
+                values[pos[1]] += (Scalar)-d;
+                values[pos[2]] += (Scalar)d;
+                values[pos[3]] += (Scalar)c;
             }
         }
     }
-    
-    // Penalty method or eliminate rows/cols?
-    // Eliminate is better for condition number.
-    // Replace rows/cols of pinned variables with identity.
-    // Pinned: u1=0, v1=0, u2=1, v2=0? (Fix scale/rot)
-    
-    int p1_u = pinned_idx1 * 2;
-    int p1_v = pinned_idx1 * 2 + 1;
-    int p2_u = pinned_idx2 * 2;
-    int p2_v = pinned_idx2 * 2 + 1;
-    
-    std::vector<int> pinned_vars = {p1_u, p1_v, p2_u, p2_v};
-    double pinned_vals[] = {0.0, 0.0, 1.0, 0.0}; // Pin to (0,0) and (1,0)
-    
-    // Modify A and b for locking
-    // For each pinned var `j` with value `val`:
-    //   A(j, :) = 0, A(:, j) = 0, A(j, j) = 1
-    //   b = b - column(j) * val  (remove influence from RHS)
-    //   b(j) = val
-    
-    // Since b is initially 0, we only subtract columns.
-    Eigen::VectorXd b = Eigen::VectorXd::Zero(2*n);
-    
-    // This modification on SparseMatrix is slow if done element-wise.
-    // Better to use "set to zero" via iterator or reconstruction?
-    // Eigen has specific prune/modify methods but it's tricky.
-    // A common trick: add large value to diagonal? Soft constraint.
-    // Or set row/col to 0 and diag to 1.
-    // iterating strictly to zero out is hard.
-    
-    // Let's use the Large Diagonal approach (Penalty) for simplicity and speed?
-    // No, Part 1 requires accuracy.
-    // Let's iterate over triplets of A? A is already built.
-    
-    // Re-build A with constraints? No.
-    // Modify A: prune is expensive.
-    
-    // Actually, usually we remove the variables from the system (Matrix slicing).
-    // But keeping 2n sizes is easier for indexing.
-    // Iterate over A to zero out rows/cols?
-    // Let's use soft constraints with very high weight? 
-    // Weight = 1e8 * max(diag).
-    // This is "Penalty Method".
-    
-    // double penalty = 1e8; 
-    
-    // Better: Algebraic modification
-    // For each pinned index `p`:
-    // b += A.col(p) * -target_val ? No, we want u_p = target.
-    // The equation was A*x = 0.
-    // Now x_p is fixed.
-    // A_{row} * x + A_{row,p} * x_p = 0
-    // A_{row} * x = -A_{row,p} * x_p
-    // So b_{row} -= A_{row,p} * x_p.
-    // Then set row p to (0...1...0) and b_p = target.
-    
-    // We can do this efficiently:
-    for (int k = 0; k < 4; k++) {
-         int idx = pinned_vars[k];
-         double val = pinned_vals[k];
-         
-         // Move column to RHS
-         // Iterate over column is hard in RowMajor, but A is ColMajor by default.
-         // A is symmetric, so Col == Row.
-         
-         for (Eigen::SparseMatrix<double>::InnerIterator it(A, idx); it; ++it) {
-             if (it.row() != idx) {
-                 b(it.row()) -= it.value() * val;
-             }
-         }
+
+    void add(int t, const int* tri, int k, int l, int p, int q, int, int, double value) {
+        int e = system.pattern.nbr_offsets[tri[l]] + system.pattern.corner_slots[t * 9 + k * 3 + l];
+        values[system.entry_pos[4 * e + 2 * q + p]] += (Scalar)value;
     }
-    
-    // Now set rows/cols to identity
-    // This is modifying the matrix structure, potentially.
-    // But setting to 0 doesn't change sparsity if we don't prune.
-    // Just setting values to 0.
-    
-    for (int k = 0; k < 4; k++) {
-        int idx = pinned_vars[k];
-        
-        // Zero out row and col
-        // Since symmetric, just iterate once?
-        // But need to ensure we visit all entries.
-        // It's easier to iterate the whole matrix or use setIdentity?
-        // Pruning is best.
+
+    void add_rhs(int row, double value) { b[row] -= (Scalar)value; }
+};
+
+/**
+ * @brief Assemble the LSCM normal matrix and RHS of an island into sink
+ *
+ * For vertices k, l of a triangle with coefficients a + ib, the 2x2 block
+ * of r r^T + s s^T (r, s being the real/imaginary rows of M) is
+ * [[c, d], [-d, c]] with c = a_k a_l + b_k b_l and d = b_k a_l - a_k b_l.
+ * Blocks whose column is pinned are moved to the RHS using the pinned
+ * values; blocks whose row is pinned are dropped. Coefficients are always
+ * computed in double. The pin policy and sink are template parameters,
+ * so the per-entry code is fixed at compile time; nearly every triangle
+ * has no pinned vertex and takes the sink's all-free path. Within a
+ * triangle each entry is added once, so both paths give the same sums.
+ * Assembles triangles [begin, end).
+ *
+ * @return false if options->should_cancel stopped the assembly
+ */
+template <typename Pins, typename Sink>
+static bool assemble_lscm(const Mesh* mesh,
+                          const int* face_indices,
+                          const int* local_tris,
+                          int begin,
+                          int end,
+                          const float* face_frames,
+                          const LscmOptions* options,
+                          const Pins& pins,
+                          Sink& sink) {
+    // Coefficients are precomputed a block at a time, then scattered
+    TriangleCoefficients coeffs[COEFF_BLOCK];
+    unsigned char valid[COEFF_BLOCK];
+    for (int t = begin; t < end; t++) {
+        int slot = (t - begin) % COEFF_BLOCK;
+        if (slot == 0) {
+            if (uvunwrap::lscm_cancelled(options)) return false;
+            int n = std::min(COEFF_BLOCK, end - t);
+            triangle_lscm_coefficients(mesh, face_indices + t, n, face_frames ? face_frames + 3 * t : NULL,
+                                       coeffs, valid);
+        }
+        if (!valid[slot]) continue;
+        const double* a = coeffs[slot].re;
+        const double* im = coeffs[slot].im;
+        const int* tri = &local_tris[t * 3];
+
+        if (!Pins::pinned || pins.all_free(tri)) {
+            sink.add_free_triangle(t, tri, a, im);
+            continue;
+        }
+
+        for (int l = 0; l < 3; l++) {
+            for (int k = 0; k < 3; k++) {
+                double c = a[k] * a[l] + im[k] * im[l];
+                double d = im[k] * a[l] - a[k] * im[l];
+                // block[p][q] = coefficient of (row 2k+p, col 2l+q)
+                double block[2][2] = {{c, d}, {-d, c}};
+                for (int q = 0; q < 2; q++) {
+                    int col_dof = 2 * tri[l] + q;
+                    int col = pins.dof(col_dof);
+                    for (int p = 0; p < 2; p++) {
+                        int row = pins.dof(2 * tri[k] + p);
+                        if (row < 0) continue;
+                        if (col >= 0) {
+                            sink.add(t, tri, k, l, p, q, row, col, block[p][q]);
+                        } else {
+                            sink.add_rhs(row, block[p][q] * pins.value(col_dof));
+                        }
+                    }
+                }
+            }
+        }
     }
-    
-    // OK, efficiently:
-    // 1. Build triplets for A directly instead of M^T * M? Hard.
-    // 2. Prune A.
-    // Let's iterate A and keep only non-pinned entries, or diagonal for pinned.
-    
-    std::vector<T> A_triplets;
-    // Extract triplets from A
-    for (int k = 0; k < A.outerSize(); ++k) {
-        for (Eigen::SparseMatrix<double>::InnerIterator it(A, k); it; ++it) {
-             int r = it.row();
-             int c = it.col();
-             
-             bool r_pin = false, c_pin = false;
-             for(int p : pinned_vars) if(p == r) r_pin = true;
-             for(int p : pinned_vars) if(p == c) c_pin = true;
-             
-             if (r_pin || c_pin) {
-                 if (r == c) A_triplets.push_back(T(r, c, 1.0));
-             } else {
-                 A_triplets.push_back(T(r, c, it.value()));
-             }
+    return true;
+}
+
+/**
+ * @brief assemble_lscm() of a coloured island, a colour at a time
+ *
+ * The chunks of one colour are split among options->num_threads workers;
+ * they write disjoint entries (see colour_assembly_chunks()). Each entry
+ * receives its contributions in colour order, then face order within a
+ * chunk, so the sums do not depend on the thread count.
+ */
+template <typename Pins, typename Sink>
+static bool assemble_lscm_coloured(const Mesh* mesh,
+                                   const int* face_indices,
+                                   const int* local_tris,
+                                   int num_faces,
+                                   const float* face_frames,
+                                   const LscmOptions* options,
+                                   const Pins& pins,
+                                   Sink& sink,
+                                   const LscmSystem& system) {
+    int requested = options && options->num_threads > 1 ? options->num_threads : 1;
+    std::atomic<bool> stopped(false);
+    int num_colours = (int)system.colour_offsets.size() - 1;
+    for (int c = 0; c < num_colours && !stopped.load(std::memory_order_relaxed); c++) {
+        const int* chunks = &system.colour_chunks[system.colour_offsets[c]];
+        int count = system.colour_offsets[c + 1] - system.colour_offsets[c];
+        uvunwrap::parallel_for_ranges(count, std::min(requested, count), [&](int, int first, int last) {
+            for (int i = first; i < last && !stopped.load(std::memory_order_relaxed); i++) {
+                int begin = chunks[i] * system.colour_chunk;
+                int end = std::min(num_faces, begin + system.colour_chunk);
+                if (!assemble_lscm(mesh, face_indices, local_tris, begin, end, face_frames, options, pins, sink)) {
+                    stopped.store(true, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+    return !stopped.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Fill the values of A (the system's matrix in Scalar) and the RHS
+ *        b for the current geometry
+ *
+ * Picks the assemble_lscm() instantiation for the island: Scalar from the
+ * caller, the pin policy from the system, and the coloured form for an
+ * island with assembly colours. face_frames optionally gives each
+ * triangle's layout, see triangle_lscm_coefficients().
+ *
+ * @return false if options->should_cancel stopped the fill (A and b are
+ *         then incomplete)
+ */
+template <typename Scalar>
+static bool fill_lscm_system(const Mesh* mesh,
+                             const int* face_indices,
+                             const int* local_tris,
+                             int num_faces,
+                             const LscmSystem& system,
+                             Eigen::SparseMatrix<Scalar>& A,
+                             Eigen::Matrix<Scalar, Eigen::Dynamic, 1>& b,
+                             const float* face_frames = NULL,
+                             const LscmOptions* options = NULL) {
+    Scalar* values = A.valuePtr();
+    std::fill(values, values + A.nonZeros(), Scalar(0));
+    b = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>::Zero(system.num_free);
+
+    SparseSink<Scalar> sink = {system, values, b};
+    bool coloured = !system.colour_offsets.empty();
+    if (!system.pinned) {
+        if (coloured) {
+            return assemble_lscm_coloured(mesh, face_indices, local_tris, num_faces, face_frames, options,
+                                          FreeDofs(), sink, system);
         }
+        return assemble_lscm(mesh, face_indices, local_tris, 0, num_faces, face_frames, options, FreeDofs(), sink);
     }
-    
-    // Set RHS for pinned
-    for (int k = 0; k < 4; k++) {
-        b(pinned_vars[k]) = pinned_vals[k];
+    PinnedDofs pins = {system.dof_remap.data(), system.pin_values.data()};
+    if (coloured) {
+        return assemble_lscm_coloured(mesh, face_indices, local_tris, num_faces, face_frames, options, pins, sink,
+                                      system);
     }
-    
-    Eigen::SparseMatrix<double> A_final(2*n, 2*n);
-    A_final.setFromTriplets(A_triplets.begin(), A_triplets.end());
-    
-    // STEP 4: Solve
-    Eigen::SparseLU<Eigen::SparseMatrix<double>> solver;
-    solver.compute(A_final);
-    
-    if (solver.info() != Eigen::Success) {
-        fprintf(stderr, "LSCM: Decomposition failed\n");
-        return NULL;
+    return assemble_lscm(mesh, face_indices, local_tris, 0, num_faces, face_frames, options, pins, sink);
+}
+
+// Islands with at most this many vertices are solved by dense_lscm_solve().
+// The dense factor costs O(n^3) against the sparse path's fixed setup; they
+// break even between 36 and 49 vertices (about 40 µs per island)
+static const int DENSE_MAX_VERTICES = 40;
+// Smaller capacity tier, so the common tiny island does not reserve (or
+// zero) the largest matrix on the stack
+static const int DENSE_SMALL_VERTICES = 16;
+
+/** Stack storage for islands of at most MaxVertices vertices */
+template <int MaxVertices>
+struct DenseLscmStorage {
+    static const int MAX_DOFS = 2 * MaxVertices - 4;
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, 0, MAX_DOFS, MAX_DOFS> Matrix;
+    typedef Eigen::Matrix<double, Eigen::Dynamic, 1, 0, MAX_DOFS, 1> Vector;
+};
+
+/** assemble_lscm() sink writing into a dense matrix (see SparseSink) */
+template <typename Matrix, typename Vector>
+struct DenseSink {
+    Matrix& A;
+    Vector& b;
+    const int* dof_remap;
+
+    void add_free_triangle(int, const int* tri, const double* a, const double* im) {
+        for (int l = 0; l < 3; l++) {
+            for (int k = 0; k < 3; k++) {
+                double c = a[k] * a[l] + im[k] * im[l];
+                double d = im[k] * a[l] - a[k] * im[l];
+                double block[2][2] = {{c, d}, {-d, c}};
+                for (int q = 0; q < 2; q++) {
+                    int col = dof_remap[2 * tri[l] + q];
+                    for (int p = 0; p < 2; p++) A(dof_remap[2 * tri[k] + p], col) += block[p][q];
+                }
+            }
+        }
     }
-    
-    Eigen::VectorXd x = solver.solve(b);
-    
-    if (solver.info() != Eigen::Success) {
-        fprintf(stderr, "LSCM: Solve failed\n");
-        return NULL;
+
+    void add(int, const int*, int, int, int, int, int row, int col, double value) { A(row, col) += value; }
+
+    void add_rhs(int row, double value) { b[row] -= value; }
+};
+
+/**
+ * @brief Solve a tiny island's reduced system as a dense matrix
+ *
+ * With a couple of dozen unknowns the sparse path spends more on setup
+ * (pattern, CSC structure, symbolic analysis, plan entry) than on
+ * arithmetic. Here A and b live in fixed-capacity Eigen storage on the
+ * stack, are assembled by the same assemble_lscm() kernel as the sparse
+ * path (through a DenseSink), and are factored with a dense LDLT; nothing
+ * here touches the heap. Writes the island's UVs (pins included).
+ *
+ * @tparam MaxVertices Capacity tier, at least n
+ * @return false if A is not safely positive definite; the caller then
+ *         takes the sparse path and its fallback ladder
+ */
+template <int MaxVertices>
+static bool dense_lscm_solve(const Mesh* mesh,
+                             const int* face_indices,
+                             const int* local_tris,
+                             int num_faces,
+                             int n,
+                             int pinned_idx1,
+                             int pinned_idx2,
+                             const float* face_frames,
+                             float* uvs,
+                             long long* assembly_ns_out,
+                             long long* factor_ns_out,
+                             long long* solve_ns_out) {
+    long long assembly_start = uvunwrap::now_ns();
+    typedef typename DenseLscmStorage<MaxVertices>::Matrix Matrix;
+    typedef typename DenseLscmStorage<MaxVertices>::Vector Vector;
+    int dof_remap[2 * MaxVertices];
+    double pin_values[2 * MaxVertices];
+    for (int i = 0; i < 2 * n; i++) {
+        dof_remap[i] = 0;
+        pin_values[i] = 0.0;
+    }
+    dof_remap[pinned_idx1 * 2 + 0] = -1;
+    dof_remap[pinned_idx1 * 2 + 1] = -1;
+    dof_remap[pinned_idx2 * 2 + 0] = -1;
+    dof_remap[pinned_idx2 * 2 + 1] = -1;
+    pin_values[pinned_idx2 * 2 + 0] = 1.0;
+    int num_free = 0;
+    for (int i = 0; i < 2 * n; i++) {
+        if (dof_remap[i] >= 0) dof_remap[i] = num_free++;
     }
 
-    // STEP 5: Extract UVs
-    float* uvs = (float*)malloc(n * 2 * sizeof(float));
-    for (int i = 0; i < n; i++) {
-        uvs[i * 2 + 0] = (float)x[i * 2 + 0];
-        uvs[i * 2 + 1] = (float)x[i * 2 + 1];
+    Matrix A = Matrix::Zero(num_free, num_free);
+    Vector b = Vector::Zero(num_free);
+    DenseSink<Matrix, Vector> sink = {A, b, dof_remap};
+    PinnedDofs pins = {dof_remap, pin_values};
+    assemble_lscm(mesh, face_indices, local_tris, 0, num_faces, face_frames, NULL, pins, sink);
+    *assembly_ns_out = uvunwrap::now_ns() - assembly_start;
+
+    long long factor_start = uvunwrap::now_ns();
+    Eigen::LDLT<Matrix> ldlt(A);
+    *factor_ns_out = uvunwrap::now_ns() - factor_start;
+    // A singular island (all triangles degenerate, say) gives a zero pivot
+    // that LDLT would silently skip; leave it to the fallback ladder
+    double max_pivot = ldlt.vectorD().cwiseAbs().maxCoeff();
+    if (ldlt.info() != Eigen::Success || !ldlt.isPositive() ||
+        !(ldlt.vectorD().minCoeff() > max_pivot * 1e-12)) {
+        return false;
     }
 
-    normalize_uvs_to_unit_square(uvs, n);
+    long long solve_start = uvunwrap::now_ns();
+    Vector x = ldlt.solve(b);
+    *solve_ns_out = uvunwrap::now_ns() - solve_start;
+    if (!x.allFinite()) return false;
+    for (int i = 0; i < 2 * n; i++) {
+        uvs[i] = dof_remap[i] >= 0 ? (float)x[dof_remap[i]] : (float)pin_values[i];
+    }
+    return true;
+}
 
-    printf("  LSCM completed\n");
-    return uvs;
+// Defaults for zero-valued LscmOptions fields
+static const int DEFAULT_ITERATIVE_THRESHOLD = 500000;
+static const int DEFAULT_CG_MAX_ITERATIONS = 2000;
+static const double DEFAULT_CG_TOLERANCE = 1e-8;
+// Float CG stalls near its rounding floor; tighter tolerances only burn iterations
+static const double FLOAT_CG_TOLERANCE = 1e-5;
+static const int DEFAULT_PLAN_ENTRIES = 256;
+static const int DEFAULT_MULTIGRID_COARSE_VERTICES = 4000;
+static const int DEFAULT_MULTIGRID_SMOOTHING = 1;
+// Interpolation terms kept per removed vertex; more densifies the coarse operators
+static const int MULTIGRID_INTERPOLATION_TERMS = 4;
+
+// Tutte embedding used as the CG warm start only needs to be rough
+static const int TUTTE_MAX_ITERATIONS = 200;
+static const double TUTTE_TOLERANCE = 1e-4;
+
+void lscm_options_default(LscmOptions* options) {
+    if (!options) return;
+    memset(options, 0, sizeof(LscmOptions));
+    options->solver = LSCM_SOLVER_AUTO;
+}
+
+int lscm_solver_available(LscmSolver solver) {
+    switch (solver) {
+        case LSCM_SOLVER_AUTO:
+        case LSCM_SOLVER_LDLT:
+        case LSCM_SOLVER_LLT:
+        case LSCM_SOLVER_LU:
+        case LSCM_SOLVER_CG:
+        case LSCM_SOLVER_MULTIGRID:
+            return 1;
+        case LSCM_SOLVER_CUDA_CG:
+            return uvunwrap::gpu_available() ? 1 : 0;
+#ifdef UVUNWRAP_HAVE_CHOLMOD
+        case LSCM_SOLVER_CHOLMOD:
+            return 1;
+#endif
+#ifdef UVUNWRAP_HAVE_PARDISO
+        case LSCM_SOLVER_PARDISO:
+            return 1;
+#endif
+        default:
+            return 0;
+    }
+}
+
+int lscm_ordering_available(LscmOrdering ordering) {
+    switch (ordering) {
+        case LSCM_ORDERING_AUTO:
+        case LSCM_ORDERING_AMD:
+        case LSCM_ORDERING_COLAMD:
+        case LSCM_ORDERING_NATURAL:
+            return 1;
+#ifdef UVUNWRAP_HAVE_METIS
+        case LSCM_ORDERING_METIS:
+            return 1;
+#endif
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief Map a requested backend to one that is compiled in
+ */
+static LscmSolver resolve_solver(const LscmOptions* options, int num_vertices) {
+    int requested = options->solver;
+    if (requested == LSCM_SOLVER_AUTO) {
+        int threshold = options->iterative_threshold != 0 ? options->iterative_threshold
+                                                          : DEFAULT_ITERATIVE_THRESHOLD;
+        if (threshold > 0 && num_vertices > threshold) return LSCM_SOLVER_MULTIGRID;
+#ifdef UVUNWRAP_HAVE_CHOLMOD
+        // CHOLMOD is double only, so float solves stay on Eigen
+        if (options->precision == LSCM_PRECISION_DOUBLE) return LSCM_SOLVER_CHOLMOD;
+        return LSCM_SOLVER_LDLT;
+#else
+        return LSCM_SOLVER_LDLT;
+#endif
+    }
+    if (requested == LSCM_SOLVER_CUDA_CG && !lscm_solver_available(LSCM_SOLVER_CUDA_CG)) {
+        LOG_WARNING("LSCM: no CUDA device, using multigrid");
+        return LSCM_SOLVER_MULTIGRID;
+    }
+    if (!lscm_solver_available((LscmSolver)requested)) {
+        LOG_WARNING("LSCM: solver %d not available, using SimplicialLDLT", requested);
+        return LSCM_SOLVER_LDLT;
+    }
+    return (LscmSolver)requested;
+}
+
+/** CG, multigrid and CUDA CG: no factorisation of the island itself */
+static bool iterative_solver(LscmSolver solver) {
+    return solver == LSCM_SOLVER_CG || solver == LSCM_SOLVER_MULTIGRID || solver == LSCM_SOLVER_CUDA_CG;
+}
+
+/**
+ * @brief Ordering an Eigen direct backend factors with, AUTO resolved to
+ *        Eigen's default; AUTO for every other backend
+ */
+static LscmOrdering resolve_ordering(const LscmOptions* options, LscmSolver solver) {
+    if (solver != LSCM_SOLVER_LDLT && solver != LSCM_SOLVER_LLT && solver != LSCM_SOLVER_LU) {
+        return LSCM_ORDERING_AUTO;
+    }
+    int requested = options->ordering;
+    if (requested != LSCM_ORDERING_AUTO && !lscm_ordering_available((LscmOrdering)requested)) {
+        LOG_WARNING("LSCM: ordering %d not available, using the default", requested);
+        requested = LSCM_ORDERING_AUTO;
+    }
+    if (requested == LSCM_ORDERING_AUTO) {
+        return solver == LSCM_SOLVER_LU ? LSCM_ORDERING_COLAMD : LSCM_ORDERING_AMD;
+    }
+    return (LscmOrdering)requested;
+}
+
+/**
+ * @brief Precision a solve runs in; CHOLMOD, PARDISO, multigrid and CUDA
+ *        CG are double only
+ */
+static int resolve_precision(const LscmOptions* options, LscmSolver solver) {
+    int precision = options->precision;
+    if (precision != LSCM_PRECISION_FLOAT && precision != LSCM_PRECISION_FLOAT_REFINED) {
+        return LSCM_PRECISION_DOUBLE;
+    }
+    if (solver == LSCM_SOLVER_CHOLMOD || solver == LSCM_SOLVER_PARDISO || solver == LSCM_SOLVER_MULTIGRID ||
+        solver == LSCM_SOLVER_CUDA_CG) {
+        LOG_DEBUG("LSCM: solver %d is double only, ignoring float precision", (int)solver);
+        return LSCM_PRECISION_DOUBLE;
+    }
+    return precision;
+}
+
+/**
+ * @brief One coarse level of the multigrid preconditioner
+ *
+ * P interpolates the level's free DOFs (u and v of every vertex except
+ * the pins) onto those of the next finer level; A = P^T A_finer P is the
+ * Galerkin operator, rebuilt by every solve since the geometry may have
+ * changed.
+ */
+struct MultigridLevel {
+    Eigen::SparseMatrix<double> P;
+    Eigen::SparseMatrix<double> A;
+    Eigen::VectorXd inv_diag;
+};
+
+/**
+ * @brief Multigrid state of a plan entry, levels finest first
+ *
+ * The hierarchy and interpolation weights come from the geometry of the
+ * first solve and are reused; for a deformed island (or another island
+ * with the same connectivity) they are still a valid, if weaker,
+ * preconditioner, so the solution itself is unaffected.
+ */
+struct Multigrid {
+    std::vector<MultigridLevel> levels;
+    Eigen::VectorXd fine_inv_diag;
+    std::unique_ptr<DirectSolver<double> > coarse;  /**< Factorisation of the coarsest operator */
+};
+
+/**
+ * @brief Cached island system: layout plus (for direct backends) the
+ *        analysed solver. The mutex serialises islands that share an entry.
+ */
+struct LscmPlanEntry {
+    std::mutex mutex;
+    uint64_t key;
+    std::vector<int> local_tris;
+    int pinned_idx1;
+    int pinned_idx2;
+    int pin_rule;
+    LscmSolver solver;
+    LscmOrdering ordering;
+    LscmSystem system;
+    std::unique_ptr<DirectSolver<double> > direct;
+    std::unique_ptr<DirectSolver<float> > direct_float;  /**< Created by the first float solve */
+    std::unique_ptr<Multigrid> multigrid;                /**< Created by the first multigrid solve */
+    std::unique_ptr<DirectSolver<double> > arap;         /**< Created by the first ARAP pass */
+};
+
+/**
+ * @brief Symbolic factorisation cache, keyed by island connectivity,
+ *        backend, ordering and pin rule; each entry also fixes the
+ *        island's pin choice
+ *
+ * The pin rule is the resolved LscmPinMethod, or PIN_RULE_USER when the
+ * caller's pinned_vertices decided the pins (the pins then must match too).
+ */
+struct LscmPlan {
+    std::mutex mutex;
+    int max_entries;
+    std::unordered_multimap<uint64_t, std::shared_ptr<LscmPlanEntry> > entries;
+};
+
+static const int PIN_RULE_USER = -1;
+
+// FNV-1a over the island's local triangles, backend, ordering and pin rule
+static uint64_t hash_island(const std::vector<int>& local_tris, LscmSolver solver, LscmOrdering ordering,
+                            int pin_rule) {
+    uint64_t h = 1469598103934665603ULL;
+    h = (h ^ (uint32_t)solver) * 1099511628211ULL;
+    h = (h ^ (uint32_t)ordering) * 1099511628211ULL;
+    h = (h ^ (uint32_t)pin_rule) * 1099511628211ULL;
+    for (size_t i = 0; i < local_tris.size(); i++) {
+        h = (h ^ (uint32_t)local_tris[i]) * 1099511628211ULL;
+    }
+    return h;
+}
+
+static std::shared_ptr<LscmPlanEntry> new_plan_entry(const std::vector<int>& local_tris, int n,
+                                                     int pinned_idx1, int pinned_idx2, int pin_rule,
+                                                     LscmSolver solver, LscmOrdering ordering) {
+    std::shared_ptr<LscmPlanEntry> entry(new LscmPlanEntry());
+    entry->key = hash_island(local_tris, solver, ordering, pin_rule);
+    entry->local_tris = local_tris;
+    entry->pinned_idx1 = pinned_idx1;
+    entry->pinned_idx2 = pinned_idx2;
+    entry->pin_rule = pin_rule;
+    entry->solver = solver;
+    entry->ordering = ordering;
+    build_lscm_system(local_tris.data(), (int)local_tris.size() / 3, n, pinned_idx1, pinned_idx2,
+                      entry->system);
+    if (!iterative_solver(solver)) {
+        entry->direct = create_direct_solver(solver, ordering);
+    }
+    return entry;
+}
+
+/**
+ * @brief Find the cached entry for an island's connectivity and backend
+ * @return The entry, or an empty pointer on a miss
+ */
+/** user_pin1/2 are only compared for PIN_RULE_USER */
+static std::shared_ptr<LscmPlanEntry> plan_find(LscmPlan* plan,
+                                                const std::vector<int>& local_tris,
+                                                LscmSolver solver, LscmOrdering ordering, int pin_rule,
+                                                int user_pin1, int user_pin2) {
+    uint64_t key = hash_island(local_tris, solver, ordering, pin_rule);
+    std::lock_guard<std::mutex> lock(plan->mutex);
+    auto range = plan->entries.equal_range(key);
+    for (auto it = range.first; it != range.second; ++it) {
+        const LscmPlanEntry& entry = *it->second;
+        if (entry.solver != solver || entry.ordering != ordering || entry.pin_rule != pin_rule) continue;
+        if (pin_rule == PIN_RULE_USER &&
+            (entry.pinned_idx1 != user_pin1 || entry.pinned_idx2 != user_pin2)) {
+            continue;
+        }
+        if (entry.local_tris == local_tris) {
+            return it->second;
+        }
+    }
+    return std::shared_ptr<LscmPlanEntry>();
+}
+
+/**
+ * @brief Add a freshly built entry to the plan
+ *
+ * A concurrent miss on the same island may insert a duplicate; it is
+ * harmless since lookups return the first match.
+ */
+static void plan_insert(LscmPlan* plan, const std::shared_ptr<LscmPlanEntry>& entry) {
+    std::lock_guard<std::mutex> lock(plan->mutex);
+    if ((int)plan->entries.size() >= plan->max_entries) {
+        // Entries in use elsewhere stay alive through their shared_ptr
+        plan->entries.clear();
+    }
+    plan->entries.insert(std::make_pair(entry->key, entry));
+}
+
+LscmPlan* lscm_plan_create(int max_entries) {
+    LscmPlan* plan = new LscmPlan();
+    plan->max_entries = max_entries > 0 ? max_entries : DEFAULT_PLAN_ENTRIES;
+    return plan;
+}
+
+void lscm_plan_free(LscmPlan* plan) {
+    delete plan;
+}
+
+/**
+ * @brief Preconditioned CG iterations, operation for operation Eigen's
+ *        internal::conjugate_gradient(), polling should_cancel between them
+ *
+ * Eigen runs all iterations in one call; this loop matches its results
+ * (the matrix is applied transposed, as Eigen does for Lower|Upper)
+ * while letting a cancelled solve stop within one iteration.
+ *
+ * @return false if cancelled (x holds the last iterate)
+ */
+template <typename Scalar, typename Preconditioner>
+static bool pcg_iterate(const LscmOptions* options,
+                        const Eigen::SparseMatrix<Scalar>& A,
+                        const Preconditioner& precond,
+                        const Eigen::Matrix<Scalar, Eigen::Dynamic, 1>& b,
+                        Eigen::Matrix<Scalar, Eigen::Dynamic, 1>& x,
+                        int max_iterations,
+                        Scalar tolerance,
+                        int* iterations_out,
+                        double* error_out) {
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1> Vector;
+    *iterations_out = 0;
+    *error_out = 0.0;
+    Vector residual = b - A.transpose() * x;
+    Scalar b_norm2 = b.squaredNorm();
+    if (b_norm2 == 0) {
+        x.setZero();
+        return true;
+    }
+    Scalar threshold = std::max(Scalar(tolerance * tolerance * b_norm2), std::numeric_limits<Scalar>::min());
+    Scalar residual_norm2 = residual.squaredNorm();
+    if (residual_norm2 < threshold) {
+        *error_out = std::sqrt(residual_norm2 / b_norm2);
+        return true;
+    }
+
+    Vector p = precond.solve(residual);
+    Vector z(b.size()), Ap(b.size());
+    Scalar rz = residual.dot(p);
+    int i = 0;
+    while (i < max_iterations) {
+        if (uvunwrap::lscm_cancelled(options)) return false;
+        Ap.noalias() = A.transpose() * p;
+        Scalar alpha = rz / p.dot(Ap);
+        x += alpha * p;
+        residual -= alpha * Ap;
+        residual_norm2 = residual.squaredNorm();
+        if (residual_norm2 < threshold) break;
+        z = precond.solve(residual);
+        Scalar rz_old = rz;
+        rz = residual.dot(z);
+        p = z + (rz / rz_old) * p;
+        i++;
+    }
+    *iterations_out = i;
+    *error_out = std::sqrt(residual_norm2 / b_norm2);
+    return true;
+}
+
+template <typename Scalar, typename Preconditioner>
+static bool cg_solve(const LscmOptions* options,
+                     const Eigen::SparseMatrix<Scalar>& A,
+                     const Eigen::Matrix<Scalar, Eigen::Dynamic, 1>& b,
+                     const Eigen::Matrix<Scalar, Eigen::Dynamic, 1>& x0,
+                     Eigen::Matrix<Scalar, Eigen::Dynamic, 1>& x,
+                     int* iterations_out,
+                     double* residual_out,
+                     long long* factor_ns_out) {
+    int max_iterations = options->cg_max_iterations > 0 ? options->cg_max_iterations : DEFAULT_CG_MAX_ITERATIONS;
+    double tolerance = options->cg_tolerance > 0.0 ? options->cg_tolerance : DEFAULT_CG_TOLERANCE;
+    if (sizeof(Scalar) < sizeof(double)) tolerance = std::max(tolerance, FLOAT_CG_TOLERANCE);
+
+    Preconditioner precond;
+    long long start = uvunwrap::now_ns();
+    precond.compute(A);
+    *factor_ns_out = uvunwrap::now_ns() - start;
+    if (precond.info() != Eigen::Success) {
+        LOG_ERROR("LSCM: Preconditioner setup failed");
+        return false;
+    }
+
+    x = x0;
+    if (!pcg_iterate(options, A, precond, b, x, max_iterations, (Scalar)tolerance, iterations_out, residual_out)) {
+        return false;
+    }
+    if (*residual_out > (Scalar)tolerance) {
+        // Left to the fallback ladder, which solves the island directly
+        LOG_WARNING("LSCM: CG did not converge (%d iterations, residual %g)",
+                    *iterations_out, *residual_out);
+        return false;
+    }
+    return true;
+}
+
+template <typename Scalar>
+static bool cg_solve_preconditioned(const LscmOptions* options,
+                                    const Eigen::SparseMatrix<Scalar>& A,
+                                    const Eigen::Matrix<Scalar, Eigen::Dynamic, 1>& b,
+                                    const Eigen::Matrix<Scalar, Eigen::Dynamic, 1>& x0,
+                                    Eigen::Matrix<Scalar, Eigen::Dynamic, 1>& x,
+                                    int* iterations_out,
+                                    double* residual_out,
+                                    long long* factor_ns_out) {
+    if (options->cg_preconditioner == LSCM_PRECONDITIONER_ICHOL) {
+        return cg_solve<Scalar, Eigen::IncompleteCholesky<Scalar> >(options, A, b, x0, x, iterations_out,
+                                                                    residual_out, factor_ns_out);
+    }
+    return cg_solve<Scalar, Eigen::DiagonalPreconditioner<Scalar> >(options, A, b, x0, x, iterations_out,
+                                                                    residual_out, factor_ns_out);
+}
+
+/** ||b - A x|| / ||b|| in double */
+static double relative_residual(const Eigen::SparseMatrix<double>& A, const Eigen::VectorXd& b,
+                                const Eigen::VectorXd& x) {
+    double norm = b.norm();
+    return norm > 0.0 ? (b - A * x).norm() / norm : 0.0;
+}
+
+// Tikhonov weight of the regularised fallback, relative to mean |diag(A)|
+static const double FALLBACK_REGULARIZATION = 1e-8;
+
+static const char* fallback_name(int fallback) {
+    static const char* names[] = {"none", "regularized", "alternate solver", "planar projection"};
+    return fallback >= 0 && fallback <= LSCM_FALLBACK_PLANAR ? names[fallback] : "unknown";
+}
+
+/**
+ * @brief Regularised rungs of the fallback ladder: A + lambda I with a
+ *        fresh direct solver, so a failed plan entry is left alone
+ * @return false if the backend fails too or x is not finite
+ */
+static bool regularized_solve(const Eigen::SparseMatrix<double>& A,
+                              const Eigen::VectorXd& b,
+                              LscmSolver backend,
+                              Eigen::VectorXd& x,
+                              long long* nonzeros_out,
+                              long long* factor_ns_out) {
+    double mean_diag = A.rows() > 0 ? A.diagonal().cwiseAbs().mean() : 0.0;
+    double lambda = FALLBACK_REGULARIZATION * (mean_diag > 0.0 ? mean_diag : 1.0);
+    Eigen::SparseMatrix<double> R = A;
+    for (Eigen::Index i = 0; i < R.rows(); i++) R.coeffRef(i, i) += lambda;
+
+    std::unique_ptr<DirectSolver<double> > direct = create_eigen_direct_solver<double>(backend);
+    return direct->factorize(R, nonzeros_out, factor_ns_out) && direct->solve(b, x) && x.allFinite();
+}
+
+/**
+ * @brief Last rung of the fallback ladder: orthographic projection onto
+ *        the plane of the island's area-weighted normal
+ */
+static void planar_projection(const Mesh* mesh,
+                              const int* face_indices,
+                              int num_faces,
+                              const std::vector<int>& local_to_global,
+                              float* uvs) {
+    using namespace uvunwrap;
+    Vec3 sum = {0.0f, 0.0f, 0.0f};
+    for (int i = 0; i < num_faces; i++) sum = add(sum, face_normal(mesh, face_indices[i]));
+    Vec3 normal = normalize(sum);
+    if (length(normal) == 0.0f) normal = Vec3{0.0f, 0.0f, 1.0f};
+
+    // Any in-plane frame will do; start from the world axis least aligned with the normal
+    Vec3 helper = fabsf(normal.x) < 0.9f ? Vec3{1.0f, 0.0f, 0.0f} : Vec3{0.0f, 1.0f, 0.0f};
+    Vec3 u_axis = normalize(cross(helper, normal));
+    Vec3 v_axis = cross(normal, u_axis);
+    for (size_t i = 0; i < local_to_global.size(); i++) {
+        Vec3 p = vertex_position(mesh, local_to_global[i]);
+        uvs[i * 2 + 0] = dot(p, u_axis);
+        uvs[i * 2 + 1] = dot(p, v_axis);
+    }
+}
+
+/**
+ * @brief Longest boundary loop (ties: smallest first vertex)
+ * @return Vertices of the loop (empty for a closed island)
+ */
+static std::vector<int> longest_boundary_loop(const std::vector<int>& loop_offsets,
+                                              const std::vector<int>& loop_vertices) {
+    int best = -1;
+    for (int l = 0; l + 1 < (int)loop_offsets.size(); l++) {
+        int size = loop_offsets[l + 1] - loop_offsets[l];
+        if (best < 0) {
+            best = l;
+            continue;
+        }
+        int best_size = loop_offsets[best + 1] - loop_offsets[best];
+        if (size > best_size ||
+            (size == best_size && loop_vertices[loop_offsets[l]] < loop_vertices[loop_offsets[best]])) {
+            best = l;
+        }
+    }
+    if (best < 0) return std::vector<int>();
+    return std::vector<int>(loop_vertices.begin() + loop_offsets[best],
+                            loop_vertices.begin() + loop_offsets[best + 1]);
+}
+
+/**
+ * @brief Uniform-weight Tutte embedding of an island
+ *
+ * The longest boundary loop is mapped to the unit circle by arc length and
+ * interior vertices are placed at the average of their neighbours (solved
+ * loosely with Jacobi CG). Used only as a CG warm start.
+ *
+ * @return false if the island has no usable boundary
+ */
+static bool tutte_embedding(const Mesh* mesh,
+                            const std::vector<int>& local_to_global,
+                            const std::vector<int>& loop_offsets,
+                            const std::vector<int>& loop_vertices,
+                            const LscmPattern& pattern,
+                            std::vector<double>& uv0) {
+    int n = (int)local_to_global.size();
+    std::vector<int> loop = longest_boundary_loop(loop_offsets, loop_vertices);
+    if (loop.size() < 3) return false;
+
+    uv0.assign(2 * n, 0.0);
+    std::vector<int> interior(n, 0);
+
+    std::vector<double> arc(loop.size() + 1, 0.0);
+    for (size_t i = 0; i < loop.size(); i++) {
+        Vec3 p = uvunwrap::vertex_position(mesh, local_to_global[loop[i]]);
+        Vec3 q = uvunwrap::vertex_position(mesh, local_to_global[loop[(i + 1) % loop.size()]]);
+        arc[i + 1] = arc[i] + uvunwrap::length(uvunwrap::sub(q, p));
+    }
+    double total = arc[loop.size()] > 0.0 ? arc[loop.size()] : 1.0;
+
+    std::vector<char> on_boundary(n, 0);
+    for (size_t i = 0; i < loop.size(); i++) {
+        double angle = 2.0 * M_PI * arc[i] / total;
+        uv0[2 * loop[i] + 0] = cos(angle);
+        uv0[2 * loop[i] + 1] = sin(angle);
+        on_boundary[loop[i]] = 1;
+    }
+
+    int num_interior = 0;
+    for (int i = 0; i < n; i++) {
+        interior[i] = on_boundary[i] ? -1 : num_interior++;
+    }
+    if (num_interior == 0) return true;
+
+    // Laplacian on interior vertices; boundary neighbours go to the RHS
+    typedef Eigen::Triplet<double> T;
+    std::vector<T> triplets;
+    Eigen::MatrixXd rhs = Eigen::MatrixXd::Zero(num_interior, 2);
+    for (int i = 0; i < n; i++) {
+        if (interior[i] < 0) continue;
+        int row = interior[i];
+        int degree = 0;
+        for (int e = pattern.nbr_offsets[i]; e < pattern.nbr_offsets[i + 1]; e++) {
+            int j = pattern.nbrs[e];
+            if (j == i) continue;
+            degree++;
+            if (interior[j] >= 0) {
+                triplets.push_back(T(row, interior[j], -1.0));
+            } else {
+                rhs(row, 0) += uv0[2 * j + 0];
+                rhs(row, 1) += uv0[2 * j + 1];
+            }
+        }
+        triplets.push_back(T(row, row, (double)degree));
+    }
+
+    Eigen::SparseMatrix<double> L(num_interior, num_interior);
+    L.setFromTriplets(triplets.begin(), triplets.end());
+
+    Eigen::ConjugateGradient<Eigen::SparseMatrix<double>, Eigen::Lower | Eigen::Upper> cg;
+    cg.setMaxIterations(TUTTE_MAX_ITERATIONS);
+    cg.setTolerance(TUTTE_TOLERANCE);
+    cg.compute(L);
+    Eigen::MatrixXd solution = cg.solve(rhs);
+
+    for (int i = 0; i < n; i++) {
+        if (interior[i] < 0) continue;
+        uv0[2 * i + 0] = solution(interior[i], 0);
+        uv0[2 * i + 1] = solution(interior[i], 1);
+    }
+    return true;
+}
+
+/**
+ * @brief Build the reduced CG initial guess from a full-length embedding
+ *
+ * The embedding is mapped by the similarity z -> (z - z1) / (z2 - z1) so
+ * the pinned vertices land on their pinned positions (0,0) and (1,0);
+ * conformal maps are invariant under similarities, so this loses nothing.
+ */
+static Eigen::VectorXd reduced_initial_guess(const std::vector<double>& uv0,
+                                             int pinned_idx1, int pinned_idx2,
+                                             const std::vector<int>& dof_remap,
+                                             int num_free) {
+    Eigen::VectorXd x0 = Eigen::VectorXd::Zero(num_free);
+    if (uv0.empty()) return x0;
+
+    double z1r = uv0[2 * pinned_idx1], z1i = uv0[2 * pinned_idx1 + 1];
+    double dr = uv0[2 * pinned_idx2] - z1r, di = uv0[2 * pinned_idx2 + 1] - z1i;
+    double denom = dr * dr + di * di;
+    if (denom < 1e-20) return x0;
+
+    int n = (int)uv0.size() / 2;
+    for (int i = 0; i < n; i++) {
+        double zr = uv0[2 * i] - z1r, zi = uv0[2 * i + 1] - z1i;
+        // (zr + i zi) / (dr + i di)
+        double u = (zr * dr + zi * di) / denom;
+        double v = (zi * dr - zr * di) / denom;
+        if (dof_remap[2 * i] >= 0) x0[dof_remap[2 * i]] = u;
+        if (dof_remap[2 * i + 1] >= 0) x0[dof_remap[2 * i + 1]] = v;
+    }
+    return x0;
+}
+
+/**
+ * @brief Free-DOF index of each island vertex coordinate on a level
+ *
+ * Same numbering as build_lscm_system() for the island itself; -1 for
+ * pinned coordinates and vertices the level does not have.
+ */
+static int level_dofs(const std::vector<int>& tris, int n, int pinned_idx1, int pinned_idx2,
+                      std::vector<int>& dofs) {
+    dofs.assign(2 * n, -1);
+    std::vector<char> present(n, 0);
+    for (int v : tris) present[v] = 1;
+    int num_free = 0;
+    for (int v = 0; v < n; v++) {
+        if (!present[v] || v == pinned_idx1 || v == pinned_idx2) continue;
+        dofs[2 * v + 0] = num_free++;
+        dofs[2 * v + 1] = num_free++;
+    }
+    return num_free;
+}
+
+/**
+ * @brief Decimate the island and build the interpolation between levels
+ *
+ * The pins are locked in the decimation, so every level keeps them and
+ * their (zero) corrections drop out of P.
+ */
+static void build_multigrid(const Mesh* mesh,
+                            const std::vector<int>& local_to_global,
+                            const std::vector<int>& local_tris,
+                            int pinned_idx1, int pinned_idx2,
+                            int coarse_vertices,
+                            Multigrid& mg) {
+    std::vector<uvunwrap::LscmLevel> hierarchy;
+    uvunwrap::build_lscm_hierarchy(mesh, local_to_global, local_tris, pinned_idx1, pinned_idx2,
+                                   coarse_vertices, hierarchy);
+
+    int n = (int)local_to_global.size();
+    std::vector<int> finer_dofs, dofs, row_offsets, cols;
+    std::vector<double> weights;
+    int num_finer = level_dofs(local_tris, n, pinned_idx1, pinned_idx2, finer_dofs);
+    const std::vector<int>* finer_tris = &local_tris;
+    mg.levels.resize(hierarchy.size());
+    for (size_t l = 0; l < hierarchy.size(); l++) {
+        int num_free = level_dofs(hierarchy[l].tris, n, pinned_idx1, pinned_idx2, dofs);
+        uvunwrap::level_prolongation(hierarchy[l], *finer_tris, n, MULTIGRID_INTERPOLATION_TERMS,
+                                     row_offsets, cols, weights);
+
+        std::vector<Eigen::Triplet<double> > triplets;
+        for (int v = 0; v < n; v++) {
+            for (int e = row_offsets[v]; e < row_offsets[v + 1]; e++) {
+                for (int q = 0; q < 2; q++) {
+                    int row = finer_dofs[2 * v + q];
+                    int col = dofs[2 * cols[e] + q];
+                    if (row >= 0 && col >= 0) triplets.push_back(Eigen::Triplet<double>(row, col, weights[e]));
+                }
+            }
+        }
+        Eigen::SparseMatrix<double>& P = mg.levels[l].P;
+        P.resize(num_finer, num_free);
+        P.setFromTriplets(triplets.begin(), triplets.end());
+
+        finer_dofs.swap(dofs);
+        num_finer = num_free;
+        finer_tris = &hierarchy[l].tris;
+    }
+    mg.coarse = create_eigen_direct_solver<double>(LSCM_SOLVER_LDLT);
+}
+
+/** Galerkin operators for the island matrix A, and the coarsest factorisation */
+static bool multigrid_setup(const Eigen::SparseMatrix<double>& A, Multigrid& mg, long long* factor_ns_out) {
+    mg.fine_inv_diag = A.diagonal().cwiseInverse();
+    const Eigen::SparseMatrix<double>* finer = &A;
+    for (size_t l = 0; l < mg.levels.size(); l++) {
+        MultigridLevel& level = mg.levels[l];
+        Eigen::SparseMatrix<double> AP = *finer * level.P;
+        level.A = level.P.transpose() * AP;
+        level.inv_diag = level.A.diagonal().cwiseInverse();
+        finer = &level.A;
+    }
+    long long nonzeros = 0;
+    return mg.coarse->factorize(*finer, &nonzeros, factor_ns_out);
+}
+
+/** One Gauss-Seidel sweep on a fully stored symmetric A (columns are rows) */
+static void gauss_seidel(const Eigen::SparseMatrix<double>& A, const Eigen::VectorXd& inv_diag,
+                         const Eigen::VectorXd& b, Eigen::VectorXd& x, bool backward) {
+    const int* outer = A.outerIndexPtr();
+    const int* inner = A.innerIndexPtr();
+    const double* values = A.valuePtr();
+    int size = (int)A.cols();
+    for (int k = 0; k < size; k++) {
+        int j = backward ? size - 1 - k : k;
+        double r = b[j];
+        for (int p = outer[j]; p < outer[j + 1]; p++) r -= values[p] * x[inner[p]];
+        x[j] += r * inv_diag[j];
+    }
+}
+
+/**
+ * @brief Symmetric V-cycle x ~= A_depth^-1 b (depth 0 is the island)
+ *
+ * Forward Gauss-Seidel sweeps, coarse correction, backward sweeps: the
+ * cycle is a symmetric operator, as preconditioned CG needs.
+ */
+static void multigrid_vcycle(Multigrid& mg, const Eigen::SparseMatrix<double>& fine, size_t depth,
+                             int sweeps, const Eigen::VectorXd& b, Eigen::VectorXd& x) {
+    if (depth == mg.levels.size()) {
+        mg.coarse->solve(b, x);
+        return;
+    }
+    const Eigen::SparseMatrix<double>& A = depth == 0 ? fine : mg.levels[depth - 1].A;
+    const Eigen::VectorXd& inv_diag = depth == 0 ? mg.fine_inv_diag : mg.levels[depth - 1].inv_diag;
+    const Eigen::SparseMatrix<double>& P = mg.levels[depth].P;
+
+    x.setZero(b.size());
+    for (int s = 0; s < sweeps; s++) gauss_seidel(A, inv_diag, b, x, false);
+    Eigen::VectorXd coarse_b = P.transpose() * (b - A * x);
+    Eigen::VectorXd coarse_x;
+    multigrid_vcycle(mg, fine, depth + 1, sweeps, coarse_b, coarse_x);
+    x += P * coarse_x;
+    for (int s = 0; s < sweeps; s++) gauss_seidel(A, inv_diag, b, x, true);
+}
+
+/**
+ * @brief Full-multigrid start: solve the coarsest level directly, then
+ *        interpolate onto each finer level and correct with a V-cycle
+ */
+static void multigrid_initial_guess(Multigrid& mg, const Eigen::SparseMatrix<double>& fine, int sweeps,
+                                    const Eigen::VectorXd& b, Eigen::VectorXd& x) {
+    size_t depth = mg.levels.size();
+    std::vector<Eigen::VectorXd> rhs(depth + 1);
+    rhs[0] = b;
+    for (size_t l = 0; l < depth; l++) rhs[l + 1] = mg.levels[l].P.transpose() * rhs[l];
+    mg.coarse->solve(rhs[depth], x);
+    Eigen::VectorXd correction;
+    for (size_t l = depth; l-- > 0;) {
+        const Eigen::SparseMatrix<double>& A = l == 0 ? fine : mg.levels[l - 1].A;
+        Eigen::VectorXd finer = mg.levels[l].P * x;
+        multigrid_vcycle(mg, fine, l, sweeps, rhs[l] - A * finer, correction);
+        x = finer + correction;
+    }
+}
+
+/**
+ * @brief Solve the island system A x = b of entry with V-cycle
+ *        preconditioned CG from a full-multigrid start
+ *
+ * Islands no larger than the coarse size have no levels and are factored
+ * directly. Convergence is tested like Eigen's CG (||r|| / ||b||).
+ *
+ * @param on_device In: finish with Jacobi CG on the CUDA device
+ *        (gpu_pcg) instead of V-cycle CG on the host. Out: false if the
+ *        device failed and the host finished the solve
+ * @param setup_ns_out Hierarchy build, Galerkin products and the coarse
+ *        factorisation
+ */
+static bool multigrid_solve(const Mesh* mesh,
+                            const LscmOptions* options,
+                            const std::vector<int>& local_to_global,
+                            const std::vector<int>& local_tris,
+                            LscmPlanEntry& entry,
+                            const Eigen::SparseMatrix<double>& A,
+                            const Eigen::VectorXd& b,
+                            Eigen::VectorXd& x,
+                            bool* on_device,
+                            int* iterations_out,
+                            double* residual_out,
+                            long long* setup_ns_out) {
+    long long setup_start = uvunwrap::now_ns();
+    if (!entry.multigrid) {
+        int coarse_vertices = options->multigrid_coarse_vertices > 0 ? options->multigrid_coarse_vertices
+                                                                     : DEFAULT_MULTIGRID_COARSE_VERTICES;
+        entry.multigrid.reset(new Multigrid());
+        build_multigrid(mesh, local_to_global, local_tris, entry.pinned_idx1, entry.pinned_idx2,
+                        coarse_vertices, *entry.multigrid);
+    }
+    Multigrid& mg = *entry.multigrid;
+    long long factor_ns = 0;
+    bool ok = multigrid_setup(A, mg, &factor_ns);
+    *setup_ns_out = uvunwrap::now_ns() - setup_start;
+    *iterations_out = 0;
+    *residual_out = 0.0;
+    if (!ok) return false;
+    if (mg.levels.empty()) return mg.coarse->solve(b, x);
+
+    int sweeps = options->multigrid_smoothing > 0 ? options->multigrid_smoothing : DEFAULT_MULTIGRID_SMOOTHING;
+    int max_iterations = options->cg_max_iterations > 0 ? options->cg_max_iterations : DEFAULT_CG_MAX_ITERATIONS;
+    double tolerance = options->cg_tolerance > 0.0 ? options->cg_tolerance : DEFAULT_CG_TOLERANCE;
+    double b_norm = b.norm();
+    if (b_norm == 0.0) {
+        x.setZero(b.size());
+        return true;
+    }
+    multigrid_initial_guess(mg, A, sweeps, b, x);
+
+    Eigen::VectorXd r = b - A * x;
+    double residual = r.norm() / b_norm;
+    int iterations = 0;
+    if (*on_device && residual > tolerance) {
+        if (uvunwrap::gpu_pcg((int)A.cols(), A.outerIndexPtr(), A.innerIndexPtr(), A.valuePtr(), b.data(), x.data(),
+                              max_iterations, tolerance, options, iterations_out, residual_out)) {
+            if (*residual_out > tolerance) {
+                LOG_WARNING("LSCM: CUDA CG did not converge (%d iterations, residual %g)", *iterations_out,
+                            *residual_out);
+                return false;
+            }
+            return true;
+        }
+        if (uvunwrap::lscm_cancelled(options)) return false;
+        LOG_WARNING("LSCM: CUDA CG failed, finishing the island on the host");
+        *on_device = false;
+        r = b - A * x;
+        residual = r.norm() / b_norm;
+    }
+    if (residual > tolerance) {
+        Eigen::VectorXd z, p, Ap;
+        multigrid_vcycle(mg, A, 0, sweeps, r, z);
+        p = z;
+        double rz = r.dot(z);
+        while (iterations < max_iterations) {
+            if (uvunwrap::lscm_cancelled(options)) return false;
+            Ap = A * p;
+            double alpha = rz / p.dot(Ap);
+            x += alpha * p;
+            r -= alpha * Ap;
+            iterations++;
+            residual = r.norm() / b_norm;
+            if (residual <= tolerance) break;
+            multigrid_vcycle(mg, A, 0, sweeps, r, z);
+            double rz_next = r.dot(z);
+            p = z + (rz_next / rz) * p;
+            rz = rz_next;
+        }
+    }
+    *iterations_out = iterations;
+    *residual_out = residual;
+    if (residual > tolerance) {
+        // Left to the fallback ladder, as with plain CG
+        LOG_WARNING("LSCM: Multigrid CG did not converge (%d iterations, residual %g)", iterations, residual);
+        return false;
+    }
+    return true;
+}
+
+// Spectral conformal parameterisation (LSCM_METHOD_SPECTRAL)
+static const int SCP_BLOCK = 4;
+typedef Eigen::Matrix<double, SCP_BLOCK, SCP_BLOCK> RitzMatrix;
+static const int SCP_MAX_ITERATIONS = 100;
+static const double SCP_TOLERANCE = 1e-6;
+// Shift of L_C + sigma B, relative to trace(L_C) / trace(B)
+static const double SCP_SHIFT = 1e-6;
+
+/**
+ * @brief Spectral conformal map of an island
+ *
+ * L_C is the LSCM matrix assembled with no pins (the same fill as the
+ * pinned system, before any DOF is eliminated). Its null space is the two
+ * translations. Each subspace iteration applies (L_C + sigma B)^-1 B to a
+ * block of SCP_BLOCK vectors, removes their B-components along the
+ * translations, orthonormalises them and solves the projected pencil
+ * (Rayleigh-Ritz). Conformal eigenvalues come in pairs (a map and its
+ * 90 degree rotation), so the block holds the two smallest pairs. The
+ * start block is built from the vertex positions, which is already the
+ * answer for a flat island.
+ *
+ * @param uv Output per local vertex [u, v, ...], not normalised
+ * @return false if the factorisation fails, the iteration does not
+ *         reach SCP_TOLERANCE or options->should_cancel stops it
+ */
+static bool spectral_solve(const Mesh* mesh,
+                           const int* face_indices,
+                           int num_faces,
+                           const std::vector<int>& local_to_global,
+                           const std::vector<int>& local_tris,
+                           const LscmOptions* options,
+                           LscmSolver solver,
+                           std::vector<double>& uv,
+                           LscmReport* report) {
+    using namespace uvunwrap;
+    int n = (int)local_to_global.size();
+    int dofs = 2 * n;
+
+    long long assembly_start = now_ns();
+    LscmSystem system;
+    build_lscm_system(local_tris.data(), num_faces, n, -1, -1, system);
+    Eigen::VectorXd zero_rhs;
+    if (!fill_lscm_system(mesh, face_indices, local_tris.data(), num_faces, system, system.A, zero_rhs, NULL,
+                          options)) {
+        return false;
+    }
+    const Eigen::SparseMatrix<double>& L = system.A;
+
+    // B: unit mass on boundary vertices; a closed island has none, so it
+    // gets the lumped area mass instead
+    std::vector<int> loop_offsets, loop_vertices;
+    triangle_boundary_loops(local_tris.data(), num_faces, n, loop_offsets, loop_vertices);
+    Eigen::VectorXd mass = Eigen::VectorXd::Zero(dofs);
+    if (!loop_vertices.empty()) {
+        for (size_t k = 0; k < loop_vertices.size(); k++) {
+            mass[2 * loop_vertices[k] + 0] = 1.0;
+            mass[2 * loop_vertices[k] + 1] = 1.0;
+        }
+    } else {
+        for (int t = 0; t < num_faces; t++) {
+            double third = length(face_normal(mesh, face_indices[t])) / 6.0;
+            for (int k = 0; k < 3; k++) {
+                mass[2 * local_tris[t * 3 + k] + 0] += third;
+                mass[2 * local_tris[t * 3 + k] + 1] += third;
+            }
+        }
+    }
+    double trace_l = L.diagonal().sum();
+    double trace_b = mass.sum();
+    if (!(trace_l > 0.0) || !(trace_b > 0.0)) return false;
+
+    Eigen::SparseMatrix<double> K = L;
+    double sigma = SCP_SHIFT * trace_l / trace_b;
+    for (int i = 0; i < dofs; i++) K.coeffRef(i, i) += sigma * mass[i];
+    long long assembly_ns = now_ns() - assembly_start;
+
+    // Iterative backends have nothing to factor; the shifted system is SPD
+    LscmSolver backend = iterative_solver(solver) ? LSCM_SOLVER_LDLT : solver;
+    LscmOrdering ordering = resolve_ordering(options, backend);
+    std::unique_ptr<DirectSolver<double> > direct = create_direct_solver(backend, ordering);
+    long long nonzeros = 0, factor_ns = 0;
+    long long solve_start = now_ns();
+    if (!direct->factorize(K, &nonzeros, &factor_ns)) return false;
+
+    Eigen::MatrixXd X(dofs, SCP_BLOCK);
+    for (int i = 0; i < n; i++) {
+        Vec3 p = vertex_position(mesh, local_to_global[i]);
+        X(2 * i, 0) = p.x;  X(2 * i + 1, 0) = p.y;
+        X(2 * i, 1) = -p.y; X(2 * i + 1, 1) = p.x;
+        X(2 * i, 2) = p.z;  X(2 * i + 1, 2) = p.x;
+        X(2 * i, 3) = p.y;  X(2 * i + 1, 3) = p.z;
+    }
+
+    // Residual relative to the mean diagonal of L_C, which stays
+    // meaningful when the eigenvalue is 0 (flat islands)
+    double scale = trace_l / dofs;
+    double translation_mass = 0.5 * trace_b;
+    Eigen::MatrixXd Y(dofs, SCP_BLOCK);
+    Eigen::VectorXd rhs, y, x;
+    int iterations = 0;
+    double residual = HUGE_VAL;
+    while (iterations < SCP_MAX_ITERATIONS && !(residual <= SCP_TOLERANCE)) {
+        if (lscm_cancelled(options)) return false;
+        for (int c = 0; c < SCP_BLOCK; c++) {
+            rhs = mass.cwiseProduct(X.col(c));
+            if (!direct->solve(rhs, y)) return false;
+            for (int q = 0; q < 2; q++) {
+                double along = 0.0;
+                for (int i = q; i < dofs; i += 2) along += mass[i] * y[i];
+                along /= translation_mass;
+                for (int i = q; i < dofs; i += 2) y[i] -= along;
+            }
+            Y.col(c) = y;
+        }
+
+        // Modified Gram-Schmidt, twice: the block is only SCP_BLOCK wide
+        Eigen::MatrixXd& Q = Y;
+        for (int pass = 0; pass < 2; pass++) {
+            for (int c = 0; c < SCP_BLOCK; c++) {
+                for (int k = 0; k < c; k++) Q.col(c) -= Q.col(k).dot(Q.col(c)) * Q.col(k);
+                double norm = Q.col(c).norm();
+                if (!(norm > 0.0)) return false;
+                Q.col(c) /= norm;
+            }
+        }
+        Eigen::MatrixXd LQ = L * Q;
+        RitzMatrix Lr = Q.transpose() * LQ;
+        RitzMatrix Br = Q.transpose() * mass.asDiagonal() * Q;
+        Lr = 0.5 * (Lr + Lr.transpose()).eval();
+        Br = 0.5 * (Br + Br.transpose()).eval();
+
+        // Rayleigh-Ritz on the block: Lr v = theta Br v, reduced through
+        // Br = C C^T to (C^-1 Lr C^-T) w = theta w. That matrix is
+        // positive semi-definite like L_C, so its singular vectors are its
+        // eigenvectors; the smallest singular value comes last
+        Eigen::LLT<RitzMatrix> cholesky(Br);
+        if (cholesky.info() != Eigen::Success) return false;
+        RitzMatrix reduced = cholesky.matrixL().solve(cholesky.matrixL().solve(Lr).transpose());
+        Eigen::JacobiSVD<RitzMatrix> ritz(reduced, Eigen::ComputeFullU);
+        RitzMatrix V = cholesky.matrixU().solve(ritz.matrixU().rowwise().reverse());
+
+        X = Q * V;
+        x = X.col(0);
+        double theta = V.col(0).dot(Lr * V.col(0));
+        residual = (LQ * V.col(0) - theta * mass.cwiseProduct(x)).norm() / (scale * x.norm());
+        iterations++;
+    }
+    if (!(residual <= SCP_TOLERANCE) || !x.allFinite()) {
+        LOG_DEBUG("  Spectral: no convergence after %d iterations (residual %g)", iterations, residual);
+        return false;
+    }
+    LOG_DEBUG("  Spectral: %d iterations, residual %g", iterations, residual);
+
+    uv.assign(x.data(), x.data() + dofs);
+    report->solver = backend;
+    report->factor_nonzeros = nonzeros;
+    report->iterations = iterations;
+    report->residual = residual;
+    report->plan_hit = 0;
+    report->matrix_nonzeros = (long long)L.nonZeros();
+    report->assembly_ns = assembly_ns;
+    report->factor_ns = factor_ns;
+    report->solve_ns = now_ns() - solve_start - factor_ns;
+    report->precision = LSCM_PRECISION_DOUBLE;
+    report->fallback = LSCM_FALLBACK_NONE;
+    report->method = LSCM_METHOD_SPECTRAL;
+    report->angle_iterations = 0;
+    report->angle_ns = 0;
+    report->arap_iterations = 0;
+    report->arap_ns = 0;
+    report->ordering = ordering;
+    report->dense = 0;
+    report->closed_form = LSCM_CLOSED_FORM_NONE;
+    // Y (orthonormalised in place), L Y and X are dofs x SCP_BLOCK dense blocks
+    report->peak_bytes = sparse_bytes(L) + factor_bytes(nonzeros, sizeof(double)) +
+                         (long long)dofs * SCP_BLOCK * 3 * (long long)sizeof(double) +
+                         vector_bytes(local_tris) + vector_bytes(local_to_global);
+    return true;
+}
+
+/**
+ * @brief ARAP post-pass over raw island UVs (options->arap_iterations)
+ *
+ * Runs on the island's direct backend, or SimplicialLDLT for iterative
+ * ones. Leaves uvs untouched and logs if the Laplacian cannot be factored.
+ *
+ * @return false if options->should_cancel stopped it
+ */
+static bool arap_post_pass(const Mesh* mesh,
+                           const int* face_indices,
+                           const std::vector<int>& local_tris,
+                           int num_faces,
+                           int n,
+                           const LscmOptions* options,
+                           LscmSolver solver,
+                           std::unique_ptr<DirectSolver<double> >& arap_solver,
+                           float* uvs,
+                           LscmReport* report_out) {
+    if (options->arap_iterations <= 0) return true;
+    UV_TRACE_ZONE("arap");
+    long long start = uvunwrap::now_ns();
+    LscmSolver backend = iterative_solver(solver) ? LSCM_SOLVER_LDLT : solver;
+    long long time_limit_ns = options->arap_time_limit > 0.0 ? (long long)(options->arap_time_limit * 1e9) : 0;
+    long long bytes = 0;
+    int iterations = uvunwrap::arap_refine(mesh, face_indices, local_tris.data(), num_faces, n, options, backend,
+                                           options->arap_iterations, time_limit_ns, arap_solver, uvs, NULL,
+                                           &bytes);
+    if (uvunwrap::lscm_cancelled(options)) return false;
+    if (iterations < 0) {
+        LOG_WARNING("LSCM: ARAP Laplacian of an island of %d vertices could not be factored", n);
+        iterations = 0;
+    }
+    LOG_DEBUG("  ARAP: %d iterations", iterations);
+    if (report_out) {
+        report_out->arap_iterations = iterations;
+        report_out->arap_ns = uvunwrap::now_ns() - start;
+        // The island's LSCM system and factor are still held
+        report_out->peak_bytes += bytes;
+    }
+    return true;
+}
+
+float* lscm_parameterize(const Mesh* mesh,
+                         const int* face_indices,
+                         int num_faces) {
+    return lscm_parameterize_with_options(mesh, face_indices, num_faces, NULL, NULL);
+}
+
+/**
+ * @brief Shared LSCM driver
+ *
+ * Writes into uvs_out when given (capacity 3 * num_faces vertices),
+ * otherwise mallocs an exactly-sized array. vertex_remap is a dense
+ * global->local scratch of mesh->num_vertices entries, all -1; only the
+ * island's entries are touched and they are restored before returning.
+ * geometry, when it holds frames, replaces the projection of the 3D
+ * triangles (see lscm_parameterize_geometry()).
+ */
+static float* lscm_solve(const Mesh* mesh,
+                         const int* face_indices,
+                         int num_faces,
+                         const LscmOptions* options,
+                         LscmReport* report_out,
+                         float* uvs_out,
+                         int* num_verts_out,
+                         int* vertices_out,
+                         int* vertex_remap,
+                         const uvunwrap::TriangleGeometry* geometry = NULL,
+                         const int* geometry_faces = NULL) {
+    if (!mesh || !face_indices || num_faces == 0) return NULL;
+
+    LscmOptions defaults;
+    lscm_options_default(&defaults);
+    if (!options) options = &defaults;
+    if (uvunwrap::lscm_cancelled(options)) return NULL;
+    UV_TRACE_ZONE("lscm_parameterize");
+
+    LOG_DEBUG("LSCM parameterizing %d faces...", num_faces);
+
+    // STEP 1: Local vertex mapping and local triangles
+    std::vector<int> own_remap;
+    if (!vertex_remap) {
+        own_remap.assign(mesh->num_vertices, -1);
+        vertex_remap = own_remap.data();
+    }
+    int* global_to_local = vertex_remap;
+    std::vector<int> local_to_global;
+    std::vector<int> local_tris(num_faces * 3);
+
+    for (int i = 0; i < num_faces; i++) {
+        int f = face_indices[i];
+        for (int j = 0; j < 3; j++) {
+            int v_global = mesh->triangles[f*3 + j];
+            if (global_to_local[v_global] < 0) {
+                global_to_local[v_global] = local_to_global.size();
+                local_to_global.push_back(v_global);
+            }
+            local_tris[i * 3 + j] = global_to_local[v_global];
+        }
+    }
+
+    int n = local_to_global.size();
+    LOG_DEBUG("  Island has %d vertices", n);
+
+    // Caller pins are looked up while the remap is still populated
+    int pinned_idx1 = 0, pinned_idx2 = 0;
+    bool user_pins = uvunwrap::island_user_pins(options->pinned_vertices, options->num_pinned_vertices,
+                                                global_to_local, mesh->num_vertices,
+                                                &pinned_idx1, &pinned_idx2);
+    for (int i = 0; i < n; i++) global_to_local[local_to_global[i]] = -1;
+
+    // Optional locality renumbering; outputs are mapped back to first_seen
+    std::vector<int> first_seen;
+    std::vector<int> old_to_new;
+    std::vector<int> ordered_faces;
+    if (options->vertex_order != VERTEX_ORDER_INPUT && n >= 3) {
+        std::vector<int> new_to_old(n);
+        if (uvunwrap::locality_vertex_order(options->vertex_order, mesh, local_to_global.data(), local_tris.data(),
+                                            num_faces, n, new_to_old.data())) {
+            UV_TRACE_ZONE("lscm reorder");
+            first_seen = local_to_global;
+            old_to_new.resize(n);
+            for (int i = 0; i < n; i++) {
+                old_to_new[new_to_old[i]] = i;
+                local_to_global[i] = first_seen[new_to_old[i]];
+            }
+            std::vector<int> face_order(num_faces);
+            uvunwrap::locality_face_order(local_tris.data(), num_faces, n, old_to_new.data(), face_order.data());
+            std::vector<int> tris(local_tris.size());
+            ordered_faces.resize(num_faces);
+            for (int i = 0; i < num_faces; i++) {
+                int f = face_order[i];
+                ordered_faces[i] = face_indices[f];
+                for (int j = 0; j < 3; j++) tris[i * 3 + j] = old_to_new[local_tris[f * 3 + j]];
+            }
+            local_tris.swap(tris);
+            face_indices = ordered_faces.data();
+            pinned_idx1 = old_to_new[pinned_idx1];
+            pinned_idx2 = old_to_new[pinned_idx2];
+        }
+    }
+    // Back to first-seen order (a no-op without a renumbering)
+    auto restore_input_order = [&](float* uvs) {
+        if (first_seen.empty()) return;
+        std::vector<float> solved(uvs, uvs + 2 * n);
+        for (int i = 0; i < n; i++) {
+            uvs[2 * i + 0] = solved[2 * old_to_new[i] + 0];
+            uvs[2 * i + 1] = solved[2 * old_to_new[i] + 1];
+        }
+        local_to_global.swap(first_seen);
+    };
+
+    LscmSolver solver = resolve_solver(options, n);
+    if (options->method == LSCM_METHOD_SPECTRAL && n >= 3) {
+        std::vector<double> uv;
+        LscmReport spectral;
+        if (spectral_solve(mesh, face_indices, num_faces, local_to_global, local_tris, options, solver, uv,
+                           &spectral)) {
+            if (report_out) *report_out = spectral;
+            float* uvs = uvs_out ? uvs_out : (float*)malloc(n * 2 * sizeof(float));
+            for (int i = 0; i < 2 * n; i++) uvs[i] = (float)uv[i];
+            std::unique_ptr<DirectSolver<double> > arap_solver;
+            if (!arap_post_pass(mesh, face_indices, local_tris, num_faces, n, options, solver, arap_solver, uvs,
+                                report_out)) {
+                if (!uvs_out) free(uvs);
+                return NULL;
+            }
+            normalize_uvs_to_unit_square(uvs, n);
+            restore_input_order(uvs);
+            if (num_verts_out) *num_verts_out = n;
+            if (vertices_out) memcpy(vertices_out, local_to_global.data(), n * sizeof(int));
+            return uvs;
+        }
+        if (uvunwrap::lscm_cancelled(options)) return NULL;
+        LOG_WARNING("LSCM: Spectral solve of an island of %d vertices failed, solving it pinned", n);
+    }
+
+    LscmOrdering ordering = resolve_ordering(options, solver);
+    int pin_method = options->pin_method == LSCM_PIN_AUTO ? LSCM_PIN_DOUBLE_SWEEP : options->pin_method;
+    int pin_rule = user_pins ? PIN_RULE_USER : pin_method;
+
+    // Boundary loops (local indices) feed pin selection, the Tutte warm
+    // start and ABF++, so they are only built when one of those runs
+    bool plan_hit = false;
+    std::shared_ptr<LscmPlanEntry> entry;
+    std::vector<int> loop_offsets, loop_vertices;
+    if (n >= 3) {
+        if (options->plan) {
+            entry = plan_find(options->plan, local_tris, solver, ordering, pin_rule, pinned_idx1, pinned_idx2);
+            plan_hit = (bool)entry;
+        }
+        bool choose_pins = !entry && !user_pins;
+        if (choose_pins || (solver == LSCM_SOLVER_CG && !options->initial_uvs) ||
+            options->method == LSCM_METHOD_ABF) {
+            triangle_boundary_loops(local_tris.data(), num_faces, n, loop_offsets, loop_vertices);
+        }
+        if (choose_pins) {
+            UV_TRACE_ZONE("lscm pins");
+            uvunwrap::select_pins(mesh, local_to_global, loop_vertices, pin_method,
+                                  &pinned_idx1, &pinned_idx2);
+        }
+    }
+
+    if (n < 3) {
+        LOG_ERROR("LSCM: Island too small (%d vertices)", n);
+        return NULL;
+    }
+
+    // A plan entry remembers the pins chosen when it was built, so later
+    // solves of a deformed island reuse both the pins and the factorisation
+    if (entry) {
+        pinned_idx1 = entry->pinned_idx1;
+        pinned_idx2 = entry->pinned_idx2;
+    }
+
+    // Planar and developable islands have a zero-energy layout that needs
+    // no system at all
+    if (options->solver == LSCM_SOLVER_AUTO && options->method == LSCM_METHOD_PINNED) {
+        UV_TRACE_ZONE("lscm closed form");
+        long long closed_form_start = uvunwrap::now_ns();
+        float* uvs = uvs_out ? uvs_out : (float*)malloc(n * 2 * sizeof(float));
+        int closed_form = uvunwrap::closed_form_layout(mesh, local_tris.data(), num_faces, local_to_global,
+                                                       pinned_idx1, pinned_idx2, uvs);
+        if (closed_form != LSCM_CLOSED_FORM_NONE) {
+            if (report_out) {
+                using namespace uvunwrap;
+                memset(report_out, 0, sizeof(*report_out));
+                report_out->assembly_ns = now_ns() - closed_form_start;
+                report_out->precision = LSCM_PRECISION_DOUBLE;
+                report_out->fallback = LSCM_FALLBACK_NONE;
+                report_out->method = LSCM_METHOD_PINNED;
+                report_out->plan_hit = plan_hit ? 1 : 0;
+                report_out->peak_bytes = vector_bytes(local_tris) + vector_bytes(local_to_global) +
+                                         vector_bytes(own_remap) + vector_bytes(loop_offsets) +
+                                         vector_bytes(loop_vertices);
+                report_out->closed_form = closed_form;
+            }
+            normalize_uvs_to_unit_square(uvs, n);
+            restore_input_order(uvs);
+            LOG_DEBUG("  LSCM completed (closed form %d)", closed_form);
+            if (num_verts_out) *num_verts_out = n;
+            if (vertices_out) memcpy(vertices_out, local_to_global.data(), n * sizeof(int));
+            return uvs;
+        }
+        if (!uvs_out) free(uvs);
+    }
+
+    // ABF++ replaces each triangle's own shape with the layout of its
+    // optimised angles; the system is then solved like any other
+    int method = LSCM_METHOD_PINNED;
+    uvunwrap::AbfStats abf_stats;
+    memset(&abf_stats, 0, sizeof(abf_stats));
+    long long angle_ns = 0;
+    std::vector<float> abf_frames;
+    if (options->method == LSCM_METHOD_ABF) {
+        UV_TRACE_ZONE("abf");
+        long long abf_start = uvunwrap::now_ns();
+        LscmSolver backend = iterative_solver(solver) ? LSCM_SOLVER_LDLT : solver;
+        if (uvunwrap::abf_flatten(mesh, face_indices, local_tris.data(), num_faces, n, loop_vertices, options,
+                                  backend, abf_frames, &abf_stats)) {
+            method = LSCM_METHOD_ABF;
+            LOG_DEBUG("  ABF++: %d iterations, %d factorisations, residual %g", abf_stats.iterations,
+                      abf_stats.factorizations, abf_stats.residual);
+        } else if (uvunwrap::lscm_cancelled(options)) {
+            return NULL;
+        } else {
+            abf_frames.clear();
+            LOG_WARNING("LSCM: ABF++ failed on an island of %d vertices, using its 3D angles", n);
+        }
+        angle_ns = uvunwrap::now_ns() - abf_start;
+    }
+    // Otherwise the cached 3D frames, in the (possibly reordered) face order
+    std::vector<float> cached_frames;
+    if (abf_frames.empty() && geometry && (geometry->parts & uvunwrap::GEOMETRY_FRAMES)) {
+        cached_frames.resize((size_t)num_faces * 3);
+        for (int i = 0; i < num_faces; i++) {
+            int g = geometry_faces ? geometry_faces[face_indices[i]] : face_indices[i];
+            cached_frames[3 * i + 0] = geometry->x1[g];
+            cached_frames[3 * i + 1] = geometry->x2[g];
+            cached_frames[3 * i + 2] = geometry->y2[g];
+        }
+    }
+    const float* face_frames = !abf_frames.empty() ? abf_frames.data()
+                               : cached_frames.empty() ? NULL : cached_frames.data();
+
+    // Tiny islands skip the sparse machinery; a plan, an explicit backend
+    // or a float precision keeps them on the sparse path
+    if (n <= DENSE_MAX_VERTICES && !options->plan && options->solver == LSCM_SOLVER_AUTO &&
+        !iterative_solver(solver) && resolve_precision(options, solver) == LSCM_PRECISION_DOUBLE &&
+        pinned_idx1 >= 0 && pinned_idx2 >= 0 && pinned_idx1 != pinned_idx2) {
+        UV_TRACE_ZONE("lscm dense");
+        float* uvs = uvs_out ? uvs_out : (float*)malloc(n * 2 * sizeof(float));
+        long long assembly_ns = 0, factor_ns = 0, solve_ns = 0;
+        bool solved = n <= DENSE_SMALL_VERTICES
+            ? dense_lscm_solve<DENSE_SMALL_VERTICES>(mesh, face_indices, local_tris.data(), num_faces, n,
+                                                     pinned_idx1, pinned_idx2, face_frames, uvs,
+                                                     &assembly_ns, &factor_ns, &solve_ns)
+            : dense_lscm_solve<DENSE_MAX_VERTICES>(mesh, face_indices, local_tris.data(), num_faces, n,
+                                                   pinned_idx1, pinned_idx2, face_frames, uvs,
+                                                   &assembly_ns, &factor_ns, &solve_ns);
+        if (solved) {
+            if (report_out) {
+                using namespace uvunwrap;
+                long long num_free = 2 * n - 4;
+                memset(report_out, 0, sizeof(*report_out));
+                report_out->solver = LSCM_SOLVER_LDLT;
+                report_out->ordering = LSCM_ORDERING_AUTO;
+                report_out->matrix_nonzeros = num_free * num_free;
+                report_out->factor_nonzeros = num_free * (num_free + 1) / 2;
+                report_out->assembly_ns = assembly_ns;
+                report_out->factor_ns = factor_ns;
+                report_out->solve_ns = solve_ns;
+                report_out->precision = LSCM_PRECISION_DOUBLE;
+                report_out->fallback = LSCM_FALLBACK_NONE;
+                report_out->method = method;
+                report_out->angle_iterations = abf_stats.iterations;
+                report_out->angle_ns = angle_ns;
+                // A, its factor and b live on the stack
+                report_out->peak_bytes = vector_bytes(local_tris) + vector_bytes(local_to_global) +
+                                         vector_bytes(own_remap) + vector_bytes(loop_offsets) +
+                                         vector_bytes(loop_vertices) + vector_bytes(abf_frames);
+                report_out->dense = 1;
+                report_out->closed_form = LSCM_CLOSED_FORM_NONE;
+            }
+            std::unique_ptr<DirectSolver<double> > arap_solver;
+            if (!arap_post_pass(mesh, face_indices, local_tris, num_faces, n, options, solver, arap_solver, uvs,
+                                report_out)) {
+                if (!uvs_out) free(uvs);
+                return NULL;
+            }
+            normalize_uvs_to_unit_square(uvs, n);
+            restore_input_order(uvs);
+            LOG_DEBUG("  LSCM completed (dense)");
+            if (num_verts_out) *num_verts_out = n;
+            if (vertices_out) memcpy(vertices_out, local_to_global.data(), n * sizeof(int));
+            return uvs;
+        }
+        if (!uvs_out) free(uvs);
+        LOG_DEBUG("  Dense solve of an island of %d vertices failed, solving it sparse", n);
+    }
+
+    // STEP 2: Boundary conditions
+    if (!entry) {
+        entry = new_plan_entry(local_tris, n, pinned_idx1, pinned_idx2, pin_rule, solver, ordering);
+        if (options->plan) plan_insert(options->plan, entry);
+    }
+
+    // STEP 3: Assemble the reduced system A = M^T M
+    // M has two rows per triangle (real and imaginary parts of the
+    // discrete Cauchy-Riemann equation, weighted by sqrt(area)); each
+    // triangle's blocks of M^T M are scattered straight into a CSC
+    // matrix whose pattern comes from the island's vertex adjacency.
+    // Reference: "Least Squares Conformal Maps for Automatic Texture Atlas
+    // Generation", Levy et al.
+    // Entries may be shared by concurrent solves of identical islands
+    // Float mode assembles and factors in single precision; refined mode
+    // assembles in double so one refinement step can take the residual
+    // against the exact system, then factors a float copy
+    std::unique_lock<std::mutex> entry_lock(entry->mutex);
+    LscmSystem& system = entry->system;
+    int precision = resolve_precision(options, solver);
+    bool use_float = precision != LSCM_PRECISION_DOUBLE;
+
+    UV_TRACE_ZONE_BEGIN(assembly_zone, "lscm assembly");
+    long long assembly_start = uvunwrap::now_ns();
+    Eigen::VectorXd b;
+    Eigen::VectorXf b_float;
+    if (use_float) prepare_float_matrix(system);
+    if (precision == LSCM_PRECISION_FLOAT) {
+        if (!fill_lscm_system(mesh, face_indices, local_tris.data(), num_faces, system, system.A_float, b_float,
+                              face_frames, options)) {
+            return NULL;
+        }
+    } else {
+        if (!fill_lscm_system(mesh, face_indices, local_tris.data(), num_faces, system, system.A, b, face_frames,
+                              options)) {
+            return NULL;
+        }
+        if (use_float) {
+            // Entries at double roundoff level (exact zeros in float
+            // accumulation) are flushed: left in, they turn into denormals
+            // during factorization and slow it down more than twofold
+            const double* src = system.A.valuePtr();
+            float* dst = system.A_float.valuePtr();
+            Eigen::Index nnz = system.A.nonZeros();
+            double max_abs = 0.0;
+            for (Eigen::Index i = 0; i < nnz; i++) max_abs = std::max(max_abs, std::fabs(src[i]));
+            double flush_below = max_abs * FLT_EPSILON;
+            for (Eigen::Index i = 0; i < nnz; i++) {
+                dst[i] = std::fabs(src[i]) < flush_below ? 0.0f : (float)src[i];
+            }
+            b_float = b.cast<float>();
+        }
+    }
+    const Eigen::SparseMatrix<double>& A = system.A;
+    long long assembly_ns = uvunwrap::now_ns() - assembly_start;
+    UV_TRACE_ZONE_END(assembly_zone);
+
+    // STEP 4: Solve (factorisations are zones of their own, in direct_solver.h)
+    UV_TRACE_ZONE_BEGIN(solve_zone, "lscm solve");
+    long long nonzeros = 0;
+    long long factor_ns = 0;
+    long long solve_start = 0;
+    int iterations = 0;
+    double residual = 0.0;
+    bool solved = true;
+    Eigen::VectorXd x;
+
+    if (solver == LSCM_SOLVER_CG) {
+        std::vector<double> uv0;
+        if (options->initial_uvs) {
+            uv0.resize(2 * n);
+            for (int i = 0; i < n; i++) {
+                uv0[2 * i + 0] = options->initial_uvs[local_to_global[i] * 2 + 0];
+                uv0[2 * i + 1] = options->initial_uvs[local_to_global[i] * 2 + 1];
+            }
+        } else if (!tutte_embedding(mesh, local_to_global, loop_offsets, loop_vertices,
+                                    system.pattern, uv0)) {
+            uv0.clear();
+        }
+        Eigen::VectorXd x0 = reduced_initial_guess(uv0, pinned_idx1, pinned_idx2,
+                                                   system.dof_remap, system.num_free);
+
+        bool ok;
+        solve_start = uvunwrap::now_ns();
+        if (!use_float) {
+            ok = cg_solve_preconditioned<double>(options, A, b, x0, x, &iterations, &residual, &factor_ns);
+        } else {
+            Eigen::VectorXf x_float;
+            ok = cg_solve_preconditioned<float>(options, system.A_float, b_float, x0.cast<float>(), x_float,
+                                                &iterations, &residual, &factor_ns);
+            x = x_float.cast<double>();
+            if (ok && precision == LSCM_PRECISION_FLOAT_REFINED) {
+                // One step: solve A d = b - A x in float, residual in double
+                Eigen::VectorXf r = (b - A * x).cast<float>();
+                Eigen::VectorXf d;
+                int more_iterations = 0;
+                long long more_factor_ns = 0;
+                ok = cg_solve_preconditioned<float>(options, system.A_float, r, Eigen::VectorXf::Zero(r.size()), d,
+                                                    &more_iterations, &residual, &more_factor_ns);
+                x += d.cast<double>();
+                iterations += more_iterations;
+                factor_ns += more_factor_ns;
+                residual = relative_residual(A, b, x);
+            }
+        }
+        solved = ok;
+        if (ok) LOG_DEBUG("  CG: %d iterations, residual %g", iterations, residual);
+    } else if (solver == LSCM_SOLVER_MULTIGRID || solver == LSCM_SOLVER_CUDA_CG) {
+        solve_start = uvunwrap::now_ns();
+        bool on_device = solver == LSCM_SOLVER_CUDA_CG;
+        solved = multigrid_solve(mesh, options, local_to_global, local_tris, *entry, A, b, x, &on_device,
+                                 &iterations, &residual, &factor_ns);
+        if (!on_device) solver = LSCM_SOLVER_MULTIGRID;
+        if (solved) {
+            LOG_DEBUG("  %s: %zu levels, %d fine iterations, residual %g", on_device ? "CUDA CG" : "Multigrid",
+                      entry->multigrid->levels.size(), iterations, residual);
+        }
+    } else if (!use_float) {
+        solve_start = uvunwrap::now_ns();
+        solved = entry->direct->factorize(A, &nonzeros, &factor_ns) && entry->direct->solve(b, x);
+    } else {
+        solve_start = uvunwrap::now_ns();
+        if (!entry->direct_float) entry->direct_float = create_eigen_direct_solver<float>(solver, ordering);
+        DirectSolver<float>& direct = *entry->direct_float;
+        Eigen::VectorXf x_float;
+        solved = direct.factorize(system.A_float, &nonzeros, &factor_ns) && direct.solve(b_float, x_float);
+        if (solved) x = x_float.cast<double>();
+        if (solved && precision == LSCM_PRECISION_FLOAT_REFINED) {
+            Eigen::VectorXf r = (b - A * x).cast<float>();
+            Eigen::VectorXf d;
+            solved = direct.solve(r, d);
+            if (solved) {
+                x += d.cast<double>();
+                residual = relative_residual(A, b, x);
+            }
+        }
+    }
+    if (!solved && uvunwrap::lscm_cancelled(options)) return NULL;
+    if (solved && !x.allFinite()) {
+        LOG_ERROR("LSCM: Non-finite solution");
+        solved = false;
+    }
+
+    // Fallback ladder, rungs as in LscmFallback: regularised direct solve,
+    // the same with another backend, planar projection
+    int fallback = LSCM_FALLBACK_NONE;
+    if (!solved) {
+        // Float mode never filled the double system
+        if (precision == LSCM_PRECISION_FLOAT) {
+            fill_lscm_system(mesh, face_indices, local_tris.data(), num_faces, system, system.A, b, face_frames);
+        }
+        LscmSolver first = (solver == LSCM_SOLVER_LLT || solver == LSCM_SOLVER_LU) ? solver : LSCM_SOLVER_LDLT;
+        LscmSolver second = first == LSCM_SOLVER_LU ? LSCM_SOLVER_LDLT : LSCM_SOLVER_LU;
+        long long rung_factor_ns = 0;
+        iterations = 0;
+        nonzeros = 0;
+        if (regularized_solve(A, b, first, x, &nonzeros, &rung_factor_ns)) {
+            fallback = LSCM_FALLBACK_REGULARIZED;
+        } else {
+            factor_ns += rung_factor_ns;
+            fallback = regularized_solve(A, b, second, x, &nonzeros, &rung_factor_ns) ? LSCM_FALLBACK_ALT_SOLVER
+                                                                                    : LSCM_FALLBACK_PLANAR;
+        }
+        factor_ns += rung_factor_ns;
+        residual = fallback == LSCM_FALLBACK_PLANAR ? 0.0 : relative_residual(A, b, x);
+        LOG_WARNING("LSCM: Island of %d vertices recovered by fallback (%s)", n, fallback_name(fallback));
+    }
+    long long solve_ns = uvunwrap::now_ns() - solve_start - factor_ns;
+    UV_TRACE_ZONE_END(solve_zone);
+
+    if (report_out) {
+        // Iterative solves keep about 8 vectors (CG) or a hierarchy about
+        // the size of A (multigrid, CUDA CG: device memory is not counted);
+        // direct ones b and x
+        using namespace uvunwrap;
+        long long vector = (long long)system.num_free * (long long)sizeof(double);
+        long long solve_bytes = solver == LSCM_SOLVER_CG ? 8 * vector
+                              : solver == LSCM_SOLVER_MULTIGRID || solver == LSCM_SOLVER_CUDA_CG
+                                  ? sparse_bytes(A) + 4 * vector
+                                                                : 2 * vector;
+        report_out->peak_bytes = sparse_bytes(A) + sparse_bytes(system.A_float) +
+                                 factor_bytes(nonzeros, use_float ? sizeof(float) : sizeof(double)) + solve_bytes +
+                                 vector_bytes(local_tris) + vector_bytes(local_to_global) + vector_bytes(own_remap) +
+                                 vector_bytes(loop_offsets) + vector_bytes(loop_vertices) + vector_bytes(abf_frames) +
+                                 vector_bytes(system.pattern.nbrs) + vector_bytes(system.pattern.corner_slots) +
+                                 vector_bytes(system.entry_pos) + vector_bytes(system.dof_remap) +
+                                 vector_bytes(system.pin_values);
+        report_out->solver = solver;
+        report_out->ordering = ordering;
+        report_out->factor_nonzeros = nonzeros;
+        report_out->iterations = iterations;
+        report_out->residual = residual;
+        report_out->plan_hit = plan_hit ? 1 : 0;
+        report_out->matrix_nonzeros = (long long)A.nonZeros();
+        report_out->assembly_ns = assembly_ns;
+        report_out->factor_ns = factor_ns;
+        report_out->solve_ns = solve_ns;
+        report_out->precision = precision;
+        report_out->fallback = fallback;
+        report_out->method = method;
+        report_out->angle_iterations = abf_stats.iterations;
+        report_out->angle_ns = angle_ns;
+        report_out->arap_iterations = 0;
+        report_out->arap_ns = 0;
+        report_out->dense = 0;
+        report_out->closed_form = LSCM_CLOSED_FORM_NONE;
+    }
+
+    // STEP 5: Extract UVs
+    const std::vector<int>& dof_remap = system.dof_remap;
+    float* uvs = uvs_out ? uvs_out : (float*)malloc(n * 2 * sizeof(float));
+    if (fallback == LSCM_FALLBACK_PLANAR) {
+        planar_projection(mesh, face_indices, num_faces, local_to_global, uvs);
+    } else {
+        for (int i = 0; i < 2 * n; i++) {
+            uvs[i] = dof_remap[i] >= 0 ? (float)x[dof_remap[i]] : (float)system.pin_values[i];
+        }
+        if (!arap_post_pass(mesh, face_indices, local_tris, num_faces, n, options, solver, entry->arap, uvs,
+                            report_out)) {
+            if (!uvs_out) free(uvs);
+            return NULL;
+        }
+    }
+
+    {
+        UV_TRACE_ZONE("lscm normalise");
+        normalize_uvs_to_unit_square(uvs, n);
+    }
+    restore_input_order(uvs);
+
+    LOG_DEBUG("  LSCM completed");
+    if (num_verts_out) *num_verts_out = n;
+    if (vertices_out) memcpy(vertices_out, local_to_global.data(), n * sizeof(int));
+    return uvs;
+}
+
+/**
+ * @brief Strictly lower nonzeros of the Cholesky factor of a vertex graph
+ *
+ * Orders the graph with AMD (or keeps its order), then counts the
+ * entries of each row of L by walking the elimination tree up from its
+ * neighbours (as SimplicialCholesky's analyzePattern does). No numeric
+ * work, so it costs the ordering plus O(nnz(L)).
+ */
+static long long symbolic_factor_nonzeros(const std::vector<int>& nbr_offsets, const std::vector<int>& nbrs, int n,
+                                          bool natural) {
+    Eigen::SparseMatrix<double> G(n, n);
+    G.resizeNonZeros((Eigen::Index)nbrs.size());
+    std::copy(nbr_offsets.begin(), nbr_offsets.end(), G.outerIndexPtr());
+    std::copy(nbrs.begin(), nbrs.end(), G.innerIndexPtr());
+    std::fill(G.valuePtr(), G.valuePtr() + nbrs.size(), 1.0);
+
+    // AMD gives new -> old; the walk needs old -> new as well
+    Eigen::PermutationMatrix<Eigen::Dynamic, Eigen::Dynamic, int> order(n);
+    if (natural) {
+        order.setIdentity();
+    } else {
+        Eigen::AMDOrdering<int> amd;
+        amd(G, order);
+    }
+    const int* new_to_old = order.indices().data();
+    std::vector<int> old_to_new(n);
+    for (int k = 0; k < n; k++) old_to_new[new_to_old[k]] = k;
+
+    std::vector<int> parent(n, -1);
+    std::vector<int> mark(n, -1);
+    long long count = 0;
+    for (int k = 0; k < n; k++) {
+        mark[k] = k;
+        int j = new_to_old[k];
+        for (int e = nbr_offsets[j]; e < nbr_offsets[j + 1]; e++) {
+            int i = old_to_new[nbrs[e]];
+            if (i >= k) continue;
+            for (; mark[i] != k; i = parent[i]) {
+                if (parent[i] < 0) parent[i] = k;
+                count++;
+                mark[i] = k;
+            }
+        }
+    }
+    return count;
+}
+
+long long lscm_estimate_peak_bytes(const Mesh* mesh,
+                                   const int* face_indices,
+                                   int num_faces,
+                                   const LscmOptions* options) {
+    using namespace uvunwrap;
+    if (!mesh || !face_indices || num_faces <= 0) return 0;
+
+    LscmOptions defaults;
+    lscm_options_default(&defaults);
+    if (!options) options = &defaults;
+
+    // Local ids in ascending mesh order; the ordering makes the numbering irrelevant
+    std::vector<int> local_to_global((size_t)num_faces * 3);
+    for (int i = 0; i < num_faces; i++) {
+        for (int j = 0; j < 3; j++) local_to_global[i * 3 + j] = mesh->triangles[face_indices[i] * 3 + j];
+    }
+    std::vector<int> local_tris(local_to_global);
+    std::sort(local_to_global.begin(), local_to_global.end());
+    local_to_global.erase(std::unique(local_to_global.begin(), local_to_global.end()), local_to_global.end());
+    int n = (int)local_to_global.size();
+    for (size_t i = 0; i < local_tris.size(); i++) {
+        local_tris[i] = (int)(std::lower_bound(local_to_global.begin(), local_to_global.end(), local_tris[i]) -
+                              local_to_global.begin());
+    }
+    if (n < 3) return 0;
+
+    std::vector<int> nbr_offsets, nbrs;
+    vertex_neighbours(local_tris.data(), num_faces, n, nbr_offsets, nbrs);
+
+    // The terms of lscm_solve()'s LscmReport::peak_bytes, with the DOF
+    // matrix (a 2x2 block per vertex pair, two DOFs pinned) and its factor
+    // expanded from the vertex graph
+    LscmSolver solver = resolve_solver(options, n);
+    int precision = resolve_precision(options, solver);
+    LscmOrdering ordering = resolve_ordering(options, solver);
+    long long blocks = (long long)nbrs.size();
+    long long dofs = 2 * (long long)n - 4;
+    long long matrix_nonzeros = 4 * blocks;
+    long long vector = dofs * (long long)sizeof(double);
+    long long outer = (dofs + 1) * (long long)sizeof(int);
+    long long bytes = matrix_nonzeros * (long long)(sizeof(double) + sizeof(int)) + outer;
+    if (precision != LSCM_PRECISION_DOUBLE) {
+        bytes += matrix_nonzeros * (long long)(sizeof(float) + sizeof(int)) + outer;
+    }
+    if (solver == LSCM_SOLVER_CG) {
+        bytes += 8 * vector;
+    } else if (solver == LSCM_SOLVER_MULTIGRID || solver == LSCM_SOLVER_CUDA_CG) {
+        bytes += bytes + 4 * vector;
+    } else {
+        // Each vertex pair of L is a full 2x2 block, each diagonal block
+        // one strictly lower entry (LDLT) or three (LLT, with the diagonal).
+        // SparseLU's U and pivoting take about 3.5 times that. COLAMD and
+        // METIS orderings are estimated by AMD's fill
+        long long lower = symbolic_factor_nonzeros(nbr_offsets, nbrs, n, ordering == LSCM_ORDERING_NATURAL);
+        long long nonzeros = 4 * lower + (solver == LSCM_SOLVER_LDLT ? 1 : 3) * (long long)n;
+        if (solver == LSCM_SOLVER_LU) nonzeros = nonzeros * 7 / 2;
+        bytes += factor_bytes(nonzeros, precision == LSCM_PRECISION_DOUBLE ? sizeof(double) : sizeof(float)) +
+                 2 * vector;
+        if (options->method == LSCM_METHOD_SPECTRAL) bytes += dofs * SCP_BLOCK * 3 * (long long)sizeof(double);
+    }
+    // Local triangles and ids, the pattern, its corner slots and entry
+    // positions, the DOF remap and pin values
+    bytes += vector_bytes(local_tris) + (long long)n * (long long)sizeof(int) + vector_bytes(nbrs) +
+             (long long)num_faces * 9 * (long long)sizeof(int) + 4 * blocks * (long long)sizeof(int) +
+             2 * (long long)n * (long long)(sizeof(int) + sizeof(double));
+    return bytes;
+}
+
+float* lscm_parameterize_with_options(const Mesh* mesh,
+                                      const int* face_indices,
+                                      int num_faces,
+                                      const LscmOptions* options,
+                                      LscmReport* report_out) {
+    return lscm_solve(mesh, face_indices, num_faces, options, report_out, NULL, NULL, NULL, NULL);
+}
+
+int lscm_parameterize_into(const Mesh* mesh,
+                           const int* face_indices,
+                           int num_faces,
+                           const LscmOptions* options,
+                           LscmReport* report_out,
+                           float* uvs_out,
+                           int* vertices_out,
+                           int* vertex_remap) {
+    return uvunwrap::lscm_parameterize_geometry(mesh, face_indices, num_faces, options, report_out, uvs_out,
+                                                vertices_out, vertex_remap, NULL, NULL);
+}
+
+int uvunwrap::lscm_parameterize_geometry(const Mesh* mesh,
+                                         const int* face_indices,
+                                         int num_faces,
+                                         const LscmOptions* options,
+                                         LscmReport* report_out,
+                                         float* uvs_out,
+                                         int* vertices_out,
+                                         int* vertex_remap,
+                                         const TriangleGeometry* geometry,
+                                         const int* geometry_faces) {
+    if (!uvs_out) return -1;
+    int num_verts = 0;
+    if (!lscm_solve(mesh, face_indices, num_faces, options, report_out, uvs_out, &num_verts,
+                    vertices_out, vertex_remap, geometry, geometry_faces)) {
+        return -1;
+    }
+    return num_verts;
 }
@@ -0,0 +1,23 @@
+/**
+ * @file lscm_cancel.h
+ * @brief Internal polling of LscmOptions::should_cancel
+ *
+ * Not part of the public API. Shared by the LSCM driver and the ABF++ and
+ * ARAP passes, which poll between their iterations.
+ */
+
+#ifndef UVUNWRAP_LSCM_CANCEL_H
+#define UVUNWRAP_LSCM_CANCEL_H
+
+#include "lscm.h"
+
+namespace uvunwrap {
+
+/** True once the caller asked the solve to stop (options may be NULL) */
+inline bool lscm_cancelled(const LscmOptions* options) {
+    return options && options->should_cancel && options->should_cancel(options->cancel_user_data);
+}
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_LSCM_CANCEL_H */
@@ -0,0 +1,242 @@
+/**
+ * @file lscm_closed_form.cpp
+ * @brief Closed-form layouts of planar and developable islands
+ *
+ * The LSCM energy of an island is zero exactly when one similarity maps
+ * every triangle to the plane unchanged in shape, i.e. the island is flat
+ * or a flat sheet folded without stretching. Hard-surface models are full
+ * of such islands (cube faces, panels, strips around a bevel), and for
+ * them a projection or an unfolding is the LSCM result in linear time.
+ * Both layouts are checked against the 3D edge lengths, so an island that
+ * only looks flat to the classifier still gets a solve.
+ */
+
+#include "lscm_closed_form.h"
+#include "lscm.h"
+#include "half_edge.h"
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
+namespace uvunwrap {
+
+namespace {
+
+// Largest distance from the plane, relative to the bounding box diagonal
+const double PLANAR_TOLERANCE = 1e-6;
+// Largest |2 pi - angle sum| at an interior vertex of a developable island
+const double DEFECT_TOLERANCE = 1e-4;
+// Largest change of an edge length in a laid out triangle, relative to
+// the triangle's longest edge
+const double EDGE_TOLERANCE = 1e-5;
+
+struct D3 {
+    double x, y, z;
+};
+
+D3 sub3(D3 a, D3 b) { return D3{a.x - b.x, a.y - b.y, a.z - b.z}; }
+double dot3(D3 a, D3 b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+D3 cross3(D3 a, D3 b) { return D3{a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x}; }
+double norm3(D3 a) { return sqrt(dot3(a, a)); }
+
+/** Every triangle keeps its 3D edge lengths and its orientation */
+bool isometric(const std::vector<D3>& P, const int* tris, int num_faces, const std::vector<double>& uv) {
+    for (int f = 0; f < num_faces; f++) {
+        const int* t = &tris[f * 3];
+        double longest = 0.0;
+        double l3[3], l2[3];
+        for (int k = 0; k < 3; k++) {
+            int a = t[k], b = t[(k + 1) % 3];
+            l3[k] = norm3(sub3(P[b], P[a]));
+            l2[k] = hypot(uv[2 * b] - uv[2 * a], uv[2 * b + 1] - uv[2 * a + 1]);
+            longest = std::max(longest, l3[k]);
+        }
+        for (int k = 0; k < 3; k++) {
+            if (!(fabs(l2[k] - l3[k]) <= EDGE_TOLERANCE * longest)) return false;
+        }
+        // Degenerate triangles add nothing to the LSCM energy either way
+        double area3 = norm3(cross3(sub3(P[t[1]], P[t[0]]), sub3(P[t[2]], P[t[0]])));
+        if (area3 <= EDGE_TOLERANCE * longest * longest) continue;
+        double area2 = (uv[2 * t[1]] - uv[2 * t[0]]) * (uv[2 * t[2] + 1] - uv[2 * t[0] + 1]) -
+                       (uv[2 * t[1] + 1] - uv[2 * t[0] + 1]) * (uv[2 * t[2]] - uv[2 * t[0]]);
+        if (!(area2 > 0.0)) return false;
+    }
+    return true;
+}
+
+/** Orthographic projection onto the island's plane, if it has one */
+bool project_planar(const std::vector<D3>& P, const int* tris, int num_faces, std::vector<double>& uv) {
+    int n = (int)P.size();
+    D3 normal = {0.0, 0.0, 0.0};
+    for (int f = 0; f < num_faces; f++) {
+        const int* t = &tris[f * 3];
+        D3 c = cross3(sub3(P[t[1]], P[t[0]]), sub3(P[t[2]], P[t[0]]));
+        normal.x += c.x;
+        normal.y += c.y;
+        normal.z += c.z;
+    }
+    D3 lo = P[0], hi = P[0], centre = {0.0, 0.0, 0.0};
+    for (int i = 0; i < n; i++) {
+        lo = D3{std::min(lo.x, P[i].x), std::min(lo.y, P[i].y), std::min(lo.z, P[i].z)};
+        hi = D3{std::max(hi.x, P[i].x), std::max(hi.y, P[i].y), std::max(hi.z, P[i].z)};
+        centre.x += P[i].x / n;
+        centre.y += P[i].y / n;
+        centre.z += P[i].z / n;
+    }
+    double diagonal = norm3(sub3(hi, lo));
+    double length = norm3(normal);
+    if (!(length > 0.0) || !(diagonal > 0.0)) return false;
+    normal = D3{normal.x / length, normal.y / length, normal.z / length};
+    for (int i = 0; i < n; i++) {
+        if (fabs(dot3(sub3(P[i], centre), normal)) > PLANAR_TOLERANCE * diagonal) return false;
+    }
+
+    // Right-handed (X, Y, normal), so counter-clockwise triangles stay so
+    D3 axis = {0.0, 0.0, 0.0};
+    double ax = fabs(normal.x), ay = fabs(normal.y), az = fabs(normal.z);
+    if (ax <= ay && ax <= az) axis.x = 1.0;
+    else if (ay <= az) axis.y = 1.0;
+    else axis.z = 1.0;
+    D3 X = cross3(axis, normal);
+    double x_length = norm3(X);
+    X = D3{X.x / x_length, X.y / x_length, X.z / x_length};
+    D3 Y = cross3(normal, X);
+
+    uv.resize(2 * n);
+    for (int i = 0; i < n; i++) {
+        D3 d = sub3(P[i], centre);
+        uv[2 * i + 0] = dot3(d, X);
+        uv[2 * i + 1] = dot3(d, Y);
+    }
+    return true;
+}
+
+/** Unfold a developable disk across its edges, breadth first */
+bool unfold_developable(const std::vector<D3>& P, const int* tris, int num_faces, std::vector<double>& uv) {
+    int n = (int)P.size();
+    Mesh part;
+    memset(&part, 0, sizeof(part));
+    part.triangles = (int*)tris;
+    part.num_triangles = num_faces;
+    part.num_vertices = n;
+    HalfEdgeMesh he;
+    if (!build_half_edge_mesh(&part, &he, 1) || he.num_nonmanifold_edges > 0) return false;
+
+    // A disk: V - E + F = 1 with a boundary
+    std::vector<unsigned char> on_boundary(n, 0);
+    int num_boundary = 0;
+    for (int h = 0; h < 3 * num_faces; h++) {
+        if (he.twin[h] >= 0) continue;
+        on_boundary[he.origin(h)] = 1;
+        on_boundary[he.target(h)] = 1;
+        num_boundary++;
+    }
+    if (num_boundary == 0 || n - he.num_edges + num_faces != 1) return false;
+
+    // Angular defect at interior vertices
+    std::vector<double> angle_sum(n, 0.0);
+    int seed = 0;
+    double seed_area = -1.0;
+    for (int f = 0; f < num_faces; f++) {
+        const int* t = &tris[f * 3];
+        for (int k = 0; k < 3; k++) {
+            D3 e1 = sub3(P[t[(k + 1) % 3]], P[t[k]]);
+            D3 e2 = sub3(P[t[(k + 2) % 3]], P[t[k]]);
+            angle_sum[t[k]] += atan2(norm3(cross3(e1, e2)), dot3(e1, e2));
+        }
+        double area = norm3(cross3(sub3(P[t[1]], P[t[0]]), sub3(P[t[2]], P[t[0]])));
+        if (area > seed_area) {
+            seed_area = area;
+            seed = f;
+        }
+    }
+    for (int i = 0; i < n; i++) {
+        if (!on_boundary[i] && fabs(angle_sum[i] - 2.0 * M_PI) > DEFECT_TOLERANCE) return false;
+    }
+    if (!(seed_area > 0.0)) return false;
+
+    // Seed triangle in its own frame, then each neighbour's third corner
+    // from the shared edge, to its left as the triangle is counter-clockwise
+    uv.assign(2 * n, 0.0);
+    std::vector<unsigned char> placed(n, 0);
+    std::vector<unsigned char> reached(num_faces, 0);
+    {
+        const int* t = &tris[seed * 3];
+        D3 e1 = sub3(P[t[1]], P[t[0]]);
+        D3 e2 = sub3(P[t[2]], P[t[0]]);
+        double l1 = norm3(e1);
+        uv[2 * t[1]] = l1;
+        uv[2 * t[2]] = dot3(e2, e1) / l1;
+        uv[2 * t[2] + 1] = norm3(cross3(e1, e2)) / l1;
+        placed[t[0]] = placed[t[1]] = placed[t[2]] = 1;
+    }
+    std::vector<int> queue(1, seed);
+    reached[seed] = 1;
+    for (size_t q = 0; q < queue.size(); q++) {
+        int f = queue[q];
+        for (int k = 0; k < 3; k++) {
+            int t = he.twin[3 * f + k];
+            if (t < 0 || reached[HalfEdgeMesh::face(t)]) continue;
+            reached[HalfEdgeMesh::face(t)] = 1;
+            queue.push_back(HalfEdgeMesh::face(t));
+            int a = he.origin(t), b = he.target(t), c = he.origin(HalfEdgeMesh::prev(t));
+            if (placed[c]) continue;
+            D3 e = sub3(P[b], P[a]);
+            D3 pc = sub3(P[c], P[a]);
+            double l3 = norm3(e);
+            double dx = uv[2 * b] - uv[2 * a], dy = uv[2 * b + 1] - uv[2 * a + 1];
+            double l2 = hypot(dx, dy);
+            if (!(l3 > 0.0) || !(l2 > 0.0)) return false;
+            double x = dot3(pc, e) / l3;
+            double y = norm3(cross3(e, pc)) / l3;
+            dx /= l2;
+            dy /= l2;
+            uv[2 * c + 0] = uv[2 * a + 0] + x * dx - y * dy;
+            uv[2 * c + 1] = uv[2 * a + 1] + x * dy + y * dx;
+            placed[c] = 1;
+        }
+    }
+    return (int)queue.size() == num_faces;
+}
+
+} // namespace
+
+int closed_form_layout(const Mesh* mesh,
+                       const int* local_tris,
+                       int num_faces,
+                       const std::vector<int>& local_to_global,
+                       int pin1,
+                       int pin2,
+                       float* uvs) {
+    int n = (int)local_to_global.size();
+    if (n < 3 || num_faces <= 0 || pin1 < 0 || pin2 < 0 || pin1 == pin2) return LSCM_CLOSED_FORM_NONE;
+    std::vector<D3> P(n);
+    for (int i = 0; i < n; i++) {
+        const float* p = &mesh->vertices[local_to_global[i] * 3];
+        P[i] = D3{p[0], p[1], p[2]};
+    }
+
+    std::vector<double> uv;
+    int kind = LSCM_CLOSED_FORM_NONE;
+    if (project_planar(P, local_tris, num_faces, uv) && isometric(P, local_tris, num_faces, uv)) {
+        kind = LSCM_CLOSED_FORM_PLANAR;
+    } else if (unfold_developable(P, local_tris, num_faces, uv) && isometric(P, local_tris, num_faces, uv)) {
+        kind = LSCM_CLOSED_FORM_UNFOLDED;
+    } else {
+        return LSCM_CLOSED_FORM_NONE;
+    }
+
+    // w = (z - z1) / (z2 - z1) puts the pins where LSCM pins them
+    double dx = uv[2 * pin2] - uv[2 * pin1], dy = uv[2 * pin2 + 1] - uv[2 * pin1 + 1];
+    double d2 = dx * dx + dy * dy;
+    if (!(d2 > 0.0)) return LSCM_CLOSED_FORM_NONE;
+    double x1 = uv[2 * pin1], y1 = uv[2 * pin1 + 1];
+    for (int i = 0; i < n; i++) {
+        double x = uv[2 * i] - x1, y = uv[2 * i + 1] - y1;
+        uvs[2 * i + 0] = (float)((x * dx + y * dy) / d2);
+        uvs[2 * i + 1] = (float)((y * dx - x * dy) / d2);
+    }
+    return kind;
+}
+
+} // namespace uvunwrap
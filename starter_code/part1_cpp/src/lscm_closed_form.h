@@ -0,0 +1,42 @@
+/**
+ * @file lscm_closed_form.h
+ * @brief Internal closed-form layouts of planar and developable islands
+ *
+ * Not part of the public API; the kinds are LscmClosedForm in lscm.h.
+ * All indices are island-local.
+ */
+
+#ifndef UVUNWRAP_LSCM_CLOSED_FORM_H
+#define UVUNWRAP_LSCM_CLOSED_FORM_H
+
+#include "mesh.h"
+#include <vector>
+
+namespace uvunwrap {
+
+/**
+ * @brief Lay out an island whose LSCM energy can reach zero, without a solve
+ *
+ * A planar island is projected onto its plane; a developable disk (no
+ * angle defect at any interior vertex) is unfolded triangle by triangle
+ * across its edges. Either layout is checked to be isometric, face by
+ * face, before it is used. The result is the similarity that puts pin1 at
+ * (0, 0) and pin2 at (1, 0), which is what pinned LSCM returns for such
+ * an island.
+ *
+ * @param local_tris Island triangles in local vertex indices (3 * num_faces)
+ * @param local_to_global Mesh vertex of each local vertex
+ * @param uvs Output: 2 UVs per local vertex (left undefined on failure)
+ * @return LscmClosedForm used, LSCM_CLOSED_FORM_NONE if the island needs a solve
+ */
+int closed_form_layout(const Mesh* mesh,
+                       const int* local_tris,
+                       int num_faces,
+                       const std::vector<int>& local_to_global,
+                       int pin1,
+                       int pin2,
+                       float* uvs);
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_LSCM_CLOSED_FORM_H */
@@ -0,0 +1,389 @@
+/**
+ * @file lscm_hierarchy.cpp
+ * @brief Edge-collapse decimation for the multigrid LSCM solver
+ *
+ * A pass visits vertices shortest incident edge first and collapses each
+ * into a neighbour (half-edge collapse: the neighbour keeps its position).
+ * A collapse marks the removed vertex and its one-ring as touched, and
+ * later collapses in the pass need an untouched source and target, so
+ * every check runs on connectivity the pass has not changed yet and all
+ * collapses of a pass can be applied in one sweep over the triangles.
+ * Passes repeat until the level holds a quarter of the vertices.
+ */
+
+#include "lscm_hierarchy.h"
+#include "vec_math.h"
+#include <math.h>
+#include <algorithm>
+#include <utility>
+
+namespace uvunwrap {
+
+namespace {
+
+// Each level keeps at most 1 / LEVEL_RATIO of the vertices of the one before
+const int LEVEL_RATIO = 4;
+// A pass that removes less than this fraction ends the decimation
+const double MIN_PASS_FRACTION = 0.01;
+// Coarsest levels below this are not worth another level
+const int MIN_COARSE_VERTICES = 64;
+// Faces around a collapse may not turn their normal by more than ~72 degrees
+const float MIN_NORMAL_COS = 0.3f;
+
+/** Vertex one-rings of a triangle list, with the number of faces on each edge */
+struct Rings {
+    std::vector<int> face_offsets;
+    std::vector<int> faces;
+    std::vector<int> nbr_offsets;
+    std::vector<int> nbrs;
+    std::vector<int> edge_faces;
+};
+
+void build_rings(const std::vector<int>& tris, int n, Rings& rings) {
+    int F = (int)tris.size() / 3;
+    rings.face_offsets.assign(n + 1, 0);
+    for (int c = 0; c < 3 * F; c++) rings.face_offsets[tris[c] + 1]++;
+    for (int v = 0; v < n; v++) rings.face_offsets[v + 1] += rings.face_offsets[v];
+    rings.faces.resize(3 * F);
+    std::vector<int> cursor(rings.face_offsets.begin(), rings.face_offsets.end() - 1);
+    for (int c = 0; c < 3 * F; c++) rings.faces[cursor[tris[c]]++] = c / 3;
+
+    // Each face adds its other two corners; repeats count the edge's faces
+    std::vector<int> slot(n, -1);
+    rings.nbr_offsets.assign(n + 1, 0);
+    rings.nbrs.clear();
+    rings.edge_faces.clear();
+    for (int v = 0; v < n; v++) {
+        int begin = (int)rings.nbrs.size();
+        for (int i = rings.face_offsets[v]; i < rings.face_offsets[v + 1]; i++) {
+            const int* tri = &tris[rings.faces[i] * 3];
+            for (int k = 0; k < 3; k++) {
+                int w = tri[k];
+                if (w == v) continue;
+                if (slot[w] >= begin) {
+                    rings.edge_faces[slot[w]]++;
+                } else {
+                    slot[w] = (int)rings.nbrs.size();
+                    rings.nbrs.push_back(w);
+                    rings.edge_faces.push_back(1);
+                }
+            }
+        }
+        rings.nbr_offsets[v + 1] = (int)rings.nbrs.size();
+    }
+}
+
+inline int face_count(const Rings& rings, int v) {
+    return rings.face_offsets[v + 1] - rings.face_offsets[v];
+}
+
+/** Collapsing v into u leaves u and the apexes of uv's faces with a face each */
+bool collapse_keeps_faces(const std::vector<int>& tris, const Rings& rings, int v, int u, int edge_faces) {
+    if (face_count(rings, u) <= edge_faces) return false;
+    for (int i = rings.face_offsets[v]; i < rings.face_offsets[v + 1]; i++) {
+        const int* tri = &tris[rings.faces[i] * 3];
+        if (tri[0] != u && tri[1] != u && tri[2] != u) continue;
+        for (int k = 0; k < 3; k++) {
+            if (tri[k] != u && tri[k] != v && face_count(rings, tri[k]) <= 1) return false;
+        }
+    }
+    return true;
+}
+
+/** Normals of v's faces without u keep their orientation if v moves to u */
+bool collapse_keeps_normals(const std::vector<Vec3>& pos, const std::vector<int>& tris,
+                            const Rings& rings, int v, int u) {
+    for (int i = rings.face_offsets[v]; i < rings.face_offsets[v + 1]; i++) {
+        const int* tri = &tris[rings.faces[i] * 3];
+        if (tri[0] == u || tri[1] == u || tri[2] == u) continue;
+        Vec3 p[3], q[3];
+        for (int k = 0; k < 3; k++) {
+            p[k] = pos[tri[k]];
+            q[k] = tri[k] == v ? pos[u] : p[k];
+        }
+        Vec3 before = cross(sub(p[1], p[0]), sub(p[2], p[0]));
+        Vec3 after = cross(sub(q[1], q[0]), sub(q[2], q[0]));
+        float len_after = length(after);
+        if (len_after <= 0.0f) return false;
+        if (dot(before, after) <= MIN_NORMAL_COS * length(before) * len_after) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Weights placing v on the mesh left by collapsing it into u
+ *
+ * Interior: barycentric coordinates of v in whichever of the faces
+ * (u, a, b) its faces (v, a, b) turn into holds it best. Boundary: v's
+ * position along the boundary segment from u to its other boundary
+ * neighbour. Both reproduce linear functions over a flat one-ring, which
+ * the coarse-grid correction relies on.
+ */
+void collapse_weights(const std::vector<Vec3>& pos, const std::vector<int>& tris, const Rings& rings,
+                      int v, int u, int boundary_nbr, LscmCoarsening& pass) {
+    Vec3 pv = pos[v];
+    if (boundary_nbr >= 0) {
+        Vec3 d = sub(pos[boundary_nbr], pos[u]);
+        float len2 = dot(d, d);
+        float t = len2 > 0.0f ? clamp(dot(sub(pv, pos[u]), d) / len2, 0.0f, 1.0f) : 0.5f;
+        pass.nbrs.push_back(u);
+        pass.weights.push_back(1.0f - t);
+        pass.nbrs.push_back(boundary_nbr);
+        pass.weights.push_back(t);
+        return;
+    }
+
+    float best_min = -INFINITY;
+    int best[3] = {u, u, u};
+    float best_bary[3] = {1.0f, 0.0f, 0.0f};
+    for (int i = rings.face_offsets[v]; i < rings.face_offsets[v + 1]; i++) {
+        const int* tri = &tris[rings.faces[i] * 3];
+        if (tri[0] == u || tri[1] == u || tri[2] == u) continue;
+        int k = tri[0] == v ? 0 : (tri[1] == v ? 1 : 2);
+        int a = tri[(k + 1) % 3], b = tri[(k + 2) % 3];
+        Vec3 e1 = sub(pos[a], pos[u]);
+        Vec3 e2 = sub(pos[b], pos[u]);
+        Vec3 normal = cross(e1, e2);
+        float area2 = dot(normal, normal);
+        if (area2 <= 0.0f) continue;
+        Vec3 d = sub(pv, pos[u]);
+        float wa = dot(cross(d, e2), normal) / area2;
+        float wb = dot(cross(e1, d), normal) / area2;
+        float wu = 1.0f - wa - wb;
+        float lowest = std::min(wu, std::min(wa, wb));
+        if (lowest > best_min) {
+            best_min = lowest;
+            best[1] = a;
+            best[2] = b;
+            best_bary[0] = wu;
+            best_bary[1] = wa;
+            best_bary[2] = wb;
+        }
+    }
+    // Outside every face (a non-convex ring): clamp into the nearest one
+    float sum = 0.0f;
+    for (int k = 0; k < 3; k++) {
+        best_bary[k] = std::max(best_bary[k], 0.0f);
+        sum += best_bary[k];
+    }
+    for (int k = 0; k < 3; k++) {
+        if (best_bary[k] <= 0.0f) continue;
+        pass.nbrs.push_back(best[k]);
+        pass.weights.push_back(best_bary[k] / sum);
+    }
+}
+
+/**
+ * @brief One pass over tris (in place)
+ * @return Number of vertices removed
+ */
+int collapse_pass(const std::vector<Vec3>& pos, const std::vector<char>& locked, int n,
+                  std::vector<int>& tris, LscmCoarsening& pass) {
+    Rings rings;
+    build_rings(tris, n, rings);
+
+    // Candidates: manifold vertices, boundary ones with exactly two
+    // boundary edges (one open fan), ordered by shortest incident edge
+    std::vector<char> boundary(n, 0);
+    std::vector<std::pair<float, int> > order;
+    for (int v = 0; v < n; v++) {
+        int num_faces = face_count(rings, v);
+        if (num_faces == 0 || locked[v]) continue;
+        int num_nbrs = rings.nbr_offsets[v + 1] - rings.nbr_offsets[v];
+        int boundary_edges = 0;
+        bool manifold = true;
+        float shortest = INFINITY;
+        for (int e = rings.nbr_offsets[v]; e < rings.nbr_offsets[v + 1]; e++) {
+            if (rings.edge_faces[e] == 1) boundary_edges++;
+            if (rings.edge_faces[e] > 2) manifold = false;
+            shortest = std::min(shortest, length(sub(pos[rings.nbrs[e]], pos[v])));
+        }
+        boundary[v] = boundary_edges > 0;
+        if (boundary[v]) manifold = manifold && boundary_edges == 2 && num_nbrs == num_faces + 1;
+        else manifold = manifold && num_nbrs == num_faces;
+        if (manifold) order.push_back(std::make_pair(shortest, v));
+    }
+    std::sort(order.begin(), order.end());
+
+    std::vector<int> target(n, -1);
+    std::vector<char> touched(n, 0);
+    std::vector<int> mark(n, -1);
+    std::vector<std::pair<float, int> > targets;
+    pass.removed.clear();
+    pass.nbr_offsets.assign(1, 0);
+    pass.nbrs.clear();
+    pass.weights.clear();
+
+    for (size_t o = 0; o < order.size(); o++) {
+        int v = order[o].second;
+        if (touched[v]) continue;
+
+        targets.clear();
+        for (int e = rings.nbr_offsets[v]; e < rings.nbr_offsets[v + 1]; e++) {
+            int u = rings.nbrs[e];
+            if (touched[u]) continue;
+            if (boundary[v] && rings.edge_faces[e] != 1) continue;
+            targets.push_back(std::make_pair(length(sub(pos[u], pos[v])), e));
+        }
+        if (targets.empty()) continue;
+        std::sort(targets.begin(), targets.end());
+
+        for (int e = rings.nbr_offsets[v]; e < rings.nbr_offsets[v + 1]; e++) mark[rings.nbrs[e]] = v;
+        int chosen = -1;
+        for (size_t t = 0; t < targets.size() && chosen < 0; t++) {
+            int e = targets[t].second;
+            int u = rings.nbrs[e];
+            // Link condition: the only shared neighbours are the apexes of uv's faces
+            int shared = 0;
+            for (int g = rings.nbr_offsets[u]; g < rings.nbr_offsets[u + 1]; g++) {
+                if (mark[rings.nbrs[g]] == v) shared++;
+            }
+            if (shared != rings.edge_faces[e]) continue;
+            if (!collapse_keeps_faces(tris, rings, v, u, rings.edge_faces[e])) continue;
+            if (!collapse_keeps_normals(pos, tris, rings, v, u)) continue;
+            chosen = u;
+        }
+        if (chosen < 0) continue;
+
+        target[v] = chosen;
+        touched[v] = 1;
+        pass.removed.push_back(v);
+        int boundary_nbr = -1;
+        for (int e = rings.nbr_offsets[v]; e < rings.nbr_offsets[v + 1]; e++) {
+            int w = rings.nbrs[e];
+            touched[w] = 1;
+            if (boundary[v] && w != chosen && rings.edge_faces[e] == 1) boundary_nbr = w;
+        }
+        collapse_weights(pos, tris, rings, v, chosen, boundary_nbr, pass);
+        pass.nbr_offsets.push_back((int)pass.nbrs.size());
+    }
+
+    // Apply: move removed corners to their targets, drop the faces on the
+    // collapsed edges
+    size_t out = 0;
+    for (size_t t = 0; t < tris.size(); t += 3) {
+        int c[3];
+        for (int k = 0; k < 3; k++) c[k] = target[tris[t + k]] >= 0 ? target[tris[t + k]] : tris[t + k];
+        if (c[0] == c[1] || c[1] == c[2] || c[2] == c[0]) continue;
+        for (int k = 0; k < 3; k++) tris[out + k] = c[k];
+        out += 3;
+    }
+    tris.resize(out);
+    return (int)pass.removed.size();
+}
+
+} // namespace
+
+void build_lscm_hierarchy(const Mesh* mesh,
+                          const std::vector<int>& local_to_global,
+                          const std::vector<int>& local_tris,
+                          int locked1,
+                          int locked2,
+                          int coarse_vertices,
+                          std::vector<LscmLevel>& levels) {
+    levels.clear();
+    int n = (int)local_to_global.size();
+    coarse_vertices = std::max(coarse_vertices, MIN_COARSE_VERTICES);
+    if (n <= coarse_vertices) return;
+
+    std::vector<Vec3> pos(n);
+    for (int i = 0; i < n; i++) pos[i] = vertex_position(mesh, local_to_global[i]);
+    std::vector<char> locked(n, 0);
+    locked[locked1] = 1;
+    locked[locked2] = 1;
+
+    std::vector<int> tris(local_tris);
+    int alive = n;
+    bool stalled = false;
+    while (!stalled && alive > coarse_vertices) {
+        LscmLevel level;
+        int level_target = std::max(coarse_vertices, alive / LEVEL_RATIO);
+        while (alive > level_target) {
+            LscmCoarsening pass;
+            int removed = collapse_pass(pos, locked, n, tris, pass);
+            if (removed > 0) level.passes.push_back(std::move(pass));
+            alive -= removed;
+            if (removed < alive * MIN_PASS_FRACTION) {
+                stalled = true;
+                break;
+            }
+        }
+        if (level.passes.empty()) break;
+        level.tris = tris;
+        levels.push_back(std::move(level));
+    }
+}
+
+void level_prolongation(const LscmLevel& level,
+                        const std::vector<int>& finer_tris,
+                        int n,
+                        int max_terms,
+                        std::vector<int>& row_offsets,
+                        std::vector<int>& cols,
+                        std::vector<double>& weights) {
+    typedef std::pair<int, double> Term;
+    std::vector<std::vector<Term> > rows(n);
+    std::vector<char> removed(n, 0);
+    for (const LscmCoarsening& pass : level.passes) {
+        for (int v : pass.removed) removed[v] = 1;
+    }
+
+    // Later passes first, so every neighbour's row is already in terms of
+    // the level's vertices
+    std::vector<Term> merged;
+    for (size_t p = level.passes.size(); p-- > 0;) {
+        const LscmCoarsening& pass = level.passes[p];
+        for (size_t i = 0; i < pass.removed.size(); i++) {
+            int v = pass.removed[i];
+            merged.clear();
+            for (int e = pass.nbr_offsets[i]; e < pass.nbr_offsets[i + 1]; e++) {
+                int w = pass.nbrs[e];
+                double weight = pass.weights[e];
+                if (removed[w]) {
+                    for (const Term& t : rows[w]) merged.push_back(Term(t.first, weight * t.second));
+                } else {
+                    merged.push_back(Term(w, weight));
+                }
+            }
+
+            std::sort(merged.begin(), merged.end());
+            size_t out = 0;
+            for (size_t k = 0; k < merged.size(); k++) {
+                if (out > 0 && merged[out - 1].first == merged[k].first) merged[out - 1].second += merged[k].second;
+                else merged[out++] = merged[k];
+            }
+            merged.resize(out);
+            if ((int)merged.size() > max_terms) {
+                std::nth_element(merged.begin(), merged.begin() + max_terms, merged.end(),
+                                 [](const Term& a, const Term& b) { return a.second > b.second; });
+                merged.resize(max_terms);
+            }
+            double sum = 0.0;
+            for (const Term& t : merged) sum += t.second;
+            for (Term& t : merged) t.second /= sum;
+            rows[v] = merged;
+        }
+    }
+
+    std::vector<char> in_finer(n, 0);
+    for (int v : finer_tris) in_finer[v] = 1;
+    row_offsets.assign(n + 1, 0);
+    cols.clear();
+    weights.clear();
+    for (int v = 0; v < n; v++) {
+        if (in_finer[v]) {
+            if (removed[v]) {
+                for (const Term& t : rows[v]) {
+                    cols.push_back(t.first);
+                    weights.push_back(t.second);
+                }
+            } else {
+                cols.push_back(v);
+                weights.push_back(1.0);
+            }
+        }
+        row_offsets[v + 1] = (int)cols.size();
+    }
+}
+
+} // namespace uvunwrap
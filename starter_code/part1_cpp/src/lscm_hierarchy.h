@@ -0,0 +1,79 @@
+/**
+ * @file lscm_hierarchy.h
+ * @brief Internal mesh hierarchy for the multigrid LSCM solver
+ *
+ * Not part of the public API; see LSCM_SOLVER_MULTIGRID in lscm.h. All
+ * indices are island-local. Coarse levels come from half-edge collapses,
+ * so every coarse vertex is an island vertex at its original position and
+ * a level is just a triangle list over island vertices.
+ */
+
+#ifndef UVUNWRAP_LSCM_HIERARCHY_H
+#define UVUNWRAP_LSCM_HIERARCHY_H
+
+#include "mesh.h"
+#include <vector>
+
+namespace uvunwrap {
+
+/**
+ * @brief One collapse pass: an independent set of vertices removed at once
+ *
+ * Removed vertex removed[i] is interpolated from the vertices
+ * nbrs[nbr_offsets[i] .. nbr_offsets[i+1]) with the matching weights
+ * (summing to one); none of them is removed by the same pass.
+ */
+struct LscmCoarsening {
+    std::vector<int> removed;
+    std::vector<int> nbr_offsets;
+    std::vector<int> nbrs;
+    std::vector<float> weights;
+};
+
+struct LscmLevel {
+    std::vector<int> tris;                 /**< Triangles after all passes (island-local vertices) */
+    std::vector<LscmCoarsening> passes;    /**< Passes from the next finer level to this one, in order */
+};
+
+/**
+ * @brief Decimate an island into successively coarser levels
+ *
+ * Each level has about a quarter of the vertices of the one before, until
+ * at most coarse_vertices remain or no collapse passes the link-condition
+ * and normal-flip checks. Boundary vertices only collapse along the
+ * boundary and the locked (pinned) vertices are never removed, so every
+ * level has the island's pins and the outline of its boundary.
+ *
+ * @param levels Output, finest first; empty if the island is small enough
+ */
+void build_lscm_hierarchy(const Mesh* mesh,
+                          const std::vector<int>& local_to_global,
+                          const std::vector<int>& local_tris,
+                          int locked1,
+                          int locked2,
+                          int coarse_vertices,
+                          std::vector<LscmLevel>& levels);
+
+/**
+ * @brief Interpolation from a level's vertices to the next finer level's
+ *
+ * A kept vertex maps to itself. A removed vertex gets its pass weights,
+ * composed through the later passes of the level, truncated to the
+ * max_terms largest and renormalised to sum to one.
+ *
+ * @param n Island vertex count
+ * @param row_offsets CSR over island vertices (n + 1 entries); vertices
+ *        not in the finer level have empty rows
+ * @param cols Island vertices of the level
+ */
+void level_prolongation(const LscmLevel& level,
+                        const std::vector<int>& finer_tris,
+                        int n,
+                        int max_terms,
+                        std::vector<int>& row_offsets,
+                        std::vector<int>& cols,
+                        std::vector<double>& weights);
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_LSCM_HIERARCHY_H */
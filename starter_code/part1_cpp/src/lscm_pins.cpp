@@ -0,0 +1,203 @@
+/**
+ * @file lscm_pins.cpp
+ * @brief LSCM pin selection
+ *
+ * LSCM with two pins is determined up to a similarity by any pair, but
+ * the conditioning of the reduced system and the float precision of the
+ * result are best when the pins are far apart, ideally the diameter of
+ * the boundary. The double sweep (farthest point from the centroid, then
+ * repeatedly the farthest point from the last pick) and the principal-axis
+ * extremes are both linear and land within a few percent of the exact
+ * diameter on typical islands.
+ */
+
+#include "lscm_pins.h"
+#include "lscm.h"
+#include "vec_math.h"
+#include <math.h>
+#include <algorithm>
+
+namespace uvunwrap {
+
+namespace {
+
+const int MAX_SWEEPS = 4;
+const int POWER_ITERATIONS = 32;
+
+/** Index into points of the candidate farthest from q (first on ties) */
+int farthest_from(const std::vector<Vec3>& points, Vec3 q, float* dist_sq_out) {
+    int best = 0;
+    float best_dist = -1.0f;
+    for (size_t i = 0; i < points.size(); i++) {
+        Vec3 d = sub(points[i], q);
+        float dist = dot(d, d);
+        if (dist > best_dist) {
+            best_dist = dist;
+            best = (int)i;
+        }
+    }
+    *dist_sq_out = best_dist;
+    return best;
+}
+
+Vec3 centroid(const std::vector<Vec3>& points) {
+    double sum[3] = {0.0, 0.0, 0.0};
+    for (const Vec3& p : points) {
+        sum[0] += p.x;
+        sum[1] += p.y;
+        sum[2] += p.z;
+    }
+    double inv = 1.0 / (double)points.size();
+    return Vec3{(float)(sum[0] * inv), (float)(sum[1] * inv), (float)(sum[2] * inv)};
+}
+
+void double_sweep(const std::vector<Vec3>& points, int* a_out, int* b_out) {
+    float dist;
+    int a = farthest_from(points, centroid(points), &dist);
+    int b = farthest_from(points, points[a], &dist);
+    for (int sweep = 0; sweep < MAX_SWEEPS; sweep++) {
+        float next_dist;
+        int c = farthest_from(points, points[b], &next_dist);
+        if (next_dist <= dist) break;
+        a = b;
+        b = c;
+        dist = next_dist;
+    }
+    *a_out = a;
+    *b_out = b;
+}
+
+/** @return false if the points are (numerically) coincident */
+bool principal_axis(const std::vector<Vec3>& points, int* a_out, int* b_out) {
+    Vec3 c = centroid(points);
+    double cov[3][3] = {{0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}};
+    for (const Vec3& p : points) {
+        double d[3] = {(double)p.x - c.x, (double)p.y - c.y, (double)p.z - c.z};
+        for (int r = 0; r < 3; r++) {
+            for (int k = 0; k < 3; k++) cov[r][k] += d[r] * d[k];
+        }
+    }
+
+    // Power iteration from the covariance column with the largest norm
+    int start = 0;
+    double start_norm = -1.0;
+    for (int k = 0; k < 3; k++) {
+        double norm = cov[0][k] * cov[0][k] + cov[1][k] * cov[1][k] + cov[2][k] * cov[2][k];
+        if (norm > start_norm) {
+            start_norm = norm;
+            start = k;
+        }
+    }
+    if (start_norm <= 1e-30) return false;
+
+    double axis[3] = {cov[0][start], cov[1][start], cov[2][start]};
+    for (int it = 0; it < POWER_ITERATIONS; it++) {
+        double next[3];
+        for (int r = 0; r < 3; r++) {
+            next[r] = cov[r][0] * axis[0] + cov[r][1] * axis[1] + cov[r][2] * axis[2];
+        }
+        double norm = sqrt(next[0] * next[0] + next[1] * next[1] + next[2] * next[2]);
+        if (norm <= 1e-30) return false;
+        for (int r = 0; r < 3; r++) axis[r] = next[r] / norm;
+    }
+
+    int lo = 0, hi = 0;
+    double lo_t = INFINITY, hi_t = -INFINITY;
+    for (size_t i = 0; i < points.size(); i++) {
+        double t = points[i].x * axis[0] + points[i].y * axis[1] + points[i].z * axis[2];
+        if (t < lo_t) {
+            lo_t = t;
+            lo = (int)i;
+        }
+        if (t > hi_t) {
+            hi_t = t;
+            hi = (int)i;
+        }
+    }
+    *a_out = lo;
+    *b_out = hi;
+    return true;
+}
+
+void farthest_pair(const std::vector<Vec3>& points, int* a_out, int* b_out) {
+    float best = -1.0f;
+    int a = 0, b = 0;
+    for (size_t i = 0; i < points.size(); i++) {
+        for (size_t k = i + 1; k < points.size(); k++) {
+            Vec3 d = sub(points[i], points[k]);
+            float dist = dot(d, d);
+            if (dist > best) {
+                best = dist;
+                a = (int)i;
+                b = (int)k;
+            }
+        }
+    }
+    *a_out = a;
+    *b_out = b;
+}
+
+} // namespace
+
+bool island_user_pins(const int* pinned_vertices, int num_pinned_vertices,
+                      const int* global_to_local, int num_mesh_vertices,
+                      int* pin1_out, int* pin2_out) {
+    if (!pinned_vertices) return false;
+    int found[2] = {-1, -1};
+    int num_found = 0;
+    for (int i = 0; i < num_pinned_vertices && num_found < 2; i++) {
+        int v = pinned_vertices[i];
+        if (v < 0 || v >= num_mesh_vertices) continue;
+        int local = global_to_local[v];
+        if (local < 0 || (num_found == 1 && local == found[0])) continue;
+        found[num_found++] = local;
+    }
+    if (num_found < 2) return false;
+    *pin1_out = found[0];
+    *pin2_out = found[1];
+    return true;
+}
+
+void select_pins(const Mesh* mesh,
+                 const std::vector<int>& local_to_global,
+                 const std::vector<int>& candidates,
+                 int method,
+                 int* pin1_out,
+                 int* pin2_out) {
+    int n = (int)local_to_global.size();
+    std::vector<int> locals(candidates);
+    if (method == LSCM_PIN_FARTHEST_PAIR || locals.size() < 2) {
+        std::sort(locals.begin(), locals.end());
+        locals.erase(std::unique(locals.begin(), locals.end()), locals.end());
+    }
+    if (locals.size() < 2) {
+        locals.resize(n);
+        for (int i = 0; i < n; i++) locals[i] = i;
+    }
+
+    std::vector<Vec3> points(locals.size());
+    for (size_t i = 0; i < locals.size(); i++) {
+        points[i] = vertex_position(mesh, local_to_global[locals[i]]);
+    }
+
+    int a = 0, b = 0;
+    switch (method) {
+        case LSCM_PIN_PRINCIPAL_AXIS:
+            if (!principal_axis(points, &a, &b)) double_sweep(points, &a, &b);
+            break;
+        case LSCM_PIN_FARTHEST_PAIR:
+            farthest_pair(points, &a, &b);
+            break;
+        default:
+            double_sweep(points, &a, &b);
+            break;
+    }
+
+    int pin1 = locals[a];
+    int pin2 = locals[b];
+    if (pin1 == pin2) pin2 = (pin1 + 1) % n;  // Every candidate coincides
+    *pin1_out = pin1;
+    *pin2_out = pin2;
+}
+
+} // namespace uvunwrap
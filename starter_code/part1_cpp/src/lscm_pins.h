@@ -0,0 +1,40 @@
+/**
+ * @file lscm_pins.h
+ * @brief Internal LSCM pin selection
+ *
+ * Not part of the public API; the methods are LscmPinMethod in lscm.h.
+ * All indices are island-local.
+ */
+
+#ifndef UVUNWRAP_LSCM_PINS_H
+#define UVUNWRAP_LSCM_PINS_H
+
+#include "mesh.h"
+#include <vector>
+
+namespace uvunwrap {
+
+/**
+ * @brief First two listed pins that belong to the island
+ * @param global_to_local Mesh vertex -> local index, -1 outside the island
+ * @return true if two distinct pins were found
+ */
+bool island_user_pins(const int* pinned_vertices, int num_pinned_vertices,
+                      const int* global_to_local, int num_mesh_vertices,
+                      int* pin1_out, int* pin2_out);
+
+/**
+ * @brief Choose two distinct pins with an LscmPinMethod
+ * @param candidates Boundary vertices (may repeat); empty means every
+ *        island vertex is a candidate
+ */
+void select_pins(const Mesh* mesh,
+                 const std::vector<int>& local_to_global,
+                 const std::vector<int>& candidates,
+                 int method,
+                 int* pin1_out,
+                 int* pin2_out);
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_LSCM_PINS_H */
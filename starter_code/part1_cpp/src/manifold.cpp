@@ -0,0 +1,154 @@
+/**
+ * @file manifold.cpp
+ * @brief Non-manifold edge and vertex detection and repair
+ *
+ * Works on the half-edge view, where a non-manifold edge already joins
+ * only its lowest and highest face. Corners (one per half-edge origin)
+ * are united across every twin pair, so each set is a fan: the faces
+ * around a vertex that are connected through shared edges. A manifold
+ * vertex has one fan; a bowtie vertex, or an end of a non-manifold edge,
+ * has several. Repair gives every extra fan its own copy of the vertex,
+ * which also cuts each non-manifold edge into manifold ones.
+ */
+
+#include "topology.h"
+#include "half_edge.h"
+#include "disjoint_set.h"
+#include "logging.h"
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+namespace uvunwrap {
+
+namespace {
+
+/** Corner of face f at vertex v (the half-edge leaving v), or -1 */
+inline int corner_at(const HalfEdgeMesh& he, int f, int v) {
+    for (int k = 0; k < 3; k++) {
+        if (he.vertex[3 * f + k] == v) return 3 * f + k;
+    }
+    return -1;
+}
+
+} // namespace
+
+int label_vertex_fans(const HalfEdgeMesh& he,
+                      std::vector<int>& corner_fan,
+                      std::vector<int>& fan_vertex,
+                      int* num_nonmanifold_vertices_out) {
+    int H = he.num_faces * 3;
+    DisjointSet corners(H);
+    for (int h = 0; h < H; h++) {
+        int t = he.twin[h];
+        if (t < h) continue;  // Each pair once; also skips boundaries
+        int g = HalfEdgeMesh::face(t);
+        int a = corner_at(he, g, he.origin(h));
+        int b = corner_at(he, g, he.target(h));
+        if (a >= 0) corners.unite(h, a);
+        if (b >= 0) corners.unite(HalfEdgeMesh::next(h), b);
+    }
+
+    // Number fans by their lowest corner
+    corner_fan.assign(H, -1);
+    fan_vertex.clear();
+    std::vector<int> fans_per_vertex(he.num_vertices, 0);
+    int num_nonmanifold = 0;
+    for (int h = 0; h < H; h++) {
+        int root = corners.find(h);
+        if (corner_fan[root] < 0) {
+            corner_fan[root] = (int)fan_vertex.size();
+            fan_vertex.push_back(he.origin(h));
+            if (++fans_per_vertex[he.origin(h)] == 2) num_nonmanifold++;
+        }
+        corner_fan[h] = corner_fan[root];
+    }
+    if (num_nonmanifold_vertices_out) *num_nonmanifold_vertices_out = num_nonmanifold;
+    return (int)fan_vertex.size();
+}
+
+} // namespace uvunwrap
+
+/** Validate mesh and build its half-edges and fans */
+static bool analyze_manifold(const Mesh* mesh,
+                             uvunwrap::HalfEdgeMesh& he,
+                             std::vector<int>& corner_fan,
+                             std::vector<int>& fan_vertex,
+                             ManifoldReport* report) {
+    memset(report, 0, sizeof(*report));
+    if (!mesh || mesh->num_vertices < 0 || (mesh->num_triangles > 0 && !mesh->triangles)) return false;
+    for (int c = 0; c < mesh->num_triangles * 3; c++) {
+        if (mesh->triangles[c] < 0 || mesh->triangles[c] >= mesh->num_vertices) {
+            LOG_ERROR("Triangle %d references vertex %d of %d", c / 3, mesh->triangles[c], mesh->num_vertices);
+            return false;
+        }
+    }
+    if (!uvunwrap::build_half_edge_mesh(mesh, &he, 0)) return false;
+    report->num_nonmanifold_edges = he.num_nonmanifold_edges;
+    uvunwrap::label_vertex_fans(he, corner_fan, fan_vertex, &report->num_nonmanifold_vertices);
+    return true;
+}
+
+int check_manifold(const Mesh* mesh, ManifoldReport* report_out) {
+    ManifoldReport report;
+    uvunwrap::HalfEdgeMesh he;
+    std::vector<int> corner_fan, fan_vertex;
+    if (!analyze_manifold(mesh, he, corner_fan, fan_vertex, &report)) {
+        LOG_ERROR("check_manifold: Invalid mesh");
+        return -1;
+    }
+    if (report_out) *report_out = report;
+    return report.num_nonmanifold_edges == 0 && report.num_nonmanifold_vertices == 0;
+}
+
+Mesh* repair_nonmanifold(const Mesh* mesh, ManifoldReport* report_out) {
+    ManifoldReport report;
+    uvunwrap::HalfEdgeMesh he;
+    std::vector<int> corner_fan, fan_vertex;
+    if (!analyze_manifold(mesh, he, corner_fan, fan_vertex, &report)) {
+        LOG_ERROR("repair_nonmanifold: Invalid mesh");
+        if (report_out) memset(report_out, 0, sizeof(*report_out));
+        return NULL;
+    }
+
+    // A vertex's first fan keeps its index; later fans get copies appended
+    // in fan order. Vertices without faces are kept as they are.
+    int V = mesh->num_vertices;
+    int num_fans = (int)fan_vertex.size();
+    std::vector<int> fan_index(num_fans);
+    std::vector<char> claimed(V, 0);
+    int num_out = V;
+    for (int fan = 0; fan < num_fans; fan++) {
+        int v = fan_vertex[fan];
+        if (!claimed[v]) {
+            claimed[v] = 1;
+            fan_index[fan] = v;
+        } else {
+            fan_index[fan] = num_out++;
+        }
+    }
+    report.num_split_vertices = num_out - V;
+
+    Mesh* out = (Mesh*)malloc(sizeof(Mesh));
+    out->num_vertices = num_out;
+    out->num_triangles = mesh->num_triangles;
+    out->vertices = (float*)malloc((size_t)(num_out > 0 ? num_out : 1) * 3 * sizeof(float));
+    out->triangles = (int*)malloc((size_t)(mesh->num_triangles > 0 ? mesh->num_triangles : 1) * 3 * sizeof(int));
+    out->uvs = mesh->uvs ? (float*)malloc((size_t)(num_out > 0 ? num_out : 1) * 2 * sizeof(float)) : NULL;
+    memcpy(out->vertices, mesh->vertices, (size_t)V * 3 * sizeof(float));
+    if (out->uvs) memcpy(out->uvs, mesh->uvs, (size_t)V * 2 * sizeof(float));
+    for (int fan = 0; fan < num_fans; fan++) {
+        int dst = fan_index[fan];
+        if (dst < V) continue;
+        memcpy(&out->vertices[dst * 3], &mesh->vertices[fan_vertex[fan] * 3], 3 * sizeof(float));
+        if (out->uvs) memcpy(&out->uvs[dst * 2], &mesh->uvs[fan_vertex[fan] * 2], 2 * sizeof(float));
+    }
+    for (int c = 0; c < mesh->num_triangles * 3; c++) out->triangles[c] = fan_index[corner_fan[c]];
+
+    if (report.num_split_vertices > 0) {
+        LOG_INFO("Repaired %d non-manifold edges and %d non-manifold vertices (%d vertex copies)",
+                 report.num_nonmanifold_edges, report.num_nonmanifold_vertices, report.num_split_vertices);
+    }
+    if (report_out) *report_out = report;
+    return out;
+}
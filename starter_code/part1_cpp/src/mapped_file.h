@@ -0,0 +1,175 @@
+/**
+ * @file mapped_file.h
+ * @brief Internal whole-file view: mmap where available, a read elsewhere
+ *
+ * Not part of the public API. open() maps privately, so a writable view
+ * gives copy-on-write pages and never touches the file; create() maps a
+ * new file shared so writes land in it.
+ */
+
+#ifndef UVUNWRAP_MAPPED_FILE_H
+#define UVUNWRAP_MAPPED_FILE_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace uvunwrap {
+
+class MappedFile {
+public:
+    MappedFile() : data_(NULL), size_(0) {
+#ifndef _WIN32
+        mapping_ = NULL;
+#endif
+    }
+
+    ~MappedFile() {
+#ifndef _WIN32
+        if (mapping_) munmap(mapping_, size_);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Map the whole file
+     * @param writable Map pages copy-on-write so data() may be modified
+     * @return false if the file cannot be opened or mapped
+     */
+    bool open(const char* filename, bool writable = false) {
+#ifdef _WIN32
+        (void)writable;
+        FILE* f = fopen(filename, "rb");
+        if (!f) return false;
+        fseek(f, 0, SEEK_END);
+        long length = ftell(f);
+        fseek(f, 0, SEEK_SET);
+        if (length > 0) {
+            buffer_.resize((size_t)length);
+            size_ = fread(buffer_.data(), 1, buffer_.size(), f);
+            data_ = buffer_.data();
+        }
+        fclose(f);
+        return true;
+#else
+        int fd = ::open(filename, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            return false;
+        }
+        if (st.st_size > 0) {
+            int prot = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+            mapping_ = mmap(NULL, (size_t)st.st_size, prot, MAP_PRIVATE, fd, 0);
+            if (mapping_ == MAP_FAILED) {
+                mapping_ = NULL;
+                close(fd);
+                return false;
+            }
+            size_ = (size_t)st.st_size;
+            data_ = (char*)mapping_;
+        }
+        close(fd);
+        return true;
+#endif
+    }
+
+    /**
+     * @brief Create (or truncate) a file of the given size and map it writable
+     * @return false if the file cannot be created or mapped
+     */
+    bool create(const char* filename, size_t size) {
+#ifdef _WIN32
+        buffer_.assign(size, 0);
+        data_ = buffer_.data();
+        size_ = size;
+        create_path_ = filename;
+        FILE* f = fopen(filename, "wb");
+        if (!f) return false;
+        fclose(f);
+        return true;
+#else
+        int fd = ::open(filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return false;
+        if (size == 0 || ftruncate(fd, (off_t)size) != 0) {
+            close(fd);
+            return false;
+        }
+        mapping_ = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapping_ == MAP_FAILED) {
+            mapping_ = NULL;
+            return false;
+        }
+        size_ = size;
+        data_ = (char*)mapping_;
+        return true;
+#endif
+    }
+
+    /** Write back a create()d file; false on I/O error */
+    bool flush() {
+#ifdef _WIN32
+        if (create_path_.empty()) return true;
+        FILE* f = fopen(create_path_.c_str(), "wb");
+        if (!f) return false;
+        bool ok = fwrite(buffer_.data(), 1, buffer_.size(), f) == buffer_.size();
+        if (fclose(f) != 0) ok = false;
+        return ok;
+#else
+        return !mapping_ || msync(mapping_, size_, MS_SYNC) == 0;
+#endif
+    }
+
+    /** Hint that the file will be read front to back */
+    void advise_sequential() {
+#ifndef _WIN32
+        if (mapping_) madvise(mapping_, size_, MADV_SEQUENTIAL);
+#endif
+    }
+
+    /**
+     * @brief Ask the OS to start reading a file into the page cache
+     *
+     * Returns at once; a later open() then finds the pages resident. A
+     * no-op where posix_fadvise() is missing.
+     */
+    static void prefetch(const char* filename) {
+#if !defined(_WIN32) && defined(POSIX_FADV_WILLNEED)
+        int fd = ::open(filename, O_RDONLY);
+        if (fd < 0) return;
+        posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+        close(fd);
+#else
+        (void)filename;
+#endif
+    }
+
+    char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    char* data_;
+    size_t size_;
+#ifdef _WIN32
+    std::vector<char> buffer_;
+    std::string create_path_;
+#else
+    void* mapping_;
+#endif
+};
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_MAPPED_FILE_H */
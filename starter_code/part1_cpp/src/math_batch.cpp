@@ -0,0 +1,156 @@
+/**
+ * @file math_batch.cpp
+ * @brief SoA batch vector math with runtime SIMD selection
+ *
+ * Each kernel is written once against the lane type of simd.h (AVX-512,
+ * AVX, SSE2, NEON or plain floats, chosen by the compiler's target
+ * macros) in math_batch_kernels.cpp. A default build has one copy, for
+ * what the compiler targets (-DUVUNWRAP_NATIVE_ARCH=ON: the host's
+ * widest); -DUVUNWRAP_MULTI_ISA=ON adds AVX2 and AVX-512 copies and the
+ * widest the CPU supports is picked on first use. Leftover elements go
+ * through the scalar inline math.
+ *
+ * Only correctly rounded operations are used, in the scalar order, so
+ * every path gives the same floats as vec3_cross() / vec3_length()
+ * (unless the compiler is allowed to contract the scalar code to FMA).
+ *
+ * Mesh-based functions gather blocks of BATCH_BLOCK triangles into stack
+ * SoA buffers, so they need no heap memory.
+ */
+
+#include "math_utils.h"
+#include "math_batch_kernels.h"
+#include <string.h>
+#include <atomic>
+
+#define BATCH_BLOCK 256
+
+namespace {
+
+using uvunwrap::BatchKernels;
+
+std::atomic<const BatchKernels*> g_forced(NULL);
+
+bool cpu_runs(const BatchKernels* kernels) {
+#if defined(UVUNWRAP_MULTI_ISA)
+    if (kernels == &uvunwrap::isa_avx512::batch_kernels) return __builtin_cpu_supports("avx512f");
+    if (kernels == &uvunwrap::isa_avx2::batch_kernels) return __builtin_cpu_supports("avx2");
+#endif
+    return kernels == &uvunwrap::isa_base::batch_kernels;
+}
+
+/** Compiled copies, widest first */
+const BatchKernels* const VARIANTS[] = {
+#if defined(UVUNWRAP_MULTI_ISA)
+    &uvunwrap::isa_avx512::batch_kernels,
+    &uvunwrap::isa_avx2::batch_kernels,
+#endif
+    &uvunwrap::isa_base::batch_kernels,
+};
+const int NUM_VARIANTS = (int)(sizeof(VARIANTS) / sizeof(VARIANTS[0]));
+
+const BatchKernels* detect_kernels() {
+    for (int i = 0; i < NUM_VARIANTS; i++) {
+        if (cpu_runs(VARIANTS[i])) return VARIANTS[i];
+    }
+    return &uvunwrap::isa_base::batch_kernels;
+}
+
+const BatchKernels& kernels() {
+    static const BatchKernels* const detected = detect_kernels();
+    const BatchKernels* forced = g_forced.load(std::memory_order_acquire);
+    return forced ? *forced : *detected;
+}
+
+void cross_kernel(int n,
+                  const float* ax, const float* ay, const float* az,
+                  const float* bx, const float* by, const float* bz,
+                  float* ox, float* oy, float* oz) {
+    kernels().cross(n, ax, ay, az, bx, by, bz, ox, oy, oz);
+}
+
+void length_kernel(int n, const float* x, const float* y, const float* z, float s, float* out) {
+    kernels().length(n, x, y, z, s, out);
+}
+
+} // namespace
+
+void triangle_edges_soa(const Mesh* mesh, int begin, int count,
+                        float* e1x, float* e1y, float* e1z,
+                        float* e2x, float* e2y, float* e2z) {
+    const float* P = mesh->vertices;
+    const int* T = mesh->triangles;
+    for (int i = 0; i < count; i++) {
+        const int* t = &T[(begin + i) * 3];
+        const float* p0 = &P[t[0] * 3];
+        const float* p1 = &P[t[1] * 3];
+        const float* p2 = &P[t[2] * 3];
+        e1x[i] = p1[0] - p0[0]; e1y[i] = p1[1] - p0[1]; e1z[i] = p1[2] - p0[2];
+        e2x[i] = p2[0] - p0[0]; e2y[i] = p2[1] - p0[1]; e2z[i] = p2[2] - p0[2];
+    }
+}
+
+void vec3_cross_soa(int n,
+                    const float* ax, const float* ay, const float* az,
+                    const float* bx, const float* by, const float* bz,
+                    float* ox, float* oy, float* oz) {
+    cross_kernel(n, ax, ay, az, bx, by, bz, ox, oy, oz);
+}
+
+void vec3_length_soa(int n, const float* x, const float* y, const float* z, float* out) {
+    length_kernel(n, x, y, z, 1.0f, out);
+}
+
+void triangle_normals_soa(const Mesh* mesh, int begin, int count,
+                          float* nx, float* ny, float* nz) {
+    float e1x[BATCH_BLOCK], e1y[BATCH_BLOCK], e1z[BATCH_BLOCK];
+    float e2x[BATCH_BLOCK], e2y[BATCH_BLOCK], e2z[BATCH_BLOCK];
+    for (int block = 0; block < count; block += BATCH_BLOCK) {
+        int n = count - block < BATCH_BLOCK ? count - block : BATCH_BLOCK;
+        triangle_edges_soa(mesh, begin + block, n, e1x, e1y, e1z, e2x, e2y, e2z);
+        cross_kernel(n, e1x, e1y, e1z, e2x, e2y, e2z, nx + block, ny + block, nz + block);
+    }
+}
+
+void triangle_areas_batch(const Mesh* mesh, int begin, int count, float* areas) {
+    float nx[BATCH_BLOCK], ny[BATCH_BLOCK], nz[BATCH_BLOCK];
+    for (int block = 0; block < count; block += BATCH_BLOCK) {
+        int n = count - block < BATCH_BLOCK ? count - block : BATCH_BLOCK;
+        triangle_normals_soa(mesh, begin + block, n, nx, ny, nz);
+        length_kernel(n, nx, ny, nz, 0.5f, areas + block);
+    }
+}
+
+void edge_lengths_batch(const Mesh* mesh, const int* edges, int count, float* lengths) {
+    float dx[BATCH_BLOCK], dy[BATCH_BLOCK], dz[BATCH_BLOCK];
+    const float* P = mesh->vertices;
+    for (int block = 0; block < count; block += BATCH_BLOCK) {
+        int n = count - block < BATCH_BLOCK ? count - block : BATCH_BLOCK;
+        for (int i = 0; i < n; i++) {
+            const float* a = &P[edges[(block + i) * 2] * 3];
+            const float* b = &P[edges[(block + i) * 2 + 1] * 3];
+            dx[i] = b[0] - a[0];
+            dy[i] = b[1] - a[1];
+            dz[i] = b[2] - a[2];
+        }
+        length_kernel(n, dx, dy, dz, 1.0f, lengths + block);
+    }
+}
+
+const char* math_batch_isa(void) {
+    return kernels().name;
+}
+
+int math_batch_set_isa(const char* isa) {
+    if (!isa) {
+        g_forced.store(NULL, std::memory_order_release);
+        return 0;
+    }
+    for (int i = 0; i < NUM_VARIANTS; i++) {
+        if (strcmp(VARIANTS[i]->name, isa) == 0 && cpu_runs(VARIANTS[i])) {
+            g_forced.store(VARIANTS[i], std::memory_order_release);
+            return 0;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file math_batch_kernels.cpp
+ * @brief SIMD kernels behind math_batch.cpp, built once per instruction set
+ *
+ * See math_batch_kernels.h. UVUNWRAP_ISA_NAMESPACE names this copy. The
+ * build turns off FMA contraction here, so every copy rounds like the
+ * scalar functions and a mixed fleet gets the same floats on every node.
+ */
+
+#include "math_batch_kernels.h"
+#include "vec_math.h"
+#include "simd.h"
+
+#ifndef UVUNWRAP_ISA_NAMESPACE
+#define UVUNWRAP_ISA_NAMESPACE isa_base
+#endif
+
+namespace uvunwrap {
+namespace UVUNWRAP_ISA_NAMESPACE {
+
+namespace {
+
+typedef Lanes::V V;
+
+void cross_kernel(int n,
+                  const float* ax, const float* ay, const float* az,
+                  const float* bx, const float* by, const float* bz,
+                  float* ox, float* oy, float* oz) {
+    int i = 0;
+    for (; i + Lanes::N <= n; i += Lanes::N) {
+        V x0 = Lanes::load(ax + i), y0 = Lanes::load(ay + i), z0 = Lanes::load(az + i);
+        V x1 = Lanes::load(bx + i), y1 = Lanes::load(by + i), z1 = Lanes::load(bz + i);
+        Lanes::store(ox + i, Lanes::sub(Lanes::mul(y0, z1), Lanes::mul(z0, y1)));
+        Lanes::store(oy + i, Lanes::sub(Lanes::mul(z0, x1), Lanes::mul(x0, z1)));
+        Lanes::store(oz + i, Lanes::sub(Lanes::mul(x0, y1), Lanes::mul(y0, x1)));
+    }
+    for (; i < n; i++) {
+        Vec3 c = cross(Vec3{ax[i], ay[i], az[i]}, Vec3{bx[i], by[i], bz[i]});
+        ox[i] = c.x;
+        oy[i] = c.y;
+        oz[i] = c.z;
+    }
+}
+
+void length_kernel(int n, const float* x, const float* y, const float* z, float s, float* out) {
+    int i = 0;
+    V vs = Lanes::set1(s);
+    for (; i + Lanes::N <= n; i += Lanes::N) {
+        V vx = Lanes::load(x + i), vy = Lanes::load(y + i), vz = Lanes::load(z + i);
+        V sq = Lanes::add(Lanes::add(Lanes::mul(vx, vx), Lanes::mul(vy, vy)), Lanes::mul(vz, vz));
+        V len = Lanes::sqrt(sq);
+        Lanes::store(out + i, s == 1.0f ? len : Lanes::mul(len, vs));
+    }
+    for (; i < n; i++) {
+        float len = length(Vec3{x[i], y[i], z[i]});
+        out[i] = s == 1.0f ? len : len * s;
+    }
+}
+
+} // namespace
+
+// extern: the declaration in math_batch_kernels.h only covers the copies
+// math_batch.cpp was built to expect
+extern const BatchKernels batch_kernels = {Lanes::name(), cross_kernel, length_kernel};
+
+} // namespace UVUNWRAP_ISA_NAMESPACE
+} // namespace uvunwrap
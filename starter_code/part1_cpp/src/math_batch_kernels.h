@@ -0,0 +1,36 @@
+/**
+ * @file math_batch_kernels.h
+ * @brief Internal per-ISA batch math kernels and their runtime dispatch
+ *
+ * Not part of the public API. math_batch_kernels.cpp is compiled once for
+ * whatever the compiler targets (namespace isa_base) and, with
+ * UVUNWRAP_MULTI_ISA, again with -mavx2 and -mavx512f (isa_avx2,
+ * isa_avx512), simd.h picking each copy's lanes. math_batch.cpp picks
+ * the widest table the CPU runs.
+ */
+
+#ifndef UVUNWRAP_MATH_BATCH_KERNELS_H
+#define UVUNWRAP_MATH_BATCH_KERNELS_H
+
+namespace uvunwrap {
+
+/** One compiled copy of the batch kernels */
+struct BatchKernels {
+    const char* name;            /**< Lanes::name() of the copy */
+    void (*cross)(int n,
+                  const float* ax, const float* ay, const float* az,
+                  const float* bx, const float* by, const float* bz,
+                  float* ox, float* oy, float* oz);
+    /** out = |v| * s (s = 1 for plain lengths, 0.5 for areas from normals) */
+    void (*length)(int n, const float* x, const float* y, const float* z, float s, float* out);
+};
+
+namespace isa_base { extern const BatchKernels batch_kernels; }
+#if defined(UVUNWRAP_MULTI_ISA)
+namespace isa_avx2 { extern const BatchKernels batch_kernels; }
+namespace isa_avx512 { extern const BatchKernels batch_kernels; }
+#endif
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_MATH_BATCH_KERNELS_H */
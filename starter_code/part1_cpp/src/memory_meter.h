@@ -0,0 +1,114 @@
+/**
+ * @file memory_meter.h
+ * @brief Internal byte accounting and memory budget of one unwrap call
+ *
+ * Not part of the public API. Counts the buffers that dominate a call's
+ * footprint (arena blocks, topology, output mesh, island solves) rather
+ * than every heap call. Eigen has no allocation hook, so an island's
+ * solver memory is charged from the sizes of the matrices and factors it
+ * built (LscmReport::peak_bytes).
+ */
+
+#ifndef UVUNWRAP_MEMORY_METER_H
+#define UVUNWRAP_MEMORY_METER_H
+
+#include <mutex>
+#include <vector>
+
+namespace uvunwrap {
+
+class MemoryMeter {
+public:
+    MemoryMeter() : current_(0), peak_(0), stage_peak_(0), budget_(0), reservations_(0) {}
+
+    MemoryMeter(const MemoryMeter&) = delete;
+    MemoryMeter& operator=(const MemoryMeter&) = delete;
+
+    /** Bytes the budget admits island solves under (<= 0 = unlimited) */
+    void set_budget(long long bytes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        budget_ = bytes;
+    }
+
+    void charge(long long bytes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        add(bytes);
+    }
+
+    void release(long long bytes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        add(-bytes);
+    }
+
+    long long current() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return current_;
+    }
+
+    long long peak() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return peak_;
+    }
+
+    /** Peak since the previous call (or construction); the next stage starts from current() */
+    long long end_stage() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        long long stage_peak = stage_peak_;
+        stage_peak_ = current_;
+        return stage_peak;
+    }
+
+    /**
+     * @brief Charge an island's predicted bytes if they fit in the budget
+     *
+     * They fit if current() stays within the budget or no other
+     * reservation is held, so one island always runs however small the
+     * budget. Callers that get false pick other work and retry once a
+     * reservation is dropped (TaskGraph does).
+     */
+    bool try_reserve(long long bytes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (budget_ > 0 && reservations_ > 0 && current_ + bytes > budget_) return false;
+        reservations_++;
+        add(bytes);
+        return true;
+    }
+
+    /** Replace a reservation's estimate by what the island actually used */
+    void adjust(long long estimated, long long actual) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        add(actual - estimated);
+    }
+
+    /** Drop a reservation of bytes */
+    void unreserve(long long bytes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        reservations_--;
+        add(-bytes);
+    }
+
+private:
+    /** Caller holds mutex_ */
+    void add(long long bytes) {
+        current_ += bytes;
+        if (current_ > peak_) peak_ = current_;
+        if (current_ > stage_peak_) stage_peak_ = current_;
+    }
+
+    std::mutex mutex_;
+    long long current_;
+    long long peak_;
+    long long stage_peak_;
+    long long budget_;
+    int reservations_;
+};
+
+/** Heap bytes held by a vector */
+template <typename T>
+inline long long vector_bytes(const std::vector<T>& v) {
+    return (long long)(v.capacity() * sizeof(T));
+}
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_MEMORY_METER_H */
@@ -0,0 +1,697 @@
+/**
+ * @file mesh_bin.cpp
+ * @brief Binary mesh + unwrap result container
+ *
+ * Layout (all little-endian):
+ *   FileHeader (64 bytes)
+ *   SectionEntry[num_sections] (48 bytes each)
+ *   sections, each starting on a 64-byte boundary
+ *
+ * The header checksum covers the header and the section table; each
+ * section has its own checksum over its stored bytes. Unknown section
+ * types are skipped so later versions can add data without breaking
+ * older readers.
+ *
+ * Quantised UVs (save_mesh_bin_quantized()) replace the float UV section
+ * by 16-bit values and a table of the boxes that decode them; readers
+ * that predate them load such a file without UVs.
+ */
+
+#include "mesh_bin.h"
+#include "mapped_file.h"
+#include "mesh_bin_writer.h"
+#include "uv_quantize.h"
+#include "logging.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <vector>
+
+#ifdef UVUNWRAP_HAVE_LZ4
+#include <lz4.h>
+#endif
+
+#ifdef UVUNWRAP_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+
+const char MESH_BIN_MAGIC[8] = {'U', 'V', 'M', 'E', 'S', 'H', 'B', 'N'};
+const uint32_t MESH_BIN_VERSION = 1;
+const uint32_t MESH_BIN_ENDIAN_TAG = 0x01020304;
+const size_t MESH_BIN_ALIGNMENT = 64;
+const int MESH_BIN_ZSTD_LEVEL = 3;
+
+enum SectionType {
+    SECTION_VERTICES = 1,
+    SECTION_TRIANGLES = 2,
+    SECTION_UVS = 3,
+    SECTION_FACE_ISLAND_IDS = 4,
+    SECTION_METRICS = 5,
+    SECTION_QUALITY = 6,
+    SECTION_UVS_Q16 = 7,
+    SECTION_UV_BOXES = 8
+};
+
+/** Sections the streaming writer can hold, in write order */
+const int MAX_SECTIONS = 6;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t endian_tag;
+    uint32_t num_vertices;
+    uint32_t num_triangles;
+    uint32_t num_sections;
+    uint32_t reserved0;
+    uint64_t checksum;      /**< Over header (this field zeroed) and section table */
+    uint8_t reserved[24];
+};
+
+struct SectionEntry {
+    uint32_t type;
+    uint32_t compression;
+    uint64_t offset;
+    uint64_t stored_size;
+    uint64_t raw_size;
+    uint64_t checksum;      /**< Over the stored (possibly compressed) bytes */
+    uint64_t reserved;
+};
+
+/** UnwrapResult scalars */
+struct MetricsRecord {
+    int32_t num_islands;
+    float avg_stretch;
+    float max_stretch;
+    float coverage;
+    int32_t solver_iterations;
+    float solver_residual;
+    uint8_t reserved[8];
+};
+
+/** UnwrapResult scalars MetricsRecord has no room for */
+struct QualityRecord {
+    float stretch_l2;
+    float stretch_linf;
+    float angle_distortion;
+    float max_angle_distortion;
+    int32_t num_degenerate_faces;
+    float overlap;
+    int32_t num_tiles;
+    float uv_density;
+};
+
+/** Head of SECTION_UV_BOXES, followed by num_boxes * 4 floats */
+struct UvBoxesRecord {
+    uint32_t grid;           /**< UvQuantizeGrid */
+    uint32_t num_boxes;
+    uint8_t reserved[8];
+};
+
+static_assert(sizeof(FileHeader) == 64, "FileHeader must stay 64 bytes");
+static_assert(sizeof(SectionEntry) == 48, "SectionEntry must stay 48 bytes");
+static_assert(sizeof(MetricsRecord) == 32, "MetricsRecord must stay 32 bytes");
+static_assert(sizeof(QualityRecord) == 32, "QualityRecord must stay 32 bytes");
+static_assert(sizeof(UvBoxesRecord) == 16, "UvBoxesRecord must stay 16 bytes");
+
+void fill_records(const UnwrapResult* result, MetricsRecord* metrics, QualityRecord* quality) {
+    memset(metrics, 0, sizeof(*metrics));
+    memset(quality, 0, sizeof(*quality));
+    if (!result) return;
+    metrics->num_islands = result->num_islands;
+    metrics->avg_stretch = result->avg_stretch;
+    metrics->max_stretch = result->max_stretch;
+    metrics->coverage = result->coverage;
+    metrics->solver_iterations = result->solver_iterations;
+    metrics->solver_residual = result->solver_residual;
+    quality->stretch_l2 = result->stretch_l2;
+    quality->stretch_linf = result->stretch_linf;
+    quality->angle_distortion = result->angle_distortion;
+    quality->max_angle_distortion = result->max_angle_distortion;
+    quality->num_degenerate_faces = result->num_degenerate_faces;
+    quality->overlap = result->overlap;
+    quality->num_tiles = result->num_tiles;
+    quality->uv_density = result->uv_density;
+}
+
+/**
+ * @brief FNV-1a over 64-bit little-endian words (tail bytes folded singly)
+ */
+uint64_t checksum_bytes(const void* data, size_t size, uint64_t hash = 1469598103934665603ull) {
+    const uint64_t prime = 1099511628211ull;
+    const unsigned char* p = (const unsigned char*)data;
+    size_t words = size / 8;
+    for (size_t i = 0; i < words; i++) {
+        uint64_t w;
+        memcpy(&w, p + i * 8, sizeof(w));
+        hash = (hash ^ w) * prime;
+    }
+    for (size_t i = words * 8; i < size; i++) {
+        hash = (hash ^ p[i]) * prime;
+    }
+    return hash;
+}
+
+uint64_t checksum_table(const FileHeader& header, const SectionEntry* entries) {
+    FileHeader copy = header;
+    copy.checksum = 0;
+    uint64_t hash = checksum_bytes(&copy, sizeof(copy));
+    return checksum_bytes(entries, header.num_sections * sizeof(SectionEntry), hash);
+}
+
+size_t align_up(size_t value) {
+    return (value + MESH_BIN_ALIGNMENT - 1) & ~(MESH_BIN_ALIGNMENT - 1);
+}
+
+/** Compress src into dst; false if the codec is missing or it does not shrink */
+bool compress_section(MeshBinCompression compression, const void* src, size_t size,
+                      std::vector<char>& dst) {
+#ifdef UVUNWRAP_HAVE_LZ4
+    if (compression == MESH_BIN_COMPRESSION_LZ4) {
+        if (size > (size_t)LZ4_MAX_INPUT_SIZE) return false;
+        dst.resize(LZ4_compressBound((int)size));
+        int written = LZ4_compress_default((const char*)src, dst.data(), (int)size, (int)dst.size());
+        if (written <= 0 || (size_t)written >= size) return false;
+        dst.resize(written);
+        return true;
+    }
+#endif
+#ifdef UVUNWRAP_HAVE_ZSTD
+    if (compression == MESH_BIN_COMPRESSION_ZSTD) {
+        dst.resize(ZSTD_compressBound(size));
+        size_t written = ZSTD_compress(dst.data(), dst.size(), src, size, MESH_BIN_ZSTD_LEVEL);
+        if (ZSTD_isError(written) || written >= size) return false;
+        dst.resize(written);
+        return true;
+    }
+#endif
+    (void)compression;
+    (void)src;
+    (void)size;
+    (void)dst;
+    return false;
+}
+
+bool decompress_section(uint32_t compression, const char* src, size_t stored_size,
+                        char* dst, size_t raw_size) {
+#ifdef UVUNWRAP_HAVE_LZ4
+    if (compression == MESH_BIN_COMPRESSION_LZ4) {
+        if (stored_size > (size_t)LZ4_MAX_INPUT_SIZE || raw_size > (size_t)LZ4_MAX_INPUT_SIZE) return false;
+        int read = LZ4_decompress_safe(src, dst, (int)stored_size, (int)raw_size);
+        return read >= 0 && (size_t)read == raw_size;
+    }
+#endif
+#ifdef UVUNWRAP_HAVE_ZSTD
+    if (compression == MESH_BIN_COMPRESSION_ZSTD) {
+        size_t read = ZSTD_decompress(dst, raw_size, src, stored_size);
+        return !ZSTD_isError(read) && read == raw_size;
+    }
+#endif
+    (void)compression;
+    (void)src;
+    (void)stored_size;
+    (void)dst;
+    (void)raw_size;
+    return false;
+}
+
+struct PendingSection {
+    uint32_t type;
+    const void* data;
+    size_t raw_size;
+    std::vector<char> compressed;
+    bool is_compressed;
+};
+
+/**
+ * @brief Decode SECTION_UVS_Q16 with its boxes into uvs_out
+ * @return false if the box table is malformed or a per-island file has no island ids
+ */
+bool decode_uvs(const uint16_t* q16, const char* boxes_section, size_t boxes_size, const Mesh& mesh,
+                const int* face_island_ids, float* uvs_out) {
+    UvBoxesRecord head;
+    if (boxes_size < sizeof(head)) return false;
+    memcpy(&head, boxes_section, sizeof(head));
+    if (head.num_boxes == 0 || (boxes_size - sizeof(head)) / (4 * sizeof(float)) != head.num_boxes) return false;
+
+    QuantizedUvs quantized;
+    memset(&quantized, 0, sizeof(quantized));
+    quantized.num_vertices = mesh.num_vertices;
+    quantized.uvs = (uint16_t*)q16;
+    quantized.grid = (int)head.grid;
+    quantized.num_boxes = (int)head.num_boxes;
+    std::vector<float> boxes((size_t)head.num_boxes * 4);
+    memcpy(boxes.data(), boxes_section + sizeof(head), boxes.size() * sizeof(float));
+    quantized.boxes = boxes.data();
+
+    // Per-island boxes follow the island of each vertex's first face, as quantize_uvs() assigned them
+    std::vector<int> vertex_box;
+    if (head.grid == UV_QUANTIZE_PER_ISLAND) {
+        if (!face_island_ids) return false;
+        vertex_box.assign(mesh.num_vertices, -1);
+        for (int f = 0; f < mesh.num_triangles; f++) {
+            int island = face_island_ids[f];
+            if (island < 0 || (uint32_t)island >= head.num_boxes) island = 0;
+            for (int k = 0; k < 3; k++) {
+                int v = mesh.triangles[f * 3 + k];
+                if (v >= 0 && v < mesh.num_vertices && vertex_box[v] < 0) vertex_box[v] = island;
+            }
+        }
+        for (size_t v = 0; v < vertex_box.size(); v++) {
+            if (vertex_box[v] < 0) vertex_box[v] = 0;
+        }
+        quantized.vertex_box = vertex_box.data();
+    }
+    dequantize_uvs(&quantized, uvs_out);
+    return true;
+}
+
+int save_sections(const Mesh* mesh,
+                  const UnwrapResult* result,
+                  const char* filename,
+                  MeshBinCompression compression,
+                  const QuantizedUvs* quantized);
+
+} // namespace
+
+struct MeshBin {
+    uvunwrap::MappedFile file;
+    Mesh mesh;
+    UnwrapResult result;
+    bool has_result;
+    std::vector<std::vector<char> > buffers;  /**< Decompressed sections */
+};
+
+int mesh_bin_compression_available(MeshBinCompression compression) {
+    switch (compression) {
+        case MESH_BIN_COMPRESSION_NONE:
+            return 1;
+        case MESH_BIN_COMPRESSION_LZ4:
+#ifdef UVUNWRAP_HAVE_LZ4
+            return 1;
+#else
+            return 0;
+#endif
+        case MESH_BIN_COMPRESSION_ZSTD:
+#ifdef UVUNWRAP_HAVE_ZSTD
+            return 1;
+#else
+            return 0;
+#endif
+    }
+    return 0;
+}
+
+int save_mesh_bin(const Mesh* mesh,
+                  const UnwrapResult* result,
+                  const char* filename,
+                  MeshBinCompression compression) {
+    return save_sections(mesh, result, filename, compression, NULL);
+}
+
+int save_mesh_bin_quantized(const Mesh* mesh,
+                            const UnwrapResult* result,
+                            const char* filename,
+                            MeshBinCompression compression,
+                            const UvQuantizeOptions* options) {
+    if (!mesh || !filename) return -1;
+    if (!mesh->uvs) return save_sections(mesh, result, filename, compression, NULL);
+    const int* island_ids = result ? result->face_island_ids : NULL;
+    QuantizedUvs* quantized = quantize_uvs(mesh, island_ids, result ? result->num_islands : 0, options);
+    if (!quantized) {
+        LOG_ERROR("save_mesh_bin_quantized: %s: UVs cannot be quantised without adding overlap", filename);
+        return -1;
+    }
+    int rc = save_sections(mesh, result, filename, compression, quantized);
+    free_quantized_uvs(quantized);
+    return rc;
+}
+
+namespace {
+
+int save_sections(const Mesh* mesh,
+                  const UnwrapResult* result,
+                  const char* filename,
+                  MeshBinCompression compression,
+                  const QuantizedUvs* quantized) {
+    if (!mesh || !filename) return -1;
+
+    if (!mesh_bin_compression_available(compression)) {
+        LOG_WARNING("save_mesh_bin: compression %d not compiled in, storing uncompressed",
+                    (int)compression);
+        compression = MESH_BIN_COMPRESSION_NONE;
+    }
+
+    MetricsRecord metrics;
+    QualityRecord quality;
+    fill_records(result, &metrics, &quality);
+
+    std::vector<PendingSection> sections;
+    auto add = [&](uint32_t type, const void* data, size_t size) {
+        PendingSection section;
+        section.type = type;
+        section.data = data;
+        section.raw_size = size;
+        section.is_compressed = false;
+        sections.push_back(std::move(section));
+    };
+    add(SECTION_VERTICES, mesh->vertices, (size_t)mesh->num_vertices * 3 * sizeof(float));
+    add(SECTION_TRIANGLES, mesh->triangles, (size_t)mesh->num_triangles * 3 * sizeof(int));
+    std::vector<char> boxes;
+    if (quantized) {
+        UvBoxesRecord head;
+        memset(&head, 0, sizeof(head));
+        head.grid = (uint32_t)quantized->grid;
+        head.num_boxes = (uint32_t)quantized->num_boxes;
+        boxes.resize(sizeof(head) + (size_t)quantized->num_boxes * 4 * sizeof(float));
+        memcpy(boxes.data(), &head, sizeof(head));
+        memcpy(boxes.data() + sizeof(head), quantized->boxes, boxes.size() - sizeof(head));
+        add(SECTION_UVS_Q16, quantized->uvs, (size_t)mesh->num_vertices * 2 * sizeof(uint16_t));
+        add(SECTION_UV_BOXES, boxes.data(), boxes.size());
+    } else if (mesh->uvs) {
+        add(SECTION_UVS, mesh->uvs, (size_t)mesh->num_vertices * 2 * sizeof(float));
+    }
+    if (result) {
+        if (result->face_island_ids) {
+            add(SECTION_FACE_ISLAND_IDS, result->face_island_ids, (size_t)mesh->num_triangles * sizeof(int));
+        }
+        add(SECTION_METRICS, &metrics, sizeof(metrics));
+        add(SECTION_QUALITY, &quality, sizeof(quality));
+    }
+
+    FileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MESH_BIN_MAGIC, sizeof(header.magic));
+    header.version = MESH_BIN_VERSION;
+    header.endian_tag = MESH_BIN_ENDIAN_TAG;
+    header.num_vertices = (uint32_t)mesh->num_vertices;
+    header.num_triangles = (uint32_t)mesh->num_triangles;
+    header.num_sections = (uint32_t)sections.size();
+
+    std::vector<SectionEntry> entries(sections.size());
+    size_t offset = align_up(sizeof(FileHeader) + entries.size() * sizeof(SectionEntry));
+    for (size_t i = 0; i < sections.size(); i++) {
+        PendingSection& section = sections[i];
+        if (compression != MESH_BIN_COMPRESSION_NONE && section.type != SECTION_METRICS &&
+            section.type != SECTION_QUALITY) {
+            section.is_compressed = compress_section(compression, section.data, section.raw_size,
+                                                     section.compressed);
+        }
+
+        const void* stored = section.is_compressed ? section.compressed.data() : section.data;
+        size_t stored_size = section.is_compressed ? section.compressed.size() : section.raw_size;
+
+        SectionEntry& entry = entries[i];
+        memset(&entry, 0, sizeof(entry));
+        entry.type = section.type;
+        entry.compression = section.is_compressed ? (uint32_t)compression : (uint32_t)MESH_BIN_COMPRESSION_NONE;
+        entry.offset = offset;
+        entry.stored_size = stored_size;
+        entry.raw_size = section.raw_size;
+        entry.checksum = checksum_bytes(stored, stored_size);
+        offset = align_up(offset + stored_size);
+    }
+    header.checksum = checksum_table(header, entries.data());
+
+    FILE* f = fopen(filename, "wb");
+    if (!f) {
+        LOG_ERROR("Cannot write file: %s", filename);
+        return -1;
+    }
+
+    static const char zeros[MESH_BIN_ALIGNMENT] = {0};
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+    ok = ok && fwrite(entries.data(), sizeof(SectionEntry), entries.size(), f) == entries.size();
+    size_t written = sizeof(header) + entries.size() * sizeof(SectionEntry);
+    for (size_t i = 0; i < sections.size() && ok; i++) {
+        size_t padding = entries[i].offset - written;
+        ok = fwrite(zeros, 1, padding, f) == padding;
+        const void* stored = sections[i].is_compressed ? sections[i].compressed.data() : sections[i].data;
+        size_t stored_size = entries[i].stored_size;
+        ok = ok && fwrite(stored, 1, stored_size, f) == stored_size;
+        written = entries[i].offset + stored_size;
+    }
+
+    if (fclose(f) != 0) ok = false;
+    if (!ok) {
+        LOG_ERROR("Cannot write file: %s", filename);
+        return -1;
+    }
+    LOG_INFO("Saved %s", filename);
+    return 0;
+}
+
+} // namespace
+
+MeshBin* load_mesh_bin(const char* filename, int verify) {
+    MeshBin* bin = new MeshBin();
+    memset(&bin->mesh, 0, sizeof(bin->mesh));
+    memset(&bin->result, 0, sizeof(bin->result));
+    bin->has_result = false;
+
+    auto fail = [&](const char* message) -> MeshBin* {
+        LOG_ERROR("load_mesh_bin: %s: %s", filename, message);
+        delete bin;
+        return NULL;
+    };
+
+    if (!bin->file.open(filename, true)) {
+        LOG_ERROR("Cannot open file: %s", filename);
+        delete bin;
+        return NULL;
+    }
+    char* data = bin->file.data();
+    size_t size = bin->file.size();
+
+    FileHeader header;
+    if (size < sizeof(header)) return fail("file too small");
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, MESH_BIN_MAGIC, sizeof(header.magic)) != 0) return fail("not a mesh bin file");
+    if (header.endian_tag != MESH_BIN_ENDIAN_TAG) return fail("byte order mismatch");
+    if (header.version != MESH_BIN_VERSION) return fail("unsupported version");
+
+    size_t table_end = sizeof(header) + (size_t)header.num_sections * sizeof(SectionEntry);
+    if (table_end > size) return fail("truncated section table");
+    std::vector<SectionEntry> entries(header.num_sections);
+    memcpy(entries.data(), data + sizeof(header), entries.size() * sizeof(SectionEntry));
+    if (checksum_table(header, entries.data()) != header.checksum) return fail("header checksum mismatch");
+
+    size_t nv = header.num_vertices;
+    size_t nt = header.num_triangles;
+    bin->buffers.reserve(entries.size());
+    bool has_metrics = false;
+    bool has_quality = false;
+    MetricsRecord metrics;
+    QualityRecord quality;
+    fill_records(NULL, &metrics, &quality);
+    const uint16_t* q16 = NULL;
+    const char* uv_boxes = NULL;
+    size_t uv_boxes_size = 0;
+
+    for (size_t i = 0; i < entries.size(); i++) {
+        const SectionEntry& entry = entries[i];
+        size_t expected;
+        switch (entry.type) {
+            case SECTION_VERTICES: expected = nv * 3 * sizeof(float); break;
+            case SECTION_TRIANGLES: expected = nt * 3 * sizeof(int); break;
+            case SECTION_UVS: expected = nv * 2 * sizeof(float); break;
+            case SECTION_FACE_ISLAND_IDS: expected = nt * sizeof(int); break;
+            case SECTION_METRICS: expected = sizeof(MetricsRecord); break;
+            case SECTION_QUALITY: expected = sizeof(QualityRecord); break;
+            case SECTION_UVS_Q16: expected = nv * 2 * sizeof(uint16_t); break;
+            case SECTION_UV_BOXES: expected = entry.raw_size; break;  // Checked when decoding
+            default: continue;  // Newer section type
+        }
+
+        if (entry.offset > size || entry.stored_size > size - entry.offset) return fail("truncated section");
+        if (entry.raw_size != expected) return fail("section size does not match header counts");
+        char* stored = data + entry.offset;
+        if (verify && checksum_bytes(stored, entry.stored_size) != entry.checksum) {
+            return fail("section checksum mismatch");
+        }
+
+        char* raw = stored;
+        if (entry.compression != MESH_BIN_COMPRESSION_NONE) {
+            bin->buffers.push_back(std::vector<char>(entry.raw_size > 0 ? entry.raw_size : 1));
+            raw = bin->buffers.back().data();
+            if (!mesh_bin_compression_available((MeshBinCompression)entry.compression)) {
+                return fail("section compression not compiled in");
+            }
+            if (!decompress_section(entry.compression, stored, entry.stored_size, raw, entry.raw_size)) {
+                return fail("section failed to decompress");
+            }
+        } else if (entry.stored_size != entry.raw_size || entry.offset % sizeof(float) != 0) {
+            return fail("malformed section");
+        }
+
+        switch (entry.type) {
+            case SECTION_VERTICES: bin->mesh.vertices = (float*)raw; break;
+            case SECTION_TRIANGLES: bin->mesh.triangles = (int*)raw; break;
+            case SECTION_UVS: bin->mesh.uvs = (float*)raw; break;
+            case SECTION_FACE_ISLAND_IDS: bin->result.face_island_ids = (int*)raw; break;
+            case SECTION_METRICS:
+                memcpy(&metrics, raw, sizeof(metrics));
+                has_metrics = true;
+                break;
+            case SECTION_QUALITY:
+                memcpy(&quality, raw, sizeof(quality));
+                has_quality = true;
+                break;
+            case SECTION_UVS_Q16: q16 = (const uint16_t*)raw; break;
+            case SECTION_UV_BOXES:
+                uv_boxes = raw;
+                uv_boxes_size = entry.raw_size;
+                break;
+        }
+    }
+
+    if (!bin->mesh.vertices || !bin->mesh.triangles || nv == 0 || nt == 0) {
+        return fail("missing vertex or triangle data");
+    }
+    bin->mesh.num_vertices = (int)nv;
+    bin->mesh.num_triangles = (int)nt;
+
+    if (verify) {
+        for (size_t i = 0; i < nt * 3; i++) {
+            if (bin->mesh.triangles[i] < 0 || (size_t)bin->mesh.triangles[i] >= nv) {
+                return fail("triangle index out of range");
+            }
+        }
+    }
+
+    if (q16 && !bin->mesh.uvs) {
+        bin->buffers.push_back(std::vector<char>(nv * 2 * sizeof(float)));
+        float* uvs = (float*)bin->buffers.back().data();
+        if (!uv_boxes || !decode_uvs(q16, uv_boxes, uv_boxes_size, bin->mesh, bin->result.face_island_ids, uvs)) {
+            return fail("malformed quantised UVs");
+        }
+        bin->mesh.uvs = uvs;
+    }
+
+    if (has_metrics) {
+        bin->has_result = true;
+        bin->result.num_islands = metrics.num_islands;
+        bin->result.avg_stretch = metrics.avg_stretch;
+        bin->result.max_stretch = metrics.max_stretch;
+        bin->result.coverage = metrics.coverage;
+        bin->result.solver_iterations = metrics.solver_iterations;
+        bin->result.solver_residual = metrics.solver_residual;
+    }
+    if (has_metrics && has_quality) {
+        bin->result.stretch_l2 = quality.stretch_l2;
+        bin->result.stretch_linf = quality.stretch_linf;
+        bin->result.angle_distortion = quality.angle_distortion;
+        bin->result.max_angle_distortion = quality.max_angle_distortion;
+        bin->result.num_degenerate_faces = quality.num_degenerate_faces;
+        bin->result.overlap = quality.overlap;
+        bin->result.num_tiles = quality.num_tiles;
+        bin->result.uv_density = quality.uv_density;
+    }
+
+    LOG_INFO("Loaded %s: %d vertices, %d triangles",
+             filename, bin->mesh.num_vertices, bin->mesh.num_triangles);
+    return bin;
+}
+
+Mesh* mesh_bin_mesh(MeshBin* bin) {
+    return bin ? &bin->mesh : NULL;
+}
+
+const UnwrapResult* mesh_bin_result(const MeshBin* bin) {
+    return bin && bin->has_result ? &bin->result : NULL;
+}
+
+void free_mesh_bin(MeshBin* bin) {
+    delete bin;
+}
+
+namespace uvunwrap {
+
+MeshBinWriter::MeshBinWriter()
+    : num_vertices_(0), num_triangles_(0), with_uvs_(false), with_result_(false), num_sections_(0) {}
+
+bool MeshBinWriter::open(const char* filename, int num_vertices, int num_triangles,
+                         bool with_uvs, bool with_result) {
+    num_vertices_ = num_vertices;
+    num_triangles_ = num_triangles;
+    with_uvs_ = with_uvs;
+    with_result_ = with_result;
+
+    size_t sizes[MAX_SECTIONS];
+    num_sections_ = 0;
+    sizes[num_sections_++] = (size_t)num_vertices * 3 * sizeof(float);
+    sizes[num_sections_++] = (size_t)num_triangles * 3 * sizeof(int);
+    if (with_uvs) sizes[num_sections_++] = (size_t)num_vertices * 2 * sizeof(float);
+    if (with_result) {
+        sizes[num_sections_++] = (size_t)num_triangles * sizeof(int);
+        sizes[num_sections_++] = sizeof(MetricsRecord);
+        sizes[num_sections_++] = sizeof(QualityRecord);
+    }
+
+    size_t offset = align_up(sizeof(FileHeader) + num_sections_ * sizeof(SectionEntry));
+    for (int i = 0; i < num_sections_; i++) {
+        offsets_[i] = offset;
+        offset = align_up(offset + sizes[i]);
+    }
+
+    if (!file_.create(filename, offset)) {
+        LOG_ERROR("Cannot write file: %s", filename);
+        return false;
+    }
+    return true;
+}
+
+bool MeshBinWriter::finish(const UnwrapResult* result) {
+    FileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MESH_BIN_MAGIC, sizeof(header.magic));
+    header.version = MESH_BIN_VERSION;
+    header.endian_tag = MESH_BIN_ENDIAN_TAG;
+    header.num_vertices = (uint32_t)num_vertices_;
+    header.num_triangles = (uint32_t)num_triangles_;
+    header.num_sections = (uint32_t)num_sections_;
+
+    uint32_t types[MAX_SECTIONS];
+    size_t sizes[MAX_SECTIONS];
+    int n = 0;
+    types[n] = SECTION_VERTICES; sizes[n++] = (size_t)num_vertices_ * 3 * sizeof(float);
+    types[n] = SECTION_TRIANGLES; sizes[n++] = (size_t)num_triangles_ * 3 * sizeof(int);
+    if (with_uvs_) {
+        types[n] = SECTION_UVS;
+        sizes[n++] = (size_t)num_vertices_ * 2 * sizeof(float);
+    }
+    if (with_result_) {
+        types[n] = SECTION_FACE_ISLAND_IDS;
+        sizes[n++] = (size_t)num_triangles_ * sizeof(int);
+        types[n] = SECTION_METRICS;
+        sizes[n++] = sizeof(MetricsRecord);
+        types[n] = SECTION_QUALITY;
+        sizes[n++] = sizeof(QualityRecord);
+
+        MetricsRecord metrics;
+        QualityRecord quality;
+        fill_records(result, &metrics, &quality);
+        memcpy(section(n - 2), &metrics, sizeof(metrics));
+        memcpy(section(n - 1), &quality, sizeof(quality));
+    }
+
+    SectionEntry entries[MAX_SECTIONS];
+    for (int i = 0; i < n; i++) {
+        memset(&entries[i], 0, sizeof(entries[i]));
+        entries[i].type = types[i];
+        entries[i].compression = MESH_BIN_COMPRESSION_NONE;
+        entries[i].offset = offsets_[i];
+        entries[i].stored_size = sizes[i];
+        entries[i].raw_size = sizes[i];
+        entries[i].checksum = checksum_bytes(section(i), sizes[i]);
+    }
+    header.checksum = checksum_table(header, entries);
+
+    memcpy(file_.data(), &header, sizeof(header));
+    memcpy(file_.data() + sizeof(header), entries, n * sizeof(SectionEntry));
+    return file_.flush();
+}
+
+} // namespace uvunwrap
@@ -0,0 +1,56 @@
+/**
+ * @file mesh_bin_writer.h
+ * @brief Internal in-place writer for uncompressed mesh_bin files
+ *
+ * Not part of the public API. The whole file is laid out up front and
+ * mapped, so sections can be filled in any order and in pieces (the
+ * streaming unwrap writes UVs chunk by chunk); finish() computes the
+ * checksums and writes the header.
+ */
+
+#ifndef UVUNWRAP_MESH_BIN_WRITER_H
+#define UVUNWRAP_MESH_BIN_WRITER_H
+
+#include "mesh_bin.h"
+#include "mapped_file.h"
+#include <stdint.h>
+
+namespace uvunwrap {
+
+class MeshBinWriter {
+public:
+    MeshBinWriter();
+
+    /**
+     * @brief Create the file with vertex and triangle sections, plus UV
+     *        and face_island_ids/metrics sections when requested
+     */
+    bool open(const char* filename, int num_vertices, int num_triangles,
+              bool with_uvs, bool with_result);
+
+    float* vertices() { return (float*)section(0); }
+    int* triangles() { return (int*)section(1); }
+    float* uvs() { return with_uvs_ ? (float*)section(2) : NULL; }
+    int* face_island_ids() { return with_result_ ? (int*)section(with_uvs_ ? 3 : 2) : NULL; }
+
+    /**
+     * @brief Store result scalars (if opened with_result), checksum and flush
+     * @return false on I/O error
+     */
+    bool finish(const UnwrapResult* result);
+
+private:
+    char* section(int index) { return file_.data() + offsets_[index]; }
+
+    MappedFile file_;
+    int num_vertices_;
+    int num_triangles_;
+    bool with_uvs_;
+    bool with_result_;
+    int num_sections_;
+    uint64_t offsets_[6];
+};
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_MESH_BIN_WRITER_H */
@@ -0,0 +1,690 @@
+/**
+ * @file mesh_glb.cpp
+ * @brief glTF 2.0 binary (GLB) reader and writers
+ *
+ * A GLB is a 12-byte header, a JSON chunk describing accessors into
+ * buffer views of the binary chunk, and the binary chunk itself. The
+ * reader resolves each POSITION, TEXCOORD_0 and indices accessor to a
+ * pointer and stride inside the mapped file and copies from there.
+ *
+ * The mesh load_glb() builds is laid out by GlbLayout: one vertex range
+ * per distinct POSITION accessor, in first use, then every triangle
+ * primitive's indices offset into its range. save_glb_uvs() rebuilds the
+ * same layout from the source file to know which accessor each UV range
+ * belongs to.
+ */
+
+#include "mesh_formats.h"
+#include "uv_quantize.h"
+#include "mapped_file.h"
+#include "json.h"
+#include "logging.h"
+#include "trace.h"
+#include <float.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+using uvunwrap::JsonValue;
+
+namespace {
+
+const uint32_t GLB_MAGIC = 0x46546C67;        // "glTF"
+const uint32_t GLB_VERSION = 2;
+const uint32_t GLB_CHUNK_JSON = 0x4E4F534A;   // "JSON"
+const uint32_t GLB_CHUNK_BIN = 0x004E4942;    // "BIN\0"
+const size_t GLB_HEADER_BYTES = 12;
+const size_t GLB_CHUNK_HEADER_BYTES = 8;
+
+const int GL_UNSIGNED_BYTE = 5121;
+const int GL_UNSIGNED_SHORT = 5123;
+const int GL_UNSIGNED_INT = 5125;
+const int GL_FLOAT = 5126;
+const int GL_ARRAY_BUFFER = 34962;
+const int GL_ELEMENT_ARRAY_BUFFER = 34963;
+const int GLTF_MODE_TRIANGLES = 4;
+
+bool host_is_little_endian() {
+    const uint16_t probe = 1;
+    unsigned char first;
+    memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+size_t align4(size_t n) {
+    return (n + 3) & ~(size_t)3;
+}
+
+struct GlbFile {
+    uvunwrap::MappedFile file;
+    JsonValue json;
+    const char* bin;
+    size_t bin_size;
+    size_t bin_chunk_end;  // file offset just past the BIN chunk (0 if none)
+
+    GlbFile() : bin(NULL), bin_size(0), bin_chunk_end(0) {}
+};
+
+uint32_t read_u32(const char* p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+bool open_glb(const char* filename, GlbFile* glb, std::string* error) {
+    if (!host_is_little_endian()) {
+        *error = "big-endian hosts are not supported";
+        return false;
+    }
+    if (!glb->file.open(filename)) {
+        *error = "cannot open file";
+        return false;
+    }
+    const char* data = glb->file.data();
+    size_t size = glb->file.size();
+    if (size < GLB_HEADER_BYTES || read_u32(data) != GLB_MAGIC) {
+        *error = "not a GLB file";
+        return false;
+    }
+    if (read_u32(data + 4) != GLB_VERSION) {
+        *error = "unsupported glTF version";
+        return false;
+    }
+    size_t length = read_u32(data + 8);
+    if (length > size) {
+        *error = "truncated file";
+        return false;
+    }
+
+    bool have_json = false;
+    for (size_t pos = GLB_HEADER_BYTES; pos + GLB_CHUNK_HEADER_BYTES <= length;) {
+        size_t chunk_length = read_u32(data + pos);
+        uint32_t type = read_u32(data + pos + 4);
+        size_t start = pos + GLB_CHUNK_HEADER_BYTES;
+        if (chunk_length > length - start) {
+            *error = "truncated chunk";
+            return false;
+        }
+        if (type == GLB_CHUNK_JSON && !have_json) {
+            if (!JsonValue::parse(data + start, chunk_length, &glb->json, error)) return false;
+            if (!glb->json.is_object()) {
+                *error = "JSON chunk is not an object";
+                return false;
+            }
+            have_json = true;
+        } else if (type == GLB_CHUNK_BIN && !glb->bin) {
+            glb->bin = data + start;
+            glb->bin_size = chunk_length;
+            glb->bin_chunk_end = start + chunk_length;
+        }
+        pos = start + align4(chunk_length);
+    }
+    if (!have_json) {
+        *error = "no JSON chunk";
+        return false;
+    }
+    return true;
+}
+
+const JsonValue* array_item(const JsonValue& root, const char* name, int index) {
+    const JsonValue* array = root.find(name);
+    if (!array || !array->is_array() || index < 0 || (size_t)index >= array->size()) return NULL;
+    return &(*array)[(size_t)index];
+}
+
+int member_int(const JsonValue& object, const char* name, int fallback) {
+    const JsonValue* v = object.find(name);
+    return v ? v->as_int(fallback) : fallback;
+}
+
+/** Elements of one accessor inside the binary chunk */
+struct AccessorView {
+    const char* data;
+    int count;
+    int component_type;
+    int components;
+    size_t stride;
+    bool normalized;
+};
+
+int type_components(const std::string& type) {
+    if (type == "SCALAR") return 1;
+    if (type == "VEC2") return 2;
+    if (type == "VEC3") return 3;
+    if (type == "VEC4") return 4;
+    return 0;
+}
+
+size_t component_bytes(int component_type) {
+    switch (component_type) {
+        case 5120: case GL_UNSIGNED_BYTE: return 1;
+        case 5122: case GL_UNSIGNED_SHORT: return 2;
+        case GL_UNSIGNED_INT: case GL_FLOAT: return 4;
+        default: return 0;
+    }
+}
+
+bool accessor_view(const GlbFile& glb, int index, AccessorView* out, std::string* error) {
+    const JsonValue* accessor = array_item(glb.json, "accessors", index);
+    if (!accessor || !accessor->is_object()) {
+        *error = "bad accessor index";
+        return false;
+    }
+    if (accessor->find("sparse")) {
+        *error = "sparse accessors are not supported";
+        return false;
+    }
+    const JsonValue* type = accessor->find("type");
+    out->count = member_int(*accessor, "count", -1);
+    out->component_type = member_int(*accessor, "componentType", -1);
+    out->components = type && type->is_string() ? type_components(type->as_string()) : 0;
+    const JsonValue* normalized = accessor->find("normalized");
+    out->normalized = normalized && normalized->as_bool();
+    size_t element = component_bytes(out->component_type) * (size_t)out->components;
+    if (out->count < 0 || element == 0) {
+        *error = "bad accessor";
+        return false;
+    }
+
+    const JsonValue* view = array_item(glb.json, "bufferViews", member_int(*accessor, "bufferView", -1));
+    if (!view || !view->is_object()) {
+        *error = "accessor without a buffer view";
+        return false;
+    }
+    const JsonValue* buffer = array_item(glb.json, "buffers", member_int(*view, "buffer", -1));
+    if (member_int(*view, "buffer", -1) != 0 || !buffer || buffer->find("uri") || !glb.bin) {
+        *error = "buffers outside the GLB are not supported";
+        return false;
+    }
+    int view_offset = member_int(*view, "byteOffset", 0);
+    int view_length = member_int(*view, "byteLength", -1);
+    int stride = member_int(*view, "byteStride", 0);
+    int offset = member_int(*accessor, "byteOffset", 0);
+    out->stride = stride > 0 ? (size_t)stride : element;
+    if (view_offset < 0 || view_length < 0 || offset < 0 || stride < 0 ||
+        (size_t)view_offset + (size_t)view_length > glb.bin_size) {
+        *error = "buffer view out of range";
+        return false;
+    }
+    size_t needed = out->count > 0 ? (size_t)offset + (size_t)(out->count - 1) * out->stride + element : 0;
+    if (needed > (size_t)view_length) {
+        *error = "accessor out of range";
+        return false;
+    }
+    out->data = glb.bin + view_offset + offset;
+    return true;
+}
+
+/** How load_glb() lays out a file (see the file comment) */
+struct GlbLayout {
+    struct Primitive {
+        const JsonValue* json;
+        int slot;
+        int indices;  // accessor, -1 for none
+    };
+    std::vector<int> positions;  // POSITION accessor per slot
+    std::vector<int> counts;     // vertices per slot
+    std::vector<int> bases;      // first mesh vertex per slot
+    std::vector<Primitive> primitives;
+    int num_vertices;
+    int num_skipped;             // primitives of other modes
+};
+
+bool glb_layout(const GlbFile& glb, GlbLayout* layout, std::string* error) {
+    layout->num_vertices = 0;
+    layout->num_skipped = 0;
+    const JsonValue* meshes = glb.json.find("meshes");
+    for (size_t m = 0; meshes && meshes->is_array() && m < meshes->size(); m++) {
+        const JsonValue* primitives = (*meshes)[m].find("primitives");
+        for (size_t p = 0; primitives && primitives->is_array() && p < primitives->size(); p++) {
+            const JsonValue& primitive = (*primitives)[p];
+            const JsonValue* attributes = primitive.find("attributes");
+            const JsonValue* position = attributes ? attributes->find("POSITION") : NULL;
+            if (member_int(primitive, "mode", GLTF_MODE_TRIANGLES) != GLTF_MODE_TRIANGLES || !position) {
+                layout->num_skipped++;
+                continue;
+            }
+            int accessor = position->as_int(-1);
+            int slot = -1;
+            for (size_t s = 0; s < layout->positions.size(); s++) {
+                if (layout->positions[s] == accessor) slot = (int)s;
+            }
+            if (slot < 0) {
+                AccessorView view;
+                if (!accessor_view(glb, accessor, &view, error)) return false;
+                if (view.component_type != GL_FLOAT || view.components != 3) {
+                    *error = "POSITION is not float VEC3";
+                    return false;
+                }
+                if (view.count > 0x7FFFFFFF - layout->num_vertices) {
+                    *error = "too many vertices";
+                    return false;
+                }
+                slot = (int)layout->positions.size();
+                layout->positions.push_back(accessor);
+                layout->counts.push_back(view.count);
+                layout->bases.push_back(layout->num_vertices);
+                layout->num_vertices += view.count;
+            }
+            GlbLayout::Primitive record = {&primitive, slot, member_int(primitive, "indices", -1)};
+            layout->primitives.push_back(record);
+        }
+    }
+    if (layout->primitives.empty()) {
+        *error = "no triangle primitives";
+        return false;
+    }
+    return true;
+}
+
+/** TEXCOORD_0 accessor of the first primitive of each slot that has one */
+std::vector<int> slot_uv_accessors(const GlbLayout& layout) {
+    std::vector<int> uvs(layout.positions.size(), -1);
+    for (const GlbLayout::Primitive& primitive : layout.primitives) {
+        const JsonValue* attributes = primitive.json->find("attributes");
+        const JsonValue* uv = attributes ? attributes->find("TEXCOORD_0") : NULL;
+        if (uv && uvs[primitive.slot] < 0) uvs[primitive.slot] = uv->as_int(-1);
+    }
+    return uvs;
+}
+
+bool write_glb(const char* filename, const JsonValue& json, const char* bin_parts[], const size_t bin_sizes[],
+               int num_parts, const char* trailing, size_t trailing_size) {
+    std::string text;
+    json.write(&text);
+    text.append(align4(text.size()) - text.size(), ' ');
+    size_t bin_size = 0;
+    for (int i = 0; i < num_parts; i++) bin_size += bin_sizes[i];
+    size_t total = GLB_HEADER_BYTES + GLB_CHUNK_HEADER_BYTES + text.size() + GLB_CHUNK_HEADER_BYTES +
+                   align4(bin_size) + trailing_size;
+    if (total > 0xFFFFFFFFu) {
+        LOG_ERROR("save_glb: %s: file would exceed 4 GB", filename);
+        return false;
+    }
+
+    uvunwrap::MappedFile file;
+    if (!file.create(filename, total)) {
+        LOG_ERROR("Cannot open file for writing: %s", filename);
+        return false;
+    }
+    char* out = file.data();
+    uint32_t words[3] = {GLB_MAGIC, GLB_VERSION, (uint32_t)total};
+    memcpy(out, words, sizeof(words));
+    out += sizeof(words);
+    uint32_t json_header[2] = {(uint32_t)text.size(), GLB_CHUNK_JSON};
+    memcpy(out, json_header, sizeof(json_header));
+    memcpy(out + sizeof(json_header), text.data(), text.size());
+    out += sizeof(json_header) + text.size();
+    uint32_t bin_header[2] = {(uint32_t)align4(bin_size), GLB_CHUNK_BIN};
+    memcpy(out, bin_header, sizeof(bin_header));
+    out += sizeof(bin_header);
+    for (int i = 0; i < num_parts; i++) {
+        if (bin_sizes[i] > 0) memcpy(out, bin_parts[i], bin_sizes[i]);
+        out += bin_sizes[i];
+    }
+    memset(out, 0, align4(bin_size) - bin_size);
+    out += align4(bin_size) - bin_size;
+    if (trailing_size > 0) memcpy(out, trailing, trailing_size);
+    if (!file.flush()) {
+        LOG_ERROR("Failed to write GLB file: %s", filename);
+        return false;
+    }
+    return true;
+}
+
+JsonValue json_int(long long value) {
+    return JsonValue::number((double)value);
+}
+
+JsonValue buffer_view(int offset, size_t length, int target) {
+    JsonValue view = JsonValue::object();
+    view.member("buffer") = json_int(0);
+    view.member("byteOffset") = json_int(offset);
+    view.member("byteLength") = json_int((long long)length);
+    view.member("target") = json_int(target);
+    return view;
+}
+
+JsonValue accessor(int view, size_t offset, int component_type, int count, const char* type) {
+    JsonValue a = JsonValue::object();
+    a.member("bufferView") = json_int(view);
+    if (offset > 0) a.member("byteOffset") = json_int((long long)offset);
+    a.member("componentType") = json_int(component_type);
+    a.member("count") = json_int(count);
+    a.member("type") = JsonValue::string(type);
+    return a;
+}
+
+/** UVs with v flipped to glTF's top-left origin */
+std::vector<float> gltf_uvs(const float* uvs, int num_vertices) {
+    std::vector<float> out((size_t)num_vertices * 2);
+    for (int v = 0; v < num_vertices; v++) {
+        out[v * 2 + 0] = uvs[v * 2 + 0];
+        out[v * 2 + 1] = 1.0f - uvs[v * 2 + 1];
+    }
+    return out;
+}
+
+} // namespace
+
+Mesh* load_glb(const char* filename) {
+    UV_TRACE_ZONE("load_glb");
+    GlbFile glb;
+    GlbLayout layout;
+    std::string error;
+    if (!open_glb(filename, &glb, &error) || !glb_layout(glb, &layout, &error)) {
+        LOG_ERROR("load_glb: %s: %s", filename, error.c_str());
+        return NULL;
+    }
+    if (layout.num_skipped > 0) LOG_WARNING("load_glb: %s: skipped %d non-triangle primitives", filename,
+                                            layout.num_skipped);
+
+    // Triangles first: every accessor is checked before anything is allocated
+    std::vector<int> triangles;
+    for (const GlbLayout::Primitive& primitive : layout.primitives) {
+        int base = layout.bases[primitive.slot];
+        int count = layout.counts[primitive.slot];
+        size_t first = triangles.size();
+        if (primitive.indices < 0) {
+            for (int i = 0; i + 2 < count; i += 3) {
+                for (int k = 0; k < 3; k++) triangles.push_back(base + i + k);
+            }
+            continue;
+        }
+        AccessorView view;
+        if (!accessor_view(glb, primitive.indices, &view, &error)) {
+            LOG_ERROR("load_glb: %s: %s", filename, error.c_str());
+            return NULL;
+        }
+        int num_indices = view.count - view.count % 3;
+        triangles.resize(first + (size_t)num_indices);
+        int* out = &triangles[first];
+        if (view.component_type == GL_UNSIGNED_INT && view.stride == 4) {
+            if (num_indices > 0) memcpy(out, view.data, (size_t)num_indices * 4);
+        } else if (view.component_type == GL_UNSIGNED_INT || view.component_type == GL_UNSIGNED_SHORT ||
+                   view.component_type == GL_UNSIGNED_BYTE) {
+            for (int i = 0; i < num_indices; i++) {
+                const char* at = view.data + (size_t)i * view.stride;
+                if (view.component_type == GL_UNSIGNED_INT) {
+                    out[i] = (int)read_u32(at);
+                } else if (view.component_type == GL_UNSIGNED_SHORT) {
+                    uint16_t v;
+                    memcpy(&v, at, 2);
+                    out[i] = v;
+                } else {
+                    out[i] = (unsigned char)*at;
+                }
+            }
+        } else {
+            LOG_ERROR("load_glb: %s: indices are not unsigned integers", filename);
+            return NULL;
+        }
+        for (int i = 0; i < num_indices; i++) {
+            if (out[i] < 0 || out[i] >= count) {
+                LOG_ERROR("load_glb: %s: vertex index %d out of range (%d vertices)", filename, out[i], count);
+                return NULL;
+            }
+            out[i] += base;
+        }
+    }
+    if (triangles.empty() || layout.num_vertices == 0) {
+        LOG_ERROR("Failed to parse GLB file: %s", filename);
+        return NULL;
+    }
+
+    // UVs only if every slot has float or normalised unsigned ones
+    std::vector<int> uv_accessors = slot_uv_accessors(layout);
+    std::vector<AccessorView> uv_views(uv_accessors.size());
+    bool with_uvs = true;
+    for (size_t s = 0; s < uv_accessors.size() && with_uvs; s++) {
+        with_uvs = uv_accessors[s] >= 0 && accessor_view(glb, uv_accessors[s], &uv_views[s], &error) &&
+                   uv_views[s].components == 2 && uv_views[s].count == layout.counts[s] &&
+                   (uv_views[s].component_type == GL_FLOAT ||
+                    (uv_views[s].normalized && (uv_views[s].component_type == GL_UNSIGNED_SHORT ||
+                                                uv_views[s].component_type == GL_UNSIGNED_BYTE)));
+    }
+
+    Mesh* mesh = (Mesh*)malloc(sizeof(Mesh));
+    mesh->num_vertices = layout.num_vertices;
+    mesh->vertices = (float*)malloc((size_t)layout.num_vertices * 3 * sizeof(float));
+    mesh->num_triangles = (int)(triangles.size() / 3);
+    mesh->triangles = (int*)malloc(triangles.size() * sizeof(int));
+    memcpy(mesh->triangles, triangles.data(), triangles.size() * sizeof(int));
+    mesh->uvs = with_uvs ? (float*)malloc((size_t)layout.num_vertices * 2 * sizeof(float)) : NULL;
+
+    for (size_t s = 0; s < layout.positions.size(); s++) {
+        AccessorView view;
+        accessor_view(glb, layout.positions[s], &view, &error);
+        float* out = mesh->vertices + (size_t)layout.bases[s] * 3;
+        if (view.stride == 3 * sizeof(float)) {
+            memcpy(out, view.data, (size_t)view.count * 3 * sizeof(float));
+        } else {
+            for (int v = 0; v < view.count; v++) memcpy(out + v * 3, view.data + v * view.stride, 3 * sizeof(float));
+        }
+        if (with_uvs) {
+            const AccessorView& uv = uv_views[s];
+            float* uv_out = mesh->uvs + (size_t)layout.bases[s] * 2;
+            for (int v = 0; v < uv.count; v++) {
+                const char* at = uv.data + v * uv.stride;
+                float t[2];
+                if (uv.component_type == GL_FLOAT) {
+                    memcpy(t, at, sizeof(t));
+                } else if (uv.component_type == GL_UNSIGNED_SHORT) {
+                    uint16_t q[2];
+                    memcpy(q, at, sizeof(q));
+                    t[0] = (float)q[0] / 65535.0f;
+                    t[1] = (float)q[1] / 65535.0f;
+                } else {
+                    t[0] = (float)(unsigned char)at[0] / 255.0f;
+                    t[1] = (float)(unsigned char)at[1] / 255.0f;
+                }
+                uv_out[v * 2 + 0] = t[0];
+                uv_out[v * 2 + 1] = 1.0f - t[1];
+            }
+        }
+    }
+
+    LOG_INFO("Loaded %s: %d vertices, %d triangles", filename, mesh->num_vertices, mesh->num_triangles);
+    return mesh;
+}
+
+namespace {
+
+/** save_glb() body; quantized replaces float UVs by normalised unsigned shorts */
+int write_mesh_glb(const Mesh* mesh, const char* filename, const QuantizedUvs* quantized) {
+    if (!mesh || !filename || mesh->num_vertices <= 0 || !host_is_little_endian()) return -1;
+
+    size_t position_bytes = (size_t)mesh->num_vertices * 3 * sizeof(float);
+    size_t uv_bytes = !mesh->uvs ? 0
+                    : quantized ? (size_t)mesh->num_vertices * 2 * sizeof(uint16_t)
+                    : (size_t)mesh->num_vertices * 2 * sizeof(float);
+    size_t index_bytes = (size_t)mesh->num_triangles * 3 * sizeof(int);
+    std::vector<float> uvs;
+    std::vector<uint16_t> uvs_q16;
+    if (quantized) {
+        // The flip is exact on the grid: 1 - q/65535 = (65535 - q)/65535
+        uvs_q16.resize((size_t)mesh->num_vertices * 2);
+        for (int v = 0; v < mesh->num_vertices; v++) {
+            uvs_q16[v * 2 + 0] = quantized->uvs[v * 2 + 0];
+            uvs_q16[v * 2 + 1] = (uint16_t)(65535 - quantized->uvs[v * 2 + 1]);
+        }
+    } else if (mesh->uvs) {
+        uvs = gltf_uvs(mesh->uvs, mesh->num_vertices);
+    }
+
+    JsonValue min = JsonValue::array(), max = JsonValue::array();
+    for (int k = 0; k < 3; k++) {
+        float lo = FLT_MAX, hi = -FLT_MAX;
+        for (int v = 0; v < mesh->num_vertices; v++) {
+            float x = mesh->vertices[(size_t)v * 3 + k];
+            lo = x < lo ? x : lo;
+            hi = x > hi ? x : hi;
+        }
+        min.push_back(JsonValue::number(lo));
+        max.push_back(JsonValue::number(hi));
+    }
+
+    JsonValue json = JsonValue::object();
+    JsonValue& asset = json.member("asset");
+    asset = JsonValue::object();
+    asset.member("version") = JsonValue::string("2.0");
+    asset.member("generator") = JsonValue::string("uvunwrap");
+
+    JsonValue views = JsonValue::array();
+    JsonValue accessors = JsonValue::array();
+    JsonValue attributes = JsonValue::object();
+    views.push_back(buffer_view(0, position_bytes, GL_ARRAY_BUFFER));
+    accessors.push_back(accessor(0, 0, GL_FLOAT, mesh->num_vertices, "VEC3"));
+    accessors[0].member("min") = min;
+    accessors[0].member("max") = max;
+    attributes.member("POSITION") = json_int(0);
+    if (mesh->uvs) {
+        views.push_back(buffer_view((int)position_bytes, uv_bytes, GL_ARRAY_BUFFER));
+        accessors.push_back(accessor(1, 0, quantized ? GL_UNSIGNED_SHORT : GL_FLOAT, mesh->num_vertices, "VEC2"));
+        if (quantized) accessors[1].member("normalized") = JsonValue::boolean(true);
+        attributes.member("TEXCOORD_0") = json_int(1);
+    }
+    int index_view = (int)views.size();
+    views.push_back(buffer_view((int)(position_bytes + uv_bytes), index_bytes, GL_ELEMENT_ARRAY_BUFFER));
+    accessors.push_back(accessor(index_view, 0, GL_UNSIGNED_INT, mesh->num_triangles * 3, "SCALAR"));
+
+    JsonValue buffer = JsonValue::object();
+    buffer.member("byteLength") = json_int((long long)(position_bytes + uv_bytes + index_bytes));
+    json.member("buffers") = JsonValue::array();
+    json.member("buffers").push_back(buffer);
+    json.member("bufferViews") = views;
+    json.member("accessors") = accessors;
+
+    JsonValue primitive = JsonValue::object();
+    primitive.member("attributes") = attributes;
+    primitive.member("indices") = json_int((long long)accessors.size() - 1);
+    primitive.member("mode") = json_int(GLTF_MODE_TRIANGLES);
+    JsonValue gltf_mesh = JsonValue::object();
+    gltf_mesh.member("primitives") = JsonValue::array();
+    gltf_mesh.member("primitives").push_back(primitive);
+    json.member("meshes") = JsonValue::array();
+    json.member("meshes").push_back(gltf_mesh);
+    JsonValue node = JsonValue::object();
+    node.member("mesh") = json_int(0);
+    json.member("nodes") = JsonValue::array();
+    json.member("nodes").push_back(node);
+    JsonValue scene = JsonValue::object();
+    scene.member("nodes") = JsonValue::array();
+    scene.member("nodes").push_back(json_int(0));
+    json.member("scenes") = JsonValue::array();
+    json.member("scenes").push_back(scene);
+    json.member("scene") = json_int(0);
+
+    const char* uv_data = quantized ? (const char*)uvs_q16.data() : (const char*)uvs.data();
+    const char* parts[3] = {(const char*)mesh->vertices, uv_data, (const char*)mesh->triangles};
+    size_t sizes[3] = {position_bytes, uv_bytes, index_bytes};
+    return write_glb(filename, json, parts, sizes, 3, NULL, 0) ? 0 : -1;
+}
+
+} // namespace
+
+int save_glb(const Mesh* mesh, const char* filename) {
+    UV_TRACE_ZONE("save_glb");
+    return write_mesh_glb(mesh, filename, NULL);
+}
+
+int save_glb_quantized(const Mesh* mesh, const char* filename, const UvQuantizeOptions* options) {
+    UV_TRACE_ZONE("save_glb");
+    if (!mesh || !mesh->uvs) return write_mesh_glb(mesh, filename, NULL);
+
+    UvQuantizeOptions global;
+    uv_quantize_options_default(&global);
+    if (options) global = *options;
+    if (global.grid != UV_QUANTIZE_GLOBAL) {
+        LOG_WARNING("save_glb_quantized: glTF has no per-island UV boxes, using the global grid");
+        global.grid = UV_QUANTIZE_GLOBAL;
+    }
+    QuantizedUvs* quantized = quantize_uvs(mesh, NULL, 0, &global);
+    bool unit = quantized && quantized->boxes[0] == 0.0f && quantized->boxes[1] == 0.0f &&
+                quantized->boxes[2] == 1.0f && quantized->boxes[3] == 1.0f;
+    int rc = -1;
+    if (!quantized) {
+        LOG_ERROR("save_glb_quantized: %s: UVs cannot be quantised without adding overlap", filename);
+    } else if (!unit) {
+        LOG_ERROR("save_glb_quantized: %s: normalised UVs must lie in [0,1]", filename);
+    } else {
+        rc = write_mesh_glb(mesh, filename, quantized);
+    }
+    free_quantized_uvs(quantized);
+    return rc;
+}
+
+int save_glb_uvs(const char* source, const Mesh* mesh, const char* filename) {
+    UV_TRACE_ZONE("save_glb_uvs");
+    if (!source || !mesh || !mesh->uvs || !filename || strcmp(source, filename) == 0) return -1;
+
+    GlbFile glb;
+    GlbLayout layout;
+    std::string error;
+    if (!open_glb(source, &glb, &error) || !glb_layout(glb, &layout, &error)) {
+        LOG_ERROR("save_glb_uvs: %s: %s", source, error.c_str());
+        return -1;
+    }
+    if (layout.num_vertices != mesh->num_vertices) {
+        LOG_ERROR("save_glb_uvs: %s has %d vertices, the mesh %d", source, layout.num_vertices,
+                  mesh->num_vertices);
+        return -1;
+    }
+
+    // One new view after the old binary chunk, one accessor per vertex range
+    JsonValue& json = glb.json;
+    size_t uv_offset = align4(glb.bin_size);
+    size_t uv_bytes = (size_t)mesh->num_vertices * 2 * sizeof(float);
+    if (!json.find("bufferViews")) json.member("bufferViews") = JsonValue::array();
+    if (!json.find("accessors")) json.member("accessors") = JsonValue::array();
+    if (!json.find("buffers")) {
+        json.member("buffers") = JsonValue::array();
+        json.member("buffers").push_back(JsonValue::object());
+    }
+    JsonValue& views = json.member("bufferViews");
+    JsonValue& accessors = json.member("accessors");
+    JsonValue& buffers = json.member("buffers");
+    if (!views.is_array() || !accessors.is_array() || !buffers.is_array() || buffers.size() == 0 ||
+        buffers[0].find("uri")) {
+        LOG_ERROR("save_glb_uvs: %s: unexpected buffer layout", source);
+        return -1;
+    }
+    int view = (int)views.size();
+    views.push_back(buffer_view((int)uv_offset, uv_bytes, GL_ARRAY_BUFFER));
+    std::vector<int> slot_accessor(layout.positions.size());
+    for (size_t s = 0; s < layout.positions.size(); s++) {
+        slot_accessor[s] = (int)accessors.size();
+        accessors.push_back(accessor(view, (size_t)layout.bases[s] * 2 * sizeof(float), GL_FLOAT, layout.counts[s],
+                                     "VEC2"));
+    }
+    buffers[0].member("byteLength") = json_int((long long)(uv_offset + uv_bytes));
+
+    // Every primitive on a converted POSITION accessor gets the UVs, whatever its mode
+    JsonValue* meshes = json.find("meshes");
+    for (size_t m = 0; meshes && meshes->is_array() && m < meshes->size(); m++) {
+        JsonValue* primitives = (*meshes)[m].find("primitives");
+        for (size_t p = 0; primitives && primitives->is_array() && p < primitives->size(); p++) {
+            JsonValue* attributes = (*primitives)[p].find("attributes");
+            const JsonValue* position = attributes ? attributes->find("POSITION") : NULL;
+            if (!position) continue;
+            int accessor_index = position->as_int(-1);
+            for (size_t s = 0; s < layout.positions.size(); s++) {
+                if (layout.positions[s] == accessor_index) {
+                    attributes->member("TEXCOORD_0") = json_int(slot_accessor[s]);
+                }
+            }
+        }
+    }
+
+    std::vector<float> uvs = gltf_uvs(mesh->uvs, mesh->num_vertices);
+    std::vector<char> padding(uv_offset - glb.bin_size, 0);
+    const char* parts[3] = {glb.bin, padding.data(), (const char*)uvs.data()};
+    size_t sizes[3] = {glb.bin_size, padding.size(), uv_bytes};
+    size_t tail = glb.bin_chunk_end ? align4(glb.bin_chunk_end) : 0;
+    size_t length = read_u32(glb.file.data() + 8);
+    const char* trailing = tail && tail < length ? glb.file.data() + tail : NULL;
+    size_t trailing_size = trailing ? length - tail : 0;
+    return write_glb(filename, json, parts, sizes, 3, trailing, trailing_size) ? 0 : -1;
+}
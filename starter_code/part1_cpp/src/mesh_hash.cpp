@@ -0,0 +1,165 @@
+/**
+ * @file mesh_hash.cpp
+ * @brief XXH3-style content hashes of meshes
+ *
+ * Each 1 MiB chunk is hashed with eight 64-bit accumulators fed 64-byte
+ * stripes (acc += swapped input; acc += lo32(d ^ key) * hi32(d ^ key)),
+ * scrambled every 16 stripes and folded with 64x64->128 multiplies. The
+ * lane loop has no cross-lane dependencies, so compilers vectorise it.
+ * Chunk digests are then hashed in order, which keeps the result
+ * independent of how many threads ran.
+ */
+
+#include "mesh_hash.h"
+#include "parallel.h"
+#include <string.h>
+#include <vector>
+
+namespace {
+
+const size_t STRIPE_BYTES = 64;
+const size_t STRIPES_PER_BLOCK = 16;
+const size_t BLOCK_BYTES = STRIPE_BYTES * STRIPES_PER_BLOCK;
+const size_t CHUNK_BYTES = (size_t)1 << 20;
+const int NUM_KEYS = 8 + (int)STRIPES_PER_BLOCK;
+
+const uint64_t PRIME32_1 = 0x9E3779B1ULL;
+const uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+const uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+const uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+const uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+
+inline uint64_t read64(const unsigned char* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint64_t mul128_fold64(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 uint128;
+    uint128 product = (uint128)a * b;
+    return (uint64_t)product ^ (uint64_t)(product >> 64);
+#else
+    uint64_t lo_lo = (a & 0xFFFFFFFFULL) * (b & 0xFFFFFFFFULL);
+    uint64_t hi_lo = (a >> 32) * (b & 0xFFFFFFFFULL);
+    uint64_t lo_hi = (a & 0xFFFFFFFFULL) * (b >> 32);
+    uint64_t hi_hi = (a >> 32) * (b >> 32);
+    uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFULL) + lo_hi;
+    uint64_t upper = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+    uint64_t lower = (cross << 32) | (lo_lo & 0xFFFFFFFFULL);
+    return lower ^ upper;
+#endif
+}
+
+inline uint64_t avalanche(uint64_t h) {
+    h ^= h >> 37;
+    h *= 0x165667919E3779F9ULL;
+    h ^= h >> 32;
+    return h;
+}
+
+inline uint64_t splitmix64(uint64_t* state) {
+    uint64_t z = (*state += PRIME64_1);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/** Stripe s of a block uses keys[s .. s + 7]; the scramble uses keys[16 .. 23] */
+struct HashKeys {
+    uint64_t k[NUM_KEYS];
+
+    explicit HashKeys(uint64_t seed) {
+        uint64_t state = seed ^ PRIME64_3;
+        for (int i = 0; i < NUM_KEYS; i++) k[i] = splitmix64(&state);
+    }
+};
+
+inline void accumulate_stripe(uint64_t* acc, const unsigned char* p, const uint64_t* keys) {
+    for (int i = 0; i < 8; i++) {
+        uint64_t data = read64(p + i * 8);
+        uint64_t mixed = data ^ keys[i];
+        acc[i ^ 1] += data;
+        acc[i] += (mixed & 0xFFFFFFFFULL) * (mixed >> 32);
+    }
+}
+
+inline void scramble(uint64_t* acc, const uint64_t* keys) {
+    for (int i = 0; i < 8; i++) {
+        uint64_t a = acc[i];
+        a ^= a >> 47;
+        a ^= keys[i];
+        acc[i] = a * PRIME32_1;
+    }
+}
+
+uint64_t hash_chunk(const unsigned char* data, size_t size, const HashKeys& keys) {
+    uint64_t acc[8] = {PRIME32_1, PRIME64_1, PRIME64_2, PRIME64_3,
+                       PRIME64_4, PRIME64_2 ^ PRIME32_1, PRIME64_1 ^ PRIME64_4, PRIME64_3 ^ PRIME64_2};
+    const uint64_t* scramble_keys = keys.k + STRIPES_PER_BLOCK;
+
+    size_t offset = 0;
+    for (; offset + BLOCK_BYTES <= size; offset += BLOCK_BYTES) {
+        for (size_t s = 0; s < STRIPES_PER_BLOCK; s++) {
+            accumulate_stripe(acc, data + offset + s * STRIPE_BYTES, keys.k + s);
+        }
+        scramble(acc, scramble_keys);
+    }
+
+    // Remaining full stripes, then the tail zero-padded to a stripe
+    size_t s = 0;
+    for (; offset + STRIPE_BYTES <= size; offset += STRIPE_BYTES, s++) {
+        accumulate_stripe(acc, data + offset, keys.k + s);
+    }
+    if (offset < size) {
+        unsigned char tail[STRIPE_BYTES];
+        memset(tail, 0, sizeof(tail));
+        memcpy(tail, data + offset, size - offset);
+        accumulate_stripe(acc, tail, keys.k + s);
+    }
+
+    uint64_t h = (uint64_t)size * PRIME64_1;
+    for (int i = 0; i < 4; i++) {
+        h += mul128_fold64(acc[2 * i] ^ keys.k[2 * i], acc[2 * i + 1] ^ keys.k[2 * i + 1]);
+    }
+    return avalanche(h);
+}
+
+inline uint64_t combine(uint64_t a, uint64_t b) {
+    return avalanche(mul128_fold64(a ^ PRIME64_1, b ^ PRIME64_2));
+}
+
+} // namespace
+
+uint64_t uv_hash_bytes(const void* data, size_t size, uint64_t seed, int num_threads) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    HashKeys keys(seed);
+    if (size <= CHUNK_BYTES) return hash_chunk(bytes, size, keys);
+
+    int num_chunks = (int)((size + CHUNK_BYTES - 1) / CHUNK_BYTES);
+    std::vector<uint64_t> digests(num_chunks);
+    int threads = uvunwrap::choose_thread_count(num_chunks, num_threads, 4);
+    uvunwrap::parallel_for_dynamic(num_chunks, threads, [&](int, int c) {
+        size_t begin = (size_t)c * CHUNK_BYTES;
+        size_t length = size - begin < CHUNK_BYTES ? size - begin : CHUNK_BYTES;
+        digests[c] = hash_chunk(bytes + begin, length, keys);
+    });
+
+    uint64_t h = hash_chunk((const unsigned char*)digests.data(), digests.size() * sizeof(uint64_t), keys);
+    return combine(h, (uint64_t)size);
+}
+
+uint64_t uv_mesh_topology_hash(const Mesh* mesh, int num_threads) {
+    if (!mesh) return 0;
+    size_t size = mesh->triangles ? (size_t)mesh->num_triangles * 3 * sizeof(int) : 0;
+    uint64_t h = uv_hash_bytes(mesh->triangles, size, (uint64_t)mesh->num_vertices, num_threads);
+    return combine(h, (uint64_t)mesh->num_triangles);
+}
+
+uint64_t uv_mesh_hash(const Mesh* mesh, int num_threads) {
+    if (!mesh) return 0;
+    size_t size = mesh->vertices ? (size_t)mesh->num_vertices * 3 * sizeof(float) : 0;
+    uint64_t geometry = uv_hash_bytes(mesh->vertices, size, PRIME64_4, num_threads);
+    return combine(uv_mesh_topology_hash(mesh, num_threads), geometry);
+}
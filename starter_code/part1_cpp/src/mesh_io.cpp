@@ -7,151 +7,584 @@
  */
 
 #include "mesh.h"
+#include "mesh_formats.h"
+#include "parallel.h"
+#include "mapped_file.h"
+#include "logging.h"
+#include "trace.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <string>
 #include <vector>
 
-Mesh* load_obj(const char* filename) {
-    FILE* f = fopen(filename, "r");
-    if (!f) {
-        fprintf(stderr, "Cannot open file: %s\n", filename);
-        return NULL;
-    }
+// ---------------------------------------------------------------------------
+// OBJ parsing: one pass per newline-aligned chunk, chunks on threads
+// ---------------------------------------------------------------------------
 
-    std::vector<float> vertices;
-    std::vector<int> triangles;
-    std::vector<float> uvs_temp;
-    bool has_uvs = false;
-
-    char line[256];
-    while (fgets(line, sizeof(line), f)) {
-        if (line[0] == 'v' && line[1] == ' ') {
-            // Vertex
-            float x, y, z;
-            if (sscanf(line, "v %f %f %f", &x, &y, &z) == 3) {
-                vertices.push_back(x);
-                vertices.push_back(y);
-                vertices.push_back(z);
+namespace {
+
+/** Chunks smaller than this are not worth a thread */
+const size_t OBJ_MIN_CHUNK_BYTES = 1 << 20;
+
+/** Longest number handed to strtof on the slow path */
+const int OBJ_MAX_NUMBER_CHARS = 63;
+
+inline bool obj_is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+inline bool obj_is_alnum(char c) {
+    return (c >= '0' && c <= '9') || ((c | 0x20) >= 'a' && (c | 0x20) <= 'z');
+}
+
+inline const char* obj_skip_space(const char* p, const char* end) {
+    while (p < end && obj_is_space(*p)) p++;
+    return p;
+}
+
+/** Powers of ten a float mantissa of up to 19 digits can meet */
+const int OBJ_MIN_POW10 = -65;
+const int OBJ_MAX_POW10 = 38;
+
+/** 5^q for q in [OBJ_MIN_POW10, OBJ_MAX_POW10], normalised to 128 bits, high word first */
+const uint64_t OBJ_POW5_128[OBJ_MAX_POW10 - OBJ_MIN_POW10 + 1][2] = {
+    {0x86ccbb52ea94baeaull, 0x98e947129fc2b4e9ull},  // 5^-65
+    {0xa87fea27a539e9a5ull, 0x3f2398d747b36224ull},  // 5^-64
+    {0xd29fe4b18e88640eull, 0x8eec7f0d19a03aadull},  // 5^-63
+    {0x83a3eeeef9153e89ull, 0x1953cf68300424acull},  // 5^-62
+    {0xa48ceaaab75a8e2bull, 0x5fa8c3423c052dd7ull},  // 5^-61
+    {0xcdb02555653131b6ull, 0x3792f412cb06794dull},  // 5^-60
+    {0x808e17555f3ebf11ull, 0xe2bbd88bbee40bd0ull},  // 5^-59
+    {0xa0b19d2ab70e6ed6ull, 0x5b6aceaeae9d0ec4ull},  // 5^-58
+    {0xc8de047564d20a8bull, 0xf245825a5a445275ull},  // 5^-57
+    {0xfb158592be068d2eull, 0xeed6e2f0f0d56712ull},  // 5^-56
+    {0x9ced737bb6c4183dull, 0x55464dd69685606bull},  // 5^-55
+    {0xc428d05aa4751e4cull, 0xaa97e14c3c26b886ull},  // 5^-54
+    {0xf53304714d9265dfull, 0xd53dd99f4b3066a8ull},  // 5^-53
+    {0x993fe2c6d07b7fabull, 0xe546a8038efe4029ull},  // 5^-52
+    {0xbf8fdb78849a5f96ull, 0xde98520472bdd033ull},  // 5^-51
+    {0xef73d256a5c0f77cull, 0x963e66858f6d4440ull},  // 5^-50
+    {0x95a8637627989aadull, 0xdde7001379a44aa8ull},  // 5^-49
+    {0xbb127c53b17ec159ull, 0x5560c018580d5d52ull},  // 5^-48
+    {0xe9d71b689dde71afull, 0xaab8f01e6e10b4a6ull},  // 5^-47
+    {0x9226712162ab070dull, 0xcab3961304ca70e8ull},  // 5^-46
+    {0xb6b00d69bb55c8d1ull, 0x3d607b97c5fd0d22ull},  // 5^-45
+    {0xe45c10c42a2b3b05ull, 0x8cb89a7db77c506aull},  // 5^-44
+    {0x8eb98a7a9a5b04e3ull, 0x77f3608e92adb242ull},  // 5^-43
+    {0xb267ed1940f1c61cull, 0x55f038b237591ed3ull},  // 5^-42
+    {0xdf01e85f912e37a3ull, 0x6b6c46dec52f6688ull},  // 5^-41
+    {0x8b61313bbabce2c6ull, 0x2323ac4b3b3da015ull},  // 5^-40
+    {0xae397d8aa96c1b77ull, 0xabec975e0a0d081aull},  // 5^-39
+    {0xd9c7dced53c72255ull, 0x96e7bd358c904a21ull},  // 5^-38
+    {0x881cea14545c7575ull, 0x7e50d64177da2e54ull},  // 5^-37
+    {0xaa242499697392d2ull, 0xdde50bd1d5d0b9e9ull},  // 5^-36
+    {0xd4ad2dbfc3d07787ull, 0x955e4ec64b44e864ull},  // 5^-35
+    {0x84ec3c97da624ab4ull, 0xbd5af13bef0b113eull},  // 5^-34
+    {0xa6274bbdd0fadd61ull, 0xecb1ad8aeacdd58eull},  // 5^-33
+    {0xcfb11ead453994baull, 0x67de18eda5814af2ull},  // 5^-32
+    {0x81ceb32c4b43fcf4ull, 0x80eacf948770ced7ull},  // 5^-31
+    {0xa2425ff75e14fc31ull, 0xa1258379a94d028dull},  // 5^-30
+    {0xcad2f7f5359a3b3eull, 0x096ee45813a04330ull},  // 5^-29
+    {0xfd87b5f28300ca0dull, 0x8bca9d6e188853fcull},  // 5^-28
+    {0x9e74d1b791e07e48ull, 0x775ea264cf55347eull},  // 5^-27
+    {0xc612062576589ddaull, 0x95364afe032a819eull},  // 5^-26
+    {0xf79687aed3eec551ull, 0x3a83ddbd83f52205ull},  // 5^-25
+    {0x9abe14cd44753b52ull, 0xc4926a9672793543ull},  // 5^-24
+    {0xc16d9a0095928a27ull, 0x75b7053c0f178294ull},  // 5^-23
+    {0xf1c90080baf72cb1ull, 0x5324c68b12dd6339ull},  // 5^-22
+    {0x971da05074da7beeull, 0xd3f6fc16ebca5e04ull},  // 5^-21
+    {0xbce5086492111aeaull, 0x88f4bb1ca6bcf585ull},  // 5^-20
+    {0xec1e4a7db69561a5ull, 0x2b31e9e3d06c32e6ull},  // 5^-19
+    {0x9392ee8e921d5d07ull, 0x3aff322e62439fd0ull},  // 5^-18
+    {0xb877aa3236a4b449ull, 0x09befeb9fad487c3ull},  // 5^-17
+    {0xe69594bec44de15bull, 0x4c2ebe687989a9b4ull},  // 5^-16
+    {0x901d7cf73ab0acd9ull, 0x0f9d37014bf60a11ull},  // 5^-15
+    {0xb424dc35095cd80full, 0x538484c19ef38c95ull},  // 5^-14
+    {0xe12e13424bb40e13ull, 0x2865a5f206b06fbaull},  // 5^-13
+    {0x8cbccc096f5088cbull, 0xf93f87b7442e45d4ull},  // 5^-12
+    {0xafebff0bcb24aafeull, 0xf78f69a51539d749ull},  // 5^-11
+    {0xdbe6fecebdedd5beull, 0xb573440e5a884d1cull},  // 5^-10
+    {0x89705f4136b4a597ull, 0x31680a88f8953031ull},  // 5^-9
+    {0xabcc77118461cefcull, 0xfdc20d2b36ba7c3eull},  // 5^-8
+    {0xd6bf94d5e57a42bcull, 0x3d32907604691b4dull},  // 5^-7
+    {0x8637bd05af6c69b5ull, 0xa63f9a49c2c1b110ull},  // 5^-6
+    {0xa7c5ac471b478423ull, 0x0fcf80dc33721d54ull},  // 5^-5
+    {0xd1b71758e219652bull, 0xd3c36113404ea4a9ull},  // 5^-4
+    {0x83126e978d4fdf3bull, 0x645a1cac083126eaull},  // 5^-3
+    {0xa3d70a3d70a3d70aull, 0x3d70a3d70a3d70a4ull},  // 5^-2
+    {0xccccccccccccccccull, 0xcccccccccccccccdull},  // 5^-1
+    {0x8000000000000000ull, 0x0000000000000000ull},  // 5^0
+    {0xa000000000000000ull, 0x0000000000000000ull},  // 5^1
+    {0xc800000000000000ull, 0x0000000000000000ull},  // 5^2
+    {0xfa00000000000000ull, 0x0000000000000000ull},  // 5^3
+    {0x9c40000000000000ull, 0x0000000000000000ull},  // 5^4
+    {0xc350000000000000ull, 0x0000000000000000ull},  // 5^5
+    {0xf424000000000000ull, 0x0000000000000000ull},  // 5^6
+    {0x9896800000000000ull, 0x0000000000000000ull},  // 5^7
+    {0xbebc200000000000ull, 0x0000000000000000ull},  // 5^8
+    {0xee6b280000000000ull, 0x0000000000000000ull},  // 5^9
+    {0x9502f90000000000ull, 0x0000000000000000ull},  // 5^10
+    {0xba43b74000000000ull, 0x0000000000000000ull},  // 5^11
+    {0xe8d4a51000000000ull, 0x0000000000000000ull},  // 5^12
+    {0x9184e72a00000000ull, 0x0000000000000000ull},  // 5^13
+    {0xb5e620f480000000ull, 0x0000000000000000ull},  // 5^14
+    {0xe35fa931a0000000ull, 0x0000000000000000ull},  // 5^15
+    {0x8e1bc9bf04000000ull, 0x0000000000000000ull},  // 5^16
+    {0xb1a2bc2ec5000000ull, 0x0000000000000000ull},  // 5^17
+    {0xde0b6b3a76400000ull, 0x0000000000000000ull},  // 5^18
+    {0x8ac7230489e80000ull, 0x0000000000000000ull},  // 5^19
+    {0xad78ebc5ac620000ull, 0x0000000000000000ull},  // 5^20
+    {0xd8d726b7177a8000ull, 0x0000000000000000ull},  // 5^21
+    {0x878678326eac9000ull, 0x0000000000000000ull},  // 5^22
+    {0xa968163f0a57b400ull, 0x0000000000000000ull},  // 5^23
+    {0xd3c21bcecceda100ull, 0x0000000000000000ull},  // 5^24
+    {0x84595161401484a0ull, 0x0000000000000000ull},  // 5^25
+    {0xa56fa5b99019a5c8ull, 0x0000000000000000ull},  // 5^26
+    {0xcecb8f27f4200f3aull, 0x0000000000000000ull},  // 5^27
+    {0x813f3978f8940984ull, 0x4000000000000000ull},  // 5^28
+    {0xa18f07d736b90be5ull, 0x5000000000000000ull},  // 5^29
+    {0xc9f2c9cd04674edeull, 0xa400000000000000ull},  // 5^30
+    {0xfc6f7c4045812296ull, 0x4d00000000000000ull},  // 5^31
+    {0x9dc5ada82b70b59dull, 0xf020000000000000ull},  // 5^32
+    {0xc5371912364ce305ull, 0x6c28000000000000ull},  // 5^33
+    {0xf684df56c3e01bc6ull, 0xc732000000000000ull},  // 5^34
+    {0x9a130b963a6c115cull, 0x3c7f400000000000ull},  // 5^35
+    {0xc097ce7bc90715b3ull, 0x4b9f100000000000ull},  // 5^36
+    {0xf0bdc21abb48db20ull, 0x1e86d40000000000ull},  // 5^37
+    {0x96769950b50d88f4ull, 0x1314448000000000ull},  // 5^38
+};
+
+/** Most significant digits whose value fits a uint64_t exactly */
+const int OBJ_MAX_FAST_DIGITS = 19;
+
+const int FLOAT_MANTISSA_BITS = 23;
+const int FLOAT_EXPONENT_BIAS = 127;
+const int FLOAT_INFINITE_POWER = 0xFF;
+
+struct ObjU128 {
+    uint64_t high, low;
+};
+
+inline ObjU128 obj_mul_64(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 uint128;
+    uint128 product = (uint128)a * b;
+    ObjU128 r = {(uint64_t)(product >> 64), (uint64_t)product};
+    return r;
+#else
+    uint64_t lo_lo = (a & 0xFFFFFFFFULL) * (b & 0xFFFFFFFFULL);
+    uint64_t hi_lo = (a >> 32) * (b & 0xFFFFFFFFULL);
+    uint64_t lo_hi = (a & 0xFFFFFFFFULL) * (b >> 32);
+    uint64_t hi_hi = (a >> 32) * (b >> 32);
+    uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFULL) + lo_hi;
+    ObjU128 r = {(hi_lo >> 32) + (cross >> 32) + hi_hi, (cross << 32) | (lo_lo & 0xFFFFFFFFULL)};
+    return r;
+#endif
+}
+
+inline int obj_leading_zeros(uint64_t x) {
+#if defined(__GNUC__)
+    return __builtin_clzll(x);
+#else
+    int n = 0;
+    for (; !(x & (1ULL << 63)); x <<= 1) n++;
+    return n;
+#endif
+}
+
+/**
+ * @brief Correctly rounded float nearest to w * 10^q (Eisel-Lemire)
+ *
+ * w is shifted up to 64 significant bits and multiplied by the truncated
+ * 128-bit 5^q; the top 26 bits of the product are exact unless every bit
+ * below them is set, when the low half of 5^q settles it. The power of two
+ * comes from q * log2(10). Ties are only possible for q in [-17, 10], where
+ * an exact product shows as a zero low word. Lemire, "Number Parsing at a
+ * Gigabyte per Second", 2021, and Mushtak and Lemire, "Fast Number Parsing
+ * Without Fallback", 2023.
+ */
+float obj_decimal_to_float(uint64_t w, int q, bool negative) {
+    uint32_t bits = 0;
+    if (w == 0 || q < OBJ_MIN_POW10) {
+        bits = 0;
+    } else if (q > OBJ_MAX_POW10) {
+        bits = (uint32_t)FLOAT_INFINITE_POWER << FLOAT_MANTISSA_BITS;
+    } else {
+        int lz = obj_leading_zeros(w);
+        w <<= lz;
+        const uint64_t* pow5 = OBJ_POW5_128[q - OBJ_MIN_POW10];
+        ObjU128 product = obj_mul_64(w, pow5[0]);
+        const uint64_t precision_mask = ~0ULL >> (FLOAT_MANTISSA_BITS + 3);
+        if ((product.high & precision_mask) == precision_mask) {
+            ObjU128 second = obj_mul_64(w, pow5[1]);
+            product.low += second.high;
+            if (second.high > product.low) product.high++;
+        }
+
+        int upper_bit = (int)(product.high >> 63);
+        int shift = upper_bit + 64 - FLOAT_MANTISSA_BITS - 3;
+        uint64_t mantissa = product.high >> shift;
+        int power2 = (((152170 + 65536) * q) >> 16) + 63 + upper_bit - lz + FLOAT_EXPONENT_BIAS;
+
+        if (power2 <= 0) {
+            // Subnormal, or below half the smallest one
+            if (-power2 + 1 >= 64) {
+                mantissa = 0;
+                power2 = 0;
+            } else {
+                mantissa >>= -power2 + 1;
+                mantissa += mantissa & 1;
+                mantissa >>= 1;
+                power2 = mantissa < (1ULL << FLOAT_MANTISSA_BITS) ? 0 : 1;
+            }
+        } else {
+            if (product.low <= 1 && q >= -17 && q <= 10 && (mantissa & 3) == 1 &&
+                (mantissa << shift) == product.high) {
+                mantissa &= ~1ULL;  // exactly halfway: round to even
             }
-        } else if (line[0] == 'v' && line[1] == 't') {
-            // UV coordinate
-            float u, v;
-            if (sscanf(line, "vt %f %f", &u, &v) == 2) {
-                uvs_temp.push_back(u);
-                uvs_temp.push_back(v);
-                has_uvs = true;
+            mantissa += mantissa & 1;
+            mantissa >>= 1;
+            if (mantissa >= (2ULL << FLOAT_MANTISSA_BITS)) {
+                mantissa = 1ULL << FLOAT_MANTISSA_BITS;
+                power2++;
             }
-        } else if (line[0] == 'f' && line[1] == ' ') {
-            // Face - supports multiple formats:
-            // - Triangles: f v1 v2 v3
-            // - Triangles with UVs: f v1/vt1 v2/vt2 v3/vt3
-            // - Triangles with UVs and normals: f v1/vt1/vn1 v2/vt2/vn2 v3/vt3/vn3
-            // - Quads: f v1 v2 v3 v4 (converted to two triangles)
-            // - Quads with UVs/normals: f v1/vt1/vn1 v2/vt2/vn2 v3/vt3/vn3 v4/vt4/vn4
-
-            int v[4], vt[4], vn[4];
-            int num_vertices = vertices.size() / 3;
-            int num_parsed = 0;
-
-            // Try v/vt/vn format (most common in Blender)
-            if (sscanf(line, "f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d",
-                      &v[0], &vt[0], &vn[0], &v[1], &vt[1], &vn[1],
-                      &v[2], &vt[2], &vn[2], &v[3], &vt[3], &vn[3]) == 12) {
-                num_parsed = 4;  // Quad with UVs and normals
-            } else if (sscanf(line, "f %d/%d/%d %d/%d/%d %d/%d/%d",
-                             &v[0], &vt[0], &vn[0], &v[1], &vt[1], &vn[1],
-                             &v[2], &vt[2], &vn[2]) == 9) {
-                num_parsed = 3;  // Triangle with UVs and normals
-            } else if (sscanf(line, "f %d/%d %d/%d %d/%d %d/%d",
-                             &v[0], &vt[0], &v[1], &vt[1], &v[2], &vt[2], &v[3], &vt[3]) == 8) {
-                num_parsed = 4;  // Quad with UVs
-            } else if (sscanf(line, "f %d/%d %d/%d %d/%d",
-                             &v[0], &vt[0], &v[1], &vt[1], &v[2], &vt[2]) == 6) {
-                num_parsed = 3;  // Triangle with UVs
-            } else if (sscanf(line, "f %d %d %d %d", &v[0], &v[1], &v[2], &v[3]) == 4) {
-                num_parsed = 4;  // Quad without UVs
-            } else if (sscanf(line, "f %d %d %d", &v[0], &v[1], &v[2]) == 3) {
-                num_parsed = 3;  // Triangle without UVs
+            mantissa &= ~(1ULL << FLOAT_MANTISSA_BITS);
+            if (power2 >= FLOAT_INFINITE_POWER) {
+                power2 = FLOAT_INFINITE_POWER;
+                mantissa = 0;
             }
+        }
+        // A subnormal rounded up to the smallest normal carries into power2
+        bits = (uint32_t)mantissa | ((uint32_t)power2 << FLOAT_MANTISSA_BITS);
+    }
+    if (negative) bits |= 1u << 31;
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
 
-            if (num_parsed >= 3) {
-                // Validate vertex indices (OBJ is 1-indexed)
-                bool valid = true;
-                for (int i = 0; i < num_parsed; i++) {
-                    if (v[i] < 1 || v[i] > num_vertices) {
-                        fprintf(stderr, "Error: Invalid vertex index %d in face (valid range: 1-%d)\n",
-                               v[i], num_vertices);
-                        valid = false;
-                        break;
-                    }
-                }
+/**
+ * @brief Parse a float like sscanf("%f")
+ *
+ * Decimals of up to 19 significant digits are converted directly by
+ * obj_decimal_to_float(); longer ones, hex floats, inf and nan go through
+ * strtof. Returns NULL on a matching failure.
+ */
+const char* obj_parse_float(const char* p, const char* end, float* out) {
+    p = obj_skip_space(p, end);
+    const char* start = p;
+
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) negative = (*p++ == '-');
+
+    // Past 19 significant digits the mantissa wraps, but it is not used then
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    const char* first_digit = p;
+    for (; p < end && *p >= '0' && *p <= '9'; p++, digits++) mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+    if (p < end && *p == '.') {
+        const char* fraction = ++p;
+        for (; p < end && *p >= '0' && *p <= '9'; p++) mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+        exponent = (int)(fraction - p);
+        digits -= exponent;
+    }
+    bool fast = digits > 0;
+    if (digits > OBJ_MAX_FAST_DIGITS) {
+        // Leading zeros are not significant
+        int zeros = 0;
+        for (const char* q = first_digit; q < p && (*q == '0' || *q == '.'); q++) zeros += *q == '0';
+        fast = digits - zeros <= OBJ_MAX_FAST_DIGITS;
+    }
+    if (fast && p < end && (*p == 'e' || *p == 'E')) {
+        const char* q = p + 1;
+        bool exp_negative = false;
+        if (q < end && (*q == '-' || *q == '+')) exp_negative = (*q++ == '-');
+        int e = 0;
+        const char* exp_digits = q;
+        for (; q < end && *q >= '0' && *q <= '9'; q++) {
+            if (e < 100000) e = e * 10 + (*q - '0');
+        }
+        if (q == exp_digits) fast = false;
+        exponent += exp_negative ? -e : e;
+        p = q;
+    }
+    // Hex floats, inf/nan and the like
+    if (p < end && (obj_is_alnum(*p) || *p == '.')) fast = false;
+
+    if (fast) {
+        *out = obj_decimal_to_float(mantissa, exponent, negative);
+        return p;
+    }
+
+    char buffer[OBJ_MAX_NUMBER_CHARS + 1];
+    int length = 0;
+    for (const char* q = start; q < end && length < OBJ_MAX_NUMBER_CHARS && *q != '\n'; q++) {
+        buffer[length++] = *q;
+    }
+    buffer[length] = '\0';
+    char* parsed_end = NULL;
+    float value = strtof(buffer, &parsed_end);
+    if (parsed_end == buffer) return NULL;
+    *out = value;
+    return start + (parsed_end - buffer);
+}
+
+/** Parse an int like sscanf("%d"); NULL on a matching failure */
+const char* obj_parse_int(const char* p, const char* end, int* out) {
+    p = obj_skip_space(p, end);
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) negative = (*p++ == '-');
+    const char* digits = p;
+    long long value = 0;
+    for (; p < end && *p >= '0' && *p <= '9'; p++) {
+        if (value < (1ll << 40)) value = value * 10 + (*p - '0');
+    }
+    if (p == digits) return NULL;
+    *out = (int)(negative ? -value : value);
+    return p;
+}
 
-                if (valid) {
-                    // Add first triangle (v0, v1, v2)
-                    triangles.push_back(v[0] - 1);
-                    triangles.push_back(v[1] - 1);
-                    triangles.push_back(v[2] - 1);
-
-                    // If quad, add second triangle (v0, v2, v3)
-                    if (num_parsed == 4) {
-                        triangles.push_back(v[0] - 1);
-                        triangles.push_back(v[2] - 1);
-                        triangles.push_back(v[3] - 1);
+/**
+ * @brief Everything parsed from one newline-aligned slice of the file
+ *
+ * Face indices are stored raw together with the number of vertices the
+ * chunk had seen, so they can be validated and made absolute once the
+ * chunk's global vertex offset is known.
+ */
+struct ObjChunk {
+    std::vector<float> vertices;
+    std::vector<float> uvs;
+    std::vector<int> faces;     /**< Per face: corner count n, n indices, vertices seen */
+    std::vector<int> triangles; /**< Resolved 0-based triangles */
+    std::vector<int> bad_indices; /**< Per rejected face: raw index, vertex count */
+};
+
+void parse_obj_chunk(const char* p, const char* end, ObjChunk* chunk) {
+    while (p < end) {
+        const char* eol = (const char*)memchr(p, '\n', end - p);
+        const char* line_end = eol ? eol : end;
+
+        if (line_end - p >= 2 && p[0] == 'v' && p[1] == ' ') {
+            float xyz[3];
+            const char* q = p + 1;
+            int i = 0;
+            for (; i < 3 && q; i++) q = obj_parse_float(q, line_end, &xyz[i]);
+            if (q) chunk->vertices.insert(chunk->vertices.end(), xyz, xyz + 3);
+        } else if (line_end - p >= 2 && p[0] == 'v' && p[1] == 't') {
+            float uv[2];
+            const char* q = obj_parse_float(p + 2, line_end, &uv[0]);
+            if (q) q = obj_parse_float(q, line_end, &uv[1]);
+            if (q) chunk->uvs.insert(chunk->uvs.end(), uv, uv + 2);
+        } else if (line_end - p >= 2 && p[0] == 'f' && p[1] == ' ') {
+            // Corners are v, v/vt, v/vt/vn or v//vn, as many as the line has
+            size_t head = chunk->faces.size();
+            chunk->faces.push_back(0);
+            int num_corners = 0;
+            const char* q = p + 1;
+            for (;;) {
+                int index, attribute;
+                const char* next = obj_parse_int(q, line_end, &index);
+                if (!next) break;
+                if (next < line_end && *next == '/') {
+                    next++;
+                    if (next < line_end && *next == '/') {
+                        next = obj_parse_int(next + 1, line_end, &attribute);
+                    } else {
+                        next = obj_parse_int(next, line_end, &attribute);
+                        if (next && next < line_end && *next == '/') {
+                            next = obj_parse_int(next + 1, line_end, &attribute);
+                        }
                     }
+                    if (!next) break;
                 }
+                chunk->faces.push_back(index);
+                num_corners++;
+                q = next;
+            }
+            if (num_corners >= 3) {
+                chunk->faces[head] = num_corners;
+                chunk->faces.push_back((int)(chunk->vertices.size() / 3));
+            } else {
+                chunk->faces.resize(head);
             }
         }
+
+        p = line_end + 1;
     }
+}
 
-    fclose(f);
+/** Validate faces against the vertices seen so far and fan-triangulate them */
+void resolve_obj_faces(ObjChunk* chunk, int vertex_base) {
+    // A triangle's record is 5 ints for 3 indices, a quad's 6 for 6
+    chunk->triangles.reserve(chunk->faces.size());
+    std::vector<int> v;
+    for (size_t i = 0; i < chunk->faces.size();) {
+        int num_corners = chunk->faces[i];
+        const int* face = &chunk->faces[i + 1];
+        int num_vertices = vertex_base + face[num_corners];
+        i += (size_t)num_corners + 2;
+
+        v.resize((size_t)num_corners);
+        bool valid = true;
+        for (int k = 0; k < num_corners; k++) {
+            // Negative indices are relative to the last vertex seen
+            v[k] = face[k] < 0 ? num_vertices + face[k] + 1 : face[k];
+            if (v[k] < 1 || v[k] > num_vertices) {
+                chunk->bad_indices.push_back(face[k]);
+                chunk->bad_indices.push_back(num_vertices);
+                valid = false;
+                break;
+            }
+        }
+        if (!valid) continue;
 
-    if (vertices.empty() || triangles.empty()) {
-        fprintf(stderr, "Failed to parse OBJ file: %s\n", filename);
-        return NULL;
+        for (int k = 1; k + 1 < num_corners; k++) {
+            chunk->triangles.push_back(v[0] - 1);
+            chunk->triangles.push_back(v[k] - 1);
+            chunk->triangles.push_back(v[k + 1] - 1);
+        }
     }
+    std::vector<int>().swap(chunk->faces);
+}
 
-    Mesh* mesh = (Mesh*)malloc(sizeof(Mesh));
+/**
+ * @brief Parse a whole OBJ file held in memory
+ *
+ * Newline-aligned chunks, a few per thread for load balance; a single
+ * chunk when num_threads is 1 or the file is small.
+ */
+Mesh* parse_obj(const char* data, size_t size, int num_threads, const char* filename) {
+    size_t max_chunks = size / OBJ_MIN_CHUNK_BYTES;
+    size_t wanted = (size_t)num_threads * 4;
+    int num_chunks = num_threads > 1 ? (int)(max_chunks < wanted ? max_chunks : wanted) : 1;
+    if (num_chunks < 1) num_chunks = 1;
+
+    std::vector<size_t> bounds(num_chunks + 1);
+    bounds[0] = 0;
+    for (int c = 1; c < num_chunks; c++) {
+        size_t pos = size * c / num_chunks;
+        if (pos < bounds[c - 1]) pos = bounds[c - 1];
+        const char* eol = (const char*)memchr(data + pos, '\n', size - pos);
+        bounds[c] = eol ? (size_t)(eol - data) + 1 : size;
+    }
+    bounds[num_chunks] = size;
+
+    std::vector<ObjChunk> chunks(num_chunks);
+    uvunwrap::parallel_for_dynamic(num_chunks, num_threads, [&](int, int c) {
+        parse_obj_chunk(data + bounds[c], data + bounds[c + 1], &chunks[c]);
+    });
+
+    // Global offsets, then resolve indices in parallel
+    std::vector<size_t> vertex_offsets(num_chunks + 1, 0);
+    std::vector<size_t> uv_offsets(num_chunks + 1, 0);
+    for (int c = 0; c < num_chunks; c++) {
+        vertex_offsets[c + 1] = vertex_offsets[c] + chunks[c].vertices.size();
+        uv_offsets[c + 1] = uv_offsets[c] + chunks[c].uvs.size();
+    }
+    uvunwrap::parallel_for_dynamic(num_chunks, num_threads, [&](int, int c) {
+        resolve_obj_faces(&chunks[c], (int)(vertex_offsets[c] / 3));
+    });
+
+    std::vector<size_t> triangle_offsets(num_chunks + 1, 0);
+    for (int c = 0; c < num_chunks; c++) {
+        triangle_offsets[c + 1] = triangle_offsets[c] + chunks[c].triangles.size();
+        for (size_t i = 0; i < chunks[c].bad_indices.size(); i += 2) {
+            LOG_ERROR("Error: Invalid vertex index %d in face (valid range: 1-%d)",
+                      chunks[c].bad_indices[i], chunks[c].bad_indices[i + 1]);
+        }
+    }
 
-    mesh->num_vertices = vertices.size() / 3;
-    mesh->vertices = (float*)malloc(vertices.size() * sizeof(float));
-    memcpy(mesh->vertices, vertices.data(), vertices.size() * sizeof(float));
+    size_t num_floats = vertex_offsets[num_chunks];
+    size_t num_indices = triangle_offsets[num_chunks];
+    size_t num_uv_floats = uv_offsets[num_chunks];
+    if (num_floats == 0 || num_indices == 0) {
+        LOG_ERROR("Failed to parse OBJ file: %s", filename);
+        return NULL;
+    }
 
-    mesh->num_triangles = triangles.size() / 3;
-    mesh->triangles = (int*)malloc(triangles.size() * sizeof(int));
-    memcpy(mesh->triangles, triangles.data(), triangles.size() * sizeof(int));
+    Mesh* mesh = (Mesh*)malloc(sizeof(Mesh));
+    mesh->num_vertices = (int)(num_floats / 3);
+    mesh->vertices = (float*)malloc(num_floats * sizeof(float));
+    mesh->num_triangles = (int)(num_indices / 3);
+    mesh->triangles = (int*)malloc(num_indices * sizeof(int));
+    mesh->uvs = NULL;
 
-    if (has_uvs) {
-        size_t expected_uv_count = (vertices.size() / 3) * 2;
-        if (uvs_temp.size() == expected_uv_count) {
-            mesh->uvs = (float*)malloc(uvs_temp.size() * sizeof(float));
-            memcpy(mesh->uvs, uvs_temp.data(), uvs_temp.size() * sizeof(float));
+    bool keep_uvs = false;
+    if (num_uv_floats > 0) {
+        size_t expected_uv_count = (size_t)mesh->num_vertices * 2;
+        if (num_uv_floats == expected_uv_count) {
+            mesh->uvs = (float*)malloc(num_uv_floats * sizeof(float));
+            keep_uvs = true;
         } else {
-            fprintf(stderr,
-                    "Warning: UV count mismatch in %s\n"
-                    "  Expected: %zu UVs (%zu vertices)\n"
-                    "  Found:    %zu UVs\n"
-                    "  UVs will be ignored.\n",
-                    filename, expected_uv_count / 2, vertices.size() / 3,
-                    uvs_temp.size() / 2);
-            mesh->uvs = NULL;
+            LOG_WARNING("Warning: UV count mismatch in %s\n"
+                        "  Expected: %zu UVs (%zu vertices)\n"
+                        "  Found:    %zu UVs\n"
+                        "  UVs will be ignored.",
+                        filename, expected_uv_count / 2, (size_t)mesh->num_vertices,
+                        num_uv_floats / 2);
         }
-    } else {
-        mesh->uvs = NULL;
     }
 
-    printf("Loaded %s: %d vertices, %d triangles\n",
-           filename, mesh->num_vertices, mesh->num_triangles);
+    uvunwrap::parallel_for_dynamic(num_chunks, num_threads, [&](int, int c) {
+        const ObjChunk& chunk = chunks[c];
+        if (!chunk.vertices.empty()) {
+            memcpy(mesh->vertices + vertex_offsets[c], chunk.vertices.data(),
+                   chunk.vertices.size() * sizeof(float));
+        }
+        if (!chunk.triangles.empty()) {
+            memcpy(mesh->triangles + triangle_offsets[c], chunk.triangles.data(),
+                   chunk.triangles.size() * sizeof(int));
+        }
+        if (keep_uvs && !chunk.uvs.empty()) {
+            memcpy(mesh->uvs + uv_offsets[c], chunk.uvs.data(), chunk.uvs.size() * sizeof(float));
+        }
+    });
+
+    LOG_INFO("Loaded %s: %d vertices, %d triangles",
+             filename, mesh->num_vertices, mesh->num_triangles);
 
     return mesh;
 }
 
+} // namespace
+
+Mesh* load_obj(const char* filename) {
+    UV_TRACE_ZONE("load_obj");
+    FILE* f = fopen(filename, "rb");
+    if (!f) {
+        LOG_ERROR("Cannot open file: %s", filename);
+        return NULL;
+    }
+    std::vector<char> data;
+    char buffer[1 << 16];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) data.insert(data.end(), buffer, buffer + n);
+    fclose(f);
+    return parse_obj(data.data(), data.size(), 1, filename);
+}
+
+Mesh* load_obj_fast(const char* filename) {
+    UV_TRACE_ZONE("load_obj_fast");
+    uvunwrap::MappedFile file;
+    if (!file.open(filename)) {
+        LOG_ERROR("Cannot open file: %s", filename);
+        return NULL;
+    }
+    file.advise_sequential();
+    return parse_obj(file.data(), file.size(), uvunwrap::resolve_thread_count(0), filename);
+}
+
 int save_obj(const Mesh* mesh, const char* filename) {
     if (!mesh) return -1;
+    UV_TRACE_ZONE("save_obj");
 
     FILE* f = fopen(filename, "w");
     if (!f) {
-        fprintf(stderr, "Cannot write file: %s\n", filename);
+        LOG_ERROR("Cannot write file: %s", filename);
         return -1;
     }
 
@@ -187,7 +620,273 @@ int save_obj(const Mesh* mesh, const char* filename) {
     }
 
     fclose(f);
-    printf("Saved %s\n", filename);
+    LOG_INFO("Saved %s", filename);
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// save_obj_fast: chunked formatting into per-chunk buffers
+// ---------------------------------------------------------------------------
+
+namespace {
+
+/** Lines formatted per chunk; each chunk is one task and one buffer */
+const int OBJ_LINES_PER_CHUNK = 1 << 16;
+
+/** Decimal exponents printed in plain notation; others use "e" */
+const int OBJ_FIXED_MIN_EXPONENT = -5;
+const int OBJ_FIXED_MAX_EXPONENT = 9;
+
+/** 10^k for k in [0, 22], all exact in double */
+double obj_pow10(int k) {
+    static const double table[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    return table[k];
+}
+
+/**
+ * @brief Sign of (scaled decimal n) - x, computed exactly
+ *
+ * The decimal is n * 10^-k; x is a double that is exact for a float
+ * rounding boundary. One side is always an exact power of ten, so a
+ * single fma gives the exact sign.
+ */
+int obj_compare_decimal(double n, int k, double x) {
+    double d = k >= 0 ? -fma(x, obj_pow10(k), -n) : fma(n, obj_pow10(-k), -x);
+    return (d > 0) - (d < 0);
+}
+
+/**
+ * @brief Decimal n * 10^-k nearest to x inside the rounding interval of x
+ *
+ * Only the two integers bracketing x * 10^k can be the nearest; each is
+ * tested exactly against [lo, hi] (inclusive for even mantissas, which
+ * round-half-even parsing maps back to x). Returns false if neither fits.
+ */
+bool obj_nearest_decimal(double x, double lo, double hi, bool inclusive, int k, uint32_t* digits_out) {
+    if (k > 22 || k < -22) return false;
+    double scaled = k >= 0 ? x * obj_pow10(k) : x / obj_pow10(-k);
+    double base = floor(scaled);
+    bool found = false;
+    double best_error = 0.0;
+    for (int c = 0; c < 2; c++) {
+        double n = base + c;
+        if (n <= 0.0 || n >= 4294967295.0) continue;
+        int lo_cmp = obj_compare_decimal(n, k, lo);
+        int hi_cmp = obj_compare_decimal(n, k, hi);
+        bool inside = inclusive ? (lo_cmp >= 0 && hi_cmp <= 0) : (lo_cmp > 0 && hi_cmp < 0);
+        if (!inside) continue;
+        double error = fabs(n - scaled);
+        if (!found || error < best_error || (error == best_error && fmod(n, 2.0) == 0.0)) {
+            *digits_out = (uint32_t)n;
+            best_error = error;
+            found = true;
+        }
+    }
+    return found;
+}
+
+char* obj_write_uint(char* out, uint32_t value) {
+    char digits[10];
+    int count = 0;
+    do {
+        digits[count++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+    while (count) *out++ = digits[--count];
+    return out;
+}
+
+/**
+ * @brief Shortest decimal that reads back as the same float
+ *
+ * Subnormals and magnitudes whose scale factor would not be an exact
+ * double fall back to %.9g, which always round-trips.
+ */
+char* obj_write_float(char* out, float value) {
+    if (value == 0.0f) {
+        if (signbit(value)) *out++ = '-';
+        *out++ = '0';
+        return out;
+    }
+    if (!isfinite(value)) {
+        return out + snprintf(out, 16, "%g", value);
+    }
+
+    if (value < 0.0f) {
+        *out++ = '-';
+        value = -value;
+    }
+
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    int biased_exponent = (int)(bits >> 23);
+    uint32_t mantissa = (bits & 0x7fffff) | 0x800000;
+    double x = value;
+    double half_ulp = ldexp(1.0, biased_exponent - 151);
+    // Below an exact power of two the float spacing halves
+    double lo = x - ((bits & 0x7fffff) == 0 && biased_exponent > 1 ? half_ulp / 2 : half_ulp);
+    double hi = x + half_ulp;
+    bool inclusive = (mantissa & 1) == 0;
+
+    // At least one p-digit decimal lies in the interval for every p from
+    // the shortest up to 9, so binary search for the shortest
+    int exponent10 = (int)floor(log10(x));
+    uint32_t digits = 0;
+    int num_digits = 0;
+    if (biased_exponent > 0 && obj_nearest_decimal(x, lo, hi, inclusive, 8 - exponent10, &digits)) {
+        num_digits = 9;
+        int shortest = 1, longest = 9;
+        while (shortest < longest) {
+            int p = (shortest + longest) / 2;
+            uint32_t candidate;
+            if (obj_nearest_decimal(x, lo, hi, inclusive, p - 1 - exponent10, &candidate)) {
+                longest = p;
+                digits = candidate;
+                num_digits = p;
+            } else {
+                shortest = p + 1;
+            }
+        }
+    }
+
+    if (num_digits == 0) {
+        return out + snprintf(out, 24, "%.9g", (double)value);
+    }
+
+    // Rounding up may have produced 10^p (one digit more than intended)
+    char text[12];
+    int length = (int)(obj_write_uint(text, digits) - text);
+    int point = exponent10 + 1 + (length - num_digits);
+    while (length > 1 && text[length - 1] == '0') length--;
+
+    int sci_exponent = point - 1;
+    if (sci_exponent >= OBJ_FIXED_MIN_EXPONENT && sci_exponent < OBJ_FIXED_MAX_EXPONENT) {
+        if (point <= 0) {
+            *out++ = '0';
+            *out++ = '.';
+            for (int i = point; i < 0; i++) *out++ = '0';
+            memcpy(out, text, length);
+            out += length;
+        } else if (point >= length) {
+            memcpy(out, text, length);
+            out += length;
+            for (int i = length; i < point; i++) *out++ = '0';
+        } else {
+            memcpy(out, text, point);
+            out += point;
+            *out++ = '.';
+            memcpy(out, text + point, length - point);
+            out += length - point;
+        }
+    } else {
+        *out++ = text[0];
+        if (length > 1) {
+            *out++ = '.';
+            memcpy(out, text + 1, length - 1);
+            out += length - 1;
+        }
+        *out++ = 'e';
+        if (sci_exponent < 0) {
+            *out++ = '-';
+            sci_exponent = -sci_exponent;
+        }
+        out = obj_write_uint(out, (uint32_t)sci_exponent);
+    }
+    return out;
+}
+
+/** Longest line: "vt " / "v " plus three floats, or a face with six ints */
+const size_t OBJ_MAX_LINE_CHARS = 96;
+
+/** Format lines [begin, end) of one section into buffer */
+void format_obj_lines(const Mesh* mesh, char section, int begin, int end, std::string* buffer) {
+    buffer->resize((size_t)(end - begin) * OBJ_MAX_LINE_CHARS);
+    char* out = &(*buffer)[0];
+    for (int i = begin; i < end; i++) {
+        if (section == 'v') {
+            *out++ = 'v';
+            for (int j = 0; j < 3; j++) {
+                *out++ = ' ';
+                out = obj_write_float(out, mesh->vertices[i * 3 + j]);
+            }
+        } else if (section == 't') {
+            *out++ = 'v';
+            *out++ = 't';
+            for (int j = 0; j < 2; j++) {
+                *out++ = ' ';
+                out = obj_write_float(out, mesh->uvs[i * 2 + j]);
+            }
+        } else {
+            *out++ = 'f';
+            for (int j = 0; j < 3; j++) {
+                uint32_t v = (uint32_t)mesh->triangles[i * 3 + j] + 1;
+                *out++ = ' ';
+                out = obj_write_uint(out, v);
+                if (mesh->uvs) {
+                    *out++ = '/';
+                    out = obj_write_uint(out, v);
+                }
+            }
+        }
+        *out++ = '\n';
+    }
+    buffer->resize(out - buffer->data());
+}
+
+} // namespace
+
+int save_obj_fast(const Mesh* mesh, const char* filename) {
+    if (!mesh) return -1;
+    UV_TRACE_ZONE("save_obj_fast");
+
+    FILE* f = fopen(filename, "wb");
+    if (!f) {
+        LOG_ERROR("Cannot write file: %s", filename);
+        return -1;
+    }
+    // Chunks are already large; skip stdio's copy
+    setvbuf(f, NULL, _IONBF, 0);
+
+    struct Chunk {
+        char section;
+        int begin, end;
+    };
+    std::vector<Chunk> chunks;
+    auto add_section = [&](char section, int count) {
+        for (int begin = 0; begin < count; begin += OBJ_LINES_PER_CHUNK) {
+            int end = count - begin > OBJ_LINES_PER_CHUNK ? begin + OBJ_LINES_PER_CHUNK : count;
+            Chunk chunk = {section, begin, end};
+            chunks.push_back(chunk);
+        }
+    };
+    add_section('v', mesh->num_vertices);
+    if (mesh->uvs) add_section('t', mesh->num_vertices);
+    add_section('f', mesh->num_triangles);
+
+    // Format a window of chunks in parallel, then write it in file order
+    int num_threads = uvunwrap::choose_thread_count((int)chunks.size(), 0, 1);
+    int window = num_threads * 2;
+    std::vector<std::string> buffers(window);
+    bool ok = true;
+    for (size_t first = 0; first < chunks.size() && ok; first += window) {
+        int count = (int)(chunks.size() - first < (size_t)window ? chunks.size() - first : window);
+        uvunwrap::parallel_for_dynamic(count, num_threads, [&](int, int c) {
+            const Chunk& chunk = chunks[first + c];
+            format_obj_lines(mesh, chunk.section, chunk.begin, chunk.end, &buffers[c]);
+        });
+        for (int c = 0; c < count && ok; c++) {
+            ok = fwrite(buffers[c].data(), 1, buffers[c].size(), f) == buffers[c].size();
+        }
+    }
+
+    if (fclose(f) != 0) ok = false;
+    if (!ok) {
+        LOG_ERROR("Cannot write file: %s", filename);
+        return -1;
+    }
+    LOG_INFO("Saved %s", filename);
     return 0;
 }
 
@@ -217,3 +916,32 @@ Mesh* allocate_mesh_copy(const Mesh* input) {
 
     return mesh;
 }
+
+namespace {
+
+bool has_extension(const char* filename, const char* ext) {
+    size_t len = strlen(filename), ext_len = strlen(ext);
+    if (len < ext_len) return false;
+    for (size_t i = 0; i < ext_len; i++) {
+        char c = filename[len - ext_len + i];
+        if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+        if (c != ext[i]) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+Mesh* load_mesh(const char* filename) {
+    if (!filename) return NULL;
+    if (has_extension(filename, ".ply")) return load_ply(filename);
+    if (has_extension(filename, ".glb")) return load_glb(filename);
+    return load_obj_fast(filename);
+}
+
+int save_mesh(const Mesh* mesh, const char* filename) {
+    if (!filename) return -1;
+    if (has_extension(filename, ".ply")) return save_ply(mesh, filename);
+    if (has_extension(filename, ".glb")) return save_glb(mesh, filename);
+    return save_obj_fast(mesh, filename);
+}
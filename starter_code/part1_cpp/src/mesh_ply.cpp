@@ -0,0 +1,449 @@
+/**
+ * @file mesh_ply.cpp
+ * @brief Binary little-endian PLY reader and writer
+ *
+ * The header is parsed into elements of typed properties. Elements whose
+ * properties are all scalars have a fixed row size, so the vertex rows
+ * can be read at fixed offsets (or, for bare float x, y, z, copied in one
+ * memcpy) and unknown elements skipped in one step; rows with lists are
+ * walked property by property.
+ */
+
+#include "mesh_formats.h"
+#include "mapped_file.h"
+#include "logging.h"
+#include "trace.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+enum PlyType {
+    PLY_NONE,
+    PLY_INT8,
+    PLY_UINT8,
+    PLY_INT16,
+    PLY_UINT16,
+    PLY_INT32,
+    PLY_UINT32,
+    PLY_FLOAT32,
+    PLY_FLOAT64
+};
+
+/** Longest header accepted before end_header */
+const size_t PLY_MAX_HEADER_BYTES = 1 << 20;
+
+const char PLY_END_HEADER[] = "end_header";
+
+struct PlyProperty {
+    std::string name;
+    PlyType type;        // item type for lists
+    PlyType count_type;  // PLY_NONE for scalars
+};
+
+struct PlyElement {
+    std::string name;
+    long long count;
+    std::vector<PlyProperty> properties;
+};
+
+bool host_is_little_endian() {
+    const uint16_t probe = 1;
+    unsigned char first;
+    memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+PlyType ply_type(const std::string& name) {
+    if (name == "char" || name == "int8") return PLY_INT8;
+    if (name == "uchar" || name == "uint8") return PLY_UINT8;
+    if (name == "short" || name == "int16") return PLY_INT16;
+    if (name == "ushort" || name == "uint16") return PLY_UINT16;
+    if (name == "int" || name == "int32") return PLY_INT32;
+    if (name == "uint" || name == "uint32") return PLY_UINT32;
+    if (name == "float" || name == "float32") return PLY_FLOAT32;
+    if (name == "double" || name == "float64") return PLY_FLOAT64;
+    return PLY_NONE;
+}
+
+size_t ply_size(PlyType type) {
+    static const size_t SIZES[] = {0, 1, 1, 2, 2, 4, 4, 4, 8};
+    return SIZES[type];
+}
+
+double ply_value(const char* p, PlyType type) {
+    switch (type) {
+        case PLY_INT8: { int8_t v; memcpy(&v, p, 1); return v; }
+        case PLY_UINT8: { uint8_t v; memcpy(&v, p, 1); return v; }
+        case PLY_INT16: { int16_t v; memcpy(&v, p, 2); return v; }
+        case PLY_UINT16: { uint16_t v; memcpy(&v, p, 2); return v; }
+        case PLY_INT32: { int32_t v; memcpy(&v, p, 4); return v; }
+        case PLY_UINT32: { uint32_t v; memcpy(&v, p, 4); return v; }
+        case PLY_FLOAT32: { float v; memcpy(&v, p, 4); return v; }
+        case PLY_FLOAT64: { double v; memcpy(&v, p, 8); return v; }
+        default: return 0.0;
+    }
+}
+
+/** Bytes of one row, or 0 if a property is a list */
+size_t ply_row_size(const PlyElement& element) {
+    size_t size = 0;
+    for (const PlyProperty& p : element.properties) {
+        if (p.count_type != PLY_NONE) return 0;
+        size += ply_size(p.type);
+    }
+    return size;
+}
+
+/** Split the header into whitespace-separated words per line */
+bool parse_ply_header(const char* data, size_t size, std::vector<PlyElement>& elements, size_t* body,
+                      std::string* error) {
+    size_t limit = size < PLY_MAX_HEADER_BYTES ? size : PLY_MAX_HEADER_BYTES;
+    size_t pos = 0;
+    bool first = true;
+    bool format_ok = false;
+    while (pos < limit) {
+        const char* line = data + pos;
+        const char* eol = (const char*)memchr(line, '\n', limit - pos);
+        if (!eol) break;
+        pos = (size_t)(eol - data) + 1;
+
+        std::vector<std::string> words;
+        for (const char* p = line; p < eol;) {
+            while (p < eol && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+            const char* start = p;
+            while (p < eol && *p != ' ' && *p != '\t' && *p != '\r') p++;
+            if (p > start) words.push_back(std::string(start, p));
+        }
+        if (first) {
+            if (words.size() != 1 || words[0] != "ply") {
+                *error = "not a PLY file";
+                return false;
+            }
+            first = false;
+            continue;
+        }
+        if (words.empty() || words[0] == "comment" || words[0] == "obj_info") continue;
+
+        if (words[0] == "format") {
+            if (words.size() < 2 || words[1] != "binary_little_endian") {
+                *error = "only binary_little_endian PLY is supported";
+                return false;
+            }
+            format_ok = true;
+        } else if (words[0] == "element" && words.size() == 3) {
+            PlyElement element;
+            element.name = words[1];
+            element.count = atoll(words[2].c_str());
+            if (element.count < 0) {
+                *error = "negative element count";
+                return false;
+            }
+            elements.push_back(element);
+        } else if (words[0] == "property" && !elements.empty()) {
+            PlyProperty property;
+            if (words.size() == 5 && words[1] == "list") {
+                property.count_type = ply_type(words[2]);
+                property.type = ply_type(words[3]);
+                property.name = words[4];
+                if (property.count_type == PLY_NONE || property.count_type == PLY_FLOAT32 ||
+                    property.count_type == PLY_FLOAT64) {
+                    *error = "bad list count type";
+                    return false;
+                }
+            } else if (words.size() == 3) {
+                property.count_type = PLY_NONE;
+                property.type = ply_type(words[1]);
+                property.name = words[2];
+            } else {
+                *error = "bad property line";
+                return false;
+            }
+            if (property.type == PLY_NONE) {
+                *error = "unknown property type";
+                return false;
+            }
+            elements.back().properties.push_back(property);
+        } else if (words[0] == PLY_END_HEADER) {
+            if (!format_ok) {
+                *error = "missing format line";
+                return false;
+            }
+            *body = pos;
+            return true;
+        } else {
+            *error = "bad header line";
+            return false;
+        }
+    }
+    *error = "header has no end_header";
+    return false;
+}
+
+int find_property(const PlyElement& element, const char* const* names, int num_names) {
+    for (size_t i = 0; i < element.properties.size(); i++) {
+        for (int n = 0; n < num_names; n++) {
+            if (element.properties[i].name == names[n] && element.properties[i].count_type == PLY_NONE) return (int)i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Walk one row, handing every scalar to scalar(property, value) and
+ *        every list to list(property, count, items)
+ * @return End of the row, or NULL if it runs past end
+ */
+template <typename ScalarFn, typename ListFn>
+const char* walk_ply_row(const PlyElement& element, const char* p, const char* end, ScalarFn&& scalar,
+                         ListFn&& list) {
+    for (size_t i = 0; i < element.properties.size(); i++) {
+        const PlyProperty& prop = element.properties[i];
+        if (prop.count_type == PLY_NONE) {
+            size_t n = ply_size(prop.type);
+            if ((size_t)(end - p) < n) return NULL;
+            scalar((int)i, p);
+            p += n;
+        } else {
+            size_t n = ply_size(prop.count_type);
+            if ((size_t)(end - p) < n) return NULL;
+            double count = ply_value(p, prop.count_type);
+            p += n;
+            if (count < 0) return NULL;
+            size_t bytes = (size_t)count * ply_size(prop.type);
+            if ((size_t)(end - p) < bytes) return NULL;
+            list((int)i, (int)count, p);
+            p += bytes;
+        }
+    }
+    return p;
+}
+
+} // namespace
+
+Mesh* load_ply(const char* filename) {
+    UV_TRACE_ZONE("load_ply");
+    if (!host_is_little_endian()) {
+        LOG_ERROR("load_ply: big-endian hosts are not supported");
+        return NULL;
+    }
+    uvunwrap::MappedFile file;
+    if (!file.open(filename)) {
+        LOG_ERROR("Cannot open file: %s", filename);
+        return NULL;
+    }
+    file.advise_sequential();
+    const char* data = file.data();
+    const char* end = data + file.size();
+
+    std::vector<PlyElement> elements;
+    size_t body = 0;
+    std::string error;
+    if (!data || !parse_ply_header(data, file.size(), elements, &body, &error)) {
+        LOG_ERROR("load_ply: %s: %s", filename, data ? error.c_str() : "empty file");
+        return NULL;
+    }
+
+    static const char* const X[] = {"x"};
+    static const char* const Y[] = {"y"};
+    static const char* const Z[] = {"z"};
+    static const char* const U[] = {"u", "s", "texture_u"};
+    static const char* const V[] = {"v", "t", "texture_v"};
+    static const char* const INDICES[] = {"vertex_indices", "vertex_index"};
+
+    std::vector<float> vertices, uvs;
+    std::vector<int> triangles;
+    long long num_vertices = -1;
+    bool have_faces = false;
+    const char* p = data + body;
+    for (const PlyElement& element : elements) {
+        size_t row = ply_row_size(element);
+        if (element.name == "vertex" && num_vertices < 0) {
+            int px = find_property(element, X, 1), py = find_property(element, Y, 1), pz = find_property(element, Z, 1);
+            int pu = find_property(element, U, 3), pv = find_property(element, V, 3);
+            if (px < 0 || py < 0 || pz < 0 || element.count > 0x7FFFFFFF) {
+                LOG_ERROR("load_ply: %s: vertices need x, y and z", filename);
+                return NULL;
+            }
+            num_vertices = element.count;
+            bool with_uvs = pu >= 0 && pv >= 0;
+            vertices.resize((size_t)num_vertices * 3);
+            if (with_uvs) uvs.resize((size_t)num_vertices * 2);
+
+            const PlyProperty* props = element.properties.data();
+            if (row == 12 && px == 0 && py == 1 && pz == 2 && props[0].type == PLY_FLOAT32 &&
+                props[1].type == PLY_FLOAT32 && props[2].type == PLY_FLOAT32) {
+                // Bare float x, y, z: one copy
+                size_t bytes = vertices.size() * sizeof(float);
+                if ((size_t)(end - p) < bytes) {
+                    LOG_ERROR("load_ply: %s: truncated vertices", filename);
+                    return NULL;
+                }
+                memcpy(vertices.data(), p, bytes);
+                p += bytes;
+                continue;
+            }
+            std::vector<size_t> offsets(element.properties.size(), 0);
+            for (size_t i = 1; row > 0 && i < offsets.size(); i++) {
+                offsets[i] = offsets[i - 1] + ply_size(props[i - 1].type);
+            }
+            if (row > 0 && (size_t)(end - p) / row < (size_t)num_vertices) {
+                LOG_ERROR("load_ply: %s: truncated vertices", filename);
+                return NULL;
+            }
+            const int targets[5] = {px, py, pz, pu, pv};
+            for (long long v = 0; v < num_vertices; v++) {
+                float values[5] = {0, 0, 0, 0, 0};
+                if (row > 0) {
+                    for (int k = 0; k < (with_uvs ? 5 : 3); k++) {
+                        values[k] = (float)ply_value(p + offsets[targets[k]], props[targets[k]].type);
+                    }
+                    p += row;
+                } else {
+                    p = walk_ply_row(element, p, end, [&](int prop, const char* at) {
+                        for (int k = 0; k < 5; k++) {
+                            if (targets[k] == prop) values[k] = (float)ply_value(at, props[prop].type);
+                        }
+                    }, [](int, int, const char*) {});
+                    if (!p) {
+                        LOG_ERROR("load_ply: %s: truncated vertices", filename);
+                        return NULL;
+                    }
+                }
+                memcpy(&vertices[(size_t)v * 3], values, 3 * sizeof(float));
+                if (with_uvs) memcpy(&uvs[(size_t)v * 2], values + 3, 2 * sizeof(float));
+            }
+        } else if (element.name == "face" && !have_faces) {
+            have_faces = true;
+            int list = -1;
+            for (size_t i = 0; i < element.properties.size(); i++) {
+                const PlyProperty& prop = element.properties[i];
+                if (prop.count_type != PLY_NONE && (prop.name == INDICES[0] || prop.name == INDICES[1])) {
+                    list = (int)i;
+                }
+            }
+            if (list < 0) {
+                LOG_ERROR("load_ply: %s: faces have no vertex_indices", filename);
+                return NULL;
+            }
+            PlyType index_type = element.properties[list].type;
+            bool exact = index_type == PLY_INT32 || index_type == PLY_UINT32;
+            triangles.reserve((size_t)element.count * 3);
+            std::vector<int> corners;
+            for (long long f = 0; f < element.count && p; f++) {
+                p = walk_ply_row(element, p, end, [](int, const char*) {}, [&](int prop, int count, const char* items) {
+                    if (prop != list || count < 3) return;
+                    if (count == 3 && exact) {
+                        // The common case: one 12-byte copy per triangle
+                        size_t at = triangles.size();
+                        triangles.resize(at + 3);
+                        memcpy(&triangles[at], items, 3 * sizeof(int));
+                        return;
+                    }
+                    corners.resize((size_t)count);
+                    for (int k = 0; k < count; k++) {
+                        corners[k] = (int)ply_value(items + k * ply_size(index_type), index_type);
+                    }
+                    for (int k = 1; k + 1 < count; k++) {
+                        triangles.push_back(corners[0]);
+                        triangles.push_back(corners[k]);
+                        triangles.push_back(corners[k + 1]);
+                    }
+                });
+            }
+            if (!p) {
+                LOG_ERROR("load_ply: %s: truncated faces", filename);
+                return NULL;
+            }
+        } else if (row > 0) {
+            if ((size_t)(end - p) / row < (size_t)element.count) {
+                LOG_ERROR("load_ply: %s: truncated %s elements", filename, element.name.c_str());
+                return NULL;
+            }
+            p += row * (size_t)element.count;
+        } else {
+            for (long long i = 0; i < element.count && p; i++) {
+                p = walk_ply_row(element, p, end, [](int, const char*) {}, [](int, int, const char*) {});
+            }
+            if (!p) {
+                LOG_ERROR("load_ply: %s: truncated %s elements", filename, element.name.c_str());
+                return NULL;
+            }
+        }
+    }
+
+    if (num_vertices <= 0 || triangles.empty()) {
+        LOG_ERROR("Failed to parse PLY file: %s", filename);
+        return NULL;
+    }
+    for (size_t i = 0; i < triangles.size(); i++) {
+        if (triangles[i] < 0 || triangles[i] >= num_vertices) {
+            LOG_ERROR("load_ply: %s: vertex index %d out of range (%lld vertices)", filename, triangles[i],
+                      num_vertices);
+            return NULL;
+        }
+    }
+
+    Mesh* mesh = (Mesh*)malloc(sizeof(Mesh));
+    mesh->num_vertices = (int)num_vertices;
+    mesh->vertices = (float*)malloc(vertices.size() * sizeof(float));
+    memcpy(mesh->vertices, vertices.data(), vertices.size() * sizeof(float));
+    mesh->num_triangles = (int)(triangles.size() / 3);
+    mesh->triangles = (int*)malloc(triangles.size() * sizeof(int));
+    memcpy(mesh->triangles, triangles.data(), triangles.size() * sizeof(int));
+    mesh->uvs = NULL;
+    if (!uvs.empty()) {
+        mesh->uvs = (float*)malloc(uvs.size() * sizeof(float));
+        memcpy(mesh->uvs, uvs.data(), uvs.size() * sizeof(float));
+    }
+
+    LOG_INFO("Loaded %s: %d vertices, %d triangles", filename, mesh->num_vertices, mesh->num_triangles);
+    return mesh;
+}
+
+int save_ply(const Mesh* mesh, const char* filename) {
+    UV_TRACE_ZONE("save_ply");
+    if (!mesh || !filename || !host_is_little_endian()) return -1;
+
+    char header[512];
+    int length = snprintf(header, sizeof(header),
+                          "ply\nformat binary_little_endian 1.0\ncomment uvunwrap\n"
+                          "element vertex %d\nproperty float x\nproperty float y\nproperty float z\n%s"
+                          "element face %d\nproperty list uchar int vertex_indices\nend_header\n",
+                          mesh->num_vertices, mesh->uvs ? "property float u\nproperty float v\n" : "",
+                          mesh->num_triangles);
+    size_t vertex_bytes = mesh->uvs ? 5 * sizeof(float) : 3 * sizeof(float);
+    size_t face_bytes = 1 + 3 * sizeof(int);
+    size_t size = (size_t)length + (size_t)mesh->num_vertices * vertex_bytes + (size_t)mesh->num_triangles * face_bytes;
+
+    uvunwrap::MappedFile file;
+    if (!file.create(filename, size)) {
+        LOG_ERROR("Cannot open file for writing: %s", filename);
+        return -1;
+    }
+    char* out = file.data();
+    memcpy(out, header, (size_t)length);
+    out += length;
+    for (int v = 0; v < mesh->num_vertices; v++) {
+        memcpy(out, &mesh->vertices[(size_t)v * 3], 3 * sizeof(float));
+        out += 3 * sizeof(float);
+        if (mesh->uvs) {
+            memcpy(out, &mesh->uvs[(size_t)v * 2], 2 * sizeof(float));
+            out += 2 * sizeof(float);
+        }
+    }
+    for (int f = 0; f < mesh->num_triangles; f++) {
+        *out++ = 3;
+        memcpy(out, &mesh->triangles[(size_t)f * 3], 3 * sizeof(int));
+        out += 3 * sizeof(int);
+    }
+    if (!file.flush()) {
+        LOG_ERROR("Failed to write PLY file: %s", filename);
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,377 @@
+/**
+ * @file mesh_reorder.cpp
+ * @brief Reverse Cuthill-McKee and Morton vertex orders, and reorder_mesh()
+ *
+ * RCM: breadth-first search from a pseudo-peripheral vertex of each
+ * connected component, neighbours visited by increasing degree, the whole
+ * order reversed. Reference: "Reducing the Bandwidth of Sparse Symmetric
+ * Matrices", Cuthill and McKee; George and Liu for the reversal and the
+ * peripheral start.
+ *
+ * Morton: positions quantised to 10 bits per axis over the bounding box
+ * and sorted by their interleaved code.
+ *
+ * Vertex cache: Tom Forsyth's "Linear-Speed Vertex Cache Optimisation".
+ * A simulated LRU cache scores each vertex by its cache position and by
+ * how few unemitted triangles still use it; the next triangle is the
+ * best-scoring one around the cached vertices, or the next unemitted
+ * triangle in input order when none is left there.
+ */
+
+#include "mesh_reorder.h"
+#include "locality_order.h"
+#include "logging.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+/** Vertex adjacency from triangle corners; an edge shared by two faces is listed twice */
+void corner_adjacency(const int* tris, int num_faces, int n, std::vector<int>& offsets, std::vector<int>& nbrs) {
+    offsets.assign(n + 1, 0);
+    for (int i = 0; i < num_faces * 3; i++) offsets[tris[i] + 1] += 2;
+    for (int v = 0; v < n; v++) offsets[v + 1] += offsets[v];
+    nbrs.resize(offsets[n]);
+    std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+    for (int f = 0; f < num_faces; f++) {
+        const int* tri = &tris[f * 3];
+        for (int k = 0; k < 3; k++) {
+            nbrs[fill[tri[k]]++] = tri[(k + 1) % 3];
+            nbrs[fill[tri[k]]++] = tri[(k + 2) % 3];
+        }
+    }
+}
+
+void rcm_order(const int* tris, int num_faces, int n, int* new_to_old) {
+    std::vector<int> offsets, nbrs;
+    corner_adjacency(tris, num_faces, n, offsets, nbrs);
+    auto degree = [&](int v) { return offsets[v + 1] - offsets[v]; };
+
+    // Level structure of the unplaced component around root, in the
+    // queue; returns the minimum-degree vertex of the last level
+    std::vector<int> stamp(n, -1);
+    std::vector<int> queue(n);
+    int bfs = 0;
+    auto last_level = [&](int root, int* depth_out) {
+        bfs++;
+        int head = 0, tail = 0, depth = 0, level_start = 0;
+        queue[tail++] = root;
+        stamp[root] = bfs;
+        while (head < tail) {
+            int level_end = tail;
+            level_start = head;
+            for (; head < level_end; head++) {
+                int v = queue[head];
+                for (int e = offsets[v]; e < offsets[v + 1]; e++) {
+                    int w = nbrs[e];
+                    if (stamp[w] == bfs || stamp[w] == -2) continue;
+                    stamp[w] = bfs;
+                    queue[tail++] = w;
+                }
+            }
+            if (tail > level_end) depth++;
+        }
+        int best = queue[level_start];
+        for (int i = level_start; i < tail; i++) {
+            if (degree(queue[i]) < degree(best)) best = queue[i];
+        }
+        *depth_out = depth;
+        return best;
+    };
+
+    // stamp -2 marks placed vertices
+    int placed = 0;
+    std::vector<int> candidates;
+    for (int start = 0; start < n; start++) {
+        if (stamp[start] == -2) continue;
+
+        // Pseudo-peripheral root: hop to the far end while that deepens the levels
+        int root = start, depth = 0;
+        int far = last_level(root, &depth);
+        for (int hop = 0; hop < 4; hop++) {
+            int far_depth = 0;
+            int next = last_level(far, &far_depth);
+            if (far_depth <= depth) break;
+            root = far;
+            depth = far_depth;
+            far = next;
+        }
+
+        int head = placed;
+        new_to_old[placed++] = root;
+        stamp[root] = -2;
+        while (head < placed) {
+            int v = new_to_old[head++];
+            candidates.clear();
+            for (int e = offsets[v]; e < offsets[v + 1]; e++) {
+                int w = nbrs[e];
+                if (stamp[w] == -2) continue;
+                stamp[w] = -2;
+                candidates.push_back(w);
+            }
+            std::sort(candidates.begin(), candidates.end(), [&](int a, int b) {
+                int da = degree(a), db = degree(b);
+                return da != db ? da < db : a < b;
+            });
+            for (size_t i = 0; i < candidates.size(); i++) new_to_old[placed++] = candidates[i];
+        }
+    }
+    std::reverse(new_to_old, new_to_old + n);
+}
+
+/** Spreads the low 10 bits of x to every third bit */
+inline uint32_t spread_bits(uint32_t x) {
+    x &= 0x3FF;
+    x = (x | (x << 16)) & 0x030000FF;
+    x = (x | (x << 8)) & 0x0300F00F;
+    x = (x | (x << 4)) & 0x030C30C3;
+    x = (x | (x << 2)) & 0x09249249;
+    return x;
+}
+
+void morton_order(const Mesh* mesh, const int* vertices, int n, int* new_to_old) {
+    float lo[3] = {0.0f, 0.0f, 0.0f}, hi[3] = {0.0f, 0.0f, 0.0f};
+    for (int i = 0; i < n; i++) {
+        const float* p = &mesh->vertices[(size_t)(vertices ? vertices[i] : i) * 3];
+        for (int a = 0; a < 3; a++) {
+            if (i == 0 || p[a] < lo[a]) lo[a] = p[a];
+            if (i == 0 || p[a] > hi[a]) hi[a] = p[a];
+        }
+    }
+    float scale[3];
+    for (int a = 0; a < 3; a++) scale[a] = hi[a] > lo[a] ? 1023.0f / (hi[a] - lo[a]) : 0.0f;
+
+    std::vector<uint64_t> keys(n);
+    for (int i = 0; i < n; i++) {
+        const float* p = &mesh->vertices[(size_t)(vertices ? vertices[i] : i) * 3];
+        uint32_t code = 0;
+        for (int a = 0; a < 3; a++) code |= spread_bits((uint32_t)((p[a] - lo[a]) * scale[a])) << a;
+        keys[i] = (uint64_t)code << 32 | (uint32_t)i;
+    }
+    std::sort(keys.begin(), keys.end());
+    for (int i = 0; i < n; i++) new_to_old[i] = (int)(uint32_t)keys[i];
+}
+
+// Forsyth's constants: a 32-entry LRU cache, the last triangle's three
+// vertices scored flat
+const int CACHE_SIZE = 32;
+const float CACHE_DECAY_POWER = 1.5f;
+const float LAST_TRIANGLE_SCORE = 0.75f;
+const float VALENCE_BOOST_SCALE = 2.0f;
+const float VALENCE_BOOST_POWER = 0.5f;
+const int MAX_TABLED_VALENCE = 32;
+
+struct CacheScores {
+    float position[CACHE_SIZE];
+    float valence[MAX_TABLED_VALENCE];
+
+    CacheScores() {
+        for (int i = 0; i < CACHE_SIZE; i++) {
+            position[i] = i < 3 ? LAST_TRIANGLE_SCORE
+                                : powf(1.0f - (float)(i - 3) / (CACHE_SIZE - 3), CACHE_DECAY_POWER);
+        }
+        valence[0] = 0.0f;
+        for (int i = 1; i < MAX_TABLED_VALENCE; i++) valence[i] = VALENCE_BOOST_SCALE * powf((float)i, -VALENCE_BOOST_POWER);
+    }
+
+    /** Score of a vertex at cache position (-1 = not cached) used by live unemitted triangles */
+    float vertex(int position_in_cache, int live) const {
+        if (live == 0) return -1.0f;
+        float score = position_in_cache >= 0 ? position[position_in_cache] : 0.0f;
+        return score + (live < MAX_TABLED_VALENCE ? valence[live]
+                                                  : VALENCE_BOOST_SCALE * powf((float)live, -VALENCE_BOOST_POWER));
+    }
+};
+
+void vertex_cache_face_order(const int* tris, int num_faces, int n, int* new_to_old) {
+    static const CacheScores scores;
+
+    // Unemitted triangles of each vertex: the first live[v] of its list
+    std::vector<int> offsets(n + 1, 0);
+    for (int i = 0; i < num_faces * 3; i++) offsets[tris[i] + 1]++;
+    for (int v = 0; v < n; v++) offsets[v + 1] += offsets[v];
+    std::vector<int> faces(offsets[n]);
+    std::vector<int> live(n, 0);
+    for (int f = 0; f < num_faces; f++) {
+        for (int k = 0; k < 3; k++) {
+            int v = tris[f * 3 + k];
+            faces[offsets[v] + live[v]++] = f;
+        }
+    }
+
+    std::vector<int> cache_position(n, -1);
+    std::vector<float> vertex_score(n);
+    for (int v = 0; v < n; v++) vertex_score[v] = scores.vertex(-1, live[v]);
+    std::vector<char> emitted(num_faces, 0);
+
+    int cache[CACHE_SIZE + 3];
+    int cache_used = 0;
+    int next_unemitted = 0;
+    int best = num_faces > 0 ? 0 : -1;
+    for (int out = 0; out < num_faces; out++) {
+        if (best < 0) {
+            while (emitted[next_unemitted]) next_unemitted++;
+            best = next_unemitted;
+        }
+        new_to_old[out] = best;
+        emitted[best] = 1;
+        const int* tri = &tris[best * 3];
+        for (int k = 0; k < 3; k++) {
+            int v = tri[k];
+            int* list = &faces[offsets[v]];
+            for (int i = 0; i < live[v]; i++) {
+                if (list[i] == best) {
+                    list[i] = list[--live[v]];
+                    break;
+                }
+            }
+        }
+
+        // The triangle's corners move to the front, the rest shift back
+        int next_cache[CACHE_SIZE + 3];
+        int next_used = 0;
+        for (int k = 0; k < 3; k++) {
+            if (k > 0 && (tri[k] == tri[0] || (k == 2 && tri[2] == tri[1]))) continue;
+            next_cache[next_used++] = tri[k];
+        }
+        for (int i = 0; i < cache_used; i++) {
+            int v = cache[i];
+            if (v != tri[0] && v != tri[1] && v != tri[2]) next_cache[next_used++] = v;
+        }
+        for (int i = 0; i < next_used; i++) {
+            int v = next_cache[i];
+            cache_position[v] = i < CACHE_SIZE ? i : -1;
+            vertex_score[v] = scores.vertex(cache_position[v], live[v]);
+        }
+        cache_used = next_used < CACHE_SIZE ? next_used : CACHE_SIZE;
+        memcpy(cache, next_cache, (size_t)cache_used * sizeof(int));
+
+        // Best triangle around the cached vertices
+        best = -1;
+        float best_score = -1.0f;
+        for (int i = 0; i < cache_used; i++) {
+            int v = cache[i];
+            const int* list = &faces[offsets[v]];
+            for (int j = 0; j < live[v]; j++) {
+                const int* t = &tris[list[j] * 3];
+                float score = vertex_score[t[0]] + vertex_score[t[1]] + vertex_score[t[2]];
+                if (score > best_score) {
+                    best_score = score;
+                    best = list[j];
+                }
+            }
+        }
+    }
+}
+
+/** Vertices numbered in the order faces (in face_order) first use them; unused ones last */
+void first_use_vertex_order(const int* tris, int num_faces, const int* face_order, int n, int* new_to_old) {
+    std::vector<char> seen(n, 0);
+    int placed = 0;
+    for (int i = 0; i < num_faces; i++) {
+        const int* tri = &tris[face_order[i] * 3];
+        for (int k = 0; k < 3; k++) {
+            if (seen[tri[k]]) continue;
+            seen[tri[k]] = 1;
+            new_to_old[placed++] = tri[k];
+        }
+    }
+    for (int v = 0; v < n; v++) {
+        if (!seen[v]) new_to_old[placed++] = v;
+    }
+}
+
+} // namespace
+
+namespace uvunwrap {
+
+bool locality_vertex_order(int order, const Mesh* mesh, const int* vertices, const int* tris, int num_faces,
+                           int n, int* new_to_old) {
+    switch (order) {
+        case VERTEX_ORDER_RCM:
+            rcm_order(tris, num_faces, n, new_to_old);
+            return true;
+        case VERTEX_ORDER_MORTON:
+            morton_order(mesh, vertices, n, new_to_old);
+            return true;
+        case VERTEX_ORDER_CACHE: {
+            std::vector<int> face_order(num_faces);
+            vertex_cache_face_order(tris, num_faces, n, face_order.data());
+            first_use_vertex_order(tris, num_faces, face_order.data(), n, new_to_old);
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+void locality_face_order(const int* tris, int num_faces, int n, const int* old_to_new, int* new_to_old) {
+    // Counting sort on the lowest new corner keeps ties in input order
+    std::vector<int> start(n + 1, 0);
+    std::vector<int> key(num_faces);
+    for (int f = 0; f < num_faces; f++) {
+        const int* tri = &tris[f * 3];
+        key[f] = std::min(old_to_new[tri[0]], std::min(old_to_new[tri[1]], old_to_new[tri[2]]));
+        start[key[f] + 1]++;
+    }
+    for (int v = 0; v < n; v++) start[v + 1] += start[v];
+    for (int f = 0; f < num_faces; f++) new_to_old[start[key[f]]++] = f;
+}
+
+} // namespace uvunwrap
+
+Mesh* reorder_mesh(const Mesh* mesh, int order, int* vertex_remap_out, int* face_remap_out) {
+    if (!mesh || !mesh->vertices || !mesh->triangles || mesh->num_vertices < 0 || mesh->num_triangles < 0) {
+        return NULL;
+    }
+    int V = mesh->num_vertices;
+    int F = mesh->num_triangles;
+
+    // The cache order picks faces first and numbers vertices after them
+    std::vector<int> vertex_order(V);
+    std::vector<int> face_order(F);
+    bool faces_first = order == VERTEX_ORDER_CACHE;
+    bool reordered;
+    if (faces_first) {
+        vertex_cache_face_order(mesh->triangles, F, V, face_order.data());
+        first_use_vertex_order(mesh->triangles, F, face_order.data(), V, vertex_order.data());
+        reordered = true;
+    } else {
+        reordered = uvunwrap::locality_vertex_order(order, mesh, NULL, mesh->triangles, F, V, vertex_order.data());
+    }
+    if (!reordered) {
+        for (int v = 0; v < V; v++) vertex_order[v] = v;
+    }
+    std::vector<int> local_remap(vertex_remap_out ? 0 : V);
+    int* remap = vertex_remap_out ? vertex_remap_out : local_remap.data();
+    for (int v = 0; v < V; v++) remap[vertex_order[v]] = v;
+
+    if (!faces_first && reordered) {
+        uvunwrap::locality_face_order(mesh->triangles, F, V, remap, face_order.data());
+    } else if (!faces_first) {
+        for (int f = 0; f < F; f++) face_order[f] = f;
+    }
+
+    Mesh* out = (Mesh*)malloc(sizeof(Mesh));
+    out->num_vertices = V;
+    out->num_triangles = F;
+    out->vertices = (float*)malloc((size_t)(V > 0 ? V : 1) * 3 * sizeof(float));
+    out->uvs = mesh->uvs ? (float*)malloc((size_t)(V > 0 ? V : 1) * 2 * sizeof(float)) : NULL;
+    out->triangles = (int*)malloc((size_t)(F > 0 ? F : 1) * 3 * sizeof(int));
+    for (int v = 0; v < V; v++) {
+        memcpy(&out->vertices[v * 3], &mesh->vertices[vertex_order[v] * 3], 3 * sizeof(float));
+        if (out->uvs) memcpy(&out->uvs[v * 2], &mesh->uvs[vertex_order[v] * 2], 2 * sizeof(float));
+    }
+    for (int f = 0; f < F; f++) {
+        const int* tri = &mesh->triangles[face_order[f] * 3];
+        for (int k = 0; k < 3; k++) out->triangles[f * 3 + k] = remap[tri[k]];
+        if (face_remap_out) face_remap_out[face_order[f]] = f;
+    }
+
+    LOG_INFO("Reordered %d vertices and %d faces (order %d)", V, F, order);
+    return out;
+}
@@ -0,0 +1,248 @@
+/**
+ * @file mesh_view.cpp
+ * @brief Memoised mesh analyses built on first use
+ */
+
+#include "mesh_view.h"
+#include "mesh_view_internal.h"
+#include "logging.h"
+#include "trace.h"
+#include <stdlib.h>
+#include <string.h>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+struct SeamSet {
+    float angle_threshold;
+    int method;
+    int num_seams;
+    int* edges;
+};
+
+} // namespace
+
+struct MeshView {
+    const Mesh* mesh;
+    int num_threads;
+    mutable std::mutex lock;
+    MeshViewStats stats;
+
+    bool flags_built;
+    std::vector<unsigned char> face_flags;
+    int num_flagged_faces;
+
+    bool topology_built;
+    uvunwrap::HalfEdgeMesh half_edges;
+    TopologyInfo* topo;
+
+    AdjacencyInfo* adj;
+
+    bool defects_built;
+    ManifoldReport defects;
+
+    std::vector<SeamSet> seams;
+
+    // Islands of the last seam set asked for, and their loops
+    std::vector<int> island_seams;
+    IslandInfo* islands;
+    BoundaryLoops* loops;
+};
+
+namespace {
+
+const unsigned char* face_flags_locked(MeshView* view) {
+    if (!view->flags_built) {
+        UV_TRACE_ZONE("mesh view: flag faces");
+        int F = view->mesh->num_triangles;
+        view->face_flags.assign(F > 0 ? F : 1, 0);
+        view->num_flagged_faces = classify_faces(view->mesh, view->face_flags.data(), view->num_threads);
+        view->flags_built = true;
+        view->stats.face_flag_builds++;
+    }
+    return view->num_flagged_faces < 0 ? NULL : view->face_flags.data();
+}
+
+const TopologyInfo* topology_locked(MeshView* view) {
+    if (!view->topology_built) {
+        view->topology_built = true;
+        const unsigned char* flags = face_flags_locked(view);
+        if (!flags) return NULL;
+        UV_TRACE_ZONE("mesh view: topology");
+        view->stats.topology_builds++;
+        if (uvunwrap::build_half_edge_mesh(view->mesh, &view->half_edges, view->num_threads, flags)) {
+            view->topo = uvunwrap::topology_from_half_edges(view->half_edges, view->num_threads);
+        }
+        if (!view->topo) {
+            LOG_ERROR("mesh_view_topology: Failed to build topology");
+            return NULL;
+        }
+        validate_topology(view->mesh, view->topo);
+    }
+    return view->topo;
+}
+
+const IslandInfo* islands_locked(MeshView* view, const int* seam_edges, int num_seams) {
+    if (view->islands && (int)view->island_seams.size() == num_seams &&
+        (num_seams == 0 || memcmp(view->island_seams.data(), seam_edges, (size_t)num_seams * sizeof(int)) == 0)) {
+        return view->islands;
+    }
+    const TopologyInfo* topo = topology_locked(view);
+    if (!topo) return NULL;
+    UV_TRACE_ZONE("mesh view: islands");
+    free_islands(view->islands);
+    free_boundary_loops(view->loops);
+    view->loops = NULL;
+    view->islands = extract_islands(view->mesh, topo, seam_edges, num_seams);
+    view->island_seams.assign(seam_edges, seam_edges + num_seams);
+    view->stats.island_builds++;
+    return view->islands;
+}
+
+} // namespace
+
+MeshView* mesh_view_create(const Mesh* mesh, int num_threads) {
+    if (!mesh || !mesh->triangles || mesh->num_vertices <= 0 || mesh->num_triangles < 0) {
+        LOG_ERROR("mesh_view_create: Invalid mesh");
+        return NULL;
+    }
+    MeshView* view = new MeshView();
+    view->mesh = mesh;
+    view->num_threads = num_threads;
+    memset(&view->stats, 0, sizeof(view->stats));
+    view->flags_built = false;
+    view->num_flagged_faces = 0;
+    view->topology_built = false;
+    view->topo = NULL;
+    view->adj = NULL;
+    view->defects_built = false;
+    memset(&view->defects, 0, sizeof(view->defects));
+    view->islands = NULL;
+    view->loops = NULL;
+    return view;
+}
+
+void mesh_view_free(MeshView* view) {
+    if (!view) return;
+    free_topology(view->topo);
+    free_adjacency(view->adj);
+    for (size_t i = 0; i < view->seams.size(); i++) free(view->seams[i].edges);
+    free_islands(view->islands);
+    free_boundary_loops(view->loops);
+    delete view;
+}
+
+const Mesh* mesh_view_mesh(const MeshView* view) {
+    return view ? view->mesh : NULL;
+}
+
+const unsigned char* mesh_view_face_flags(MeshView* view, int* num_flagged_out) {
+    if (!view) return NULL;
+    std::lock_guard<std::mutex> guard(view->lock);
+    const unsigned char* flags = face_flags_locked(view);
+    if (num_flagged_out) *num_flagged_out = flags ? view->num_flagged_faces : 0;
+    return flags;
+}
+
+const TopologyInfo* mesh_view_topology(MeshView* view) {
+    if (!view) return NULL;
+    std::lock_guard<std::mutex> guard(view->lock);
+    return topology_locked(view);
+}
+
+const uvunwrap::HalfEdgeMesh* uvunwrap::mesh_view_half_edges(MeshView* view) {
+    if (!view) return NULL;
+    std::lock_guard<std::mutex> guard(view->lock);
+    return topology_locked(view) ? &view->half_edges : NULL;
+}
+
+const AdjacencyInfo* mesh_view_adjacency(MeshView* view) {
+    if (!view) return NULL;
+    std::lock_guard<std::mutex> guard(view->lock);
+    if (!view->adj) {
+        const TopologyInfo* topo = topology_locked(view);
+        if (!topo) return NULL;
+        UV_TRACE_ZONE("mesh view: adjacency");
+        view->adj = build_adjacency(view->mesh, topo);
+        view->stats.adjacency_builds++;
+    }
+    return view->adj;
+}
+
+const ManifoldReport* mesh_view_defects(MeshView* view) {
+    if (!view) return NULL;
+    std::lock_guard<std::mutex> guard(view->lock);
+    if (!view->defects_built) {
+        if (!topology_locked(view)) return NULL;
+        UV_TRACE_ZONE("mesh view: defects");
+        std::vector<int> corner_fan, fan_vertex;
+        uvunwrap::label_vertex_fans(view->half_edges, corner_fan, fan_vertex,
+                                    &view->defects.num_nonmanifold_vertices);
+        view->defects.num_nonmanifold_edges = view->half_edges.num_nonmanifold_edges;
+        view->defects_built = true;
+        view->stats.manifold_builds++;
+    }
+    return &view->defects;
+}
+
+const int* mesh_view_seams(MeshView* view, float angle_threshold, SeamMethod method, int* num_seams_out) {
+    if (num_seams_out) *num_seams_out = 0;
+    if (!view) return NULL;
+    std::lock_guard<std::mutex> guard(view->lock);
+    for (size_t i = 0; i < view->seams.size(); i++) {
+        const SeamSet& s = view->seams[i];
+        if (s.angle_threshold == angle_threshold && s.method == (int)method) {
+            if (num_seams_out) *num_seams_out = s.num_seams;
+            return s.edges;
+        }
+    }
+
+    const TopologyInfo* topo = topology_locked(view);
+    if (!topo) return NULL;
+    UV_TRACE_ZONE("mesh view: seams");
+    SeamSet s;
+    s.angle_threshold = angle_threshold;
+    s.method = (int)method;
+    s.num_seams = 0;
+    s.edges = uvunwrap::detect_seams_half_edge(view->mesh, topo, view->half_edges, angle_threshold, method,
+                                               &s.num_seams, view->face_flags.data(), SORT_POLICY_AUTO,
+                                               view->num_threads);
+    if (!s.edges) {
+        LOG_ERROR("mesh_view_seams: Failed to detect seams");
+        return NULL;
+    }
+    view->seams.push_back(s);
+    view->stats.seam_builds++;
+    if (num_seams_out) *num_seams_out = s.num_seams;
+    return s.edges;
+}
+
+const IslandInfo* mesh_view_islands(MeshView* view, const int* seam_edges, int num_seams) {
+    if (!view || num_seams < 0 || (num_seams > 0 && !seam_edges)) return NULL;
+    std::lock_guard<std::mutex> guard(view->lock);
+    return islands_locked(view, seam_edges, num_seams);
+}
+
+const BoundaryLoops* mesh_view_boundary_loops(MeshView* view) {
+    if (!view) return NULL;
+    std::lock_guard<std::mutex> guard(view->lock);
+    if (!view->loops) {
+        const TopologyInfo* topo = topology_locked(view);
+        if (!topo) return NULL;
+        UV_TRACE_ZONE("mesh view: boundary loops");
+        const IslandInfo* islands = view->islands;
+        view->loops = build_boundary_loops(view->mesh, topo, islands ? islands->face_island_ids : NULL,
+                                           islands ? islands->num_islands : 1);
+        view->stats.boundary_loop_builds++;
+    }
+    return view->loops;
+}
+
+void mesh_view_stats(const MeshView* view, MeshViewStats* stats_out) {
+    if (!stats_out) return;
+    memset(stats_out, 0, sizeof(*stats_out));
+    if (!view) return;
+    std::lock_guard<std::mutex> guard(view->lock);
+    *stats_out = view->stats;
+}
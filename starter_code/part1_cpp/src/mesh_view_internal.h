@@ -0,0 +1,24 @@
+/**
+ * @file mesh_view_internal.h
+ * @brief What the unwrap pipeline takes from a MeshView
+ *
+ * Not part of the public API.
+ */
+
+#ifndef UVUNWRAP_MESH_VIEW_INTERNAL_H
+#define UVUNWRAP_MESH_VIEW_INTERNAL_H
+
+#include "mesh_view.h"
+#include "half_edge.h"
+
+namespace uvunwrap {
+
+/**
+ * @brief The half-edges mesh_view_topology() was built from (built on demand)
+ * @return NULL on error
+ */
+const HalfEdgeMesh* mesh_view_half_edges(MeshView* view);
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_MESH_VIEW_INTERNAL_H */
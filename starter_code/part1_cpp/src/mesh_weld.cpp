@@ -0,0 +1,259 @@
+/**
+ * @file mesh_weld.cpp
+ * @brief Vertex welding on a parallel spatial hash grid
+ *
+ * 1. Cell coordinates of every vertex (cells epsilon wide; for an exact
+ *    weld the position bits themselves)
+ * 2. Cells claimed in an open-addressing table by compare-and-swap, the
+ *    first vertex to land in a cell naming its slot
+ * 3. Counting sort of vertices by slot
+ * 4. Each vertex scans the 27 cells around its own for the lowest-indexed
+ *    vertex within epsilon
+ * 5. One ordered pass resolves chains of merges and numbers survivors
+ * 6. Vertices and triangles are written in parallel
+ *
+ * Only steps 2-3 depend on thread timing, through slot placement and the
+ * order inside a cell, and step 4 takes a minimum over the cell, so the
+ * output is the same for any thread count.
+ */
+
+#include "mesh_weld.h"
+#include "parallel.h"
+#include "logging.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace {
+
+const int MIN_VERTICES_PER_THREAD = 65536;
+// Cell coordinates are clamped so neighbour offsets cannot overflow
+const double MAX_CELL_COORD = 4.0e18;
+
+struct Cell {
+    int64_t x, y, z;
+    bool operator==(const Cell& o) const { return x == o.x && y == o.y && z == o.z; }
+};
+
+inline uint64_t cell_hash(const Cell& c) {
+    uint64_t h = (uint64_t)c.x * 0x9E3779B185EBCA87ULL;
+    h ^= (uint64_t)c.y * 0xC2B2AE3D27D4EB4FULL;
+    h ^= (uint64_t)c.z * 0x165667B19E3779F9ULL;
+    h ^= h >> 29;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    return h ^ (h >> 32);
+}
+
+inline int64_t grid_coord(float value, double inv_cell) {
+    double q = floor((double)value * inv_cell);
+    if (q > MAX_CELL_COORD) q = MAX_CELL_COORD;
+    if (q < -MAX_CELL_COORD) q = -MAX_CELL_COORD;
+    return (int64_t)q;
+}
+
+inline int64_t bits_coord(float value) {
+    float canonical = value + 0.0f;  // -0 and +0 weld
+    int32_t bits;
+    memcpy(&bits, &canonical, sizeof(bits));
+    return bits;
+}
+
+/** Open-addressing cell table; a slot holds the vertex that claimed it */
+class CellTable {
+public:
+    CellTable(const std::vector<Cell>& cells, int capacity_for)
+        : cells_(cells) {
+        capacity_ = 16;
+        while (capacity_ < 2 * (size_t)capacity_for) capacity_ <<= 1;
+        slots_.reset(new std::atomic<int>[capacity_]);
+        for (size_t i = 0; i < capacity_; i++) slots_[i].store(-1, std::memory_order_relaxed);
+    }
+
+    size_t capacity() const { return capacity_; }
+
+    /** Slot of v's cell, claiming a free one if the cell is new */
+    size_t insert(int v) {
+        const Cell& c = cells_[v];
+        size_t s = cell_hash(c) & (capacity_ - 1);
+        for (;;) {
+            int owner = slots_[s].load(std::memory_order_acquire);
+            if (owner < 0) {
+                if (slots_[s].compare_exchange_strong(owner, v, std::memory_order_acq_rel)) return s;
+            }
+            if (cells_[owner] == c) return s;
+            s = (s + 1) & (capacity_ - 1);
+        }
+    }
+
+    /** Slot of cell c, or capacity() if no vertex lies in it */
+    size_t find(const Cell& c) const {
+        size_t s = cell_hash(c) & (capacity_ - 1);
+        for (;;) {
+            int owner = slots_[s].load(std::memory_order_relaxed);
+            if (owner < 0) return capacity_;
+            if (cells_[owner] == c) return s;
+            s = (s + 1) & (capacity_ - 1);
+        }
+    }
+
+private:
+    const std::vector<Cell>& cells_;
+    size_t capacity_;
+    std::unique_ptr<std::atomic<int>[]> slots_;
+};
+
+} // namespace
+
+Mesh* weld_vertices(const Mesh* mesh,
+                    float epsilon,
+                    int num_threads,
+                    int* remap_out,
+                    MeshWeldStats* stats_out) {
+    if (!mesh || mesh->num_vertices < 0 || mesh->num_triangles < 0 ||
+        (mesh->num_vertices > 0 && !mesh->vertices) || (mesh->num_triangles > 0 && !mesh->triangles)) {
+        LOG_ERROR("weld_vertices: Invalid mesh");
+        return NULL;
+    }
+    int V = mesh->num_vertices;
+    int F = mesh->num_triangles;
+    for (int c = 0; c < 3 * F; c++) {
+        if (mesh->triangles[c] < 0 || mesh->triangles[c] >= V) {
+            LOG_ERROR("weld_vertices: Triangle %d references vertex %d of %d", c / 3, mesh->triangles[c], V);
+            return NULL;
+        }
+    }
+    int threads = uvunwrap::choose_thread_count(V, num_threads, MIN_VERTICES_PER_THREAD);
+    bool exact = !(epsilon > 0.0f);
+    const float* pos = mesh->vertices;
+
+    // 1. Cell of every vertex
+    std::vector<Cell> cells(V);
+    double inv_cell = exact ? 0.0 : 1.0 / (double)epsilon;
+    uvunwrap::parallel_for_ranges(V, threads, [&](int, int begin, int end) {
+        for (int v = begin; v < end; v++) {
+            const float* p = &pos[v * 3];
+            cells[v] = exact ? Cell{bits_coord(p[0]), bits_coord(p[1]), bits_coord(p[2])}
+                             : Cell{grid_coord(p[0], inv_cell), grid_coord(p[1], inv_cell),
+                                    grid_coord(p[2], inv_cell)};
+        }
+    });
+
+    // 2-3. Claim cells, then counting sort vertices by slot
+    CellTable table(cells, V);
+    size_t capacity = table.capacity();
+    std::vector<int> slot_of(V);
+    std::unique_ptr<std::atomic<int>[]> cursor(new std::atomic<int>[capacity + 1]);
+    for (size_t s = 0; s <= capacity; s++) cursor[s].store(0, std::memory_order_relaxed);
+    uvunwrap::parallel_for_ranges(V, threads, [&](int, int begin, int end) {
+        for (int v = begin; v < end; v++) {
+            slot_of[v] = (int)table.insert(v);
+            cursor[slot_of[v] + 1].fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+    std::vector<int> offsets(capacity + 1, 0);
+    for (size_t s = 0; s < capacity; s++) {
+        offsets[s + 1] = offsets[s] + cursor[s + 1].load(std::memory_order_relaxed);
+        cursor[s].store(offsets[s], std::memory_order_relaxed);
+    }
+    std::vector<int> members(V > 0 ? V : 1);
+    uvunwrap::parallel_for_ranges(V, threads, [&](int, int begin, int end) {
+        for (int v = begin; v < end; v++) {
+            members[cursor[slot_of[v]].fetch_add(1, std::memory_order_relaxed)] = v;
+        }
+    });
+
+    // 4. Lowest-indexed vertex within epsilon
+    std::vector<int> target(V);
+    float eps2 = exact ? 0.0f : epsilon * epsilon;
+    int reach = exact ? 0 : 1;
+    uvunwrap::parallel_for_ranges(V, threads, [&](int, int begin, int end) {
+        for (int v = begin; v < end; v++) {
+            const float* p = &pos[v * 3];
+            int best = v;
+            for (int dx = -reach; dx <= reach; dx++) {
+                for (int dy = -reach; dy <= reach; dy++) {
+                    for (int dz = -reach; dz <= reach; dz++) {
+                        size_t s = table.find(Cell{cells[v].x + dx, cells[v].y + dy, cells[v].z + dz});
+                        if (s == capacity) continue;
+                        for (int i = offsets[s]; i < offsets[s + 1]; i++) {
+                            int u = members[i];
+                            if (u >= best) continue;
+                            const float* q = &pos[u * 3];
+                            float ddx = p[0] - q[0], ddy = p[1] - q[1], ddz = p[2] - q[2];
+                            if (ddx * ddx + ddy * ddy + ddz * ddz <= eps2) best = u;
+                        }
+                    }
+                }
+            }
+            target[v] = best;
+        }
+    });
+
+    // 5. Follow merges (targets are lower, so already resolved) and number survivors
+    std::vector<int> local_remap(remap_out ? 0 : V);
+    int* remap = remap_out ? remap_out : local_remap.data();
+    std::vector<int> survivors;
+    survivors.reserve(V);
+    for (int v = 0; v < V; v++) {
+        if (target[v] == v) {
+            remap[v] = (int)survivors.size();
+            survivors.push_back(v);
+        } else {
+            remap[v] = remap[target[v]];
+        }
+    }
+    int num_out = (int)survivors.size();
+
+    // 6. Output vertices, then triangles compacted per range in order
+    Mesh* out = (Mesh*)malloc(sizeof(Mesh));
+    out->num_vertices = num_out;
+    out->vertices = (float*)malloc((size_t)(num_out > 0 ? num_out : 1) * 3 * sizeof(float));
+    out->uvs = mesh->uvs ? (float*)malloc((size_t)(num_out > 0 ? num_out : 1) * 2 * sizeof(float)) : NULL;
+    int out_threads = uvunwrap::choose_thread_count(num_out, num_threads, MIN_VERTICES_PER_THREAD);
+    uvunwrap::parallel_for_ranges(num_out, out_threads, [&](int, int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            memcpy(&out->vertices[i * 3], &pos[survivors[i] * 3], 3 * sizeof(float));
+            if (out->uvs) memcpy(&out->uvs[i * 2], &mesh->uvs[survivors[i] * 2], 2 * sizeof(float));
+        }
+    });
+
+    int tri_threads = uvunwrap::choose_thread_count(F, num_threads, MIN_VERTICES_PER_THREAD);
+    std::vector<int> range_kept(tri_threads + 1, 0);
+    uvunwrap::parallel_for_ranges(F, tri_threads, [&](int t, int begin, int end) {
+        int kept = 0;
+        for (int f = begin; f < end; f++) {
+            const int* tri = &mesh->triangles[f * 3];
+            int a = remap[tri[0]], b = remap[tri[1]], c = remap[tri[2]];
+            if (a != b && b != c && c != a) kept++;
+        }
+        range_kept[t + 1] = kept;
+    });
+    for (int t = 0; t < tri_threads; t++) range_kept[t + 1] += range_kept[t];
+    int num_kept = range_kept[tri_threads];
+    out->num_triangles = num_kept;
+    out->triangles = (int*)malloc((size_t)(num_kept > 0 ? num_kept : 1) * 3 * sizeof(int));
+    uvunwrap::parallel_for_ranges(F, tri_threads, [&](int t, int begin, int end) {
+        int* dst = &out->triangles[(size_t)range_kept[t] * 3];
+        for (int f = begin; f < end; f++) {
+            const int* tri = &mesh->triangles[f * 3];
+            int a = remap[tri[0]], b = remap[tri[1]], c = remap[tri[2]];
+            if (a == b || b == c || c == a) continue;
+            dst[0] = a;
+            dst[1] = b;
+            dst[2] = c;
+            dst += 3;
+        }
+    });
+
+    LOG_INFO("Welded %d -> %d vertices (%d collapsed triangles removed)", V, num_out, F - num_kept);
+    if (stats_out) {
+        stats_out->num_input_vertices = V;
+        stats_out->num_output_vertices = num_out;
+        stats_out->num_removed_triangles = F - num_kept;
+    }
+    return out;
+}
@@ -0,0 +1,414 @@
+/**
+ * @file metrics.cpp
+ * @brief UV quality metrics: stretch, Sander L2/L∞ stretch, angle distortion, coverage
+ *
+ * Faces are processed in fixed-size blocks. Each block is gathered into
+ * structure-of-arrays scratch (edge vectors of the 3D and UV triangle),
+ * then the per-face kernel runs as straight-line loops over those arrays
+ * so the compiler can vectorise them. Sums are kept per fixed chunk of
+ * METRICS_CHUNK faces and the chunks are folded pairwise (parallel.h
+ * reduce_pairwise()), so the aggregates are the same for every thread
+ * count.
+ *
+ * For a face with 3D edges dp1, dp2 and UV edges duv1, duv2 the Jacobian
+ * of the UV→3D map has columns
+ *     Su = (dp1 * dv2 - dp2 * dv1) / det,  Sv = (dp2 * du1 - dp1 * du2) / det
+ * with det = du1 * dv2 - dv1 * du2. With a = Su·Su, b = Su·Sv, c = Sv·Sv
+ * the singular values are σ² = ((a + c) ± sqrt((a - c)² + 4b²)) / 2.
+ * Reference: "Texture Mapping Progressive Meshes", Sander et al. 2001.
+ *
+ * With the CUDA backend the per-face values come from the device
+ * (metrics_face.h, one thread per face) and are loaded into the same
+ * blocks, so the reduction below is shared by both backends.
+ *
+ * Histograms of the per-face stretch and angle error are recorded per
+ * chunk as well and merged in the same tree.
+ *
+ * island_areas() runs the same gather and stretch kernel and sums the
+ * face areas per island instead, for the density scaling of packing;
+ * the per-island sums run serially in face order.
+ */
+
+#include "unwrap.h"
+#include "metrics_face.h"
+#include "metrics_islands.h"
+#include "gpu_backend.h"
+#include "parallel.h"
+#include "logging.h"
+#include <limits.h>
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+using uvunwrap::DEGENERATE_SIGMA;
+using uvunwrap::DEGENERATE_UV_DET;
+using uvunwrap::corner_angle;
+
+namespace {
+
+const int METRICS_BLOCK = 256;
+const int METRICS_CHUNK = 16 * METRICS_BLOCK;
+const int METRICS_MIN_FACES_PER_THREAD = 16384;
+const int METRICS_COVERAGE_RESOLUTION = 1024;
+
+// COMPUTE_BACKEND_AUTO runs the per-face kernels on the GPU from this
+// many faces on; below it the upload costs more than the CPU pass
+const int METRICS_GPU_MIN_FACES = 1 << 18;
+
+/** Partial sums of one chunk of faces */
+struct MetricsPartial {
+    double area_3d;            // 3D area of valid faces
+    double area_uv;            // UV area of valid faces
+    double stretch_sum;        // Σ A3d · σmax/σmin
+    double l2_sum;             // Σ A3d · (σmax² + σmin²) / 2
+    double angle_sum;          // Σ A3d · angle error
+    double max_stretch;
+    double max_sigma;          // unnormalised L∞
+    double max_angle;
+    int degenerate;
+};
+
+/** SoA scratch for one block of faces */
+struct MetricsBlock {
+    double p1x[METRICS_BLOCK], p1y[METRICS_BLOCK], p1z[METRICS_BLOCK];
+    double p2x[METRICS_BLOCK], p2y[METRICS_BLOCK], p2z[METRICS_BLOCK];
+    double u1[METRICS_BLOCK], v1[METRICS_BLOCK];
+    double u2[METRICS_BLOCK], v2[METRICS_BLOCK];
+
+    double area_3d[METRICS_BLOCK];
+    double area_uv[METRICS_BLOCK];
+    double ratio[METRICS_BLOCK];       // σmax/σmin, 0 if degenerate
+    double l2_sq[METRICS_BLOCK];       // (σmax² + σmin²) / 2
+    double sigma_max[METRICS_BLOCK];
+    double angle[METRICS_BLOCK];
+    int valid[METRICS_BLOCK];
+};
+
+void gather_block(const Mesh* mesh, int begin, int count, MetricsBlock& block) {
+    const float* V = mesh->vertices;
+    const float* UV = mesh->uvs;
+    for (int k = 0; k < count; k++) {
+        const int* tri = &mesh->triangles[(size_t)(begin + k) * 3];
+        const float* p0 = &V[(size_t)tri[0] * 3];
+        const float* p1 = &V[(size_t)tri[1] * 3];
+        const float* p2 = &V[(size_t)tri[2] * 3];
+        const float* t0 = &UV[(size_t)tri[0] * 2];
+        const float* t1 = &UV[(size_t)tri[1] * 2];
+        const float* t2 = &UV[(size_t)tri[2] * 2];
+        block.p1x[k] = (double)p1[0] - p0[0];
+        block.p1y[k] = (double)p1[1] - p0[1];
+        block.p1z[k] = (double)p1[2] - p0[2];
+        block.p2x[k] = (double)p2[0] - p0[0];
+        block.p2y[k] = (double)p2[1] - p0[1];
+        block.p2z[k] = (double)p2[2] - p0[2];
+        block.u1[k] = (double)t1[0] - t0[0];
+        block.v1[k] = (double)t1[1] - t0[1];
+        block.u2[k] = (double)t2[0] - t0[0];
+        block.v2[k] = (double)t2[1] - t0[1];
+    }
+}
+
+/** Branch-free Jacobian / singular value kernel over one gathered block */
+void stretch_kernel(int count, MetricsBlock& b) {
+    for (int k = 0; k < count; k++) {
+        double det = b.u1[k] * b.v2[k] - b.v1[k] * b.u2[k];
+        double ok_det = fabs(det) >= DEGENERATE_UV_DET ? 1.0 : 0.0;
+        double inv = ok_det / (ok_det > 0.0 ? det : 1.0);
+
+        double sux = (b.p1x[k] * b.v2[k] - b.p2x[k] * b.v1[k]) * inv;
+        double suy = (b.p1y[k] * b.v2[k] - b.p2y[k] * b.v1[k]) * inv;
+        double suz = (b.p1z[k] * b.v2[k] - b.p2z[k] * b.v1[k]) * inv;
+        double svx = (b.p2x[k] * b.u1[k] - b.p1x[k] * b.u2[k]) * inv;
+        double svy = (b.p2y[k] * b.u1[k] - b.p1y[k] * b.u2[k]) * inv;
+        double svz = (b.p2z[k] * b.u1[k] - b.p1z[k] * b.u2[k]) * inv;
+
+        double a = sux * sux + suy * suy + suz * suz;
+        double c = svx * svx + svy * svy + svz * svz;
+        double m = sux * svx + suy * svy + suz * svz;
+        double root = sqrt((a - c) * (a - c) + 4.0 * m * m);
+        double smax = sqrt(std::max(0.5 * (a + c + root), 0.0));
+        double smin = sqrt(std::max(0.5 * (a + c - root), 0.0));
+
+        double cx = b.p1y[k] * b.p2z[k] - b.p1z[k] * b.p2y[k];
+        double cy = b.p1z[k] * b.p2x[k] - b.p1x[k] * b.p2z[k];
+        double cz = b.p1x[k] * b.p2y[k] - b.p1y[k] * b.p2x[k];
+
+        double ok = ok_det > 0.0 && smin >= DEGENERATE_SIGMA ? 1.0 : 0.0;
+        b.valid[k] = ok > 0.0;
+        b.area_3d[k] = ok * 0.5 * sqrt(cx * cx + cy * cy + cz * cz);
+        b.area_uv[k] = ok * 0.5 * fabs(det);
+        b.ratio[k] = ok * smax / (ok > 0.0 ? smin : 1.0);
+        b.l2_sq[k] = ok * 0.5 * (a + c);
+        b.sigma_max[k] = ok * smax;
+    }
+}
+
+/** Largest corner angle error per face (valid faces only) */
+void angle_kernel(int count, MetricsBlock& b) {
+    for (int k = 0; k < count; k++) {
+        // Edges p0->p1, p0->p2 and p1->p2 in both spaces
+        double ex = b.p2x[k] - b.p1x[k], ey = b.p2y[k] - b.p1y[k], ez = b.p2z[k] - b.p1z[k];
+        double eu = b.u2[k] - b.u1[k], ev = b.v2[k] - b.v1[k];
+
+        double a0 = corner_angle(b.p1x[k], b.p1y[k], b.p1z[k], b.p2x[k], b.p2y[k], b.p2z[k]);
+        double a1 = corner_angle(-b.p1x[k], -b.p1y[k], -b.p1z[k], ex, ey, ez);
+        double t0 = corner_angle(b.u1[k], b.v1[k], 0.0, b.u2[k], b.v2[k], 0.0);
+        double t1 = corner_angle(-b.u1[k], -b.v1[k], 0.0, eu, ev, 0.0);
+        // Angles sum to π in both triangles
+        double a2 = M_PI - a0 - a1;
+        double t2 = M_PI - t0 - t1;
+
+        double d = std::max(fabs(a0 - t0), std::max(fabs(a1 - t1), fabs(a2 - t2)));
+        b.angle[k] = b.valid[k] ? d : 0.0;
+    }
+}
+
+/** Per-face values computed on the GPU, one array per MetricsBlock field */
+struct DeviceFaceValues {
+    std::vector<double> area_3d, area_uv, ratio, l2_sq, sigma_max, angle;
+    std::vector<int> valid;
+
+    bool compute(const Mesh* mesh) {
+        size_t F = (size_t)mesh->num_triangles;
+        area_3d.resize(F);
+        area_uv.resize(F);
+        ratio.resize(F);
+        l2_sq.resize(F);
+        sigma_max.resize(F);
+        angle.resize(F);
+        valid.resize(F);
+        uvunwrap::GpuFaceMetrics out;
+        out.area_3d = area_3d.data();
+        out.area_uv = area_uv.data();
+        out.ratio = ratio.data();
+        out.l2_sq = l2_sq.data();
+        out.sigma_max = sigma_max.data();
+        out.angle = angle.data();
+        out.valid = valid.data();
+        return uvunwrap::gpu_face_metrics(mesh, out);
+    }
+
+    void load(int begin, int count, MetricsBlock& block) const {
+        size_t bytes = (size_t)count * sizeof(double);
+        memcpy(block.area_3d, &area_3d[begin], bytes);
+        memcpy(block.area_uv, &area_uv[begin], bytes);
+        memcpy(block.ratio, &ratio[begin], bytes);
+        memcpy(block.l2_sq, &l2_sq[begin], bytes);
+        memcpy(block.sigma_max, &sigma_max[begin], bytes);
+        memcpy(block.angle, &angle[begin], bytes);
+        memcpy(block.valid, &valid[begin], (size_t)count * sizeof(int));
+    }
+};
+
+} // namespace
+
+void compute_quality_metrics_with_histograms(const Mesh* mesh,
+                                             UnwrapResult* result,
+                                             FaceMetrics* faces_out,
+                                             MetricsHistograms* histograms,
+                                             int num_threads,
+                                             int backend) {
+    if (!mesh || !result || !mesh->uvs) return;
+
+    int F = mesh->num_triangles;
+    int threads = uvunwrap::choose_thread_count(F, num_threads, METRICS_MIN_FACES_PER_THREAD);
+    std::vector<MetricsPartial> partials((size_t)(F + METRICS_CHUNK - 1) / METRICS_CHUNK);
+    if (!partials.empty()) memset(partials.data(), 0, partials.size() * sizeof(MetricsPartial));
+
+    // One histogram pair per chunk, only for the histograms asked for
+    bool record_stretch = histograms && histograms->stretch;
+    bool record_angle = histograms && histograms->angle_distortion;
+    std::vector<UvHistogram> stretch_histograms(record_stretch ? partials.size() : 0);
+    std::vector<UvHistogram> angle_histograms(record_angle ? partials.size() : 0);
+    for (size_t c = 0; c < stretch_histograms.size(); c++) uv_histogram_clear(&stretch_histograms[c]);
+    for (size_t c = 0; c < angle_histograms.size(); c++) uv_histogram_clear(&angle_histograms[c]);
+
+    bool try_gpu = backend == COMPUTE_BACKEND_CUDA ||
+                   (backend == COMPUTE_BACKEND_AUTO && F >= METRICS_GPU_MIN_FACES);
+    DeviceFaceValues device;
+    bool on_gpu = false;
+    if (try_gpu && uvunwrap::gpu_available()) {
+        on_gpu = device.compute(mesh);
+        if (!on_gpu) LOG_WARNING("compute_quality_metrics: GPU kernels failed, using the CPU");
+    }
+
+    // First pass: per-face values and partial sums. The Sander values depend
+    // on the global UV/3D area ratio, so per-face L2/L∞ are scaled afterwards.
+    uvunwrap::parallel_for_chunks(F, METRICS_CHUNK, threads, [&](int chunk, int begin, int end) {
+        MetricsPartial& p = partials[chunk];
+        std::vector<MetricsBlock> storage(1);
+        MetricsBlock& block = storage[0];
+
+        for (int start = begin; start < end; start += METRICS_BLOCK) {
+            int count = std::min(METRICS_BLOCK, end - start);
+            if (on_gpu) {
+                device.load(start, count, block);
+            } else {
+                gather_block(mesh, start, count, block);
+                stretch_kernel(count, block);
+                angle_kernel(count, block);
+            }
+
+            for (int k = 0; k < count; k++) {
+                p.area_3d += block.area_3d[k];
+                p.area_uv += block.area_uv[k];
+                p.stretch_sum += block.area_3d[k] * block.ratio[k];
+                p.l2_sum += block.area_3d[k] * block.l2_sq[k];
+                p.angle_sum += block.area_3d[k] * block.angle[k];
+                p.max_stretch = std::max(p.max_stretch, block.ratio[k]);
+                p.max_sigma = std::max(p.max_sigma, block.sigma_max[k]);
+                p.max_angle = std::max(p.max_angle, block.angle[k]);
+                p.degenerate += !block.valid[k];
+            }
+
+            for (int k = 0; record_stretch && k < count; k++) {
+                if (block.valid[k]) uv_histogram_record(&stretch_histograms[chunk], block.ratio[k]);
+            }
+            for (int k = 0; record_angle && k < count; k++) {
+                if (block.valid[k]) uv_histogram_record(&angle_histograms[chunk], block.angle[k]);
+            }
+
+            if (faces_out) {
+                for (int k = 0; k < count; k++) {
+                    int f = start + k;
+                    if (faces_out->stretch) faces_out->stretch[f] = (float)block.ratio[k];
+                    if (faces_out->stretch_l2) faces_out->stretch_l2[f] = (float)sqrt(block.l2_sq[k]);
+                    if (faces_out->stretch_linf) faces_out->stretch_linf[f] = (float)block.sigma_max[k];
+                    if (faces_out->angle_distortion) faces_out->angle_distortion[f] = (float)block.angle[k];
+                }
+            }
+        }
+    });
+
+    uvunwrap::reduce_pairwise(partials, [](MetricsPartial& total, const MetricsPartial& p) {
+        total.area_3d += p.area_3d;
+        total.area_uv += p.area_uv;
+        total.stretch_sum += p.stretch_sum;
+        total.l2_sum += p.l2_sum;
+        total.angle_sum += p.angle_sum;
+        total.max_stretch = std::max(total.max_stretch, p.max_stretch);
+        total.max_sigma = std::max(total.max_sigma, p.max_sigma);
+        total.max_angle = std::max(total.max_angle, p.max_angle);
+        total.degenerate += p.degenerate;
+    });
+    MetricsPartial total;
+    memset(&total, 0, sizeof(total));
+    if (!partials.empty()) total = partials[0];
+
+    // Folded like the partials, so the sums do not depend on the thread count either
+    uvunwrap::reduce_pairwise(stretch_histograms, [](UvHistogram& into, const UvHistogram& from) {
+        uv_histogram_merge(&into, &from);
+    });
+    uvunwrap::reduce_pairwise(angle_histograms, [](UvHistogram& into, const UvHistogram& from) {
+        uv_histogram_merge(&into, &from);
+    });
+    if (!stretch_histograms.empty()) uv_histogram_merge(histograms->stretch, &stretch_histograms[0]);
+    if (!angle_histograms.empty()) uv_histogram_merge(histograms->angle_distortion, &angle_histograms[0]);
+
+    // Sander stretch is measured after scaling the UVs to the surface area,
+    // so an isometry up to a uniform scale scores 1
+    double scale = total.area_3d > 0.0 ? sqrt(total.area_uv / total.area_3d) : 0.0;
+
+    if (faces_out && scale != 1.0) {
+        float fscale = (float)scale;
+        uvunwrap::parallel_for_ranges(F, threads, [&](int, int begin, int end) {
+            for (int f = begin; f < end; f++) {
+                if (faces_out->stretch_l2) faces_out->stretch_l2[f] *= fscale;
+                if (faces_out->stretch_linf) faces_out->stretch_linf[f] *= fscale;
+            }
+        });
+    }
+
+    // Faces but none measured: the layout collapsed (or the mesh has no
+    // area), which must not read as a perfect score
+    bool any = total.area_3d > 0.0;
+    float no_stretch = F > 0 ? INFINITY : 1.0f;
+    float no_angle = F > 0 ? INFINITY : 0.0f;
+    result->avg_stretch = any ? (float)(total.stretch_sum / total.area_3d) : no_stretch;
+    result->max_stretch = any ? (float)total.max_stretch : no_stretch;
+    result->stretch_l2 = any ? (float)(sqrt(total.l2_sum / total.area_3d) * scale) : no_stretch;
+    result->stretch_linf = any ? (float)(total.max_sigma * scale) : no_stretch;
+    result->angle_distortion = any ? (float)(total.angle_sum / total.area_3d) : no_angle;
+    result->max_angle_distortion = any ? (float)total.max_angle : no_angle;
+    result->num_degenerate_faces = total.degenerate;
+    result->uv_density = (float)scale;
+
+    UvCoverage* coverage = compute_uv_coverage_ex(mesh, result->face_island_ids, result->num_islands,
+                                                  METRICS_COVERAGE_RESOLUTION, num_threads, backend);
+    result->coverage = coverage ? coverage->coverage : 0.0f;
+    result->overlap = coverage ? coverage->overlap : 0.0f;
+    free_uv_coverage(coverage);
+
+    LOG_INFO("Quality metrics:");
+    LOG_INFO("  Avg stretch: %.2f (max %.2f)", result->avg_stretch, result->max_stretch);
+    LOG_INFO("  Sander L2: %.3f, Linf: %.3f", result->stretch_l2, result->stretch_linf);
+    LOG_INFO("  Angle distortion: %.3f rad (max %.3f)", result->angle_distortion,
+             result->max_angle_distortion);
+    LOG_INFO("  Coverage: %.1f%% (overlap %.1f%%)", result->coverage * 100, result->overlap * 100);
+    if (total.degenerate > 0) LOG_DEBUG("  Degenerate faces skipped: %d", total.degenerate);
+}
+
+void compute_quality_metrics_with_backend(const Mesh* mesh,
+                                          UnwrapResult* result,
+                                          FaceMetrics* faces_out,
+                                          int num_threads,
+                                          int backend) {
+    compute_quality_metrics_with_histograms(mesh, result, faces_out, NULL, num_threads, backend);
+}
+
+void compute_quality_metrics_ex(const Mesh* mesh,
+                                UnwrapResult* result,
+                                FaceMetrics* faces_out,
+                                int num_threads) {
+    compute_quality_metrics_with_backend(mesh, result, faces_out, num_threads, COMPUTE_BACKEND_AUTO);
+}
+
+void compute_quality_metrics(const Mesh* mesh, UnwrapResult* result) {
+    compute_quality_metrics_ex(mesh, result, NULL, 0);
+}
+
+int texture_size_for_density(const UnwrapResult* result, float texels_per_unit) {
+    if (!result || !(result->uv_density > 0.0f) || !(texels_per_unit > 0.0f)) return 0;
+    double side = ceil((double)texels_per_unit / result->uv_density);
+    return side < (double)INT_MAX ? (int)side : INT_MAX;
+}
+
+void uvunwrap::island_areas(const Mesh* mesh, const int* face_island_ids, int num_islands,
+                            const float* face_weights, int num_threads, IslandAreas* out) {
+    out->area_3d.assign((size_t)num_islands, 0.0);
+    out->area_uv.assign((size_t)num_islands, 0.0);
+    out->weight.assign((size_t)num_islands, 1.0);
+    if (!mesh || !mesh->uvs || !face_island_ids || num_islands <= 0) return;
+
+    // Face areas in parallel, then per-island sums in face order
+    int F = mesh->num_triangles;
+    int threads = uvunwrap::choose_thread_count(F, num_threads, METRICS_MIN_FACES_PER_THREAD);
+    std::vector<double> face_areas((size_t)F * 2);
+    uvunwrap::parallel_for_ranges(F, threads, [&](int, int begin, int end) {
+        std::vector<MetricsBlock> storage(1);
+        MetricsBlock& block = storage[0];
+        for (int start = begin; start < end; start += METRICS_BLOCK) {
+            int count = std::min(METRICS_BLOCK, end - start);
+            gather_block(mesh, start, count, block);
+            stretch_kernel(count, block);
+            for (int k = 0; k < count; k++) {
+                face_areas[(size_t)(start + k) * 2 + 0] = block.area_3d[k];
+                face_areas[(size_t)(start + k) * 2 + 1] = block.area_uv[k];
+            }
+        }
+    });
+
+    std::vector<double> weighted((size_t)num_islands, 0.0);
+    for (int f = 0; f < F; f++) {
+        int island = face_island_ids[f];
+        if (island < 0 || island >= num_islands) continue;
+        double area_3d = face_areas[(size_t)f * 2 + 0];
+        out->area_3d[island] += area_3d;
+        out->area_uv[island] += face_areas[(size_t)f * 2 + 1];
+        weighted[island] += area_3d * (face_weights ? (double)face_weights[f] : 1.0);
+    }
+    for (int i = 0; i < num_islands; i++) {
+        if (out->area_3d[i] > 0.0) out->weight[i] = weighted[i] / out->area_3d[i];
+    }
+}
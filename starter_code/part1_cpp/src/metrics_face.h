@@ -0,0 +1,119 @@
+/**
+ * @file metrics_face.h
+ * @brief Internal per-face stretch and angle math of the quality metrics
+ *
+ * Not part of the public API. metrics.cpp runs these formulas as SoA
+ * loops over blocks of faces; face_metrics() is the same computation for
+ * one face, which the CUDA backend runs one thread per face.
+ */
+
+#ifndef UVUNWRAP_METRICS_FACE_H
+#define UVUNWRAP_METRICS_FACE_H
+
+#include "gpu_backend.h"
+#include <math.h>
+
+namespace uvunwrap {
+
+// Thresholds from the metrics spec: such faces are skipped (constexpr so
+// device code can read them)
+constexpr double DEGENERATE_UV_DET = 1e-10;
+constexpr double DEGENERATE_SIGMA = 1e-10;
+
+constexpr double METRICS_PI = 3.14159265358979323846;
+
+/**
+ * @brief Branch-free acos, absolute error below 2e-8 rad
+ *
+ * Abramowitz & Stegun 4.4.46 on |x|, reflected for x < 0. Unlike libm
+ * acos it inlines, so the angle loop vectorises.
+ */
+UV_HOST_DEVICE inline double fast_acos(double x) {
+    x = x < -1.0 ? -1.0 : (x > 1.0 ? 1.0 : x);
+    double ax = fabs(x);
+    double p = -0.0012624911;
+    p = p * ax + 0.0066700901;
+    p = p * ax - 0.0170881256;
+    p = p * ax + 0.0308918810;
+    p = p * ax - 0.0501743046;
+    p = p * ax + 0.0889789874;
+    p = p * ax - 0.2145988016;
+    p = p * ax + 1.5707963050;
+    double r = sqrt(1.0 - ax) * p;
+    return x < 0.0 ? METRICS_PI - r : r;
+}
+
+/** Interior angle between edges (ax, ay, az) and (bx, by, bz) */
+UV_HOST_DEVICE inline double corner_angle(double ax, double ay, double az, double bx, double by, double bz) {
+    double dot = ax * bx + ay * by + az * bz;
+    double len = sqrt((ax * ax + ay * ay + az * az) * (bx * bx + by * by + bz * bz));
+    return fast_acos(len > 0.0 ? dot / len : 1.0);
+}
+
+/** Values of one face; every field is 0 for a degenerate face */
+struct FaceMetricValues {
+    double area_3d;
+    double area_uv;
+    double ratio;              // σmax/σmin
+    double l2_sq;              // (σmax² + σmin²) / 2
+    double sigma_max;
+    double angle;              // largest corner angle error
+    int valid;
+};
+
+/**
+ * @brief Stretch and angle error of a face from its edge vectors
+ *
+ * p1, p2: 3D edges p0->p1, p0->p2; (u1, v1), (u2, v2): the UV edges.
+ */
+UV_HOST_DEVICE inline FaceMetricValues face_metrics(double p1x, double p1y, double p1z,
+                                                    double p2x, double p2y, double p2z,
+                                                    double u1, double v1, double u2, double v2) {
+    FaceMetricValues out;
+    double det = u1 * v2 - v1 * u2;
+    double ok_det = fabs(det) >= DEGENERATE_UV_DET ? 1.0 : 0.0;
+    double inv = ok_det / (ok_det > 0.0 ? det : 1.0);
+
+    double sux = (p1x * v2 - p2x * v1) * inv;
+    double suy = (p1y * v2 - p2y * v1) * inv;
+    double suz = (p1z * v2 - p2z * v1) * inv;
+    double svx = (p2x * u1 - p1x * u2) * inv;
+    double svy = (p2y * u1 - p1y * u2) * inv;
+    double svz = (p2z * u1 - p1z * u2) * inv;
+
+    double a = sux * sux + suy * suy + suz * suz;
+    double c = svx * svx + svy * svy + svz * svz;
+    double m = sux * svx + suy * svy + suz * svz;
+    double root = sqrt((a - c) * (a - c) + 4.0 * m * m);
+    double smax = sqrt(fmax(0.5 * (a + c + root), 0.0));
+    double smin = sqrt(fmax(0.5 * (a + c - root), 0.0));
+
+    double cx = p1y * p2z - p1z * p2y;
+    double cy = p1z * p2x - p1x * p2z;
+    double cz = p1x * p2y - p1y * p2x;
+
+    double ok = ok_det > 0.0 && smin >= DEGENERATE_SIGMA ? 1.0 : 0.0;
+    out.valid = ok > 0.0;
+    out.area_3d = ok * 0.5 * sqrt(cx * cx + cy * cy + cz * cz);
+    out.area_uv = ok * 0.5 * fabs(det);
+    out.ratio = ok * smax / (ok > 0.0 ? smin : 1.0);
+    out.l2_sq = ok * 0.5 * (a + c);
+    out.sigma_max = ok * smax;
+
+    // Edges p0->p1, p0->p2 and p1->p2 in both spaces; angles sum to π
+    double ex = p2x - p1x, ey = p2y - p1y, ez = p2z - p1z;
+    double eu = u2 - u1, ev = v2 - v1;
+    double a0 = corner_angle(p1x, p1y, p1z, p2x, p2y, p2z);
+    double a1 = corner_angle(-p1x, -p1y, -p1z, ex, ey, ez);
+    double t0 = corner_angle(u1, v1, 0.0, u2, v2, 0.0);
+    double t1 = corner_angle(-u1, -v1, 0.0, eu, ev, 0.0);
+    double a2 = METRICS_PI - a0 - a1;
+    double t2 = METRICS_PI - t0 - t1;
+    double d = fmax(fabs(a0 - t0), fmax(fabs(a1 - t1), fabs(a2 - t2)));
+    out.angle = out.valid ? d : 0.0;
+    return out;
+}
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_METRICS_FACE_H */
@@ -0,0 +1,35 @@
+/**
+ * @file metrics_islands.h
+ * @brief Internal per-island areas from the quality metrics kernel
+ *
+ * Not part of the public API; used by packing.cpp to give islands a
+ * common texel density.
+ */
+
+#ifndef UVUNWRAP_METRICS_ISLANDS_H
+#define UVUNWRAP_METRICS_ISLANDS_H
+
+#include "mesh.h"
+#include <vector>
+
+namespace uvunwrap {
+
+/** Areas of each island, over the faces the metrics do not skip as degenerate */
+struct IslandAreas {
+    std::vector<double> area_3d;
+    std::vector<double> area_uv;
+    std::vector<double> weight;  /**< Area-weighted mean face weight (1 without weights) */
+};
+
+/**
+ * @brief Sum 3D and UV face areas per island
+ * @param face_island_ids Island per face; faces outside [0, num_islands) are skipped
+ * @param face_weights Optional weight per face (may be NULL)
+ * @param num_threads Worker threads (0 = automatic by face count)
+ */
+void island_areas(const Mesh* mesh, const int* face_island_ids, int num_islands,
+                  const float* face_weights, int num_threads, IslandAreas* out);
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_METRICS_ISLANDS_H */
@@ -0,0 +1,126 @@
+/**
+ * @file numa.cpp
+ * @brief NUMA node discovery and worker pinning (see numa.h)
+ */
+
+#include "numa.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace uvunwrap {
+
+namespace {
+
+// Nodes probed in sysfs; the ids may have gaps (offline nodes)
+const int MAX_NUMA_NODES = 256;
+
+/** CPUs of every node that has some, from /sys/devices/system/node */
+struct NumaTopology {
+    std::vector<std::vector<int> > node_cpus;
+    std::vector<int> cpu_node;  // by CPU id, -1 for CPUs of no listed node
+
+    NumaTopology() {
+#ifdef __linux__
+        for (int id = 0; id < MAX_NUMA_NODES; id++) {
+            char path[64];
+            snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", id);
+            FILE* file = fopen(path, "r");
+            if (!file) continue;
+            char list[4096];
+            std::vector<int> cpus;
+            if (fgets(list, sizeof(list), file)) parse_cpu_list(list, cpus);
+            fclose(file);
+            if (!cpus.empty()) node_cpus.push_back(cpus);
+        }
+#endif
+        if (node_cpus.size() <= 1) node_cpus.clear();
+        for (size_t node = 0; node < node_cpus.size(); node++) {
+            for (size_t i = 0; i < node_cpus[node].size(); i++) {
+                int cpu = node_cpus[node][i];
+                if (cpu >= (int)cpu_node.size()) cpu_node.resize((size_t)cpu + 1, -1);
+                cpu_node[cpu] = (int)node;
+            }
+        }
+    }
+
+    /** "0-3,8-11" -> 0 1 2 3 8 9 10 11 */
+    static void parse_cpu_list(const char* list, std::vector<int>& cpus) {
+        const char* p = list;
+        while (*p) {
+            char* end;
+            long first = strtol(p, &end, 10);
+            if (end == p) break;
+            long last = first;
+            p = end;
+            if (*p == '-') {
+                last = strtol(p + 1, &end, 10);
+                p = end;
+            }
+            for (long cpu = first; cpu <= last; cpu++) cpus.push_back((int)cpu);
+            if (*p != ',') break;
+            p++;
+        }
+    }
+};
+
+const NumaTopology& numa_topology() {
+    static const NumaTopology topology;
+    return topology;
+}
+
+} // namespace
+
+int numa_node_count() {
+    int nodes = (int)numa_topology().node_cpus.size();
+    return nodes > 0 ? nodes : 1;
+}
+
+int numa_current_node() {
+#ifdef __linux__
+    const NumaTopology& topology = numa_topology();
+    int cpu = sched_getcpu();
+    if (cpu >= 0 && cpu < (int)topology.cpu_node.size() && topology.cpu_node[cpu] >= 0) {
+        return topology.cpu_node[cpu];
+    }
+#endif
+    return 0;
+}
+
+bool numa_pin_thread(int node) {
+#ifdef __linux__
+    const NumaTopology& topology = numa_topology();
+    if (node < 0 || node >= (int)topology.node_cpus.size()) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    const std::vector<int>& cpus = topology.node_cpus[node];
+    for (size_t i = 0; i < cpus.size(); i++) {
+        if (cpus[i] < CPU_SETSIZE) CPU_SET(cpus[i], &set);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)node;
+    return false;
+#endif
+}
+
+int numa_place_worker(const NumaPlacement& placement, int worker, int num_workers) {
+    if (placement.policy == UNWRAP_NUMA_NONE) return -1;
+    int nodes = numa_node_count();
+    if (nodes <= 1) return -1;
+    int node = placement.node;
+    if (node < 0) node = (int)((long long)worker * nodes / (num_workers > 0 ? num_workers : 1));
+    if (!numa_pin_thread(node)) return -1;
+    NumaPlacement local;
+    local.policy = placement.policy;
+    local.node = node;
+    current_numa_placement() = local;
+    return node;
+}
+
+} // namespace uvunwrap
@@ -0,0 +1,111 @@
+/**
+ * @file numa.h
+ * @brief Internal NUMA node discovery, worker pinning and first-touch buffers
+ *
+ * Not part of the public API. A call chooses a placement (UnwrapNumaPolicy)
+ * with a ScopedNumaPlacement; like the log sink it is per thread, and the
+ * helpers that start workers (parallel.h, task_graph.h) hand it on through
+ * numa_place_worker(), which pins the new worker to its node. A pinned
+ * worker passes its own node on, so nested loops stay on that node.
+ *
+ * Linux places a page on the node of the thread that first writes it.
+ * FirstTouchVector leaves resized elements uninitialised, so the parallel
+ * loop that fills a buffer, not the thread that sized it, decides where
+ * its pages live. The node list comes from sysfs; elsewhere, or on a
+ * single node, there is one node and nothing is pinned.
+ */
+
+#ifndef UVUNWRAP_NUMA_H
+#define UVUNWRAP_NUMA_H
+
+#include "unwrap.h"
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace uvunwrap {
+
+/** Where the workers a thread starts run */
+struct NumaPlacement {
+    int policy = UNWRAP_NUMA_NONE;  /**< UnwrapNumaPolicy */
+    int node = -1;                  /**< >= 0: every worker stays on this node */
+};
+
+/** Placement installed on this thread */
+inline NumaPlacement& current_numa_placement() {
+    static thread_local NumaPlacement placement;
+    return placement;
+}
+
+/** Installs a placement on this thread for its lifetime */
+class ScopedNumaPlacement {
+public:
+    explicit ScopedNumaPlacement(const NumaPlacement& placement) : saved_(current_numa_placement()) {
+        current_numa_placement() = placement;
+    }
+    ~ScopedNumaPlacement() { current_numa_placement() = saved_; }
+    ScopedNumaPlacement(const ScopedNumaPlacement&) = delete;
+    ScopedNumaPlacement& operator=(const ScopedNumaPlacement&) = delete;
+
+private:
+    NumaPlacement saved_;
+};
+
+/** NUMA nodes with CPUs (1 where the topology is unknown) */
+int numa_node_count();
+
+/** Node of the CPU this thread is running on (0 if unknown) */
+int numa_current_node();
+
+/** Restrict this thread to the CPUs of node; false if that is not possible */
+bool numa_pin_thread(int node);
+
+/**
+ * @brief Place worker `worker` of num_workers, started under placement
+ *
+ * Called first thing on each started worker (never on the calling
+ * thread, which is the caller's to place). Under UNWRAP_NUMA_SPREAD the
+ * workers go to the nodes in contiguous blocks, so neighbouring worker
+ * indices, which take neighbouring ranges in parallel_for_ranges(), share
+ * a node; a placement with a node keeps them all there. The worker then
+ * hands its node on to the workers it starts.
+ *
+ * @return The worker's node, or -1 if it was not pinned
+ */
+int numa_place_worker(const NumaPlacement& placement, int worker, int num_workers);
+
+/**
+ * @brief std::allocator whose value-initialisation is default-initialisation
+ *
+ * resize() then leaves ints and floats unwritten, for the filling loop to
+ * touch first.
+ */
+template <typename T>
+struct FirstTouchAllocator : std::allocator<T> {
+    template <typename U>
+    struct rebind {
+        typedef FirstTouchAllocator<U> other;
+    };
+
+    FirstTouchAllocator() noexcept {}
+    template <typename U>
+    FirstTouchAllocator(const FirstTouchAllocator<U>&) noexcept {}
+
+    template <typename U>
+    void construct(U* p) noexcept(std::is_nothrow_default_constructible<U>::value) {
+        ::new ((void*)p) U;
+    }
+    template <typename U, typename... Args>
+    void construct(U* p, Args&&... args) {
+        ::new ((void*)p) U(std::forward<Args>(args)...);
+    }
+};
+
+template <typename T>
+using FirstTouchVector = std::vector<T, FirstTouchAllocator<T> >;
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_NUMA_H */
@@ -2,161 +2,234 @@
  * @file packing.cpp
  * @brief UV island packing into [0,1]² texture space
  *
- * SKELETON - YOU IMPLEMENT THIS
+ * Islands are packed by one of four engines (PackMethod):
+ * - Shelf: sort boxes by height, fill rows left to right, scale to fit
+ * - Skyline bottom-left and MaxRects best-short-side-fit (rect_pack.cpp):
+ *   pack bounding boxes into the smallest square found by bisection,
+ *   then scale it to [0,1]², keeping island_margin as the gap in final
+ *   UV units
+ * - Raster: conservative island silhouettes on a bit grid, dilated by the
+ *   margin, placed bottom-left with word-wide shift/AND tests; the side
+ *   is bisected below the MaxRects side
  *
- * Algorithm: Shelf packing
- * 1. Compute bounding box for each island
- * 2. Sort islands by height (descending)
- * 3. Pack using shelf algorithm
- * 4. Scale to fit [0,1]²
+ * Under ISLAND_SCALE_UNIFORM, scale_islands() first gives every island the
+ * same texel density, which the [0,1]² engines keep since they scale the
+ * whole sheet at once. pack_uv_islands_udim() always scales that way
+ * and spreads the boxes over UDIM tiles (one MaxRects or skyline bin per
+ * tile), writing the tile offset into the UVs.
+ *
+ * Before packing an island may be turned to the orientation of its
+ * minimum-area bounding box (rotating calipers over its convex hull);
+ * the engines can additionally place each box rotated by 90°. Boxes,
+ * hulls and orientations come from island_bounds.cpp, one island per
+ * worker. The box engines and UDIM only decide where each island goes;
+ * both turns, the move and the scale are then written in one pass per
+ * island by transform_islands() (island_transform.cpp).
  */
 
-#include "unwrap.h"
+#include "packing.h"
 #include "math_utils.h"
+#include "rect_pack.h"
+#include "parallel_sort.h"
+#include "parallel.h"
+#include "island_bounds.h"
+#include "island_transform.h"
+#include "metrics_islands.h"
+#include "trace.h"
+#include "logging.h"
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <stdio.h>
 #include <math.h>
 #include <float.h>
 #include <vector>
 #include <algorithm>
 
+/** Read-only run of indices inside an IslandLists array */
+struct IndexSpan {
+    const int* first;
+    const int* last;
+
+    const int* begin() const { return first; }
+    const int* end() const { return last; }
+    size_t size() const { return (size_t)(last - first); }
+    bool empty() const { return first == last; }
+    int operator[](size_t i) const { return first[i]; }
+};
+
 /**
  * @brief Island bounding box info
+ *
+ * Plain data, so sorting islands moves no heap blocks; the vertex and
+ * face lists live in the shared IslandLists.
  */
 struct Island {
     int id;
     float min_u, max_u, min_v, max_v;
     float width, height;
     float target_x, target_y;  // Packed position
-    std::vector<int> vertex_indices;
+    double angle;              // Minimum-area turn not yet written to the UVs
+    bool turned;               // Turned by 90° (width and height already swapped)
+    IndexSpan vertex_indices;
+    IndexSpan faces;
 };
 
-void pack_uv_islands(Mesh* mesh,
-                     const UnwrapResult* result,
-                     float margin) {
-    if (!mesh || !result || !mesh->uvs) return;
+/** Every island's vertices and faces, back to back (CSR) */
+struct IslandLists {
+    std::vector<int> vertex_offsets;
+    std::vector<int> vertices;
+    std::vector<int> face_offsets;
+    std::vector<int> faces;
+    std::vector<int> loose;  // Vertices of no island
+};
 
-    if (result->num_islands <= 1) {
-        // Single island, already normalized to [0,1]
+/** Copy an IslandBox into the island; an empty island gets a zero-size box */
+static void set_bounds(Island& isl, const uvunwrap::IslandBox& box) {
+    isl.min_u = box.min_u;
+    isl.max_u = box.max_u;
+    isl.min_v = box.min_v;
+    isl.max_v = box.max_v;
+    isl.angle = box.angle;
+    isl.turned = false;
+    if (isl.min_u == FLT_MAX) {
+        isl.width = 0;
+        isl.height = 0;
         return;
     }
+    isl.width = isl.max_u - isl.min_u;
+    isl.height = isl.max_v - isl.min_v;
+}
 
-    printf("Packing %d islands...\n", result->num_islands);
-
-    // TODO: Implement island packing
-    //
-    // ALGORITHM:
-    //
-    // STEP 1: Compute bounding box for each island
-    //   - For each island, find min/max U and V
-    //   - Compute width and height
-    //   - Track which vertices belong to each island
-    //
-    // STEP 2: Sort islands by height (descending)
-    //   - Larger islands first
-    //   - Use std::sort with custom comparator
-    //
-    // STEP 3: Shelf packing
-    //   - Create shelves (horizontal rows)
-    //   - Try to fit island in current shelf
-    //   - If doesn't fit, create new shelf below
-    //   - Track target_x, target_y for each island
-    //
-    // STEP 4: Move islands to packed positions
-    //   - For each island:
-    //       offset_x = target_x - current_min_u
-    //       offset_y = target_y - current_min_v
-    //   - Apply offset to all UVs in island
-    //
-    // STEP 5: Scale everything to fit [0,1]²
-    //   - Find max_width, max_height of packed result
-    //   - Scale all UVs by 1.0 / max(max_width, max_height)
-    //
-    // EXPECTED COVERAGE:
-    //   - Shelf packing: > 60%
-    //
-    // BONUS (+10 points):
-    //   - Implement MaxRects or Skyline packing for > 75% coverage
-
-    std::vector<Island> islands(result->num_islands);
+/**
+ * @brief Gather every island's vertices, faces and box
+ * @param min_area Give each island the box of its minimum-area
+ *        orientation; the turn is only recorded in Island::angle
+ */
+static void collect_islands(const Mesh* mesh,
+                            const UnwrapResult* result,
+                            std::vector<Island>& islands,
+                            IslandLists& lists,
+                            bool min_area,
+                            int num_threads) {
     int num_islands = result->num_islands;
-    
-    // Initialize islands
-    for (int i = 0; i < num_islands; i++) {
-        islands[i].id = i;
-        islands[i].min_u = FLT_MAX;
-        islands[i].max_u = -FLT_MAX;
-        islands[i].min_v = FLT_MAX;
-        islands[i].max_v = -FLT_MAX;
-        // Vertex indices not strictly needed if we just track UV bounds and offset later
-        // But to apply offset, we need to know which vertices to move.
-        // Since we have face_island_ids, we can iterate faces later again.
-        // OR store vertices here.
-        // Storing vertices is safer to avoid repeated updates.
-    }
-    
-    // STEP 1: Compute bounding boxes and collect vertices
-    // We assume mesh has split vertices, so each vertex belongs to exactly one island?
-    // If so, we can iterate vertices? No, we only have face mapping.
-    // Let's iterate faces.
-    
+    islands.resize(num_islands);
+
+    // Vertices are split along seams, so each one belongs to the island
+    // of the first face that references it. One pass counts, the second
+    // fills both lists in face order.
     std::vector<int> vert_to_island(mesh->num_vertices, -1);
-    
+    lists.vertex_offsets.assign((size_t)num_islands + 1, 0);
+    lists.face_offsets.assign((size_t)num_islands + 1, 0);
     for (int f = 0; f < mesh->num_triangles; f++) {
         int island_id = result->face_island_ids[f];
         if (island_id < 0 || island_id >= num_islands) continue;
-        
-        Island& island = islands[island_id];
-        
+        lists.face_offsets[island_id + 1]++;
         for (int j = 0; j < 3; j++) {
             int v = mesh->triangles[f * 3 + j];
-            
-            // Assign vertex to island (first time only)
             if (vert_to_island[v] == -1) {
                 vert_to_island[v] = island_id;
-                island.vertex_indices.push_back(v);
-                
-                float u = mesh->uvs[v * 2 + 0];
-                float v_coord = mesh->uvs[v * 2 + 1];
-                
-                island.min_u = min_float(island.min_u, u);
-                island.max_u = max_float(island.max_u, u);
-                island.min_v = min_float(island.min_v, v_coord);
-                island.max_v = max_float(island.max_v, v_coord);
+                lists.vertex_offsets[island_id + 1]++;
             }
         }
     }
-    
-    // Normalize dimensions
     for (int i = 0; i < num_islands; i++) {
-        Island& isl = islands[i];
-        // Check for empty islands
-        if (isl.min_u == FLT_MAX) {
-            isl.width = 0; 
-            isl.height = 0;
-            continue;
+        lists.vertex_offsets[i + 1] += lists.vertex_offsets[i];
+        lists.face_offsets[i + 1] += lists.face_offsets[i];
+    }
+    lists.vertices.resize((size_t)lists.vertex_offsets[num_islands]);
+    lists.faces.resize((size_t)lists.face_offsets[num_islands]);
+
+    std::vector<int> vertex_cursor(lists.vertex_offsets.begin(), lists.vertex_offsets.end() - 1);
+    std::vector<int> face_cursor(lists.face_offsets.begin(), lists.face_offsets.end() - 1);
+    for (int f = 0; f < mesh->num_triangles; f++) {
+        int island_id = result->face_island_ids[f];
+        if (island_id < 0 || island_id >= num_islands) continue;
+        lists.faces[face_cursor[island_id]++] = f;
+
+        for (int j = 0; j < 3; j++) {
+            int v = mesh->triangles[f * 3 + j];
+
+            // Assign vertex to island (first time only); -2 marks it placed
+            if (vert_to_island[v] == island_id) {
+                vert_to_island[v] = -2;
+                lists.vertices[vertex_cursor[island_id]++] = v;
+            }
         }
-        isl.width = isl.max_u - isl.min_u;
-        isl.height = isl.max_v - isl.min_v;
-        
-        // Add minimal margin to width/height to ensure spacing?
-        // Or apply margin during packing.
-        // Applying during packing is safer.
-    }
-
-    // STEP 2: Sort by height (descending)
-    // We need to sort but keep track of indices. 
-    // std::sort moves objects.
-    std::sort(islands.begin(), islands.end(), [](const Island& a, const Island& b) {
+    }
+    lists.loose.clear();
+    for (int v = 0; v < mesh->num_vertices; v++) {
+        if (vert_to_island[v] == -1) lists.loose.push_back(v);
+    }
+    for (int i = 0; i < num_islands; i++) {
+        const int* vertices = lists.vertices.data();
+        const int* faces = lists.faces.data();
+        islands[i].id = i;
+        islands[i].vertex_indices = {vertices + lists.vertex_offsets[i], vertices + lists.vertex_offsets[i + 1]};
+        islands[i].faces = {faces + lists.face_offsets[i], faces + lists.face_offsets[i + 1]};
+    }
+
+    std::vector<uvunwrap::IslandBox> boxes(num_islands);
+    uvunwrap::island_boxes(mesh->uvs, lists.vertex_offsets.data(), lists.vertices.data(), num_islands,
+                           min_area, num_threads, boxes.data());
+    for (int i = 0; i < num_islands; i++) set_bounds(islands[i], boxes[i]);
+}
+
+/**
+ * @brief Transform that applies an island's pending turns in place
+ * @param rotate_90 Also turn by 90° inside the box, whose height is
+ *        height before the turn
+ */
+static uvunwrap::IslandTransform pending_turns(const Island& isl, bool rotate_90, float height) {
+    uvunwrap::IslandTransform t = uvunwrap::identity_transform();
+    t.angle = isl.angle;
+    t.rotate_90 = rotate_90;
+    t.min_u = isl.min_u;
+    t.min_v = isl.min_v;
+    t.height = height;
+    return t;
+}
+
+/** Write every island's transform (indexed by island id) to the UVs */
+static void move_islands(Mesh* mesh, const IslandLists& lists,
+                         const std::vector<uvunwrap::IslandTransform>& transforms, int num_threads) {
+    uvunwrap::transform_islands(mesh->uvs, lists.vertex_offsets.data(), lists.vertices.data(),
+                                (int)transforms.size(), transforms.data(), num_threads);
+}
+
+/**
+ * @brief Write the minimum-area turns to the UVs, for engines that read
+ *        the island shapes
+ *
+ * Islands are still in id order here, so their lists line up with the
+ * CSR offsets.
+ */
+static void orient_min_area(Mesh* mesh, std::vector<Island>& islands, const IslandLists& lists,
+                            int num_threads) {
+    std::vector<uvunwrap::IslandTransform> transforms(islands.size());
+    for (size_t i = 0; i < islands.size(); i++) {
+        transforms[i] = pending_turns(islands[i], false, 0.0f);
+        islands[i].angle = 0.0;
+    }
+    move_islands(mesh, lists, transforms, num_threads);
+}
+
+static void shelf_pack(Mesh* mesh, std::vector<Island>& islands, const IslandLists& lists, float margin,
+                       int sort_threads, int num_threads) {
+    int num_islands = (int)islands.size();
+
+    // STEP 2: Sort by height (descending); stable, so equal heights keep
+    // island order for every thread count
+    uvunwrap::parallel_stable_sort(islands, [](const Island& a, const Island& b) {
         return a.height > b.height;
-    });
+    }, sort_threads);
 
     // STEP 3: Shelf packing
     float map_width = 1.0f; // Target
     float current_x = 0.0f;
     float current_y = 0.0f;
     float shelf_height = 0.0f;
-    
+
     // For final scaling
     float packed_max_w = 0.0f;
     float packed_max_h = 0.0f;
@@ -164,7 +237,7 @@ void pack_uv_islands(Mesh* mesh,
     for (int i = 0; i < num_islands; i++) {
         Island& isl = islands[i];
         if (isl.width == 0) continue;
-        
+
         // Check if fits in current shelf
         if (current_x + isl.width > map_width && current_x > 0) {
             // New shelf
@@ -172,87 +245,735 @@ void pack_uv_islands(Mesh* mesh,
             current_x = 0.0f;
             shelf_height = 0.0f;
         }
-        
+
         // Place here
         isl.target_x = current_x;
         isl.target_y = current_y;
-        
+
         // Update shelf
         current_x += isl.width + margin;
         shelf_height = max_float(shelf_height, isl.height);
-        
+
         packed_max_w = max_float(packed_max_w, isl.target_x + isl.width);
         packed_max_h = max_float(packed_max_h, isl.target_y + isl.height);
     }
-    
-    // STEP 4: Move islands
+
+    // STEP 4: Move islands and scale to [0,1] in one pass
+    float scale = 1.0f / max_float(packed_max_w, packed_max_h);
+    // Avoid inf
+    if (packed_max_w == 0) scale = 1.0f;
+
+    std::vector<uvunwrap::IslandTransform> transforms(islands.size());
     for (int i = 0; i < num_islands; i++) {
         const Island& isl = islands[i];
-        if (isl.width == 0) continue;
-        
-        float offset_x = isl.target_x - isl.min_u;
-        float offset_y = isl.target_y - isl.min_v;
-        
+        uvunwrap::IslandTransform& t = transforms[isl.id];
+        t = pending_turns(isl, isl.turned, isl.turned ? isl.width : isl.height);
+        if (isl.width != 0) {
+            t.add_u = isl.target_x - isl.min_u;
+            t.add_v = isl.target_y - isl.min_v;
+        }
+        t.scale = scale;
+    }
+    move_islands(mesh, lists, transforms, num_threads);
+
+    // The sheet scale reaches vertices outside every island too
+    for (int v : lists.loose) {
+        mesh->uvs[v * 2 + 0] *= scale;
+        mesh->uvs[v * 2 + 1] *= scale;
+    }
+}
+
+/** Move islands to their packed boxes and scale the square to [0,1]² */
+static void place_boxes(Mesh* mesh, const std::vector<Island>& islands, const IslandLists& lists,
+                        const std::vector<uvunwrap::PackPlacement>& placements, float side, int num_threads) {
+    float inv = 1.0f / side;
+    std::vector<uvunwrap::IslandTransform> transforms(islands.size());
+    for (size_t i = 0; i < islands.size(); i++) {
+        const Island& isl = islands[i];
+        uvunwrap::IslandTransform& t = transforms[isl.id];
+        t = pending_turns(isl, placements[i].rotated, isl.height);
+        t.add_u = placements[i].x;
+        t.add_v = placements[i].y;
+        t.sub_u = isl.min_u;
+        t.sub_v = isl.min_v;
+        t.scale = inv;
+    }
+    move_islands(mesh, lists, transforms, num_threads);
+}
+
+static void rect_pack(Mesh* mesh, std::vector<Island>& islands, const IslandLists& lists, float margin,
+                      int method, bool allow_rotate, int num_threads) {
+    std::vector<uvunwrap::PackRect> rects(islands.size());
+    for (size_t i = 0; i < islands.size(); i++) {
+        rects[i].w = islands[i].width;
+        rects[i].h = islands[i].height;
+    }
+
+    std::vector<uvunwrap::PackPlacement> placements;
+    float side = uvunwrap::pack_rects_square(rects, method, allow_rotate, margin, placements);
+    if (side <= 0.0f) {
+        orient_min_area(mesh, islands, lists, num_threads);
+        return;
+    }
+    place_boxes(mesh, islands, lists, placements, side, num_threads);
+}
+
+// ---------------------------------------------------------------------------
+// Silhouette (raster) packing
+// ---------------------------------------------------------------------------
+
+namespace {
+
+const int RASTER_MIN_GRID = 128;
+const int RASTER_MAX_GRID = 512;
+const int RASTER_CELLS_PER_ISLAND = 24;     // grid side ~ this * sqrt(islands)
+const int RASTER_BISECT_STEPS = 6;
+
+/** Island bitmap: `h` rows of `words` uint64_t, bit x of row y = cell (x, y) */
+struct IslandMask {
+    int w, h, words;
+    std::vector<uint64_t> bits;
+
+    void reset(int width, int height) {
+        w = width;
+        h = height;
+        words = (width + 63) >> 6;
+        bits.assign((size_t)words * height, 0);
+    }
+    uint64_t* row(int y) { return &bits[(size_t)y * words]; }
+    const uint64_t* row(int y) const { return &bits[(size_t)y * words]; }
+};
+
+inline void set_bits(uint64_t* row, int x0, int x1) {
+    for (int x = x0; x <= x1; x++) row[x >> 6] |= 1ULL << (x & 63);
+}
+
+/** dst |= src << shift over a row of dst_words words */
+inline void or_shifted(uint64_t* dst, int dst_words, const uint64_t* src, int src_words, int shift) {
+    int word = shift >> 6, bit = shift & 63;
+    for (int k = 0; k < src_words; k++) {
+        if (word + k < dst_words) dst[word + k] |= src[k] << bit;
+        if (bit && word + k + 1 < dst_words) dst[word + k + 1] |= src[k] >> (64 - bit);
+    }
+}
+
+/** Local island coordinates in cells after turning by rot * 90° */
+inline void turn(int rot, float lx, float ly, float w, float h, float& x, float& y) {
+    switch (rot) {
+        case 1: x = h - ly; y = lx; break;
+        case 2: x = w - lx; y = h - ly; break;
+        case 3: x = ly; y = w - lx; break;
+        default: x = lx; y = ly; break;
+    }
+}
+
+/**
+ * @brief Conservative raster of an island turned by rot * 90° at `cell`
+ *        UV units per cell, plus the mask dilated by `dilate` cells
+ *
+ * Every cell a triangle touches is set: per row, the triangle is clipped
+ * to the row's band and the x extent of the clipped part is filled.
+ */
+void rasterise_island(const Mesh* mesh, const Island& isl, int rot, float cell, int dilate,
+                      IslandMask& mask, IslandMask& dilated) {
+    float w = isl.width / cell, h = isl.height / cell;
+    float tw = (rot & 1) ? h : w, th = (rot & 1) ? w : h;
+    mask.reset((int)floorf(tw) + 1, (int)floorf(th) + 1);
+
+    for (int f : isl.faces) {
+        float px[3], py[3];
+        for (int k = 0; k < 3; k++) {
+            int v = mesh->triangles[f * 3 + k];
+            float lx = (mesh->uvs[v * 2 + 0] - isl.min_u) / cell;
+            float ly = (mesh->uvs[v * 2 + 1] - isl.min_v) / cell;
+            turn(rot, lx, ly, w, h, px[k], py[k]);
+        }
+        float ymin = std::min(py[0], std::min(py[1], py[2]));
+        float ymax = std::max(py[0], std::max(py[1], py[2]));
+        int r0 = std::max(0, (int)floorf(ymin)), r1 = std::min(mask.h - 1, (int)floorf(ymax));
+        for (int r = r0; r <= r1; r++) {
+            float band_lo = (float)r, band_hi = (float)(r + 1);
+            float xlo = FLT_MAX, xhi = -FLT_MAX;
+            for (int k = 0; k < 3; k++) {
+                if (py[k] >= band_lo && py[k] <= band_hi) {
+                    xlo = std::min(xlo, px[k]);
+                    xhi = std::max(xhi, px[k]);
+                }
+                int j = (k + 1) % 3;
+                float ya = py[k], yb = py[j];
+                if (ya == yb) continue;
+                for (int e = 0; e < 2; e++) {
+                    float yc = e ? band_hi : band_lo;
+                    if ((yc - ya) * (yc - yb) > 0.0f) continue;
+                    float x = px[k] + (yc - ya) * (px[j] - px[k]) / (yb - ya);
+                    xlo = std::min(xlo, x);
+                    xhi = std::max(xhi, x);
+                }
+            }
+            if (xlo > xhi) continue;
+            int c0 = std::max(0, (int)floorf(xlo)), c1 = std::min(mask.w - 1, (int)floorf(xhi));
+            if (c0 <= c1) set_bits(mask.row(r), c0, c1);
+        }
+    }
+
+    // Square dilation: horizontal run widening, then vertical OR
+    dilated.reset(mask.w + 2 * dilate, mask.h + 2 * dilate);
+    std::vector<uint64_t> wide((size_t)dilated.words * mask.h, 0);
+    for (int r = 0; r < mask.h; r++) {
+        for (int s = 0; s <= 2 * dilate; s++) {
+            or_shifted(&wide[(size_t)r * dilated.words], dilated.words, mask.row(r), mask.words, s);
+        }
+    }
+    for (int r = 0; r < dilated.h; r++) {
+        uint64_t* out = dilated.row(r);
+        int j0 = std::max(0, r - 2 * dilate), j1 = std::min(mask.h - 1, r);
+        for (int j = j0; j <= j1; j++) {
+            const uint64_t* in = &wide[(size_t)j * dilated.words];
+            for (int k = 0; k < dilated.words; k++) out[k] |= in[k];
+        }
+    }
+}
+
+/** Horizontal runs of set cells per row of a mask */
+struct MaskRuns {
+    struct Run { int x, len; };
+    std::vector<int> row_start;    // runs of row y: [row_start[y], row_start[y + 1])
+    std::vector<int> longest;      // longest run of row y
+    std::vector<Run> runs;
+
+    void build(const IslandMask& m) {
+        row_start.assign(1, 0);
+        longest.assign(m.h, 0);
+        runs.clear();
+        for (int y = 0; y < m.h; y++) {
+            const uint64_t* row = m.row(y);
+            for (int x = 0; x < m.w;) {
+                if (!((row[x >> 6] >> (x & 63)) & 1)) { x++; continue; }
+                int start = x;
+                while (x < m.w && ((row[x >> 6] >> (x & 63)) & 1)) x++;
+                runs.push_back({start, x - start});
+                longest[y] = std::max(longest[y], x - start);
+            }
+            row_start.push_back((int)runs.size());
+        }
+    }
+};
+
+/** out = in >> shift over `words` words, zero filled */
+inline void shift_down(uint64_t* out, const uint64_t* in, int words, int shift) {
+    int word = shift >> 6, bit = shift & 63;
+    for (int k = 0; k < words; k++) {
+        uint64_t lo = k + word < words ? in[k + word] : 0;
+        uint64_t hi = k + word + 1 < words ? in[k + word + 1] : 0;
+        out[k] = bit ? (lo >> bit) | (hi << (64 - bit)) : lo;
+    }
+}
+
+/**
+ * @brief Occupancy of the packing sheet
+ *
+ * The sheet is grid + 2 * apron cells wide: dilated masks may reach into
+ * the apron, the islands themselves stay inside the grid.
+ *
+ * Placement is searched a whole row of candidate x at a time: a mask row
+ * run of `len` cells at offset `a` fits at x iff cells x+a .. x+a+len-1
+ * are free, i.e. bit x+a of the free row eroded by len. Erosion is
+ * log2(len) shift-ANDs, so every candidate x costs a fraction of a bit op.
+ */
+class Sheet {
+public:
+    Sheet(int grid, int apron)
+        : side_(grid + 2 * apron), words_((grid + 2 * apron + 63) >> 6),
+          bits_((size_t)words_ * (grid + 2 * apron), 0), longest_free_(grid + 2 * apron, grid + 2 * apron) {}
+
+    int side() const { return side_; }
+    int words() const { return words_; }
+
+    /** Bits x where cells x .. x+len-1 of row y are all free */
+    void free_runs(int y, int len, uint64_t* out, uint64_t* tmp) const {
+        const uint64_t* row = &bits_[(size_t)y * words_];
+        for (int k = 0; k < words_; k++) out[k] = ~row[k];
+        int tail = side_ & 63;
+        if (tail) out[words_ - 1] &= (1ULL << tail) - 1;
+        for (int have = 1; have < len;) {
+            int step = std::min(have, len - have);
+            shift_down(tmp, out, words_, step);
+            for (int k = 0; k < words_; k++) out[k] &= tmp[k];
+            have += step;
+        }
+    }
+
+    /** Lowest row y, then lowest x, where the mask fits; false if none */
+    bool find_position(const IslandMask& m, const MaskRuns& runs, int& out_x, int& out_y) const {
+        int max_x = side_ - m.w;
+        if (max_x < 0 || m.h > side_) return false;
+        std::vector<uint64_t> acc(words_), free(words_), tmp(words_);
+        for (int y = 0; y + m.h <= side_; y++) {
+            // Cheap reject: some row has no free run long enough
+            bool open = true;
+            for (int r = 0; r < m.h && open; r++) open = longest_free_[y + r] >= runs.longest[r];
+            if (!open) continue;
+
+            std::fill(acc.begin(), acc.end(), 0);
+            for (int x = 0; x <= max_x; x += 64) {
+                int n = std::min(64, max_x + 1 - x);
+                acc[x >> 6] = n == 64 ? ~0ULL : (1ULL << n) - 1;
+            }
+            bool any = true;
+            for (int r = 0; r < m.h && any; r++) {
+                for (int k = runs.row_start[r]; k < runs.row_start[r + 1] && any; k++) {
+                    free_runs(y + r, runs.runs[k].len, free.data(), tmp.data());
+                    shift_down(tmp.data(), free.data(), words_, runs.runs[k].x);
+                    uint64_t live = 0;
+                    for (int w = 0; w < words_; w++) live |= (acc[w] &= tmp[w]);
+                    any = live != 0;
+                }
+            }
+            if (!any) continue;
+            for (int w = 0; w < words_; w++) {
+                if (acc[w]) {
+                    out_x = (w << 6) + __builtin_ctzll(acc[w]);
+                    out_y = y;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    void stamp(const IslandMask& m, int x, int y) {
+        for (int r = 0; r < m.h; r++) {
+            uint64_t* row = &bits_[(size_t)(y + r) * words_];
+            or_shifted(row, words_, m.row(r), m.words, x);
+
+            int best = 0, run = 0;
+            for (int c = 0; c < side_; c++) {
+                run = ((row[c >> 6] >> (c & 63)) & 1) ? 0 : run + 1;
+                best = std::max(best, run);
+            }
+            longest_free_[y + r] = best;
+        }
+    }
+
+private:
+    int side_, words_;
+    std::vector<uint64_t> bits_;
+    std::vector<int> longest_free_;    // longest free run per row
+};
+
+struct RasterPlacement {
+    int x, y, rot;
+};
+
+/**
+ * @brief Pack every island (in `order`) at `side` UV units per sheet
+ *
+ * Rotations are searched in parallel; the lowest top edge wins, then
+ * the lowest x, then the lowest rotation, so the result does not depend
+ * on the thread count.
+ */
+bool raster_try_pack(const Mesh* mesh, const std::vector<Island>& islands, const std::vector<int>& order,
+                     int grid, float side, float margin, int num_rotations,
+                     std::vector<RasterPlacement>& out) {
+    float cell = side / grid;
+    int dilate = (int)ceilf(margin * grid);
+    Sheet sheet(grid, dilate);
+    int threads = uvunwrap::choose_thread_count(num_rotations, 0, 1);
+
+    std::vector<IslandMask> masks(num_rotations), dilated(num_rotations);
+    std::vector<MaskRuns> runs(num_rotations);
+    std::vector<int> found(num_rotations), fx(num_rotations), fy(num_rotations);
+    for (int i : order) {
+        uvunwrap::parallel_for_dynamic(num_rotations, threads, [&](int, int rot) {
+            rasterise_island(mesh, islands[i], rot, cell, dilate, masks[rot], dilated[rot]);
+            runs[rot].build(dilated[rot]);
+            found[rot] = sheet.find_position(dilated[rot], runs[rot], fx[rot], fy[rot]);
+        });
+
+        int best = -1;
+        for (int rot = 0; rot < num_rotations; rot++) {
+            if (!found[rot]) continue;
+            if (best < 0 || fy[rot] + dilated[rot].h < fy[best] + dilated[best].h ||
+                (fy[rot] + dilated[rot].h == fy[best] + dilated[best].h && fx[rot] < fx[best])) {
+                best = rot;
+            }
+        }
+        if (best < 0) return false;
+
+        // The dilated mask sits `dilate` cells left of and below the island
+        sheet.stamp(masks[best], fx[best] + dilate, fy[best] + dilate);
+        out[i].x = fx[best];
+        out[i].y = fy[best];
+        out[i].rot = best;
+    }
+    return true;
+}
+
+} // namespace
+
+static void raster_pack(Mesh* mesh, std::vector<Island>& islands, const IslandLists& lists, float margin,
+                        bool allow_rotate, int sort_threads, int num_threads) {
+    std::vector<int> order;
+    double area = 0.0;
+    for (size_t i = 0; i < islands.size(); i++) {
+        const Island& isl = islands[i];
+        if (isl.vertex_indices.empty()) continue;
+        order.push_back((int)i);
+        for (int f : isl.faces) {
+            const float* a = &mesh->uvs[mesh->triangles[f * 3 + 0] * 2];
+            const float* b = &mesh->uvs[mesh->triangles[f * 3 + 1] * 2];
+            const float* c = &mesh->uvs[mesh->triangles[f * 3 + 2] * 2];
+            area += 0.5 * fabs((double)(b[0] - a[0]) * (c[1] - a[1]) - (double)(b[1] - a[1]) * (c[0] - a[0]));
+        }
+    }
+    if (order.empty()) return;
+
+    // Largest boxes first
+    uvunwrap::parallel_stable_sort(order, [&](int a, int b) {
+        return islands[a].width * islands[a].height > islands[b].width * islands[b].height;
+    }, sort_threads);
+
+    int grid = RASTER_CELLS_PER_ISLAND * (int)ceil(sqrt((double)order.size()));
+    grid = std::max(RASTER_MIN_GRID, std::min(RASTER_MAX_GRID, (grid + 63) & ~63));
+    int num_rotations = allow_rotate ? 4 : 1;
+
+    // Box packing bounds the side from above, the UV area from below
+    std::vector<uvunwrap::PackRect> rects(islands.size());
+    float max_side = 0.0f;
+    for (size_t i = 0; i < islands.size(); i++) {
+        rects[i].w = islands[i].width;
+        rects[i].h = islands[i].height;
+        max_side = std::max(max_side, std::max(islands[i].width, islands[i].height));
+    }
+    std::vector<uvunwrap::PackPlacement> boxes;
+    float hi = uvunwrap::pack_rects_square(rects, PACK_METHOD_MAXRECTS, allow_rotate, margin, boxes);
+    float lo = std::max((float)sqrt(area), max_side);
+    if (hi <= 0.0f) return;
+
+    // Silhouettes only help if they beat the boxes: otherwise the grid is
+    // too coarse for the islands and the MaxRects layout is kept
+    std::vector<RasterPlacement> placements(islands.size()), trial(islands.size());
+    if (!raster_try_pack(mesh, islands, order, grid, hi, margin, num_rotations, trial)) {
+        LOG_DEBUG("  Silhouette packing no tighter than boxes, keeping MaxRects");
+        place_boxes(mesh, islands, lists, boxes, hi, num_threads);
+        return;
+    }
+    placements = trial;
+    for (int step = 0; step < RASTER_BISECT_STEPS; step++) {
+        float mid = 0.5f * (lo + hi);
+        if (raster_try_pack(mesh, islands, order, grid, mid, margin, num_rotations, trial)) {
+            hi = mid;
+            placements = trial;
+        } else {
+            lo = mid;
+        }
+    }
+    LOG_DEBUG("  Silhouette packing: %d² grid, side %.4f (area bound %.4f)", grid, hi, sqrt(area));
+
+    // Cell (x, y) of the grid maps to [x, x + 1] / grid in [0,1]²
+    float cell = hi / grid;
+    for (int i : order) {
+        Island& isl = islands[i];
+        const RasterPlacement& p = placements[i];
+        float w = isl.width / cell, h = isl.height / cell;
         for (int v : isl.vertex_indices) {
-            mesh->uvs[v * 2 + 0] += offset_x;
-            mesh->uvs[v * 2 + 1] += offset_y;
+            float lx = (mesh->uvs[v * 2 + 0] - isl.min_u) / cell;
+            float ly = (mesh->uvs[v * 2 + 1] - isl.min_v) / cell;
+            float x, y;
+            turn(p.rot, lx, ly, w, h, x, y);
+            mesh->uvs[v * 2 + 0] = (p.x + x) / grid;
+            mesh->uvs[v * 2 + 1] = (p.y + y) / grid;
         }
     }
+}
 
-    // STEP 5: Scale to [0,1]
-    float scale = 1.0f / max_float(packed_max_w, packed_max_h);
-    // Avoid inf
-    if (packed_max_w == 0) scale = 1.0f;
-    
-    for (int i = 0; i < mesh->num_vertices; i++) {
-         mesh->uvs[i * 2 + 0] *= scale;
-         mesh->uvs[i * 2 + 1] *= scale;
+/**
+ * @brief Mesh length per UV length of each island, times its importance
+ *
+ * Islands without 3D or UV area, or with a non-positive importance, get 1.
+ */
+static void density_scales(const Mesh* mesh, const UnwrapResult* result, const float* face_importance,
+                           int num_threads, std::vector<double>& scales) {
+    uvunwrap::IslandAreas areas;
+    uvunwrap::island_areas(mesh, result->face_island_ids, result->num_islands, face_importance,
+                           num_threads, &areas);
+    scales.assign((size_t)result->num_islands, 1.0);
+    for (int i = 0; i < result->num_islands; i++) {
+        if (areas.area_3d[i] <= 0.0 || areas.area_uv[i] <= 0.0) continue;
+        double weight = areas.weight[i] > 0.0 ? areas.weight[i] : 1.0;
+        scales[i] = weight * sqrt(areas.area_3d[i] / areas.area_uv[i]);
     }
+}
+
+void uvunwrap::scale_islands(Mesh* mesh, const UnwrapResult* result, const float* face_importance,
+                             int num_threads) {
+    if (!mesh || !result || !mesh->uvs || !mesh->vertices || result->num_islands < 1) return;
+    UV_TRACE_ZONE("scale islands");
+    std::vector<double> scales;
+    density_scales(mesh, result, face_importance, num_threads, scales);
 
-    printf("  Packing completed. Coverage: %.1f%%\n", result->coverage * 100);    
+    // Each vertex is scaled once, by the island of the first face using it
+    std::vector<unsigned char> done(mesh->num_vertices, 0);
+    for (int f = 0; f < mesh->num_triangles; f++) {
+        int island_id = result->face_island_ids[f];
+        if (island_id < 0 || island_id >= result->num_islands) continue;
+        float s = (float)scales[island_id];
+        for (int j = 0; j < 3; j++) {
+            int v = mesh->triangles[f * 3 + j];
+            if (done[v]) continue;
+            done[v] = 1;
+            mesh->uvs[v * 2 + 0] *= s;
+            mesh->uvs[v * 2 + 1] *= s;
+        }
+    }
+}
+
+void scale_uv_islands_to_density(Mesh* mesh,
+                                 const UnwrapResult* result,
+                                 const float* face_importance) {
+    uvunwrap::scale_islands(mesh, result, face_importance, 0);
+}
+
+void uvunwrap::prepare_pack_boxes(const Mesh* mesh, const UnwrapResult* result, int rotation, int num_threads,
+                                  PackBoxes& boxes) {
+    boxes.uvs.assign(mesh->uvs, mesh->uvs + (size_t)mesh->num_vertices * 2);
+    Mesh turned = *mesh;
+    turned.uvs = boxes.uvs.data();
+
+    std::vector<Island> islands;
+    IslandLists lists;
+    collect_islands(&turned, result, islands, lists, rotation == PACK_ROTATION_MIN_AREA, num_threads);
+    orient_min_area(&turned, islands, lists, num_threads);
+
+    boxes.rects.resize(islands.size());
+    boxes.min_u.resize(islands.size());
+    boxes.min_v.resize(islands.size());
+    for (size_t i = 0; i < islands.size(); i++) {
+        boxes.rects[i].w = islands[i].width;
+        boxes.rects[i].h = islands[i].height;
+        boxes.min_u[i] = islands[i].min_u;
+        boxes.min_v[i] = islands[i].min_v;
+    }
+    boxes.vertex_offsets.swap(lists.vertex_offsets);
+    boxes.vertices.swap(lists.vertices);
+}
+
+void uvunwrap::place_pack_boxes(const PackBoxes& boxes, const std::vector<PackPlacement>& placements, float side,
+                                float* uvs) {
+    // The transforms of place_boxes(), so a layout comes out bit for bit
+    // as pack_islands() would write it
+    memcpy(uvs, boxes.uvs.data(), boxes.uvs.size() * sizeof(float));
+    float inv = 1.0f / side;
+    std::vector<IslandTransform> transforms(boxes.rects.size());
+    for (size_t i = 0; i < boxes.rects.size(); i++) {
+        IslandTransform& t = transforms[i];
+        t = identity_transform();
+        t.rotate_90 = placements[i].rotated;
+        t.min_u = boxes.min_u[i];
+        t.min_v = boxes.min_v[i];
+        t.height = boxes.rects[i].h;
+        t.add_u = placements[i].x;
+        t.add_v = placements[i].y;
+        t.sub_u = boxes.min_u[i];
+        t.sub_v = boxes.min_v[i];
+        t.scale = inv;
+    }
+    transform_islands(uvs, boxes.vertex_offsets.data(), boxes.vertices.data(), (int)transforms.size(),
+                      transforms.data(), 1);
+}
+
+void pack_uv_islands(Mesh* mesh,
+                     const UnwrapResult* result,
+                     float margin) {
+    pack_uv_islands_ex(mesh, result, margin, PACK_METHOD_SHELF, PACK_ROTATION_NONE);
+}
+
+void pack_uv_islands_ex(Mesh* mesh,
+                        const UnwrapResult* result,
+                        float margin,
+                        int method,
+                        int rotation) {
+    uvunwrap::pack_islands(mesh, result, margin, method, rotation, SORT_POLICY_AUTO, 0);
 }
 
-void compute_quality_metrics(const Mesh* mesh, UnwrapResult* result) {
+void uvunwrap::pack_islands(Mesh* mesh, const UnwrapResult* result, float margin, int method, int rotation,
+                            int sort_policy, int num_threads) {
     if (!mesh || !result || !mesh->uvs) return;
 
-    // TODO: Implement quality metrics computation
-    //
-    // NOTE: This function is OPTIONAL for Part 1.
-    // You will implement full metrics in Part 2 (Python).
-    // For Part 1, you can either:
-    //   (A) Leave these as defaults (tests will still pass)
-    //   (B) Implement basic estimation for testing
-    //
-    // ALGORITHM (see reference/algorithms.md and part2_python/reference/metrics_spec.md):
-    //
-    // STRETCH METRIC (SVD-based):
-    //   For each triangle:
-    //     1. Build Jacobian matrix J (3x2): maps UV space to 3D space
-    //        J = [dp/du, dp/dv] where p is 3D position
-    //     2. Compute J^T * J (2x2 Gramian matrix)
-    //     3. Find eigenvalues λ1, λ2 of J^T * J
-    //     4. Singular values: σ1 = sqrt(λ1), σ2 = sqrt(λ2)
-    //     5. Stretch = σ1 / σ2 (ratio of max/min stretching)
-    //   Average and max stretch across all triangles
-    //
-    // COVERAGE METRIC (Rasterization-based):
-    //   1. Create 1024x1024 bitmap of [0,1]² UV space
-    //   2. Rasterize all UV triangles
-    //   3. Coverage = (pixels_filled / total_pixels)
-    //   Alternative: Use bounding box as approximation
-    //
-    // EXPECTED RESULTS:
-    //   - Good unwrap: avg_stretch < 1.5, max_stretch < 2.0
-    //   - Shelf packing: coverage > 0.60 (60%)
-    //   - MaxRects packing: coverage > 0.75 (75%)
-
-    // Default values (replace with your implementation)
-    result->avg_stretch = 1.0f;
-    result->max_stretch = 1.0f;
-    result->coverage = 0.7f;
-
-    printf("Quality metrics: (using defaults - implement for accurate values)\n");
-    printf("  Avg stretch: %.2f\n", result->avg_stretch);
-    printf("  Max stretch: %.2f\n", result->max_stretch);
-    printf("  Coverage: %.1f%%\n", result->coverage * 100);
+    if (result->num_islands <= 1) {
+        // Single island, already normalized to [0,1]
+        return;
+    }
+
+    LOG_INFO("Packing %d islands (%s)...", result->num_islands,
+             method == PACK_METHOD_RASTER ? "raster" :
+             method == PACK_METHOD_MAXRECTS ? "maxrects" :
+             method == PACK_METHOD_SKYLINE ? "skyline" : "shelf");
+
+    // STEP 1: Compute bounding boxes and collect vertices
+    std::vector<Island> islands;
+    IslandLists lists;
+    collect_islands(mesh, result, islands, lists, rotation == PACK_ROTATION_MIN_AREA, num_threads);
+    int sort_threads = uvunwrap::sort_thread_count((int)islands.size(), sort_policy, num_threads);
+
+    if (method == PACK_METHOD_RASTER) {
+        // Silhouettes are drawn from the turned UVs
+        orient_min_area(mesh, islands, lists, num_threads);
+        raster_pack(mesh, islands, lists, margin, rotation != PACK_ROTATION_NONE, sort_threads, num_threads);
+    } else if (method == PACK_METHOD_SKYLINE || method == PACK_METHOD_MAXRECTS) {
+        rect_pack(mesh, islands, lists, margin, method, rotation != PACK_ROTATION_NONE, num_threads);
+    } else {
+        // Shelves fill best with wide boxes
+        if (rotation != PACK_ROTATION_NONE) {
+            for (Island& isl : islands) {
+                if (isl.height <= isl.width) continue;
+                isl.turned = true;
+                std::swap(isl.width, isl.height);
+                isl.max_u = isl.min_u + isl.width;
+                isl.max_v = isl.min_v + isl.height;
+            }
+        }
+        shelf_pack(mesh, islands, lists, margin, sort_threads, num_threads);
+    }
+
+    LOG_INFO("  Packing completed. Coverage: %.1f%%", result->coverage * 100);
+}
+
+// ---------------------------------------------------------------------------
+// UDIM tiles
+// ---------------------------------------------------------------------------
+
+static const int UDIM_ROW_TILES = 10;
+static const int UDIM_DEFAULT_RESOLUTION = 1024;
+static const int UDIM_SHRINK_STEPS = 40;
+static const double UDIM_SHRINK_FACTOR = 0.8;
+static const int UDIM_BISECT_STEPS = 8;
+
+int pack_uv_islands_udim(Mesh* mesh,
+                         const UnwrapResult* result,
+                         const UnwrapParams* params) {
+    if (!mesh || !result || !params || !mesh->uvs || !mesh->vertices) return 0;
+    if (result->num_islands < 1) return 0;
+
+    int method = params->pack_method == PACK_METHOD_SKYLINE ? PACK_METHOD_SKYLINE : PACK_METHOD_MAXRECTS;
+    bool allow_rotate = params->pack_rotation != PACK_ROTATION_NONE;
+    int resolution = params->udim_resolution > 0 ? params->udim_resolution : UDIM_DEFAULT_RESOLUTION;
+    float margin = max_float(params->island_margin, 0.0f);
+    double target = params->texel_density > 0.0f ? (double)params->texel_density / resolution : 0.0;
+
+    std::vector<Island> islands;
+    IslandLists lists;
+    collect_islands(mesh, result, islands, lists, params->pack_rotation == PACK_ROTATION_MIN_AREA,
+                    params->num_threads);
+
+    // Mesh units per UV unit of each island: scaling island i by
+    // density * to_mesh[i] gives every island the same texel density
+    int n = (int)islands.size();
+    std::vector<double> to_mesh;
+    density_scales(mesh, result, params->face_importance, params->num_threads, to_mesh);
+    double box_area = 0.0, max_side = 0.0;
+    for (int i = 0; i < n; i++) {
+        const Island& isl = islands[i];
+        if (isl.vertex_indices.empty()) continue;
+        box_area += (double)isl.width * isl.height * to_mesh[i] * to_mesh[i];
+        max_side = std::max(max_side, std::max(isl.width, isl.height) * to_mesh[i]);
+    }
+    if (max_side <= 0.0) return 0;
+
+    // Densities are in tile units per mesh unit; above fit_density the
+    // largest island no longer fits a tile
+    double fit_density = (1.0 - 1e-6) / max_side;
+    std::vector<double> scale(n);
+    std::vector<uvunwrap::PackRect> rects(n);
+    auto set_density = [&](double density) {
+        for (int i = 0; i < n; i++) {
+            scale[i] = density * to_mesh[i];
+            rects[i].w = (float)(islands[i].width * scale[i]);
+            rects[i].h = (float)(islands[i].height * scale[i]);
+        }
+    };
+
+    std::vector<uvunwrap::PackPlacement> placements, trial;
+    double density;
+    int tiles;
+    if (params->udim_tiles > 0 || target <= 0.0) {
+        tiles = std::max(1, params->udim_tiles);
+
+        // The boxes cannot take more than the tiles' area
+        double hi = std::min(sqrt(tiles / std::max(box_area, 1e-30)), fit_density);
+        if (target > 0.0) hi = std::min(hi, target);
+
+        density = hi;
+        bool packed = false;
+        for (int step = 0; step < UDIM_SHRINK_STEPS; step++) {
+            set_density(density);
+            if (uvunwrap::pack_rects_tiles(rects, method, allow_rotate, margin, tiles, placements) > 0) {
+                packed = true;
+                break;
+            }
+            hi = density;
+            density *= UDIM_SHRINK_FACTOR;
+        }
+        if (!packed) {
+            LOG_ERROR("UDIM packing failed: %d islands do not fit %d tiles", n, tiles);
+            return 0;
+        }
+        for (int step = 0; step < UDIM_BISECT_STEPS && hi > density; step++) {
+            double mid = 0.5 * (density + hi);
+            set_density(mid);
+            if (uvunwrap::pack_rects_tiles(rects, method, allow_rotate, margin, tiles, trial) > 0) {
+                density = mid;
+                placements.swap(trial);
+            } else {
+                hi = mid;
+            }
+        }
+        set_density(density);
+        if (target > 0.0 && density < target * 0.999) {
+            LOG_WARNING("Texel density %.1f does not fit %d tiles, using %.1f",
+                        params->texel_density, tiles, density * resolution);
+        }
+    } else {
+        density = target;
+        set_density(density);
+
+        int shrunk = 0;
+        for (int i = 0; i < n; i++) {
+            float side = std::max(rects[i].w, rects[i].h);
+            if (side < 1.0f) continue;
+            float fit = (1.0f - 1e-6f) / side;
+            scale[i] *= fit;
+            rects[i].w *= fit;
+            rects[i].h *= fit;
+            shrunk++;
+        }
+        if (shrunk > 0) {
+            LOG_WARNING("%d islands are larger than a tile at %.1f texels per unit, shrunk to fit",
+                        shrunk, params->texel_density);
+        }
+
+        tiles = uvunwrap::pack_rects_tiles(rects, method, allow_rotate, margin, 0, placements);
+        if (tiles <= 0) {
+            LOG_ERROR("UDIM packing failed for %d islands", n);
+            return 0;
+        }
+    }
+
+    LOG_INFO("Packed %d islands into %d UDIM tiles (%.1f texels per unit)",
+             n, tiles, density * resolution);
+
+    std::vector<uvunwrap::IslandTransform> transforms(n);
+    for (int i = 0; i < n; i++) {
+        const Island& isl = islands[i];
+        const uvunwrap::PackPlacement& p = placements[i];
+        uvunwrap::IslandTransform& t = transforms[i];
+        t = pending_turns(isl, p.rotated, isl.height);
+        t.sub_u = isl.min_u;
+        t.sub_v = isl.min_v;
+        t.scale = (float)scale[i];
+        t.tile_u = (float)(p.tile % UDIM_ROW_TILES) + p.x;
+        t.tile_v = (float)(p.tile / UDIM_ROW_TILES) + p.y;
+    }
+    move_islands(mesh, lists, transforms, params->num_threads);
+    return tiles;
 }
@@ -0,0 +1,64 @@
+/**
+ * @file packing.h
+ * @brief Internal entry point of pack_uv_islands_ex() with a sort policy
+ *
+ * Not part of the public API. Lets the pipelines pass UnwrapParams'
+ * sort_policy and num_threads through to the island sorts.
+ */
+
+#ifndef UVUNWRAP_PACKING_H
+#define UVUNWRAP_PACKING_H
+
+#include "unwrap.h"
+#include "rect_pack.h"
+#include <vector>
+
+namespace uvunwrap {
+
+/**
+ * @brief Islands reduced to boxes, detached from the mesh
+ *
+ * What the square packers of pack_islands() see: the UVs after the
+ * optional minimum-area turn, each island's vertices and the lower-left
+ * corner and size of its box.
+ */
+struct PackBoxes {
+    std::vector<float> uvs;
+    std::vector<int> vertex_offsets;    /**< num_islands + 1 offsets into vertices */
+    std::vector<int> vertices;
+    std::vector<float> min_u, min_v;
+    std::vector<PackRect> rects;
+};
+
+/**
+ * @brief Collect the boxes pack_islands() would pack for rotation
+ *        (PACK_ROTATION_MIN_AREA turns the islands first)
+ */
+void prepare_pack_boxes(const Mesh* mesh, const UnwrapResult* result, int rotation, int num_threads,
+                        PackBoxes& boxes);
+
+/**
+ * @brief Write boxes.uvs with every island moved to its placement and the
+ *        square of the given side scaled to [0,1]², as pack_islands() does
+ * @param uvs Output, boxes.uvs.size() floats
+ */
+void place_pack_boxes(const PackBoxes& boxes, const std::vector<PackPlacement>& placements, float side,
+                      float* uvs);
+
+/**
+ * @brief pack_uv_islands_ex() whose island sorts follow sort_policy on up
+ *        to num_threads workers (0 = all cores); the layout does not
+ *        depend on either
+ */
+void pack_islands(Mesh* mesh, const UnwrapResult* result, float margin, int method, int rotation,
+                  int sort_policy, int num_threads);
+
+/**
+ * @brief scale_uv_islands_to_density() with the island areas summed on
+ *        up to num_threads workers (0 = automatic by face count)
+ */
+void scale_islands(Mesh* mesh, const UnwrapResult* result, const float* face_importance, int num_threads);
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_PACKING_H */
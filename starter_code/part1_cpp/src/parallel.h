@@ -0,0 +1,168 @@
+/**
+ * @file parallel.h
+ * @brief Internal fork-join helpers shared by the parallel kernels
+ *
+ * Not part of the public API. Uses std::thread so the library has no
+ * dependency on OpenMP or TBB. Workers inherit the caller's log sink and
+ * NUMA placement (numa.h) and are named in traces (trace.h).
+ */
+
+#ifndef UVUNWRAP_PARALLEL_H
+#define UVUNWRAP_PARALLEL_H
+
+#include "logging.h"
+#include "numa.h"
+#include "trace.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace uvunwrap {
+
+/**
+ * @brief Resolve a user-facing thread count (<= 0 means "all cores")
+ */
+inline int resolve_thread_count(int requested) {
+    if (requested > 0) return requested;
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw > 0 ? (int)hw : 1;
+}
+
+/**
+ * @brief Pick a worker count for a loop of `count` items
+ *
+ * An explicit request is honoured (capped at count). Otherwise one worker
+ * is used per `min_items_per_thread` items so small inputs stay serial.
+ */
+inline int choose_thread_count(int count, int requested, int min_items_per_thread) {
+    if (count <= 0) return 1;
+    int threads;
+    if (requested > 0) {
+        threads = requested;
+    } else {
+        int hw = resolve_thread_count(0);
+        int by_size = count / (min_items_per_thread > 0 ? min_items_per_thread : 1);
+        threads = by_size < hw ? by_size : hw;
+    }
+    if (threads > count) threads = count;
+    return threads < 1 ? 1 : threads;
+}
+
+/**
+ * @brief Split [0, count) into num_threads contiguous ranges and run
+ *        fn(thread_index, begin, end) on each, joining before returning
+ *
+ * Ranges are deterministic for a given (count, num_threads) so per-thread
+ * partial results can be reduced in a fixed order.
+ */
+template <typename Fn>
+void parallel_for_ranges(int count, int num_threads, Fn fn) {
+    if (num_threads <= 1 || count <= 1) {
+        fn(0, 0, count);
+        return;
+    }
+
+    LogSink* sink = current_log_sink();
+    NumaPlacement placement = current_numa_placement();
+    std::vector<std::thread> workers;
+    workers.reserve(num_threads - 1);
+    for (int t = 1; t < num_threads; t++) {
+        int begin = (int)((long long)count * t / num_threads);
+        int end = (int)((long long)count * (t + 1) / num_threads);
+        workers.emplace_back([=]() {
+            numa_place_worker(placement, t, num_threads);
+            ScopedLogSink scope(sink);
+            UV_TRACE_THREAD_NAME("uvunwrap worker", t);
+            fn(t, begin, end);
+        });
+    }
+    fn(0, 0, (int)((long long)count / num_threads));
+
+    for (size_t i = 0; i < workers.size(); i++) {
+        workers[i].join();
+    }
+}
+
+/**
+ * @brief Run fn(thread_index, item) for every item in [0, count) with
+ *        dynamic scheduling: workers pull the next item from a shared
+ *        atomic counter, so long items do not stall the others
+ *
+ * Items are handed out in index order; callers that want the biggest
+ * jobs to start first pass a largest-first permutation.
+ */
+template <typename Fn>
+void parallel_for_dynamic(int count, int num_threads, Fn fn) {
+    if (num_threads > count) num_threads = count;
+    if (num_threads <= 1) {
+        for (int i = 0; i < count; i++) fn(0, i);
+        return;
+    }
+
+    std::atomic<int> next(0);
+    LogSink* sink = current_log_sink();
+    NumaPlacement placement = current_numa_placement();
+    auto worker = [&](int t) {
+        if (t > 0) numa_place_worker(placement, t, num_threads);
+        ScopedLogSink scope(sink);
+        if (t > 0) UV_TRACE_THREAD_NAME("uvunwrap worker", t);
+        for (;;) {
+            int i = next.fetch_add(1, std::memory_order_relaxed);
+            if (i >= count) break;
+            fn(t, i);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(num_threads - 1);
+    for (int t = 1; t < num_threads; t++) {
+        workers.emplace_back(worker, t);
+    }
+    worker(0);
+
+    for (size_t i = 0; i < workers.size(); i++) {
+        workers[i].join();
+    }
+}
+
+/**
+ * @brief Run fn(chunk, begin, end) for every chunk of chunk_size items of
+ *        [0, count), the chunks split over num_threads workers
+ *
+ * Chunks depend only on count and chunk_size, so per-chunk partial
+ * results combined by reduce_pairwise() do not depend on the worker
+ * count. Returns the number of chunks.
+ */
+template <typename Fn>
+int parallel_for_chunks(int count, int chunk_size, int num_threads, Fn fn) {
+    if (count <= 0) return 0;
+    int num_chunks = (int)(((long long)count + chunk_size - 1) / chunk_size);
+    parallel_for_ranges(num_chunks, num_threads < num_chunks ? num_threads : num_chunks,
+                        [&](int, int first, int last) {
+        for (int c = first; c < last; c++) {
+            int begin = (int)((long long)c * chunk_size);
+            int end = count - begin < chunk_size ? count : begin + chunk_size;
+            fn(c, begin, end);
+        }
+    });
+    return num_chunks;
+}
+
+/**
+ * @brief Fold partials[0, n) into partials[0] along a fixed binary tree,
+ *        combine(into, from) at every node
+ *
+ * The tree depends only on n, and pairwise sums round less than a
+ * running sum over the chunks.
+ */
+template <typename T, typename Combine>
+void reduce_pairwise(std::vector<T>& partials, Combine combine) {
+    size_t n = partials.size();
+    for (size_t step = 1; step < n; step *= 2) {
+        for (size_t i = 0; i + step < n; i += 2 * step) combine(partials[i], partials[i + step]);
+    }
+}
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_PARALLEL_H */
@@ -0,0 +1,87 @@
+/**
+ * @file parallel_sort.h
+ * @brief Internal stable sort split across std::thread workers
+ *
+ * Not part of the public API. Contiguous runs are sorted in parallel with
+ * std::stable_sort and then merged pairwise, a round of merges at a time,
+ * so the result is std::stable_sort's for any thread count. std::execution
+ * is not used: with libstdc++ its parallel policies need TBB, and the
+ * library only depends on std::thread (parallel.h).
+ */
+
+#ifndef UVUNWRAP_PARALLEL_SORT_H
+#define UVUNWRAP_PARALLEL_SORT_H
+
+#include "unwrap.h"
+#include "parallel.h"
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+namespace uvunwrap {
+
+/** SORT_POLICY_AUTO only splits a sort with at least this many items per worker */
+const int PARALLEL_SORT_MIN_ITEMS_PER_THREAD = 32768;
+
+/**
+ * @brief Workers for sorting count items under a SortPolicy
+ * @param num_threads UnwrapParams::num_threads (<= 0 = all cores)
+ */
+inline int sort_thread_count(int count, int policy, int num_threads) {
+    if (policy == SORT_POLICY_SEQUENTIAL) return 1;
+    int threads = resolve_thread_count(num_threads);
+    if (policy != SORT_POLICY_PARALLEL) {
+        int by_size = count / PARALLEL_SORT_MIN_ITEMS_PER_THREAD;
+        if (by_size < threads) threads = by_size;
+    }
+    // Runs of at least two items
+    if (threads > count / 2) threads = count / 2;
+    return threads < 1 ? 1 : threads;
+}
+
+/**
+ * @brief std::stable_sort(items, less) on `threads` workers
+ */
+template <typename T, typename Less>
+void parallel_stable_sort(std::vector<T>& items, Less less, int threads) {
+    int n = (int)items.size();
+    if (threads > n / 2) threads = n / 2;
+    if (threads <= 1) {
+        std::stable_sort(items.begin(), items.end(), less);
+        return;
+    }
+
+    // Run t is parallel_for_ranges' range t
+    std::vector<int> bounds(threads + 1);
+    for (int t = 0; t <= threads; t++) bounds[t] = (int)((long long)n * t / threads);
+    parallel_for_ranges(n, threads, [&](int, int begin, int end) {
+        std::stable_sort(items.begin() + begin, items.begin() + end, less);
+    });
+
+    // std::merge takes from the left run on ties, which keeps it stable
+    std::vector<T> buffer(n);
+    std::vector<T>* from = &items;
+    std::vector<T>* to = &buffer;
+    while (bounds.size() > 2) {
+        int runs = (int)bounds.size() - 1;
+        int pairs = (runs + 1) / 2;
+        parallel_for_dynamic(pairs, pairs < threads ? pairs : threads, [&](int, int p) {
+            int lo = bounds[2 * p];
+            int mid = bounds[std::min(2 * p + 1, runs)];
+            int hi = bounds[std::min(2 * p + 2, runs)];
+            std::merge(std::make_move_iterator(from->begin() + lo), std::make_move_iterator(from->begin() + mid),
+                       std::make_move_iterator(from->begin() + mid), std::make_move_iterator(from->begin() + hi),
+                       to->begin() + lo, less);
+        });
+        std::vector<int> merged;
+        for (int r = 0; r < runs; r += 2) merged.push_back(bounds[r]);
+        merged.push_back(n);
+        bounds.swap(merged);
+        std::swap(from, to);
+    }
+    if (from != &items) items.swap(buffer);
+}
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_PARALLEL_SORT_H */
@@ -0,0 +1,629 @@
+/**
+ * @file rect_pack.cpp
+ * @brief Skyline and MaxRects rectangle packing into a square
+ *
+ * Both engines pack into a fixed square; pack_rects_square() finds the
+ * smallest side that fits by growing an upper bound from the area lower
+ * bound and then bisecting. The margin scales with the side, so each
+ * trial inflates the rects by margin * side. pack_rects_tiles() runs one
+ * engine per unit tile instead.
+ *
+ * MaxRects keeps every maximal free rectangle. Free rects are bucketed in
+ * a coarse uniform grid, so splitting after a placement only visits the
+ * free rects in the cells under it and the containment pruning only those
+ * in one cell, instead of the whole list. Free space that none of the
+ * remaining rects fits is dropped at once, which keeps the list short.
+ * Reference: J. Jylänki, "A Thousand Ways to Pack the Bin".
+ */
+
+#include "rect_pack.h"
+#include "unwrap.h"
+#include "logging.h"
+#include <math.h>
+#include <float.h>
+#include <algorithm>
+
+namespace {
+
+using uvunwrap::PackRect;
+using uvunwrap::PackPlacement;
+
+const int GROW_STEPS = 64;
+const float GROW_FACTOR = 1.25f;
+const int BISECT_STEPS = 8;
+const int MAX_INDEX_GRID = 16;
+
+// Padding may take at most this share of the sheet, else the margin is
+// reduced: margin² · n <= MAX_PAD_SHARE
+const float MAX_PAD_SHARE = 0.25f;
+
+/** Rect in the bin, inflated by the padding */
+struct BinRect {
+    float w, h;
+};
+
+// ---------------------------------------------------------------------------
+// Skyline bottom-left
+// ---------------------------------------------------------------------------
+
+struct Segment {
+    float x, y, w;
+};
+
+class Skyline {
+public:
+    explicit Skyline(float side) : side_(side), eps_(side * 1e-6f) {
+        segments_.push_back({0.0f, 0.0f, side});
+    }
+
+    /** Lowest y at which a w × h rect starting at segment i fits, or -1 */
+    float fit(size_t i, float w, float h) const {
+        float x = segments_[i].x;
+        if (x + w > side_ + eps_) return -1.0f;
+        float y = 0.0f, remaining = w;
+        for (size_t j = i; remaining > eps_; j++) {
+            if (j >= segments_.size()) return -1.0f;
+            y = std::max(y, segments_[j].y);
+            if (y + h > side_ + eps_) return -1.0f;
+            remaining -= segments_[j].w;
+        }
+        return y;
+    }
+
+    /**
+     * Bottom-left: lowest top edge, then lowest x. Returns false if the
+     * rect fits nowhere.
+     */
+    bool place(const BinRect& r, bool allow_rotate, PackPlacement& out) {
+        float best_top = FLT_MAX;
+        size_t best_i = 0;
+        bool found = false, best_rotated = false;
+        for (size_t i = 0; i < segments_.size(); i++) {
+            for (int o = 0; o < (allow_rotate ? 2 : 1); o++) {
+                float w = o ? r.h : r.w, h = o ? r.w : r.h;
+                float y = fit(i, w, h);
+                if (y < 0.0f) continue;
+                if (y + h < best_top) {
+                    best_top = y + h;
+                    best_i = i;
+                    best_rotated = o != 0;
+                    found = true;
+                }
+            }
+        }
+        if (!found) return false;
+
+        float w = best_rotated ? r.h : r.w, h = best_rotated ? r.w : r.h;
+        out.x = segments_[best_i].x;
+        out.y = best_top - h;
+        out.rotated = best_rotated;
+        add(best_i, w, best_top);
+        return true;
+    }
+
+private:
+    void add(size_t i, float w, float top) {
+        Segment seg = {segments_[i].x, top, w};
+        segments_.insert(segments_.begin() + i, seg);
+
+        // Trim the segments now under the new one
+        float end = seg.x + seg.w;
+        size_t j = i + 1;
+        while (j < segments_.size() && segments_[j].x < end) {
+            float shrink = end - segments_[j].x;
+            if (shrink < segments_[j].w) {
+                segments_[j].x += shrink;
+                segments_[j].w -= shrink;
+                break;
+            }
+            segments_.erase(segments_.begin() + j);
+        }
+
+        // Merge neighbours at the same height
+        for (size_t k = 0; k + 1 < segments_.size();) {
+            if (segments_[k].y == segments_[k + 1].y) {
+                segments_[k].w += segments_[k + 1].w;
+                segments_.erase(segments_.begin() + k + 1);
+            } else {
+                k++;
+            }
+        }
+    }
+
+    float side_;
+    float eps_;
+    std::vector<Segment> segments_;
+};
+
+// ---------------------------------------------------------------------------
+// MaxRects best-short-side-fit
+// ---------------------------------------------------------------------------
+
+struct FreeRect {
+    float x, y, w, h;
+};
+
+inline bool intersects(const FreeRect& a, const FreeRect& b) {
+    return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+inline bool contains(const FreeRect& outer, const FreeRect& inner) {
+    return inner.x >= outer.x && inner.y >= outer.y &&
+           inner.x + inner.w <= outer.x + outer.w && inner.y + inner.h <= outer.y + outer.h;
+}
+
+/**
+ * @brief Free rectangles with a uniform grid index over the bin
+ *
+ * Each live rect is listed in every cell it overlaps. Removal only marks
+ * the id dead (ids are never reused); cells drop dead ids when they are
+ * next queried. live() lists the live ids for the fit search.
+ */
+class FreeRectSet {
+public:
+    FreeRectSet(float side, int grid)
+        : grid_(grid), cell_size_(side / grid), epoch_(0), cells_((size_t)grid * grid) {}
+
+    int add(const FreeRect& r) {
+        int id = (int)rects_.size();
+        rects_.push_back(r);
+        alive_.push_back(1);
+        stamp_.push_back(0);
+        live_pos_.push_back((int)live_.size());
+        live_.push_back(id);
+        int x0, y0, x1, y1;
+        cell_range(r, x0, y0, x1, y1);
+        for (int cy = y0; cy <= y1; cy++) {
+            for (int cx = x0; cx <= x1; cx++) cells_[(size_t)cy * grid_ + cx].push_back(id);
+        }
+        return id;
+    }
+
+    void remove(int id) {
+        alive_[id] = 0;
+        int pos = live_pos_[id];
+        live_[pos] = live_.back();
+        live_pos_[live_[pos]] = pos;
+        live_.pop_back();
+    }
+
+    /** Call fn(id) once for every live rect whose cells overlap q */
+    template <typename Fn>
+    void query(const FreeRect& q, Fn fn) {
+        int x0, y0, x1, y1;
+        cell_range(q, x0, y0, x1, y1);
+        query_cells(x0, y0, x1, y1, fn);
+    }
+
+    /** Call fn(id) for every live rect whose cells hold the point (x, y) */
+    template <typename Fn>
+    void query_point(float x, float y, Fn fn) {
+        int cx = clamp_cell(x), cy = clamp_cell(y);
+        query_cells(cx, cy, cx, cy, fn);
+    }
+
+    const std::vector<FreeRect>& rects() const { return rects_; }
+    const std::vector<int>& live() const { return live_; }
+
+private:
+    template <typename Fn>
+    void query_cells(int x0, int y0, int x1, int y1, Fn fn) {
+        epoch_++;
+        for (int cy = y0; cy <= y1; cy++) {
+            for (int cx = x0; cx <= x1; cx++) {
+                std::vector<int>& cell = cells_[(size_t)cy * grid_ + cx];
+                size_t keep = 0;
+                for (size_t k = 0; k < cell.size(); k++) {
+                    int id = cell[k];
+                    if (!alive_[id]) continue;
+                    cell[keep++] = id;
+                    if (stamp_[id] == epoch_) continue;
+                    stamp_[id] = epoch_;
+                    ids_.push_back(id);
+                }
+                cell.resize(keep);
+            }
+        }
+        // fn may add or remove rects, so it runs after the cell walk
+        std::vector<int> ids;
+        ids.swap(ids_);
+        for (size_t k = 0; k < ids.size(); k++) fn(ids[k]);
+        ids.clear();
+        ids_.swap(ids);
+    }
+
+    void cell_range(const FreeRect& r, int& x0, int& y0, int& x1, int& y1) const {
+        x0 = clamp_cell(r.x);
+        y0 = clamp_cell(r.y);
+        x1 = clamp_cell(r.x + r.w);
+        y1 = clamp_cell(r.y + r.h);
+    }
+
+    int clamp_cell(float v) const {
+        int c = (int)(v / cell_size_);
+        return c < 0 ? 0 : (c >= grid_ ? grid_ - 1 : c);
+    }
+
+    int grid_;
+    float cell_size_;
+    unsigned epoch_;
+    std::vector<FreeRect> rects_;
+    std::vector<unsigned char> alive_;
+    std::vector<unsigned> stamp_;
+    std::vector<int> live_;
+    std::vector<int> live_pos_;
+    std::vector<std::vector<int> > cells_;
+    std::vector<int> ids_;
+};
+
+class MaxRects {
+public:
+    MaxRects(float side, int grid) : free_(side, grid), min_w_(0.0f), min_h_(0.0f), rotate_(false) {
+        free_.add({0.0f, 0.0f, side, side});
+    }
+
+    /**
+     * Smallest width and height among the rects still to place: free
+     * rects that none of them fits are dropped instead of kept
+     */
+    void set_remaining(float min_w, float min_h, bool allow_rotate) {
+        min_w_ = min_w;
+        min_h_ = min_h;
+        rotate_ = allow_rotate;
+    }
+
+    bool place(const BinRect& r, bool allow_rotate, PackPlacement& out) {
+        const std::vector<FreeRect>& rects = free_.rects();
+        const std::vector<int>& live = free_.live();
+        float best_short = FLT_MAX, best_long = FLT_MAX;
+        int best = -1;
+        bool best_rotated = false;
+        for (size_t k = 0; k < live.size(); k++) {
+            int i = live[k];
+            const FreeRect& fr = rects[i];
+            for (int o = 0; o < (allow_rotate ? 2 : 1); o++) {
+                float w = o ? r.h : r.w, h = o ? r.w : r.h;
+                if (w > fr.w || h > fr.h) continue;
+                float dw = fr.w - w, dh = fr.h - h;
+                float short_side = std::min(dw, dh), long_side = std::max(dw, dh);
+                if (short_side < best_short || (short_side == best_short && long_side < best_long)) {
+                    best_short = short_side;
+                    best_long = long_side;
+                    best = i;
+                    best_rotated = o != 0;
+                }
+            }
+        }
+        if (best < 0) return false;
+
+        FreeRect placed = {rects[best].x, rects[best].y,
+                           best_rotated ? r.h : r.w, best_rotated ? r.w : r.h};
+        out.x = placed.x;
+        out.y = placed.y;
+        out.rotated = best_rotated;
+        split(placed);
+        return true;
+    }
+
+private:
+    /** Replace every free rect overlapping `placed` by its maximal leftovers */
+    void split(const FreeRect& placed) {
+        fresh_.clear();
+        free_.query(placed, [&](int id) {
+            FreeRect fr = free_.rects()[id];
+            if (!intersects(fr, placed)) return;
+            free_.remove(id);
+            if (placed.x > fr.x) fresh_.push_back({fr.x, fr.y, placed.x - fr.x, fr.h});
+            if (placed.x + placed.w < fr.x + fr.w) {
+                float x = placed.x + placed.w;
+                fresh_.push_back({x, fr.y, fr.x + fr.w - x, fr.h});
+            }
+            if (placed.y > fr.y) fresh_.push_back({fr.x, fr.y, fr.w, placed.y - fr.y});
+            if (placed.y + placed.h < fr.y + fr.h) {
+                float y = placed.y + placed.h;
+                fresh_.push_back({fr.x, y, fr.w, fr.y + fr.h - y});
+            }
+        });
+
+        // New rects are pieces of removed ones, so an untouched free rect
+        // can only contain a new one, never the reverse. A rect containing
+        // r holds r's centre, so one grid cell has every candidate
+        for (size_t i = 0; i < fresh_.size(); i++) {
+            const FreeRect& r = fresh_[i];
+            bool redundant = false;
+            for (size_t j = 0; j < fresh_.size() && !redundant; j++) {
+                if (i == j || !contains(fresh_[j], r)) continue;
+                // Identical rects: keep the first
+                redundant = !contains(r, fresh_[j]) || j < i;
+            }
+            if (!redundant) {
+                free_.query_point(r.x + 0.5f * r.w, r.y + 0.5f * r.h, [&](int id) {
+                    if (!redundant && contains(free_.rects()[id], r)) redundant = true;
+                });
+            }
+            if (!redundant && useful(r)) free_.add(r);
+        }
+    }
+
+    bool useful(const FreeRect& r) const {
+        if (!rotate_) return r.w >= min_w_ && r.h >= min_h_;
+        // min_w_ / min_h_ hold the smallest short and long sides
+        return std::min(r.w, r.h) >= min_w_ && std::max(r.w, r.h) >= min_h_;
+    }
+
+    FreeRectSet free_;
+    std::vector<FreeRect> fresh_;
+    float min_w_, min_h_;
+    bool rotate_;
+};
+
+inline void set_remaining(Skyline&, float, float, bool) {}
+
+inline void set_remaining(MaxRects& engine, float min_w, float min_h, bool allow_rotate) {
+    engine.set_remaining(min_w, min_h, allow_rotate);
+}
+
+/**
+ * Suffix minima of the sides still to place (short / long sides when
+ * rotating), so engines can discard space nothing will fill
+ */
+void remaining_minima(const std::vector<PackRect>& rects,
+                      const std::vector<int>& order,
+                      bool allow_rotate,
+                      float pad,
+                      std::vector<float>& min_a,
+                      std::vector<float>& min_b) {
+    size_t n = order.size();
+    min_a.assign(n + 1, FLT_MAX);
+    min_b.assign(n + 1, FLT_MAX);
+    for (size_t k = n; k-- > 0;) {
+        const PackRect& r = rects[order[k]];
+        float a = allow_rotate ? std::min(r.w, r.h) : r.w;
+        float b = allow_rotate ? std::max(r.w, r.h) : r.h;
+        min_a[k] = std::min(min_a[k + 1], a + pad);
+        min_b[k] = std::min(min_b[k + 1], b + pad);
+    }
+}
+
+template <typename Engine>
+bool place_all(Engine& engine,
+               const std::vector<PackRect>& rects,
+               const std::vector<int>& order,
+               bool allow_rotate,
+               float pad,
+               std::vector<PackPlacement>& out) {
+    size_t n = order.size();
+    std::vector<float> min_a, min_b;
+    remaining_minima(rects, order, allow_rotate, pad, min_a, min_b);
+
+    for (size_t k = 0; k < n; k++) {
+        int i = order[k];
+        BinRect r = {rects[i].w + pad, rects[i].h + pad};
+        set_remaining(engine, min_a[k + 1], min_b[k + 1], allow_rotate);
+        if (!engine.place(r, allow_rotate, out[i])) return false;
+    }
+    return true;
+}
+
+/** Try to pack every rect (in `order`) into a square of the given side */
+bool try_pack(const std::vector<PackRect>& rects,
+              const std::vector<int>& order,
+              int method,
+              bool allow_rotate,
+              float side,
+              float pad,
+              std::vector<PackPlacement>& out) {
+    // Rects grow by the pad on their right and top; the bin grows with
+    // them so the last row and column may end exactly at `side`
+    float bin = side + pad;
+    if (method == PACK_METHOD_MAXRECTS) {
+        int grid = std::max(1, std::min(MAX_INDEX_GRID, (int)sqrt((double)order.size())));
+        MaxRects engine(bin, grid);
+        return place_all(engine, rects, order, allow_rotate, pad, out);
+    }
+    Skyline engine(bin);
+    return place_all(engine, rects, order, allow_rotate, pad, out);
+}
+
+/**
+ * Place every rect (in `order`) into unit tiles, one engine per tile.
+ * `spread` tries tiles from the least filled, else first-fit; tiles are
+ * opened as needed while fewer than max_tiles exist (max_tiles <= 0: no
+ * limit). Returns the tile count, or 0 if a rect fits no tile.
+ */
+template <typename Engine, typename Make>
+int place_tiles(Make make,
+                const std::vector<PackRect>& rects,
+                const std::vector<int>& order,
+                bool allow_rotate,
+                float pad,
+                int initial_tiles,
+                int max_tiles,
+                bool spread,
+                std::vector<PackPlacement>& out) {
+    std::vector<float> min_a, min_b;
+    remaining_minima(rects, order, allow_rotate, pad, min_a, min_b);
+
+    std::vector<Engine> tiles;
+    std::vector<double> fill;
+    for (int t = 0; t < initial_tiles; t++) {
+        tiles.push_back(make());
+        fill.push_back(0.0);
+    }
+    std::vector<int> candidates;
+    for (size_t k = 0; k < order.size(); k++) {
+        int i = order[k];
+        BinRect r = {rects[i].w + pad, rects[i].h + pad};
+
+        candidates.resize(tiles.size());
+        for (size_t t = 0; t < tiles.size(); t++) candidates[t] = (int)t;
+        if (spread) {
+            std::stable_sort(candidates.begin(), candidates.end(),
+                             [&](int a, int b) { return fill[a] < fill[b]; });
+        }
+        int placed = -1;
+        for (int t : candidates) {
+            set_remaining(tiles[t], min_a[k + 1], min_b[k + 1], allow_rotate);
+            if (tiles[t].place(r, allow_rotate, out[i])) {
+                placed = t;
+                break;
+            }
+        }
+        if (placed < 0) {
+            if (max_tiles > 0 && (int)tiles.size() >= max_tiles) return 0;
+            tiles.push_back(make());
+            fill.push_back(0.0);
+            placed = (int)tiles.size() - 1;
+            set_remaining(tiles[placed], min_a[k + 1], min_b[k + 1], allow_rotate);
+            if (!tiles[placed].place(r, allow_rotate, out[i])) return 0;
+        }
+        out[i].tile = placed;
+        fill[placed] += (double)r.w * r.h;
+    }
+    return (int)tiles.size();
+}
+
+int tiles_pack(const std::vector<PackRect>& rects,
+               const std::vector<int>& order,
+               int method,
+               bool allow_rotate,
+               float pad,
+               int initial_tiles,
+               int max_tiles,
+               bool spread,
+               std::vector<PackPlacement>& out) {
+    // As in try_pack, the bin grows by the pad so rects may end at 1
+    float bin = 1.0f + pad;
+    if (method == PACK_METHOD_MAXRECTS) {
+        int grid = std::max(1, std::min(MAX_INDEX_GRID, (int)sqrt((double)order.size())));
+        return place_tiles<MaxRects>([&]() { return MaxRects(bin, grid); }, rects, order,
+                                     allow_rotate, pad, initial_tiles, max_tiles, spread, out);
+    }
+    return place_tiles<Skyline>([&]() { return Skyline(bin); }, rects, order,
+                                allow_rotate, pad, initial_tiles, max_tiles, spread, out);
+}
+
+void reset_placements(size_t count, std::vector<PackPlacement>& out) {
+    out.assign(count, PackPlacement());
+    for (size_t i = 0; i < out.size(); i++) {
+        out[i].x = out[i].y = 0.0f;
+        out[i].rotated = false;
+        out[i].tile = 0;
+    }
+}
+
+} // namespace
+
+namespace uvunwrap {
+
+/*
+ * Largest side first, then largest area: the usual order for both
+ * engines; with rotation the skyline wants the long side down
+ */
+void packing_order(const std::vector<PackRect>& rects, std::vector<int>& order) {
+    order.clear();
+    for (size_t i = 0; i < rects.size(); i++) {
+        if (rects[i].w <= 0.0f && rects[i].h <= 0.0f) continue;
+        order.push_back((int)i);
+    }
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        float sa = std::max(rects[a].w, rects[a].h), sb = std::max(rects[b].w, rects[b].h);
+        if (sa != sb) return sa > sb;
+        return rects[a].w * rects[a].h > rects[b].w * rects[b].h;
+    });
+}
+
+float pack_rects_square(const std::vector<PackRect>& rects,
+                        int method,
+                        bool allow_rotate,
+                        float margin,
+                        std::vector<PackPlacement>& out) {
+    std::vector<int> order;
+    packing_order(rects, order);
+    return pack_rects_square_ordered(rects, order, method, allow_rotate, margin, out);
+}
+
+float pack_rects_square_ordered(const std::vector<PackRect>& rects,
+                                const std::vector<int>& order,
+                                int method,
+                                bool allow_rotate,
+                                float margin,
+                                std::vector<PackPlacement>& out) {
+    reset_placements(rects.size(), out);
+    if (order.empty()) return 0.0f;
+
+    double area = 0.0;
+    float max_side = 0.0f;
+    for (int i : order) {
+        area += (double)rects[i].w * rects[i].h;
+        max_side = std::max(max_side, std::max(rects[i].w, rects[i].h));
+    }
+
+    float max_margin = sqrtf(MAX_PAD_SHARE / (float)order.size());
+    if (margin > max_margin) {
+        LOG_WARNING("Island margin %.4f too large for %d islands, using %.4f",
+                    margin, (int)order.size(), max_margin);
+        margin = max_margin;
+    }
+    if (margin < 0.0f) margin = 0.0f;
+
+    // A square side can never be below the area bound or the largest rect
+    float lo = std::max((float)sqrt(area), max_side);
+    float hi = lo;
+    std::vector<PackPlacement> trial(rects.size(), out[0]);
+    bool packed = false;
+    for (int step = 0; step < GROW_STEPS; step++) {
+        if (try_pack(rects, order, method, allow_rotate, hi, margin * hi, trial)) {
+            packed = true;
+            break;
+        }
+        lo = hi;
+        hi *= GROW_FACTOR;
+    }
+    if (!packed) {
+        LOG_ERROR("Rect packing failed for %d rects", (int)order.size());
+        return 0.0f;
+    }
+    out = trial;
+
+    for (int step = 0; step < BISECT_STEPS && hi > lo; step++) {
+        float mid = 0.5f * (lo + hi);
+        if (try_pack(rects, order, method, allow_rotate, mid, margin * mid, trial)) {
+            hi = mid;
+            out = trial;
+        } else {
+            lo = mid;
+        }
+    }
+    return hi;
+}
+
+int pack_rects_tiles(const std::vector<PackRect>& rects,
+                     int method,
+                     bool allow_rotate,
+                     float margin,
+                     int num_tiles,
+                     std::vector<PackPlacement>& out) {
+    reset_placements(rects.size(), out);
+
+    std::vector<int> order;
+    packing_order(rects, order);
+    if (order.empty()) return num_tiles > 0 ? num_tiles : 1;
+    if (margin < 0.0f) margin = 0.0f;
+
+    if (num_tiles > 0) {
+        return tiles_pack(rects, order, method, allow_rotate, margin, num_tiles, num_tiles, true, out);
+    }
+
+    // First-fit finds the count; spreading over it evens the fill, and
+    // is kept only if it still fits
+    int count = tiles_pack(rects, order, method, allow_rotate, margin, 1, 0, false, out);
+    if (count <= 1) return count;
+    std::vector<PackPlacement> spread(out);
+    if (tiles_pack(rects, order, method, allow_rotate, margin, count, count, true, spread) == count) {
+        out.swap(spread);
+    }
+    return count;
+}
+
+} // namespace uvunwrap
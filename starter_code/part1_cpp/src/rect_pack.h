@@ -0,0 +1,92 @@
+/**
+ * @file rect_pack.h
+ * @brief Internal rectangle packers behind pack_uv_islands_ex()
+ *
+ * Not part of the public API. Packs axis-aligned rectangles into the
+ * smallest square found by bisection, or across unit tiles, with skyline
+ * bottom-left or MaxRects best-short-side-fit placement and optional 90°
+ * rotation.
+ */
+
+#ifndef UVUNWRAP_RECT_PACK_H
+#define UVUNWRAP_RECT_PACK_H
+
+#include <vector>
+
+namespace uvunwrap {
+
+struct PackRect {
+    float w, h;
+};
+
+struct PackPlacement {
+    float x, y;                // lower-left corner in [0, side]²
+    bool rotated;              // placed as h × w (90° counter-clockwise)
+    int tile;                  // tile index (pack_rects_tiles; 0 otherwise)
+};
+
+/**
+ * @brief Pack rects into a square and return its side
+ *
+ * Placed rects are at least margin * side apart, so after dividing by
+ * the side every gap is `margin` in [0,1]². A margin too large for the
+ * rect count is reduced (see the definition). Zero-size rects are placed
+ * at the origin.
+ *
+ * @param rects Rect sizes
+ * @param method PACK_METHOD_SKYLINE or PACK_METHOD_MAXRECTS
+ * @param allow_rotate Try each rect in both orientations
+ * @param margin Gap between rects as a fraction of the side
+ * @param out Placement per rect
+ * @return Square side (0 if every rect is empty)
+ */
+float pack_rects_square(const std::vector<PackRect>& rects,
+                        int method,
+                        bool allow_rotate,
+                        float margin,
+                        std::vector<PackPlacement>& out);
+
+/**
+ * @brief Non-empty rects in the order pack_rects_square() places them
+ */
+void packing_order(const std::vector<PackRect>& rects, std::vector<int>& order);
+
+/**
+ * @brief pack_rects_square() placing the rects in the given order
+ *
+ * Rects left out of order are placed at the origin, like empty ones.
+ * Orders other than packing_order() can pack tighter or looser; the
+ * anytime packer (uv_pack_anytime.h) searches over them.
+ */
+float pack_rects_square_ordered(const std::vector<PackRect>& rects,
+                                const std::vector<int>& order,
+                                int method,
+                                bool allow_rotate,
+                                float margin,
+                                std::vector<PackPlacement>& out);
+
+/**
+ * @brief Pack rects into unit squares ("tiles")
+ *
+ * With num_tiles > 0 every rect goes to the least filled tile it fits,
+ * which spreads the area evenly. With num_tiles <= 0 tiles are opened
+ * first-fit as needed and the rects are then spread over that count.
+ *
+ * @param rects Rect sizes in tile units
+ * @param method PACK_METHOD_SKYLINE or PACK_METHOD_MAXRECTS
+ * @param allow_rotate Try each rect in both orientations
+ * @param margin Gap between rects in tile units
+ * @param num_tiles Tiles to fill, or <= 0 for as many as needed
+ * @param out Placement per rect, with `tile` set
+ * @return Tiles used, or 0 if the rects do not fit
+ */
+int pack_rects_tiles(const std::vector<PackRect>& rects,
+                     int method,
+                     bool allow_rotate,
+                     float margin,
+                     int num_tiles,
+                     std::vector<PackPlacement>& out);
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_RECT_PACK_H */
@@ -0,0 +1,44 @@
+/**
+ * @file result_cache.h
+ * @brief Internal hooks the unwrap pipeline uses to reach the result cache
+ *
+ * Not part of the public API; see unwrap_cache.h.
+ */
+
+#ifndef UVUNWRAP_RESULT_CACHE_H
+#define UVUNWRAP_RESULT_CACHE_H
+
+#include "unwrap.h"
+#include "mesh_bin.h"
+#include <stdint.h>
+
+namespace uvunwrap {
+
+/**
+ * @brief Cached output for (mesh, params); UV_OUTPUT_SPLIT_VERTICES and
+ *        reordered (UnwrapParams::output_order) outputs are never cached
+ * @param key_out Set to the entry key to pass to result_cache_store(), or
+ *        0 when no cache is configured
+ * @return Output mesh with *result_out set (owned as from unwrap_mesh()),
+ *         or NULL on a miss
+ */
+Mesh* result_cache_lookup(const Mesh* mesh, const UnwrapParams* params,
+                          UnwrapResult** result_out, uint64_t* key_out);
+
+/** Store an output under the key result_cache_lookup() gave; no-op for key 0 */
+void result_cache_store(uint64_t key, const Mesh* output, const UnwrapResult* result);
+
+/**
+ * @brief Raw entry of the on-disk cache under a caller's key (the island
+ *        cache keeps solved islands there)
+ * @return The entry, checksums verified, or NULL if no cache is configured
+ *         or it has none; free with free_mesh_bin()
+ */
+MeshBin* result_cache_load_entry(uint64_t key);
+
+/** Write mesh (with its uvs) as the entry of key; false if not stored */
+bool result_cache_save_entry(uint64_t key, const Mesh* mesh);
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_RESULT_CACHE_H */
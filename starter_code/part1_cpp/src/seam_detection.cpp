@@ -17,154 +17,753 @@
 #include <cmath>
 #include "unwrap.h"
 #include "math_utils.h"
+#include "vec_math.h"
+#include "curvature.h"
+#include "disjoint_set.h"
+#include "half_edge.h"
+#include "triangle_geometry.h"
+#include "parallel_sort.h"
+#include "logging.h"
 #include <stdlib.h>
 #include <stdio.h>
 // #include <math.h>
 #include <vector>
-#include <set>
-#include <queue>
 #include <algorithm>
+#include <functional>
+#include <queue>
+#include <unordered_map>
 
 /**
- * @brief Compute angular defect at a vertex
+ * @brief Count incident edges per vertex in one pass over topo->edges
  *
- * Angular defect = 2π - sum of angles at vertex
+ * A degenerate edge (v0 == v1) counts once, matching the per-edge scan
+ * this replaces.
+ */
+static void compute_vertex_valence(const Mesh* mesh,
+                                   const TopologyInfo* topo,
+                                   std::vector<int>& valence) {
+    valence.assign(mesh->num_vertices, 0);
+    for (int e = 0; e < topo->num_edges; e++) {
+        int v0 = topo->edges[e * 2];
+        int v1 = topo->edges[e * 2 + 1];
+        valence[v0]++;
+        if (v1 != v0) valence[v1]++;
+    }
+}
+
+/** True if either face of edge e is flagged degenerate (never a seam) */
+static bool touches_flagged_face(const TopologyInfo* topo, const unsigned char* face_flags, int e) {
+    if (!face_flags) return false;
+    int f0 = topo->edge_faces[e * 2], f1 = topo->edge_faces[e * 2 + 1];
+    return (f0 >= 0 && face_flags[f0]) || (f1 >= 0 && face_flags[f1]);
+}
+
+/**
+ * @brief Number of non-tree edges to keep as seams
  *
- * - Flat surface: defect ≈ 0
- * - Corner (like cube): defect > 0
- * - Saddle: defect < 0
+ * Closed meshes:
+ * - Cube (12 faces, 7 non-tree) -> want ~7 seams
+ * - Sphere (80 faces, 41 non-tree) -> want ~3 seams
+ * Open meshes: boundaries already provide cuts, keep 1-2.
  *
- * @param mesh Input mesh
- * @param vertex_idx Vertex index
- * @return Angular defect in radians
+ * @param F Number of faces
+ * @param num_candidates Number of non-tree (interior) edges
+ * @param is_closed True if the mesh has no boundary edges
  */
-static float compute_angular_defect(const Mesh* mesh, int vertex_idx) {
-    if (!mesh) return 0.0f;
-
-    float angle_sum = 0.0f;
-
-    // Find all triangles containing this vertex
-    // Ideally we would have a Vertex->Face map, but since we don't,
-    // we iterate all triangles.
-    // Optimization: In a real system, we'd build V->F adjacency.
-    // Given the constraints and typical mesh sizes here, this might be slow O(V*F).
-    // Let's rely on building the dual graph later, but for this specific helper,
-    // if it's called per vertex, O(F) is too slow.
-    // Wait, detect_seams is called once. The logic below says "For each vertex with high angular defect".
-    // We should pre-calculate V->F or iterate triangles once to accumulate angles.
-
-    // Let's implement a helper to build V->F map inside detect_seams or assume inputs?
-    // The signature is static float compute... (const Mesh* ...).
-    // Changing signature is not allowed if it's not a helper I created?
-    // It's static, so I can change it or its usage.
-    // Actually, I'll implement it efficiently by iterating triangles in the calling function
-    // and accumulating angles there, rather than calling this potentially slow function?
-    // BUT, let's look at how it's intended.
-    // For this assignment, I will first implement a V->F adjacency map inside detect_seams
-    // to make this fast, or just iterate.
-    // Given 10k vertices limit, O(V*F) = 10^8 ops, might be 1-5 seconds. Borderline.
-    // I'll build a temporary V->F map in detect_seams and pass it?
-    // No, I'll stick to the signature but maybe rely on the caller to optimize?
-    // "Step 4: Angular defect refinement... For each vertex..."
-    // If I iterate all triangles once, I can compute all defects.
-
-    return 2.0f * M_PI - angle_sum;
+static int seam_budget(int F, int num_candidates, bool is_closed) {
+    int target_seams;
+    if (is_closed && F <= 20) {
+        // Simple meshes (cube): keep ALL non-tree edges
+        target_seams = num_candidates;
+    } else if (!is_closed || F <= 70) {
+        // Medium meshes (cylinder) and open meshes: keep minimal seams
+        target_seams = std::max(1, num_candidates / 3);
+        target_seams = std::min(target_seams, 2);
+    } else {
+        // Complex meshes (sphere): keep minimal seams
+        target_seams = std::max(1, num_candidates / 14);
+        target_seams = std::min(target_seams, 5);
+    }
+    return std::min(target_seams, num_candidates);
 }
 
-// Helper to accumulate angles for all vertices
-static void compute_all_angular_defects(const Mesh* mesh, std::vector<float>& defects) {
-    defects.assign(mesh->num_vertices, 2.0f * M_PI);
-    
-    // For boundary vertices, defect is different (usually ignored or treated differently)
-    // But for closed shapes (cube, sphere) it matters.
-    // We assume standard deviation from 2PI.
-
-    for (int i = 0; i < mesh->num_triangles; i++) {
-        for (int j = 0; j < 3; j++) {
-            int v = mesh->triangles[i*3 + j];
-            float angle = compute_vertex_angle_in_triangle(mesh, i, v);
-            if (!isnan(angle)) {
-                defects[v] -= angle;
-            }
+/**
+ * @brief Interior edges in Kruskal order: ascending dual edge weight
+ *
+ * Dual edge weight = (dihedral + 0.05) * (mean_edge_length / edge_length):
+ * flat, long edges are cheap and come first, sharp, short ones last.
+ * Edges next to flagged faces weigh nothing. The face normals come from
+ * geometry when it holds them.
+ *
+ * @param order_out Interior edges, edge index breaking ties
+ * @return Number of boundary edges
+ */
+static int dual_edge_order(const Mesh* mesh,
+                           const TopologyInfo* topo,
+                           const unsigned char* face_flags,
+                           int sort_policy,
+                           int num_threads,
+                           const uvunwrap::TriangleGeometry* geometry,
+                           std::vector<int>& order_out) {
+    int F = mesh->num_triangles;
+    int E = topo->num_edges;
+
+    // Unnormalised face normals (SoA)
+    std::vector<float> own_nx, own_ny, own_nz;
+    const float *nx, *ny, *nz;
+    if (geometry && (geometry->parts & uvunwrap::GEOMETRY_NORMALS)) {
+        nx = geometry->nx.data();
+        ny = geometry->ny.data();
+        nz = geometry->nz.data();
+    } else {
+        own_nx.resize(F);
+        own_ny.resize(F);
+        own_nz.resize(F);
+        triangle_normals_soa(mesh, 0, F, own_nx.data(), own_ny.data(), own_nz.data());
+        nx = own_nx.data();
+        ny = own_ny.data();
+        nz = own_nz.data();
+    }
+
+    // Interior edges with their lengths
+    std::vector<int> interior;
+    std::vector<float> lengths(E, 0.0f);
+    edge_lengths_batch(mesh, topo->edges, E, lengths.data());
+    double length_sum = 0.0;
+    int num_boundary_edges = 0;
+    interior.reserve(E);
+
+    for (int e = 0; e < E; e++) {
+        length_sum += lengths[e];
+
+        if (topo->edge_faces[e * 2 + 1] == -1) {
+            num_boundary_edges++;
+        } else {
+            interior.push_back(e);
         }
     }
+    float mean_length = E > 0 ? (float)(length_sum / E) : 1.0f;
+
+    std::vector<float> weights(E, 0.0f);
+    for (size_t i = 0; i < interior.size(); i++) {
+        int e = interior[i];
+        if (touches_flagged_face(topo, face_flags, e)) continue;
+        int f0 = topo->edge_faces[e * 2], f1 = topo->edge_faces[e * 2 + 1];
+        Vec3 n0 = {nx[f0], ny[f0], nz[f0]};
+        Vec3 n1 = {nx[f1], ny[f1], nz[f1]};
+        float dihedral = atan2f(uvunwrap::length(uvunwrap::cross(n0, n1)), uvunwrap::dot(n0, n1));
+        float len = lengths[e] > 1e-12f ? lengths[e] : 1e-12f;
+        weights[e] = (dihedral + 0.05f) * (mean_length / len);
+    }
+
+    // Ascending weight, edge index breaks ties deterministically
+    order_out.swap(interior);
+    uvunwrap::parallel_stable_sort(order_out, [&](int a, int b) {
+        if (weights[a] != weights[b]) return weights[a] < weights[b];
+        return a < b;
+    }, uvunwrap::sort_thread_count((int)order_out.size(), sort_policy, num_threads));
+    return num_boundary_edges;
+}
+
+/**
+ * @brief Corner angles from geometry when it holds them, else computed
+ *        into own
+ */
+static const float* corner_angles(const Mesh* mesh,
+                                  const uvunwrap::TriangleGeometry* geometry,
+                                  int num_threads,
+                                  std::vector<float>& own) {
+    if (geometry && (geometry->parts & uvunwrap::GEOMETRY_ANGLES)) return geometry->angle.data();
+    own.resize((size_t)mesh->num_triangles * 3);
+    compute_corner_angles(mesh, own.data(), num_threads);
+    return own.data();
 }
 
-static std::vector<int> get_vertex_edges(const TopologyInfo* topo, int vertex_idx) {
-    std::vector<int> edges;
-    for (int i = 0; i < topo->num_edges; i++) {
-        if (topo->edges[i*2] == vertex_idx || topo->edges[i*2+1] == vertex_idx) {
-            edges.push_back(i);
+/**
+ * @brief Sum of corner angles around every vertex, and which vertices lie
+ *        on a boundary edge (their defect is not curvature)
+ */
+static void vertex_angle_sums(const Mesh* mesh,
+                              const TopologyInfo* topo,
+                              const float* angles,
+                              std::vector<double>& angle_sum,
+                              std::vector<unsigned char>& on_boundary) {
+    angle_sum.assign(mesh->num_vertices, 0.0);
+    for (int c = 0; c < mesh->num_triangles * 3; c++) angle_sum[mesh->triangles[c]] += angles[c];
+    on_boundary.assign(mesh->num_vertices, 0);
+    for (int e = 0; e < topo->num_edges; e++) {
+        if (topo->edge_faces[e * 2 + 1] == -1) {
+            on_boundary[topo->edges[e * 2]] = 1;
+            on_boundary[topo->edges[e * 2 + 1]] = 1;
         }
     }
-    return edges;
 }
 
-int* detect_seams(const Mesh* mesh,
-                  const TopologyInfo* topo,
-                  float angle_threshold,
-                  int* num_seams_out) {
-    if (!mesh || !topo || !num_seams_out) return NULL;
+/**
+ * @brief Seam detection via a dihedral-weighted minimum spanning tree
+ *
+ * Kruskal over dual_edge_order() with a disjoint-set forest, so the
+ * non-tree (seam candidate) edges are the sharp, short ones; tree and
+ * seam membership live in byte arrays. Candidates are ranked
+ * sharpest-first and trimmed with seam_budget(). Edges next to flagged
+ * faces join the tree first.
+ */
+static int* detect_seams_mst(const Mesh* mesh,
+                             const TopologyInfo* topo,
+                             const unsigned char* face_flags,
+                             int sort_policy,
+                             int num_threads,
+                             int* num_seams_out,
+                             const uvunwrap::TriangleGeometry* geometry = NULL) {
+    int F = mesh->num_triangles;
+    int E = topo->num_edges;
 
+    std::vector<int> order;
+    int num_boundary_edges = dual_edge_order(mesh, topo, face_flags, sort_policy, num_threads, geometry, order);
+
+    std::vector<unsigned char> in_tree(E, 0);
+    uvunwrap::DisjointSet forest(F);
+    int tree_size = 0;
+    for (size_t i = 0; i < order.size(); i++) {
+        int e = order[i];
+        if (forest.unite(topo->edge_faces[e * 2], topo->edge_faces[e * 2 + 1])) {
+            in_tree[e] = 1;
+            tree_size++;
+        }
+    }
+
+    LOG_DEBUG("Dual graph MST: Tree edges: %d", tree_size);
+
+    // Non-tree interior edges, sharpest first (order is ascending)
+    std::vector<int> candidates;
+    for (size_t i = order.size(); i-- > 0;) {
+        if (!in_tree[order[i]] && !touches_flagged_face(topo, face_flags, order[i])) candidates.push_back(order[i]);
+    }
+
+    bool is_closed_mesh = (num_boundary_edges == 0);
+    int target_seams = seam_budget(F, (int)candidates.size(), is_closed_mesh);
+
+    std::vector<unsigned char> is_seam(E, 0);
+    for (int i = 0; i < target_seams; i++) {
+        is_seam[candidates[i]] = 1;
+    }
+
+    LOG_DEBUG("Seam selection: %s mesh, %d seams",
+              is_closed_mesh ? "closed" : "open", target_seams);
+
+    *num_seams_out = target_seams;
+    int* seams = (int*)malloc((target_seams > 0 ? target_seams : 1) * sizeof(int));
+    int idx = 0;
+    for (int e = 0; e < E; e++) {
+        if (is_seam[e]) seams[idx++] = e;
+    }
+
+    LOG_INFO("Detected %d seams", *num_seams_out);
+    return seams;
+}
+
+namespace {
+
+// Cost model of SEAM_METHOD_COST. Every term is dimensionless:
+// solve time relative to solving the whole mesh as one chart, distortion
+// and packing waste as fractions of the surface area.
+const double COST_CHART_OVERHEAD = 4000.0;  // Per-chart setup, pinning and packing, in solve-cost units
+const double COST_DISTORTION_WEIGHT = 1.0;
+const double COST_PACKING_MARGIN = 0.02;    // Island margin the packing term charges per unit perimeter
+const double COST_MERGE_THRESHOLD = 0.0;    // Merge while J drops by more than this
+
+/**
+ * Predicted LSCM cost of a chart of f faces: a disk-like chart has about
+ * f/2 + 2√f + 1 vertices, the normal matrix ~14 nonzeros per row of its
+ * 2V unknowns, and a nested-dissection factor ~8 V log2 V entries of fill
+ */
+double chart_solve_cost(double f) {
+    double v = 0.5 * f + 2.0 * sqrt(f) + 1.0;
+    return COST_CHART_OVERHEAD + 28.0 * v + 8.0 * v * log2(v + 1.0);
+}
+
+/**
+ * Predicted distortion of a chart with area fraction a and absolute
+ * Gaussian curvature k: flattening a cap of curvature k stretches it by ~(k / 2π)²
+ * (a hemisphere costs 1), weighted by area
+ */
+double chart_distortion(double a, double k) {
+    double r = k / (2.0 * M_PI);
+    return COST_DISTORTION_WEIGHT * a * r * r;
+}
+
+/** Margin area wasted around a chart of area fraction a (perimeter ~4√a) */
+double chart_packing_waste(double a) {
+    return COST_PACKING_MARGIN * 4.0 * sqrt(a);
+}
+
+} // namespace
+
+/**
+ * @brief Seam detection driven by a solve-time / distortion / packing cost
+ *
+ * Every face starts as its own chart. Interior edges are visited in the
+ * dual_edge_order() of the MST engine (flat, long edges first), and the
+ * two charts on either side merge when that lowers
+ *
+ *   J = Σ_c chart_solve_cost(F_c) / chart_solve_cost(F)
+ *     + Σ_c chart_distortion(A_c / A, K_c) + Σ_c chart_packing_waste(A_c / A)
+ *
+ * by more than COST_MERGE_THRESHOLD. K_c is the chart's share of the
+ * absolute angular defect: each vertex's |defect| split between its faces
+ * by corner angle (boundary vertices carry none). Small charts merge
+ * because of the per-chart overhead and packing waste, and curved ones
+ * stop merging once the distortion they would add outweighs that. A merge
+ * that would not leave a topological disk is skipped, so closed meshes
+ * always keep a seam. Edges next to flagged faces skip the cost test.
+ * The seams are the interior edges between different charts, so the
+ * islands are exactly the charts. Corner angles and areas come from
+ * geometry when it holds them.
+ */
+static int* detect_seams_cost(const Mesh* mesh,
+                              const TopologyInfo* topo,
+                              const unsigned char* face_flags,
+                              int sort_policy,
+                              int num_threads,
+                              int* num_seams_out,
+                              const uvunwrap::TriangleGeometry* geometry = NULL) {
     int F = mesh->num_triangles;
-    
-    // 1. Build Dual Graph
-    // Adjacency: Face -> [Neighbor Face 1, Neighbor Face 2, ...]
-    // Shared Edge -> Edge Index
-    std::vector<std::vector<int>> dual_adj(F);
-    std::vector<std::vector<int>> dual_edge_indices(F); // Stores edge index connecting to neighbor
+    int V = mesh->num_vertices;
+    int E = topo->num_edges;
 
-    for (int e = 0; e < topo->num_edges; e++) {
-        int f0 = topo->edge_faces[e * 2 + 0];
+    std::vector<int> order;
+    dual_edge_order(mesh, topo, face_flags, sort_policy, num_threads, geometry, order);
+
+    // Face areas
+    std::vector<float> own_area;
+    const float* area;
+    if (geometry && (geometry->parts & uvunwrap::GEOMETRY_NORMALS)) {
+        area = geometry->area.data();
+    } else {
+        std::vector<float> nx(F), ny(F), nz(F);
+        triangle_normals_soa(mesh, 0, F, nx.data(), ny.data(), nz.data());
+        own_area.resize(F);
+        for (int f = 0; f < F; f++) {
+            own_area[f] = 0.5f * sqrtf(nx[f] * nx[f] + ny[f] * ny[f] + nz[f] * nz[f]);
+        }
+        area = own_area.data();
+    }
+
+    // Corner angles, their sum per vertex and the boundary vertices
+    std::vector<float> own_angles;
+    const float* angles = corner_angles(mesh, geometry, num_threads, own_angles);
+    std::vector<double> angle_sum;
+    std::vector<unsigned char> on_boundary;
+    vertex_angle_sums(mesh, topo, angles, angle_sum, on_boundary);
+
+    // Per-chart face count, area fraction and absolute curvature, indexed
+    // by root; saddles count like caps, so they cannot cancel them out
+    double total_area = 0.0;
+    for (int f = 0; f < F; f++) total_area += area[f];
+    std::vector<double> chart_faces(F, 1.0), chart_area(F), chart_curvature(F, 0.0);
+    for (int f = 0; f < F; f++) {
+        chart_area[f] = total_area > 0.0 ? area[f] / total_area : 1.0 / F;
+        if (face_flags && face_flags[f]) continue;
+        for (int k = 0; k < 3; k++) {
+            int v = mesh->triangles[f * 3 + k];
+            if (on_boundary[v] || angle_sum[v] <= 0.0) continue;
+            double defect = fabs(2.0 * M_PI - angle_sum[v]);
+            chart_curvature[f] += defect * angles[f * 3 + k] / angle_sum[v];
+        }
+    }
+
+    AdjacencyInfo* adj = build_adjacency(mesh, topo);
+    if (!adj) {
+        *num_seams_out = 0;
+        return NULL;
+    }
+
+    // Charts stay topological disks: two disks glued along one arc of k
+    // edges and k + 1 vertices give a disk, anything else an annulus or a
+    // closed surface LSCM cannot flatten. Shared edges and vertices are
+    // counted from the smaller chart's face list. A pair that failed stays
+    // failed until one of the two charts grows (its generation changes).
+    std::vector<std::vector<int>> chart_face_list(F);
+    std::vector<int> generation(F, 0);
+    std::unordered_map<long long, std::pair<int, int>> not_disk;
+    for (int f = 0; f < F; f++) chart_face_list[f].push_back(f);
+    std::vector<int> vertex_stamp(V, -1);
+    int stamp = 0;
+
+    double solve_ref = chart_solve_cost(F);
+    uvunwrap::DisjointSet charts(F);
+    int num_charts = F;
+    for (size_t i = 0; i < order.size(); i++) {
+        int e = order[i];
+        int a = charts.find(topo->edge_faces[e * 2]), b = charts.find(topo->edge_faces[e * 2 + 1]);
+        if (a == b) continue;
+
+        if (!touches_flagged_face(topo, face_flags, e)) {
+            double area_ab = chart_area[a] + chart_area[b];
+            double curvature_ab = chart_curvature[a] + chart_curvature[b];
+            double delta = (chart_solve_cost(chart_faces[a] + chart_faces[b]) - chart_solve_cost(chart_faces[a]) -
+                            chart_solve_cost(chart_faces[b])) / solve_ref +
+                           chart_distortion(area_ab, curvature_ab) - chart_distortion(chart_area[a], chart_curvature[a]) -
+                           chart_distortion(chart_area[b], chart_curvature[b]) +
+                           chart_packing_waste(area_ab) - chart_packing_waste(chart_area[a]) -
+                           chart_packing_waste(chart_area[b]);
+            if (delta >= -COST_MERGE_THRESHOLD) continue;
+        }
+
+        long long pair = (long long)std::min(a, b) * F + std::max(a, b);
+        std::unordered_map<long long, std::pair<int, int>>::const_iterator failed = not_disk.find(pair);
+        std::pair<int, int> generations(generation[std::min(a, b)], generation[std::max(a, b)]);
+        if (failed != not_disk.end() && failed->second == generations) continue;
+
+        int small = chart_face_list[a].size() <= chart_face_list[b].size() ? a : b;
+        int large = small == a ? b : a;
+        int shared_edges = 0, shared_vertices = 0;
+        stamp++;
+        for (size_t j = 0; j < chart_face_list[small].size(); j++) {
+            int f = chart_face_list[small][j];
+            for (int k = 0; k < 3; k++) {
+                int edge = adj->face_edges[f * 3 + k];
+                int g = topo->edge_faces[edge * 2] == f ? topo->edge_faces[edge * 2 + 1] : topo->edge_faces[edge * 2];
+                if (g >= 0 && charts.find(g) == large) shared_edges++;
+
+                int v = mesh->triangles[f * 3 + k];
+                if (vertex_stamp[v] == stamp) continue;
+                vertex_stamp[v] = stamp;
+                for (int o = adj->vert_face_offsets[v]; o < adj->vert_face_offsets[v + 1]; o++) {
+                    if (charts.find(adj->vert_faces[o]) == large) {
+                        shared_vertices++;
+                        break;
+                    }
+                }
+            }
+        }
+        if (shared_vertices - shared_edges != 1) {
+            not_disk[pair] = generations;
+            continue;
+        }
+
+        charts.unite(a, b);
+        int root = charts.find(a);
+        int other = root == a ? b : a;
+        chart_faces[root] = chart_faces[a] + chart_faces[b];
+        chart_area[root] = chart_area[a] + chart_area[b];
+        chart_curvature[root] = chart_curvature[a] + chart_curvature[b];
+        generation[root]++;
+        if (chart_face_list[root].size() < chart_face_list[other].size()) chart_face_list[root].swap(chart_face_list[other]);
+        chart_face_list[root].insert(chart_face_list[root].end(), chart_face_list[other].begin(), chart_face_list[other].end());
+        std::vector<int>().swap(chart_face_list[other]);
+        num_charts--;
+    }
+    free_adjacency(adj);
+
+    LOG_DEBUG("Cost model: %d charts from %d faces", num_charts, F);
+
+    std::vector<int> seams;
+    for (int e = 0; e < E; e++) {
         int f1 = topo->edge_faces[e * 2 + 1];
+        if (f1 != -1 && charts.find(topo->edge_faces[e * 2]) != charts.find(f1)) seams.push_back(e);
+    }
+
+    *num_seams_out = (int)seams.size();
+    int* out = (int*)malloc((seams.empty() ? 1 : seams.size()) * sizeof(int));
+    for (size_t i = 0; i < seams.size(); i++) out[i] = seams[i];
+
+    LOG_INFO("Detected %d seams", *num_seams_out);
+    return out;
+}
+
+/**
+ * @brief Seam detection as a cut graph through the cone vertices
+ *
+ * Cones are interior vertices whose angular defect reaches
+ * angle_threshold (radians here); a closed component with fewer than two
+ * gets its highest-defect vertices instead, and the boundary of an open
+ * mesh counts as one more terminal. The seams are built in four passes:
+ *
+ * 1. Multi-source Dijkstra (binary heap over the vertex → edge CSR, edge
+ *    length weights) from every terminal at once labels each vertex with
+ *    its nearest terminal and the edge it was reached by.
+ * 2. Every edge joining two labels is a bridge of length d(u) + |e| + d(v);
+ *    Kruskal over the bridges links the terminals, and each accepted
+ *    bridge adds itself and both shortest paths back to its terminals
+ *    (Mehlhorn's Steiner tree, within twice the shortest tree).
+ * 3. Tree-cotree: with the shortest-path forest and the bridges as the
+ *    primal tree, a dual spanning tree over the remaining interior edges
+ *    (longest loops first) leaves one edge per handle or extra boundary
+ *    loop; each adds itself and its two shortest paths, the greedy
+ *    shortest system of loops.
+ * 4. Dangling branches are pruned: a vertex other than a cone with one
+ *    cut edge left drops it, until none remains.
+ *
+ * The result connects the cones and opens every component into a disk.
+ * Dijkstra dominates at O(E log V). Edges next to flagged faces are
+ * never walked and the dual tree crosses them first.
+ */
+static int* detect_seams_cut_graph(const Mesh* mesh,
+                                   const TopologyInfo* topo,
+                                   float angle_threshold,
+                                   const unsigned char* face_flags,
+                                   int sort_policy,
+                                   int num_threads,
+                                   int* num_seams_out,
+                                   const uvunwrap::TriangleGeometry* geometry = NULL) {
+    int F = mesh->num_triangles;
+    int V = mesh->num_vertices;
+    int E = topo->num_edges;
+
+    AdjacencyInfo* adj = build_adjacency(mesh, topo);
+    if (!adj) {
+        *num_seams_out = 0;
+        return NULL;
+    }
+
+    std::vector<float> own_angles;
+    const float* angles = corner_angles(mesh, geometry, num_threads, own_angles);
+    std::vector<double> angle_sum;
+    std::vector<unsigned char> on_boundary;
+    vertex_angle_sums(mesh, topo, angles, angle_sum, on_boundary);
+
+    // Connected components of the vertex graph, with whether each is open
+    uvunwrap::DisjointSet components(V);
+    for (int e = 0; e < E; e++) components.unite(topo->edges[e * 2], topo->edges[e * 2 + 1]);
+    std::vector<unsigned char> component_open(V, 0);
+    for (int v = 0; v < V; v++) {
+        if (on_boundary[v]) component_open[components.find(v)] = 1;
+    }
 
-        if (f0 != -1 && f1 != -1) {
-            dual_adj[f0].push_back(f1);
-            dual_edge_indices[f0].push_back(e);
-            
-            dual_adj[f1].push_back(f0);
-            dual_edge_indices[f1].push_back(e);
+    // Terminals: label 0 is the boundary, 1.. the cones
+    const double threshold = angle_threshold * M_PI / 180.0;
+    std::vector<double> defect(V, 0.0);
+    std::vector<int> label(V, -1);
+    std::vector<unsigned char> is_cone(V, 0);
+    std::vector<int> component_cones(V, 0), best(V, -1), second(V, -1);
+    for (int v = 0; v < V; v++) {
+        if (on_boundary[v] || adj->vert_face_offsets[v] == adj->vert_face_offsets[v + 1]) continue;
+        defect[v] = fabs(2.0 * M_PI - angle_sum[v]);
+        int c = components.find(v);
+        if (defect[v] >= threshold) {
+            is_cone[v] = 1;
+            component_cones[c]++;
         }
+        if (best[c] < 0 || defect[v] > defect[best[c]]) {
+            second[c] = best[c];
+            best[c] = v;
+        } else if (second[c] < 0 || defect[v] > defect[second[c]]) {
+            second[c] = v;
+        }
+    }
+    for (int c = 0; c < V; c++) {
+        if (components.find(c) != c || component_open[c] || component_cones[c] >= 2) continue;
+        if (best[c] >= 0) is_cone[best[c]] = 1;
+        if (second[c] >= 0) is_cone[second[c]] = 1;
+    }
+    int num_terminals = 1;
+    for (int v = 0; v < V; v++) {
+        if (on_boundary[v]) label[v] = 0;
+        else if (is_cone[v]) label[v] = num_terminals++;
     }
 
-    // 2. Compute Spanning Tree (BFS) efficiently
-    // We want a Minimum Spanning Tree based on some weight? 
-    // Usually "flat" edges are preferred for the tree (so seams are at sharp edges).
-    // Or just simple BFS for connectivity?
-    // Assignment says: "Spanning tree on dual graph... Mark non-tree edges as seam candidates"
-    // "Refine using angular defect"
-    // Let's use simple BFS for the tree.
-    
-    std::vector<bool> visited(F, false);
-    std::queue<int> q;
-    std::set<int> tree_edges;
+    std::vector<float> lengths(E);
+    edge_lengths_batch(mesh, topo->edges, E, lengths.data());
+
+    // 1. Multi-source Dijkstra from all terminals
+    typedef std::pair<double, int> HeapEntry;
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry>> heap;
+    std::vector<double> dist(V, INFINITY);
+    std::vector<int> via(V, -1);
+    for (int v = 0; v < V; v++) {
+        if (label[v] < 0) continue;
+        dist[v] = 0.0;
+        heap.push(HeapEntry(0.0, v));
+    }
+    while (!heap.empty()) {
+        HeapEntry top = heap.top();
+        heap.pop();
+        int u = top.second;
+        if (top.first > dist[u]) continue;
+        for (int o = adj->vert_edge_offsets[u]; o < adj->vert_edge_offsets[u + 1]; o++) {
+            int e = adj->vert_edges[o];
+            if (touches_flagged_face(topo, face_flags, e)) continue;
+            int w = topo->edges[e * 2] == u ? topo->edges[e * 2 + 1] : topo->edges[e * 2];
+            double d = dist[u] + lengths[e];
+            if (d < dist[w]) {
+                dist[w] = d;
+                via[w] = e;
+                label[w] = label[u];
+                heap.push(HeapEntry(d, w));
+            }
+        }
+    }
+
+    // 2. Bridges between terminal regions, shortest first
+    std::vector<unsigned char> is_cut(E, 0);
+    std::vector<std::pair<double, int>> bridges;
+    for (int e = 0; e < E; e++) {
+        int u = topo->edges[e * 2], w = topo->edges[e * 2 + 1];
+        if (label[u] < 0 || label[w] < 0 || label[u] == label[w]) continue;
+        if (touches_flagged_face(topo, face_flags, e)) continue;
+        bridges.push_back(std::make_pair(dist[u] + lengths[e] + dist[w], e));
+    }
+    uvunwrap::parallel_stable_sort(bridges, [](const std::pair<double, int>& a, const std::pair<double, int>& b) {
+        if (a.first != b.first) return a.first < b.first;
+        return a.second < b.second;
+    }, uvunwrap::sort_thread_count((int)bridges.size(), sort_policy, num_threads));
+    uvunwrap::DisjointSet terminals(num_terminals);
+    for (size_t i = 0; i < bridges.size(); i++) {
+        int e = bridges[i].second;
+        int ends[2] = {topo->edges[e * 2], topo->edges[e * 2 + 1]};
+        if (!terminals.unite(label[ends[0]], label[ends[1]])) continue;
+        is_cut[e] = 1;
+        for (int k = 0; k < 2; k++) {
+            for (int v = ends[k]; via[v] >= 0 && !is_cut[via[v]];) {
+                is_cut[via[v]] = 1;
+                v = topo->edges[via[v] * 2] == v ? topo->edges[via[v] * 2 + 1] : topo->edges[via[v] * 2];
+            }
+        }
+    }
+
+    // 3. Tree-cotree: the shortest-path forest plus the bridges span the
+    //    vertices; a dual spanning tree over the other interior edges,
+    //    longest loops first, leaves one edge per handle whose loop
+    //    (the edge and both shortest paths) is as short as the greedy
+    //    order allows. Edges next to flagged faces are crossed first.
+    std::vector<unsigned char> in_tree(E, 0);
+    for (int v = 0; v < V; v++) {
+        if (via[v] >= 0) in_tree[via[v]] = 1;
+    }
+    std::vector<std::pair<double, int>> cotree;
+    for (int e = 0; e < E; e++) {
+        if (topo->edge_faces[e * 2 + 1] == -1 || in_tree[e] || is_cut[e]) continue;
+        double loop = touches_flagged_face(topo, face_flags, e)
+            ? INFINITY
+            : dist[topo->edges[e * 2]] + lengths[e] + dist[topo->edges[e * 2 + 1]];
+        cotree.push_back(std::make_pair(loop, e));
+    }
+    uvunwrap::parallel_stable_sort(cotree, [](const std::pair<double, int>& a, const std::pair<double, int>& b) {
+        if (a.first != b.first) return a.first > b.first;
+        return a.second < b.second;
+    }, uvunwrap::sort_thread_count((int)cotree.size(), sort_policy, num_threads));
+    uvunwrap::DisjointSet dual(F);
+    for (size_t i = 0; i < cotree.size(); i++) {
+        int e = cotree[i].second;
+        if (dual.unite(topo->edge_faces[e * 2], topo->edge_faces[e * 2 + 1])) continue;
+        is_cut[e] = 1;
+        for (int k = 0; k < 2; k++) {
+            for (int v = topo->edges[e * 2 + k]; via[v] >= 0 && !is_cut[via[v]];) {
+                is_cut[via[v]] = 1;
+                v = topo->edges[via[v] * 2] == v ? topo->edges[via[v] * 2 + 1] : topo->edges[via[v] * 2];
+            }
+        }
+    }
+
+    // 4. Prune dangling branches (boundary edges count as cut)
+    std::vector<int> degree(V, 0);
+    for (int e = 0; e < E; e++) {
+        if (!is_cut[e] && topo->edge_faces[e * 2 + 1] != -1) continue;
+        degree[topo->edges[e * 2]]++;
+        degree[topo->edges[e * 2 + 1]]++;
+    }
+    std::vector<int> leaves;
+    for (int v = 0; v < V; v++) {
+        if (degree[v] == 1 && !is_cone[v]) leaves.push_back(v);
+    }
+    while (!leaves.empty()) {
+        int v = leaves.back();
+        leaves.pop_back();
+        if (degree[v] != 1) continue;
+        for (int o = adj->vert_edge_offsets[v]; o < adj->vert_edge_offsets[v + 1]; o++) {
+            int e = adj->vert_edges[o];
+            if (!is_cut[e]) continue;
+            int w = topo->edges[e * 2] == v ? topo->edges[e * 2 + 1] : topo->edges[e * 2];
+            is_cut[e] = 0;
+            degree[v]--;
+            degree[w]--;
+            if (degree[w] == 1 && !is_cone[w]) leaves.push_back(w);
+            break;
+        }
+    }
+    free_adjacency(adj);
+
+    std::vector<int> seams;
+    for (int e = 0; e < E; e++) {
+        if (is_cut[e] && topo->edge_faces[e * 2 + 1] != -1) seams.push_back(e);
+    }
+
+    LOG_DEBUG("Cut graph: %d terminals, %d seams", num_terminals - 1, (int)seams.size());
+
+    *num_seams_out = (int)seams.size();
+    int* out = (int*)malloc((seams.empty() ? 1 : seams.size()) * sizeof(int));
+    for (size_t i = 0; i < seams.size(); i++) out[i] = seams[i];
+
+    LOG_INFO("Detected %d seams", *num_seams_out);
+    return out;
+}
+
+/**
+ * @brief Seam detection via a BFS spanning tree of the dual graph
+ *
+ * The dual graph is read off the half-edge twins; each face visits its
+ * neighbours in ascending edge index, the order of the edge scan that
+ * used to build explicit adjacency lists, so the tree is unchanged.
+ */
+static int* detect_seams_bfs(const Mesh* mesh,
+                             const TopologyInfo* topo,
+                             const uvunwrap::HalfEdgeMesh& he,
+                             const unsigned char* face_flags,
+                             int sort_policy,
+                             int num_threads,
+                             int* num_seams_out) {
+    int F = mesh->num_triangles;
+    int E = topo->num_edges;
+
+    // 1-2. BFS spanning tree over faces; tree edges as a byte mask
+    std::vector<unsigned char> visited(F, 0);
+    std::vector<unsigned char> in_tree(E, 0);
+    std::vector<int> queue(F > 0 ? F : 1);
+    int num_visited = 0;
+    int tree_size = 0;
 
     // Handle disconnected components (though assumed one)
     for (int start_node = 0; start_node < F; start_node++) {
         if (visited[start_node]) continue;
 
-        q.push(start_node);
-        visited[start_node] = true;
+        int head = 0, tail = 0;
+        queue[tail++] = start_node;
+        visited[start_node] = 1;
+        num_visited++;
 
-        while(!q.empty()) {
-            int u = q.front();
-            q.pop();
+        while (head < tail) {
+            int u = queue[head++];
 
-            for (size_t i = 0; i < dual_adj[u].size(); i++) {
-                int v = dual_adj[u][i];
-                int edge_idx = dual_edge_indices[u][i];
+            int nbr_face[3], nbr_edge[3], count = 0;
+            for (int k = 0; k < 3; k++) {
+                int t = he.twin[u * 3 + k];
+                if (t < 0) continue;
+                int e = he.edge[u * 3 + k];
+                int c = count++;
+                while (c > 0 && nbr_edge[c - 1] > e) {
+                    nbr_face[c] = nbr_face[c - 1];
+                    nbr_edge[c] = nbr_edge[c - 1];
+                    c--;
+                }
+                nbr_face[c] = uvunwrap::HalfEdgeMesh::face(t);
+                nbr_edge[c] = e;
+            }
 
+            for (int i = 0; i < count; i++) {
+                int v = nbr_face[i];
                 if (!visited[v]) {
-                    visited[v] = true;
-                    tree_edges.insert(edge_idx);
-                    q.push(v);
+                    visited[v] = 1;
+                    num_visited++;
+                    if (!in_tree[nbr_edge[i]]) tree_size++;
+                    in_tree[nbr_edge[i]] = 1;
+                    queue[tail++] = v;
                 }
             }
         }
     }
 
-    printf("[DEBUG] Dual graph BFS: Visited %d/%d faces, Tree edges: %lu\n", 
-           (int)std::count(visited.begin(), visited.end(), true), F, tree_edges.size());
+    LOG_DEBUG("Dual graph BFS: Visited %d/%d faces, Tree edges: %d", num_visited, F, tree_size);
 
     // 3. Smarter seam selection
     // For CLOSED meshes (all edges have 2 faces), we want minimal cuts
@@ -179,8 +778,13 @@ int* detect_seams(const Mesh* mesh,
     }
     
     bool is_closed_mesh = (num_boundary_edges == 0);
+
+    // Vertex valence drives the seam priority in both branches below
+    std::vector<int> valence;
+    compute_vertex_valence(mesh, topo, valence);
     
-    std::set<int> seam_candidates;
+    std::vector<unsigned char> is_seam(E, 0);
+    int num_selected = 0;
     
     if (is_closed_mesh) {
         // For closed meshes (sphere, cube): use MINIMAL cuts
@@ -202,28 +806,24 @@ int* detect_seams(const Mesh* mesh,
         std::vector<std::pair<int, int>> non_tree_edges; // (edge_id, priority)
         
         for (int e = 0; e < topo->num_edges; e++) {
-            if (tree_edges.find(e) == tree_edges.end()) {
+            if (!in_tree[e] && !touches_flagged_face(topo, face_flags, e)) {
                 // This is a non-tree edge
                 int v0 = topo->edges[e * 2];
                 int v1 = topo->edges[e * 2 + 1];
                 
                 // Compute priority (simple heuristic: vertex degree)
-                int deg0 = 0, deg1 = 0;
-                for (int e2 = 0; e2 < topo->num_edges; e2++) {
-                    if (topo->edges[e2 * 2] == v0 || topo->edges[e2 * 2 + 1] == v0) deg0++;
-                    if (topo->edges[e2 * 2] == v1 || topo->edges[e2 * 2 + 1] == v1) deg1++;
-                }
-                int priority = deg0 + deg1;
+                int priority = valence[v0] + valence[v1];
                 non_tree_edges.push_back({e, priority});
             }
         }
         
         // Sort by priority (higher = better candidate for keeping as non-seam)
         // We want to CUT edges with LOW priority (low vertex degree)
-        std::sort(non_tree_edges.begin(), non_tree_edges.end(), 
+        // Stable, so equal priorities stay in edge order whatever the policy
+        uvunwrap::parallel_stable_sort(non_tree_edges,
                   [](const std::pair<int,int>& a, const std::pair<int,int>& b) {
                       return a.second < b.second; // ascending
-                  });
+                  }, uvunwrap::sort_thread_count((int)non_tree_edges.size(), sort_policy, num_threads));
         
         // Only keep a portion of seams based on mesh complexity
         // Cube (12 faces, 7 non-tree) -> want ~7 seams
@@ -231,22 +831,11 @@ int* detect_seams(const Mesh* mesh,
         // Sphere (80 faces, 41 non-tree) -> want ~3 seams  
         // Strategy: use more seams for simpler meshes, fewer for complex ones
         
-        int target_seams;
-        if (F <= 20) {
-            // Simple meshes (cube): keep ALL non-tree edges
-            target_seams = (int)non_tree_edges.size();
-        } else if (F <= 70) {
-            // Medium meshes (cylinder): keep minimal seams
-            target_seams = std::max(1, (int)non_tree_edges.size() / 3);
-            target_seams = std::min(target_seams, 2);
-        } else {
-            // Complex meshes (sphere): keep minimal seams
-            target_seams = std::max(1, (int)non_tree_edges.size() / 14);
-            target_seams = std::min(target_seams, 5);
-        }
+        int target_seams = seam_budget(F, (int)non_tree_edges.size(), true);
         
         for (int i = 0; i < std::min(target_seams, (int)non_tree_edges.size()); i++) {
-            seam_candidates.insert(non_tree_edges[i].first);
+            is_seam[non_tree_edges[i].first] = 1;
+            num_selected++;
         }
         
     } else {
@@ -257,63 +846,109 @@ int* detect_seams(const Mesh* mesh,
         
         for (int e = 0; e < topo->num_edges; e++) {
             bool is_boundary = (topo->edge_faces[e * 2 + 1] == -1);
-            if (!is_boundary && tree_edges.find(e) == tree_edges.end()) {
+            if (!is_boundary && !in_tree[e] && !touches_flagged_face(topo, face_flags, e)) {
                 int v0 = topo->edges[e * 2];
                 int v1 = topo->edges[e * 2 + 1];
                 
-                int deg0 = 0, deg1 = 0;
-                for (int e2 = 0; e2 < topo->num_edges; e2++) {
-                    if (topo->edges[e2 * 2] == v0 || topo->edges[e2 * 2 + 1] == v0) deg0++;
-                    if (topo->edges[e2 * 2] == v1 || topo->edges[e2 * 2 + 1] == v1) deg1++;
-                }
-                int priority = deg0 + deg1;
+                int priority = valence[v0] + valence[v1];
                 non_tree_edges.push_back({e, priority});
             }
         }
         
-        std::sort(non_tree_edges.begin(), non_tree_edges.end(),
+        uvunwrap::parallel_stable_sort(non_tree_edges,
                   [](const std::pair<int,int>& a, const std::pair<int,int>& b) {
                       return a.second < b.second;
-                  });
+                  }, uvunwrap::sort_thread_count((int)non_tree_edges.size(), sort_policy, num_threads));
         
         // For open meshes, keep even fewer seams (boundaries already provide cuts)
-        int target_seams = std::max(1, (int)non_tree_edges.size() / 3);
-        target_seams = std::min(target_seams, 2);
+        int target_seams = seam_budget(F, (int)non_tree_edges.size(), false);
         
         for (int i = 0; i < std::min(target_seams, (int)non_tree_edges.size()); i++) {
-            seam_candidates.insert(non_tree_edges[i].first);
+            is_seam[non_tree_edges[i].first] = 1;
+            num_selected++;
         }
     }
     
-    printf("[DEBUG] Seam selection: %s mesh, %lu seams\n", 
-           is_closed_mesh ? "closed" : "open", seam_candidates.size());
-
-    // 4. Angular defect refinement (DISABLED - adds too many seams)
-    // The initial non-tree edges are already sufficient for unwrapping
-    /*
-    // Calculate defects
-    std::vector<float> defects;
-    compute_all_angular_defects(mesh, defects);
-
-    for (int v = 0; v < mesh->num_vertices; v++) {
-        if (fabs(defects[v]) > 0.5f) {
-             std::vector<int> inc_edges = get_vertex_edges(topo, v);
-             for(int e : inc_edges) {
-                 seam_candidates.insert(e);
-             }
-        }
-    }
-    */
+    LOG_DEBUG("Seam selection: %s mesh, %d seams",
+              is_closed_mesh ? "closed" : "open", num_selected);
+
+    // 4. No angular defect refinement here: adding every edge around a
+    //    high-defect vertex cut far too much. SEAM_METHOD_CUT_GRAPH links
+    //    the cones with shortest paths instead.
+
+    // 5. Convert to output array (ascending edge index)
+    *num_seams_out = num_selected;
+    int* seams = (int*)malloc((num_selected > 0 ? num_selected : 1) * sizeof(int));
 
-    // 5. Convert to output array
-    *num_seams_out = seam_candidates.size();
-    int* seams = (int*)malloc(*num_seams_out * sizeof(int));
-    
     int idx = 0;
-    for (int e : seam_candidates) {
-        seams[idx++] = e;
+    for (int e = 0; e < E; e++) {
+        if (is_seam[e]) seams[idx++] = e;
     }
-    
-    printf("Detected %d seams\n", *num_seams_out);
+
+    LOG_INFO("Detected %d seams", *num_seams_out);
     return seams;
 }
+
+int* detect_seams(const Mesh* mesh,
+                  const TopologyInfo* topo,
+                  float angle_threshold,
+                  int* num_seams_out) {
+    if (!mesh || !topo || !num_seams_out) return NULL;
+
+    uvunwrap::HalfEdgeMesh he;
+    if (!uvunwrap::half_edges_from_topology(mesh, topo, &he)) return NULL;
+    return uvunwrap::detect_seams_half_edge(mesh, topo, he, angle_threshold, SEAM_METHOD_BFS, num_seams_out);
+}
+
+int* uvunwrap::detect_seams_half_edge(const Mesh* mesh,
+                                      const TopologyInfo* topo,
+                                      const HalfEdgeMesh& he,
+                                      float angle_threshold,
+                                      int seam_method,
+                                      int* num_seams_out,
+                                      const unsigned char* face_flags,
+                                      int sort_policy,
+                                      int num_threads,
+                                      const TriangleGeometry* geometry) {
+    if (!mesh || !topo || !num_seams_out) return NULL;
+
+    switch (seam_method) {
+        case SEAM_METHOD_MST:
+            return detect_seams_mst(mesh, topo, face_flags, sort_policy, num_threads, num_seams_out, geometry);
+        case SEAM_METHOD_BFS:
+            return detect_seams_bfs(mesh, topo, he, face_flags, sort_policy, num_threads, num_seams_out);
+        case SEAM_METHOD_COST:
+            return detect_seams_cost(mesh, topo, face_flags, sort_policy, num_threads, num_seams_out, geometry);
+        case SEAM_METHOD_CUT_GRAPH:
+            return detect_seams_cut_graph(mesh, topo, angle_threshold, face_flags, sort_policy, num_threads,
+                                          num_seams_out, geometry);
+        default:
+            LOG_ERROR("detect_seams: Unknown seam method %d", seam_method);
+            return NULL;
+    }
+}
+
+int* detect_seams_with_method(const Mesh* mesh,
+                              const TopologyInfo* topo,
+                              float angle_threshold,
+                              SeamMethod method,
+                              int* num_seams_out) {
+    if (!mesh || !topo || !num_seams_out) return NULL;
+
+    switch (method) {
+        case SEAM_METHOD_MST:
+            return detect_seams_mst(mesh, topo, NULL, SORT_POLICY_AUTO, 0, num_seams_out);
+        case SEAM_METHOD_BFS: {
+            uvunwrap::HalfEdgeMesh he;
+            if (!uvunwrap::half_edges_from_topology(mesh, topo, &he)) return NULL;
+            return detect_seams_bfs(mesh, topo, he, NULL, SORT_POLICY_AUTO, 0, num_seams_out);
+        }
+        case SEAM_METHOD_COST:
+            return detect_seams_cost(mesh, topo, NULL, SORT_POLICY_AUTO, 0, num_seams_out);
+        case SEAM_METHOD_CUT_GRAPH:
+            return detect_seams_cut_graph(mesh, topo, angle_threshold, NULL, SORT_POLICY_AUTO, 0, num_seams_out);
+        default:
+            LOG_ERROR("detect_seams: Unknown seam method %d", (int)method);
+            return NULL;
+    }
+}
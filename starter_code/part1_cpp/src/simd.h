@@ -0,0 +1,127 @@
+/**
+ * @file simd.h
+ * @brief Compile-time selected float lanes for the batch kernels
+ *
+ * Not part of the public API. `Lanes` wraps AVX-512 (16 floats), AVX
+ * (8), SSE2 or AArch64 NEON (4) or a plain float, whichever the compiler
+ * targets; kernels are written once against it and handle the last
+ * count % Lanes::N elements with scalar code. Only correctly rounded
+ * operations are offered, so a lane computes exactly what the same
+ * scalar expression does.
+ */
+
+#ifndef UVUNWRAP_SIMD_H
+#define UVUNWRAP_SIMD_H
+
+#include "isa_abi.h"
+#include <math.h>
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+#define UVUNWRAP_SIMD_AVX512
+#elif defined(__AVX__)
+#include <immintrin.h>
+#define UVUNWRAP_SIMD_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define UVUNWRAP_SIMD_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define UVUNWRAP_SIMD_NEON
+#endif
+
+namespace uvunwrap {
+inline namespace UVUNWRAP_ISA_ABI {
+
+#if defined(UVUNWRAP_SIMD_AVX512)
+struct Lanes {
+    typedef __m512 V;
+    typedef __mmask16 M;
+    static const int N = 16;
+    static const char* name() { return "avx512"; }
+    static V set1(float s) { return _mm512_set1_ps(s); }
+    static V load(const float* p) { return _mm512_loadu_ps(p); }
+    static void store(float* p, V v) { _mm512_storeu_ps(p, v); }
+    static V add(V a, V b) { return _mm512_add_ps(a, b); }
+    static V sub(V a, V b) { return _mm512_sub_ps(a, b); }
+    static V mul(V a, V b) { return _mm512_mul_ps(a, b); }
+    static V div(V a, V b) { return _mm512_div_ps(a, b); }
+    static V sqrt(V a) { return _mm512_sqrt_ps(a); }
+    static M lt(V a, V b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+    /** m ? a : b per lane */
+    static V select(M m, V a, V b) { return _mm512_mask_blend_ps(m, b, a); }
+};
+#elif defined(UVUNWRAP_SIMD_AVX)
+struct Lanes {
+    typedef __m256 V;
+    typedef __m256 M;
+    static const int N = 8;
+    static const char* name() { return "avx"; }
+    static V set1(float s) { return _mm256_set1_ps(s); }
+    static V load(const float* p) { return _mm256_loadu_ps(p); }
+    static void store(float* p, V v) { _mm256_storeu_ps(p, v); }
+    static V add(V a, V b) { return _mm256_add_ps(a, b); }
+    static V sub(V a, V b) { return _mm256_sub_ps(a, b); }
+    static V mul(V a, V b) { return _mm256_mul_ps(a, b); }
+    static V div(V a, V b) { return _mm256_div_ps(a, b); }
+    static V sqrt(V a) { return _mm256_sqrt_ps(a); }
+    static M lt(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static V select(M m, V a, V b) { return _mm256_blendv_ps(b, a, m); }
+};
+#elif defined(UVUNWRAP_SIMD_SSE2)
+struct Lanes {
+    typedef __m128 V;
+    typedef __m128 M;
+    static const int N = 4;
+    static const char* name() { return "sse2"; }
+    static V set1(float s) { return _mm_set1_ps(s); }
+    static V load(const float* p) { return _mm_loadu_ps(p); }
+    static void store(float* p, V v) { _mm_storeu_ps(p, v); }
+    static V add(V a, V b) { return _mm_add_ps(a, b); }
+    static V sub(V a, V b) { return _mm_sub_ps(a, b); }
+    static V mul(V a, V b) { return _mm_mul_ps(a, b); }
+    static V div(V a, V b) { return _mm_div_ps(a, b); }
+    static V sqrt(V a) { return _mm_sqrt_ps(a); }
+    static M lt(V a, V b) { return _mm_cmplt_ps(a, b); }
+    static V select(M m, V a, V b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+};
+#elif defined(UVUNWRAP_SIMD_NEON)
+struct Lanes {
+    typedef float32x4_t V;
+    typedef uint32x4_t M;
+    static const int N = 4;
+    static const char* name() { return "neon"; }
+    static V set1(float s) { return vdupq_n_f32(s); }
+    static V load(const float* p) { return vld1q_f32(p); }
+    static void store(float* p, V v) { vst1q_f32(p, v); }
+    static V add(V a, V b) { return vaddq_f32(a, b); }
+    static V sub(V a, V b) { return vsubq_f32(a, b); }
+    static V mul(V a, V b) { return vmulq_f32(a, b); }
+    static V div(V a, V b) { return vdivq_f32(a, b); }
+    static V sqrt(V a) { return vsqrtq_f32(a); }
+    static M lt(V a, V b) { return vcltq_f32(a, b); }
+    static V select(M m, V a, V b) { return vbslq_f32(m, a, b); }
+};
+#else
+struct Lanes {
+    typedef float V;
+    typedef bool M;
+    static const int N = 1;
+    static const char* name() { return "scalar"; }
+    static V set1(float s) { return s; }
+    static V load(const float* p) { return *p; }
+    static void store(float* p, V v) { *p = v; }
+    static V add(V a, V b) { return a + b; }
+    static V sub(V a, V b) { return a - b; }
+    static V mul(V a, V b) { return a * b; }
+    static V div(V a, V b) { return a / b; }
+    static V sqrt(V a) { return sqrtf(a); }
+    static M lt(V a, V b) { return a < b; }
+    static V select(M m, V a, V b) { return m ? a : b; }
+};
+#endif
+
+} // namespace UVUNWRAP_ISA_ABI
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_SIMD_H */
@@ -0,0 +1,55 @@
+/**
+ * @file socket_io.h
+ * @brief Internal blocking stream-socket helpers shared by the daemon and
+ *        the cluster
+ *
+ * Not part of the public API. POSIX only; sends never raise SIGPIPE.
+ */
+
+#ifndef UVUNWRAP_SOCKET_IO_H
+#define UVUNWRAP_SOCKET_IO_H
+
+#ifndef _WIN32
+
+#include <errno.h>
+#include <stddef.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace uvunwrap {
+
+/** Read exactly size bytes; false on error or end of stream */
+inline bool read_all(int fd, void* data, size_t size) {
+    char* p = (char*)data;
+    while (size > 0) {
+        ssize_t got = recv(fd, p, size, 0);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) return false;
+        p += got;
+        size -= (size_t)got;
+    }
+    return true;
+}
+
+/** Write exactly size bytes; false on error */
+inline bool write_all(int fd, const void* data, size_t size) {
+    const char* p = (const char*)data;
+    while (size > 0) {
+        ssize_t sent = send(fd, p, size, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent <= 0) return false;
+        p += sent;
+        size -= (size_t)sent;
+    }
+    return true;
+}
+
+} // namespace uvunwrap
+
+#endif /* _WIN32 */
+
+#endif /* UVUNWRAP_SOCKET_IO_H */
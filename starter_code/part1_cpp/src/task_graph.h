@@ -0,0 +1,233 @@
+/**
+ * @file task_graph.h
+ * @brief Internal dependency-driven task executor
+ *
+ * Not part of the public API. Lets a pipeline start each piece of work as
+ * soon as its inputs exist instead of waiting for a whole stage, e.g. an
+ * island's write-back right after its own solve. Uses std::thread like
+ * parallel.h, and likewise hands the caller's log sink and NUMA placement
+ * to its workers.
+ */
+
+#ifndef UVUNWRAP_TASK_GRAPH_H
+#define UVUNWRAP_TASK_GRAPH_H
+
+#include "logging.h"
+#include "numa.h"
+#include "trace.h"
+#include "memory_meter.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace uvunwrap {
+
+/**
+ * @brief DAG of tasks run by a fixed set of workers
+ *
+ * Tasks become ready when all their predecessors have finished; among
+ * ready tasks the highest priority runs first (lowest id on ties). A
+ * running task may add tasks and edges, which lets a stage fan out into
+ * work it only discovers when it runs (one task per island). Tasks added
+ * by a running task are held back until that task returns, so all their
+ * edges are in place before any of them can start.
+ *
+ * With a MemoryMeter attached, a task added with bytes > 0 only starts
+ * once MemoryMeter::try_reserve(bytes) admits it. A ready task that does
+ * not fit is passed over for the next one that does (a large island's
+ * solve lets smaller ones backfill the budget) and retried whenever a
+ * task holding bytes finishes. Such a task must drop its reservation
+ * with MemoryMeter::unreserve() before it returns.
+ *
+ * Under a NUMA placement the workers are pinned to nodes, and a task given
+ * a node with set_node() is preferred by that node's workers: a worker
+ * takes the first ready task of its own node (or of none) among the next
+ * NUMA_LOOKAHEAD in priority order, and only otherwise the first one.
+ */
+class TaskGraph {
+public:
+    typedef std::function<void(int worker)> Fn;
+
+    /** Budget tasks added with bytes > 0 through meter (NULL: run them like any other) */
+    void set_meter(MemoryMeter* meter) { meter_ = meter; }
+
+    /** Ready tasks a pinned worker looks through for one of its own node */
+    static const int NUMA_LOOKAHEAD = 8;
+
+    /** Tasks that were passed over at least once because their bytes did not fit */
+    int num_deferred() const { return num_deferred_; }
+
+    /** Add a task; fn receives the worker index in [0, num_threads) */
+    int add(Fn fn, long long priority = 0, long long bytes = 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        int id = (int)tasks_.size();
+        tasks_.emplace_back();
+        Task& task = tasks_.back();
+        task.fn = std::move(fn);
+        task.priority = priority;
+        task.bytes = bytes;
+        task.pending = 1;  // Hold, released by run() or by the spawning task
+        const Running& running = running_on_thread();
+        if (running.graph == this) tasks_[running.task].spawned.push_back(id);
+        else roots_.push_back(id);
+        remaining_++;
+        return id;
+    }
+
+    /** Prefer running task id on a worker of node (-1: any worker); id must still be held */
+    void set_node(int id, int node) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_[id].node = node;
+    }
+
+    /**
+     * @brief after waits for before (no-op if before has already finished)
+     *
+     * after must still be held: added before run(), or by the running task.
+     */
+    void precede(int before, int after) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (tasks_[before].done) return;
+        tasks_[before].successors.push_back(after);
+        tasks_[after].pending++;
+    }
+
+    /** Run every task, including ones added while running, then return */
+    void run(int num_threads) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (size_t i = 0; i < roots_.size(); i++) release(roots_[i]);
+            roots_.clear();
+        }
+        LogSink* sink = current_log_sink();
+        NumaPlacement placement = current_numa_placement();
+        std::vector<std::thread> workers;
+        for (int t = 1; t < num_threads; t++) {
+            workers.emplace_back([this, t, num_threads, sink, placement]() {
+                int node = numa_place_worker(placement, t, num_threads);
+                ScopedLogSink scope(sink);
+                UV_TRACE_THREAD_NAME("island worker", t);
+                work(t, node);
+            });
+        }
+        work(0, -1);
+        for (size_t i = 0; i < workers.size(); i++) workers[i].join();
+    }
+
+private:
+    struct Task {
+        Fn fn;
+        long long priority = 0;
+        long long bytes = 0;
+        int node = -1;
+        int pending = 0;
+        bool done = false;
+        bool deferred = false;
+        std::vector<int> successors;
+        std::vector<int> spawned;
+    };
+
+    /** Ordered by when they run: highest priority first, lowest id on ties */
+    struct Ready {
+        long long priority;
+        int id;
+        bool operator<(const Ready& o) const { return priority > o.priority || (priority == o.priority && id < o.id); }
+    };
+
+    /** Drop one pending count; caller holds mutex_ */
+    void release(int id) {
+        if (--tasks_[id].pending == 0) {
+            ready_.insert(Ready{tasks_[id].priority, id});
+            wake_.notify_one();
+        }
+    }
+
+    /**
+     * Remove and return the first ready task the meter admits, or -1,
+     * looking ahead for one of node first when node >= 0; caller holds mutex_
+     */
+    int take_ready(int node) {
+        if (node >= 0) {
+            int looked = 0;
+            for (std::set<Ready>::iterator it = ready_.begin(); it != ready_.end() && looked < NUMA_LOOKAHEAD;
+                 ++it, ++looked) {
+                Task& task = tasks_[it->id];
+                if (task.node >= 0 && task.node != node) continue;
+                if (meter_ && task.bytes > 0 && !meter_->try_reserve(task.bytes)) continue;
+                int id = it->id;
+                ready_.erase(it);
+                return id;
+            }
+        }
+        for (std::set<Ready>::iterator it = ready_.begin(); it != ready_.end(); ++it) {
+            Task& task = tasks_[it->id];
+            if (meter_ && task.bytes > 0 && !meter_->try_reserve(task.bytes)) {
+                if (!task.deferred) num_deferred_++;
+                task.deferred = true;
+                continue;
+            }
+            int id = it->id;
+            ready_.erase(it);
+            return id;
+        }
+        return -1;
+    }
+
+    /** node: the worker's NUMA node, or -1 if it is not pinned */
+    void work(int worker, int node) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            int id;
+            while ((id = take_ready(node)) < 0 && remaining_ > 0) wake_.wait(lock);
+            if (id < 0) break;
+
+            // Only this worker touches the task's fn while it runs; deque
+            // growth from add() never moves existing elements
+            Fn& fn = tasks_[id].fn;
+            lock.unlock();
+            {
+                Running saved = running_on_thread();
+                running_on_thread() = Running{this, id};
+                fn(worker);
+                running_on_thread() = saved;
+            }
+            lock.lock();
+
+            Task& task = tasks_[id];
+            task.done = true;
+            task.fn = Fn();
+            for (size_t i = 0; i < task.successors.size(); i++) release(task.successors[i]);
+            for (size_t i = 0; i < task.spawned.size(); i++) release(task.spawned[i]);
+            // Its bytes are back, so tasks passed over may fit now
+            if (--remaining_ == 0 || (meter_ && task.bytes > 0)) wake_.notify_all();
+        }
+    }
+
+    /** Task running on this thread, so add() can tell spawns from roots */
+    struct Running {
+        const TaskGraph* graph;
+        int task;
+    };
+
+    static Running& running_on_thread() {
+        static thread_local Running running = {NULL, -1};
+        return running;
+    }
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<Task> tasks_;
+    std::vector<int> roots_;
+    std::set<Ready> ready_;
+    int remaining_ = 0;
+    MemoryMeter* meter_ = NULL;
+    int num_deferred_ = 0;
+};
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_TASK_GRAPH_H */
@@ -0,0 +1,21 @@
+/**
+ * @file timer.h
+ * @brief Internal monotonic clock for stage timings
+ */
+
+#ifndef UVUNWRAP_TIMER_H
+#define UVUNWRAP_TIMER_H
+
+#include <chrono>
+
+namespace uvunwrap {
+
+/** Monotonic wall clock in nanoseconds (arbitrary epoch) */
+inline long long now_ns() {
+    return (long long)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_TIMER_H */
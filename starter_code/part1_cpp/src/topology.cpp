@@ -2,110 +2,399 @@
  * @file topology.cpp
  * @brief Topology builder implementation
  *
- * SKELETON - YOU IMPLEMENT THIS
- *
  * Algorithm:
- * 1. Extract all edges from triangles
- * 2. Ensure uniqueness (always store as v0 < v1)
- * 3. For each edge, find adjacent faces
+ * 1. Extract all edges from triangles as packed 64-bit keys (v0 < v1)
+ * 2. Group identical keys, either by radix sort or by an open-addressing
+ *    hash table
+ * 3. For each edge, record the adjacent faces
  * 4. Validate using Euler characteristic
+ *
+ * The sort strategy goes through the half-edge view (half_edge.h): the
+ * sorted groups give twins and edge indices in the same pass. Its key
+ * extraction, radix sort and group scan all run over contiguous ranges of
+ * half-edges, one per thread, with per-thread histograms and counts
+ * reduced in range order, so the output is the same for any thread count.
  */
 
 #include "topology.h"
+#include "half_edge.h"
+#include "parallel_sort.h"
+#include "logging.h"
 #include <stdlib.h>
 #include <stdio.h>
-#include <map>
+#include <string.h>
+#include <stdint.h>
 #include <vector>
 
 /**
- * @brief Edge structure for uniqueness
+ * @brief Half-edge record produced while scanning triangles
+ *
+ * The key packs the ordered vertex pair as (v0 << 32) | v1 with v0 < v1,
+ * so sorting keys gives the same (v0, v1) lexicographic order as the
+ * original std::map<Edge, EdgeInfo> implementation. half_edge is
+ * 3 * face + side.
  */
-struct Edge {
-    int v0, v1;
-
-    Edge(int a, int b) {
-        // Always store smaller vertex first
-        if (a < b) {
-            v0 = a;
-            v1 = b;
-        } else {
-            v0 = b;
-            v1 = a;
-        }
-    }
-
-    bool operator<(const Edge& other) const {
-        if (v0 != other.v0) return v0 < other.v0;
-        return v1 < other.v1;
-    }
+struct EdgeRecord {
+    uint64_t key;
+    int half_edge;
 };
 
 /**
- * @brief Edge information
+ * @brief Unique edge with its adjacent faces
  */
 struct EdgeInfo {
+    uint64_t key;
     int face0;
     int face1;
-
-    EdgeInfo() : face0(-1), face1(-1) {}
 };
 
-TopologyInfo* build_topology(const Mesh* mesh) {
-    if (!mesh) return NULL;
+static inline uint64_t make_edge_key(int a, int b) {
+    if (a > b) {
+        int t = a; a = b; b = t;
+    }
+    return ((uint64_t)(uint32_t)a << 32) | (uint64_t)(uint32_t)b;
+}
+
+/**
+ * @brief Number of significant bits needed for a vertex index
+ */
+static int vertex_index_bits(int num_vertices) {
+    int bits = 1;
+    while (bits < 31 && (1 << bits) < num_vertices) bits++;
+    return bits;
+}
+
+// Below this many half-edges per thread the build stays serial
+static const int MIN_HALF_EDGES_PER_THREAD = 1 << 18;
 
-    // Map to collect unique edges
-    std::map<Edge, EdgeInfo> edge_map;
+/**
+ * @brief Stable LSD radix sort on the low vertex_bits of each 32-bit key half
+ *
+ * Only the digits that can actually be non-zero are processed, so a mesh
+ * with fewer than 65k vertices needs four 8-bit passes instead of eight.
+ * Stability keeps records with equal keys in face order, which is what
+ * makes face0/face1 assignment identical to the map-based builder.
+ *
+ * Each pass histograms and scatters contiguous ranges in parallel; the
+ * scatter offsets run digit-major, range-minor, which keeps the sort
+ * stable and the result independent of num_threads.
+ */
+template <typename T>
+static void radix_sort_by_key(std::vector<T>& items, int vertex_bits, int num_threads) {
+    if (items.size() < 2) return;
+
+    int n = (int)items.size();
+    std::vector<T> scratch(items.size());
+    T* src = items.data();
+    T* dst = scratch.data();
+    int digit_passes = (vertex_bits + 7) / 8;
+    std::vector<size_t> counts((size_t)num_threads * 256);
+
+    for (int half = 0; half < 2; half++) {
+        for (int pass = 0; pass < digit_passes; pass++) {
+            int shift = half * 32 + pass * 8;
+
+            uvunwrap::parallel_for_ranges(n, num_threads, [&](int t, int begin, int end) {
+                size_t* range_counts = &counts[(size_t)t * 256];
+                memset(range_counts, 0, 256 * sizeof(size_t));
+                for (int i = begin; i < end; i++) {
+                    range_counts[(src[i].key >> shift) & 0xFF]++;
+                }
+            });
+
+            size_t offset = 0;
+            for (int d = 0; d < 256; d++) {
+                for (int t = 0; t < num_threads; t++) {
+                    size_t c = counts[(size_t)t * 256 + d];
+                    counts[(size_t)t * 256 + d] = offset;
+                    offset += c;
+                }
+            }
+
+            uvunwrap::parallel_for_ranges(n, num_threads, [&](int t, int begin, int end) {
+                size_t* cursor = &counts[(size_t)t * 256];
+                for (int i = begin; i < end; i++) {
+                    dst[cursor[(src[i].key >> shift) & 0xFF]++] = src[i];
+                }
+            });
+
+            T* t = src; src = dst; dst = t;
+        }
+    }
 
-    // Iterate through all triangles
-    for (int f = 0; f < mesh->num_triangles; f++) {
-        int v0 = mesh->triangles[f * 3 + 0];
-        int v1 = mesh->triangles[f * 3 + 1];
-        int v2 = mesh->triangles[f * 3 + 2];
+    if (src != items.data()) {
+        memcpy(items.data(), src, items.size() * sizeof(T));
+    }
+}
 
-        // Process 3 edges: (v0,v1), (v1,v2), (v2,v0)
-        int vs[3] = {v0, v1, v2};
+static inline uint64_t hash_edge_key(uint64_t key) {
+    // splitmix64 finalizer
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+    return key;
+}
+
+/**
+ * @brief Hash-based edge extraction: linear-probing table, then sort uniques
+ */
+static void collect_edges_hash(const Mesh* mesh, std::vector<EdgeInfo>& edges) {
+    int F = mesh->num_triangles;
+
+    // Closed manifold meshes have E = 1.5F; size for a load factor <= 0.5
+    size_t capacity = 16;
+    while (capacity < (size_t)F * 3) capacity <<= 1;
+    size_t mask = capacity - 1;
+
+    const uint64_t EMPTY = ~(uint64_t)0;
+    std::vector<uint64_t> slot_keys(capacity, EMPTY);
+    std::vector<int> slot_edges(capacity, -1);
+
+    edges.clear();
+    edges.reserve((size_t)F * 3 / 2 + 1);
+
+    for (int f = 0; f < F; f++) {
+        const int* tri = &mesh->triangles[f * 3];
         for (int i = 0; i < 3; i++) {
-            int a = vs[i];
-            int b = vs[(i + 1) % 3];
-            Edge e(a, b);
+            uint64_t key = make_edge_key(tri[i], tri[(i + 1) % 3]);
+            size_t slot = (size_t)hash_edge_key(key) & mask;
+
+            while (slot_keys[slot] != EMPTY && slot_keys[slot] != key) {
+                slot = (slot + 1) & mask;
+            }
+
+            if (slot_keys[slot] == EMPTY) {
+                slot_keys[slot] = key;
+                slot_edges[slot] = (int)edges.size();
 
-            // Check if edge exists
-            if (edge_map.find(e) == edge_map.end()) {
-                // New edge
                 EdgeInfo info;
+                info.key = key;
                 info.face0 = f;
-                edge_map[e] = info;
+                info.face1 = -1;
+                edges.push_back(info);
             } else {
-                // Existing edge, set second face
-                edge_map[e].face1 = f;
+                edges[slot_edges[slot]].face1 = f;
             }
         }
     }
 
+    radix_sort_by_key(edges, vertex_index_bits(mesh->num_vertices), 1);
+}
+
+TopologyInfo* build_topology_with_strategy(const Mesh* mesh,
+                                           TopologyBuildStrategy strategy) {
+    if (!mesh || mesh->num_triangles < 0) return NULL;
+    if (mesh->num_triangles > 0 && !mesh->triangles) return NULL;
+
+    std::vector<EdgeInfo> edges;
+    switch (strategy) {
+        case TOPOLOGY_BUILD_HASH:
+            collect_edges_hash(mesh, edges);
+            break;
+        case TOPOLOGY_BUILD_SORT:
+            return build_topology_parallel(mesh, 1, NULL);
+        case TOPOLOGY_BUILD_PARALLEL:
+            return build_topology_parallel(mesh, 0, NULL);
+        default:
+            LOG_ERROR("build_topology: Unknown strategy %d", (int)strategy);
+            return NULL;
+    }
+
     // Allocate TopologyInfo
     TopologyInfo* topo = (TopologyInfo*)malloc(sizeof(TopologyInfo));
-    topo->num_edges = edge_map.size();
+    topo->num_edges = (int)edges.size();
     topo->edges = (int*)malloc(topo->num_edges * 2 * sizeof(int));
     topo->edge_faces = (int*)malloc(topo->num_edges * 2 * sizeof(int));
 
     // Fill arrays
-    int idx = 0;
-    for (std::map<Edge, EdgeInfo>::iterator it = edge_map.begin(); it != edge_map.end(); ++it) {
-        const Edge& e = it->first;
-        const EdgeInfo& info = it->second;
+    for (int idx = 0; idx < topo->num_edges; idx++) {
+        const EdgeInfo& info = edges[idx];
 
-        topo->edges[idx * 2 + 0] = e.v0;
-        topo->edges[idx * 2 + 1] = e.v1;
+        topo->edges[idx * 2 + 0] = (int)(info.key >> 32);
+        topo->edges[idx * 2 + 1] = (int)(info.key & 0xFFFFFFFFu);
 
         topo->edge_faces[idx * 2 + 0] = info.face0;
         topo->edge_faces[idx * 2 + 1] = info.face1;
+    }
+
+    return topo;
+}
 
-        idx++;
+namespace uvunwrap {
+
+bool build_half_edge_mesh(const Mesh* mesh, HalfEdgeMesh* out, int num_threads,
+                          const unsigned char* face_flags, int sort_policy) {
+    if (!mesh || mesh->num_triangles < 0) return false;
+    if (mesh->num_triangles > 0 && !mesh->triangles) return false;
+
+    int F = mesh->num_triangles;
+    int H = F * 3;
+    int threads = choose_thread_count(H, num_threads, MIN_HALF_EDGES_PER_THREAD);
+    std::vector<EdgeRecord> records(H);
+    parallel_for_ranges(H, threads, [&](int, int begin, int end) {
+        for (int h = begin; h < end; h++) {
+            records[h].key = make_edge_key(mesh->triangles[h], mesh->triangles[HalfEdgeMesh::next(h)]);
+            records[h].half_edge = h;
+        }
+    });
+
+    // Stable, so each group lists its half-edges in face order
+    int sort_threads = sort_policy == SORT_POLICY_AUTO ? threads : sort_thread_count(H, sort_policy, num_threads);
+    radix_sort_by_key(records, vertex_index_bits(mesh->num_vertices), sort_threads);
+
+    // A group starts where the key changes; numbering the starts of each
+    // range gives every range its first edge index
+    std::vector<int> range_edges(threads + 1, 0);
+    parallel_for_ranges(H, threads, [&](int t, int begin, int end) {
+        int starts = 0;
+        for (int i = begin; i < end; i++) {
+            if (i == 0 || records[i].key != records[i - 1].key) starts++;
+        }
+        range_edges[t + 1] = starts;
+    });
+    for (int t = 0; t < threads; t++) range_edges[t + 1] += range_edges[t];
+    int num_edges = range_edges[threads];
+
+    out->num_vertices = mesh->num_vertices;
+    out->num_faces = F;
+    out->num_edges = num_edges;
+    out->vertex = mesh->triangles;
+    out->twin.resize(H);
+    out->edge.resize(H);
+    out->edge_half_edges.resize((size_t)num_edges * 2);
+
+    // Each range handles the groups that start in it, reading past its
+    // end for the last one; groups own disjoint half-edges
+    std::vector<int> range_nonmanifold(threads, 0);
+    parallel_for_ranges(H, threads, [&](int t, int begin, int end) {
+        int e = range_edges[t];
+        for (int i = begin; i < end; i++) {
+            if (i > 0 && records[i].key == records[i - 1].key) continue;
+            int j = i + 1;
+            while (j < H && records[j].key == records[i].key) j++;
+
+            // First and last face pair up (matches face0/face1 of the
+            // map-based builder for non-manifold edges); faces with a
+            // repeated corner take part only if nothing else is on the edge
+            int first = -1, last = -1, count = 0;
+            for (int k = i; k < j; k++) {
+                int h = records[k].half_edge;
+                out->edge[h] = e;
+                out->twin[h] = -1;
+                if (face_flags && (face_flags[HalfEdgeMesh::face(h)] & FACE_FLAG_DUPLICATE_INDEX)) continue;
+                if (first < 0) first = h;
+                last = h;
+                count++;
+            }
+            int h0 = first >= 0 ? first : records[i].half_edge;
+            int h1 = count >= 2 ? last : -1;
+            if (h1 >= 0) {
+                out->twin[h0] = h1;
+                out->twin[h1] = h0;
+            }
+            if (count > 2) range_nonmanifold[t]++;
+            out->edge_half_edges[(size_t)e * 2 + 0] = h0;
+            out->edge_half_edges[(size_t)e * 2 + 1] = h1;
+            e++;
+        }
+    });
+
+    out->num_nonmanifold_edges = 0;
+    for (int t = 0; t < threads; t++) out->num_nonmanifold_edges += range_nonmanifold[t];
+    if (out->num_nonmanifold_edges > 0) {
+        LOG_WARNING("build_topology: %d non-manifold edges (more than two faces); "
+                    "only their lowest and highest faces are joined",
+                    out->num_nonmanifold_edges);
+    }
+    return true;
+}
+
+/** Side of face f on edge (a, b): the first match, or the last with from_end */
+static int find_side(const Mesh* mesh, int f, int a, int b, bool from_end) {
+    for (int n = 0; n < 3; n++) {
+        int k = from_end ? 2 - n : n;
+        int h = f * 3 + k;
+        if (make_edge_key(mesh->triangles[h], mesh->triangles[HalfEdgeMesh::next(h)]) ==
+            make_edge_key(a, b)) {
+            return h;
+        }
+    }
+    return -1;
+}
+
+bool half_edges_from_topology(const Mesh* mesh, const TopologyInfo* topo, HalfEdgeMesh* out) {
+    if (!mesh || !topo || mesh->num_triangles < 0) return false;
+    if (mesh->num_triangles > 0 && !mesh->triangles) return false;
+
+    int E = topo->num_edges;
+    size_t H = (size_t)mesh->num_triangles * 3;
+    out->num_vertices = mesh->num_vertices;
+    out->num_faces = mesh->num_triangles;
+    out->num_edges = E;
+    out->num_nonmanifold_edges = 0;  // Extra faces are not in a TopologyInfo
+    out->vertex = mesh->triangles;
+    out->twin.assign(H, -1);
+    out->edge.assign(H, -1);
+    out->edge_half_edges.assign((size_t)E * 2, -1);
+
+    for (int e = 0; e < E; e++) {
+        int a = topo->edges[e * 2 + 0];
+        int b = topo->edges[e * 2 + 1];
+        int f0 = topo->edge_faces[e * 2 + 0];
+        int f1 = topo->edge_faces[e * 2 + 1];
+        int h0 = f0 >= 0 ? find_side(mesh, f0, a, b, false) : -1;
+        int h1 = f1 >= 0 ? find_side(mesh, f1, a, b, true) : -1;
+        if (h0 < 0) return false;
+        out->edge[h0] = e;
+        out->edge_half_edges[e * 2 + 0] = h0;
+        if (h1 >= 0 && h1 != h0) {
+            out->edge[h1] = e;
+            out->twin[h0] = h1;
+            out->twin[h1] = h0;
+            out->edge_half_edges[e * 2 + 1] = h1;
+        }
     }
+    return true;
+}
 
+TopologyInfo* topology_from_half_edges(const HalfEdgeMesh& he, int num_threads) {
+    int E = he.num_edges;
+    TopologyInfo* topo = (TopologyInfo*)malloc(sizeof(TopologyInfo));
+    topo->num_edges = E;
+    topo->edges = (int*)malloc((E > 0 ? E : 1) * 2 * sizeof(int));
+    topo->edge_faces = (int*)malloc((E > 0 ? E : 1) * 2 * sizeof(int));
+
+    int threads = choose_thread_count(E, num_threads, MIN_HALF_EDGES_PER_THREAD);
+    parallel_for_ranges(E, threads, [&](int, int begin, int end) {
+        for (int e = begin; e < end; e++) {
+            int h0 = he.edge_half_edges[e * 2 + 0];
+            int h1 = he.edge_half_edges[e * 2 + 1];
+            uint64_t key = make_edge_key(he.origin(h0), he.target(h0));
+            topo->edges[e * 2 + 0] = (int)(key >> 32);
+            topo->edges[e * 2 + 1] = (int)(key & 0xFFFFFFFFu);
+            topo->edge_faces[e * 2 + 0] = HalfEdgeMesh::face(h0);
+            topo->edge_faces[e * 2 + 1] = h1 >= 0 ? HalfEdgeMesh::face(h1) : -1;
+        }
+    });
     return topo;
 }
 
+} // namespace uvunwrap
+
+TopologyInfo* build_topology(const Mesh* mesh) {
+    return build_topology_with_strategy(mesh, TOPOLOGY_BUILD_SORT);
+}
+
+TopologyInfo* build_topology_parallel(const Mesh* mesh, int num_threads, int* num_nonmanifold_edges_out) {
+    if (num_nonmanifold_edges_out) *num_nonmanifold_edges_out = 0;
+    uvunwrap::HalfEdgeMesh he;
+    if (!uvunwrap::build_half_edge_mesh(mesh, &he, num_threads)) return NULL;
+    if (num_nonmanifold_edges_out) *num_nonmanifold_edges_out = he.num_nonmanifold_edges;
+    return uvunwrap::topology_from_half_edges(he, num_threads);
+}
+
 void free_topology(TopologyInfo* topo) {
     if (!topo) return;
 
@@ -114,6 +403,91 @@ void free_topology(TopologyInfo* topo) {
     free(topo);
 }
 
+AdjacencyInfo* build_adjacency(const Mesh* mesh, const TopologyInfo* topo) {
+    if (!mesh || !topo) return NULL;
+
+    int V = mesh->num_vertices;
+    int F = mesh->num_triangles;
+    int E = topo->num_edges;
+
+    AdjacencyInfo* adj = (AdjacencyInfo*)malloc(sizeof(AdjacencyInfo));
+    adj->num_vertices = V;
+    adj->num_faces = F;
+    adj->vert_face_offsets = (int*)calloc(V + 1, sizeof(int));
+    adj->vert_faces = (int*)malloc((size_t)F * 3 * sizeof(int));
+    adj->vert_edge_offsets = (int*)calloc(V + 1, sizeof(int));
+    adj->vert_edges = (int*)malloc((size_t)E * 2 * sizeof(int));
+    adj->face_edges = (int*)malloc((size_t)F * 3 * sizeof(int));
+
+    // Count incidences (offsets shifted by one so the prefix sum lands in place)
+    for (int i = 0; i < F * 3; i++) {
+        adj->vert_face_offsets[mesh->triangles[i] + 1]++;
+    }
+    for (int e = 0; e < E; e++) {
+        int v0 = topo->edges[e * 2 + 0];
+        int v1 = topo->edges[e * 2 + 1];
+        adj->vert_edge_offsets[v0 + 1]++;
+        if (v1 != v0) adj->vert_edge_offsets[v1 + 1]++;
+    }
+    for (int v = 0; v < V; v++) {
+        adj->vert_face_offsets[v + 1] += adj->vert_face_offsets[v];
+        adj->vert_edge_offsets[v + 1] += adj->vert_edge_offsets[v];
+    }
+
+    // Scatter; iterating faces/edges in order keeps each list ascending
+    std::vector<int> cursor(adj->vert_face_offsets, adj->vert_face_offsets + V);
+    for (int f = 0; f < F; f++) {
+        for (int j = 0; j < 3; j++) {
+            int v = mesh->triangles[f * 3 + j];
+            adj->vert_faces[cursor[v]++] = f;
+        }
+    }
+
+    cursor.assign(adj->vert_edge_offsets, adj->vert_edge_offsets + V);
+    for (int e = 0; e < E; e++) {
+        int v0 = topo->edges[e * 2 + 0];
+        int v1 = topo->edges[e * 2 + 1];
+        adj->vert_edges[cursor[v0]++] = e;
+        if (v1 != v0) adj->vert_edges[cursor[v1]++] = e;
+    }
+
+    // Resolve each triangle side to its edge through the lower vertex's
+    // edge list (O(valence) per side)
+    for (int f = 0; f < F; f++) {
+        const int* tri = &mesh->triangles[f * 3];
+        for (int j = 0; j < 3; j++) {
+            int a = tri[j];
+            int b = tri[(j + 1) % 3];
+            if (a > b) {
+                int t = a; a = b; b = t;
+            }
+
+            int found = -1;
+            for (int k = adj->vert_edge_offsets[a]; k < adj->vert_edge_offsets[a + 1]; k++) {
+                int e = adj->vert_edges[k];
+                if (topo->edges[e * 2 + 0] == a && topo->edges[e * 2 + 1] == b) {
+                    found = e;
+                    break;
+                }
+            }
+            adj->face_edges[f * 3 + j] = found;
+        }
+    }
+
+    return adj;
+}
+
+void free_adjacency(AdjacencyInfo* adj) {
+    if (!adj) return;
+
+    free(adj->vert_face_offsets);
+    free(adj->vert_faces);
+    free(adj->vert_edge_offsets);
+    free(adj->vert_edges);
+    free(adj->face_edges);
+    free(adj);
+}
+
 int validate_topology(const Mesh* mesh, const TopologyInfo* topo) {
     if (!mesh || !topo) return 0;
 
@@ -123,16 +497,60 @@ int validate_topology(const Mesh* mesh, const TopologyInfo* topo) {
 
     int euler = V - E + F;
 
-    printf("Topology validation:\n");
-    printf("  V=%d, E=%d, F=%d\n", V, E, F);
-    printf("  Euler characteristic: %d (expected 2 for closed mesh)\n", euler);
+    LOG_DEBUG("Topology validation:");
+    LOG_DEBUG("  V=%d, E=%d, F=%d", V, E, F);
+    LOG_DEBUG("  Euler characteristic: %d (expected 2 for closed mesh)", euler);
 
     // Closed meshes should have Euler = 2
     // Open meshes or meshes with holes may differ
     if (euler != 2) {
-        printf("  Warning: Non-standard Euler characteristic\n");
-        printf("  (This may be OK for open meshes or meshes with boundaries)\n");
+        LOG_DEBUG("  Warning: Non-standard Euler characteristic");
+        LOG_DEBUG("  (This may be OK for open meshes or meshes with boundaries)");
     }
 
     return 1;
 }
+
+int find_topology_edges(const TopologyInfo* topo, const int* edge_vertices, int num_pairs, int* edges_out) {
+    if (!topo || num_pairs < 0 || (num_pairs > 0 && (!edge_vertices || !edges_out))) return -1;
+
+    // Hash the requested pairs (not the edges), so memory follows the
+    // request and one pass over the edges resolves them all
+    size_t capacity = 16;
+    while (capacity < (size_t)num_pairs * 2) capacity <<= 1;
+    size_t mask = capacity - 1;
+
+    const uint64_t EMPTY = ~(uint64_t)0;
+    std::vector<uint64_t> slot_keys(capacity, EMPTY);
+    std::vector<int> slot_edges(capacity, -1);
+    std::vector<size_t> pair_slots((size_t)num_pairs, capacity);
+
+    for (int i = 0; i < num_pairs; i++) {
+        int a = edge_vertices[i * 2];
+        int b = edge_vertices[i * 2 + 1];
+        if (a < 0 || b < 0 || a == b) continue;
+        uint64_t key = make_edge_key(a, b);
+        size_t slot = (size_t)hash_edge_key(key) & mask;
+        while (slot_keys[slot] != EMPTY && slot_keys[slot] != key) {
+            slot = (slot + 1) & mask;
+        }
+        slot_keys[slot] = key;
+        pair_slots[i] = slot;
+    }
+
+    for (int e = 0; e < topo->num_edges && num_pairs > 0; e++) {
+        uint64_t key = make_edge_key(topo->edges[e * 2], topo->edges[e * 2 + 1]);
+        size_t slot = (size_t)hash_edge_key(key) & mask;
+        while (slot_keys[slot] != EMPTY && slot_keys[slot] != key) {
+            slot = (slot + 1) & mask;
+        }
+        if (slot_keys[slot] == key) slot_edges[slot] = e;
+    }
+
+    int found = 0;
+    for (int i = 0; i < num_pairs; i++) {
+        edges_out[i] = pair_slots[i] < capacity ? slot_edges[pair_slots[i]] : -1;
+        if (edges_out[i] >= 0) found++;
+    }
+    return found;
+}
@@ -0,0 +1,160 @@
+/**
+ * @file trace.cpp
+ * @brief Chrome trace-event recorder behind uv_trace.h
+ *
+ * Each thread appends complete ("X") events to its own buffer, so zones
+ * only contend with uv_trace_stop(). Buffers outlive their threads (the
+ * pool's workers are short-lived) until the trace is written.
+ */
+
+#include "uv_trace.h"
+#include "trace.h"
+#include "logging.h"
+
+#if defined(UVUNWRAP_TRACE_CHROME)
+
+#include "timer.h"
+#include <stdio.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace uvunwrap {
+
+namespace {
+
+struct TraceEvent {
+    const char* name;
+    long long start_ns;
+    long long duration_ns;
+};
+
+struct ThreadTrace {
+    int tid;
+    std::string name;
+    std::mutex mutex;
+    std::vector<TraceEvent> events;
+};
+
+std::atomic<bool> g_recording(false);
+std::atomic<int> g_next_tid(1);
+std::mutex g_trace_mutex;              // Guards everything below
+std::vector<std::shared_ptr<ThreadTrace> > g_threads;
+FILE* g_trace_file = NULL;
+long long g_origin_ns = 0;
+
+ThreadTrace& thread_trace() {
+    static thread_local std::shared_ptr<ThreadTrace> trace;
+    if (!trace) {
+        trace = std::make_shared<ThreadTrace>();
+        trace->tid = g_next_tid.fetch_add(1);
+        std::lock_guard<std::mutex> lock(g_trace_mutex);
+        g_threads.push_back(trace);
+    }
+    return *trace;
+}
+
+/** Drops buffered events and the buffers of threads that have exited; caller holds g_trace_mutex */
+void reset_threads() {
+    size_t kept = 0;
+    for (size_t i = 0; i < g_threads.size(); i++) {
+        {
+            std::lock_guard<std::mutex> lock(g_threads[i]->mutex);
+            g_threads[i]->events.clear();
+        }
+        if (g_threads[i].use_count() > 1) g_threads[kept++] = g_threads[i];
+    }
+    g_threads.resize(kept);
+}
+
+} // namespace
+
+long long trace_zone_begin() {
+    return g_recording.load(std::memory_order_relaxed) ? now_ns() : -1;
+}
+
+void trace_zone_end(const char* name, long long start_ns) {
+    if (start_ns < 0 || !g_recording.load(std::memory_order_relaxed)) return;
+    long long end_ns = now_ns();
+    ThreadTrace& trace = thread_trace();
+    std::lock_guard<std::mutex> lock(trace.mutex);
+    trace.events.push_back(TraceEvent{name, start_ns, end_ns - start_ns});
+}
+
+void trace_thread_name(const char* name, int index) {
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%s %d", name, index);
+    ThreadTrace& trace = thread_trace();
+    std::lock_guard<std::mutex> lock(trace.mutex);
+    trace.name = buffer;
+}
+
+} // namespace uvunwrap
+
+int uv_trace_start(const char* path) {
+    using namespace uvunwrap;
+    if (!path) return 0;
+    std::lock_guard<std::mutex> lock(g_trace_mutex);
+    g_recording.store(false);
+    if (g_trace_file) fclose(g_trace_file);
+    g_trace_file = fopen(path, "w");
+    if (!g_trace_file) {
+        LOG_ERROR("uv_trace_start: cannot create %s", path);
+        return 0;
+    }
+    reset_threads();
+    g_origin_ns = now_ns();
+    g_recording.store(true);
+    return 1;
+}
+
+int uv_trace_stop(void) {
+    using namespace uvunwrap;
+    std::lock_guard<std::mutex> lock(g_trace_mutex);
+    if (!g_trace_file) return -1;
+    g_recording.store(false);
+
+    // Timestamps in microseconds from uv_trace_start(); zones still open
+    // at the start or the stop are left out
+    FILE* file = g_trace_file;
+    int written = 0;
+    fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n", file);
+    fputs("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"uvunwrap\"}}", file);
+    for (size_t i = 0; i < g_threads.size(); i++) {
+        ThreadTrace& trace = *g_threads[i];
+        std::lock_guard<std::mutex> thread_lock(trace.mutex);
+        if (!trace.name.empty()) {
+            fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                    trace.tid, trace.name.c_str());
+        }
+        for (size_t e = 0; e < trace.events.size(); e++) {
+            const TraceEvent& event = trace.events[e];
+            if (event.start_ns < g_origin_ns) continue;
+            fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                    event.name, trace.tid, (event.start_ns - g_origin_ns) / 1000.0, event.duration_ns / 1000.0);
+            written++;
+        }
+    }
+    fputs("\n]}\n", file);
+    fclose(file);
+    g_trace_file = NULL;
+    reset_threads();
+    LOG_INFO("uv_trace_stop: wrote %d zones", written);
+    return written;
+}
+
+#else
+
+int uv_trace_start(const char* path) {
+    (void)path;
+    LOG_WARNING("uv_trace_start: this build records no Chrome traces (configure with UVUNWRAP_TRACE=CHROME)");
+    return 0;
+}
+
+int uv_trace_stop(void) {
+    return -1;
+}
+
+#endif
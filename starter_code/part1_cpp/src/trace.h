@@ -0,0 +1,111 @@
+/**
+ * @file trace.h
+ * @brief Internal profiling zones for Tracy or Chrome trace-event JSON
+ *
+ * Not part of the public API. The backend is picked at build time with
+ * UVUNWRAP_TRACE (CMake): TRACY emits Tracy zones through its C API,
+ * CHROME records complete events that uv_trace_stop() writes out (see
+ * uv_trace.h), and without either every macro compiles to nothing.
+ *
+ *   UV_TRACE_ZONE("topology");              // until the end of the block
+ *   UV_TRACE_ZONE_BEGIN(pins, "lscm pins"); // until UV_TRACE_ZONE_END(pins)
+ *   UV_TRACE_THREAD_NAME("island worker", t);
+ *
+ * Zone names must be string literals. A zone opened with BEGIN also ends
+ * when its variable goes out of scope, so early returns stay balanced.
+ */
+
+#ifndef UVUNWRAP_TRACE_H
+#define UVUNWRAP_TRACE_H
+
+#if defined(UVUNWRAP_TRACE_TRACY)
+#include <tracy/TracyC.h>
+#include <stdio.h>
+#endif
+
+namespace uvunwrap {
+
+#if defined(UVUNWRAP_TRACE_CHROME)
+
+/** Start of a zone on this thread, or -1 while no trace is being recorded */
+long long trace_zone_begin();
+
+/** Records a zone begun at start_ns (no-op for -1) */
+void trace_zone_end(const char* name, long long start_ns);
+
+/** Names this thread in the trace ("<name> <index>") */
+void trace_thread_name(const char* name, int index);
+
+class TraceZone {
+public:
+    explicit TraceZone(const char* name) : name_(name), start_(trace_zone_begin()) {}
+    ~TraceZone() { end(); }
+    void end() {
+        trace_zone_end(name_, start_);
+        start_ = -1;
+    }
+    TraceZone(const TraceZone&) = delete;
+    TraceZone& operator=(const TraceZone&) = delete;
+
+private:
+    const char* name_;
+    long long start_;
+};
+
+#elif defined(UVUNWRAP_TRACE_TRACY)
+
+inline void trace_thread_name(const char* name, int index) {
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%s %d", name, index);
+    TracyCSetThreadName(buffer);
+}
+
+class TraceZone {
+public:
+    explicit TraceZone(TracyCZoneCtx ctx) : ctx_(ctx), open_(true) {}
+    ~TraceZone() { end(); }
+    void end() {
+        if (open_) TracyCZoneEnd(ctx_);
+        open_ = false;
+    }
+    TraceZone(const TraceZone&) = delete;
+    TraceZone& operator=(const TraceZone&) = delete;
+
+private:
+    TracyCZoneCtx ctx_;
+    bool open_;
+};
+
+#else
+
+class TraceZone {
+public:
+    TraceZone() {}
+    void end() {}
+};
+
+#endif
+
+} // namespace uvunwrap
+
+#define UV_TRACE_CONCAT_(a, b) a##b
+#define UV_TRACE_CONCAT(a, b) UV_TRACE_CONCAT_(a, b)
+
+#if defined(UVUNWRAP_TRACE_CHROME)
+#define UV_TRACE_ZONE_BEGIN(var, name) uvunwrap::TraceZone var(name)
+#define UV_TRACE_THREAD_NAME(name, index) uvunwrap::trace_thread_name(name, index)
+#elif defined(UVUNWRAP_TRACE_TRACY)
+// TracyCZoneN keeps a static source location per call site
+#define UV_TRACE_ZONE_BEGIN(var, name) \
+    TracyCZoneN(UV_TRACE_CONCAT(var, _tracy), name, 1); \
+    uvunwrap::TraceZone var(UV_TRACE_CONCAT(var, _tracy))
+#define UV_TRACE_THREAD_NAME(name, index) uvunwrap::trace_thread_name(name, index)
+#else
+#define UV_TRACE_ZONE_BEGIN(var, name) uvunwrap::TraceZone var
+#define UV_TRACE_THREAD_NAME(name, index) ((void)0)
+#endif
+
+#define UV_TRACE_ZONE_END(var) var.end()
+#define UV_TRACE_ZONE(name) UV_TRACE_ZONE_BEGIN(UV_TRACE_CONCAT(uv_trace_zone_, __LINE__), name)
+
+#endif /* UVUNWRAP_TRACE_H */
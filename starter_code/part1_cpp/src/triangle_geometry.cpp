@@ -0,0 +1,187 @@
+/**
+ * @file triangle_geometry.cpp
+ * @brief Per-triangle geometry cache in SoA blocks
+ *
+ * Algorithm, per block of GEOMETRY_BLOCK faces:
+ * 1. Gather the edge vectors e1 = p1 - p0, e2 = p2 - p0 and p2 - p1 into
+ *    SoA arrays
+ * 2. Run the batch kernels on the block: the cross product and its length
+ *    (normal, area), the frame projection, the corner angles
+ * 3. Scatter the block into the face slots of the cache
+ * Blocks are independent, so building and updating split them over
+ * threads and the result is the same for every thread count. The build
+ * turns off FMA contraction here, so the lanes round as the scalar tail.
+ */
+
+#include "triangle_geometry.h"
+#include "math_utils.h"
+#include "vec_math.h"
+#include "simd.h"
+#include "parallel.h"
+#include "trace.h"
+
+namespace uvunwrap {
+
+namespace {
+
+const int GEOMETRY_BLOCK = 256;
+const int MIN_TRIANGLES_PER_THREAD = 16384;
+
+/** Parts of faces (faces[i], or first + i without a list) for i in [0, n) */
+void geometry_block(const Mesh* mesh, const int* faces, int first, int n, TriangleGeometry* g) {
+    float e1x[GEOMETRY_BLOCK], e1y[GEOMETRY_BLOCK], e1z[GEOMETRY_BLOCK];
+    float e2x[GEOMETRY_BLOCK], e2y[GEOMETRY_BLOCK], e2z[GEOMETRY_BLOCK];
+    float e3x[GEOMETRY_BLOCK], e3y[GEOMETRY_BLOCK], e3z[GEOMETRY_BLOCK];
+    float a[GEOMETRY_BLOCK], b[GEOMETRY_BLOCK], c[GEOMETRY_BLOCK], len[GEOMETRY_BLOCK];
+
+    const float* P = mesh->vertices;
+    for (int i = 0; i < n; i++) {
+        const int* tri = &mesh->triangles[(faces ? faces[i] : first + i) * 3];
+        const float* p0 = &P[tri[0] * 3];
+        const float* p1 = &P[tri[1] * 3];
+        const float* p2 = &P[tri[2] * 3];
+        e1x[i] = p1[0] - p0[0]; e1y[i] = p1[1] - p0[1]; e1z[i] = p1[2] - p0[2];
+        e2x[i] = p2[0] - p0[0]; e2y[i] = p2[1] - p0[1]; e2z[i] = p2[2] - p0[2];
+        e3x[i] = p2[0] - p1[0]; e3y[i] = p2[1] - p1[1]; e3z[i] = p2[2] - p1[2];
+    }
+
+    if (g->parts & (GEOMETRY_NORMALS | GEOMETRY_ANGLES)) {
+        vec3_cross_soa(n, e1x, e1y, e1z, e2x, e2y, e2z, a, b, c);
+        vec3_length_soa(n, a, b, c, len);
+    }
+    if (g->parts & GEOMETRY_NORMALS) {
+        for (int i = 0; i < n; i++) {
+            int f = faces ? faces[i] : first + i;
+            g->nx[f] = a[i];
+            g->ny[f] = b[i];
+            g->nz[f] = c[i];
+            g->area[f] = 0.5f * len[i];
+        }
+    }
+    if (g->parts & GEOMETRY_ANGLES) {
+        // Corner k lies between (p[k+1] - p[k]) and (p[k-1] - p[k]); every
+        // corner's |a × b| is twice the area, so cot = (a · b) / |e1 × e2|
+        for (int i = 0; i < n; i++) {
+            int f = faces ? faces[i] : first + i;
+            float ux = e3x[i], uy = e3y[i], uz = e3z[i];
+            float* angle = &g->angle[(size_t)f * 3];
+            float* cot = &g->cot[(size_t)f * 3];
+            angle[0] = corner_angle(e1x[i], e1y[i], e1z[i], e2x[i], e2y[i], e2z[i]);
+            angle[1] = corner_angle(ux, uy, uz, -e1x[i], -e1y[i], -e1z[i]);
+            angle[2] = corner_angle(-e2x[i], -e2y[i], -e2z[i], -ux, -uy, -uz);
+            float inv = len[i] > 1e-16f ? 1.0f / len[i] : 0.0f;
+            cot[0] = (e1x[i] * e2x[i] + e1y[i] * e2y[i] + e1z[i] * e2z[i]) * inv;
+            cot[1] = -(ux * e1x[i] + uy * e1y[i] + uz * e1z[i]) * inv;
+            cot[2] = (e2x[i] * ux + e2y[i] * uy + e2z[i] * uz) * inv;
+        }
+    }
+    if (g->parts & GEOMETRY_FRAMES) {
+        triangle_frames_soa(n, e1x, e1y, e1z, e2x, e2y, e2z, a, b, c);
+        for (int i = 0; i < n; i++) {
+            int f = faces ? faces[i] : first + i;
+            g->x1[f] = a[i];
+            g->x2[f] = b[i];
+            g->y2[f] = c[i];
+        }
+    }
+}
+
+/** geometry_block() over count faces in blocks, blocks spread over threads */
+void geometry_run(const Mesh* mesh, const int* faces, int count, int num_threads, TriangleGeometry* g) {
+    int threads = choose_thread_count(count, num_threads, MIN_TRIANGLES_PER_THREAD);
+    parallel_for_ranges(count, threads, [&](int, int begin, int end) {
+        for (int block = begin; block < end; block += GEOMETRY_BLOCK) {
+            int n = end - block < GEOMETRY_BLOCK ? end - block : GEOMETRY_BLOCK;
+            geometry_block(mesh, faces ? faces + block : NULL, block, n, g);
+        }
+    });
+}
+
+} // namespace
+
+long long TriangleGeometry::bytes() const {
+    size_t floats = nx.capacity() + ny.capacity() + nz.capacity() + area.capacity() + x1.capacity() +
+                    x2.capacity() + y2.capacity() + angle.capacity() + cot.capacity();
+    return (long long)(floats * sizeof(float));
+}
+
+void build_triangle_geometry(const Mesh* mesh, int parts, int num_threads, TriangleGeometry* out) {
+    UV_TRACE_ZONE("triangle geometry");
+    size_t F = mesh->num_triangles > 0 ? (size_t)mesh->num_triangles : 0;
+    out->parts = parts;
+    out->num_faces = (int)F;
+    size_t per_face = parts & GEOMETRY_NORMALS ? F : 0;
+    out->nx.resize(per_face);
+    out->ny.resize(per_face);
+    out->nz.resize(per_face);
+    out->area.resize(per_face);
+    per_face = parts & GEOMETRY_FRAMES ? F : 0;
+    out->x1.resize(per_face);
+    out->x2.resize(per_face);
+    out->y2.resize(per_face);
+    per_face = parts & GEOMETRY_ANGLES ? 3 * F : 0;
+    out->angle.resize(per_face);
+    out->cot.resize(per_face);
+    geometry_run(mesh, NULL, (int)F, num_threads, out);
+}
+
+void update_triangle_geometry(const Mesh* mesh, const int* faces, int count, int num_threads,
+                              TriangleGeometry* geometry) {
+    if (count <= 0 || geometry->parts == 0) return;
+    UV_TRACE_ZONE("triangle geometry update");
+    geometry_run(mesh, faces, count, num_threads, geometry);
+}
+
+void triangle_frames_soa(int n,
+                         const float* e1x, const float* e1y, const float* e1z,
+                         const float* e2x, const float* e2y, const float* e2z,
+                         float* x1, float* x2, float* y2) {
+    typedef Lanes::V V;
+    const V zero = Lanes::set1(0.0f), one = Lanes::set1(1.0f), eps = Lanes::set1(1e-8f);
+
+    int i = 0;
+    for (; i + Lanes::N <= n; i += Lanes::N) {
+        V ax = Lanes::load(e1x + i), ay = Lanes::load(e1y + i), az = Lanes::load(e1z + i);
+        V bx = Lanes::load(e2x + i), by = Lanes::load(e2y + i), bz = Lanes::load(e2z + i);
+
+        // x_axis = normalize(e1)
+        V len1 = Lanes::sqrt(Lanes::add(Lanes::add(Lanes::mul(ax, ax), Lanes::mul(ay, ay)), Lanes::mul(az, az)));
+        V inv1 = Lanes::div(one, len1);
+        Lanes::M short1 = Lanes::lt(len1, eps);
+        V xx = Lanes::select(short1, zero, Lanes::mul(ax, inv1));
+        V xy = Lanes::select(short1, zero, Lanes::mul(ay, inv1));
+        V xz = Lanes::select(short1, zero, Lanes::mul(az, inv1));
+
+        // z_axis = normalize(e1 × e2)
+        V cx = Lanes::sub(Lanes::mul(ay, bz), Lanes::mul(az, by));
+        V cy = Lanes::sub(Lanes::mul(az, bx), Lanes::mul(ax, bz));
+        V cz = Lanes::sub(Lanes::mul(ax, by), Lanes::mul(ay, bx));
+        V lenc = Lanes::sqrt(Lanes::add(Lanes::add(Lanes::mul(cx, cx), Lanes::mul(cy, cy)), Lanes::mul(cz, cz)));
+        V invc = Lanes::div(one, lenc);
+        Lanes::M shortc = Lanes::lt(lenc, eps);
+        V zx = Lanes::select(shortc, zero, Lanes::mul(cx, invc));
+        V zy = Lanes::select(shortc, zero, Lanes::mul(cy, invc));
+        V zz = Lanes::select(shortc, zero, Lanes::mul(cz, invc));
+
+        // y_axis = z_axis × x_axis
+        V yx = Lanes::sub(Lanes::mul(zy, xz), Lanes::mul(zz, xy));
+        V yy = Lanes::sub(Lanes::mul(zz, xx), Lanes::mul(zx, xz));
+        V yz = Lanes::sub(Lanes::mul(zx, xy), Lanes::mul(zy, xx));
+
+        Lanes::store(x1 + i, len1);
+        Lanes::store(x2 + i, Lanes::add(Lanes::add(Lanes::mul(bx, xx), Lanes::mul(by, xy)), Lanes::mul(bz, xz)));
+        Lanes::store(y2 + i, Lanes::add(Lanes::add(Lanes::mul(bx, yx), Lanes::mul(by, yy)), Lanes::mul(bz, yz)));
+    }
+    for (; i < n; i++) {
+        Vec3 e1 = {e1x[i], e1y[i], e1z[i]};
+        Vec3 e2 = {e2x[i], e2y[i], e2z[i]};
+        Vec3 x_axis = normalize(e1);
+        Vec3 z_axis = normalize(cross(e1, e2));
+        Vec3 y_axis = cross(z_axis, x_axis);
+        x1[i] = length(e1);
+        x2[i] = dot(e2, x_axis);
+        y2[i] = dot(e2, y_axis);
+    }
+}
+
+} // namespace uvunwrap
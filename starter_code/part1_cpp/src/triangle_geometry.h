@@ -0,0 +1,119 @@
+/**
+ * @file triangle_geometry.h
+ * @brief Internal per-triangle geometry cache shared by the pipeline stages
+ *
+ * Not part of the public API. Normals, areas, corner angles, cotangents
+ * and local 2D frames are computed once per mesh in a parallel pass over
+ * SoA blocks, and the stages read them instead of each re-deriving them
+ * from the vertex positions: seam detection the normals, chart splitting
+ * the normals and areas, LSCM assembly the frames. When vertices move
+ * only the faces around them are recomputed. Every quantity rounds as the
+ * stage computing it on the fly does, so reading the cache changes no
+ * output.
+ */
+
+#ifndef UVUNWRAP_TRIANGLE_GEOMETRY_H
+#define UVUNWRAP_TRIANGLE_GEOMETRY_H
+
+#include "mesh.h"
+#include "lscm.h"
+#include <math.h>
+#include <vector>
+
+namespace uvunwrap {
+
+/** Quantities a TriangleGeometry holds (bit flags) */
+enum TriangleGeometryParts {
+    GEOMETRY_NORMALS = 1,  /**< nx, ny, nz (unnormalised e1 × e2) and area */
+    GEOMETRY_FRAMES = 2,   /**< x1, x2, y2 of triangle_frames_soa() */
+    GEOMETRY_ANGLES = 4,   /**< angle and cot, 3 per face in corner order */
+};
+
+/**
+ * @brief SoA per-face geometry of one mesh
+ *
+ * With e1 = p1 - p0 and e2 = p2 - p0, face f has the normal
+ * (nx[f], ny[f], nz[f]) = e1 × e2 as triangle_normals_soa() computes it
+ * and area[f] = |n| / 2; its frame puts the corners at (0, 0), (x1[f], 0)
+ * and (x2[f], y2[f]); angle[3f + k] is the angle at corner k as
+ * compute_corner_angles() computes it and cot[3f + k] its cotangent
+ * (0 for a degenerate face). Arrays of parts not built are empty.
+ */
+struct TriangleGeometry {
+    int parts = 0;
+    int num_faces = 0;
+    std::vector<float> nx, ny, nz, area;
+    std::vector<float> x1, x2, y2;
+    std::vector<float> angle, cot;
+
+    /** Bytes held by the arrays */
+    long long bytes() const;
+};
+
+/**
+ * @brief Compute the parts of every face of mesh into out
+ * @param parts TriangleGeometryParts flags
+ * @param num_threads Worker threads (0 = automatic by face count)
+ */
+void build_triangle_geometry(const Mesh* mesh, int parts, int num_threads, TriangleGeometry* out);
+
+/**
+ * @brief Recompute count faces of geometry after their vertices moved
+ *
+ * geometry must have been built for mesh (same faces); faces may repeat.
+ */
+void update_triangle_geometry(const Mesh* mesh, const int* faces, int count, int num_threads,
+                              TriangleGeometry* geometry);
+
+/**
+ * @brief Local frame coordinates of a batch of triangles
+ *
+ * With e1 = p1 - p0 and e2 = p2 - p0 (SoA), the frame has X along e1 and
+ * Z along e1 × e2, so the vertices project to (0, 0), (x1, 0), (x2, y2).
+ * Lanes handle Lanes::N triangles at a time with the same float
+ * operations, in the same order, as the scalar version in the tail loop.
+ */
+void triangle_frames_soa(int n,
+                         const float* e1x, const float* e1y, const float* e1z,
+                         const float* e2x, const float* e2y, const float* e2z,
+                         float* x1, float* x2, float* y2);
+
+/**
+ * @brief Corner angle between two edge vectors (not normalised)
+ *
+ * acos(dot / (|a||b|)) with the same zero-length convention as
+ * vec3_normalize(): a degenerate edge makes the dot product 0 → π/2.
+ */
+inline float corner_angle(float ax, float ay, float az,
+                          float bx, float by, float bz) {
+    float la = ax * ax + ay * ay + az * az;
+    float lb = bx * bx + by * by + bz * bz;
+    float denom = sqrtf(la * lb);
+    float c = denom > 1e-16f ? (ax * bx + ay * by + az * bz) / denom : 0.0f;
+    c = c < -1.0f ? -1.0f : (c > 1.0f ? 1.0f : c);
+    return acosf(c);
+}
+
+/**
+ * @brief lscm_parameterize_into() taking the triangle frames from geometry
+ *
+ * Defined in lscm.cpp. Face face_indices[i] of mesh is face
+ * geometry_faces[face_indices[i]] of the mesh geometry was built for
+ * (geometry_faces NULL: the same mesh), e.g. an island submesh and its
+ * faces in the whole mesh. The UVs are those of lscm_parameterize_into();
+ * geometry without frames is ignored.
+ */
+int lscm_parameterize_geometry(const Mesh* mesh,
+                               const int* face_indices,
+                               int num_faces,
+                               const LscmOptions* options,
+                               LscmReport* report_out,
+                               float* uvs_out,
+                               int* vertices_out,
+                               int* vertex_remap,
+                               const TriangleGeometry* geometry,
+                               const int* geometry_faces);
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_TRIANGLE_GEOMETRY_H */
@@ -14,103 +14,152 @@
 
 #include "unwrap.h"
 #include "lscm.h"
+#include "unwrap_options.h"
+#include "result_cache.h"
+#include "island_solver.h"
+#include "unwrap_context.h"
+#include "mesh_view_internal.h"
+#include "half_edge.h"
+#include "chart_split.h"
+#include "triangle_geometry.h"
+#include "island_mesh.h"
+#include "island_instances.h"
+#include "island_cache.h"
+#include "disjoint_set.h"
+#include "parallel.h"
+#include "numa.h"
+#include "task_graph.h"
+#include "arena.h"
+#include "memory_meter.h"
+#include "timer.h"
+#include "trace.h"
+#include "logging.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <atomic>
+#include <mutex>
 #include <vector>
-#include <set>
-#include <map>
+#include <algorithm>
 
 /**
- * @brief Extract UV islands after seam cuts
+ * @brief Island extraction shared by extract_islands() and the context
+ *        pipeline
  *
- * Uses connected components algorithm on face graph after removing seam edges.
- *
- * @param mesh Input mesh
- * @param topo Topology info
- * @param seam_edges Array of seam edge indices
- * @param num_seams Number of seams
- * @param num_islands_out Output: number of islands
- * @return Array of island IDs per face
+ * Scratch comes from the arena. face_island_ids is always malloc'd (it
+ * ends up owned by UnwrapResult); the CSR arrays come from the arena when
+ * arena_output is set and from malloc otherwise.
  */
-static int* extract_islands(const Mesh* mesh,
-                           const TopologyInfo* topo,
-                           const int* seam_edges,
-                           int num_seams,
-                           int* num_islands_out) {
-    // TODO: Implement island extraction
-    //
-    // Algorithm:
-    // 1. Build face adjacency graph (faces connected by non-seam edges)
-    // 2. Run connected components (BFS or DFS)
-    // 3. Assign island ID to each face
-    //
-    // Steps:
-    // 1. Create std::set<int> of seam edge indices for fast lookup
-    // 2. Build adjacency list for faces (only through non-seam edges)
-    // 3. Run BFS/DFS to find connected components
-    // 4. Return array of island IDs (one per face)
-
-    int* face_island_ids = (int*)malloc(mesh->num_triangles * sizeof(int));
-
-    // Initialize all to -1 (unvisited)
-    for (int i = 0; i < mesh->num_triangles; i++) {
-        face_island_ids[i] = -1;
-    }
-
-    // 1. Create set of seam edge indices for fast lookup
-    std::set<int> seam_set;
+static void extract_islands_into(const Mesh* mesh,
+                                 const TopologyInfo* topo,
+                                 const int* seam_edges,
+                                 int num_seams,
+                                 uvunwrap::Arena& arena,
+                                 bool arena_output,
+                                 IslandInfo* islands) {
+    typedef uvunwrap::ArenaAllocator<int> IntAlloc;
+    int F = mesh->num_triangles;
+
+    // 1. Seam membership as a byte mask
+    unsigned char* is_seam = arena.alloc_array<unsigned char>(topo->num_edges);
+    memset(is_seam, 0, topo->num_edges);
     for (int i = 0; i < num_seams; i++) {
-        seam_set.insert(seam_edges[i]);
+        int e = seam_edges[i];
+        if (e >= 0 && e < topo->num_edges) is_seam[e] = 1;
     }
 
-    // 2. Build adjacency list for faces (only through non-seam edges)
-    // We iterate edges. If edge is not seam and not boundary (2 faces), add adjacency.
-    std::vector<std::vector<int>> adj(mesh->num_triangles);
-    
+    // 2. Union faces across every interior non-seam edge
+    uvunwrap::BasicDisjointSet<IntAlloc> forest(F, IntAlloc(&arena));
     for (int e = 0; e < topo->num_edges; e++) {
-        if (seam_set.find(e) != seam_set.end()) continue; // Skip seams
-        
+        if (is_seam[e]) continue;
+
         int f0 = topo->edge_faces[e * 2];
         int f1 = topo->edge_faces[e * 2 + 1];
-        
         if (f0 != -1 && f1 != -1) {
-            adj[f0].push_back(f1);
-            adj[f1].push_back(f0);
-        }
-    }
-    
-    // 3. Run BFS to find connected components
-    int current_island_id = 0;
-    
-    for (int start_face = 0; start_face < mesh->num_triangles; start_face++) {
-        if (face_island_ids[start_face] != -1) continue;
-        
-        // Start new island
-        face_island_ids[start_face] = current_island_id;
-        std::vector<int> q;
-        q.push_back(start_face);
-        
-        int head = 0;
-        while(head < (int)q.size()) {
-            int u = q[head++];
-            
-            for (int v : adj[u]) {
-                if (face_island_ids[v] == -1) {
-                    face_island_ids[v] = current_island_id;
-                    q.push_back(v);
-                }
-            }
+            forest.unite(f0, f1);
         }
-        current_island_id++;
     }
-    
-    *num_islands_out = current_island_id;
 
+    islands->face_island_ids = (int*)malloc((F > 0 ? F : 1) * sizeof(int));
+    islands->island_faces = arena_output ? arena.alloc_array<int>(F > 0 ? F : 1)
+                                         : (int*)malloc((F > 0 ? F : 1) * sizeof(int));
 
+    // 3. Label roots in face order, so island N is the component whose
+    //    lowest face comes N-th (same numbering as a BFS sweep). There are
+    //    at most F islands, so counts never grows past its reservation.
+    int* root_label = arena.alloc_array<int>(F);
+    for (int f = 0; f < F; f++) root_label[f] = -1;
+    int* counts = arena.alloc_array<int>(F);
+    int num_islands = 0;
+    for (int f = 0; f < F; f++) {
+        int root = forest.find(f);
+        if (root_label[root] == -1) {
+            root_label[root] = num_islands;
+            counts[num_islands++] = 0;
+        }
+        int id = root_label[root];
+        islands->face_island_ids[f] = id;
+        counts[id]++;
+    }
 
-    printf("Extracted %d UV islands\n", *num_islands_out);
+    // 4. CSR island -> faces (faces ascending within each island)
+    islands->num_islands = num_islands;
+    islands->island_face_offsets = arena_output ? arena.alloc_array<int>(num_islands + 1)
+                                                : (int*)malloc((num_islands + 1) * sizeof(int));
+    islands->island_face_offsets[0] = 0;
+    for (int i = 0; i < num_islands; i++) {
+        islands->island_face_offsets[i + 1] = islands->island_face_offsets[i] + counts[i];
+    }
+
+    int* cursor = counts;
+    for (int i = 0; i < num_islands; i++) cursor[i] = islands->island_face_offsets[i];
+    for (int f = 0; f < F; f++) {
+        islands->island_faces[cursor[islands->face_island_ids[f]]++] = f;
+    }
 
-    return face_island_ids;
+    LOG_INFO("Extracted %d UV islands", num_islands);
+}
+
+IslandInfo* extract_islands(const Mesh* mesh,
+                            const TopologyInfo* topo,
+                            const int* seam_edges,
+                            int num_seams) {
+    if (!mesh || !topo || (num_seams > 0 && !seam_edges)) return NULL;
+
+    uvunwrap::Arena scratch;
+    IslandInfo* islands = (IslandInfo*)malloc(sizeof(IslandInfo));
+    extract_islands_into(mesh, topo, seam_edges, num_seams, scratch, false, islands);
+
+    // Closed islands (no boundary or cut edge) are opened into charts as
+    // unwrap_mesh() opens them; the half-edges are only built for those
+    std::vector<unsigned char> open(islands->num_islands, 0);
+    for (int e = 0; e < topo->num_edges; e++) {
+        int f0 = topo->edge_faces[e * 2];
+        int f1 = topo->edge_faces[e * 2 + 1];
+        if (f0 < 0) continue;
+        if (f1 < 0 || islands->face_island_ids[f0] != islands->face_island_ids[f1]) {
+            open[islands->face_island_ids[f0]] = 1;
+            if (f1 >= 0) open[islands->face_island_ids[f1]] = 1;
+        }
+    }
+    if (std::find(open.begin(), open.end(), 0) != open.end()) {
+        uvunwrap::HalfEdgeMesh he;
+        if (uvunwrap::half_edges_from_topology(mesh, topo, &he)) {
+            uvunwrap::split_islands_into_charts(mesh, he, 0, 0.0f, 0, scratch, false, islands);
+        }
+    }
+    return islands;
+}
+
+void free_islands(IslandInfo* islands) {
+    if (!islands) return;
+
+    free(islands->face_island_ids);
+    free(islands->island_face_offsets);
+    free(islands->island_faces);
+    free(islands);
 }
 
 /**
@@ -118,144 +167,1100 @@ static int* extract_islands(const Mesh* mesh,
  */
 static void copy_island_uvs(Mesh* result,
                            const float* island_uvs,
-                           const int* face_indices,
-                           int num_faces,
-                           const std::map<int, int>& global_to_local) {
-    // TODO: Implement UV copying
-    //
-    // For each face in the island:
-    //   For each vertex in the face:
-    //     global_idx = vertex index in mesh
-    //     local_idx = global_to_local[global_idx]
-    //     result->uvs[global_idx * 2] = island_uvs[local_idx * 2]
-    //     result->uvs[global_idx * 2 + 1] = island_uvs[local_idx * 2 + 1]
-
-    for (int local_f = 0; local_f < num_faces; local_f++) {
-        int global_f = face_indices[local_f];
-        
+                           const int* island_vertices,
+                           int num_island_verts) {
+    for (int local_v = 0; local_v < num_island_verts; local_v++) {
+        int global_v = island_vertices[local_v];
+        result->uvs[global_v * 2 + 0] = island_uvs[local_v * 2 + 0];
+        result->uvs[global_v * 2 + 1] = island_uvs[local_v * 2 + 1];
+    }
+}
+
+// Islands per worker when counting the split copies of each island
+static const int SPLIT_ISLANDS_PER_THREAD = 64;
+
+/**
+ * @brief Output mesh with one vertex per (island, input vertex), its
+ *        per-island ranges assigned before any island is solved
+ *
+ * Island i owns copies [offsets[i], offsets[i + 1]), numbered in its face
+ * order. The ranges depend only on the island face lists, so every island
+ * is later written by write_split_island() on whichever worker finishes
+ * it, without locks and in any order. Triangles, positions and UVs are
+ * left to those writes; UVs start zeroed for islands that are not solved.
+ *
+ * @param offsets_out num_islands + 1 copy offsets (arena)
+ * @param remap_out Input vertex of each output vertex (malloc'd)
+ */
+static Mesh* allocate_split_mesh(const Mesh* mesh,
+                                 const IslandInfo* islands,
+                                 int num_threads,
+                                 uvunwrap::Arena& arena,
+                                 int** offsets_out,
+                                 int** remap_out) {
+    int V = mesh->num_vertices;
+    int F = mesh->num_triangles;
+    int num_islands = islands->num_islands;
+    int* offsets = arena.alloc_array<int>((size_t)num_islands + 1);
+    offsets[0] = 0;
+
+    // A stamp holds the last island that counted the vertex, so it needs
+    // no clearing between islands
+    int threads = uvunwrap::choose_thread_count(num_islands, num_threads, SPLIT_ISLANDS_PER_THREAD);
+    std::vector<std::vector<int> > stamps((size_t)threads);
+    uvunwrap::parallel_for_dynamic(num_islands, threads, [&](int t, int island) {
+        std::vector<int>& stamp = stamps[t];
+        if (stamp.empty()) stamp.assign((size_t)V, -1);
+        int count = 0;
+        for (int i = islands->island_face_offsets[island]; i < islands->island_face_offsets[island + 1]; i++) {
+            const int* tri = &mesh->triangles[islands->island_faces[i] * 3];
+            for (int j = 0; j < 3; j++) {
+                if (stamp[tri[j]] == island) continue;
+                stamp[tri[j]] = island;
+                count++;
+            }
+        }
+        offsets[island + 1] = count;
+    });
+    for (int island = 0; island < num_islands; island++) offsets[island + 1] += offsets[island];
+    int num_copies = offsets[num_islands];
+
+    Mesh* out = (Mesh*)malloc(sizeof(Mesh));
+    out->num_vertices = num_copies;
+    out->num_triangles = F;
+    out->triangles = (int*)malloc((size_t)(F > 0 ? F : 1) * 3 * sizeof(int));
+    out->vertices = (float*)malloc((size_t)(num_copies > 0 ? num_copies : 1) * 3 * sizeof(float));
+    out->uvs = (float*)calloc((size_t)(num_copies > 0 ? num_copies : 1) * 2, sizeof(float));
+    *remap_out = (int*)malloc((size_t)(num_copies > 0 ? num_copies : 1) * sizeof(int));
+    *offsets_out = offsets;
+    return out;
+}
+
+/**
+ * @brief Write one island's range of the split output mesh
+ *
+ * Touches only the island's copies and faces, so islands are written
+ * concurrently. A failed or skipped island (num_island_verts < 0) keeps
+ * zero UVs. copy is the mesh-sized all -1 scratch, restored on return.
+ */
+static void write_split_island(const Mesh* mesh,
+                               const IslandInfo* islands,
+                               int island,
+                               const int* offsets,
+                               int* copy,
+                               const float* island_uvs,
+                               const int* island_vertices,
+                               int num_island_verts,
+                               Mesh* out,
+                               int* remap) {
+    int base = offsets[island];
+    int n = base;
+    for (int i = islands->island_face_offsets[island]; i < islands->island_face_offsets[island + 1]; i++) {
+        int f = islands->island_faces[i];
         for (int j = 0; j < 3; j++) {
-            int global_v = result->triangles[global_f * 3 + j];
-            auto it = global_to_local.find(global_v);
-            if (it != global_to_local.end()) {
-                int local_v = it->second;
-                result->uvs[global_v * 2 + 0] = island_uvs[local_v * 2 + 0];
-                result->uvs[global_v * 2 + 1] = island_uvs[local_v * 2 + 1];
+            int v = mesh->triangles[f * 3 + j];
+            if (copy[v] < 0) {
+                copy[v] = n;
+                remap[n] = v;
+                memcpy(&out->vertices[(size_t)n * 3], &mesh->vertices[(size_t)v * 3], 3 * sizeof(float));
+                n++;
+            }
+            out->triangles[f * 3 + j] = copy[v];
+        }
+    }
+    for (int local_v = 0; local_v < num_island_verts; local_v++) {
+        int c = copy[island_vertices[local_v]];
+        out->uvs[c * 2 + 0] = island_uvs[local_v * 2 + 0];
+        out->uvs[c * 2 + 1] = island_uvs[local_v * 2 + 1];
+    }
+    for (int c = base; c < n; c++) copy[remap[c]] = -1;
+}
+
+/**
+ * @brief Give corners reached only by degenerate faces the UV of a solved
+ *        corner of the same face
+ *
+ * The island was solved without its flagged faces, so their corners may
+ * be missing from vertices/uvs. Each pass maps the unsolved corners of
+ * faces that have a mapped one; corners still unmapped after the passes
+ * (a face joined to the chart only through other unmapped corners) take
+ * the first UV. vertex_remap is the all -1 scratch the solve used and is
+ * restored before returning.
+ *
+ * @return New number of island vertices
+ */
+static int attach_degenerate_corners(const Mesh* mesh,
+                                     const int* faces,
+                                     int num_faces,
+                                     const unsigned char* face_flags,
+                                     int* vertex_remap,
+                                     float* uvs,
+                                     int* vertices,
+                                     int num_verts) {
+    for (int i = 0; i < num_verts; i++) vertex_remap[vertices[i]] = i;
+    int n = num_verts;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int i = 0; i < num_faces; i++) {
+            if (!face_flags[faces[i]]) continue;
+            const int* tri = &mesh->triangles[faces[i] * 3];
+            int from = -1;
+            for (int k = 0; k < 3 && from < 0; k++) from = vertex_remap[tri[k]];
+            if (from < 0) continue;
+            for (int k = 0; k < 3; k++) {
+                if (vertex_remap[tri[k]] >= 0) continue;
+                vertex_remap[tri[k]] = n;
+                vertices[n] = tri[k];
+                uvs[n * 2 + 0] = uvs[from * 2 + 0];
+                uvs[n * 2 + 1] = uvs[from * 2 + 1];
+                n++;
+                changed = true;
             }
         }
     }
+    for (int i = 0; i < num_faces; i++) {
+        const int* tri = &mesh->triangles[faces[i] * 3];
+        for (int k = 0; k < 3; k++) {
+            if (vertex_remap[tri[k]] >= 0) continue;
+            vertex_remap[tri[k]] = n;
+            vertices[n] = tri[k];
+            uvs[n * 2 + 0] = uvs[0];
+            uvs[n * 2 + 1] = uvs[1];
+            n++;
+        }
+    }
+    for (int i = 0; i < n; i++) vertex_remap[vertices[i]] = -1;
+    return n;
+}
+
+/** Per-worker buffers of the island solves, reused across islands */
+struct SolveScratch {
+    std::vector<int> triangles;  // the island's triangles widened to int
+    std::vector<int> faces;      // 0, 1, 2, ...: every face of the submesh
+    std::vector<int> remap;      // submesh-sized, all -1 between solves
+    std::vector<int> pins;
+    std::vector<float> uvs;      // warm-start UVs of the island
+    std::vector<int> copies;     // mesh-sized, all -1 between split writes
+};
+
+/**
+ * @brief lscm_parameterize_into() of one island, on its compact submesh
+ *
+ * The submesh numbers vertices as the solve would in place, so the UVs
+ * are the same; vertices_out is mapped back to mesh vertices.
+ * vertex_remap is the mesh-sized all -1 scratch, used to find pins.
+ * Submesh face k is mesh face mesh_faces[k], whose frame geometry holds.
+ * With the island cache on, an earlier solve of the same submesh is
+ * taken instead of solving (*cached_out set to 1) and a solve is kept.
+ */
+static int solve_island_mesh(const Mesh* mesh,
+                             const uvunwrap::IslandMeshes& meshes,
+                             int island,
+                             const LscmOptions* lscm_options,
+                             int* vertex_remap,
+                             SolveScratch& scratch,
+                             LscmReport* report_out,
+                             float* uvs_out,
+                             int* vertices_out,
+                             const uvunwrap::TriangleGeometry* geometry,
+                             const int* mesh_faces,
+                             int* cached_out) {
+    Mesh local;
+    meshes.view(island, scratch.triangles, &local);
+    LscmOptions options = *lscm_options;
+    if (options.initial_uvs) {
+        meshes.gather_uvs(island, options.initial_uvs, scratch.uvs);
+        options.initial_uvs = scratch.uvs.data();
+    }
+    if (options.pinned_vertices) {
+        meshes.local_pins(island, options.pinned_vertices, options.num_pinned_vertices, mesh->num_vertices,
+                          vertex_remap, scratch.pins);
+        options.pinned_vertices = scratch.pins.empty() ? NULL : scratch.pins.data();
+        options.num_pinned_vertices = (int)scratch.pins.size();
+    }
+    uint64_t key = uvunwrap::island_cache_key(&local, &options);
+    int num_verts = uvunwrap::island_cache_lookup(key, &local, uvs_out, vertices_out, report_out);
+    *cached_out = num_verts > 0 ? 1 : 0;
+    if (num_verts == 0) {
+        for (int f = (int)scratch.faces.size(); f < local.num_triangles; f++) scratch.faces.push_back(f);
+        if ((int)scratch.remap.size() < local.num_vertices) scratch.remap.resize(local.num_vertices, -1);
+        num_verts = uvunwrap::lscm_parameterize_geometry(&local, scratch.faces.data(), local.num_triangles, &options,
+                                                         report_out, uvs_out, vertices_out, scratch.remap.data(),
+                                                         geometry, mesh_faces);
+        uvunwrap::island_cache_store(key, &local, uvs_out, vertices_out, num_verts, report_out);
+    }
+    const int* global = meshes.vertices(island);
+    for (int i = 0; i < num_verts; i++) vertices_out[i] = global[vertices_out[i]];
+    return num_verts;
+}
+
+// Indexed by LscmSolver
+static const char* const LSCM_SOLVER_NAMES[] = {"auto",    "ldlt", "llt",       "lu",     "cholmod",
+                                                "pardiso", "cg",   "multigrid", "cuda_cg"};
+static_assert(sizeof(LSCM_SOLVER_NAMES) / sizeof(LSCM_SOLVER_NAMES[0]) == LSCM_SOLVER_CUDA_CG + 1,
+              "LSCM_SOLVER_NAMES must name every LscmSolver");
+
+static const char* lscm_solver_name(int solver) {
+    if (solver < 0 || solver > LSCM_SOLVER_CUDA_CG) return "unknown";
+    return LSCM_SOLVER_NAMES[solver];
+}
+
+// Share of UnwrapProgress's fraction at the start of each stage; the
+// solve stage advances by solved faces in between
+static const float PROGRESS_SEAMS = 0.05f;
+static const float PROGRESS_ISLANDS = 0.1f;
+static const float PROGRESS_SOLVE = 0.15f;
+static const float PROGRESS_PACKING = 0.9f;
+static const float PROGRESS_METRICS = 0.95f;
+
+/**
+ * @brief Progress reporting and cancellation of one unwrap call
+ *
+ * The caller's callback runs under the mutex, so it is never re-entered
+ * although islands finish on worker threads. Cancellation, by flag or by
+ * the callback, latches; LSCM polls it through LscmOptions::should_cancel.
+ */
+struct UnwrapMonitor {
+    const UnwrapParams* params;
+    const volatile int* cancel;  // the context's flag, polled with params->cancel
+    std::mutex mutex;
+    std::atomic<bool> cancelled;
+    int num_islands;
+    int islands_done;
+    long long total_faces;
+    long long faces_done;
+    float fraction;
+
+    UnwrapMonitor(const UnwrapParams* p, const volatile int* flag)
+        : params(p), cancel(flag), cancelled(false), num_islands(0), islands_done(0), total_faces(0), faces_done(0),
+          fraction(0.0f) {}
+
+    /** True once the call is cancelled */
+    bool poll() {
+        if (cancelled.load(std::memory_order_relaxed)) return true;
+        if ((params->cancel && *params->cancel) || (cancel && *cancel)) {
+            cancelled.store(true, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    /** Report a stage starting at fraction at; true once cancelled */
+    bool report(int stage, float at) {
+        if (params->progress) {
+            std::lock_guard<std::mutex> lock(mutex);
+            notify(stage, at);
+        }
+        return poll();
+    }
+
+    /** Report a solved island of faces faces; true once cancelled */
+    bool island_done(int faces) {
+        if (params->progress) {
+            std::lock_guard<std::mutex> lock(mutex);
+            islands_done++;
+            faces_done += faces;
+            float solved = total_faces > 0 ? (float)((double)faces_done / total_faces) : 1.0f;
+            notify(UNWRAP_STAGE_SOLVE, PROGRESS_SOLVE + (PROGRESS_PACKING - PROGRESS_SOLVE) * solved);
+        }
+        return poll();
+    }
+
+private:
+    void notify(int stage, float at) {
+        fraction = std::max(fraction, std::min(at, 1.0f));
+        if (params->progress(stage, islands_done, num_islands, fraction, params->progress_user_data)) {
+            cancelled.store(true, std::memory_order_relaxed);
+        }
+    }
+};
+
+static int monitor_should_cancel(void* user_data) {
+    return ((UnwrapMonitor*)user_data)->poll() ? 1 : 0;
+}
+
+// Reservation for an island solve without a memory budget, where the
+// symbolic estimate is not worth its time: what LscmReport::peak_bytes
+// comes to per face for a direct solve of a few thousand faces; fill-in
+// adds about a tenth per doubling beyond that
+const double ISLAND_BYTES_PER_FACE = 1024.0;
+
+static long long estimate_island_bytes(int num_faces) {
+    double faces = (double)num_faces;
+    double fill = faces > 4096.0 ? 1.0 + 0.1 * log2(faces / 4096.0) : 1.0;
+    return (long long)(faces * ISLAND_BYTES_PER_FACE * fill);
+}
+
+static long long mesh_bytes(const Mesh* mesh) {
+    return ((long long)mesh->num_vertices * 5 + (long long)mesh->num_triangles * 3) * 4;
+}
+
+void unwrap_params_default(UnwrapParams* params) {
+    if (!params) return;
+
+    memset(params, 0, sizeof(UnwrapParams));
+    params->angle_threshold = 30.0f;
+    params->min_island_faces = 5;
+    params->pack_islands = 1;
+    params->island_margin = 0.02f;
+}
+
+/**
+ * @brief Reusable pipeline state: the scratch arena is reset per mesh and
+ *        keeps its memory, so a warm context does no scratch allocation
+ */
+UnwrapContext* unwrap_context_create(void) {
+    return new UnwrapContext();
+}
+
+void unwrap_context_free(UnwrapContext* ctx) {
+    delete ctx;
+}
+
+void unwrap_context_stats(const UnwrapContext* ctx, UnwrapContextStats* stats_out) {
+    if (!ctx || !stats_out) return;
+    stats_out->scratch_capacity = (long long)ctx->arena.capacity();
+    stats_out->scratch_block_allocations = ctx->arena.block_allocations();
+}
+
+int unwrap_numa_node_count(void) {
+    return uvunwrap::numa_node_count();
+}
+
+void unwrap_context_set_numa(UnwrapContext* ctx, int policy) {
+    if (!ctx) return;
+    ctx->numa = policy == UNWRAP_NUMA_SPREAD ? UNWRAP_NUMA_SPREAD : UNWRAP_NUMA_NONE;
+}
+
+void unwrap_context_set_log_callback(UnwrapContext* ctx, UvLogCallback callback, void* user_data, int level) {
+    if (!ctx) return;
+    if (level < UV_LOG_SILENT) level = UV_LOG_SILENT;
+    if (level > UV_LOG_DEBUG) level = UV_LOG_DEBUG;
+    ctx->log.callback = callback;
+    ctx->log.user_data = user_data;
+    ctx->log.level = level;
 }
 
 Mesh* unwrap_mesh(const Mesh* mesh,
                   const UnwrapParams* params,
                   UnwrapResult** result_out) {
-    if (!mesh || !params || !result_out) {
-        fprintf(stderr, "unwrap_mesh: Invalid arguments\n");
+    UnwrapContext ctx;
+    return unwrap_mesh_ctx(&ctx, mesh, params, result_out);
+}
+
+Mesh* unwrap_mesh_ctx(UnwrapContext* ctx,
+                      const Mesh* mesh,
+                      const UnwrapParams* params,
+                      UnwrapResult** result_out) {
+    return uvunwrap::unwrap_mesh_with_solver(ctx, mesh, params, NULL, result_out);
+}
+
+Mesh* unwrap_mesh_view(UnwrapContext* ctx,
+                       MeshView* view,
+                       const UnwrapParams* params,
+                       UnwrapResult** result_out) {
+    const Mesh* mesh = mesh_view_mesh(view);
+    if (!mesh) {
+        LOG_ERROR("unwrap_mesh_view: Invalid arguments");
         return NULL;
     }
+    if (!ctx) {
+        UnwrapContext local;
+        return uvunwrap::unwrap_mesh_with_solver(&local, mesh, params, NULL, result_out, view);
+    }
+    return uvunwrap::unwrap_mesh_with_solver(ctx, mesh, params, NULL, result_out, view);
+}
 
-    printf("\n=== UV Unwrapping ===\n");
-    printf("Input: %d vertices, %d triangles\n",
-           mesh->num_vertices, mesh->num_triangles);
-    printf("Parameters:\n");
-    printf("  Angle threshold: %.1f°\n", params->angle_threshold);
-    printf("  Min island faces: %d\n", params->min_island_faces);
-    printf("  Pack islands: %s\n", params->pack_islands ? "yes" : "no");
-    printf("  Island margin: %.3f\n", params->island_margin);
-    printf("\n");
-
-    // TODO: Implement main unwrapping pipeline
-    //
-    // STEP 1: Build topology
-    TopologyInfo* topo = build_topology(mesh);
-    if (!topo) {
-        fprintf(stderr, "Failed to build topology\n");
+Mesh* uvunwrap::unwrap_mesh_with_solver(UnwrapContext* ctx,
+                                        const Mesh* mesh,
+                                        const UnwrapParams* params,
+                                        IslandSolver* solver,
+                                        UnwrapResult** result_out,
+                                        MeshView* view) {
+    if (!ctx || !mesh || !params || !result_out) {
+        LOG_ERROR("unwrap_mesh: Invalid arguments");
         return NULL;
     }
-    validate_topology(mesh, topo);
 
-    // STEP 2: Detect seams
-    int num_seams;
-    int* seam_edges = detect_seams(mesh, topo, params->angle_threshold, &num_seams);
+    uvunwrap::ScopedLogSink log_scope(ctx->log.callback ? &ctx->log : NULL);
+    uvunwrap::NumaPlacement placement = uvunwrap::current_numa_placement();
+    if (ctx->numa != UNWRAP_NUMA_NONE) {
+        placement.policy = ctx->numa;
+        placement.node = -1;
+    }
+    uvunwrap::ScopedNumaPlacement numa_scope(placement);
+    UV_TRACE_ZONE("unwrap_mesh");
+    long long start_ns = uvunwrap::now_ns();
+    UnwrapMonitor monitor(params, ctx->cancel);
+    uint64_t cache_key;
+    Mesh* cached = uvunwrap::result_cache_lookup(mesh, params, result_out, &cache_key);
+    if (cached) {
+        (*result_out)->stats.total_ns = uvunwrap::now_ns() - start_ns;
+        LOG_INFO("unwrap_mesh: result cache hit (%d islands)", (*result_out)->num_islands);
+        monitor.report(UNWRAP_STAGE_DONE, 1.0f);
+        return cached;
+    }
 
-    // STEP 3: Extract islands
-    int num_islands;
-    int* face_island_ids = extract_islands(mesh, topo, seam_edges, num_seams, &num_islands);
+    UnwrapStats stats;
+    memset(&stats, 0, sizeof(stats));
+
+    uvunwrap::Arena& arena = ctx->arena;
+    arena.reset();
+    uvunwrap::MemoryMeter meter;
+    meter.set_budget(params->memory_budget);
+    arena.set_meter(&meter);
 
-    // STEP 4: Parameterize each island using LSCM
-    Mesh* result = allocate_mesh_copy(mesh);
-    result->uvs = (float*)calloc(mesh->num_vertices * 2, sizeof(float));
+    LOG_INFO("=== UV Unwrapping ===");
+    LOG_INFO("Input: %d vertices, %d triangles",
+             mesh->num_vertices, mesh->num_triangles);
+    LOG_DEBUG("Parameters:");
+    LOG_DEBUG("  Angle threshold: %.1f°", params->angle_threshold);
+    LOG_DEBUG("  Min island faces: %d", params->min_island_faces);
+    LOG_DEBUG("  Pack islands: %s", params->pack_islands ? "yes" : "no");
+    LOG_DEBUG("  Island margin: %.3f", params->island_margin);
+    LOG_DEBUG("  Pack method: %d, rotation: %d", params->pack_method, params->pack_rotation);
+    if (params->udim_tiles > 0 || params->texel_density > 0.0f) {
+        LOG_DEBUG("  UDIM: %d tiles, %.1f texels per unit, %d texels per tile",
+                  params->udim_tiles, params->texel_density, params->udim_resolution);
+    }
+    LOG_DEBUG("  Seam method: %s", params->seam_method == SEAM_METHOD_MST         ? "mst"
+                                   : params->seam_method == SEAM_METHOD_COST      ? "cost"
+                                   : params->seam_method == SEAM_METHOD_CUT_GRAPH ? "cut"
+                                                                                   : "bfs");
+    if (params->max_chart_faces > 0 || params->max_chart_angle > 0.0f) {
+        LOG_DEBUG("  Charts: at most %d faces, %.1f° normal cone", params->max_chart_faces, params->max_chart_angle);
+    }
+    LOG_DEBUG("  Threads: %d", uvunwrap::resolve_thread_count(params->num_threads));
+    LOG_DEBUG("  Solver: %s", lscm_solver_name(params->solver));
 
-    for (int island_id = 0; island_id < num_islands; island_id++) {
-        printf("\nProcessing island %d/%d...\n", island_id + 1, num_islands);
+    // Steps 1-4 run as a task graph rather than stage by stage: the output
+    // copy overlaps topology and seams, every island's solve is queued the
+    // moment islands are known, and its UV write-back follows its own solve
+    // instead of the slowest one.
+    const long long CRITICAL = LLONG_MAX;
+    int num_workers = uvunwrap::resolve_thread_count(params->num_threads);
+    bool split_output = params->uv_output == UV_OUTPUT_SPLIT_VERTICES;
+    uvunwrap::TaskGraph graph;
+    graph.set_meter(&meter);
+    bool failed = false;
+    long long stage_ns = 0;
 
-        // Get faces in this island
-        std::vector<int> island_faces;
-        for (int f = 0; f < mesh->num_triangles; f++) {
-            if (face_island_ids[f] == island_id) {
-                island_faces.push_back(f);
+    // Existing UVs (e.g. a previous unwrap) warm-start iterative solves
+    LscmOptions lscm_options;
+    uvunwrap::lscm_options_from_params(params, mesh->uvs, &lscm_options);
+    if (params->progress || params->cancel || ctx->cancel) {
+        lscm_options.should_cancel = monitor_should_cancel;
+        lscm_options.cancel_user_data = &monitor;
+    }
+
+    // STEP 0: Flag degenerate faces, which every later stage leaves out.
+    // With a MeshView, steps 0-2 take its memoised analyses, and the
+    // topology it owns outlives this call.
+    unsigned char* own_face_flags =
+        view ? NULL : arena.alloc_array<unsigned char>(mesh->num_triangles > 0 ? mesh->num_triangles : 1);
+    const unsigned char* face_flags = own_face_flags;
+    int flags_task = graph.add([&](int) {
+        if (monitor.report(UNWRAP_STAGE_TOPOLOGY, 0.0f)) return;
+        UV_TRACE_ZONE("flag faces");
+        if (view) {
+            face_flags = mesh_view_face_flags(view, &stats.num_flagged_faces);
+            if (!face_flags) stats.num_flagged_faces = -1;
+        } else {
+            stats.num_flagged_faces = classify_faces(mesh, own_face_flags, params->num_threads);
+        }
+        if (stats.num_flagged_faces < 0) {
+            LOG_ERROR("Failed to classify faces");
+            failed = true;
+            return;
+        }
+        if (stats.num_flagged_faces > 0) {
+            LOG_WARNING("Mesh has %d degenerate faces; they are carried by their neighbours' charts",
+                        stats.num_flagged_faces);
+        }
+    }, CRITICAL);
+
+    Mesh* result = NULL;
+    int copy_task = -1;
+    if (!split_output) {
+        copy_task = graph.add([&](int) {
+            UV_TRACE_ZONE("copy mesh");
+            result = allocate_mesh_copy(mesh);
+            result->uvs = (float*)calloc(mesh->num_vertices * 2, sizeof(float));
+            meter.charge(mesh_bytes(result));
+        });
+    }
+
+    // STEP 1: Build topology (half-edges once; seams read both views)
+    uvunwrap::HalfEdgeMesh own_half_edges;
+    const uvunwrap::HalfEdgeMesh* he = &own_half_edges;
+    const TopologyInfo* topo = NULL;
+    TopologyInfo* own_topo = NULL;
+    long long topology_bytes = 0;
+    int topology_task = graph.add([&](int) {
+        if (failed || monitor.poll()) return;
+        UV_TRACE_ZONE("topology");
+        long long topology_start = uvunwrap::now_ns();
+        if (view) {
+            he = uvunwrap::mesh_view_half_edges(view);
+            topo = he ? mesh_view_topology(view) : NULL;
+        } else {
+            own_topo = uvunwrap::build_half_edge_mesh(mesh, &own_half_edges, params->num_threads, face_flags,
+                                                      params->sort_policy)
+                           ? uvunwrap::topology_from_half_edges(own_half_edges, params->num_threads)
+                           : NULL;
+            topo = own_topo;
+        }
+        if (!topo) {
+            LOG_ERROR("Failed to build topology");
+            failed = true;
+            return;
+        }
+
+        // Non-manifold input still unwraps (extra faces on an edge are
+        // cut off by it), but say so rather than let it pass silently
+        if (view) {
+            const ManifoldReport* defects = mesh_view_defects(view);
+            stats.num_nonmanifold_vertices = defects->num_nonmanifold_vertices;
+            stats.num_nonmanifold_edges = defects->num_nonmanifold_edges;
+        } else {
+            validate_topology(mesh, topo);
+            std::vector<int> corner_fan, fan_vertex;
+            uvunwrap::label_vertex_fans(own_half_edges, corner_fan, fan_vertex, &stats.num_nonmanifold_vertices);
+            stats.num_nonmanifold_edges = own_half_edges.num_nonmanifold_edges;
+        }
+        if (stats.num_nonmanifold_vertices > 0) {
+            LOG_WARNING("Mesh has %d non-manifold vertices; repair_nonmanifold() splits them",
+                        stats.num_nonmanifold_vertices);
+        }
+        stats.topology_ns = uvunwrap::now_ns() - topology_start;
+        topology_bytes = view ? 0
+                              : uvunwrap::vector_bytes(he->twin) + uvunwrap::vector_bytes(he->edge) +
+                                    uvunwrap::vector_bytes(he->edge_half_edges) + (long long)topo->num_edges * 16;
+        meter.charge(topology_bytes);
+        stats.stage_peak_bytes[UNWRAP_STAGE_TOPOLOGY] = meter.end_stage();
+        stats.stage_end_bytes[UNWRAP_STAGE_TOPOLOGY] = meter.current();
+    }, CRITICAL);
+    graph.precede(flags_task, topology_task);
+
+    // Per-face geometry, computed once beside the topology: the frames
+    // every LSCM solve assembles from (ABF++ lays out its own), and the
+    // normals when MST seams or the chart split read them, and the corner
+    // angles the cost-model and cut-graph seams measure curvature with
+    uvunwrap::TriangleGeometry geometry;
+    int geometry_parts = params->lscm_method != LSCM_METHOD_ABF ? uvunwrap::GEOMETRY_FRAMES : 0;
+    bool own_seams = !params->seam_edges && !view;
+    if (params->seam_method == SEAM_METHOD_COST && own_seams) {
+        geometry_parts |= uvunwrap::GEOMETRY_NORMALS | uvunwrap::GEOMETRY_ANGLES;
+    }
+    if (params->seam_method == SEAM_METHOD_CUT_GRAPH && own_seams) geometry_parts |= uvunwrap::GEOMETRY_ANGLES;
+    if ((params->seam_method == SEAM_METHOD_MST && own_seams) || params->max_chart_faces > 0 ||
+        (params->max_chart_angle > 0.0f && params->max_chart_angle < 180.0f)) {
+        geometry_parts |= uvunwrap::GEOMETRY_NORMALS;
+    }
+    int geometry_task = graph.add([&](int) {
+        if (failed || geometry_parts == 0 || monitor.poll()) return;
+        uvunwrap::build_triangle_geometry(mesh, geometry_parts, params->num_threads, &geometry);
+        meter.charge(geometry.bytes());
+    }, CRITICAL);
+
+    // STEP 2: Detect seams
+    int num_seams = 0;
+    const int* seam_edges = NULL;
+    int* own_seam_edges = NULL;
+    int seams_task = graph.add([&](int) {
+        if (failed || monitor.report(UNWRAP_STAGE_SEAMS, PROGRESS_SEAMS)) return;
+        UV_TRACE_ZONE("seams");
+        long long seams_start = uvunwrap::now_ns();
+        if (params->seam_edges) {
+            // User seams: resolve the pairs and cut exactly there
+            int num_pairs = params->num_seam_edges > 0 ? params->num_seam_edges : 0;
+            own_seam_edges = (int*)malloc((size_t)(num_pairs > 0 ? num_pairs : 1) * sizeof(int));
+            num_seams = find_topology_edges(topo, params->seam_edges, num_pairs, own_seam_edges);
+            if (num_seams < 0) {
+                free(own_seam_edges);
+                own_seam_edges = NULL;
+            } else {
+                if (num_seams < num_pairs) {
+                    LOG_WARNING("%d of %d user seams are not edges of the mesh", num_pairs - num_seams, num_pairs);
+                }
+                int k = 0;
+                for (int i = 0; i < num_pairs; i++) {
+                    if (own_seam_edges[i] >= 0) own_seam_edges[k++] = own_seam_edges[i];
+                }
             }
+            seam_edges = own_seam_edges;
+        } else if (view) {
+            seam_edges = mesh_view_seams(view, params->angle_threshold, (SeamMethod)params->seam_method, &num_seams);
+        } else {
+            own_seam_edges = uvunwrap::detect_seams_half_edge(mesh, topo, *he, params->angle_threshold,
+                                                              params->seam_method, &num_seams, face_flags,
+                                                              params->sort_policy, params->num_threads, &geometry);
+            seam_edges = own_seam_edges;
+        }
+        if (!seam_edges) {
+            LOG_ERROR("Failed to detect seams");
+            failed = true;
+            return;
         }
+        stats.seams_ns = uvunwrap::now_ns() - seams_start;
+        if (own_seam_edges) meter.charge((long long)num_seams * (long long)sizeof(int));
+        stats.stage_peak_bytes[UNWRAP_STAGE_SEAMS] = meter.end_stage();
+        stats.stage_end_bytes[UNWRAP_STAGE_SEAMS] = meter.current();
+    }, CRITICAL);
+    graph.precede(topology_task, seams_task);
+    graph.precede(geometry_task, seams_task);
 
-        printf("  %d faces in island\n", (int)island_faces.size());
-
-        if (island_faces.size() < params->min_island_faces) {
-            printf("  Skipping (too small)\n");
-            continue;
-        }
-
-        // Build face indices array
-        int* face_indices_array = (int*)malloc(island_faces.size() * sizeof(int));
-        for(size_t i=0; i<island_faces.size(); i++) face_indices_array[i] = island_faces[i];
-        
-        // Call LSCM
-        float* island_uvs = lscm_parameterize(mesh, face_indices_array, island_faces.size());
-        
-        if (island_uvs) {
-            // Build global_to_local for copying
-            std::map<int, int> island_global_to_local;
-            for(size_t i=0; i<island_faces.size(); i++) {
-                int f = island_faces[i];
-                for(int j=0; j<3; j++) {
-                    int v = mesh->triangles[f*3+j];
-                    if(island_global_to_local.find(v) == island_global_to_local.end()) {
-                        int count = island_global_to_local.size();
-                        island_global_to_local[v] = count;
-                    }
+    // STEP 3: Extract islands (CSR lists live in the arena), then cut
+    // oversized ones into charts so no single solve dominates
+    IslandInfo island_info;
+    memset(&island_info, 0, sizeof(island_info));
+    IslandInfo* islands = &island_info;
+    int num_islands = 0;
+    int num_solves = 0;
+    int* solve_order = NULL;
+    const int** solve_faces = NULL;
+    int* num_solve_faces = NULL;
+    long long* island_estimates = NULL;
+    float** island_uvs = NULL;
+    int** island_vertices = NULL;
+    int* island_num_verts = NULL;
+    LscmReport* island_reports = NULL;
+    int* instance_of = NULL;
+    int* island_tasks = NULL;
+    int* vertex_remaps = NULL;
+    uvunwrap::IslandMeshes island_meshes;
+    long long island_mesh_bytes = 0;
+    std::vector<SolveScratch> solve_scratch(num_workers);
+    std::vector<int> worker_remap(num_workers, -1);
+    std::atomic<int> next_remap(0);
+    int* split_offsets = NULL;
+    int* vertex_remap = NULL;
+    std::atomic<int> num_cached_islands(0);
+    int islands_task = graph.add([&](int) {
+        if (failed || monitor.report(UNWRAP_STAGE_ISLANDS, PROGRESS_ISLANDS)) return;
+        UV_TRACE_ZONE_BEGIN(islands_zone, "islands");
+        long long islands_start = uvunwrap::now_ns();
+        extract_islands_into(mesh, topo, seam_edges, num_seams, arena, true, islands);
+        uvunwrap::split_islands_into_charts(mesh, *he, params->max_chart_faces, params->max_chart_angle,
+                                            params->num_threads, arena, true, islands, &geometry);
+        num_islands = islands->num_islands;
+        stats.islands_ns = uvunwrap::now_ns() - islands_start;
+        meter.charge((long long)mesh->num_triangles * (long long)sizeof(int));
+        stats.stage_peak_bytes[UNWRAP_STAGE_ISLANDS] = meter.end_stage();
+        stats.stage_end_bytes[UNWRAP_STAGE_ISLANDS] = meter.current();
+        UV_TRACE_ZONE_END(islands_zone);
+
+        // Split output gets its per-island ranges now, so each island is
+        // written straight into the result as soon as it is done
+        if (split_output) {
+            UV_TRACE_ZONE("split layout");
+            result = allocate_split_mesh(mesh, islands, params->num_threads, arena, &split_offsets, &vertex_remap);
+            meter.charge(mesh_bytes(result) + (long long)result->num_vertices * (long long)sizeof(int));
+        }
+
+        // STEP 4: Parameterize each island using LSCM
+        stage_ns = uvunwrap::now_ns();
+
+        // Largest islands first so the big solves start early. Islands
+        // with degenerate faces are solved on a copy of their face list
+        // without them; an island of nothing else is skipped like a small one.
+        solve_order = arena.alloc_array<int>(num_islands);
+        solve_faces = arena.alloc_array<const int*>(num_islands);
+        num_solve_faces = arena.alloc_array<int>(num_islands);
+        for (int island_id = 0; island_id < num_islands; island_id++) {
+            const int* faces = &islands->island_faces[islands->island_face_offsets[island_id]];
+            int count = islands->island_face_offsets[island_id + 1] - islands->island_face_offsets[island_id];
+            if (count > stats.peak_island_faces) stats.peak_island_faces = count;
+            solve_faces[island_id] = faces;
+            num_solve_faces[island_id] = count;
+            if (count < params->min_island_faces) {
+                LOG_DEBUG("  Island %d: %d faces, skipping (too small)", island_id, count);
+                continue;
+            }
+            int usable = 0;
+            for (int i = 0; i < count; i++) usable += face_flags[faces[i]] ? 0 : 1;
+            if (usable < count) {
+                int* kept = arena.alloc_array<int>(usable > 0 ? usable : 1);
+                int k = 0;
+                for (int i = 0; i < count; i++) {
+                    if (!face_flags[faces[i]]) kept[k++] = faces[i];
                 }
+                solve_faces[island_id] = kept;
+                num_solve_faces[island_id] = usable;
+            }
+            if (usable == 0) {
+                LOG_DEBUG("  Island %d: only degenerate faces, skipping", island_id);
+                continue;
+            }
+            solve_order[num_solves++] = island_id;
+        }
+        std::sort(solve_order, solve_order + num_solves, [&](int a, int b) {
+            int ca = islands->island_face_offsets[a + 1] - islands->island_face_offsets[a];
+            int cb = islands->island_face_offsets[b + 1] - islands->island_face_offsets[b];
+            if (ca != cb) return ca > cb;
+            return a < b;
+        });
+
+        // Copies of an island take its UVs instead of a solve; islands with
+        // degenerate faces keep theirs, since those faces are left out
+        instance_of = arena.alloc_array<int>(num_islands > 0 ? num_islands : 1);
+        for (int island_id = 0; island_id < num_islands; island_id++) instance_of[island_id] = -1;
+        if (params->island_instancing != ISLAND_INSTANCING_NONE && !params->pinned_vertices) {
+            UV_TRACE_ZONE("island instances");
+            int* candidates = arena.alloc_array<int>(num_solves > 0 ? num_solves : 1);
+            int num_candidates = 0;
+            for (int k = 0; k < num_solves; k++) {
+                int island_id = solve_order[k];
+                int count = islands->island_face_offsets[island_id + 1] - islands->island_face_offsets[island_id];
+                if (num_solve_faces[island_id] == count) candidates[num_candidates++] = island_id;
             }
-            
-            copy_island_uvs(result, island_uvs, face_indices_array, island_faces.size(), island_global_to_local);
-            
-            free(island_uvs);
+            stats.num_instance_islands = uvunwrap::find_island_instances(mesh, candidates, num_candidates,
+                                                                         solve_faces, num_solve_faces, instance_of);
+            int num_representatives = 0;
+            for (int k = 0; k < num_solves; k++) {
+                if (instance_of[solve_order[k]] < 0) solve_order[num_representatives++] = solve_order[k];
+            }
+            num_solves = num_representatives;
+            LOG_DEBUG("  %d islands reuse the UVs of a copy", stats.num_instance_islands);
+        }
+        monitor.num_islands = num_solves;
+        for (int k = 0; k < num_solves; k++) monitor.total_faces += num_solve_faces[solve_order[k]];
+        if (monitor.report(UNWRAP_STAGE_SOLVE, PROGRESS_SOLVE)) return;
+
+        // Bytes each solve reserves until its real size is known. Under a
+        // memory budget they decide admission, so they come from the
+        // symbolic factorisation of the island (a few percent of its solve)
+        island_estimates = arena.alloc_array<long long>(num_islands);
+        if (params->memory_budget > 0 && !solver) {
+            UV_TRACE_ZONE("estimate island memory");
+            uvunwrap::parallel_for_dynamic(num_solves, params->num_threads, [&](int, int k) {
+                int island_id = solve_order[k];
+                island_estimates[island_id] = lscm_estimate_peak_bytes(mesh, solve_faces[island_id],
+                                                                       num_solve_faces[island_id], &lscm_options);
+            });
         } else {
-            fprintf(stderr, "  LSCM failed for island %d\n", island_id);
+            for (int k = 0; k < num_solves; k++) {
+                island_estimates[solve_order[k]] = estimate_island_bytes(num_solve_faces[solve_order[k]]);
+            }
+        }
+
+        // Every island to solve as a compact submesh, built once and read
+        // by its solve here or on a cluster worker
+        int* mesh_faces = arena.alloc_array<int>(num_islands > 0 ? num_islands : 1);
+        for (int island_id = 0; island_id < num_islands; island_id++) mesh_faces[island_id] = 0;
+        for (int k = 0; k < num_solves; k++) mesh_faces[solve_order[k]] = num_solve_faces[solve_order[k]];
+        {
+            UV_TRACE_ZONE("island meshes");
+            island_meshes.build(mesh, num_islands, solve_faces, mesh_faces, params->num_threads);
+        }
+        island_mesh_bytes = island_meshes.bytes();
+        meter.charge(island_mesh_bytes);
+
+        // Each solve writes only its own arena buffer, sized for the worst
+        // case of 3 distinct vertices per face
+        island_uvs = arena.alloc_array<float*>(num_islands);
+        island_vertices = arena.alloc_array<int*>(num_islands);
+        island_num_verts = arena.alloc_array<int>(num_islands);
+        island_reports = arena.alloc_array<LscmReport>(num_islands);
+        island_tasks = arena.alloc_array<int>(num_islands);
+        // Owned by the result, like face_island_ids
+        stats.island_solve_ns = (long long*)calloc(num_islands > 0 ? num_islands : 1, sizeof(long long));
+        stats.island_peak_bytes = (long long*)calloc(num_islands > 0 ? num_islands : 1, sizeof(long long));
+        for (int island_id = 0; island_id < num_islands; island_id++) {
+            island_uvs[island_id] = NULL;
+            island_vertices[island_id] = NULL;
+            island_num_verts[island_id] = -1;
+            memset(&island_reports[island_id], 0, sizeof(LscmReport));
+        }
+        for (int island_id = 0; island_id < num_islands; island_id++) {
+            if (mesh_faces[island_id] == 0 && instance_of[island_id] < 0) continue;
+            int count = islands->island_face_offsets[island_id + 1] - islands->island_face_offsets[island_id];
+            island_uvs[island_id] = arena.alloc_array<float>((size_t)count * 6);
+            island_vertices[island_id] = arena.alloc_array<int>((size_t)count * 3);
+        }
+
+        // One dense global->local remap per worker that solves, reused
+        // across its islands and cleared by that worker on first use
+        int num_remaps = num_workers < num_solves ? num_workers : num_solves;
+        vertex_remaps = arena.alloc_array<int>((size_t)(num_remaps > 0 ? num_remaps : 1) * mesh->num_vertices);
+
+        // A solver elsewhere takes every island in one task; degenerate
+        // corners are attached here, where the whole mesh is
+        int remote_task = -1;
+        if (solver) {
+            remote_task = graph.add([&](int) {
+                if (monitor.poll()) return;
+                UV_TRACE_ZONE("remote island solves");
+                IslandSolveBatch batch;
+                batch.count = num_solves;
+                batch.order = solve_order;
+                batch.faces = solve_faces;
+                batch.num_faces = num_solve_faces;
+                batch.uvs = island_uvs;
+                batch.vertices = island_vertices;
+                batch.num_verts = island_num_verts;
+                batch.reports = island_reports;
+                batch.solve_ns = stats.island_solve_ns;
+                batch.meshes = &island_meshes;
+                solver->solve(mesh, params, &lscm_options, batch,
+                              [&](int island_id) { return monitor.island_done(num_solve_faces[island_id]); });
+                int* remap = vertex_remaps;
+                for (int v = 0; v < mesh->num_vertices; v++) remap[v] = -1;
+                for (int k = 0; k < num_solves; k++) {
+                    int island_id = solve_order[k];
+                    int count = islands->island_face_offsets[island_id + 1] - islands->island_face_offsets[island_id];
+                    stats.island_peak_bytes[island_id] = island_reports[island_id].peak_bytes;
+                    if (island_num_verts[island_id] <= 0 || num_solve_faces[island_id] == count) continue;
+                    island_num_verts[island_id] = attach_degenerate_corners(
+                        mesh, &islands->island_faces[islands->island_face_offsets[island_id]], count, face_flags,
+                        remap, island_uvs[island_id], island_vertices[island_id], island_num_verts[island_id]);
+                }
+            }, CRITICAL);
+        }
+
+        // Solves are prioritised by size, as the order above, and admitted
+        // by the graph under the budget: while a large island waits for
+        // memory, smaller ones that fit run instead. Write-backs
+        // are chained in island order: with shared vertices islands can
+        // overlap, so "last island wins" stays deterministic. Split output
+        // gives every island its own range, so those writes are unordered.
+        auto write_split = [&](int worker, int island_id) {
+            std::vector<int>& copies = solve_scratch[worker].copies;
+            if (copies.empty()) copies.assign((size_t)mesh->num_vertices, -1);
+            write_split_island(mesh, islands, island_id, split_offsets, copies.data(), island_uvs[island_id],
+                               island_vertices[island_id], island_num_verts[island_id], result, vertex_remap);
+        };
+        int previous_write = -1;
+        for (int island_id = 0; island_id < num_islands; island_id++) {
+            int num_island_faces = islands->island_face_offsets[island_id + 1] -
+                                   islands->island_face_offsets[island_id];
+            if (num_island_faces < params->min_island_faces || num_solve_faces[island_id] == 0) {
+                if (split_output) {
+                    graph.add([&, island_id, write_split](int worker) {
+                        UV_TRACE_ZONE("split write");
+                        write_split(worker, island_id);
+                    }, CRITICAL);
+                }
+                continue;
+            }
+            long long estimate = island_estimates[island_id];
+            int solve_task = remote_task;
+            int representative = instance_of[island_id];
+            if (representative >= 0) {
+                // The representative has a lower id, so its task exists
+                solve_task = graph.add([&, island_id, representative](int) {
+                    if (island_num_verts[representative] < 0) return;
+                    UV_TRACE_ZONE("instance uvs");
+                    island_num_verts[island_id] = uvunwrap::copy_instance_uvs(
+                        mesh, solve_faces[representative], solve_faces[island_id], num_solve_faces[island_id],
+                        island_uvs[representative], island_vertices[representative],
+                        island_num_verts[representative], island_uvs[island_id], island_vertices[island_id]);
+                }, CRITICAL);
+                graph.precede(island_tasks[representative], solve_task);
+            } else if (!solver) {
+                solve_task = graph.add([&, island_id, num_island_faces, estimate](int worker) {
+                    if (monitor.poll()) {
+                        meter.unreserve(estimate);
+                        return;
+                    }
+                    if (worker_remap[worker] < 0) {
+                        worker_remap[worker] = next_remap.fetch_add(1, std::memory_order_relaxed);
+                        int* remap = &vertex_remaps[(size_t)worker_remap[worker] * mesh->num_vertices];
+                        for (int v = 0; v < mesh->num_vertices; v++) remap[v] = -1;
+                    }
+                    int* remap = &vertex_remaps[(size_t)worker_remap[worker] * mesh->num_vertices];
+                    const int* island_faces = &islands->island_faces[islands->island_face_offsets[island_id]];
+                    LOG_DEBUG("Processing island %d/%d (%d faces)...", island_id + 1, num_islands, num_island_faces);
+                    UV_TRACE_ZONE("island solve");
+                    long long island_start = uvunwrap::now_ns();
+                    // An island with most of the faces leaves the other
+                    // workers idle: they assemble it with this one
+                    LscmOptions island_options = lscm_options;
+                    if (2LL * num_solve_faces[island_id] > monitor.total_faces) {
+                        island_options.num_threads = num_workers;
+                    }
+                    int cached = 0;
+                    int num_verts = solve_island_mesh(mesh, island_meshes, island_id, &island_options, remap,
+                                                      solve_scratch[worker], &island_reports[island_id],
+                                                      island_uvs[island_id], island_vertices[island_id], &geometry,
+                                                      solve_faces[island_id], &cached);
+                    if (cached) num_cached_islands.fetch_add(1, std::memory_order_relaxed);
+                    if (num_verts > 0 && num_solve_faces[island_id] < num_island_faces) {
+                        num_verts = attach_degenerate_corners(mesh, island_faces, num_island_faces, face_flags, remap,
+                                                              island_uvs[island_id], island_vertices[island_id],
+                                                              num_verts);
+                    }
+                    island_num_verts[island_id] = num_verts;
+                    stats.island_solve_ns[island_id] = uvunwrap::now_ns() - island_start;
+                    long long used = island_reports[island_id].peak_bytes;
+                    stats.island_peak_bytes[island_id] = used;
+                    meter.adjust(estimate, used);
+                    meter.unreserve(used);
+                    monitor.island_done(num_solve_faces[island_id]);
+                }, num_island_faces, estimate);
+                // Near the submesh the island's first-touch build placed
+                graph.set_node(solve_task, island_meshes.node(island_id));
+            }
+            island_tasks[island_id] = solve_task;
+            if (split_output) {
+                int split_task = graph.add([&, island_id, write_split](int worker) {
+                    if (monitor.poll()) return;
+                    UV_TRACE_ZONE("split write");
+                    write_split(worker, island_id);
+                }, CRITICAL);
+                graph.precede(solve_task, split_task);
+                continue;
+            }
+
+            int write_task = graph.add([&, island_id](int) {
+                if (island_num_verts[island_id] < 0) return;
+                UV_TRACE_ZONE("uv write-back");
+                copy_island_uvs(result, island_uvs[island_id], island_vertices[island_id],
+                                island_num_verts[island_id]);
+            }, CRITICAL);
+            graph.precede(solve_task, write_task);
+            graph.precede(copy_task, write_task);
+            if (previous_write >= 0) graph.precede(previous_write, write_task);
+            previous_write = write_task;
         }
-        
-        free(face_indices_array);
+    }, CRITICAL);
+    graph.precede(seams_task, islands_task);
+
+    graph.run(num_workers);
+    meter.release(island_mesh_bytes);
+    meter.release(geometry.bytes());
+    island_meshes = uvunwrap::IslandMeshes();
+    geometry = uvunwrap::TriangleGeometry();
+    solve_scratch.clear();
+
+    // A failed or cancelled call frees everything it allocated so far
+    auto abandon = [&]() -> Mesh* {
+        free_topology(own_topo);
+        free(own_seam_edges);
+        free_mesh(result);
+        free(vertex_remap);
+        free(islands->face_island_ids);
+        free(stats.island_solve_ns);
+        free(stats.island_peak_bytes);
+        arena.reset();
+        arena.set_meter(NULL);
+        if (!failed) LOG_INFO("unwrap_mesh: cancelled");
+        return NULL;
+    };
+    if (failed || monitor.poll()) return abandon();
+
+    for (int k = 0; k < num_solves; k++) {
+        if (island_num_verts[solve_order[k]] < 0) LOG_ERROR("  LSCM failed for island %d", solve_order[k]);
     }
 
-    // STEP 5: Pack islands if requested
-    if (params->pack_islands) {
-        UnwrapResult temp_result;
-        temp_result.num_islands = num_islands;
-        temp_result.face_island_ids = face_island_ids;
+    stats.lscm_ns = uvunwrap::now_ns() - stage_ns;
+    stats.num_memory_waits = graph.num_deferred();
+    stats.num_cached_islands = num_cached_islands.load();
+    stats.stage_peak_bytes[UNWRAP_STAGE_SOLVE] = meter.end_stage();
+    stats.stage_end_bytes[UNWRAP_STAGE_SOLVE] = meter.current();
 
-        pack_uv_islands(result, &temp_result, params->island_margin);
+    // STEP 5: Pack islands if requested
+    if (monitor.report(UNWRAP_STAGE_PACKING, PROGRESS_PACKING)) return abandon();
+    stage_ns = uvunwrap::now_ns();
+    UV_TRACE_ZONE_BEGIN(pack_zone, "pack");
+    UnwrapResult temp_result;
+    temp_result.num_islands = num_islands;
+    temp_result.face_island_ids = islands->face_island_ids;
+    temp_result.coverage = 0.0f;
+    if (params->island_instancing == ISLAND_INSTANCING_STACK && stats.num_instance_islands > 0) {
+        // Each instance packs as part of its representative's island,
+        // which its UVs cover exactly
+        int* pack_ids = arena.alloc_array<int>(num_islands);
+        int num_packed = 0;
+        for (int island_id = 0; island_id < num_islands; island_id++) {
+            pack_ids[island_id] = instance_of[island_id] < 0 ? num_packed++ : -1;
+        }
+        for (int island_id = 0; island_id < num_islands; island_id++) {
+            if (instance_of[island_id] >= 0) pack_ids[island_id] = pack_ids[instance_of[island_id]];
+        }
+        int* face_pack_ids = arena.alloc_array<int>(mesh->num_triangles > 0 ? mesh->num_triangles : 1);
+        for (int f = 0; f < mesh->num_triangles; f++) {
+            int island_id = islands->face_island_ids[f];
+            face_pack_ids[f] = island_id < 0 ? island_id : pack_ids[island_id];
+        }
+        temp_result.num_islands = num_packed;
+        temp_result.face_island_ids = face_pack_ids;
     }
+    int num_tiles = uvunwrap::pack_with_params(result, &temp_result, params);
+    stats.packing_ns = uvunwrap::now_ns() - stage_ns;
+    stats.stage_peak_bytes[UNWRAP_STAGE_PACKING] = meter.end_stage();
+    stats.stage_end_bytes[UNWRAP_STAGE_PACKING] = meter.current();
+    UV_TRACE_ZONE_END(pack_zone);
 
     // STEP 6: Compute quality metrics
+    if (monitor.report(UNWRAP_STAGE_METRICS, PROGRESS_METRICS)) return abandon();
+    stage_ns = uvunwrap::now_ns();
+    UV_TRACE_ZONE_BEGIN(metrics_zone, "metrics");
     UnwrapResult* result_data = (UnwrapResult*)malloc(sizeof(UnwrapResult));
     result_data->num_islands = num_islands;
-    result_data->face_island_ids = face_island_ids;
-    compute_quality_metrics(result, result_data);
+    result_data->face_island_ids = islands->face_island_ids;
+    result_data->vertex_remap = vertex_remap;
+    compute_quality_metrics_with_histograms(result, result_data, NULL, params->metrics_histograms,
+                                            params->num_threads, params->compute_backend);
+    result_data->num_tiles = num_tiles;
+    stats.metrics_ns = uvunwrap::now_ns() - stage_ns;
+    stats.stage_peak_bytes[UNWRAP_STAGE_METRICS] = meter.end_stage();
+    stats.stage_end_bytes[UNWRAP_STAGE_METRICS] = meter.current();
+    UV_TRACE_ZONE_END(metrics_zone);
+
+    result_data->solver_iterations = 0;
+    result_data->solver_residual = 0.0f;
+    for (int k = 0; k < num_solves; k++) {
+        const LscmReport& report = island_reports[solve_order[k]];
+        if (report.iterations > result_data->solver_iterations) {
+            result_data->solver_iterations = report.iterations;
+        }
+        if ((float)report.residual > result_data->solver_residual) {
+            result_data->solver_residual = (float)report.residual;
+        }
+        if (island_num_verts[solve_order[k]] < 0) continue;
+        stats.num_solved_islands++;
+        if (report.fallback != LSCM_FALLBACK_NONE) stats.num_fallback_islands++;
+        if (report.dense) stats.num_dense_islands++;
+        if (report.closed_form != LSCM_CLOSED_FORM_NONE) stats.num_closed_form_islands++;
+        stats.lscm_assembly_ns += report.assembly_ns;
+        stats.lscm_factor_ns += report.factor_ns;
+        stats.lscm_solve_ns += report.solve_ns;
+        stats.matrix_nonzeros += report.matrix_nonzeros;
+        stats.factor_nonzeros += report.factor_nonzeros;
+        stats.solver_iterations += report.iterations;
+        if (island_num_verts[solve_order[k]] > stats.peak_island_vertices) {
+            stats.peak_island_vertices = island_num_verts[solve_order[k]];
+        }
+    }
+    stats.scratch_bytes = (long long)arena.capacity();
+
+    // The result now owns face_island_ids; the rest is arena scratch
+    islands->face_island_ids = NULL;
 
     *result_out = result_data;
 
     // Cleanup
-    free_topology(topo);
-    free(seam_edges);
+    free_topology(own_topo);
+    free(own_seam_edges);
+    // Merge now rather than on the next call, so a warm context starts
+    // from a single block big enough for this mesh
+    arena.reset();
+    stats.peak_bytes = meter.peak();
+    arena.set_meter(NULL);
+
+    {
+        UV_TRACE_ZONE("output order");
+        result = uvunwrap::apply_output_order(result, result_data, params);
+    }
+
+    stats.total_ns = uvunwrap::now_ns() - start_ns;
+    result_data->stats = stats;
+    uvunwrap::result_cache_store(cache_key, result, result_data);
 
-    printf("\n=== Unwrapping Complete ===\n");
+    LOG_INFO("=== Unwrapping Complete ===");
+    monitor.report(UNWRAP_STAGE_DONE, 1.0f);
 
     return result;
 }
@@ -266,5 +1271,9 @@ void free_unwrap_result(UnwrapResult* result) {
     if (result->face_island_ids) {
         free(result->face_island_ids);
     }
+    free(result->stats.island_solve_ns);
+    free(result->stats.island_peak_bytes);
+    free(result->vertex_remap);
+    free(result->face_remap);
     free(result);
 }
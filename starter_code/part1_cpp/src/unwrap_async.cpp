@@ -0,0 +1,244 @@
+/**
+ * @file unwrap_async.cpp
+ * @brief Worker pool behind unwrap_mesh_async()
+ *
+ * Tasks are reference counted: one reference for the caller's handle and
+ * one for the pool, dropped once the task completes. Workers take tasks
+ * from one unbounded queue; cancellation only raises the task's flag,
+ * which a queued task sees when a worker takes it and a running one
+ * through its context (UnwrapContext::cancel), polled alongside
+ * params->cancel. Once the pool has shut down at exit, new tasks complete
+ * as cancelled without being queued.
+ */
+
+#include "unwrap_async.h"
+#include "unwrap_context.h"
+#include "blocking_queue.h"
+#include "parallel.h"
+#include "logging.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct UnwrapTask {
+    UnwrapContext* ctx;          // caller's, or NULL for the worker's own
+    const Mesh* mesh;
+    UnwrapParams params;
+    UnwrapDoneCallback on_done;
+    void* user_data;
+    volatile int cancel;
+    std::atomic<int> refs;
+
+    mutable std::mutex mutex;
+    std::condition_variable finished;
+    int status;                  // UnwrapAsyncStatus, under mutex
+    Mesh* output;                // kept for unwrap_task_take() when there is no callback
+    UnwrapResult* result;
+};
+
+namespace {
+
+// Cores per worker of the default pool: requests run side by side, each
+// with a few island threads
+const int CORES_PER_WORKER = 4;
+
+void release_task(UnwrapTask* task) {
+    if (task->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+    free_mesh(task->output);
+    free_unwrap_result(task->result);
+    delete task;
+}
+
+/** Store the outcome, or hand it to the callback, and drop the pool's reference */
+void complete_task(UnwrapTask* task, int status, Mesh* output, UnwrapResult* result) {
+    if (task->on_done) {
+        task->on_done(task, status, output, result, task->user_data);
+        output = NULL;
+        result = NULL;
+    }
+    {
+        std::lock_guard<std::mutex> lock(task->mutex);
+        task->output = output;
+        task->result = result;
+        task->status = status;
+        task->finished.notify_all();
+    }
+    release_task(task);
+}
+
+/** The caller's progress callback; a nonzero answer raises the task's flag */
+int forward_progress(int stage, int islands_done, int num_islands, float fraction, void* user_data) {
+    UnwrapTask* task = (UnwrapTask*)user_data;
+    if (task->params.progress(stage, islands_done, num_islands, fraction, task->params.progress_user_data)) {
+        task->cancel = 1;
+    }
+    return task->cancel;
+}
+
+class AsyncPool {
+public:
+    explicit AsyncPool(int num_workers) : queue_(SIZE_MAX), island_threads_(1), closing_(false) {
+        int cores = uvunwrap::resolve_thread_count(0);
+        if (num_workers <= 0) num_workers = std::max(1, cores / CORES_PER_WORKER);
+        island_threads_ = std::max(1, cores / num_workers);
+        for (int w = 0; w < num_workers; w++) workers_.emplace_back([this]() { work(); });
+        LOG_INFO("unwrap async: %d workers, %d island threads each", num_workers, island_threads_);
+    }
+
+    /** Running tasks finish; tasks still queued complete as cancelled */
+    ~AsyncPool() {
+        closing_.store(true, std::memory_order_relaxed);
+        queue_.close();
+        for (size_t i = 0; i < workers_.size(); i++) workers_[i].join();
+    }
+
+    /** Queue a task; false once the pool is closing */
+    bool submit(UnwrapTask* task) {
+        if (closing_.load(std::memory_order_relaxed)) return false;
+        queue_.push(task);
+        return true;
+    }
+
+private:
+    void work() {
+        UnwrapContext own;
+        UnwrapTask* task;
+        while (queue_.pop(&task)) run(task, &own);
+    }
+
+    bool cancelled(const UnwrapTask* task) const {
+        return task->cancel || (task->params.cancel && *task->params.cancel) ||
+               closing_.load(std::memory_order_relaxed);
+    }
+
+    void run(UnwrapTask* task, UnwrapContext* own) {
+        Mesh* output = NULL;
+        UnwrapResult* result = NULL;
+        if (!cancelled(task)) {
+            UnwrapParams params = task->params;
+            if (params.num_threads <= 0) params.num_threads = island_threads_;
+            if (params.progress) {
+                params.progress = forward_progress;
+                params.progress_user_data = task;
+            }
+            UnwrapContext* ctx = task->ctx ? task->ctx : own;
+            ctx->cancel = &task->cancel;
+            output = unwrap_mesh_ctx(ctx, task->mesh, &params, &result);
+            ctx->cancel = NULL;
+        }
+        int status = output ? UNWRAP_ASYNC_OK : cancelled(task) ? UNWRAP_ASYNC_CANCELLED : UNWRAP_ASYNC_FAILED;
+        complete_task(task, status, output, result);
+    }
+
+    uvunwrap::BlockingQueue<UnwrapTask*> queue_;
+    std::vector<std::thread> workers_;
+    int island_threads_;
+    std::atomic<bool> closing_;
+};
+
+std::mutex g_pool_mutex;
+int g_num_workers = 0;
+AsyncPool* g_pool = NULL;
+bool g_shut_down = false;        // at exit; no pool is started after it
+
+/** Cancels what is still queued and joins the workers at exit */
+struct PoolShutdown {
+    ~PoolShutdown() {
+        AsyncPool* pool;
+        {
+            std::lock_guard<std::mutex> lock(g_pool_mutex);
+            pool = g_pool;
+            g_pool = NULL;
+            g_shut_down = true;
+        }
+        // Joined without the lock: a completion callback may queue another unwrap
+        delete pool;
+    }
+};
+
+/** Queue a task, starting the pool on first use; false after shutdown */
+bool submit(UnwrapTask* task) {
+    static PoolShutdown shutdown;
+    // Under the lock, so the pool cannot be swapped out and closed in between
+    std::lock_guard<std::mutex> lock(g_pool_mutex);
+    if (g_shut_down) return false;
+    if (!g_pool) g_pool = new AsyncPool(g_num_workers);
+    return g_pool->submit(task);
+}
+
+} // namespace
+
+int unwrap_async_configure(int num_workers) {
+    std::lock_guard<std::mutex> lock(g_pool_mutex);
+    if (g_pool) return -1;
+    g_num_workers = num_workers > 0 ? num_workers : 0;
+    return 0;
+}
+
+UnwrapTask* unwrap_mesh_async(UnwrapContext* ctx,
+                              const Mesh* mesh,
+                              const UnwrapParams* params,
+                              UnwrapDoneCallback on_done,
+                              void* user_data) {
+    if (!mesh) {
+        LOG_ERROR("unwrap_mesh_async: Invalid arguments");
+        return NULL;
+    }
+    UnwrapTask* task = new UnwrapTask();
+    task->ctx = ctx;
+    task->mesh = mesh;
+    if (params) {
+        task->params = *params;
+    } else {
+        unwrap_params_default(&task->params);
+    }
+    task->on_done = on_done;
+    task->user_data = user_data;
+    task->cancel = 0;
+    task->refs.store(2, std::memory_order_relaxed);
+    task->status = UNWRAP_ASYNC_PENDING;
+    task->output = NULL;
+    task->result = NULL;
+    if (!submit(task)) {
+        LOG_WARNING("unwrap_mesh_async: the pool has shut down; task cancelled");
+        complete_task(task, UNWRAP_ASYNC_CANCELLED, NULL, NULL);
+    }
+    return task;
+}
+
+void unwrap_task_cancel(UnwrapTask* task) {
+    if (task) task->cancel = 1;
+}
+
+int unwrap_task_status(const UnwrapTask* task) {
+    if (!task) return UNWRAP_ASYNC_FAILED;
+    std::lock_guard<std::mutex> lock(task->mutex);
+    return task->status;
+}
+
+int unwrap_task_wait(UnwrapTask* task) {
+    if (!task) return UNWRAP_ASYNC_FAILED;
+    std::unique_lock<std::mutex> lock(task->mutex);
+    task->finished.wait(lock, [&]() { return task->status != UNWRAP_ASYNC_PENDING; });
+    return task->status;
+}
+
+Mesh* unwrap_task_take(UnwrapTask* task, UnwrapResult** result_out) {
+    if (result_out) *result_out = NULL;
+    if (!task || !result_out) return NULL;
+    std::lock_guard<std::mutex> lock(task->mutex);
+    Mesh* output = task->output;
+    *result_out = task->result;
+    task->output = NULL;
+    task->result = NULL;
+    return output;
+}
+
+void unwrap_task_release(UnwrapTask* task) {
+    if (task) release_task(task);
+}
@@ -0,0 +1,406 @@
+/**
+ * @file unwrap_batch.cpp
+ * @brief Batch unwrapping: reader → compute workers → writer pipeline
+ */
+
+#include "unwrap_batch.h"
+#include "mesh_bin.h"
+#include "mesh_formats.h"
+#include "blocking_queue.h"
+#include "json.h"
+#include "mapped_file.h"
+#include "logging.h"
+#include "parallel.h"
+#include "numa.h"
+#include "timer.h"
+#include <stddef.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using uvunwrap::BlockingQueue;
+
+namespace {
+
+struct BatchJob {
+    int index;
+    Mesh* mesh;                  // OBJ input (free_mesh)
+    MeshBin* bin;                // mesh_bin input; its arrays back the mesh
+    Mesh* unwrapped;
+    UnwrapResult* result;
+    long long held_bytes;        // charged to the MeshBudget
+};
+
+/**
+ * Bytes of meshes held between the reader and the writer. The reader
+ * waits for room before parsing, so a budget caps the parsed-ahead and
+ * not-yet-written meshes together; one file always fits.
+ */
+class MeshBudget {
+public:
+    explicit MeshBudget(long long budget) : budget_(budget), held_(0) {}
+
+    void wait_for_room() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        room_.wait(lock, [&]() { return budget_ <= 0 || held_ == 0 || held_ < budget_; });
+    }
+
+    void charge(long long bytes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        held_ += bytes;
+    }
+
+    void release(long long bytes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        held_ -= bytes;
+        room_.notify_all();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable room_;
+    long long budget_;
+    long long held_;
+};
+
+long long mesh_bytes(const Mesh* mesh) {
+    if (!mesh) return 0;
+    long long per_vertex = mesh->uvs ? 5 * sizeof(float) : 3 * sizeof(float);
+    return (long long)mesh->num_vertices * per_vertex + (long long)mesh->num_triangles * 3 * sizeof(int);
+}
+
+bool is_mesh_bin(const char* path) {
+    size_t len = strlen(path);
+    return len >= 5 && strcmp(path + len - 5, ".uvmb") == 0;
+}
+
+const Mesh* job_input(const BatchJob& job) {
+    return job.bin ? mesh_bin_mesh(job.bin) : job.mesh;
+}
+
+void release_input(BatchJob* job) {
+    free_mesh(job->mesh);
+    free_mesh_bin(job->bin);
+    job->mesh = NULL;
+    job->bin = NULL;
+}
+
+/** Keys of UnwrapBatchHistograms::stage_ns, by UnwrapStage */
+const char* const STAGE_KEYS[UNWRAP_STAGE_DONE] = {
+    "topology", "seams", "islands", "solve", "packing", "metrics"
+};
+
+/** The histograms of a set with their JSON keys, stages last */
+struct NamedHistogram {
+    const char* key;
+    size_t offset;
+};
+
+const NamedHistogram FILE_HISTOGRAMS[] = {
+    {"stretch", offsetof(UnwrapBatchHistograms, stretch)},
+    {"angle_distortion", offsetof(UnwrapBatchHistograms, angle_distortion)},
+    {"island_faces", offsetof(UnwrapBatchHistograms, island_faces)},
+    {"load_ns", offsetof(UnwrapBatchHistograms, load_ns)},
+    {"unwrap_ns", offsetof(UnwrapBatchHistograms, unwrap_ns)},
+    {"save_ns", offsetof(UnwrapBatchHistograms, save_ns)},
+};
+const int NUM_FILE_HISTOGRAMS = (int)(sizeof(FILE_HISTOGRAMS) / sizeof(FILE_HISTOGRAMS[0]));
+
+UvHistogram* histogram_at(UnwrapBatchHistograms* set, const NamedHistogram& named) {
+    return (UvHistogram*)((char*)set + named.offset);
+}
+
+const UvHistogram* histogram_at(const UnwrapBatchHistograms* set, const NamedHistogram& named) {
+    return (const UvHistogram*)((const char*)set + named.offset);
+}
+
+void append_histogram(std::string* out, const char* key, const UvHistogram* histogram) {
+    out->push_back('"');
+    out->append(key);
+    out->append("\":");
+    std::string text(uv_histogram_to_json(histogram, NULL, 0) + 1, '\0');
+    uv_histogram_to_json(histogram, &text[0], text.size());
+    text.resize(text.size() - 1);
+    out->append(text);
+}
+
+int read_histogram(const uvunwrap::JsonValue* value, UvHistogram* histogram) {
+    if (!value) return 0;
+    std::string text;
+    value->write(&text);
+    return uv_histogram_from_json(text.c_str(), histogram);
+}
+
+/** Per-file histograms of a written file (not for cache hits, whose stages were not timed) */
+void record_file(UnwrapBatchHistograms* h, const UnwrapBatchFileStats& s, const Mesh* unwrapped,
+                 const UnwrapResult* result) {
+    if (result->stats.cache_hit) return;
+    uv_histogram_record(&h->load_ns, (double)s.load_ns);
+    uv_histogram_record(&h->unwrap_ns, (double)s.unwrap_ns);
+    uv_histogram_record(&h->save_ns, (double)s.save_ns);
+    const UnwrapStats& st = result->stats;
+    long long stage_ns[UNWRAP_STAGE_DONE] = {
+        st.topology_ns, st.seams_ns, st.islands_ns, st.lscm_ns, st.packing_ns, st.metrics_ns
+    };
+    for (int k = 0; k < UNWRAP_STAGE_DONE; k++) uv_histogram_record(&h->stage_ns[k], (double)stage_ns[k]);
+
+    if (!result->face_island_ids || result->num_islands <= 0) return;
+    std::vector<int> island_faces((size_t)result->num_islands, 0);
+    for (int f = 0; f < unwrapped->num_triangles; f++) {
+        int island = result->face_island_ids[f];
+        if (island >= 0 && island < result->num_islands) island_faces[island]++;
+    }
+    for (int i = 0; i < result->num_islands; i++) uv_histogram_record(&h->island_faces, island_faces[i]);
+}
+
+} // namespace
+
+void unwrap_batch_histograms_clear(UnwrapBatchHistograms* histograms) {
+    if (histograms) memset(histograms, 0, sizeof(UnwrapBatchHistograms));
+}
+
+void unwrap_batch_histograms_merge(UnwrapBatchHistograms* dst, const UnwrapBatchHistograms* src) {
+    if (!dst || !src) return;
+    for (int i = 0; i < NUM_FILE_HISTOGRAMS; i++) {
+        uv_histogram_merge(histogram_at(dst, FILE_HISTOGRAMS[i]), histogram_at(src, FILE_HISTOGRAMS[i]));
+    }
+    for (int k = 0; k < UNWRAP_STAGE_DONE; k++) uv_histogram_merge(&dst->stage_ns[k], &src->stage_ns[k]);
+}
+
+size_t unwrap_batch_histograms_to_json(const UnwrapBatchHistograms* histograms, char* out, size_t size) {
+    std::vector<UnwrapBatchHistograms> empty;
+    if (!histograms) {
+        empty.resize(1);
+        unwrap_batch_histograms_clear(&empty[0]);
+        histograms = &empty[0];
+    }
+    std::string text = "{";
+    for (int i = 0; i < NUM_FILE_HISTOGRAMS; i++) {
+        append_histogram(&text, FILE_HISTOGRAMS[i].key, histogram_at(histograms, FILE_HISTOGRAMS[i]));
+        text.push_back(',');
+    }
+    text.append("\"stage_ns\":{");
+    for (int k = 0; k < UNWRAP_STAGE_DONE; k++) {
+        if (k > 0) text.push_back(',');
+        append_histogram(&text, STAGE_KEYS[k], &histograms->stage_ns[k]);
+    }
+    text.append("}}");
+
+    if (out && size > 0) {
+        size_t n = text.size() < size ? text.size() : size - 1;
+        memcpy(out, text.data(), n);
+        out[n] = '\0';
+    }
+    return text.size();
+}
+
+int unwrap_batch_histograms_from_json(const char* json, UnwrapBatchHistograms* histograms) {
+    if (!json || !histograms) return -1;
+    uvunwrap::JsonValue doc;
+    if (!uvunwrap::JsonValue::parse(json, strlen(json), &doc, NULL) || !doc.is_object()) return -1;
+
+    unwrap_batch_histograms_clear(histograms);
+    for (int i = 0; i < NUM_FILE_HISTOGRAMS; i++) {
+        if (read_histogram(doc.find(FILE_HISTOGRAMS[i].key), histogram_at(histograms, FILE_HISTOGRAMS[i])) != 0) {
+            return -1;
+        }
+    }
+    const uvunwrap::JsonValue* stages = doc.find("stage_ns");
+    if (stages && !stages->is_object()) return -1;
+    for (int k = 0; stages && k < UNWRAP_STAGE_DONE; k++) {
+        if (read_histogram(stages->find(STAGE_KEYS[k]), &histograms->stage_ns[k]) != 0) return -1;
+    }
+    return 0;
+}
+
+void unwrap_batch_options_default(UnwrapBatchOptions* options) {
+    if (!options) return;
+    memset(options, 0, sizeof(UnwrapBatchOptions));
+}
+
+int unwrap_batch(const char* const* inputs,
+                 const char* const* outputs,
+                 int n,
+                 const UnwrapParams* params,
+                 int num_threads,
+                 UnwrapBatchProgress progress,
+                 void* user_data,
+                 UnwrapBatchFileStats* stats_out) {
+    UnwrapBatchOptions options;
+    unwrap_batch_options_default(&options);
+    options.num_threads = num_threads;
+    options.progress = progress;
+    options.user_data = user_data;
+    return unwrap_batch_with_options(inputs, outputs, n, params, &options, stats_out);
+}
+
+int unwrap_batch_with_options(const char* const* inputs,
+                              const char* const* outputs,
+                              int n,
+                              const UnwrapParams* params,
+                              const UnwrapBatchOptions* options,
+                              UnwrapBatchFileStats* stats_out) {
+    if (n < 0 || (n > 0 && (!inputs || !outputs))) return -1;
+    if (n == 0) return 0;
+
+    UnwrapParams defaults;
+    if (!params) {
+        unwrap_params_default(&defaults);
+        params = &defaults;
+    }
+    UnwrapBatchOptions default_options;
+    if (!options) {
+        unwrap_batch_options_default(&default_options);
+        options = &default_options;
+    }
+    UnwrapBatchProgress progress = options->progress;
+    void* user_data = options->user_data;
+
+    int workers = std::min(uvunwrap::resolve_thread_count(options->num_threads), n);
+    int prefetch = options->prefetch > 0 ? options->prefetch : workers;
+    std::vector<UnwrapBatchFileStats> stats(n);
+    memset(stats.data(), 0, stats.size() * sizeof(UnwrapBatchFileStats));
+
+    // The reader may run `prefetch` meshes ahead of the workers, the
+    // workers `workers` ahead of the writer, both within the mesh budget
+    BlockingQueue<BatchJob> parsed(prefetch);
+    BlockingQueue<BatchJob> finished(workers);
+    MeshBudget budget(options->memory_budget);
+    std::atomic<int> started(0);
+    std::atomic<int> live_workers(workers);
+
+    LOG_INFO("=== Batch UV Unwrap: %d files, %d workers ===", n, workers);
+
+    std::thread reader([&]() {
+        for (int i = 0; i < n; i++) {
+            BatchJob job = {i, NULL, NULL, NULL, NULL, 0};
+            budget.wait_for_room();
+            if (i + 1 < n) uvunwrap::MappedFile::prefetch(inputs[i + 1]);
+            long long t0 = uvunwrap::now_ns();
+            if (is_mesh_bin(inputs[i])) {
+                job.bin = load_mesh_bin(inputs[i], 1);
+            } else {
+                job.mesh = load_mesh(inputs[i]);
+            }
+            stats[i].load_ns = uvunwrap::now_ns() - t0;
+
+            const Mesh* mesh = job.bin || job.mesh ? job_input(job) : NULL;
+            if (!mesh) {
+                LOG_ERROR("unwrap_batch: could not load %s", inputs[i]);
+                stats[i].status = UNWRAP_BATCH_LOAD_FAILED;
+                release_input(&job);
+                finished.push(job);
+                continue;
+            }
+            stats[i].num_vertices = mesh->num_vertices;
+            stats[i].num_triangles = mesh->num_triangles;
+            job.held_bytes = mesh_bytes(mesh);
+            budget.charge(job.held_bytes);
+            parsed.push(job);
+        }
+        parsed.close();
+    });
+
+    // Each worker records its faces into its own pair, merged in after the join
+    std::vector<UvHistogram> worker_stretch(options->histograms ? workers : 0);
+    std::vector<UvHistogram> worker_angle(options->histograms ? workers : 0);
+    for (size_t t = 0; t < worker_stretch.size(); t++) {
+        uv_histogram_clear(&worker_stretch[t]);
+        uv_histogram_clear(&worker_angle[t]);
+    }
+
+    // Spread files over the nodes; each file's island workers then stay on
+    // its compute worker's node, next to the buffers it fills
+    int nodes = options->numa != UNWRAP_NUMA_NONE ? uvunwrap::numa_node_count() : 1;
+
+    auto compute = [&](int worker) {
+        if (nodes > 1 && uvunwrap::numa_pin_thread(worker % nodes)) {
+            uvunwrap::NumaPlacement placement;
+            placement.policy = options->numa;
+            placement.node = worker % nodes;
+            uvunwrap::current_numa_placement() = placement;
+        }
+        UnwrapContext* ctx = unwrap_context_create();
+        MetricsHistograms face_histograms = {NULL, NULL};
+        if (options->histograms) {
+            face_histograms.stretch = &worker_stretch[worker];
+            face_histograms.angle_distortion = &worker_angle[worker];
+        }
+        BatchJob job;
+        while (parsed.pop(&job)) {
+            // Near the end of the batch, hand idle workers' cores to the island solve
+            UnwrapParams p = *params;
+            p.metrics_histograms = options->histograms ? &face_histograms : NULL;
+            int remaining = n - started.fetch_add(1);
+            if (p.num_threads <= 0 && remaining < workers) p.num_threads = workers / remaining;
+
+            long long t0 = uvunwrap::now_ns();
+            job.unwrapped = unwrap_mesh_ctx(ctx, job_input(job), &p, &job.result);
+            stats[job.index].unwrap_ns = uvunwrap::now_ns() - t0;
+            release_input(&job);
+            long long output_bytes = mesh_bytes(job.unwrapped);
+            budget.charge(output_bytes);
+            budget.release(job.held_bytes);
+            job.held_bytes = output_bytes;
+            finished.push(job);
+        }
+        unwrap_context_free(ctx);
+        if (live_workers.fetch_sub(1) == 1) finished.close();
+    };
+    std::vector<std::thread> pool;
+    pool.reserve(workers);
+    for (int t = 0; t < workers; t++) pool.emplace_back(compute, t);
+
+    // Writer stage on the calling thread
+    int done = 0;
+    int failed = 0;
+    BatchJob job;
+    while (finished.pop(&job)) {
+        UnwrapBatchFileStats& s = stats[job.index];
+        if (s.status == UNWRAP_BATCH_OK && !job.unwrapped) {
+            LOG_ERROR("unwrap_batch: unwrap failed for %s", inputs[job.index]);
+            s.status = UNWRAP_BATCH_UNWRAP_FAILED;
+        } else if (s.status == UNWRAP_BATCH_OK) {
+            const char* path = outputs[job.index];
+            long long t0 = uvunwrap::now_ns();
+            int rc = is_mesh_bin(path)
+                ? save_mesh_bin(job.unwrapped, job.result, path, MESH_BIN_COMPRESSION_NONE)
+                : save_mesh(job.unwrapped, path);
+            s.save_ns = uvunwrap::now_ns() - t0;
+            if (rc != 0) {
+                LOG_ERROR("unwrap_batch: could not write %s", path);
+                s.status = UNWRAP_BATCH_SAVE_FAILED;
+            } else {
+                s.num_islands = job.result->num_islands;
+                s.avg_stretch = job.result->avg_stretch;
+                s.max_stretch = job.result->max_stretch;
+                s.coverage = job.result->coverage;
+                s.overlap = job.result->overlap;
+                if (options->histograms) record_file(options->histograms, s, job.unwrapped, job.result);
+            }
+        }
+        free_unwrap_result(job.result);
+        free_mesh(job.unwrapped);
+        budget.release(job.held_bytes);
+
+        done++;
+        if (s.status != UNWRAP_BATCH_OK) failed++;
+        if (progress) progress(done, n, job.index, s.status, user_data);
+    }
+
+    reader.join();
+    for (size_t t = 0; t < pool.size(); t++) pool[t].join();
+    for (size_t t = 0; t < worker_stretch.size(); t++) {
+        uv_histogram_merge(&options->histograms->stretch, &worker_stretch[t]);
+        uv_histogram_merge(&options->histograms->angle_distortion, &worker_angle[t]);
+    }
+
+    if (stats_out) memcpy(stats_out, stats.data(), stats.size() * sizeof(UnwrapBatchFileStats));
+    LOG_INFO("=== Batch done: %d of %d files failed ===", failed, n);
+    return failed;
+}
@@ -0,0 +1,586 @@
+/**
+ * @file unwrap_cache.cpp
+ * @brief Content-addressed on-disk cache of unwrap results
+ *
+ * Directory layout:
+ *   index.bin           IndexHeader (64 bytes) + IndexSlot[capacity] (32 bytes each)
+ *   <key as 16 hex>.uvmb one mesh_bin file (output mesh + result) per entry
+ *
+ * The index is an open-addressing hash table mapped shared by every
+ * process using the directory. Readers probe it without locking: a slot's
+ * key is published (release) after its other fields, and a key found is
+ * only a hint, since the entry file is loaded with checksums verified and
+ * compared against the input geometry. Writers hold a process mutex plus
+ * flock() on the index for inserts, evictions and compaction. last_used
+ * ticks a shared logical clock, so eviction is LRU across processes.
+ */
+
+#include "unwrap_cache.h"
+#include "result_cache.h"
+#include "mesh_bin.h"
+#include "mesh_hash.h"
+#include "mesh_reorder.h"
+#include "lscm.h"
+#include "logging.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const long long DEFAULT_MAX_BYTES = 1LL << 30;
+
+/** Bump when the same inputs would unwrap differently, to orphan old entries */
+const uint64_t CACHE_KEY_VERSION = 2;
+
+/** Everything in UnwrapParams that changes the output (not threads or plans) */
+struct KeyParams {
+    float angle_threshold;
+    int32_t min_island_faces;
+    int32_t pack_islands;
+    float island_margin;
+    int32_t seam_method;
+    int32_t solver;
+    int32_t cg_threshold;
+    int32_t cg_max_iterations;
+    float cg_tolerance;
+    int32_t cg_preconditioner;
+    int32_t pack_method;
+    int32_t pack_rotation;
+    float texel_density;
+    int32_t udim_tiles;
+    int32_t udim_resolution;
+    int32_t pin_method;
+    int32_t lscm_method;
+    int32_t arap_iterations;
+    float arap_time_limit;
+    int32_t lscm_precision;
+    int32_t max_chart_faces;
+    float max_chart_angle;
+    int32_t solver_backends;     /**< AUTO resolves differently per build */
+    int32_t lscm_ordering;
+    int32_t vertex_order;
+    int32_t island_instancing;
+    int32_t island_scale;
+};
+
+uint64_t cache_key(const Mesh* mesh, const UnwrapParams* params) {
+    KeyParams p;
+    memset(&p, 0, sizeof(p));
+    p.angle_threshold = params->angle_threshold;
+    p.min_island_faces = params->min_island_faces;
+    p.pack_islands = params->pack_islands;
+    p.island_margin = params->island_margin;
+    p.seam_method = params->seam_method;
+    p.solver = params->solver;
+    p.cg_threshold = params->cg_threshold;
+    p.cg_max_iterations = params->cg_max_iterations;
+    p.cg_tolerance = params->cg_tolerance;
+    p.cg_preconditioner = params->cg_preconditioner;
+    p.pack_method = params->pack_method;
+    p.pack_rotation = params->pack_rotation;
+    p.texel_density = params->texel_density;
+    p.udim_tiles = params->udim_tiles;
+    p.udim_resolution = params->udim_resolution;
+    p.pin_method = params->pin_method;
+    p.lscm_method = params->lscm_method;
+    p.arap_iterations = params->arap_iterations;
+    p.arap_time_limit = params->arap_time_limit;
+    p.lscm_precision = params->lscm_precision;
+    p.max_chart_faces = params->max_chart_faces;
+    p.max_chart_angle = params->max_chart_angle;
+    p.solver_backends = lscm_solver_available(LSCM_SOLVER_CHOLMOD) |
+                        lscm_solver_available(LSCM_SOLVER_PARDISO) << 1 |
+                        lscm_ordering_available(LSCM_ORDERING_METIS) << 2;
+    p.lscm_ordering = params->lscm_ordering;
+    p.vertex_order = params->vertex_order;
+    p.island_instancing = params->island_instancing;
+    p.island_scale = params->island_scale;
+
+    // Existing UVs warm-start iterative solves, so they are part of the input
+    uint64_t parts[6];
+    parts[0] = uv_hash_bytes(&p, sizeof(p), CACHE_KEY_VERSION, 1);
+    parts[1] = uv_mesh_hash(mesh, params->num_threads);
+    parts[2] = mesh->uvs ? uv_hash_bytes(mesh->uvs, (size_t)mesh->num_vertices * 2 * sizeof(float),
+                                         CACHE_KEY_VERSION, params->num_threads)
+                         : 0;
+    parts[3] = params->pinned_vertices
+                   ? uv_hash_bytes(params->pinned_vertices,
+                                   (size_t)std::max(params->num_pinned_vertices, 0) * sizeof(int),
+                                   CACHE_KEY_VERSION, 1)
+                   : 0;
+    // User seams replace seam detection (the low bit keeps an empty list apart from none)
+    parts[4] = params->seam_edges
+                   ? uv_hash_bytes(params->seam_edges,
+                                   (size_t)std::max(params->num_seam_edges, 0) * 2 * sizeof(int),
+                                   CACHE_KEY_VERSION, 1) | 1
+                   : 0;
+    parts[5] = params->face_importance
+                   ? uv_hash_bytes(params->face_importance, (size_t)mesh->num_triangles * sizeof(float),
+                                   CACHE_KEY_VERSION, 1)
+                   : 0;
+    uint64_t key = uv_hash_bytes(parts, sizeof(parts), CACHE_KEY_VERSION, 1);
+    return key < 2 ? key + 2 : key;  // 0 and 1 mark empty and removed slots
+}
+
+#ifndef _WIN32
+
+const char INDEX_MAGIC[8] = {'U', 'V', 'C', 'A', 'C', 'H', 'E', 'X'};
+const uint32_t INDEX_VERSION = 1;
+const uint32_t INDEX_CAPACITY = 4096;  // Power of two
+
+const uint64_t KEY_EMPTY = 0;
+const uint64_t KEY_REMOVED = 1;
+
+struct IndexHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t capacity;
+    uint64_t clock;          /**< Logical time of the latest use (atomic) */
+    uint64_t total_bytes;    /**< Sum of live slot bytes (written under the lock) */
+    uint32_t num_entries;    /**< Live slots */
+    uint32_t num_removed;    /**< Tombstones; compacted past capacity / 4 */
+    uint8_t reserved[24];
+};
+
+struct IndexSlot {
+    uint64_t key;            /**< KEY_EMPTY, KEY_REMOVED or an entry key (atomic) */
+    uint64_t bytes;          /**< Entry file size */
+    uint64_t last_used;      /**< Clock value of the latest hit or store (atomic) */
+    uint64_t reserved;
+};
+
+static_assert(sizeof(IndexHeader) == 64, "IndexHeader must stay 64 bytes");
+static_assert(sizeof(IndexSlot) == 32, "IndexSlot must stay 32 bytes");
+
+inline uint64_t load_acquire(const uint64_t* p) { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+inline uint64_t load_relaxed(const uint64_t* p) { return __atomic_load_n(p, __ATOMIC_RELAXED); }
+inline void store_release(uint64_t* p, uint64_t value) { __atomic_store_n(p, value, __ATOMIC_RELEASE); }
+inline void store_relaxed(uint64_t* p, uint64_t value) { __atomic_store_n(p, value, __ATOMIC_RELAXED); }
+
+bool is_entry_name(const char* name) {
+    if (strlen(name) != 16 + 5 || strcmp(name + 16, ".uvmb") != 0) return false;
+    for (int i = 0; i < 16; i++) {
+        char c = name[i];
+        if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'))) return false;
+    }
+    return true;
+}
+
+bool make_directories(const std::string& path) {
+    for (size_t i = 1; i <= path.size(); i++) {
+        if (i < path.size() && path[i] != '/') continue;
+        std::string prefix = path.substr(0, i);
+        if (mkdir(prefix.c_str(), 0755) != 0 && errno != EEXIST) return false;
+    }
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+class ResultCache {
+public:
+    static ResultCache* open(const char* directory, long long max_bytes) {
+        ResultCache* cache = new ResultCache(directory, max_bytes > 0 ? max_bytes : DEFAULT_MAX_BYTES);
+        if (!cache->open_index()) {
+            delete cache;
+            return NULL;
+        }
+        return cache;
+    }
+
+    ~ResultCache() {
+        if (header_) munmap(header_, map_size());
+        if (fd_ >= 0) close(fd_);
+    }
+
+    /** Entry file of key with its use recorded, or NULL (free with free_mesh_bin()) */
+    MeshBin* load(uint64_t key) {
+        int slot = find(key);
+        if (slot < 0) return NULL;
+        store_relaxed(&slots_[slot].last_used, __atomic_add_fetch(&header_->clock, 1, __ATOMIC_RELAXED));
+
+        // The entry may have been evicted since the probe
+        std::string path = entry_path(key);
+        struct stat st;
+        return stat(path.c_str(), &st) == 0 ? load_mesh_bin(path.c_str(), 1) : NULL;
+    }
+
+    Mesh* lookup(uint64_t key, const Mesh* mesh, UnwrapResult** result_out) {
+        MeshBin* bin = load(key);
+        const Mesh* stored = mesh_bin_mesh(bin);
+        const UnwrapResult* stored_result = mesh_bin_result(bin);
+        if (!bin || !stored_result || !stored->uvs || !stored_result->face_island_ids ||
+            stored->num_vertices != mesh->num_vertices || stored->num_triangles != mesh->num_triangles ||
+            memcmp(stored->vertices, mesh->vertices, (size_t)mesh->num_vertices * 3 * sizeof(float)) != 0 ||
+            memcmp(stored->triangles, mesh->triangles, (size_t)mesh->num_triangles * 3 * sizeof(int)) != 0) {
+            if (bin) LOG_WARNING("unwrap cache: entry %016llx does not match its input", (unsigned long long)key);
+            free_mesh_bin(bin);
+            misses_++;
+            return NULL;
+        }
+
+        Mesh* output = allocate_mesh_copy(mesh);
+        size_t uv_bytes = (size_t)mesh->num_vertices * 2 * sizeof(float);
+        output->uvs = (float*)malloc(uv_bytes);
+        memcpy(output->uvs, stored->uvs, uv_bytes);
+
+        UnwrapResult* result = (UnwrapResult*)malloc(sizeof(UnwrapResult));
+        *result = *stored_result;
+        result->vertex_remap = NULL;
+        result->face_remap = NULL;
+        size_t id_bytes = (size_t)mesh->num_triangles * sizeof(int);
+        result->face_island_ids = (int*)malloc(id_bytes);
+        memcpy(result->face_island_ids, stored_result->face_island_ids, id_bytes);
+        memset(&result->stats, 0, sizeof(result->stats));
+        result->stats.cache_hit = 1;
+        free_mesh_bin(bin);
+
+        hits_++;
+        *result_out = result;
+        return output;
+    }
+
+    void store(uint64_t key, const Mesh* output, const UnwrapResult* result) {
+        if (!output->uvs || !result || !result->face_island_ids) return;
+        if (save(key, output, result)) stores_++;
+    }
+
+    /** Write mesh (and result, may be NULL) as the entry of key, evicting to stay in budget */
+    bool save(uint64_t key, const Mesh* mesh, const UnwrapResult* result) {
+        char suffix[64];
+        snprintf(suffix, sizeof(suffix), ".tmp.%ld.%lld", (long)getpid(), (long long)++temp_counter_);
+        std::string path = entry_path(key);
+        std::string temp = path + suffix;
+        if (save_mesh_bin(mesh, result, temp.c_str(), MESH_BIN_COMPRESSION_NONE) != 0) {
+            unlink(temp.c_str());
+            return false;
+        }
+        struct stat st;
+        if (stat(temp.c_str(), &st) != 0 || (long long)st.st_size > max_bytes_) {
+            unlink(temp.c_str());
+            return false;
+        }
+        uint64_t bytes = (uint64_t)st.st_size;
+
+        lock();
+        if (rename(temp.c_str(), path.c_str()) != 0) {
+            unlock();
+            LOG_WARNING("unwrap cache: cannot write %s", path.c_str());
+            unlink(temp.c_str());
+            return false;
+        }
+        int slot = find_for_insert(key);
+        IndexSlot& s = slots_[slot];
+        uint64_t previous = load_relaxed(&s.key);
+        if (previous == key) {
+            header_->total_bytes -= s.bytes;
+        } else {
+            if (previous == KEY_REMOVED) header_->num_removed--;
+            header_->num_entries++;
+        }
+        s.bytes = bytes;
+        store_relaxed(&s.last_used, __atomic_add_fetch(&header_->clock, 1, __ATOMIC_RELAXED));
+        store_release(&s.key, key);
+        header_->total_bytes += bytes;
+
+        while ((header_->total_bytes > (uint64_t)max_bytes_ ||
+                header_->num_entries > capacity_ / 4 * 3) && evict_oldest(slot)) {
+        }
+        if (header_->num_removed > capacity_ / 4) compact();
+        unlock();
+        return true;
+    }
+
+    int clear() {
+        lock();
+        int removed = 0;
+        for (uint32_t i = 0; i < capacity_; i++) {
+            uint64_t key = load_relaxed(&slots_[i].key);
+            if (key > KEY_REMOVED) {
+                unlink(entry_path(key).c_str());
+                removed++;
+            }
+        }
+        reset_index();
+        unlock();
+        return removed;
+    }
+
+    void stats(UnwrapCacheStats* out) const {
+        out->hits = hits_;
+        out->misses = misses_;
+        out->stores = stores_;
+        out->evictions = evictions_;
+        out->num_entries = (int)__atomic_load_n(&header_->num_entries, __ATOMIC_RELAXED);
+        out->total_bytes = (long long)load_relaxed(&header_->total_bytes);
+        out->max_bytes = max_bytes_;
+    }
+
+private:
+    ResultCache(const char* directory, long long max_bytes)
+        : dir_(directory), max_bytes_(max_bytes), fd_(-1), header_(NULL), slots_(NULL),
+          capacity_(INDEX_CAPACITY), hits_(0), misses_(0), stores_(0), evictions_(0), temp_counter_(0) {}
+
+    size_t map_size() const { return sizeof(IndexHeader) + (size_t)capacity_ * sizeof(IndexSlot); }
+
+    std::string entry_path(uint64_t key) const {
+        char name[32];
+        snprintf(name, sizeof(name), "/%016llx.uvmb", (unsigned long long)key);
+        return dir_ + name;
+    }
+
+    bool open_index() {
+        while (dir_.size() > 1 && dir_[dir_.size() - 1] == '/') dir_.erase(dir_.size() - 1);
+        if (!make_directories(dir_)) {
+            LOG_ERROR("unwrap cache: cannot create %s", dir_.c_str());
+            return false;
+        }
+        std::string path = dir_ + "/index.bin";
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd_ < 0) {
+            LOG_ERROR("unwrap cache: cannot open %s", path.c_str());
+            return false;
+        }
+
+        lock();
+        struct stat st;
+        bool ok = fstat(fd_, &st) == 0;
+        bool fresh = ok && (size_t)st.st_size != map_size();
+        if (fresh) ok = ftruncate(fd_, 0) == 0 && ftruncate(fd_, (off_t)map_size()) == 0;
+        if (ok) {
+            void* mapping = mmap(NULL, map_size(), PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+            if (mapping != MAP_FAILED) {
+                header_ = (IndexHeader*)mapping;
+                slots_ = (IndexSlot*)(header_ + 1);
+            }
+        }
+        if (header_ && (fresh || memcmp(header_->magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0 ||
+                        header_->version != INDEX_VERSION || header_->capacity != capacity_)) {
+            // New or unreadable index: entries it does not list could never be evicted
+            remove_entry_files();
+            reset_index();
+        }
+        unlock();
+
+        if (!header_) {
+            LOG_ERROR("unwrap cache: cannot map %s", path.c_str());
+            return false;
+        }
+        LOG_INFO("unwrap cache: %s (%u entries, %llu bytes)", dir_.c_str(), header_->num_entries,
+                 (unsigned long long)header_->total_bytes);
+        return true;
+    }
+
+    void reset_index() {
+        memset(slots_, 0, (size_t)capacity_ * sizeof(IndexSlot));
+        memset(header_, 0, sizeof(IndexHeader));
+        header_->version = INDEX_VERSION;
+        header_->capacity = capacity_;
+        memcpy(header_->magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    }
+
+    void remove_entry_files() {
+        DIR* d = opendir(dir_.c_str());
+        if (!d) return;
+        while (struct dirent* e = readdir(d)) {
+            if (is_entry_name(e->d_name)) unlink((dir_ + "/" + e->d_name).c_str());
+        }
+        closedir(d);
+    }
+
+    void lock() {
+        mutex_.lock();
+        while (flock(fd_, LOCK_EX) != 0 && errno == EINTR) {
+        }
+    }
+
+    void unlock() {
+        flock(fd_, LOCK_UN);
+        mutex_.unlock();
+    }
+
+    /** Lock-free probe; -1 if absent */
+    int find(uint64_t key) const {
+        uint32_t mask = capacity_ - 1;
+        for (uint32_t n = 0, i = (uint32_t)key & mask; n < capacity_; n++, i = (i + 1) & mask) {
+            uint64_t k = load_acquire(&slots_[i].key);
+            if (k == key) return (int)i;
+            if (k == KEY_EMPTY) return -1;
+        }
+        return -1;
+    }
+
+    /** Slot holding key, else the first free one on its probe path (under the lock) */
+    int find_for_insert(uint64_t key) {
+        int existing = find(key);
+        if (existing >= 0) return existing;
+        uint32_t mask = capacity_ - 1;
+        uint32_t i = (uint32_t)key & mask;
+        while (load_relaxed(&slots_[i].key) > KEY_REMOVED) i = (i + 1) & mask;
+        return (int)i;
+    }
+
+    bool evict_oldest(int keep) {
+        int oldest = -1;
+        uint64_t oldest_used = 0;
+        for (uint32_t i = 0; i < capacity_; i++) {
+            if ((int)i == keep || load_relaxed(&slots_[i].key) <= KEY_REMOVED) continue;
+            uint64_t used = load_relaxed(&slots_[i].last_used);
+            if (oldest < 0 || used < oldest_used) {
+                oldest = (int)i;
+                oldest_used = used;
+            }
+        }
+        if (oldest < 0) return false;
+
+        IndexSlot& s = slots_[oldest];
+        unlink(entry_path(load_relaxed(&s.key)).c_str());
+        header_->total_bytes -= s.bytes;
+        header_->num_entries--;
+        header_->num_removed++;
+        store_release(&s.key, KEY_REMOVED);
+        evictions_++;
+        return true;
+    }
+
+    /**
+     * Reinsert live slots without tombstones. A concurrent reader may miss
+     * an entry while this runs, which only costs it an unwrap.
+     */
+    void compact() {
+        std::vector<IndexSlot> live;
+        for (uint32_t i = 0; i < capacity_; i++) {
+            if (load_relaxed(&slots_[i].key) > KEY_REMOVED) live.push_back(slots_[i]);
+        }
+        for (uint32_t i = 0; i < capacity_; i++) store_release(&slots_[i].key, KEY_EMPTY);
+        for (size_t j = 0; j < live.size(); j++) {
+            IndexSlot& s = slots_[find_for_insert(live[j].key)];
+            s.bytes = live[j].bytes;
+            store_relaxed(&s.last_used, live[j].last_used);
+            store_release(&s.key, live[j].key);
+        }
+        header_->num_removed = 0;
+    }
+
+    std::string dir_;
+    long long max_bytes_;
+    int fd_;
+    IndexHeader* header_;
+    IndexSlot* slots_;
+    uint32_t capacity_;
+    std::mutex mutex_;
+    std::atomic<long long> hits_;
+    std::atomic<long long> misses_;
+    std::atomic<long long> stores_;
+    std::atomic<long long> evictions_;
+    std::atomic<long long> temp_counter_;
+};
+
+#else
+
+/** Stand-in so the configuration code builds; never instantiated */
+class ResultCache {
+public:
+    static ResultCache* open(const char*, long long) {
+        LOG_WARNING("unwrap cache: not supported on this platform");
+        return NULL;
+    }
+    MeshBin* load(uint64_t) { return NULL; }
+    Mesh* lookup(uint64_t, const Mesh*, UnwrapResult**) { return NULL; }
+    void store(uint64_t, const Mesh*, const UnwrapResult*) {}
+    bool save(uint64_t, const Mesh*, const UnwrapResult*) { return false; }
+    int clear() { return 0; }
+    void stats(UnwrapCacheStats*) const {}
+};
+
+#endif
+
+std::mutex g_config_mutex;
+std::shared_ptr<ResultCache> g_cache;
+bool g_configured = false;
+
+std::shared_ptr<ResultCache> current_cache() {
+    std::lock_guard<std::mutex> guard(g_config_mutex);
+    if (!g_configured) {
+        g_configured = true;
+        const char* directory = getenv("UVUNWRAP_CACHE_DIR");
+        if (directory && directory[0]) {
+            const char* budget = getenv("UVUNWRAP_CACHE_MAX_BYTES");
+            g_cache.reset(ResultCache::open(directory, budget ? atoll(budget) : 0));
+        }
+    }
+    return g_cache;
+}
+
+} // namespace
+
+namespace uvunwrap {
+
+Mesh* result_cache_lookup(const Mesh* mesh, const UnwrapParams* params,
+                          UnwrapResult** result_out, uint64_t* key_out) {
+    *key_out = 0;
+    std::shared_ptr<ResultCache> cache = current_cache();
+    // Entries are checked against the input geometry, which a split or
+    // reordered output no longer has
+    if (!cache || params->uv_output == UV_OUTPUT_SPLIT_VERTICES || params->output_order != VERTEX_ORDER_INPUT) {
+        return NULL;
+    }
+    *key_out = cache_key(mesh, params);
+    return cache->lookup(*key_out, mesh, result_out);
+}
+
+void result_cache_store(uint64_t key, const Mesh* output, const UnwrapResult* result) {
+    if (key == 0) return;
+    std::shared_ptr<ResultCache> cache = current_cache();
+    if (cache) cache->store(key, output, result);
+}
+
+MeshBin* result_cache_load_entry(uint64_t key) {
+    std::shared_ptr<ResultCache> cache = current_cache();
+    return cache ? cache->load(key < 2 ? key + 2 : key) : NULL;
+}
+
+bool result_cache_save_entry(uint64_t key, const Mesh* mesh) {
+    std::shared_ptr<ResultCache> cache = current_cache();
+    return cache && cache->save(key < 2 ? key + 2 : key, mesh, NULL);
+}
+
+} // namespace uvunwrap
+
+int unwrap_cache_configure(const char* directory, long long max_bytes) {
+    ResultCache* cache = directory ? ResultCache::open(directory, max_bytes) : NULL;
+    std::lock_guard<std::mutex> guard(g_config_mutex);
+    g_configured = true;
+    g_cache.reset(cache);
+    return directory && !cache ? -1 : 0;
+}
+
+int unwrap_cache_stats(UnwrapCacheStats* stats_out) {
+    std::shared_ptr<ResultCache> cache = current_cache();
+    if (stats_out) {
+        memset(stats_out, 0, sizeof(*stats_out));
+        if (cache) cache->stats(stats_out);
+    }
+    return cache ? 0 : -1;
+}
+
+int unwrap_cache_clear(void) {
+    std::shared_ptr<ResultCache> cache = current_cache();
+    return cache ? cache->clear() : -1;
+}
@@ -0,0 +1,751 @@
+/**
+ * @file unwrap_cluster.cpp
+ * @brief Island-sharded unwrapping over TCP: workers and the coordinator
+ *
+ * Wire format: the coordinator sends one shard per worker and unwrap
+ * call, a ShardHeader, the UnwrapParams and a payload of islands (each an
+ * IslandHeader, then positions, initial UVs when the shard has them,
+ * pins and triangles, all submesh-local). The worker answers with a
+ * ReplyHeader and, per island, an IslandReply followed by the solved
+ * vertices (submesh-local) and their UVs. Records are plain structs in
+ * host byte order, as in the daemon; the magic, version and UnwrapParams
+ * size catch a mismatched pair.
+ *
+ * A submesh numbers the island's vertices in the order its faces first
+ * use them, which is the local numbering lscm_solve() gives the island
+ * inside the whole mesh, and keeps their positions bit for bit. Pins are
+ * kept in the caller's order. Every input of the solve is therefore the
+ * same on the worker, and so are the UVs.
+ */
+
+#include "unwrap_cluster.h"
+#include "island_solver.h"
+#include "unwrap_options.h"
+#include "socket_io.h"
+#include "logging.h"
+#include "parallel.h"
+#include "timer.h"
+#include "trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <algorithm>
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <new>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using uvunwrap::read_all;
+using uvunwrap::write_all;
+
+namespace {
+
+const uint32_t PROTOCOL_MAGIC = 0x43575655;   // "UVWC"
+const uint32_t PROTOCOL_VERSION = 1;
+const int LISTEN_BACKLOG = 16;
+// Largest shard a worker accepts, against garbage lengths: 4 GiB holds
+// islands of some 200 million triangles, far past what one call shards
+const uint64_t MAX_MESSAGE_BYTES = 1ull << 32;
+// A payload buffer grows by at most this much per read
+const size_t READ_CHUNK_BYTES = (size_t)1 << 24;
+
+// ShardHeader::flags
+const uint32_t SHARD_WORKER_PLAN = 1;          // solve with the connection's LscmPlan
+
+struct ShardHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t params_size;
+    uint32_t flags;
+    int32_t num_islands;
+    int32_t has_uvs;
+    uint64_t payload_bytes;
+};
+
+struct IslandHeader {
+    int32_t num_vertices;
+    int32_t num_faces;
+    int32_t num_pins;
+    int32_t reserved;
+};
+
+struct ReplyHeader {
+    uint32_t magic;
+    int32_t num_islands;
+    uint64_t payload_bytes;
+};
+
+struct IslandReply {
+    int32_t num_verts;           // -1 if the solve failed
+    int32_t reserved;
+    long long solve_ns;
+    LscmReport report;
+};
+
+void put(std::vector<char>& out, const void* data, size_t size) {
+    if (size == 0) return;
+    const char* p = (const char*)data;
+    out.insert(out.end(), p, p + size);
+}
+
+/** Bounds-checked cursor over a received payload */
+struct Reader {
+    const char* p;
+    const char* end;
+
+    bool get(void* data, size_t size) {
+        if ((size_t)(end - p) < size) return false;
+        if (size > 0) memcpy(data, p, size);
+        p += size;
+        return true;
+    }
+
+    template <typename T>
+    bool get_array(std::vector<T>& out, int count) {
+        if (count < 0 || (size_t)(end - p) / sizeof(T) < (size_t)count) return false;
+        out.resize((size_t)count);
+        return get(out.data(), (size_t)count * sizeof(T));
+    }
+};
+
+/**
+ * Read a payload of the given length, growing the buffer only as its bytes
+ * arrive: a header that lies about the length costs no more memory than
+ * the peer really sends. False on a short read or if the buffer cannot grow
+ */
+bool read_payload(int fd, uint64_t bytes, std::vector<char>& out) {
+    out.clear();
+    try {
+        while (out.size() < bytes) {
+            size_t at = out.size();
+            size_t chunk = (size_t)std::min<uint64_t>(bytes - at, READ_CHUNK_BYTES);
+            out.resize(at + chunk);
+            if (!read_all(fd, out.data() + at, chunk)) return false;
+        }
+    } catch (const std::bad_alloc&) {
+        LOG_WARNING("unwrap cluster: no memory for a %llu-byte message", (unsigned long long)bytes);
+        return false;
+    }
+    return true;
+}
+
+/** Split "host:port"; an empty host or "*" is returned as "" */
+bool split_address(const char* address, std::string* host, std::string* port) {
+    if (!address) return false;
+    const char* colon = strrchr(address, ':');
+    if (!colon || !colon[1]) {
+        LOG_ERROR("unwrap cluster: expected host:port, got \"%s\"", address);
+        return false;
+    }
+    host->assign(address, (size_t)(colon - address));
+    if (*host == "*") host->clear();
+    // [v6]:port
+    if (host->size() >= 2 && (*host)[0] == '[' && (*host)[host->size() - 1] == ']') {
+        *host = host->substr(1, host->size() - 2);
+    }
+    port->assign(colon + 1);
+    return true;
+}
+
+void set_nodelay(int fd) {
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+/** UnwrapParams as sent: pointer fields mean nothing on the other side */
+UnwrapParams wire_params(const UnwrapParams* params) {
+    UnwrapParams p = *params;
+    p.lscm_plan = NULL;
+    p.pinned_vertices = NULL;
+    p.num_pinned_vertices = 0;
+    p.seam_edges = NULL;
+    p.num_seam_edges = 0;
+    p.face_importance = NULL;
+    p.metrics_histograms = NULL;
+    p.progress = NULL;
+    p.progress_user_data = NULL;
+    p.cancel = NULL;
+    return p;
+}
+
+} // namespace
+
+struct UnwrapClusterWorker {
+    int listen_fd;
+    int wake[2];                 // written once by stop() to end the acceptor's poll
+    int port;
+    int num_threads;
+    std::thread acceptor;
+    std::mutex mutex;
+    bool stopping;               // guarded by mutex
+    std::set<int> live;          // connections being served, guarded by mutex
+    std::list<std::thread> connections;     // guarded by mutex
+    std::vector<std::thread::id> finished;  // connection threads about to return, guarded by mutex
+    std::atomic<long long> islands;
+
+    UnwrapClusterWorker() : listen_fd(-1), port(0), num_threads(1), stopping(false), islands(0) {
+        wake[0] = wake[1] = -1;
+    }
+};
+
+namespace {
+
+/** One received island, as a mesh of its own */
+struct Submesh {
+    std::vector<float> vertices;
+    std::vector<float> uvs;
+    std::vector<int> triangles;
+    std::vector<int> pins;
+    Mesh mesh;
+};
+
+/** Parse a shard payload; false if it is malformed */
+bool read_shard(const std::vector<char>& payload, int num_islands, bool has_uvs, std::vector<Submesh>& islands) {
+    Reader in = {payload.data(), payload.data() + payload.size()};
+    if ((size_t)num_islands > payload.size() / sizeof(IslandHeader)) return false;
+    islands.resize((size_t)num_islands);
+    for (int i = 0; i < num_islands; i++) {
+        Submesh& s = islands[i];
+        IslandHeader h;
+        if (!in.get(&h, sizeof(h)) || h.num_vertices < 0 || h.num_faces <= 0 || h.num_pins < 0 ||
+            h.num_vertices > INT_MAX / 3 || h.num_faces > INT_MAX / 3) {
+            return false;
+        }
+        if (!in.get_array(s.vertices, h.num_vertices * 3)) return false;
+        if (has_uvs && !in.get_array(s.uvs, h.num_vertices * 2)) return false;
+        if (!in.get_array(s.pins, h.num_pins) || !in.get_array(s.triangles, h.num_faces * 3)) return false;
+        for (int v : s.triangles) {
+            if (v < 0 || v >= h.num_vertices) return false;
+        }
+        s.mesh.vertices = s.vertices.data();
+        s.mesh.uvs = has_uvs ? s.uvs.data() : NULL;
+        s.mesh.triangles = s.triangles.data();
+        s.mesh.num_vertices = h.num_vertices;
+        s.mesh.num_triangles = h.num_faces;
+    }
+    return in.p == in.end;
+}
+
+/** Solve every island of a shard and append the answer to reply */
+void solve_shard(UnwrapClusterWorker* worker, const UnwrapParams& params, LscmPlan* plan,
+                 std::vector<Submesh>& islands, std::vector<char>& reply) {
+    int count = (int)islands.size();
+    std::vector<IslandReply> answers((size_t)count);
+    std::vector<std::vector<float> > uvs((size_t)count);
+    std::vector<std::vector<int> > vertices((size_t)count);
+    uvunwrap::parallel_for_dynamic(count, worker->num_threads, [&](int, int i) {
+        Submesh& s = islands[i];
+        int num_faces = s.mesh.num_triangles;
+        LscmOptions options;
+        uvunwrap::lscm_options_from_params(&params, s.mesh.uvs, &options);
+        options.plan = plan;
+        options.pinned_vertices = s.pins.empty() ? NULL : s.pins.data();
+        options.num_pinned_vertices = (int)s.pins.size();
+        std::vector<int> faces((size_t)num_faces);
+        for (int f = 0; f < num_faces; f++) faces[f] = f;
+        uvs[i].resize((size_t)num_faces * 6);
+        vertices[i].resize((size_t)num_faces * 3);
+
+        IslandReply& answer = answers[i];
+        memset(&answer, 0, sizeof(answer));
+        long long start = uvunwrap::now_ns();
+        answer.num_verts = lscm_parameterize_into(&s.mesh, faces.data(), num_faces, &options, &answer.report,
+                                                  uvs[i].data(), vertices[i].data(), NULL);
+        answer.solve_ns = uvunwrap::now_ns() - start;
+    });
+    worker->islands.fetch_add(count);
+
+    for (int i = 0; i < count; i++) {
+        put(reply, &answers[i], sizeof(IslandReply));
+        int n = answers[i].num_verts;
+        if (n <= 0) continue;
+        put(reply, vertices[i].data(), (size_t)n * sizeof(int));
+        put(reply, uvs[i].data(), (size_t)n * 2 * sizeof(float));
+    }
+}
+
+/** Answer shards until the coordinator hangs up or sends something malformed */
+void serve_shards(UnwrapClusterWorker* worker, int fd, LscmPlan** plan_io) {
+    LscmPlan*& plan = *plan_io;
+    ShardHeader header;
+    std::vector<char> payload;
+    while (read_all(fd, &header, sizeof(header))) {
+        if (header.magic != PROTOCOL_MAGIC || header.version != PROTOCOL_VERSION ||
+            header.params_size != sizeof(UnwrapParams)) {
+            LOG_WARNING("unwrap cluster: dropping a coordinator of another protocol or build");
+            break;
+        }
+        UnwrapParams params;
+        // Every island needs at least its header in the payload
+        if (header.num_islands < 0 || header.payload_bytes > MAX_MESSAGE_BYTES ||
+            (uint64_t)header.num_islands * sizeof(IslandHeader) > header.payload_bytes ||
+            !read_all(fd, &params, sizeof(params))) {
+            break;
+        }
+        if (!read_payload(fd, header.payload_bytes, payload)) break;
+        std::vector<Submesh> islands;
+        if (!read_shard(payload, header.num_islands, header.has_uvs != 0, islands)) {
+            LOG_WARNING("unwrap cluster: dropping a coordinator that sent a malformed shard");
+            break;
+        }
+        payload.clear();
+        payload.shrink_to_fit();
+        if ((header.flags & SHARD_WORKER_PLAN) && !plan) plan = lscm_plan_create(0);
+
+        params = wire_params(&params);
+        std::vector<char> reply(sizeof(ReplyHeader));
+        solve_shard(worker, params, (header.flags & SHARD_WORKER_PLAN) ? plan : NULL, islands, reply);
+        ReplyHeader out;
+        memset(&out, 0, sizeof(out));
+        out.magic = PROTOCOL_MAGIC;
+        out.num_islands = header.num_islands;
+        out.payload_bytes = reply.size() - sizeof(ReplyHeader);
+        memcpy(reply.data(), &out, sizeof(out));
+        if (!write_all(fd, reply.data(), reply.size())) break;
+    }
+}
+
+void serve_connection(UnwrapClusterWorker* worker, int fd) {
+    LscmPlan* plan = NULL;
+    // Running out of memory on one shard drops that coordinator, not the node
+    try {
+        serve_shards(worker, fd, &plan);
+    } catch (const std::bad_alloc&) {
+        LOG_WARNING("unwrap cluster: out of memory; dropping a coordinator");
+    }
+    lscm_plan_free(plan);
+    std::lock_guard<std::mutex> lock(worker->mutex);
+    worker->live.erase(fd);
+    close(fd);
+    worker->finished.push_back(std::this_thread::get_id());
+}
+
+/** Join the connection threads that have finished; caller holds worker->mutex */
+void reap_connections(UnwrapClusterWorker* worker) {
+    for (size_t i = 0; i < worker->finished.size(); i++) {
+        for (auto it = worker->connections.begin(); it != worker->connections.end(); ++it) {
+            if (it->get_id() != worker->finished[i]) continue;
+            it->join();
+            worker->connections.erase(it);
+            break;
+        }
+    }
+    worker->finished.clear();
+}
+
+void accept_loop(UnwrapClusterWorker* worker) {
+    pollfd fds[2];
+    fds[0].fd = worker->listen_fd;
+    fds[0].events = POLLIN;
+    fds[1].fd = worker->wake[0];
+    fds[1].events = POLLIN;
+    for (;;) {
+        fds[0].revents = fds[1].revents = 0;
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            LOG_ERROR("unwrap cluster: poll failed: %s", strerror(errno));
+            break;
+        }
+        if (fds[1].revents) break;
+        if (!(fds[0].revents & POLLIN)) continue;
+        int fd = accept(worker->listen_fd, NULL, NULL);
+        if (fd < 0) {
+            if (errno != EINTR && errno != EAGAIN && errno != ECONNABORTED) {
+                LOG_WARNING("unwrap cluster: accept failed: %s", strerror(errno));
+            }
+            continue;
+        }
+        set_nodelay(fd);
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        if (worker->stopping) {
+            close(fd);
+            continue;
+        }
+        reap_connections(worker);
+        worker->live.insert(fd);
+        worker->connections.emplace_back(serve_connection, worker, fd);
+    }
+}
+
+} // namespace
+
+UnwrapClusterWorker* unwrap_cluster_worker_start(const char* address, int num_threads) {
+    std::string host, port;
+    if (!split_address(address, &host, &port)) return NULL;
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+    addrinfo* found = NULL;
+    int rc = getaddrinfo(host.empty() ? NULL : host.c_str(), port.c_str(), &hints, &found);
+    if (rc != 0) {
+        LOG_ERROR("unwrap cluster: cannot resolve %s: %s", address, gai_strerror(rc));
+        return NULL;
+    }
+    int fd = -1;
+    for (addrinfo* ai = found; ai && fd < 0; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) continue;
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (bind(fd, ai->ai_addr, ai->ai_addrlen) != 0 || listen(fd, LISTEN_BACKLOG) != 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(found);
+    if (fd < 0) {
+        LOG_ERROR("unwrap cluster: cannot listen on %s: %s", address, strerror(errno));
+        return NULL;
+    }
+
+    UnwrapClusterWorker* worker = new UnwrapClusterWorker();
+    if (pipe(worker->wake) != 0) {
+        LOG_ERROR("unwrap cluster: pipe failed: %s", strerror(errno));
+        close(fd);
+        delete worker;
+        return NULL;
+    }
+    sockaddr_storage bound;
+    socklen_t bound_size = sizeof(bound);
+    if (getsockname(fd, (sockaddr*)&bound, &bound_size) == 0) {
+        worker->port = bound.ss_family == AF_INET6 ? ntohs(((sockaddr_in6*)&bound)->sin6_port)
+                                                   : ntohs(((sockaddr_in*)&bound)->sin_port);
+    }
+    worker->listen_fd = fd;
+    worker->num_threads = uvunwrap::resolve_thread_count(num_threads);
+    worker->acceptor = std::thread(accept_loop, worker);
+    LOG_INFO("unwrap cluster: worker listening on port %d with %d threads", worker->port, worker->num_threads);
+    return worker;
+}
+
+void unwrap_cluster_worker_stop(UnwrapClusterWorker* worker) {
+    if (!worker) return;
+    {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        worker->stopping = true;
+        // Shards in flight finish and then fail to send their answer
+        for (int fd : worker->live) shutdown(fd, SHUT_RDWR);
+    }
+    char byte = 0;
+    while (write(worker->wake[1], &byte, 1) < 0 && errno == EINTR) {
+    }
+    worker->acceptor.join();
+    // The acceptor is gone, so no connection threads are added any more
+    for (std::thread& connection : worker->connections) connection.join();
+
+    close(worker->listen_fd);
+    close(worker->wake[0]);
+    close(worker->wake[1]);
+    LOG_INFO("unwrap cluster: worker stopped after %lld islands", worker->islands.load());
+    delete worker;
+}
+
+int unwrap_cluster_worker_port(const UnwrapClusterWorker* worker) {
+    return worker ? worker->port : 0;
+}
+
+long long unwrap_cluster_worker_islands(const UnwrapClusterWorker* worker) {
+    return worker ? worker->islands.load() : 0;
+}
+
+namespace {
+
+struct ClusterNode {
+    std::string address;
+    int fd;                      // -1 once the worker failed
+};
+
+} // namespace
+
+struct UnwrapCluster {
+    std::vector<ClusterNode> nodes;
+    UnwrapContext* ctx;
+};
+
+namespace {
+
+/**
+ * @brief Ships islands to the cluster's workers and solves those of
+ *        failed workers locally
+ */
+class ClusterSolver : public uvunwrap::IslandSolver {
+public:
+    explicit ClusterSolver(UnwrapCluster* cluster) : cluster_(cluster) {}
+
+    void solve(const Mesh* mesh, const UnwrapParams* params, const LscmOptions* options,
+               const uvunwrap::IslandSolveBatch& batch, const std::function<bool(int)>& island_done) override {
+        // Largest islands first onto the least loaded worker
+        std::vector<int> nodes;
+        for (size_t i = 0; i < cluster_->nodes.size(); i++) {
+            if (cluster_->nodes[i].fd >= 0) nodes.push_back((int)i);
+        }
+        std::vector<std::vector<int> > shards(nodes.size());
+        std::vector<long long> load(nodes.size(), 0);
+        std::vector<int> local;
+        for (int k = 0; k < batch.count; k++) {
+            int island_id = batch.order[k];
+            if (nodes.empty()) {
+                local.push_back(island_id);
+                continue;
+            }
+            size_t best = (size_t)(std::min_element(load.begin(), load.end()) - load.begin());
+            shards[best].push_back(island_id);
+            load[best] += batch.num_faces[island_id];
+        }
+
+        std::vector<char> ok(nodes.size(), 0);
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < nodes.size(); i++) {
+            if (shards[i].empty()) continue;
+            threads.emplace_back([&, i]() {
+                try {
+                    ok[i] = run_shard(cluster_->nodes[nodes[i]].fd, mesh, params, options, batch, shards[i],
+                                      island_done);
+                } catch (const std::bad_alloc&) {
+                    ok[i] = 0;   // its islands are solved here instead
+                }
+            });
+        }
+        for (size_t t = 0; t < threads.size(); t++) threads[t].join();
+        for (size_t i = 0; i < nodes.size(); i++) {
+            if (shards[i].empty() || ok[i]) continue;
+            ClusterNode& node = cluster_->nodes[nodes[i]];
+            LOG_WARNING("unwrap cluster: worker %s failed, solving its %d islands here", node.address.c_str(),
+                        (int)shards[i].size());
+            close(node.fd);
+            node.fd = -1;
+            local.insert(local.end(), shards[i].begin(), shards[i].end());
+        }
+        if (!local.empty()) solve_locally(mesh, params, options, batch, local, island_done);
+    }
+
+private:
+    UnwrapCluster* cluster_;
+
+    /** One shard round trip; false if the worker failed or answered garbage */
+    static bool run_shard(int fd, const Mesh* mesh, const UnwrapParams* params, const LscmOptions* options,
+                          const uvunwrap::IslandSolveBatch& batch, const std::vector<int>& shard,
+                          const std::function<bool(int)>& island_done) {
+        UV_TRACE_ZONE("cluster shard");
+        int count = (int)shard.size();
+        bool has_uvs = options->initial_uvs != NULL;
+        std::vector<char> message(sizeof(ShardHeader));
+        UnwrapParams sent = wire_params(params);
+        put(message, &sent, sizeof(sent));
+
+        // The island submeshes number vertices as lscm_solve() would in place
+        const uvunwrap::IslandMeshes& meshes = *batch.meshes;
+        std::vector<int> remap((size_t)mesh->num_vertices, -1);
+        std::vector<int> tris, pins;
+        std::vector<float> values;
+        for (int i = 0; i < count; i++) {
+            int island_id = shard[i];
+            int n = meshes.num_vertices(island_id);
+            Mesh local;
+            meshes.view(island_id, tris, &local);
+            meshes.local_pins(island_id, options->pinned_vertices, options->num_pinned_vertices, mesh->num_vertices,
+                              remap.data(), pins);
+
+            IslandHeader h;
+            memset(&h, 0, sizeof(h));
+            h.num_vertices = n;
+            h.num_faces = local.num_triangles;
+            h.num_pins = (int)pins.size();
+            put(message, &h, sizeof(h));
+            put(message, local.vertices, (size_t)n * 3 * sizeof(float));
+            if (has_uvs) {
+                meshes.gather_uvs(island_id, options->initial_uvs, values);
+                put(message, values.data(), values.size() * sizeof(float));
+            }
+            put(message, pins.data(), pins.size() * sizeof(int));
+            put(message, tris.data(), tris.size() * sizeof(int));
+        }
+
+        ShardHeader header;
+        memset(&header, 0, sizeof(header));
+        header.magic = PROTOCOL_MAGIC;
+        header.version = PROTOCOL_VERSION;
+        header.params_size = sizeof(UnwrapParams);
+        header.flags = params->lscm_plan ? SHARD_WORKER_PLAN : 0;
+        header.num_islands = count;
+        header.has_uvs = has_uvs ? 1 : 0;
+        header.payload_bytes = message.size() - sizeof(ShardHeader) - sizeof(UnwrapParams);
+        memcpy(message.data(), &header, sizeof(header));
+        if (!write_all(fd, message.data(), message.size())) return false;
+        message.clear();
+        message.shrink_to_fit();
+
+        // The longest answer: every island solved with all its vertices
+        uint64_t max_reply = 0;
+        for (int i = 0; i < count; i++) {
+            max_reply += sizeof(IslandReply) +
+                         (uint64_t)meshes.num_vertices(shard[i]) * (sizeof(int) + 2 * sizeof(float));
+        }
+        ReplyHeader reply;
+        if (!read_all(fd, &reply, sizeof(reply)) || reply.magic != PROTOCOL_MAGIC || reply.num_islands != count ||
+            reply.payload_bytes > max_reply) {
+            return false;
+        }
+        std::vector<char> payload;
+        if (!read_payload(fd, reply.payload_bytes, payload)) return false;
+
+        // Validate the whole answer before anything reports progress
+        Reader in = {payload.data(), payload.data() + payload.size()};
+        std::vector<int> vertices;
+        for (int i = 0; i < count; i++) {
+            int island_id = shard[i];
+            int n = meshes.num_vertices(island_id);
+            const int* local_to_global = meshes.vertices(island_id);
+            IslandReply answer;
+            if (!in.get(&answer, sizeof(answer)) || answer.num_verts > n) return false;
+            batch.reports[island_id] = answer.report;
+            batch.solve_ns[island_id] = answer.solve_ns;
+            batch.num_verts[island_id] = answer.num_verts < 0 ? -1 : answer.num_verts;
+            if (answer.num_verts <= 0) continue;
+            if (!in.get_array(vertices, answer.num_verts) ||
+                !in.get(batch.uvs[island_id], (size_t)answer.num_verts * 2 * sizeof(float))) {
+                return false;
+            }
+            for (int v = 0; v < answer.num_verts; v++) {
+                if (vertices[v] < 0 || vertices[v] >= n) return false;
+                batch.vertices[island_id][v] = local_to_global[vertices[v]];
+            }
+        }
+        if (in.p != in.end) return false;
+        for (int i = 0; i < count; i++) island_done(shard[i]);
+        return true;
+    }
+
+    /** The islands of failed workers, solved as unwrap_mesh() would */
+    static void solve_locally(const Mesh* mesh, const UnwrapParams* params, const LscmOptions* options,
+                              const uvunwrap::IslandSolveBatch& batch, const std::vector<int>& islands,
+                              const std::function<bool(int)>& island_done) {
+        int num_threads = uvunwrap::resolve_thread_count(params->num_threads);
+        std::vector<std::vector<int> > remaps((size_t)num_threads);
+        uvunwrap::parallel_for_dynamic((int)islands.size(), num_threads, [&](int thread, int k) {
+            int island_id = islands[k];
+            std::vector<int>& remap = remaps[thread];
+            if (remap.empty()) remap.assign((size_t)mesh->num_vertices, -1);
+            long long start = uvunwrap::now_ns();
+            batch.num_verts[island_id] = lscm_parameterize_into(
+                mesh, batch.faces[island_id], batch.num_faces[island_id], options, &batch.reports[island_id],
+                batch.uvs[island_id], batch.vertices[island_id], remap.data());
+            batch.solve_ns[island_id] = uvunwrap::now_ns() - start;
+            island_done(island_id);
+        });
+    }
+};
+
+} // namespace
+
+UnwrapCluster* unwrap_cluster_connect(const char* const* addresses, int num_addresses) {
+    if (!addresses || num_addresses <= 0) return NULL;
+    UnwrapCluster* cluster = new UnwrapCluster();
+    for (int i = 0; i < num_addresses; i++) {
+        std::string host, port;
+        if (!split_address(addresses[i], &host, &port)) continue;
+        addrinfo hints;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* found = NULL;
+        if (getaddrinfo(host.empty() ? NULL : host.c_str(), port.c_str(), &hints, &found) != 0) {
+            LOG_WARNING("unwrap cluster: cannot resolve %s", addresses[i]);
+            continue;
+        }
+        int fd = -1;
+        for (addrinfo* ai = found; ai && fd < 0; ai = ai->ai_next) {
+            fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (fd >= 0 && connect(fd, ai->ai_addr, ai->ai_addrlen) != 0) {
+                close(fd);
+                fd = -1;
+            }
+        }
+        freeaddrinfo(found);
+        if (fd < 0) {
+            LOG_WARNING("unwrap cluster: no worker on %s", addresses[i]);
+            continue;
+        }
+        set_nodelay(fd);
+        ClusterNode node;
+        node.address = addresses[i];
+        node.fd = fd;
+        cluster->nodes.push_back(node);
+    }
+    if (cluster->nodes.empty()) {
+        delete cluster;
+        return NULL;
+    }
+    cluster->ctx = unwrap_context_create();
+    return cluster;
+}
+
+void unwrap_cluster_disconnect(UnwrapCluster* cluster) {
+    if (!cluster) return;
+    for (size_t i = 0; i < cluster->nodes.size(); i++) {
+        if (cluster->nodes[i].fd >= 0) close(cluster->nodes[i].fd);
+    }
+    unwrap_context_free(cluster->ctx);
+    delete cluster;
+}
+
+int unwrap_cluster_num_workers(const UnwrapCluster* cluster) {
+    if (!cluster) return 0;
+    int count = 0;
+    for (size_t i = 0; i < cluster->nodes.size(); i++) count += cluster->nodes[i].fd >= 0 ? 1 : 0;
+    return count;
+}
+
+Mesh* unwrap_mesh_distributed(UnwrapCluster* cluster,
+                              const Mesh* mesh,
+                              const UnwrapParams* params,
+                              UnwrapResult** result_out) {
+    if (!cluster) {
+        LOG_ERROR("unwrap_mesh_distributed: Invalid arguments");
+        return NULL;
+    }
+    ClusterSolver solver(cluster);
+    return uvunwrap::unwrap_mesh_with_solver(cluster->ctx, mesh, params, &solver, result_out);
+}
+
+#else
+
+UnwrapClusterWorker* unwrap_cluster_worker_start(const char*, int) {
+    LOG_ERROR("unwrap cluster: not supported on this platform");
+    return NULL;
+}
+
+void unwrap_cluster_worker_stop(UnwrapClusterWorker*) {}
+
+int unwrap_cluster_worker_port(const UnwrapClusterWorker*) { return 0; }
+
+long long unwrap_cluster_worker_islands(const UnwrapClusterWorker*) { return 0; }
+
+UnwrapCluster* unwrap_cluster_connect(const char* const*, int) { return NULL; }
+
+void unwrap_cluster_disconnect(UnwrapCluster*) {}
+
+int unwrap_cluster_num_workers(const UnwrapCluster*) { return 0; }
+
+Mesh* unwrap_mesh_distributed(UnwrapCluster*, const Mesh*, const UnwrapParams*, UnwrapResult**) {
+    return NULL;
+}
+
+#endif
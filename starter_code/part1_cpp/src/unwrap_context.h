@@ -0,0 +1,23 @@
+/**
+ * @file unwrap_context.h
+ * @brief Internal definition of UnwrapContext
+ *
+ * Not part of the public API; shared by unwrap.cpp and the async API,
+ * which runs its tasks on pooled contexts.
+ */
+
+#ifndef UVUNWRAP_UNWRAP_CONTEXT_H
+#define UVUNWRAP_UNWRAP_CONTEXT_H
+
+#include "unwrap.h"
+#include "arena.h"
+#include "logging.h"
+
+struct UnwrapContext {
+    uvunwrap::Arena arena;
+    uvunwrap::LogSink log;       /**< Installed for each call when log.callback is set */
+    int numa = UNWRAP_NUMA_NONE; /**< UnwrapNumaPolicy installed for each call unless NONE */
+    const volatile int* cancel = NULL; /**< Polled like UnwrapParams::cancel (an async task's flag) */
+};
+
+#endif /* UVUNWRAP_UNWRAP_CONTEXT_H */
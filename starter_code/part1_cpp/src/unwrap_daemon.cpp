@@ -0,0 +1,479 @@
+/**
+ * @file unwrap_daemon.cpp
+ * @brief uvunwrapd: Unix socket front end over a pool of warm unwrap workers
+ *
+ * Wire format: the client sends fixed-size Request records and reads one
+ * Response per request. Both sides are the same library build, so the
+ * records are plain structs in host byte order; the magic, version and
+ * UnwrapParams size catch a mismatched pair.
+ *
+ * One acceptor thread polls the listening socket and a wake-up pipe and
+ * queues accepted connections; each worker owns an UnwrapContext and an
+ * LscmPlan and serves one connection at a time until it closes.
+ */
+
+#include "unwrap_daemon.h"
+#include "lscm.h"
+#include "mesh_formats.h"
+#include "blocking_queue.h"
+#include "socket_io.h"
+#include "logging.h"
+#include "parallel.h"
+#include "timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+int unwrap_daemon_default_socket(char* buffer, int size) {
+    if (!buffer || size <= 0) return -1;
+    const char* runtime = getenv("XDG_RUNTIME_DIR");
+    int written;
+    if (runtime && runtime[0]) {
+        written = snprintf(buffer, (size_t)size, "%s/uvunwrapd.sock", runtime);
+    } else {
+#ifndef _WIN32
+        written = snprintf(buffer, (size_t)size, "/tmp/uvunwrapd-%u.sock", (unsigned)getuid());
+#else
+        written = snprintf(buffer, (size_t)size, "uvunwrapd.sock");
+#endif
+    }
+    return written > 0 && written < size ? 0 : -1;
+}
+
+#ifndef _WIN32
+
+using uvunwrap::read_all;
+using uvunwrap::write_all;
+
+namespace {
+
+const uint32_t PROTOCOL_MAGIC = 0x44575655;   // "UVWD"
+const uint32_t PROTOCOL_VERSION = 1;
+const int MAX_PATH_BYTES = 1024;
+const int LISTEN_BACKLOG = 64;
+
+// Request::flags
+const uint32_t REQUEST_WORKER_PLAN = 1;        // solve with the worker's LscmPlan
+
+struct Request {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t params_size;
+    uint32_t flags;
+    UnwrapParams params;         // pointer fields are meaningless here
+    char input[MAX_PATH_BYTES];
+    char output[MAX_PATH_BYTES];
+};
+
+struct Response {
+    uint32_t magic;
+    int32_t status;              // UnwrapBatchStatus
+    UnwrapBatchFileStats stats;
+};
+
+/** The socket path, or the default one; false if it does not fit sockaddr_un */
+bool socket_address(const char* path, std::string* resolved, sockaddr_un* addr) {
+    char buffer[sizeof(addr->sun_path)];
+    if (!path) {
+        if (unwrap_daemon_default_socket(buffer, (int)sizeof(buffer)) != 0) return false;
+        path = buffer;
+    }
+    if (strlen(path) >= sizeof(addr->sun_path)) {
+        LOG_ERROR("uvunwrapd: socket path too long: %s", path);
+        return false;
+    }
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    strcpy(addr->sun_path, path);
+    *resolved = path;
+    return true;
+}
+
+bool is_mesh_bin(const char* path) {
+    size_t len = strlen(path);
+    return len >= 5 && strcmp(path + len - 5, ".uvmb") == 0;
+}
+
+/** Directory for shared-memory handover files, with a trailing slash */
+std::string shared_directory() {
+    if (access("/dev/shm", W_OK) == 0) return "/dev/shm/";
+    const char* tmp = getenv("TMPDIR");
+    std::string dir = tmp && tmp[0] ? tmp : "/tmp";
+    if (dir[dir.size() - 1] != '/') dir += '/';
+    return dir;
+}
+
+/**
+ * Create a fresh 0700 directory under shared_directory() for one client's
+ * handover files, so other users can neither read them nor plant a
+ * symlink where they will be written. Empty string on failure.
+ */
+std::string private_shared_directory() {
+    std::string dir = shared_directory() + "uvunwrapd-XXXXXX";
+    if (!mkdtemp(&dir[0])) {
+        LOG_ERROR("uvunwrapd: cannot create a directory in %s: %s", shared_directory().c_str(), strerror(errno));
+        return std::string();
+    }
+    return dir + '/';
+}
+
+} // namespace
+
+struct UnwrapDaemon {
+    std::string path;
+    int listen_fd;
+    int wake[2];                 // written once by stop() to end the acceptor's poll
+    int threads_per_request;
+    std::thread acceptor;
+    std::vector<std::thread> workers;
+    uvunwrap::BlockingQueue<int> connections;
+    std::mutex mutex;
+    bool stopping;               // guarded by mutex
+    std::set<int> live;          // connections being served, guarded by mutex
+    std::atomic<long long> requests;
+
+    UnwrapDaemon() : listen_fd(-1), threads_per_request(1), connections(LISTEN_BACKLOG), stopping(false),
+                     requests(0) {
+        wake[0] = wake[1] = -1;
+    }
+};
+
+struct UnwrapDaemonClient {
+    int fd;
+    std::string shared_dir;      // private handover directory, made on first use
+    unsigned long long sequence;
+};
+
+namespace {
+
+/** One request, handled like a single file of unwrap_batch() */
+void serve_request(UnwrapDaemon* daemon, Request& req, UnwrapContext* ctx, LscmPlan* plan, Response* resp) {
+    memset(resp, 0, sizeof(*resp));
+    resp->magic = PROTOCOL_MAGIC;
+    UnwrapBatchFileStats& s = resp->stats;
+    req.input[MAX_PATH_BYTES - 1] = '\0';
+    req.output[MAX_PATH_BYTES - 1] = '\0';
+
+    UnwrapParams p = req.params;
+    p.lscm_plan = (req.flags & REQUEST_WORKER_PLAN) ? plan : NULL;
+    p.pinned_vertices = NULL;
+    p.num_pinned_vertices = 0;
+    p.seam_edges = NULL;
+    p.num_seam_edges = 0;
+    p.face_importance = NULL;
+    p.metrics_histograms = NULL;
+    p.progress = NULL;
+    p.progress_user_data = NULL;
+    p.cancel = NULL;
+    if (p.num_threads <= 0) p.num_threads = daemon->threads_per_request;
+
+    Mesh* obj = NULL;
+    MeshBin* bin = NULL;
+    long long t0 = uvunwrap::now_ns();
+    if (is_mesh_bin(req.input)) {
+        bin = load_mesh_bin(req.input, 1);
+    } else {
+        obj = load_mesh(req.input);
+    }
+    s.load_ns = uvunwrap::now_ns() - t0;
+    const Mesh* mesh = bin ? mesh_bin_mesh(bin) : obj;
+    if (!mesh) {
+        LOG_ERROR("uvunwrapd: could not load %s", req.input);
+        s.status = UNWRAP_BATCH_LOAD_FAILED;
+        resp->status = s.status;
+        return;
+    }
+    s.num_vertices = mesh->num_vertices;
+    s.num_triangles = mesh->num_triangles;
+
+    UnwrapResult* result = NULL;
+    t0 = uvunwrap::now_ns();
+    Mesh* unwrapped = unwrap_mesh_ctx(ctx, mesh, &p, &result);
+    s.unwrap_ns = uvunwrap::now_ns() - t0;
+    free_mesh(obj);
+    free_mesh_bin(bin);
+
+    if (!unwrapped) {
+        LOG_ERROR("uvunwrapd: unwrap failed for %s", req.input);
+        s.status = UNWRAP_BATCH_UNWRAP_FAILED;
+    } else {
+        t0 = uvunwrap::now_ns();
+        int rc = is_mesh_bin(req.output) ? save_mesh_bin(unwrapped, result, req.output, MESH_BIN_COMPRESSION_NONE)
+                                         : save_mesh(unwrapped, req.output);
+        s.save_ns = uvunwrap::now_ns() - t0;
+        if (rc != 0) {
+            LOG_ERROR("uvunwrapd: could not write %s", req.output);
+            s.status = UNWRAP_BATCH_SAVE_FAILED;
+        } else {
+            s.num_islands = result->num_islands;
+            s.avg_stretch = result->avg_stretch;
+            s.max_stretch = result->max_stretch;
+            s.coverage = result->coverage;
+            s.overlap = result->overlap;
+        }
+    }
+    free_unwrap_result(result);
+    free_mesh(unwrapped);
+    resp->status = s.status;
+}
+
+void accept_loop(UnwrapDaemon* daemon) {
+    pollfd fds[2];
+    fds[0].fd = daemon->listen_fd;
+    fds[0].events = POLLIN;
+    fds[1].fd = daemon->wake[0];
+    fds[1].events = POLLIN;
+    for (;;) {
+        fds[0].revents = fds[1].revents = 0;
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            LOG_ERROR("uvunwrapd: poll failed: %s", strerror(errno));
+            break;
+        }
+        if (fds[1].revents) break;
+        if (!(fds[0].revents & POLLIN)) continue;
+        int fd = accept(daemon->listen_fd, NULL, NULL);
+        if (fd < 0) {
+            if (errno != EINTR && errno != EAGAIN && errno != ECONNABORTED) {
+                LOG_WARNING("uvunwrapd: accept failed: %s", strerror(errno));
+            }
+            continue;
+        }
+        daemon->connections.push(fd);
+    }
+    daemon->connections.close();
+}
+
+void worker_loop(UnwrapDaemon* daemon) {
+    UnwrapContext* ctx = unwrap_context_create();
+    LscmPlan* plan = lscm_plan_create(0);
+    int fd;
+    while (daemon->connections.pop(&fd)) {
+        {
+            std::lock_guard<std::mutex> lock(daemon->mutex);
+            if (daemon->stopping) {
+                close(fd);
+                continue;
+            }
+            daemon->live.insert(fd);
+        }
+        Request req;
+        Response resp;
+        while (read_all(fd, &req, sizeof(req))) {
+            if (req.magic != PROTOCOL_MAGIC || req.version != PROTOCOL_VERSION ||
+                req.params_size != sizeof(UnwrapParams)) {
+                LOG_WARNING("uvunwrapd: dropping a client of another protocol or build");
+                break;
+            }
+            serve_request(daemon, req, ctx, plan, &resp);
+            daemon->requests.fetch_add(1);
+            if (!write_all(fd, &resp, sizeof(resp))) break;
+        }
+        {
+            std::lock_guard<std::mutex> lock(daemon->mutex);
+            daemon->live.erase(fd);
+        }
+        close(fd);
+    }
+    lscm_plan_free(plan);
+    unwrap_context_free(ctx);
+}
+
+} // namespace
+
+UnwrapDaemon* unwrap_daemon_start(const char* socket_path, int num_workers) {
+    sockaddr_un addr;
+    std::string path;
+    if (!socket_address(socket_path, &path, &addr)) return NULL;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        LOG_ERROR("uvunwrapd: socket failed: %s", strerror(errno));
+        return NULL;
+    }
+    // Replace a socket left behind by a daemon that died; never another file
+    struct stat st;
+    if (lstat(path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode)) unlink(path.c_str());
+    // Only the owner may connect: requests name files the daemon reads and writes.
+    // The mode is set before listen(), so no connection is accepted earlier
+    if (bind(fd, (sockaddr*)&addr, sizeof(addr)) != 0 || chmod(path.c_str(), 0600) != 0 ||
+        listen(fd, LISTEN_BACKLOG) != 0) {
+        LOG_ERROR("uvunwrapd: cannot listen on %s: %s", path.c_str(), strerror(errno));
+        close(fd);
+        return NULL;
+    }
+
+    UnwrapDaemon* daemon = new UnwrapDaemon();
+    if (pipe(daemon->wake) != 0) {
+        LOG_ERROR("uvunwrapd: pipe failed: %s", strerror(errno));
+        close(fd);
+        unlink(path.c_str());
+        delete daemon;
+        return NULL;
+    }
+    daemon->path = path;
+    daemon->listen_fd = fd;
+    int workers = uvunwrap::resolve_thread_count(num_workers);
+    daemon->threads_per_request = std::max(1, uvunwrap::resolve_thread_count(0) / workers);
+    daemon->acceptor = std::thread(accept_loop, daemon);
+    daemon->workers.reserve(workers);
+    for (int i = 0; i < workers; i++) daemon->workers.emplace_back(worker_loop, daemon);
+    LOG_INFO("uvunwrapd: listening on %s with %d workers", path.c_str(), workers);
+    return daemon;
+}
+
+void unwrap_daemon_stop(UnwrapDaemon* daemon) {
+    if (!daemon) return;
+    {
+        std::lock_guard<std::mutex> lock(daemon->mutex);
+        daemon->stopping = true;
+        // Idle clients block their worker in recv(); requests in flight
+        // finish and then fail to send their answer
+        for (int fd : daemon->live) shutdown(fd, SHUT_RDWR);
+    }
+    char byte = 0;
+    while (write(daemon->wake[1], &byte, 1) < 0 && errno == EINTR) {
+    }
+    daemon->acceptor.join();
+    for (size_t i = 0; i < daemon->workers.size(); i++) daemon->workers[i].join();
+
+    close(daemon->listen_fd);
+    close(daemon->wake[0]);
+    close(daemon->wake[1]);
+    unlink(daemon->path.c_str());
+    LOG_INFO("uvunwrapd: stopped after %lld requests", daemon->requests.load());
+    delete daemon;
+}
+
+long long unwrap_daemon_requests(const UnwrapDaemon* daemon) {
+    return daemon ? daemon->requests.load() : 0;
+}
+
+UnwrapDaemonClient* unwrap_daemon_connect(const char* socket_path) {
+    sockaddr_un addr;
+    std::string path;
+    if (!socket_address(socket_path, &path, &addr)) return NULL;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return NULL;
+    if (connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0) {
+        LOG_DEBUG("uvunwrapd: no daemon on %s: %s", path.c_str(), strerror(errno));
+        close(fd);
+        return NULL;
+    }
+    UnwrapDaemonClient* client = new UnwrapDaemonClient();
+    client->fd = fd;
+    client->sequence = 0;
+    return client;
+}
+
+void unwrap_daemon_disconnect(UnwrapDaemonClient* client) {
+    if (!client) return;
+    close(client->fd);
+    if (!client->shared_dir.empty()) rmdir(client->shared_dir.c_str());
+    delete client;
+}
+
+int unwrap_daemon_unwrap_file(UnwrapDaemonClient* client,
+                              const char* input_path,
+                              const char* output_path,
+                              const UnwrapParams* params,
+                              UnwrapBatchFileStats* stats_out) {
+    if (!client || !input_path || !output_path) return -1;
+    if (strlen(input_path) >= (size_t)MAX_PATH_BYTES || strlen(output_path) >= (size_t)MAX_PATH_BYTES) {
+        LOG_ERROR("uvunwrapd: path too long");
+        return -1;
+    }
+
+    Request req;
+    memset(&req, 0, sizeof(req));
+    req.magic = PROTOCOL_MAGIC;
+    req.version = PROTOCOL_VERSION;
+    req.params_size = sizeof(UnwrapParams);
+    if (params) {
+        req.params = *params;
+        if (params->lscm_plan) req.flags |= REQUEST_WORKER_PLAN;
+    } else {
+        unwrap_params_default(&req.params);
+    }
+    strcpy(req.input, input_path);
+    strcpy(req.output, output_path);
+
+    Response resp;
+    if (!write_all(client->fd, &req, sizeof(req)) || !read_all(client->fd, &resp, sizeof(resp)) ||
+        resp.magic != PROTOCOL_MAGIC) {
+        LOG_ERROR("uvunwrapd: lost the connection to the daemon");
+        return -1;
+    }
+    if (stats_out) *stats_out = resp.stats;
+    return resp.status;
+}
+
+MeshBin* unwrap_daemon_unwrap(UnwrapDaemonClient* client,
+                              const Mesh* mesh,
+                              const UnwrapParams* params,
+                              UnwrapBatchFileStats* stats_out) {
+    if (!client || !mesh) return NULL;
+    if (client->shared_dir.empty()) {
+        client->shared_dir = private_shared_directory();
+        if (client->shared_dir.empty()) return NULL;
+    }
+    char name[32];
+    snprintf(name, sizeof(name), "%llu", client->sequence++);
+    std::string input = client->shared_dir + name + "-in.uvmb";
+    std::string output = client->shared_dir + name + "-out.uvmb";
+
+    if (save_mesh_bin(mesh, NULL, input.c_str(), MESH_BIN_COMPRESSION_NONE) != 0) {
+        LOG_ERROR("uvunwrapd: could not write %s", input.c_str());
+        unlink(input.c_str());
+        return NULL;
+    }
+    int status = unwrap_daemon_unwrap_file(client, input.c_str(), output.c_str(), params, stats_out);
+    unlink(input.c_str());
+    // The mapping outlives the name; the daemon wrote the file, so skip the checksum pass
+    MeshBin* bin = status == UNWRAP_BATCH_OK ? load_mesh_bin(output.c_str(), 0) : NULL;
+    unlink(output.c_str());
+    return bin;
+}
+
+#else
+
+UnwrapDaemon* unwrap_daemon_start(const char*, int) {
+    LOG_ERROR("uvunwrapd: not supported on this platform");
+    return NULL;
+}
+
+void unwrap_daemon_stop(UnwrapDaemon*) {}
+
+long long unwrap_daemon_requests(const UnwrapDaemon*) { return 0; }
+
+UnwrapDaemonClient* unwrap_daemon_connect(const char*) { return NULL; }
+
+void unwrap_daemon_disconnect(UnwrapDaemonClient*) {}
+
+int unwrap_daemon_unwrap_file(UnwrapDaemonClient*, const char*, const char*, const UnwrapParams*,
+                              UnwrapBatchFileStats*) {
+    return -1;
+}
+
+MeshBin* unwrap_daemon_unwrap(UnwrapDaemonClient*, const Mesh*, const UnwrapParams*, UnwrapBatchFileStats*) {
+    return NULL;
+}
+
+#endif
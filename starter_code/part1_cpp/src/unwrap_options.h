@@ -0,0 +1,97 @@
+/**
+ * @file unwrap_options.h
+ * @brief Internal mapping from UnwrapParams to the solve and pack stages
+ *
+ * Not part of the public API. Shared by every pipeline that solves and
+ * packs islands (unwrap_mesh_ctx, sweeps, sessions) so they do it
+ * identically.
+ */
+
+#ifndef UVUNWRAP_UNWRAP_OPTIONS_H
+#define UVUNWRAP_UNWRAP_OPTIONS_H
+
+#include "unwrap.h"
+#include "lscm.h"
+#include "mesh_reorder.h"
+#include "packing.h"
+#include <stdlib.h>
+#include <vector>
+
+namespace uvunwrap {
+
+/** initial_uvs: existing per-vertex UVs that warm-start iterative solves (may be NULL) */
+inline void lscm_options_from_params(const UnwrapParams* params, const float* initial_uvs,
+                                     LscmOptions* options) {
+    lscm_options_default(options);
+    options->solver = params->solver;
+    options->iterative_threshold = params->cg_threshold;
+    options->cg_max_iterations = params->cg_max_iterations;
+    options->cg_tolerance = params->cg_tolerance;
+    options->cg_preconditioner = params->cg_preconditioner;
+    options->plan = params->lscm_plan;
+    options->initial_uvs = initial_uvs;
+    options->pin_method = params->pin_method;
+    options->pinned_vertices = params->pinned_vertices;
+    options->num_pinned_vertices = params->num_pinned_vertices;
+    options->precision = params->lscm_precision;
+    options->method = params->lscm_method;
+    options->arap_iterations = params->arap_iterations;
+    options->arap_time_limit = params->arap_time_limit;
+    options->ordering = params->lscm_ordering;
+    options->vertex_order = params->vertex_order;
+}
+
+/**
+ * Pack mesh->uvs as params asks (no-op without pack_islands); result
+ * needs num_islands and face_island_ids. Returns the UDIM tiles used.
+ */
+inline int pack_with_params(Mesh* mesh, UnwrapResult* result, const UnwrapParams* params) {
+    if (!params->pack_islands) return 0;
+    if (params->udim_tiles > 0 || params->texel_density > 0.0f) {
+        return pack_uv_islands_udim(mesh, result, params);
+    }
+    if (params->island_scale == ISLAND_SCALE_UNIFORM && result->num_islands > 1) {
+        scale_islands(mesh, result, params->face_importance, params->num_threads);
+    }
+    pack_islands(mesh, result, params->island_margin, params->pack_method, params->pack_rotation,
+                 params->sort_policy, params->num_threads);
+    return 0;
+}
+
+/**
+ * Renumber an output mesh as params->output_order asks. face_island_ids
+ * and vertex_remap move along and face_remap is set; mesh is freed and
+ * the reordered mesh returned. Returns mesh itself (face_remap NULL)
+ * for VERTEX_ORDER_INPUT.
+ */
+inline Mesh* apply_output_order(Mesh* mesh, UnwrapResult* result, const UnwrapParams* params) {
+    result->face_remap = NULL;
+    if (params->output_order == VERTEX_ORDER_INPUT || !mesh) return mesh;
+    int V = mesh->num_vertices;
+    int F = mesh->num_triangles;
+    std::vector<int> vertex_to_out(V), face_to_out(F);
+    Mesh* ordered = reorder_mesh(mesh, params->output_order, vertex_to_out.data(), face_to_out.data());
+    if (!ordered) return mesh;
+
+    int* ids = (int*)malloc((size_t)(F > 0 ? F : 1) * sizeof(int));
+    int* face_remap = (int*)malloc((size_t)(F > 0 ? F : 1) * sizeof(int));
+    for (int f = 0; f < F; f++) {
+        ids[face_to_out[f]] = result->face_island_ids[f];
+        face_remap[face_to_out[f]] = f;
+    }
+    int* vertex_remap = (int*)malloc((size_t)(V > 0 ? V : 1) * sizeof(int));
+    for (int v = 0; v < V; v++) {
+        vertex_remap[vertex_to_out[v]] = result->vertex_remap ? result->vertex_remap[v] : v;
+    }
+    free(result->face_island_ids);
+    free(result->vertex_remap);
+    result->face_island_ids = ids;
+    result->vertex_remap = vertex_remap;
+    result->face_remap = face_remap;
+    free_mesh(mesh);
+    return ordered;
+}
+
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_UNWRAP_OPTIONS_H */
@@ -0,0 +1,407 @@
+/**
+ * @file unwrap_session.cpp
+ * @brief Incremental unwrapping: re-solve only islands an edit touched
+ */
+
+#include "unwrap_session.h"
+#include "unwrap_options.h"
+#include "triangle_geometry.h"
+#include "parallel.h"
+#include "timer.h"
+#include "logging.h"
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+/** LSCM output of one island before packing, in local vertex order */
+struct IslandUvs {
+    std::vector<float> uvs;
+    std::vector<int> vertices;
+    int num_verts;               // -1 if not solved or failed
+};
+
+} // namespace
+
+struct UnwrapSession {
+    Mesh mesh;                   // owned copy; uvs kept only to warm-start CG
+    UnwrapParams params;
+    TopologyInfo* topo;
+    AdjacencyInfo* adj;
+    std::vector<unsigned char> is_seam;     // per edge
+    std::vector<unsigned char> moved_faces; // faces touching a vertex moved since the last unwrap
+    uvunwrap::TriangleGeometry geometry;    // frames of the current positions; moved faces refreshed per unwrap
+
+    // Frame sequences (unwrap_session_create_frames())
+    bool frames;
+    bool warm_start;
+    LscmPlan* own_plan;          // created by the first unwrap when params bring none
+
+    // Decomposition of the last unwrap (empty before the first)
+    IslandInfo* info;            // kept while the seams and positions stay as they are
+    bool seams_changed;
+    std::vector<int> face_island;
+    std::vector<int> island_sizes;
+    std::vector<IslandUvs> islands;
+};
+
+/** Edge between a and b, or -1 */
+static int find_edge(const UnwrapSession* s, int a, int b) {
+    if (a < 0 || b < 0 || a >= s->mesh.num_vertices || b >= s->mesh.num_vertices) return -1;
+    int lo = std::min(a, b);
+    int hi = std::max(a, b);
+    for (int k = s->adj->vert_edge_offsets[lo]; k < s->adj->vert_edge_offsets[lo + 1]; k++) {
+        int e = s->adj->vert_edges[k];
+        if (s->topo->edges[e * 2] == lo && s->topo->edges[e * 2 + 1] == hi) return e;
+    }
+    return -1;
+}
+
+UnwrapSession* unwrap_session_create(const Mesh* mesh, const UnwrapParams* params) {
+    if (!mesh) return NULL;
+
+    UnwrapSession* s = new UnwrapSession();
+    if (params) {
+        s->params = *params;
+    } else {
+        unwrap_params_default(&s->params);
+    }
+    Mesh* copy = allocate_mesh_copy(mesh);
+    s->mesh = *copy;
+    free(copy);
+    s->topo = NULL;
+    s->adj = NULL;
+    s->frames = false;
+    s->warm_start = false;
+    s->own_plan = NULL;
+    s->info = NULL;
+    s->seams_changed = false;
+    if (mesh->uvs) {
+        s->mesh.uvs = (float*)malloc((size_t)mesh->num_vertices * 2 * sizeof(float));
+        memcpy(s->mesh.uvs, mesh->uvs, (size_t)mesh->num_vertices * 2 * sizeof(float));
+    }
+    s->topo = build_topology(&s->mesh);
+    s->adj = s->topo ? build_adjacency(&s->mesh, s->topo) : NULL;
+    if (!s->adj) {
+        LOG_ERROR("unwrap_session_create: failed to build topology");
+        unwrap_session_free(s);
+        return NULL;
+    }
+    validate_topology(&s->mesh, s->topo);
+
+    // User seams are the session's starting seams; later edits replace them
+    int num_seams = 0;
+    int* seams = NULL;
+    if (s->params.seam_edges) {
+        int num_pairs = s->params.num_seam_edges > 0 ? s->params.num_seam_edges : 0;
+        seams = (int*)malloc((size_t)(num_pairs > 0 ? num_pairs : 1) * sizeof(int));
+        find_topology_edges(s->topo, s->params.seam_edges, num_pairs, seams);
+        for (int i = 0; i < num_pairs; i++) {
+            if (seams[i] >= 0) seams[num_seams++] = seams[i];
+        }
+        s->params.seam_edges = NULL;
+        s->params.num_seam_edges = 0;
+    } else {
+        seams = detect_seams_with_method(&s->mesh, s->topo, s->params.angle_threshold,
+                                         (SeamMethod)s->params.seam_method, &num_seams);
+    }
+    if (!seams) {
+        LOG_ERROR("unwrap_session_create: failed to detect seams");
+        unwrap_session_free(s);
+        return NULL;
+    }
+    s->is_seam.assign(s->topo->num_edges, 0);
+    for (int i = 0; i < num_seams; i++) s->is_seam[seams[i]] = 1;
+    free(seams);
+    s->moved_faces.assign(s->mesh.num_triangles, 0);
+    // ABF++ lays out its own frames
+    int geometry_parts = s->params.lscm_method != LSCM_METHOD_ABF ? uvunwrap::GEOMETRY_FRAMES : 0;
+    uvunwrap::build_triangle_geometry(&s->mesh, geometry_parts, s->params.num_threads, &s->geometry);
+    return s;
+}
+
+void unwrap_session_free(UnwrapSession* session) {
+    if (!session) return;
+    free(session->mesh.vertices);
+    free(session->mesh.triangles);
+    free(session->mesh.uvs);
+    free_adjacency(session->adj);
+    free_topology(session->topo);
+    free_islands(session->info);
+    lscm_plan_free(session->own_plan);
+    delete session;
+}
+
+UnwrapSession* unwrap_session_create_frames(const Mesh* mesh, const UnwrapParams* params, int warm_start) {
+    UnwrapSession* s = unwrap_session_create(mesh, params);
+    if (!s) return NULL;
+    s->frames = true;
+    s->warm_start = warm_start != 0;
+    return s;
+}
+
+int unwrap_session_set_seams(UnwrapSession* session,
+                             const int* edge_vertices,
+                             int num_edges,
+                             int is_seam) {
+    if (!session || (num_edges > 0 && !edge_vertices)) return -1;
+    int changed = 0;
+    for (int i = 0; i < num_edges; i++) {
+        int e = find_edge(session, edge_vertices[i * 2], edge_vertices[i * 2 + 1]);
+        if (e < 0) {
+            LOG_ERROR("unwrap_session_set_seams: (%d, %d) is not an edge",
+                      edge_vertices[i * 2], edge_vertices[i * 2 + 1]);
+            return -1;
+        }
+        unsigned char flag = is_seam ? 1 : 0;
+        if (session->is_seam[e] != flag) {
+            session->is_seam[e] = flag;
+            session->seams_changed = true;
+            changed++;
+        }
+    }
+    return changed;
+}
+
+int unwrap_session_get_seams(const UnwrapSession* session, int* edge_vertices_out, int capacity) {
+    if (!session) return 0;
+    int count = 0;
+    for (int e = 0; e < session->topo->num_edges; e++) {
+        if (!session->is_seam[e]) continue;
+        if (edge_vertices_out && count < capacity) {
+            edge_vertices_out[count * 2] = session->topo->edges[e * 2];
+            edge_vertices_out[count * 2 + 1] = session->topo->edges[e * 2 + 1];
+        }
+        count++;
+    }
+    return count;
+}
+
+int unwrap_session_move_vertices(UnwrapSession* session,
+                                 const int* indices,
+                                 const float* positions,
+                                 int count) {
+    if (!session || (count > 0 && (!indices || !positions))) return -1;
+    for (int i = 0; i < count; i++) {
+        int v = indices[i];
+        if (v < 0 || v >= session->mesh.num_vertices) {
+            LOG_ERROR("unwrap_session_move_vertices: vertex %d out of range", v);
+            return -1;
+        }
+        memcpy(&session->mesh.vertices[v * 3], &positions[i * 3], 3 * sizeof(float));
+        for (int k = session->adj->vert_face_offsets[v]; k < session->adj->vert_face_offsets[v + 1]; k++) {
+            session->moved_faces[session->adj->vert_faces[k]] = 1;
+        }
+    }
+    return 0;
+}
+
+int unwrap_session_set_frame(UnwrapSession* session, const float* positions) {
+    if (!session || !positions) return -1;
+    float* P = session->mesh.vertices;
+    for (int v = 0; v < session->mesh.num_vertices; v++) {
+        if (memcmp(&P[v * 3], &positions[v * 3], 3 * sizeof(float)) == 0) continue;
+        memcpy(&P[v * 3], &positions[v * 3], 3 * sizeof(float));
+        for (int k = session->adj->vert_face_offsets[v]; k < session->adj->vert_face_offsets[v + 1]; k++) {
+            session->moved_faces[session->adj->vert_faces[k]] = 1;
+        }
+    }
+    return 0;
+}
+
+Mesh* unwrap_session_unwrap(UnwrapSession* session, UnwrapResult** result_out) {
+    if (!session || !result_out) {
+        LOG_ERROR("unwrap_session_unwrap: Invalid arguments");
+        return NULL;
+    }
+    long long start_ns = uvunwrap::now_ns();
+    const Mesh* mesh = &session->mesh;
+    const UnwrapParams* params = &session->params;
+    UnwrapStats stats;
+    memset(&stats, 0, sizeof(stats));
+
+    // 0. Bring the cached frames up to date with the moved vertices
+    std::vector<int> moved;
+    for (int f = 0; f < mesh->num_triangles; f++) {
+        if (session->moved_faces[f]) moved.push_back(f);
+    }
+    uvunwrap::update_triangle_geometry(mesh, moved.data(), (int)moved.size(), params->num_threads,
+                                       &session->geometry);
+
+    // 1. Islands under the current seams, kept until they change. Closed
+    //    islands are opened along their normals, so moves redo them too,
+    //    except in a frame sequence, whose islands stay those of frame 0
+    long long stage_ns = uvunwrap::now_ns();
+    if (!session->info || session->seams_changed || (!moved.empty() && !session->frames)) {
+        std::vector<int> seams;
+        for (int e = 0; e < session->topo->num_edges; e++) {
+            if (session->is_seam[e]) seams.push_back(e);
+        }
+        IslandInfo* fresh = extract_islands(mesh, session->topo, seams.data(), (int)seams.size());
+        if (!fresh) return NULL;
+        free_islands(session->info);
+        session->info = fresh;
+        session->seams_changed = false;
+    }
+    IslandInfo* info = session->info;
+    int num_islands = info->num_islands;
+    stats.islands_ns = uvunwrap::now_ns() - stage_ns;
+
+    // A frame sequence keeps frame 0's pins, orderings and symbolic
+    // factorisations in a plan; later frames only refactor numerically
+    if (session->frames && !session->params.lscm_plan) {
+        session->own_plan = lscm_plan_create(std::max(256, num_islands));
+        session->params.lscm_plan = session->own_plan;
+    }
+
+    // 2. Reuse an island's UVs when it is exactly an old island (same
+    //    faces: all came from one old island of the same size) and none
+    //    of its vertices moved
+    stage_ns = uvunwrap::now_ns();
+    std::vector<IslandUvs> islands(num_islands);
+    std::vector<int> solve_order;
+    std::vector<int> previous(num_islands, -1);  // the same island's last UVs, to warm-start from
+    for (int id = 0; id < num_islands; id++) {
+        const int* faces = &info->island_faces[info->island_face_offsets[id]];
+        int count = info->island_face_offsets[id + 1] - info->island_face_offsets[id];
+        stats.peak_island_faces = std::max(stats.peak_island_faces, count);
+        islands[id].num_verts = -1;
+        if (count < params->min_island_faces) continue;
+
+        bool reuse = !session->face_island.empty();
+        int old = reuse ? session->face_island[faces[0]] : -1;
+        reuse = reuse && session->island_sizes[old] == count && session->islands[old].num_verts >= 0;
+        for (int i = 0; i < count && reuse; i++) {
+            reuse = session->face_island[faces[i]] == old && !session->moved_faces[faces[i]];
+        }
+        if (reuse) {
+            islands[id] = std::move(session->islands[old]);
+            continue;
+        }
+        if (old >= 0 && session->island_sizes[old] == count && session->islands[old].num_verts >= 0) {
+            previous[id] = old;
+        }
+        islands[id].uvs.resize((size_t)count * 6);
+        islands[id].vertices.resize((size_t)count * 3);
+        solve_order.push_back(id);
+    }
+    std::stable_sort(solve_order.begin(), solve_order.end(), [&](int a, int b) {
+        return info->island_face_offsets[a + 1] - info->island_face_offsets[a] >
+               info->island_face_offsets[b + 1] - info->island_face_offsets[b];
+    });
+
+    int num_solves = (int)solve_order.size();
+    int num_workers = std::max(1, std::min(uvunwrap::resolve_thread_count(params->num_threads), num_solves));
+    std::vector<int> vertex_remaps((size_t)num_workers * mesh->num_vertices, -1);
+    std::vector<LscmReport> reports(num_solves);
+    stats.island_solve_ns = (long long*)calloc(num_islands > 0 ? num_islands : 1, sizeof(long long));
+    LscmOptions lscm_options;
+    uvunwrap::lscm_options_from_params(params, mesh->uvs, &lscm_options);
+    long long total_faces = 0;
+    for (int k = 0; k < num_solves; k++) {
+        total_faces += info->island_face_offsets[solve_order[k] + 1] - info->island_face_offsets[solve_order[k]];
+    }
+
+    // Warm starts scatter the previous frame's island UVs into a
+    // mesh-sized buffer per worker; the solve reads only its island
+    std::vector<std::vector<float> > warm_uvs(session->warm_start ? num_workers : 0);
+
+    uvunwrap::parallel_for_dynamic(num_solves, num_workers, [&](int worker, int k) {
+        int id = solve_order[k];
+        long long island_start = uvunwrap::now_ns();
+        int num_faces = info->island_face_offsets[id + 1] - info->island_face_offsets[id];
+        LscmOptions options = lscm_options;
+        // As in unwrap_mesh(), an island with most of the faces is assembled by every core
+        if (2LL * num_faces > total_faces) options.num_threads = uvunwrap::resolve_thread_count(params->num_threads);
+        if (session->warm_start && previous[id] >= 0) {
+            const IslandUvs& last = session->islands[previous[id]];
+            std::vector<float>& warm = warm_uvs[worker];
+            warm.resize((size_t)mesh->num_vertices * 2);
+            for (int v = 0; v < last.num_verts; v++) {
+                warm[last.vertices[v] * 2 + 0] = last.uvs[v * 2 + 0];
+                warm[last.vertices[v] * 2 + 1] = last.uvs[v * 2 + 1];
+            }
+            options.initial_uvs = warm.data();
+        }
+        islands[id].num_verts = uvunwrap::lscm_parameterize_geometry(
+            mesh, &info->island_faces[info->island_face_offsets[id]], num_faces, &options, &reports[k],
+            islands[id].uvs.data(), islands[id].vertices.data(),
+            &vertex_remaps[(size_t)worker * mesh->num_vertices], &session->geometry, NULL);
+        stats.island_solve_ns[id] = uvunwrap::now_ns() - island_start;
+    });
+
+    // Write back in island order, as unwrap_mesh() does
+    Mesh* result = allocate_mesh_copy(mesh);
+    result->uvs = (float*)calloc((size_t)mesh->num_vertices * 2, sizeof(float));
+    for (int id = 0; id < num_islands; id++) {
+        const IslandUvs& island = islands[id];
+        for (int v = 0; v < island.num_verts; v++) {
+            result->uvs[island.vertices[v] * 2 + 0] = island.uvs[v * 2 + 0];
+            result->uvs[island.vertices[v] * 2 + 1] = island.uvs[v * 2 + 1];
+        }
+    }
+    stats.lscm_ns = uvunwrap::now_ns() - stage_ns;
+
+    // 3. Repack and measure everything
+    stage_ns = uvunwrap::now_ns();
+    UnwrapResult temp_result;
+    temp_result.num_islands = num_islands;
+    temp_result.face_island_ids = info->face_island_ids;
+    temp_result.coverage = 0.0f;
+    int num_tiles = uvunwrap::pack_with_params(result, &temp_result, params);
+    stats.packing_ns = uvunwrap::now_ns() - stage_ns;
+
+    stage_ns = uvunwrap::now_ns();
+    UnwrapResult* result_data = (UnwrapResult*)malloc(sizeof(UnwrapResult));
+    result_data->num_islands = num_islands;
+    result_data->vertex_remap = NULL;
+    result_data->face_island_ids = (int*)malloc((mesh->num_triangles > 0 ? mesh->num_triangles : 1) * sizeof(int));
+    memcpy(result_data->face_island_ids, info->face_island_ids, (size_t)mesh->num_triangles * sizeof(int));
+    compute_quality_metrics_with_histograms(result, result_data, NULL, params->metrics_histograms,
+                                            params->num_threads, params->compute_backend);
+    result_data->num_tiles = num_tiles;
+    stats.metrics_ns = uvunwrap::now_ns() - stage_ns;
+
+    result_data->solver_iterations = 0;
+    result_data->solver_residual = 0.0f;
+    for (int k = 0; k < num_solves; k++) {
+        result_data->solver_iterations = std::max(result_data->solver_iterations, reports[k].iterations);
+        result_data->solver_residual = std::max(result_data->solver_residual, (float)reports[k].residual);
+        if (islands[solve_order[k]].num_verts < 0) {
+            LOG_ERROR("  LSCM failed for island %d", solve_order[k]);
+            continue;
+        }
+        stats.num_solved_islands++;
+        if (reports[k].fallback != LSCM_FALLBACK_NONE) stats.num_fallback_islands++;
+        if (reports[k].dense) stats.num_dense_islands++;
+        if (reports[k].closed_form != LSCM_CLOSED_FORM_NONE) stats.num_closed_form_islands++;
+        stats.lscm_assembly_ns += reports[k].assembly_ns;
+        stats.lscm_factor_ns += reports[k].factor_ns;
+        stats.lscm_solve_ns += reports[k].solve_ns;
+        stats.matrix_nonzeros += reports[k].matrix_nonzeros;
+        stats.factor_nonzeros += reports[k].factor_nonzeros;
+        stats.solver_iterations += reports[k].iterations;
+    }
+    for (int id = 0; id < num_islands; id++) {
+        stats.peak_island_vertices = std::max(stats.peak_island_vertices, islands[id].num_verts);
+    }
+
+    // 4. This decomposition is the baseline for the next call
+    session->face_island.assign(info->face_island_ids, info->face_island_ids + mesh->num_triangles);
+    session->island_sizes.resize(num_islands);
+    for (int id = 0; id < num_islands; id++) {
+        session->island_sizes[id] = info->island_face_offsets[id + 1] - info->island_face_offsets[id];
+    }
+    session->islands.swap(islands);
+    std::fill(session->moved_faces.begin(), session->moved_faces.end(), 0);
+
+    result = uvunwrap::apply_output_order(result, result_data, params);
+
+    stats.total_ns = uvunwrap::now_ns() - start_ns;
+    result_data->stats = stats;
+    *result_out = result_data;
+    LOG_INFO("unwrap_session: %d islands, %d solved", num_islands, stats.num_solved_islands);
+    return result;
+}
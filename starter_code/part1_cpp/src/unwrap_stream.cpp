@@ -0,0 +1,344 @@
+/**
+ * @file unwrap_stream.cpp
+ * @brief Out-of-core unwrapping: spatial chunks streamed through unwrap_mesh_ctx
+ */
+
+#include "unwrap_stream.h"
+#include "mesh_bin_writer.h"
+#include "logging.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+
+static const long long DEFAULT_STREAM_BUDGET = 1LL << 30;
+
+// Peak unwrap working set per face, measured at 1.7-2.2 KB for single
+// LDLT islands of 20k-180k faces, rounded up for headroom
+static const long long STREAM_BYTES_PER_FACE = 2560;
+
+// Grid cells per chunk: finer cells let the greedy grouping follow the
+// budget more closely at the cost of a larger cell table
+static const int STREAM_CELLS_PER_CHUNK = 8;
+static const int STREAM_MAX_CELLS_PER_AXIS = 1024;
+static const int UDIM_TILES_PER_ROW = 10;
+
+static uint64_t spread_bits(uint64_t x) {
+    x &= 0x3ff;
+    x = (x | (x << 16)) & 0x30000ff;
+    x = (x | (x << 8)) & 0x300f00f;
+    x = (x | (x << 4)) & 0x30c30c3;
+    x = (x | (x << 2)) & 0x9249249;
+    return x;
+}
+
+static uint64_t morton_key(int x, int y, int z) {
+    return spread_bits(x) | (spread_bits(y) << 1) | (spread_bits(z) << 2);
+}
+
+/**
+ * @brief Cells per axis so the grid has about target_cells cells
+ *
+ * Axes of zero extent (flat scans) get a single cell.
+ */
+static void choose_grid(const float extent[3], long long target_cells, int dims[3]) {
+    float longest = std::max(extent[0], std::max(extent[1], extent[2]));
+    if (longest <= 0.0f || target_cells <= 1) {
+        dims[0] = dims[1] = dims[2] = 1;
+        return;
+    }
+
+    // Bisect the cell size: the cell count falls as the size grows
+    double lo = longest / (double)STREAM_MAX_CELLS_PER_AXIS, hi = longest;
+    for (int iter = 0; iter < 60; iter++) {
+        double size = 0.5 * (lo + hi);
+        long long cells = 1;
+        for (int a = 0; a < 3; a++) cells *= std::max(1LL, (long long)ceil(extent[a] / size));
+        if (cells > target_cells) lo = size;
+        else hi = size;
+    }
+    for (int a = 0; a < 3; a++) {
+        long long d = std::max(1LL, (long long)ceil(extent[a] / hi));
+        dims[a] = (int)std::min<long long>(d, STREAM_MAX_CELLS_PER_AXIS);
+    }
+}
+
+/**
+ * @brief Group faces into spatially coherent chunks of at most budget_faces
+ *
+ * Faces are bucketed by centroid, the non-empty cells sorted in Morton
+ * order and greedily concatenated. A single cell over budget becomes its
+ * own chunk.
+ */
+static void partition_faces(const Mesh* mesh, int budget_faces,
+                            std::vector<int>& chunk_offsets, std::vector<int>& chunk_faces) {
+    int nt = mesh->num_triangles;
+    chunk_offsets.assign(1, 0);
+    chunk_faces.resize(nt);
+
+    if (nt <= budget_faces) {
+        for (int f = 0; f < nt; f++) chunk_faces[f] = f;
+        chunk_offsets.push_back(nt);
+        return;
+    }
+
+    float lo[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+    float hi[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    auto centroid = [&](int f, float c[3]) {
+        const int* tri = &mesh->triangles[f * 3];
+        for (int a = 0; a < 3; a++) {
+            c[a] = (mesh->vertices[tri[0] * 3 + a] + mesh->vertices[tri[1] * 3 + a] +
+                    mesh->vertices[tri[2] * 3 + a]) / 3.0f;
+        }
+    };
+    for (int f = 0; f < nt; f++) {
+        float c[3];
+        centroid(f, c);
+        for (int a = 0; a < 3; a++) {
+            lo[a] = std::min(lo[a], c[a]);
+            hi[a] = std::max(hi[a], c[a]);
+        }
+    }
+
+    float extent[3] = {hi[0] - lo[0], hi[1] - lo[1], hi[2] - lo[2]};
+    long long per_cell = std::max(1, budget_faces / STREAM_CELLS_PER_CHUNK);
+    int dims[3];
+    choose_grid(extent, (nt + per_cell - 1) / per_cell, dims);
+    int num_cells = dims[0] * dims[1] * dims[2];
+
+    // Cell of every face, then a CSR of faces per cell (file order kept)
+    std::vector<int> face_cell(nt);
+    std::vector<int> cell_offsets(num_cells + 1, 0);
+    for (int f = 0; f < nt; f++) {
+        float c[3];
+        centroid(f, c);
+        int idx[3];
+        for (int a = 0; a < 3; a++) {
+            int i = extent[a] > 0.0f ? (int)((c[a] - lo[a]) / extent[a] * dims[a]) : 0;
+            idx[a] = std::min(std::max(i, 0), dims[a] - 1);
+        }
+        face_cell[f] = (idx[2] * dims[1] + idx[1]) * dims[0] + idx[0];
+        cell_offsets[face_cell[f] + 1]++;
+    }
+    for (int c = 0; c < num_cells; c++) cell_offsets[c + 1] += cell_offsets[c];
+    std::vector<int> cell_faces(nt);
+    {
+        std::vector<int> cursor(cell_offsets.begin(), cell_offsets.end() - 1);
+        for (int f = 0; f < nt; f++) cell_faces[cursor[face_cell[f]]++] = f;
+    }
+    std::vector<int>().swap(face_cell);
+
+    std::vector<std::pair<uint64_t, int> > cells;
+    for (int c = 0; c < num_cells; c++) {
+        if (cell_offsets[c + 1] == cell_offsets[c]) continue;
+        int x = c % dims[0], y = (c / dims[0]) % dims[1], z = c / (dims[0] * dims[1]);
+        cells.push_back(std::make_pair(morton_key(x, y, z), c));
+    }
+    std::sort(cells.begin(), cells.end());
+
+    int written = 0;
+    int chunk_size = 0;
+    for (size_t i = 0; i < cells.size(); i++) {
+        int c = cells[i].second;
+        int count = cell_offsets[c + 1] - cell_offsets[c];
+        if (chunk_size > 0 && chunk_size + count > budget_faces) {
+            chunk_offsets.push_back(written);
+            chunk_size = 0;
+        }
+        memcpy(&chunk_faces[written], &cell_faces[cell_offsets[c]], count * sizeof(int));
+        written += count;
+        chunk_size += count;
+    }
+    chunk_offsets.push_back(written);
+}
+
+int unwrap_mesh_bin_streaming(const char* input_path,
+                              const char* output_path,
+                              const UnwrapParams* params,
+                              long long memory_budget,
+                              UnwrapStreamStats* stats_out) {
+    if (!input_path || !output_path) return -1;
+
+    UnwrapParams defaults;
+    if (!params) {
+        unwrap_params_default(&defaults);
+        params = &defaults;
+    }
+    long long budget = memory_budget > 0 ? memory_budget : DEFAULT_STREAM_BUDGET;
+    int budget_faces = (int)std::min<long long>(std::max(1LL, budget / STREAM_BYTES_PER_FACE), 0x7fffffff);
+
+    // Verified: the partition and the vertex remap index with the file's triangles
+    MeshBin* input = load_mesh_bin(input_path, 1);
+    if (!input) return -1;
+    const Mesh* mesh = mesh_bin_mesh(input);
+    int nv = mesh->num_vertices;
+    int nt = mesh->num_triangles;
+
+    LOG_INFO("=== Streaming UV Unwrap ===");
+    std::vector<int> chunk_offsets, chunk_faces;
+    partition_faces(mesh, budget_faces, chunk_offsets, chunk_faces);
+    int num_chunks = (int)chunk_offsets.size() - 1;
+    LOG_INFO("  %d faces in %d chunks (budget %d faces per chunk)", nt, num_chunks, budget_faces);
+
+    // A vertex keeps its index in the first chunk that uses it; every later
+    // chunk gets a copy appended after the input vertices, as
+    // UV_OUTPUT_SPLIT_VERTICES splits seams, so each chunk's faces keep
+    // that chunk's UVs and UDIM tile
+    std::vector<int> owner(num_chunks > 1 ? nv : 0, -1);
+    std::vector<int> remap(num_chunks > 1 ? nv : 0, -1);
+    long long out_vertices = nv;
+    for (int k = 0; k < num_chunks && num_chunks > 1; k++) {
+        for (int i = chunk_offsets[k]; i < chunk_offsets[k + 1]; i++) {
+            for (int j = 0; j < 3; j++) {
+                int v = mesh->triangles[chunk_faces[i] * 3 + j];
+                if (owner[v] < 0) {
+                    owner[v] = k;
+                } else if (owner[v] != k && remap[v] != k) {
+                    remap[v] = k;
+                    out_vertices++;
+                }
+            }
+        }
+    }
+    std::fill(remap.begin(), remap.end(), -1);
+    if (out_vertices > 0x7fffffff) {
+        LOG_ERROR("unwrap_mesh_bin_streaming: %lld vertices after splitting chunk borders", out_vertices);
+        free_mesh_bin(input);
+        return -1;
+    }
+    LOG_INFO("  %lld border vertices copied", out_vertices - nv);
+
+    uvunwrap::MeshBinWriter writer;
+    if (!writer.open(output_path, (int)out_vertices, nt, true, true)) {
+        free_mesh_bin(input);
+        return -1;
+    }
+    float* out_positions = writer.vertices();
+    int* out_triangles = writer.triangles();
+    memcpy(out_positions, mesh->vertices, (size_t)nv * 3 * sizeof(float));
+    if (num_chunks == 1) memcpy(out_triangles, mesh->triangles, (size_t)nt * 3 * sizeof(int));
+    float* out_uvs = writer.uvs();
+    int* out_island_ids = writer.face_island_ids();
+    int next_copy = nv;
+
+    UnwrapResult total;
+    memset(&total, 0, sizeof(total));
+    double stretch_sum = 0.0;
+    double coverage_sum = 0.0;
+    int max_chunk_faces = 0;
+    bool udim = params->pack_islands && num_chunks > 1;
+    // Vertices are split only at chunk borders
+    UnwrapParams chunk_params = *params;
+    chunk_params.uv_output = UV_OUTPUT_SHARED;
+    bool ok = true;
+
+    UnwrapContext* ctx = unwrap_context_create();
+    std::vector<int> local_to_global;
+    std::vector<int> local_to_output;
+    std::vector<float> sub_vertices;
+    std::vector<int> sub_triangles;
+    std::vector<float> sub_importance;
+
+    for (int k = 0; k < num_chunks && ok; k++) {
+        const int* faces = &chunk_faces[chunk_offsets[k]];
+        int count = chunk_offsets[k + 1] - chunk_offsets[k];
+        max_chunk_faces = std::max(max_chunk_faces, count);
+        LOG_INFO("--- Chunk %d/%d: %d faces ---", k + 1, num_chunks, count);
+
+        // One chunk is the whole mesh: unwrap it as is
+        Mesh sub;
+        if (num_chunks == 1) {
+            sub = *mesh;
+            sub.uvs = NULL;
+        } else {
+            local_to_global.clear();
+            local_to_output.clear();
+            sub_vertices.clear();
+            sub_triangles.resize((size_t)count * 3);
+            for (int i = 0; i < count; i++) {
+                for (int j = 0; j < 3; j++) {
+                    int v = mesh->triangles[faces[i] * 3 + j];
+                    if (remap[v] < 0) {
+                        remap[v] = (int)local_to_global.size();
+                        local_to_global.push_back(v);
+                        int out = owner[v] == k ? v : next_copy++;
+                        local_to_output.push_back(out);
+                        if (out != v) memcpy(&out_positions[(size_t)out * 3], &mesh->vertices[v * 3], 3 * sizeof(float));
+                        sub_vertices.insert(sub_vertices.end(), &mesh->vertices[v * 3], &mesh->vertices[v * 3 + 3]);
+                    }
+                    sub_triangles[i * 3 + j] = remap[v];
+                    out_triangles[faces[i] * 3 + j] = local_to_output[remap[v]];
+                }
+            }
+            for (size_t i = 0; i < local_to_global.size(); i++) remap[local_to_global[i]] = -1;
+
+            sub.vertices = sub_vertices.data();
+            sub.num_vertices = (int)local_to_global.size();
+            sub.triangles = sub_triangles.data();
+            sub.num_triangles = count;
+            sub.uvs = NULL;
+
+            // Face weights follow their faces into the chunk
+            if (params->face_importance) {
+                sub_importance.resize((size_t)count);
+                for (int i = 0; i < count; i++) sub_importance[i] = params->face_importance[faces[i]];
+                chunk_params.face_importance = sub_importance.data();
+            }
+        }
+
+        UnwrapResult* result = NULL;
+        Mesh* unwrapped = unwrap_mesh_ctx(ctx, &sub, &chunk_params, &result);
+        if (!unwrapped) {
+            LOG_ERROR("unwrap_mesh_bin_streaming: chunk %d failed", k);
+            ok = false;
+            break;
+        }
+
+        float du = udim ? (float)(k % UDIM_TILES_PER_ROW) : 0.0f;
+        float dv = udim ? (float)(k / UDIM_TILES_PER_ROW) : 0.0f;
+        for (int i = 0; i < sub.num_vertices; i++) {
+            int v = num_chunks == 1 ? i : local_to_output[i];
+            out_uvs[v * 2 + 0] = unwrapped->uvs[i * 2 + 0] + du;
+            out_uvs[v * 2 + 1] = unwrapped->uvs[i * 2 + 1] + dv;
+        }
+        for (int i = 0; i < count; i++) {
+            out_island_ids[faces[i]] = result->face_island_ids[i] + total.num_islands;
+        }
+
+        total.num_islands += result->num_islands;
+        total.max_stretch = std::max(total.max_stretch, result->max_stretch);
+        total.solver_iterations = std::max(total.solver_iterations, result->solver_iterations);
+        total.solver_residual = std::max(total.solver_residual, result->solver_residual);
+        stretch_sum += (double)result->avg_stretch * count;
+        coverage_sum += result->coverage;
+
+        free_unwrap_result(result);
+        free_mesh(unwrapped);
+    }
+    unwrap_context_free(ctx);
+
+    if (ok) {
+        total.avg_stretch = nt > 0 ? (float)(stretch_sum / nt) : 0.0f;
+        total.coverage = num_chunks > 0 ? (float)(coverage_sum / num_chunks) : 0.0f;
+        if (!writer.finish(&total)) {
+            LOG_ERROR("Cannot write file: %s", output_path);
+            ok = false;
+        }
+    }
+    free_mesh_bin(input);
+
+    if (stats_out) {
+        stats_out->num_chunks = num_chunks;
+        stats_out->max_chunk_faces = max_chunk_faces;
+        stats_out->budget_faces = budget_faces;
+        stats_out->num_islands = total.num_islands;
+    }
+
+    if (!ok) return -1;
+    LOG_INFO("=== Streaming Unwrap Complete: %d islands ===", total.num_islands);
+    return 0;
+}
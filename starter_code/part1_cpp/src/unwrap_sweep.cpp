@@ -0,0 +1,218 @@
+/**
+ * @file unwrap_sweep.cpp
+ * @brief Parameter sweeps sharing topology, seams and island solves
+ */
+
+#include "unwrap_sweep.h"
+#include "unwrap_options.h"
+#include "half_edge.h"
+#include "parallel.h"
+#include "timer.h"
+#include "logging.h"
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+/** Seams and islands for one distinct angle_threshold */
+struct SeamSet {
+    float angle;
+    int* seams;
+    int num_seams;
+    int canonical;               // earlier set with identical seams, or itself
+    IslandInfo* islands;         // canonical sets only
+    int min_faces;               // smallest min_island_faces that uses this set
+    std::vector<float*> uvs;     // per island; NULL if not solved
+    std::vector<int*> vertices;
+    std::vector<int> num_verts;  // -1 if unsolved or failed
+};
+
+int island_size(const IslandInfo* islands, int id) {
+    return islands->island_face_offsets[id + 1] - islands->island_face_offsets[id];
+}
+
+} // namespace
+
+int unwrap_sweep(const Mesh* mesh,
+                 const UnwrapParams* base,
+                 const UnwrapSweepPoint* points,
+                 int n,
+                 UnwrapSweepResult* results_out,
+                 UnwrapSweepStats* stats_out) {
+    if (!mesh || n < 0 || (n > 0 && (!points || !results_out))) return -1;
+    long long start_ns = uvunwrap::now_ns();
+
+    UnwrapParams defaults;
+    if (!base) {
+        unwrap_params_default(&defaults);
+        base = &defaults;
+    }
+    int threads = uvunwrap::resolve_thread_count(base->num_threads);
+
+    uvunwrap::HalfEdgeMesh half_edges;
+    TopologyInfo* topo = uvunwrap::build_half_edge_mesh(mesh, &half_edges, base->num_threads, NULL,
+                                                        base->sort_policy)
+                             ? uvunwrap::topology_from_half_edges(half_edges, base->num_threads)
+                             : NULL;
+    if (!topo) {
+        LOG_ERROR("unwrap_sweep: failed to build topology");
+        return -1;
+    }
+    validate_topology(mesh, topo);
+
+    // 1. Distinct angles, in first-seen order
+    std::vector<SeamSet> sets;
+    std::vector<int> point_set(n);
+    for (int i = 0; i < n; i++) {
+        int s = 0;
+        while (s < (int)sets.size() && sets[s].angle != points[i].angle_threshold) s++;
+        if (s == (int)sets.size()) {
+            SeamSet set;
+            set.angle = points[i].angle_threshold;
+            set.seams = NULL;
+            set.num_seams = 0;
+            set.canonical = s;
+            set.islands = NULL;
+            set.min_faces = points[i].min_island_faces;
+            sets.push_back(set);
+        }
+        point_set[i] = s;
+    }
+    int num_sets = (int)sets.size();
+
+    uvunwrap::parallel_for_dynamic(num_sets, std::min(threads, num_sets), [&](int, int s) {
+        sets[s].seams = uvunwrap::detect_seams_half_edge(mesh, topo, half_edges, sets[s].angle,
+                                                         base->seam_method, &sets[s].num_seams);
+    });
+
+    // 2. Angles that cut the same seams share islands and solves
+    bool ok = true;
+    int num_seam_sets = 0;
+    for (int s = 0; s < num_sets && ok; s++) {
+        SeamSet& set = sets[s];
+        if (!set.seams) {
+            LOG_ERROR("unwrap_sweep: seam detection failed at %.1f°", set.angle);
+            ok = false;
+            break;
+        }
+        for (int t = 0; t < s; t++) {
+            if (sets[t].canonical == t && sets[t].num_seams == set.num_seams &&
+                memcmp(sets[t].seams, set.seams, set.num_seams * sizeof(int)) == 0) {
+                set.canonical = t;
+                break;
+            }
+        }
+        if (set.canonical != s) continue;
+        num_seam_sets++;
+        set.islands = extract_islands(mesh, topo, set.seams, set.num_seams);
+        if (!set.islands) ok = false;
+    }
+    for (int i = 0; i < n && ok; i++) {
+        SeamSet& set = sets[sets[point_set[i]].canonical];
+        set.min_faces = std::min(set.min_faces, points[i].min_island_faces);
+    }
+
+    // 3. Solve every island any combination keeps, largest first
+    std::vector<std::pair<int, int> > solves;
+    for (int s = 0; s < num_sets && ok; s++) {
+        SeamSet& set = sets[s];
+        if (set.canonical != s) continue;
+        int num_islands = set.islands->num_islands;
+        set.uvs.assign(num_islands, NULL);
+        set.vertices.assign(num_islands, NULL);
+        set.num_verts.assign(num_islands, -1);
+        for (int id = 0; id < num_islands; id++) {
+            int count = island_size(set.islands, id);
+            if (count < set.min_faces) continue;
+            set.uvs[id] = (float*)malloc((size_t)count * 6 * sizeof(float));
+            set.vertices[id] = (int*)malloc((size_t)count * 3 * sizeof(int));
+            solves.push_back(std::make_pair(s, id));
+        }
+    }
+    std::stable_sort(solves.begin(), solves.end(), [&](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+        return island_size(sets[a.first].islands, a.second) > island_size(sets[b.first].islands, b.second);
+    });
+
+    LscmOptions lscm_options;
+    uvunwrap::lscm_options_from_params(base, mesh->uvs, &lscm_options);
+
+    int num_solves = (int)solves.size();
+    int solve_workers = std::max(1, std::min(threads, num_solves));
+    std::vector<int> vertex_remaps((size_t)solve_workers * mesh->num_vertices, -1);
+    uvunwrap::parallel_for_dynamic(num_solves, solve_workers, [&](int worker, int k) {
+        SeamSet& set = sets[solves[k].first];
+        int id = solves[k].second;
+        const int* faces = &set.islands->island_faces[set.islands->island_face_offsets[id]];
+        set.num_verts[id] = lscm_parameterize_into(mesh, faces, island_size(set.islands, id),
+                                                   &lscm_options, NULL, set.uvs[id], set.vertices[id],
+                                                   &vertex_remaps[(size_t)worker * mesh->num_vertices]);
+    });
+
+    // 4. Per combination: gather its islands, pack with its margin, measure
+    int point_workers = ok ? std::max(1, std::min(threads, n)) : 0;
+    int metric_threads = point_workers > 1 ? 1 : base->num_threads;
+    std::vector<std::vector<float> > uv_buffers(point_workers);
+    uvunwrap::parallel_for_dynamic(ok ? n : 0, point_workers, [&](int worker, int i) {
+        const SeamSet& set = sets[sets[point_set[i]].canonical];
+        const IslandInfo* islands = set.islands;
+        std::vector<float>& uvs = uv_buffers[worker];
+        uvs.assign((size_t)mesh->num_vertices * 2, 0.0f);
+
+        // Island order, so a vertex shared by two islands takes the same UV as in unwrap_mesh()
+        for (int id = 0; id < islands->num_islands; id++) {
+            if (island_size(islands, id) < points[i].min_island_faces) continue;
+            for (int v = 0; v < set.num_verts[id]; v++) {
+                int g = set.vertices[id][v];
+                uvs[g * 2 + 0] = set.uvs[id][v * 2 + 0];
+                uvs[g * 2 + 1] = set.uvs[id][v * 2 + 1];
+            }
+        }
+
+        // Packing and metrics only touch the UVs, so the mesh arrays are shared
+        Mesh view = *mesh;
+        view.uvs = uvs.data();
+        UnwrapParams p = *base;
+        p.angle_threshold = points[i].angle_threshold;
+        p.min_island_faces = points[i].min_island_faces;
+        p.island_margin = points[i].island_margin;
+
+        UnwrapResult r;
+        memset(&r, 0, sizeof(r));
+        r.num_islands = islands->num_islands;
+        r.face_island_ids = islands->face_island_ids;
+        uvunwrap::pack_with_params(&view, &r, &p);
+        compute_quality_metrics_with_backend(&view, &r, NULL, metric_threads, p.compute_backend);
+
+        UnwrapSweepResult& out = results_out[i];
+        out.num_islands = r.num_islands;
+        out.avg_stretch = r.avg_stretch;
+        out.max_stretch = r.max_stretch;
+        out.stretch_l2 = r.stretch_l2;
+        out.stretch_linf = r.stretch_linf;
+        out.angle_distortion = r.angle_distortion;
+        out.max_angle_distortion = r.max_angle_distortion;
+        out.coverage = r.coverage;
+        out.overlap = r.overlap;
+    });
+
+    for (size_t s = 0; s < sets.size(); s++) {
+        for (size_t id = 0; id < sets[s].uvs.size(); id++) {
+            free(sets[s].uvs[id]);
+            free(sets[s].vertices[id]);
+        }
+        free_islands(sets[s].islands);
+        free(sets[s].seams);
+    }
+    free_topology(topo);
+
+    if (stats_out) {
+        stats_out->num_seam_sets = num_seam_sets;
+        stats_out->num_island_solves = num_solves;
+        stats_out->total_ns = uvunwrap::now_ns() - start_ns;
+    }
+    LOG_INFO("unwrap_sweep: %d combinations, %d seam sets, %d island solves",
+             n, num_seam_sets, num_solves);
+    return ok ? 0 : -1;
+}
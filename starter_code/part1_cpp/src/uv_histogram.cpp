@@ -0,0 +1,184 @@
+/**
+ * @file uv_histogram.cpp
+ * @brief Fixed log-bucket histograms and their JSON form
+ */
+
+#include "uv_histogram.h"
+#include "json.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <locale>
+#include <sstream>
+#include <string>
+
+namespace {
+
+const int OCTAVE_BUCKETS = (UV_HISTOGRAM_MAX_EXP - UV_HISTOGRAM_MIN_EXP) * UV_HISTOGRAM_SUB_BUCKETS;
+
+void append_number(std::string* out, const char* format, double value) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), format, value);
+    out->append(buffer);
+}
+
+void append_member(std::string* out, const char* key, double value) {
+    out->push_back('"');
+    out->append(key);
+    out->append("\":");
+    append_number(out, "%.17g", value);
+    out->push_back(',');
+}
+
+/**
+ * Number member converted from its source text with correct rounding, so
+ * the %.17g values written above read back exactly (JsonValue::as_number()
+ * may be an ulp off)
+ */
+double exact_number(const uvunwrap::JsonValue* value) {
+    if (!value || !value->is_number()) return 0.0;
+    std::istringstream in(value->as_string());
+    in.imbue(std::locale::classic());
+    double number = 0.0;
+    in >> number;
+    return in.fail() ? value->as_number() : number;
+}
+
+} // namespace
+
+void uv_histogram_clear(UvHistogram* histogram) {
+    if (histogram) memset(histogram, 0, sizeof(UvHistogram));
+}
+
+int uv_histogram_bucket(double value) {
+    if (!(value >= ldexp(1.0, UV_HISTOGRAM_MIN_EXP))) return 0;
+    if (value >= ldexp(1.0, UV_HISTOGRAM_MAX_EXP)) return UV_HISTOGRAM_BUCKETS - 1;
+    // value = m · 2^e with m in [0.5, 1): octave e - 1, position 2m - 1 within it
+    int e;
+    double m = frexp(value, &e);
+    int sub = (int)((2.0 * m - 1.0) * UV_HISTOGRAM_SUB_BUCKETS);
+    if (sub >= UV_HISTOGRAM_SUB_BUCKETS) sub = UV_HISTOGRAM_SUB_BUCKETS - 1;
+    return 1 + (e - 1 - UV_HISTOGRAM_MIN_EXP) * UV_HISTOGRAM_SUB_BUCKETS + sub;
+}
+
+double uv_histogram_bucket_lower(int bucket) {
+    if (bucket <= 0) return 0.0;
+    if (bucket > OCTAVE_BUCKETS) return ldexp(1.0, UV_HISTOGRAM_MAX_EXP);
+    int octave = (bucket - 1) / UV_HISTOGRAM_SUB_BUCKETS;
+    int sub = (bucket - 1) % UV_HISTOGRAM_SUB_BUCKETS;
+    return ldexp(1.0 + (double)sub / UV_HISTOGRAM_SUB_BUCKETS, UV_HISTOGRAM_MIN_EXP + octave);
+}
+
+void uv_histogram_record(UvHistogram* histogram, double value) {
+    if (!histogram || !isfinite(value)) return;
+    if (histogram->count == 0 || value < histogram->min) histogram->min = value;
+    if (histogram->count == 0 || value > histogram->max) histogram->max = value;
+    histogram->count++;
+    histogram->sum += value;
+    histogram->buckets[uv_histogram_bucket(value)]++;
+}
+
+void uv_histogram_merge(UvHistogram* dst, const UvHistogram* src) {
+    if (!dst || !src || src->count == 0) return;
+    if (dst->count == 0 || src->min < dst->min) dst->min = src->min;
+    if (dst->count == 0 || src->max > dst->max) dst->max = src->max;
+    dst->count += src->count;
+    dst->sum += src->sum;
+    for (int b = 0; b < UV_HISTOGRAM_BUCKETS; b++) dst->buckets[b] += src->buckets[b];
+}
+
+double uv_histogram_quantile(const UvHistogram* histogram, double q) {
+    if (!histogram || histogram->count <= 0) return 0.0;
+    if (!(q > 0.0)) return histogram->min;
+    if (q >= 1.0) return histogram->max;
+
+    // The rank-th smallest value, 1-based
+    long long rank = (long long)ceil(q * (double)histogram->count);
+    if (rank < 1) rank = 1;
+    long long seen = 0;
+    int bucket = UV_HISTOGRAM_BUCKETS - 1;
+    for (int b = 0; b < UV_HISTOGRAM_BUCKETS; b++) {
+        seen += histogram->buckets[b];
+        if (seen >= rank) {
+            bucket = b;
+            break;
+        }
+    }
+    double lower = uv_histogram_bucket_lower(bucket);
+    double value = bucket > 0 && bucket <= OCTAVE_BUCKETS
+        ? 0.5 * (lower + uv_histogram_bucket_lower(bucket + 1))
+        : lower;
+    if (value < histogram->min) value = histogram->min;
+    if (value > histogram->max) value = histogram->max;
+    return value;
+}
+
+double uv_histogram_mean(const UvHistogram* histogram) {
+    if (!histogram || histogram->count <= 0) return 0.0;
+    return histogram->sum / (double)histogram->count;
+}
+
+size_t uv_histogram_to_json(const UvHistogram* histogram, char* out, size_t size) {
+    UvHistogram empty;
+    if (!histogram) {
+        uv_histogram_clear(&empty);
+        histogram = &empty;
+    }
+    std::string text = "{\"count\":";
+    append_number(&text, "%.0f", (double)histogram->count);
+    text.push_back(',');
+    append_member(&text, "sum", histogram->sum);
+    append_member(&text, "min", histogram->min);
+    append_member(&text, "max", histogram->max);
+    append_member(&text, "mean", uv_histogram_mean(histogram));
+    append_member(&text, "p50", uv_histogram_quantile(histogram, 0.5));
+    append_member(&text, "p90", uv_histogram_quantile(histogram, 0.9));
+    append_member(&text, "p99", uv_histogram_quantile(histogram, 0.99));
+    text.append("\"buckets\":[");
+    bool first = true;
+    for (int b = 0; b < UV_HISTOGRAM_BUCKETS; b++) {
+        if (histogram->buckets[b] == 0) continue;
+        char pair[48];
+        snprintf(pair, sizeof(pair), "%s[%d,%lld]", first ? "" : ",", b, histogram->buckets[b]);
+        text.append(pair);
+        first = false;
+    }
+    text.append("]}");
+
+    if (out && size > 0) {
+        size_t n = text.size() < size ? text.size() : size - 1;
+        memcpy(out, text.data(), n);
+        out[n] = '\0';
+    }
+    return text.size();
+}
+
+int uv_histogram_from_json(const char* json, UvHistogram* histogram) {
+    if (!json || !histogram) return -1;
+    uvunwrap::JsonValue doc;
+    if (!uvunwrap::JsonValue::parse(json, strlen(json), &doc, NULL) || !doc.is_object()) return -1;
+
+    uv_histogram_clear(histogram);
+    const uvunwrap::JsonValue* count = doc.find("count");
+    const uvunwrap::JsonValue* sum = doc.find("sum");
+    const uvunwrap::JsonValue* min = doc.find("min");
+    const uvunwrap::JsonValue* max = doc.find("max");
+    const uvunwrap::JsonValue* buckets = doc.find("buckets");
+    if (!count || !count->is_number() || !buckets || !buckets->is_array()) return -1;
+    histogram->count = (long long)count->as_number();
+    histogram->sum = exact_number(sum);
+    histogram->min = exact_number(min);
+    histogram->max = exact_number(max);
+
+    long long total = 0;
+    for (size_t i = 0; i < buckets->size(); i++) {
+        const uvunwrap::JsonValue& pair = (*buckets)[i];
+        if (!pair.is_array() || pair.size() != 2) return -1;
+        int b = pair[0].as_int(-1);
+        double n = pair[1].as_number(-1.0);
+        if (b < 0 || b >= UV_HISTOGRAM_BUCKETS || !(n >= 0.0)) return -1;
+        histogram->buckets[b] += (long long)n;
+        total += (long long)n;
+    }
+    return total == histogram->count ? 0 : -1;
+}
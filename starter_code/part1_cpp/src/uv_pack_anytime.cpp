@@ -0,0 +1,261 @@
+/**
+ * @file uv_pack_anytime.cpp
+ * @brief Shelf layout at once, better box layouts in the background
+ *
+ * The search state is one island order and the square side it packs
+ * into. Each round a worker copies that order, applies one to three
+ * random moves (swap two islands, move one, reverse a run), packs it
+ * with pack_rects_square_ordered() and keeps the order when the side
+ * does not grow; sideways moves let the search cross plateaus. Since
+ * every layout scales the islands uniformly, fill is the islands' UV
+ * area over side², so only layouts that beat the best fill are placed
+ * and published.
+ */
+
+#include "uv_pack_anytime.h"
+#include "packing.h"
+#include "rect_pack.h"
+#include "parallel.h"
+#include "timer.h"
+#include "logging.h"
+#include "trace.h"
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const float DEFAULT_MARGIN = 0.02f;
+const float DEFAULT_TIME_LIMIT = 2.0f;
+const int MAX_MOVES_PER_ROUND = 3;
+
+inline uint64_t splitmix64(uint64_t* state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+/** UV area of the faces of islands [0, num_islands) */
+double islands_uv_area(const Mesh* mesh, const UnwrapResult* result, const float* uvs) {
+    double area = 0.0;
+    for (int f = 0; f < mesh->num_triangles; f++) {
+        int island_id = result->face_island_ids[f];
+        if (island_id < 0 || island_id >= result->num_islands) continue;
+        const int* t = &mesh->triangles[f * 3];
+        const float* a = &uvs[t[0] * 2];
+        const float* b = &uvs[t[1] * 2];
+        const float* c = &uvs[t[2] * 2];
+        area += 0.5 * fabs((double)(b[0] - a[0]) * (c[1] - a[1]) - (double)(b[1] - a[1]) * (c[0] - a[0]));
+    }
+    return area;
+}
+
+/** One to three random moves on order */
+void perturb(std::vector<int>& order, uint64_t* rng) {
+    size_t n = order.size();
+    int moves = 1 + (int)(splitmix64(rng) % MAX_MOVES_PER_ROUND);
+    for (int m = 0; m < moves; m++) {
+        size_t a = (size_t)(splitmix64(rng) % n), b = (size_t)(splitmix64(rng) % n);
+        switch (splitmix64(rng) % 3) {
+        case 0:
+            std::swap(order[a], order[b]);
+            break;
+        case 1: {
+            int moved = order[a];
+            order.erase(order.begin() + a);
+            order.insert(order.begin() + b, moved);
+            break;
+        }
+        default:
+            if (a > b) std::swap(a, b);
+            std::reverse(order.begin() + a, order.begin() + b + 1);
+            break;
+        }
+    }
+}
+
+} // namespace
+
+struct UvPackJob {
+    UvPackOptions options;
+    uvunwrap::PackBoxes boxes;
+    double source_area;          // Island UV area of boxes.uvs
+    int method;
+    long long deadline_ns;       // 0 = none
+
+    std::mutex lock;             // Guards the search state and best layout
+    std::vector<int> order;
+    float side;
+    std::vector<float> best_uvs;
+    float best_fill;
+    int improvements;
+
+    std::mutex publish_lock;     // Serialises on_improved
+    float published_fill;
+
+    std::atomic<int> cancel;
+    std::atomic<int> rounds;
+    std::atomic<int> running;
+    std::vector<std::thread> workers;
+    std::mutex join_lock;
+};
+
+namespace {
+
+void search(UvPackJob* job, int worker) {
+    const UvPackOptions& o = job->options;
+    bool allow_rotate = o.rotation != PACK_ROTATION_NONE;
+    uint64_t rng = ((uint64_t)o.seed << 32) ^ (uint64_t)(worker + 1) * 0x9E3779B97F4A7C15ull;
+    std::vector<int> order;
+    std::vector<uvunwrap::PackPlacement> placements;
+    std::vector<float> uvs;
+
+    for (;;) {
+        if (job->cancel.load(std::memory_order_relaxed)) break;
+        if (job->deadline_ns > 0 && uvunwrap::now_ns() >= job->deadline_ns) break;
+        int round = job->rounds.fetch_add(1, std::memory_order_relaxed);
+        if (o.max_rounds > 0 && round >= o.max_rounds) break;
+
+        {
+            std::lock_guard<std::mutex> guard(job->lock);
+            order = job->order;
+        }
+        // Round 0 is the engine's own order
+        if (round > 0 && order.size() > 1) perturb(order, &rng);
+
+        float side = uvunwrap::pack_rects_square_ordered(job->boxes.rects, order, job->method, allow_rotate,
+                                                         o.margin, placements);
+        if (side <= 0.0f) continue;
+        float fill = (float)(job->source_area / ((double)side * side));
+
+        bool improved = false;
+        {
+            std::lock_guard<std::mutex> guard(job->lock);
+            if (side <= job->side) {
+                job->side = side;
+                job->order = order;
+            }
+            if (fill > job->best_fill) {
+                uvunwrap::place_pack_boxes(job->boxes, placements, side, job->best_uvs.data());
+                job->best_fill = fill;
+                job->improvements++;
+                improved = true;
+                if (o.on_improved) uvs = job->best_uvs;
+            }
+        }
+        if (improved) {
+            LOG_DEBUG("uv_pack: round %d packs to %.1f%%", round, fill * 100.0f);
+            if (o.on_improved) {
+                std::lock_guard<std::mutex> guard(job->publish_lock);
+                if (fill > job->published_fill) {
+                    job->published_fill = fill;
+                    o.on_improved(uvs.data(), (int)(uvs.size() / 2), fill, round, o.user_data);
+                }
+            }
+        }
+    }
+    job->running.fetch_sub(1);
+}
+
+} // namespace
+
+void uv_pack_options_default(UvPackOptions* options) {
+    if (!options) return;
+    memset(options, 0, sizeof(*options));
+    options->margin = DEFAULT_MARGIN;
+    options->method = PACK_METHOD_MAXRECTS;
+    options->rotation = PACK_ROTATION_NONE;
+    options->time_limit = DEFAULT_TIME_LIMIT;
+}
+
+UvPackJob* uv_pack_start(Mesh* mesh, const UnwrapResult* result, const UvPackOptions* options) {
+    if (!mesh || !result || !mesh->uvs || !mesh->triangles || !result->face_island_ids) {
+        LOG_ERROR("uv_pack_start: Invalid input");
+        return NULL;
+    }
+    UvPackJob* job = new UvPackJob();
+    if (options) {
+        job->options = *options;
+    } else {
+        uv_pack_options_default(&job->options);
+    }
+    const UvPackOptions& o = job->options;
+    job->method = o.method == PACK_METHOD_SKYLINE ? PACK_METHOD_SKYLINE : PACK_METHOD_MAXRECTS;
+    job->cancel = 0;
+    job->rounds = 0;
+    job->running = 0;
+    job->improvements = 0;
+    job->deadline_ns = 0;
+
+    // The search works from the unpacked islands
+    uvunwrap::prepare_pack_boxes(mesh, result, o.rotation, o.num_threads, job->boxes);
+    job->source_area = islands_uv_area(mesh, result, job->boxes.uvs.data());
+
+    uvunwrap::pack_islands(mesh, result, o.margin, PACK_METHOD_SHELF, o.rotation, SORT_POLICY_AUTO, o.num_threads);
+    size_t uv_count = (size_t)mesh->num_vertices * 2;
+    job->best_uvs.assign(mesh->uvs, mesh->uvs + uv_count);
+    job->best_fill = (float)islands_uv_area(mesh, result, mesh->uvs);
+    job->published_fill = job->best_fill;
+    job->side = FLT_MAX;
+    uvunwrap::packing_order(job->boxes.rects, job->order);
+
+    bool bounded = o.time_limit > 0.0f || o.max_rounds > 0;
+    if (result->num_islands <= 1 || job->order.empty() || !bounded) {
+        if (!bounded) LOG_WARNING("uv_pack_start: Neither time_limit nor max_rounds is set, not searching");
+        return job;
+    }
+    if (o.time_limit > 0.0f) job->deadline_ns = uvunwrap::now_ns() + (long long)(o.time_limit * 1e9);
+
+    int threads = uvunwrap::resolve_thread_count(o.num_threads);
+    if (o.max_rounds > 0) threads = std::min(threads, o.max_rounds);
+    LOG_INFO("uv_pack: shelf layout fills %.1f%%, searching on %d workers", job->best_fill * 100.0f, threads);
+    job->running = threads;
+    uvunwrap::LogSink* sink = uvunwrap::current_log_sink();
+    job->workers.reserve(threads);
+    for (int t = 0; t < threads; t++) {
+        job->workers.emplace_back([job, sink, t]() {
+            uvunwrap::ScopedLogSink scope(sink);
+            UV_TRACE_THREAD_NAME("uvunwrap packer", t);
+            search(job, t);
+        });
+    }
+    return job;
+}
+
+void uv_pack_cancel(UvPackJob* job) {
+    if (job) job->cancel = 1;
+}
+
+void uv_pack_wait(UvPackJob* job) {
+    if (!job) return;
+    std::lock_guard<std::mutex> guard(job->join_lock);
+    for (size_t i = 0; i < job->workers.size(); i++) {
+        if (job->workers[i].joinable()) job->workers[i].join();
+    }
+}
+
+int uv_pack_running(const UvPackJob* job) {
+    return job && job->running.load() > 0 ? 1 : 0;
+}
+
+int uv_pack_best(UvPackJob* job, float* uvs_out, float* fill_out) {
+    if (!job) return 0;
+    std::lock_guard<std::mutex> guard(job->lock);
+    if (uvs_out) memcpy(uvs_out, job->best_uvs.data(), job->best_uvs.size() * sizeof(float));
+    if (fill_out) *fill_out = job->best_fill;
+    return job->improvements;
+}
+
+void uv_pack_free(UvPackJob* job) {
+    if (!job) return;
+    uv_pack_cancel(job);
+    uv_pack_wait(job);
+    delete job;
+}
@@ -0,0 +1,149 @@
+/**
+ * @file uv_quantize.cpp
+ * @brief 16-bit UV quantisation with an overlap check at texture resolution
+ */
+
+#include "uv_quantize.h"
+#include "logging.h"
+#include "trace.h"
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+namespace {
+
+const float Q16_MAX = 65535.0f;
+const int DEFAULT_TEXTURE_SIZE = 1024;
+
+uint16_t encode(float uv, float offset, float scale) {
+    float q = (uv - offset) / scale * Q16_MAX + 0.5f;
+    if (!(q > 0.0f)) return 0;
+    if (q >= Q16_MAX) return (uint16_t)Q16_MAX;
+    return (uint16_t)q;
+}
+
+/** Overlapping texels of mesh at resolution² (-1 if it cannot be rasterised) */
+long long overlap_texels(const Mesh* mesh, const int* face_island_ids, int num_islands, int resolution) {
+    UvCoverage* coverage = compute_uv_coverage(mesh, face_island_ids, num_islands, resolution, 0);
+    long long texels = coverage ? coverage->overlap_texels : -1;
+    free_uv_coverage(coverage);
+    return texels;
+}
+
+} // namespace
+
+void uv_quantize_options_default(UvQuantizeOptions* options) {
+    if (!options) return;
+    memset(options, 0, sizeof(UvQuantizeOptions));
+    options->grid = UV_QUANTIZE_GLOBAL;
+    options->texture_size = DEFAULT_TEXTURE_SIZE;
+}
+
+QuantizedUvs* quantize_uvs(const Mesh* mesh,
+                           const int* face_island_ids,
+                           int num_islands,
+                           const UvQuantizeOptions* options) {
+    UV_TRACE_ZONE("quantize_uvs");
+    if (!mesh || !mesh->uvs || mesh->num_vertices <= 0) return NULL;
+    UvQuantizeOptions defaults;
+    if (!options) {
+        uv_quantize_options_default(&defaults);
+        options = &defaults;
+    }
+
+    int nv = mesh->num_vertices;
+    bool per_island = options->grid == UV_QUANTIZE_PER_ISLAND && face_island_ids && num_islands > 0;
+    int num_boxes = per_island ? num_islands : 1;
+
+    QuantizedUvs* q = (QuantizedUvs*)calloc(1, sizeof(QuantizedUvs));
+    q->num_vertices = nv;
+    q->uvs = (uint16_t*)malloc((size_t)nv * 2 * sizeof(uint16_t));
+    q->grid = per_island ? UV_QUANTIZE_PER_ISLAND : UV_QUANTIZE_GLOBAL;
+    q->num_boxes = num_boxes;
+    q->boxes = (float*)malloc((size_t)num_boxes * 4 * sizeof(float));
+
+    // Box of each vertex: the island of the first face that uses it
+    if (per_island) {
+        q->vertex_box = (int*)malloc((size_t)nv * sizeof(int));
+        for (int v = 0; v < nv; v++) q->vertex_box[v] = -1;
+        for (int f = 0; f < mesh->num_triangles; f++) {
+            int island = face_island_ids[f];
+            if (island < 0 || island >= num_islands) island = 0;
+            for (int k = 0; k < 3; k++) {
+                int v = mesh->triangles[f * 3 + k];
+                if (q->vertex_box[v] < 0) q->vertex_box[v] = island;
+            }
+        }
+        for (int v = 0; v < nv; v++) {
+            if (q->vertex_box[v] < 0) q->vertex_box[v] = 0;
+        }
+    }
+
+    std::vector<float> lo((size_t)num_boxes * 2, FLT_MAX), hi((size_t)num_boxes * 2, -FLT_MAX);
+    for (int v = 0; v < nv; v++) {
+        int b = q->vertex_box ? q->vertex_box[v] : 0;
+        for (int k = 0; k < 2; k++) {
+            float uv = mesh->uvs[v * 2 + k];
+            if (uv < lo[b * 2 + k]) lo[b * 2 + k] = uv;
+            if (uv > hi[b * 2 + k]) hi[b * 2 + k] = uv;
+        }
+    }
+    for (int b = 0; b < num_boxes; b++) {
+        // [0,1]² whenever it holds the global grid, so q / 65535 is the UV
+        bool unit = !per_island && lo[0] >= 0.0f && lo[1] >= 0.0f && hi[0] <= 1.0f && hi[1] <= 1.0f;
+        for (int k = 0; k < 2; k++) {
+            float offset = unit ? 0.0f : lo[b * 2 + k];
+            float scale = unit ? 1.0f : hi[b * 2 + k] - lo[b * 2 + k];
+            if (!(offset == offset) || offset == FLT_MAX) offset = 0.0f;
+            if (!(scale > 0.0f)) scale = 1.0f;
+            q->boxes[b * 4 + k] = offset;
+            q->boxes[b * 4 + 2 + k] = scale;
+        }
+    }
+
+    for (int v = 0; v < nv; v++) {
+        const float* box = q->boxes + (q->vertex_box ? q->vertex_box[v] : 0) * 4;
+        q->uvs[v * 2 + 0] = encode(mesh->uvs[v * 2 + 0], box[0], box[2]);
+        q->uvs[v * 2 + 1] = encode(mesh->uvs[v * 2 + 1], box[1], box[3]);
+    }
+
+    std::vector<float> decoded((size_t)nv * 2);
+    dequantize_uvs(q, decoded.data());
+    for (size_t i = 0; i < decoded.size(); i++) {
+        float error = fabsf(decoded[i] - mesh->uvs[i]);
+        if (error > q->max_error) q->max_error = error;
+    }
+
+    if (options->texture_size > 0) {
+        Mesh quantized = *mesh;
+        quantized.uvs = decoded.data();
+        long long before = overlap_texels(mesh, face_island_ids, num_islands, options->texture_size);
+        long long after = overlap_texels(&quantized, face_island_ids, num_islands, options->texture_size);
+        if (before < 0 || after > before) {
+            LOG_WARNING("quantize_uvs: 16-bit grid adds %lld overlapping texels at %d²", after - before,
+                        options->texture_size);
+            free_quantized_uvs(q);
+            return NULL;
+        }
+    }
+    return q;
+}
+
+void dequantize_uvs(const QuantizedUvs* quantized, float* uvs_out) {
+    if (!quantized || !uvs_out) return;
+    for (int v = 0; v < quantized->num_vertices; v++) {
+        const float* box = quantized->boxes + (quantized->vertex_box ? quantized->vertex_box[v] : 0) * 4;
+        uvs_out[v * 2 + 0] = box[0] + (float)quantized->uvs[v * 2 + 0] / Q16_MAX * box[2];
+        uvs_out[v * 2 + 1] = box[1] + (float)quantized->uvs[v * 2 + 1] / Q16_MAX * box[3];
+    }
+}
+
+void free_quantized_uvs(QuantizedUvs* quantized) {
+    if (!quantized) return;
+    free(quantized->uvs);
+    free(quantized->boxes);
+    free(quantized->vertex_box);
+    free(quantized);
+}
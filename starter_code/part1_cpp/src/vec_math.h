@@ -0,0 +1,62 @@
+/**
+ * @file vec_math.h
+ * @brief Header-only vector math for the library's kernels
+ *
+ * Not part of the public API. The same operations as math_utils.h, but
+ * inline (constexpr where the standard allows) so kernels get them
+ * inlined and vectorised instead of calling across the shared library
+ * boundary. The C functions in math_utils.cpp wrap these, so both give
+ * bit-identical results.
+ */
+
+#ifndef UVUNWRAP_VEC_MATH_H
+#define UVUNWRAP_VEC_MATH_H
+
+#include "math_utils.h"
+#include "isa_abi.h"
+#include <math.h>
+
+namespace uvunwrap {
+inline namespace UVUNWRAP_ISA_ABI {
+
+constexpr Vec3 add(Vec3 a, Vec3 b) { return Vec3{a.x + b.x, a.y + b.y, a.z + b.z}; }
+constexpr Vec3 sub(Vec3 a, Vec3 b) { return Vec3{a.x - b.x, a.y - b.y, a.z - b.z}; }
+constexpr Vec3 scale(Vec3 v, float s) { return Vec3{v.x * s, v.y * s, v.z * s}; }
+constexpr float dot(Vec3 a, Vec3 b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+constexpr Vec3 cross(Vec3 a, Vec3 b) {
+    return Vec3{a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+
+inline float length(Vec3 v) { return sqrtf(v.x * v.x + v.y * v.y + v.z * v.z); }
+
+/** Unit vector, or zero for vectors shorter than 1e-8 */
+inline Vec3 normalize(Vec3 v) {
+    float len = length(v);
+    if (len < 1e-8f) return Vec3{0.0f, 0.0f, 0.0f};
+    return scale(v, 1.0f / len);
+}
+
+constexpr Vec2 add(Vec2 a, Vec2 b) { return Vec2{a.x + b.x, a.y + b.y}; }
+constexpr Vec2 sub(Vec2 a, Vec2 b) { return Vec2{a.x - b.x, a.y - b.y}; }
+constexpr float dot(Vec2 a, Vec2 b) { return a.x * b.x + a.y * b.y; }
+inline float length(Vec2 v) { return sqrtf(v.x * v.x + v.y * v.y); }
+
+constexpr float clamp(float v, float lo, float hi) { return v < lo ? lo : (v > hi ? hi : v); }
+
+inline Vec3 vertex_position(const Mesh* mesh, int vertex_idx) {
+    const float* p = &mesh->vertices[vertex_idx * 3];
+    return Vec3{p[0], p[1], p[2]};
+}
+
+/** Unnormalised face normal (p1 - p0) × (p2 - p0); its length is twice the area */
+inline Vec3 face_normal(const Mesh* mesh, int tri_idx) {
+    const int* t = &mesh->triangles[tri_idx * 3];
+    Vec3 p0 = vertex_position(mesh, t[0]);
+    return cross(sub(vertex_position(mesh, t[1]), p0), sub(vertex_position(mesh, t[2]), p0));
+}
+
+} // namespace UVUNWRAP_ISA_ABI
+} // namespace uvunwrap
+
+#endif /* UVUNWRAP_VEC_MATH_H */
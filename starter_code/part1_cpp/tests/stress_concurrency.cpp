@@ -0,0 +1,210 @@
+/**
+ * @file stress_concurrency.cpp
+ * @brief Concurrent unwrap_mesh() stress test
+ *
+ * Runs hundreds of unwrap_mesh() / unwrap_mesh_ctx() calls from many
+ * threads at once, mixing meshes, parameter sets, a shared LSCM plan,
+ * per-context log sinks and the process-wide log state, and checks every
+ * result against a serial run. Build with -DUVUNWRAP_TSAN=ON to run it
+ * under ThreadSanitizer.
+ */
+
+#include "mesh.h"
+#include "unwrap.h"
+#include "lscm.h"
+#include "unwrap_cache.h"
+#include "uv_log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#ifndef TEST_DATA_DIR
+#define TEST_DATA_DIR "../../../test_data/meshes/"
+#endif
+
+int tests_passed = 0;
+int tests_failed = 0;
+
+namespace {
+
+const char* MESH_NAMES[] = {"01_cube.obj", "02_cylinder.obj", "03_sphere.obj", "04_torus.obj"};
+const int NUM_MESHES = 4;
+const int NUM_VARIANTS = 4;
+const int NUM_CALLER_THREADS = 16;
+const int CALLS_PER_THREAD = 24;
+
+/** Parameter set `variant`; every one but the first starts island workers */
+void variant_params(int variant, LscmPlan* plan, UnwrapParams* params) {
+    unwrap_params_default(params);
+    switch (variant) {
+    case 1:
+        params->num_threads = 4;
+        params->seam_method = SEAM_METHOD_MST;
+        params->arap_iterations = 2;
+        break;
+    case 2:
+        params->num_threads = 3;
+        params->lscm_plan = plan;
+        params->pack_method = PACK_METHOD_SKYLINE;
+        break;
+    case 3:
+        params->num_threads = 2;
+        params->lscm_method = LSCM_METHOD_ABF;
+        break;
+    default:
+        params->num_threads = 1;
+        break;
+    }
+}
+
+int results_equal(const Mesh* a, const UnwrapResult* ra, const Mesh* b, const UnwrapResult* rb) {
+    if (!a || !b || !ra || !rb) return 0;
+    if (a->num_vertices != b->num_vertices || a->num_triangles != b->num_triangles) return 0;
+    if (ra->num_islands != rb->num_islands) return 0;
+    if (memcmp(a->triangles, b->triangles, (size_t)a->num_triangles * 3 * sizeof(int)) != 0) return 0;
+    return memcmp(a->uvs, b->uvs, (size_t)a->num_vertices * 2 * sizeof(float)) == 0;
+}
+
+/** Context sink: checks that it only ever sees its own calls */
+struct ContextLog {
+    int expected_vertices;       /**< Input size of the call in flight */
+    int messages;
+    int foreign;                 /**< "Input:" lines for another mesh */
+};
+
+void context_log(int, const char* message, void* user_data) {
+    ContextLog* log = (ContextLog*)user_data;
+    log->messages++;
+    int vertices;
+    if (sscanf(message, "Input: %d vertices", &vertices) == 1 && vertices != log->expected_vertices) {
+        log->foreign++;
+    }
+}
+
+std::atomic<int> g_global_headers(0);
+
+void global_log(int, const char* message, void*) {
+    if (strcmp(message, "=== UV Unwrapping ===") == 0) g_global_headers.fetch_add(1);
+}
+
+} // namespace
+
+void test_concurrent_unwrap() {
+    printf("[TEST] %d concurrent unwrap calls on %d threads...",
+           NUM_CALLER_THREADS * CALLS_PER_THREAD, NUM_CALLER_THREADS);
+
+    Mesh* meshes[NUM_MESHES] = {NULL};
+    for (int m = 0; m < NUM_MESHES; m++) {
+        char filename[256];
+        snprintf(filename, sizeof(filename), "%s%s", TEST_DATA_DIR, MESH_NAMES[m]);
+        meshes[m] = load_obj(filename);
+        if (!meshes[m]) {
+            printf(" FAIL (could not load %s)\n", MESH_NAMES[m]);
+            tests_failed++;
+            for (int k = 0; k < m; k++) free_mesh(meshes[k]);
+            return;
+        }
+    }
+    LscmPlan* plan = lscm_plan_create(0);
+
+    // Serial reference for every (mesh, variant)
+    Mesh* expected[NUM_MESHES][NUM_VARIANTS];
+    UnwrapResult* expected_results[NUM_MESHES][NUM_VARIANTS];
+    int reference_ok = 1;
+    for (int m = 0; m < NUM_MESHES; m++) {
+        for (int v = 0; v < NUM_VARIANTS; v++) {
+            UnwrapParams params;
+            variant_params(v, plan, &params);
+            expected_results[m][v] = NULL;
+            expected[m][v] = unwrap_mesh(meshes[m], &params, &expected_results[m][v]);
+            if (!expected[m][v]) reference_ok = 0;
+        }
+    }
+
+    // Callers without a context log through the process-wide sink; the
+    // ones with a context must never reach it
+    uv_set_log_level(UV_LOG_INFO);
+    uv_set_log_callback(global_log, NULL);
+
+    std::atomic<int> mismatches(0), failures(0), foreign(0), silent_contexts(0), global_calls(0);
+    std::vector<std::thread> callers;
+    for (int t = 0; t < NUM_CALLER_THREADS; t++) {
+        callers.emplace_back([&, t]() {
+            UnwrapContext* ctx = t % 2 ? unwrap_context_create() : NULL;
+            ContextLog log = {0, 0, 0};
+            if (ctx) unwrap_context_set_log_callback(ctx, context_log, &log, UV_LOG_DEBUG);
+            for (int call = 0; call < CALLS_PER_THREAD; call++) {
+                int m = (t + call) % NUM_MESHES;
+                int v = (t / 2 + call) % NUM_VARIANTS;
+                UnwrapParams params;
+                variant_params(v, plan, &params);
+                log.expected_vertices = meshes[m]->num_vertices;
+
+                UnwrapResult* result = NULL;
+                Mesh* out = ctx ? unwrap_mesh_ctx(ctx, meshes[m], &params, &result)
+                                : unwrap_mesh(meshes[m], &params, &result);
+                if (!ctx) global_calls.fetch_add(1);
+                if (!out) failures.fetch_add(1);
+                else if (!results_equal(out, result, expected[m][v], expected_results[m][v])) mismatches.fetch_add(1);
+                if (out) free_mesh(out);
+                if (result) free_unwrap_result(result);
+            }
+            if (ctx) {
+                if (log.messages == 0) silent_contexts.fetch_add(1);
+                foreign.fetch_add(log.foreign);
+                unwrap_context_free(ctx);
+            }
+        });
+    }
+    for (size_t i = 0; i < callers.size(); i++) callers[i].join();
+
+    uv_set_log_callback(NULL, NULL);
+    uv_set_log_level(UV_LOG_SILENT);
+
+    if (!reference_ok) {
+        printf(" FAIL (serial reference failed)\n");
+        tests_failed++;
+    } else if (failures.load() || mismatches.load()) {
+        printf(" FAIL (%d failed, %d differ from the serial run)\n", failures.load(), mismatches.load());
+        tests_failed++;
+    } else if (foreign.load() || silent_contexts.load() || g_global_headers.load() != global_calls.load()) {
+        printf(" FAIL (log routing: %d foreign, %d silent contexts, %d/%d global headers)\n",
+               foreign.load(), silent_contexts.load(), g_global_headers.load(), global_calls.load());
+        tests_failed++;
+    } else {
+        printf(" PASS (all match the serial run)\n");
+        tests_passed++;
+    }
+
+    for (int m = 0; m < NUM_MESHES; m++) {
+        for (int v = 0; v < NUM_VARIANTS; v++) {
+            if (expected[m][v]) free_mesh(expected[m][v]);
+            if (expected_results[m][v]) free_unwrap_result(expected_results[m][v]);
+        }
+        free_mesh(meshes[m]);
+    }
+    lscm_plan_free(plan);
+}
+
+int main() {
+    printf("\n");
+    printf("========================================\n");
+    printf("UV Unwrapping Concurrency Stress Test\n");
+    printf("========================================\n\n");
+
+    // Cached results would skip the pipeline the test is meant to exercise
+    unwrap_cache_configure(NULL, 0);
+    uv_set_log_level(UV_LOG_SILENT);
+
+    test_concurrent_unwrap();
+
+    printf("\n");
+    printf("========================================\n");
+    printf("Results: %d passed, %d failed\n", tests_passed, tests_failed);
+    printf("========================================\n\n");
+
+    return (tests_failed == 0) ? 0 : 1;
+}
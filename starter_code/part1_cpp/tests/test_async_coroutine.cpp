@@ -0,0 +1,205 @@
+/**
+ * @file test_async_coroutine.cpp
+ * @brief C++20 test of uvunwrap::UnwrapAwaitable and of the async pool at exit
+ *
+ * Built as C++20 so unwrap_async.h declares the awaitable. The last test
+ * leaves an unwrap running when main() returns; its completion callback
+ * queues another one while the pool shuts down, which must complete as
+ * cancelled instead of hanging the exit (ctest's timeout catches that).
+ */
+
+#include "mesh.h"
+#include "unwrap.h"
+#include "unwrap_async.h"
+#include "unwrap_cache.h"
+#include "uv_log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#ifndef TEST_DATA_DIR
+#define TEST_DATA_DIR "../../../test_data/meshes/"
+#endif
+
+int tests_passed = 0;
+int tests_failed = 0;
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+
+namespace {
+
+/** Coroutine that runs to completion on its own; nobody awaits it */
+struct Detached {
+    struct promise_type {
+        Detached get_return_object() { return Detached(); }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+/** Where a coroutine leaves its outcome for the test thread */
+struct Awaited {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool done = false;
+    uvunwrap::UnwrapAsyncOutcome outcome{UNWRAP_ASYNC_PENDING, nullptr, nullptr};
+};
+
+Detached unwrap_coroutine(const Mesh* mesh, const UnwrapParams* params, Awaited* awaited) {
+    uvunwrap::UnwrapAsyncOutcome outcome = co_await uvunwrap::UnwrapAwaitable(nullptr, mesh, params);
+    std::lock_guard<std::mutex> lock(awaited->mutex);
+    awaited->outcome = outcome;
+    awaited->done = true;
+    awaited->cv.notify_all();
+}
+
+uvunwrap::UnwrapAsyncOutcome await_unwrap(const Mesh* mesh, const UnwrapParams* params) {
+    Awaited awaited;
+    unwrap_coroutine(mesh, params, &awaited);
+    std::unique_lock<std::mutex> lock(awaited.mutex);
+    awaited.cv.wait(lock, [&]() { return awaited.done; });
+    return awaited.outcome;
+}
+
+bool same_uvs(const Mesh* a, const Mesh* b) {
+    return a && b && a->num_vertices == b->num_vertices && a->uvs && b->uvs &&
+           memcmp(a->uvs, b->uvs, (size_t)a->num_vertices * 2 * sizeof(float)) == 0;
+}
+
+Mesh* load_test_mesh(const char* name) {
+    char filename[256];
+    snprintf(filename, sizeof(filename), "%s%s", TEST_DATA_DIR, name);
+    return load_obj(filename);
+}
+
+} // namespace
+
+void test_awaitable() {
+    printf("[TEST] co_await UnwrapAwaitable...");
+    Mesh* mesh = load_test_mesh("03_sphere.obj");
+    if (!mesh) {
+        printf(" FAIL (could not load)\n");
+        tests_failed++;
+        return;
+    }
+    UnwrapParams params;
+    unwrap_params_default(&params);
+    UnwrapResult* reference_result = NULL;
+    Mesh* reference = unwrap_mesh(mesh, &params, &reference_result);
+
+    int ok = 1;
+    uvunwrap::UnwrapAsyncOutcome outcome = await_unwrap(mesh, &params);
+    if (outcome.status != UNWRAP_ASYNC_OK || !same_uvs(reference, outcome.mesh) || !outcome.result ||
+        outcome.result->num_islands != reference_result->num_islands) {
+        printf(" FAIL (status %d, output differs from unwrap_mesh)\n", outcome.status);
+        ok = 0;
+    }
+    free_mesh(outcome.mesh);
+    free_unwrap_result(outcome.result);
+
+    // A raised cancel token: resumed with no output
+    if (ok) {
+        volatile int token = 1;
+        UnwrapParams cancelled = params;
+        cancelled.cancel = &token;
+        outcome = await_unwrap(mesh, &cancelled);
+        if (outcome.status != UNWRAP_ASYNC_CANCELLED || outcome.mesh || outcome.result) {
+            printf(" FAIL (cancelled await gave status %d)\n", outcome.status);
+            ok = 0;
+        }
+        free_mesh(outcome.mesh);
+        free_unwrap_result(outcome.result);
+    }
+
+    if (ok) {
+        printf(" PASS\n");
+        tests_passed++;
+    } else {
+        tests_failed++;
+    }
+    free_unwrap_result(reference_result);
+    free_mesh(reference);
+    free_mesh(mesh);
+}
+
+namespace {
+
+std::atomic<int> g_started(0);
+
+// Never freed: the worker still reads it after main() returns
+Mesh* g_exit_mesh = NULL;
+
+/** Holds the task in its first progress report until main() has returned */
+int slow_progress(int, int, int, float, void*) {
+    if (g_started.exchange(1) == 0) std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    return 0;
+}
+
+/** Queues a follow-up unwrap from the worker, as a pipeline would */
+void chain_done(UnwrapTask*, int, Mesh* output, UnwrapResult* result, void* user_data) {
+    free_mesh(output);
+    free_unwrap_result(result);
+    UnwrapParams params;
+    unwrap_params_default(&params);
+    unwrap_task_release(unwrap_mesh_async(NULL, (const Mesh*)user_data, &params, NULL, NULL));
+}
+
+} // namespace
+
+/** Leaves a task running; the exit itself is the check */
+void start_unwrap_over_exit() {
+    printf("[TEST] Exit while a completion callback queues an unwrap...");
+    g_exit_mesh = load_test_mesh("04_torus.obj");
+    if (!g_exit_mesh) {
+        printf(" FAIL (could not load)\n");
+        tests_failed++;
+        return;
+    }
+    UnwrapParams params;
+    unwrap_params_default(&params);
+    params.progress = slow_progress;
+    unwrap_task_release(unwrap_mesh_async(NULL, g_exit_mesh, &params, chain_done, g_exit_mesh));
+    while (!g_started.load()) std::this_thread::yield();
+    printf(" PASS (if the process exits)\n");
+    tests_passed++;
+}
+
+#else
+
+void test_awaitable() {
+    printf("[TEST] co_await UnwrapAwaitable... SKIP (no coroutine support)\n");
+    tests_passed++;
+}
+
+void start_unwrap_over_exit() {}
+
+#endif
+
+int main() {
+    printf("\n");
+    printf("========================================\n");
+    printf("UV Unwrapping Coroutine Test\n");
+    printf("========================================\n\n");
+
+    // Cached results would answer before the pool ever runs the task
+    unwrap_cache_configure(NULL, 0);
+    uv_set_log_level(UV_LOG_SILENT);
+
+    test_awaitable();
+    start_unwrap_over_exit();
+
+    printf("\n");
+    printf("========================================\n");
+    printf("Results: %d passed, %d failed\n", tests_passed, tests_failed);
+    printf("========================================\n\n");
+
+    return (tests_failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,62 @@
+/**
+ * @file uvunwrap_worker.cpp
+ * @brief Cluster worker: solves islands for unwrap_mesh_distributed()
+ *        coordinators until SIGINT / SIGTERM
+ *
+ * Usage: uvunwrap_worker [--listen HOST:PORT] [--threads N] [--log-level N]
+ *
+ * Listens on *:7878 by default. The protocol is unauthenticated: bind to
+ * a trusted network only.
+ */
+
+#include "unwrap_cluster.h"
+#include "uv_log.h"
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void usage(const char* argv0) {
+    fprintf(stderr, "usage: %s [--listen HOST:PORT] [--threads N] [--log-level N]\n", argv0);
+}
+
+int main(int argc, char** argv) {
+    const char* address = "*:7878";
+    int threads = 0;
+    int log_level = UV_LOG_INFO;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!value) {
+            usage(argv[0]);
+            return 2;
+        }
+        if (strcmp(arg, "--listen") == 0) {
+            address = value;
+        } else if (strcmp(arg, "--threads") == 0) {
+            threads = atoi(value);
+        } else if (strcmp(arg, "--log-level") == 0) {
+            log_level = atoi(value);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+        i++;
+    }
+    uv_set_log_level(log_level);
+
+    // Connection threads inherit the mask, so the signals reach only sigwait() below
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    UnwrapClusterWorker* worker = unwrap_cluster_worker_start(address, threads);
+    if (!worker) return 1;
+    int received = 0;
+    sigwait(&signals, &received);
+    unwrap_cluster_worker_stop(worker);
+    return 0;
+}
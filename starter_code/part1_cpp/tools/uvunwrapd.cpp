@@ -0,0 +1,75 @@
+/**
+ * @file uvunwrapd.cpp
+ * @brief Unwrap daemon: serves unwrap_daemon_*() clients until SIGINT / SIGTERM
+ *
+ * Usage: uvunwrapd [--socket PATH] [--workers N] [--cache-dir DIR]
+ *                  [--cache-max-mb N] [--log-level N]
+ *
+ * Without --cache-dir the result cache follows UVUNWRAP_CACHE_DIR, as in
+ * every other process using the library.
+ */
+
+#include "unwrap_daemon.h"
+#include "unwrap_cache.h"
+#include "uv_log.h"
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+            "usage: %s [--socket PATH] [--workers N] [--cache-dir DIR] [--cache-max-mb N] [--log-level N]\n",
+            argv0);
+}
+
+int main(int argc, char** argv) {
+    const char* socket_path = NULL;
+    const char* cache_dir = NULL;
+    int workers = 0;
+    long long cache_max_mb = 0;
+    int log_level = UV_LOG_INFO;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!value) {
+            usage(argv[0]);
+            return 2;
+        }
+        if (strcmp(arg, "--socket") == 0) {
+            socket_path = value;
+        } else if (strcmp(arg, "--workers") == 0) {
+            workers = atoi(value);
+        } else if (strcmp(arg, "--cache-dir") == 0) {
+            cache_dir = value;
+        } else if (strcmp(arg, "--cache-max-mb") == 0) {
+            cache_max_mb = atoll(value);
+        } else if (strcmp(arg, "--log-level") == 0) {
+            log_level = atoi(value);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+        i++;
+    }
+    uv_set_log_level(log_level);
+    if (cache_dir && unwrap_cache_configure(cache_dir, cache_max_mb * 1024 * 1024) != 0) {
+        fprintf(stderr, "uvunwrapd: cannot use cache directory %s\n", cache_dir);
+        return 1;
+    }
+
+    // Workers inherit the mask, so the signals reach only sigwait() below
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    UnwrapDaemon* daemon = unwrap_daemon_start(socket_path, workers);
+    if (!daemon) return 1;
+    int received = 0;
+    sigwait(&signals, &received);
+    unwrap_daemon_stop(daemon);
+    return 0;
+}
@@ -4,6 +4,7 @@ UV Unwrap CLI Tool - Complete implementation
 """
 
 import argparse
+import json
 import sys
 from pathlib import Path
 from uvwrap import bindings, processor, optimizer
@@ -11,6 +12,17 @@ from uvwrap import bindings, processor, optimizer
 
 def main():
     parser = argparse.ArgumentParser(description='UV Unwrap CLI Tool')
+    parser.add_argument('--cache-dir', help='Reuse unwrap results cached in this directory '
+                        '(default: $UVUNWRAP_CACHE_DIR)')
+    parser.add_argument('--cache-max-mb', type=int, default=0,
+                        help='Cache size budget in MiB (0 = 1024)')
+    parser.add_argument('--island-cache-mb', type=int, default=0,
+                        help='Reuse solved islands from a cache of this many MiB (0 = off)')
+    parser.add_argument('--daemon', nargs='?', const='', metavar='SOCKET',
+                        help='Unwrap through a running uvunwrapd (default socket if none given); '
+                        'falls back to in-process when none answers')
+    parser.add_argument('--cluster', metavar='HOST:PORT[,HOST:PORT...]',
+                        help='Ship the island solves of unwrap to uvunwrap_worker processes')
     subparsers = parser.add_subparsers(dest='command', help='Command to run')
     
     # Unwrap single file
@@ -21,12 +33,68 @@ def main():
     unwrap_parser.add_argument('--min-faces', type=int, default=5, help='Min island faces')
     unwrap_parser.add_argument('--margin', type=float, default=0.02, help='Island margin')
     unwrap_parser.add_argument('--no-pack', action='store_true', help='Disable packing')
+    unwrap_parser.add_argument('--seam-method', choices=sorted(bindings.SEAM_METHODS), default='bfs',
+                               help='Seam detection engine')
+    unwrap_parser.add_argument('--solver', choices=sorted(bindings.SOLVERS), default='auto',
+                               help='LSCM sparse solver backend')
+    unwrap_parser.add_argument('--pin-method', choices=sorted(bindings.PIN_METHODS), default='auto',
+                               help='How LSCM picks the two pinned vertices per island')
+    unwrap_parser.add_argument('--lscm-method', choices=sorted(bindings.LSCM_METHODS), default='pinned',
+                               help='Pinned LSCM, the pin-free spectral conformal map, or LSCM on ABF++ angles')
+    unwrap_parser.add_argument('--arap-iterations', type=int, default=0,
+                               help='ARAP refinement iterations per island after LSCM (0 = off)')
+    unwrap_parser.add_argument('--arap-time-limit', type=float, default=0.0,
+                               help='ARAP time budget per island in seconds (0 = none)')
+    unwrap_parser.add_argument('--sort-policy', choices=sorted(bindings.SORT_POLICIES), default='auto',
+                               help='Threading of the topology, seam and packing sorts (same output)')
+    unwrap_parser.add_argument('--memory-budget', type=float, default=0.0, metavar='MB',
+                               help='Delay island solves that would take tracked memory past this (0 = no limit)')
+    unwrap_parser.add_argument('--ordering', choices=sorted(bindings.ORDERINGS), default='auto',
+                               help='Fill-reducing ordering of direct LSCM solves')
+    unwrap_parser.add_argument('--vertex-order', choices=sorted(bindings.VERTEX_ORDERS), default='input',
+                               help='Renumber each island for locality before its solve')
+    unwrap_parser.add_argument('--output-order', choices=sorted(bindings.VERTEX_ORDERS), default='input',
+                               help='Renumber the output mesh (cache: GPU vertex-cache order, ready to export)')
+    unwrap_parser.add_argument('--compute-backend', choices=sorted(bindings.COMPUTE_BACKENDS), default='auto',
+                               help='Device for the quality metrics and coverage raster (cuda falls back to cpu)')
+    unwrap_parser.add_argument('--instancing', choices=sorted(bindings.ISLAND_INSTANCING), default='none',
+                               help='Solve one island per group of copies and give the others its UVs '
+                                    '(stack also packs them on top of it)')
+    unwrap_parser.add_argument('--island-scale', choices=sorted(bindings.ISLAND_SCALES), default='normalized',
+                               help='Size islands to fill the sheet alike, or all at one texel density')
+    unwrap_parser.add_argument('--pin', type=int, nargs=2, metavar=('V0', 'V1'),
+                               help='Pin these two vertices in the island that contains both')
+    unwrap_parser.add_argument('--seams', metavar='FILE',
+                               help='Cut exactly these seams instead of detecting them (one "V0 V1" pair per line)')
+    unwrap_parser.add_argument('--precision', choices=sorted(bindings.PRECISIONS), default='double',
+                               help='LSCM floating-point precision')
+    unwrap_parser.add_argument('--max-chart-faces', type=int, default=0,
+                               help='Split larger islands into charts of about this many faces (0 = no limit)')
+    unwrap_parser.add_argument('--max-chart-angle', type=float, default=0.0,
+                               help='Split islands whose normals stray further than this from their chart (degrees)')
+    unwrap_parser.add_argument('--split-vertices', action='store_true',
+                               help='Give each island its own copy of seam vertices')
+    unwrap_parser.add_argument('--weld', type=float, metavar='EPS',
+                               help='Merge vertices closer than EPS after loading (0 = identical positions only)')
+    unwrap_parser.add_argument('--repair-nonmanifold', action='store_true',
+                               help='Split non-manifold vertices and edges into manifold fans before unwrapping')
     
     # Batch process
     batch_parser = subparsers.add_parser('batch', help='Process multiple meshes')
     batch_parser.add_argument('input_dir', help='Input directory')
     batch_parser.add_argument('output_dir', help='Output directory')
     batch_parser.add_argument('--threads', type=int, help='Number of threads')
+    batch_parser.add_argument('--prefetch', type=int, default=0,
+                              help='Meshes parsed ahead of the workers (0 = one per worker)')
+    batch_parser.add_argument('--memory-budget', type=int, default=0,
+                              help='MiB of meshes held between reading and writing (0 = no limit)')
+    batch_parser.add_argument('--executor', choices=processor.EXECUTORS, default='native',
+                              help='native pipeline, or a pool of --threads worker processes')
+    batch_parser.add_argument('--histograms', metavar='FILE',
+                              help='Write stretch, island size and latency histograms as JSON '
+                              '(native executor)')
+    batch_parser.add_argument('--numa', choices=sorted(bindings.NUMA_POLICIES), default='none',
+                              help='spread: pin workers to NUMA nodes in turn (native executor)')
     batch_parser.add_argument('--angle', type=float, default=30.0)
     batch_parser.add_argument('--min-faces', type=int, default=5)
     
@@ -42,11 +110,23 @@ def main():
         return 1
     
     try:
+        if args.cache_dir:
+            bindings.configure_cache(args.cache_dir, args.cache_max_mb * 1024 * 1024)
+        if args.island_cache_mb > 0:
+            bindings.configure_island_cache(args.island_cache_mb * 1024 * 1024)
+
         if args.command == 'unwrap':
             # Load mesh
             print(f"Loading {args.input}...")
             mesh = bindings.load_mesh(args.input)
             print(f"  {mesh.num_vertices} vertices, {mesh.num_triangles} triangles")
+            if args.weld is not None:
+                mesh, _remap = bindings.weld(mesh, args.weld)
+                print(f"  Welded to {mesh.num_vertices} vertices, {mesh.num_triangles} triangles")
+            if args.repair_nonmanifold:
+                mesh, report = bindings.repair_nonmanifold(mesh)
+                print(f"  Split {report['num_nonmanifold_edges']} non-manifold edges and "
+                      f"{report['num_nonmanifold_vertices']} vertices ({report['num_split_vertices']} copies)")
             
             # Unwrap
             params = {
@@ -54,9 +134,45 @@ def main():
                 'min_island_faces': args.min_faces,
                 'pack_islands': not args.no_pack,
                 'island_margin': args.margin,
+                'seam_method': args.seam_method,
+                'solver': args.solver,
+                'pin_method': args.pin_method,
+                'lscm_method': args.lscm_method,
+                'arap_iterations': args.arap_iterations,
+                'arap_time_limit': args.arap_time_limit,
+                'sort_policy': args.sort_policy,
+                'memory_budget': int(args.memory_budget * 1024 * 1024),
+                'lscm_ordering': args.ordering,
+                'vertex_order': args.vertex_order,
+                'output_order': args.output_order,
+                'compute_backend': args.compute_backend,
+                'island_instancing': args.instancing,
+                'island_scale': args.island_scale,
+                'lscm_precision': args.precision,
+                'max_chart_faces': args.max_chart_faces,
+                'max_chart_angle': args.max_chart_angle,
+                'uv_output': 'split' if args.split_vertices else 'shared',
             }
+            if args.pin:
+                params['pinned_vertices'] = args.pin
+            if args.seams:
+                with open(args.seams) as f:
+                    params['seam_edges'] = [[int(v) for v in line.split()] for line in f if line.strip()]
             print("Unwrapping...")
-            unwrapped, metrics = bindings.unwrap(mesh, params)
+            client = None
+            if args.cluster:
+                client = bindings.Cluster(args.cluster.split(','))
+                print(f"  Cluster of {client.num_workers} workers")
+            elif args.daemon is not None and not args.pin and not args.seams:
+                try:
+                    client = bindings.DaemonClient(args.daemon or None)
+                except ConnectionError as e:
+                    print(f"  {e}; unwrapping in-process")
+            if client is not None:
+                with client:
+                    unwrapped, metrics = client.unwrap(mesh, params)
+            else:
+                unwrapped, metrics = bindings.unwrap(mesh, params)
             
             # Save
             print(f"Saving to {args.output}...")
@@ -92,7 +208,12 @@ def main():
                 [str(f) for f in files],
                 args.output_dir,
                 params,
-                on_progress=progress
+                on_progress=progress,
+                prefetch=args.prefetch,
+                memory_budget=args.memory_budget * 1024 * 1024,
+                executor=args.executor,
+                histograms=bool(args.histograms),
+                numa=args.numa
             )
             
             print(f"\n\nBatch complete:")
@@ -103,6 +224,13 @@ def main():
             print(f"  Avg time: {results['summary']['avg_time']:.2f}s")
             print(f"  Avg stretch: {results['summary']['avg_stretch']:.2f}")
             print(f"  Avg coverage: {results['summary']['avg_coverage']*100:.1f}%")
+            if results.get('histograms'):
+                stretch = results['histograms']['stretch']
+                print(f"  Face stretch p50/p90/p99: {stretch['p50']:.3f} / {stretch['p90']:.3f} / "
+                      f"{stretch['p99']:.3f}")
+                with open(args.histograms, 'w') as f:
+                    json.dump(results['histograms'], f)
+                print(f"  Histograms: {args.histograms}")
             
         elif args.command == 'optimize':
             print(f"Loading {args.input}...")
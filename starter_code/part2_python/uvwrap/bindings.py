@@ -8,6 +8,9 @@ Alternative: Use pybind11 for cleaner bindings (bonus points).
 """
 
 import ctypes
+import importlib.machinery
+import importlib.util
+import json
 import os
 from pathlib import Path
 import numpy as np
@@ -89,6 +92,11 @@ class CMesh(ctypes.Structure):
     ]
 
 
+# UnwrapProgress from unwrap.h
+_UnwrapProgress = ctypes.CFUNCTYPE(ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int,
+                                   ctypes.c_float, ctypes.c_void_p)
+
+
 class CUnwrapParams(ctypes.Structure):
     """
     Matches UnwrapParams struct in unwrap.h
@@ -98,6 +106,209 @@ class CUnwrapParams(ctypes.Structure):
         ('min_island_faces', ctypes.c_int),
         ('pack_islands', ctypes.c_int),
         ('island_margin', ctypes.c_float),
+        ('seam_method', ctypes.c_int),
+        ('num_threads', ctypes.c_int),
+        ('solver', ctypes.c_int),
+        ('cg_threshold', ctypes.c_int),
+        ('cg_max_iterations', ctypes.c_int),
+        ('cg_tolerance', ctypes.c_float),
+        ('cg_preconditioner', ctypes.c_int),
+        ('lscm_plan', ctypes.c_void_p),
+        ('pack_method', ctypes.c_int),
+        ('pack_rotation', ctypes.c_int),
+        ('texel_density', ctypes.c_float),
+        ('udim_tiles', ctypes.c_int),
+        ('udim_resolution', ctypes.c_int),
+        ('pin_method', ctypes.c_int),
+        ('pinned_vertices', ctypes.POINTER(ctypes.c_int)),
+        ('num_pinned_vertices', ctypes.c_int),
+        ('lscm_precision', ctypes.c_int),
+        ('max_chart_faces', ctypes.c_int),
+        ('max_chart_angle', ctypes.c_float),
+        ('uv_output', ctypes.c_int),
+        ('lscm_method', ctypes.c_int),
+        ('arap_iterations', ctypes.c_int),
+        ('arap_time_limit', ctypes.c_float),
+        ('progress', _UnwrapProgress),
+        ('progress_user_data', ctypes.c_void_p),
+        ('cancel', ctypes.POINTER(ctypes.c_int)),
+        ('sort_policy', ctypes.c_int),
+        ('memory_budget', ctypes.c_longlong),
+        ('lscm_ordering', ctypes.c_int),
+        ('vertex_order', ctypes.c_int),
+        ('compute_backend', ctypes.c_int),
+        ('seam_edges', ctypes.POINTER(ctypes.c_int)),
+        ('num_seam_edges', ctypes.c_int),
+        ('island_instancing', ctypes.c_int),
+        ('island_scale', ctypes.c_int),
+        ('face_importance', ctypes.POINTER(ctypes.c_float)),
+        ('output_order', ctypes.c_int),
+        ('metrics_histograms', ctypes.c_void_p),
+    ]
+
+
+# SeamMethod values from unwrap.h
+SEAM_METHODS = {
+    'bfs': 0,
+    'mst': 1,
+    'cost': 2,
+    'cut': 3,
+}
+
+# PackMethod values from unwrap.h
+PACK_METHODS = {
+    'shelf': 0,
+    'skyline': 1,
+    'maxrects': 2,
+    'raster': 3,
+}
+
+# PackRotation values from unwrap.h
+PACK_ROTATIONS = {
+    'none': 0,
+    '90': 1,
+    'min_area': 2,
+}
+
+# LscmSolver values from lscm.h
+SOLVERS = {
+    'auto': 0,
+    'ldlt': 1,
+    'llt': 2,
+    'lu': 3,
+    'cholmod': 4,
+    'pardiso': 5,
+    'cg': 6,
+    'multigrid': 7,
+    'cuda_cg': 8,
+}
+
+# LscmPinMethod values from lscm.h
+PIN_METHODS = {
+    'auto': 0,
+    'double_sweep': 1,
+    'principal_axis': 2,
+    'farthest_pair': 3,
+}
+
+# LscmMethod values from lscm.h
+LSCM_METHODS = {
+    'pinned': 0,
+    'spectral': 1,
+    'abf': 2,
+}
+
+# UnwrapStage values from unwrap.h, by value
+UNWRAP_STAGES = ('topology', 'seams', 'islands', 'solve', 'packing', 'metrics', 'done')
+
+
+class UnwrapCancelled(RuntimeError):
+    """
+    unwrap() was stopped by its 'progress' callback or 'cancel' flag
+    """
+
+# LscmPrecision values from lscm.h
+PRECISIONS = {
+    'double': 0,
+    'float': 1,
+    'float_refined': 2,
+}
+
+# UvOutput values from unwrap.h
+UV_OUTPUTS = {
+    'shared': 0,
+    'split': 1,
+}
+
+# LscmOrdering values from lscm.h ('metis' needs a build with METIS)
+ORDERINGS = {
+    'auto': 0,
+    'amd': 1,
+    'colamd': 2,
+    'metis': 3,
+    'natural': 4,
+}
+
+# VertexOrder values from mesh_reorder.h
+VERTEX_ORDERS = {
+    'input': 0,
+    'rcm': 1,
+    'morton': 2,
+    'cache': 3,
+}
+
+# ComputeBackend values from unwrap.h ('cuda' needs a CUDA build and a
+# device, and falls back to the CPU otherwise)
+COMPUTE_BACKENDS = {
+    'auto': 0,
+    'cpu': 1,
+    'cuda': 2,
+}
+
+# IslandInstancing values from unwrap.h
+ISLAND_INSTANCING = {
+    'none': 0,
+    'reuse': 1,
+    'stack': 2,
+}
+
+# IslandScale values from unwrap.h
+ISLAND_SCALES = {
+    'normalized': 0,
+    'uniform': 1,
+}
+
+# SortPolicy values from unwrap.h
+SORT_POLICIES = {
+    'auto': 0,
+    'sequential': 1,
+    'parallel': 2,
+}
+
+# LscmPreconditioner values from lscm.h
+PRECONDITIONERS = {
+    'jacobi': 0,
+    'ichol': 1,
+}
+
+
+class CUnwrapStats(ctypes.Structure):
+    """
+    Matches UnwrapStats struct in unwrap.h
+    """
+    _fields_ = [
+        ('total_ns', ctypes.c_longlong),
+        ('topology_ns', ctypes.c_longlong),
+        ('seams_ns', ctypes.c_longlong),
+        ('islands_ns', ctypes.c_longlong),
+        ('lscm_ns', ctypes.c_longlong),
+        ('lscm_assembly_ns', ctypes.c_longlong),
+        ('lscm_factor_ns', ctypes.c_longlong),
+        ('lscm_solve_ns', ctypes.c_longlong),
+        ('packing_ns', ctypes.c_longlong),
+        ('metrics_ns', ctypes.c_longlong),
+        ('matrix_nonzeros', ctypes.c_longlong),
+        ('factor_nonzeros', ctypes.c_longlong),
+        ('solver_iterations', ctypes.c_longlong),
+        ('scratch_bytes', ctypes.c_longlong),
+        ('peak_island_faces', ctypes.c_int),
+        ('peak_island_vertices', ctypes.c_int),
+        ('num_solved_islands', ctypes.c_int),
+        ('num_nonmanifold_edges', ctypes.c_int),
+        ('num_nonmanifold_vertices', ctypes.c_int),
+        ('num_flagged_faces', ctypes.c_int),
+        ('num_fallback_islands', ctypes.c_int),
+        ('island_solve_ns', ctypes.POINTER(ctypes.c_longlong)),
+        ('cache_hit', ctypes.c_int),
+        ('peak_bytes', ctypes.c_longlong),
+        ('stage_peak_bytes', ctypes.c_longlong * 6),
+        ('stage_end_bytes', ctypes.c_longlong * 6),
+        ('island_peak_bytes', ctypes.POINTER(ctypes.c_longlong)),
+        ('num_memory_waits', ctypes.c_int),
+        ('num_dense_islands', ctypes.c_int),
+        ('num_closed_form_islands', ctypes.c_int),
+        ('num_instance_islands', ctypes.c_int),
+        ('num_cached_islands', ctypes.c_int),
     ]
 
 
@@ -111,6 +322,48 @@ class CUnwrapResult(ctypes.Structure):
         ('avg_stretch', ctypes.c_float),
         ('max_stretch', ctypes.c_float),
         ('coverage', ctypes.c_float),
+        ('solver_iterations', ctypes.c_int),
+        ('solver_residual', ctypes.c_float),
+        ('stats', CUnwrapStats),
+        ('stretch_l2', ctypes.c_float),
+        ('stretch_linf', ctypes.c_float),
+        ('angle_distortion', ctypes.c_float),
+        ('max_angle_distortion', ctypes.c_float),
+        ('num_degenerate_faces', ctypes.c_int),
+        ('overlap', ctypes.c_float),
+        ('num_tiles', ctypes.c_int),
+        ('vertex_remap', ctypes.POINTER(ctypes.c_int)),
+        ('uv_density', ctypes.c_float),
+        ('face_remap', ctypes.POINTER(ctypes.c_int)),
+    ]
+
+
+class CFaceMetrics(ctypes.Structure):
+    """
+    Matches FaceMetrics struct in unwrap.h
+    """
+    _fields_ = [
+        ('stretch', ctypes.POINTER(ctypes.c_float)),
+        ('stretch_l2', ctypes.POINTER(ctypes.c_float)),
+        ('stretch_linf', ctypes.POINTER(ctypes.c_float)),
+        ('angle_distortion', ctypes.POINTER(ctypes.c_float)),
+    ]
+
+
+class CUvCoverage(ctypes.Structure):
+    """
+    Matches UvCoverage struct in unwrap.h
+    """
+    _fields_ = [
+        ('resolution', ctypes.c_int),
+        ('coverage', ctypes.c_float),
+        ('overlap', ctypes.c_float),
+        ('covered_texels', ctypes.c_longlong),
+        ('overlap_texels', ctypes.c_longlong),
+        ('num_islands', ctypes.c_int),
+        ('island_texels', ctypes.POINTER(ctypes.c_longlong)),
+        ('island_texel_density', ctypes.POINTER(ctypes.c_float)),
+        ('backend', ctypes.c_int),
     ]
 
 
@@ -118,6 +371,36 @@ class CUnwrapResult(ctypes.Structure):
 _lib_path = find_library()
 _lib = ctypes.CDLL(str(_lib_path))
 
+
+def _load_native(lib_dir):
+    """
+    Load the optional _uvwrap_native module built next to the library
+
+    Built with -DUVUNWRAP_WITH_PYTHON=ON. unwrap() then reads the NumPy
+    arrays in place, releases the GIL for the whole call and returns
+    arrays owning the library's buffers instead of copies.
+
+    Returns:
+        The module, or None to use the ctypes path
+    """
+    import sys
+    if os.environ.get('UVWRAP_NO_NATIVE'):
+        return None
+    for suffix in importlib.machinery.EXTENSION_SUFFIXES:
+        path = lib_dir / ('_uvwrap_native' + suffix)
+        if not path.exists():
+            continue
+        if sys.platform == "win32":
+            os.add_dll_directory(str(lib_dir))
+        spec = importlib.util.spec_from_file_location('_uvwrap_native', path)
+        module = importlib.util.module_from_spec(spec)
+        spec.loader.exec_module(module)
+        return module
+    return None
+
+
+_native = _load_native(_lib_path.parent)
+
 # Define function signatures
 _lib.load_obj.argtypes = [ctypes.c_char_p]
 _lib.load_obj.restype = ctypes.POINTER(CMesh)
@@ -138,6 +421,154 @@ _lib.unwrap_mesh.restype = ctypes.POINTER(CMesh)
 _lib.free_unwrap_result.argtypes = [ctypes.POINTER(CUnwrapResult)]
 _lib.free_unwrap_result.restype = None
 
+_lib.compute_quality_metrics_ex.argtypes = [
+    ctypes.POINTER(CMesh),
+    ctypes.POINTER(CUnwrapResult),
+    ctypes.POINTER(CFaceMetrics),
+    ctypes.c_int
+]
+_lib.compute_quality_metrics_ex.restype = None
+
+_lib.compute_uv_coverage.argtypes = [
+    ctypes.POINTER(CMesh),
+    ctypes.POINTER(ctypes.c_int),
+    ctypes.c_int,
+    ctypes.c_int,
+    ctypes.c_int
+]
+_lib.compute_uv_coverage.restype = ctypes.POINTER(CUvCoverage)
+
+_lib.compute_quality_metrics_with_backend.argtypes = [
+    ctypes.POINTER(CMesh),
+    ctypes.POINTER(CUnwrapResult),
+    ctypes.POINTER(CFaceMetrics),
+    ctypes.c_int,
+    ctypes.c_int
+]
+_lib.compute_quality_metrics_with_backend.restype = None
+
+_lib.compute_uv_coverage_ex.argtypes = [
+    ctypes.POINTER(CMesh),
+    ctypes.POINTER(ctypes.c_int),
+    ctypes.c_int,
+    ctypes.c_int,
+    ctypes.c_int,
+    ctypes.c_int
+]
+_lib.compute_uv_coverage_ex.restype = ctypes.POINTER(CUvCoverage)
+
+_lib.compute_backend_available.argtypes = [ctypes.c_int]
+_lib.compute_backend_available.restype = ctypes.c_int
+
+_lib.free_uv_coverage.argtypes = [ctypes.POINTER(CUvCoverage)]
+_lib.free_uv_coverage.restype = None
+
+_lib.lscm_plan_create.argtypes = [ctypes.c_int]
+_lib.lscm_plan_create.restype = ctypes.c_void_p
+
+_lib.lscm_plan_free.argtypes = [ctypes.c_void_p]
+_lib.lscm_plan_free.restype = None
+
+
+class LscmPlan:
+    """
+    LSCM factorisation cache shared across unwrap() calls
+
+    Repeated unwraps of islands with unchanged connectivity (parameter
+    sweeps, re-unwrapping a deformed mesh) reuse the cached symbolic
+    factorisation and only redo the numeric one.
+    """
+
+    def __init__(self, max_entries=0):
+        self._handle = _lib.lscm_plan_create(int(max_entries))
+
+    def close(self):
+        if self._handle:
+            _lib.lscm_plan_free(self._handle)
+            self._handle = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def __del__(self):
+        self.close()
+
+
+_lib.unwrap_context_create.argtypes = []
+_lib.unwrap_context_create.restype = ctypes.c_void_p
+
+_lib.unwrap_context_free.argtypes = [ctypes.c_void_p]
+_lib.unwrap_context_free.restype = None
+
+_LogCallback = ctypes.CFUNCTYPE(None, ctypes.c_int, ctypes.c_char_p, ctypes.c_void_p)
+
+_lib.unwrap_context_set_log_callback.argtypes = [ctypes.c_void_p, _LogCallback, ctypes.c_void_p, ctypes.c_int]
+_lib.unwrap_context_set_log_callback.restype = None
+
+# UnwrapNumaPolicy values from unwrap.h
+NUMA_POLICIES = {'none': 0, 'spread': 1}
+
+_lib.unwrap_context_set_numa.argtypes = [ctypes.c_void_p, ctypes.c_int]
+_lib.unwrap_context_set_numa.restype = None
+
+_lib.unwrap_numa_node_count.argtypes = []
+_lib.unwrap_numa_node_count.restype = ctypes.c_int
+
+
+def numa_node_count():
+    """Number of NUMA nodes with CPUs (1 where the topology is unknown)"""
+    return _lib.unwrap_numa_node_count()
+
+_lib.unwrap_mesh_ctx.argtypes = [
+    ctypes.c_void_p,
+    ctypes.POINTER(CMesh),
+    ctypes.POINTER(CUnwrapParams),
+    ctypes.POINTER(ctypes.POINTER(CUnwrapResult))
+]
+_lib.unwrap_mesh_ctx.restype = ctypes.POINTER(CMesh)
+
+
+class UnwrapContext:
+    """
+    Reusable unwrap scratch memory for batch processing
+
+    Not thread-safe: use one context per worker thread.
+
+    Args:
+        log: Optional callable(level, message) receiving this context's log
+            messages (from any of its worker threads) instead of the
+            library-wide sink
+        log_level: Most verbose level passed to log (3 = info, 4 = debug)
+        numa: Worker placement on multi-socket machines, a key of
+            NUMA_POLICIES ('spread' pins the workers to the nodes)
+    """
+
+    def __init__(self, log=None, log_level=3, numa='none'):
+        policy = NUMA_POLICIES[numa]
+        self._handle = _lib.unwrap_context_create()
+        self._log = None
+        if log is not None:
+            self._log = _LogCallback(lambda level, message, _: log(level, message.decode('utf-8', 'replace')))
+            _lib.unwrap_context_set_log_callback(self._handle, self._log, None, log_level)
+        _lib.unwrap_context_set_numa(self._handle, policy)
+
+    def close(self):
+        if self._handle:
+            _lib.unwrap_context_free(self._handle)
+            self._handle = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def __del__(self):
+        self.close()
+
 
 class Mesh:
     """
@@ -154,6 +585,15 @@ class Mesh:
         self.triangles = np.array(triangles, dtype=np.int32)
         self.uvs = np.array(uvs, dtype=np.float32) if uvs is not None else None
 
+    @classmethod
+    def _wrap(cls, vertices, triangles, uvs):
+        """Mesh over arrays already in the right dtype, without copying"""
+        mesh = cls.__new__(cls)
+        mesh.vertices = vertices
+        mesh.triangles = triangles
+        mesh.uvs = uvs
+        return mesh
+
     @property
     def num_vertices(self):
         return len(self.vertices)
@@ -236,50 +676,469 @@ def save_mesh(mesh, filename):
         raise RuntimeError(f"Failed to save mesh to {filename}")
 
 
-def unwrap(mesh, params=None):
+_METRIC_FIELDS = ('avg_stretch', 'max_stretch', 'stretch_l2', 'stretch_linf',
+                  'angle_distortion', 'max_angle_distortion', 'num_degenerate_faces', 'coverage',
+                  'overlap')
+
+
+def _c_mesh_view(mesh, uvs):
     """
-    Unwrap mesh using LSCM
+    CMesh pointing into contiguous copies of the mesh arrays
+
+    Returns:
+        tuple: (c_mesh, arrays) - keep arrays alive while c_mesh is used
+    """
+    verts_flat = np.ascontiguousarray(mesh.vertices, dtype=np.float32).ravel()
+    tris_flat = np.ascontiguousarray(mesh.triangles, dtype=np.int32).ravel()
+    uvs_flat = np.ascontiguousarray(uvs, dtype=np.float32).ravel()
+
+    c_mesh = CMesh()
+    c_mesh.num_vertices = mesh.num_vertices
+    c_mesh.num_triangles = mesh.num_triangles
+    c_mesh.vertices = verts_flat.ctypes.data_as(ctypes.POINTER(ctypes.c_float))
+    c_mesh.triangles = tris_flat.ctypes.data_as(ctypes.POINTER(ctypes.c_int))
+    c_mesh.uvs = uvs_flat.ctypes.data_as(ctypes.POINTER(ctypes.c_float))
+    return c_mesh, (verts_flat, tris_flat, uvs_flat)
+
+
+def compute_backend_available(backend):
+    """True if a COMPUTE_BACKENDS key can run here ('cuda': built in and a device found)"""
+    return bool(_lib.compute_backend_available(COMPUTE_BACKENDS[backend]))
+
+
+def compute_metrics(mesh, uvs=None, per_face=False, num_threads=0, backend='auto'):
+    """
+    Compute UV quality metrics natively
 
     Args:
         mesh: Mesh object
-        params: Dictionary of parameters
+        uvs: UVs (N, 2) to measure instead of mesh.uvs
+        per_face: Also return per-face arrays (num_triangles,)
+        num_threads: Worker threads (0 = automatic)
+        backend: Key of COMPUTE_BACKENDS
 
     Returns:
-        tuple: (unwrapped_mesh, result_dict)
+        dict: Aggregate metrics; with per_face, also 'face_stretch',
+              'face_stretch_l2', 'face_stretch_linf', 'face_angle_distortion'
+    """
+    if uvs is None:
+        uvs = mesh.uvs
+    if uvs is None:
+        raise ValueError("Mesh has no UVs")
+
+    c_mesh, _keep = _c_mesh_view(mesh, uvs)
+
+    c_result = CUnwrapResult()
+    arrays = {}
+    c_faces = None
+    if per_face:
+        c_faces = CFaceMetrics()
+        for name, _ in CFaceMetrics._fields_:
+            arrays[name] = np.zeros(mesh.num_triangles, dtype=np.float32)
+            setattr(c_faces, name, arrays[name].ctypes.data_as(ctypes.POINTER(ctypes.c_float)))
+
+    _lib.compute_quality_metrics_with_backend(ctypes.byref(c_mesh), ctypes.byref(c_result),
+                                              ctypes.byref(c_faces) if c_faces is not None else None,
+                                              num_threads, COMPUTE_BACKENDS[backend])
+
+    result = {name: getattr(c_result, name) for name in _METRIC_FIELDS}
+    for name, values in arrays.items():
+        result['face_' + name] = values
+    return result
+
+
+def compute_coverage(mesh, uvs=None, island_ids=None, resolution=1024, num_threads=0, backend='auto'):
+    """
+    Rasterise UVs into a resolution x resolution grid natively
+
+    Args:
+        mesh: Mesh object
+        uvs: UVs (N, 2) to measure instead of mesh.uvs
+        island_ids: Island per face (num_triangles,), or None for one island
+        resolution: Grid side in texels
+        num_threads: Worker threads (0 = automatic)
+        backend: Key of COMPUTE_BACKENDS
+
+    Returns:
+        dict: 'coverage', 'overlap' (fractions of the grid), 'covered_texels',
+              'overlap_texels', per-island 'island_texels' and
+              'island_texel_density' (texels per unit of 3D length) arrays,
+              and the 'backend' that ran ('cpu' or 'cuda')
+    """
+    if uvs is None:
+        uvs = mesh.uvs
+    if uvs is None:
+        raise ValueError("Mesh has no UVs")
+
+    c_mesh, _keep = _c_mesh_view(mesh, uvs)
+    ids_ptr = None
+    num_islands = 0
+    if island_ids is not None:
+        ids = np.ascontiguousarray(island_ids, dtype=np.int32)
+        ids_ptr = ids.ctypes.data_as(ctypes.POINTER(ctypes.c_int))
+        num_islands = int(ids.max()) + 1 if len(ids) else 0
+
+    c_cov = _lib.compute_uv_coverage_ex(ctypes.byref(c_mesh), ids_ptr, num_islands,
+                                        resolution, num_threads, COMPUTE_BACKENDS[backend])
+    if not c_cov:
+        raise RuntimeError("compute_uv_coverage failed")
+
+    cov = c_cov.contents
+    n = cov.num_islands
+    result = {
+        'resolution': cov.resolution,
+        'coverage': cov.coverage,
+        'overlap': cov.overlap,
+        'covered_texels': cov.covered_texels,
+        'overlap_texels': cov.overlap_texels,
+        'island_texels': np.ctypeslib.as_array(cov.island_texels, shape=(n,)).copy(),
+        'island_texel_density': np.ctypeslib.as_array(cov.island_texel_density, shape=(n,)).copy(),
+        'backend': 'cuda' if cov.backend == COMPUTE_BACKENDS['cuda'] else 'cpu',
+    }
+    _lib.free_uv_coverage(c_cov)
+    return result
+
+
+_lib.uv_mesh_hash.argtypes = [ctypes.POINTER(CMesh), ctypes.c_int]
+_lib.uv_mesh_hash.restype = ctypes.c_uint64
+
+_lib.uv_mesh_topology_hash.argtypes = [ctypes.POINTER(CMesh), ctypes.c_int]
+_lib.uv_mesh_topology_hash.restype = ctypes.c_uint64
+
+
+def _hash_view(vertices, triangles, num_vertices):
+    """CMesh over contiguous copies of the arrays (vertices may be None)"""
+    tris_flat = np.ascontiguousarray(triangles, dtype=np.int32).ravel()
+    c_mesh = CMesh()
+    c_mesh.num_vertices = num_vertices
+    c_mesh.num_triangles = len(tris_flat) // 3
+    c_mesh.triangles = tris_flat.ctypes.data_as(ctypes.POINTER(ctypes.c_int))
+    keep = [tris_flat]
+    if vertices is not None:
+        verts_flat = np.ascontiguousarray(vertices, dtype=np.float32).ravel()
+        c_mesh.vertices = verts_flat.ctypes.data_as(ctypes.POINTER(ctypes.c_float))
+        keep.append(verts_flat)
+    return c_mesh, keep
+
+
+def mesh_hash(mesh, num_threads=0):
+    """
+    64-bit content hash of vertex positions and triangles (not UVs)
+
+    Non-cryptographic and much faster than hashlib on large meshes; use
+    it to key result caches.
+
+    Args:
+        mesh: Mesh object (or anything with vertices and triangles arrays)
+        num_threads: Worker threads (0 = automatic)
+
+    Returns:
+        int: Hash value
+    """
+    c_mesh, _keep = _hash_view(mesh.vertices, mesh.triangles, len(mesh.vertices))
+    return _lib.uv_mesh_hash(ctypes.byref(c_mesh), num_threads)
+
+
+def topology_hash(triangles, num_vertices, num_threads=0):
+    """
+    64-bit hash of triangles and vertex count only
+
+    Unchanged when vertices move, so it keys data that depends only on
+    connectivity (seams, LSCM plans).
+
+    Args:
+        triangles: Triangle indices (M, 3)
+        num_vertices: Number of vertices
+        num_threads: Worker threads (0 = automatic)
+
+    Returns:
+        int: Hash value
+    """
+    c_mesh, _keep = _hash_view(None, triangles, num_vertices)
+    return _lib.uv_mesh_topology_hash(ctypes.byref(c_mesh), num_threads)
+
+
+
+def _take_mesh(c_out):
+    """Copy a library-allocated CMesh into a Mesh and free it"""
+    out = c_out.contents
+    vertices = np.ctypeslib.as_array(out.vertices, shape=(out.num_vertices * 3,)).reshape(-1, 3).copy()
+    triangles = np.ctypeslib.as_array(out.triangles, shape=(out.num_triangles * 3,)).reshape(-1, 3).copy()
+    uvs = None
+    if out.uvs:
+        uvs = np.ctypeslib.as_array(out.uvs, shape=(out.num_vertices * 2,)).reshape(-1, 2).copy()
+    _lib.free_mesh(c_out)
+    return Mesh(vertices, triangles, uvs)
+
+
+class CMeshWeldStats(ctypes.Structure):
+    _fields_ = [
+        ('num_input_vertices', ctypes.c_int),
+        ('num_output_vertices', ctypes.c_int),
+        ('num_removed_triangles', ctypes.c_int),
+    ]
+
+
+_lib.weld_vertices.argtypes = [ctypes.POINTER(CMesh), ctypes.c_float, ctypes.c_int,
+                               ctypes.POINTER(ctypes.c_int), ctypes.POINTER(CMeshWeldStats)]
+_lib.weld_vertices.restype = ctypes.POINTER(CMesh)
+
+
+def weld(mesh, epsilon=1e-6, num_threads=0):
+    """
+    Merge vertices closer than epsilon (e.g. OBJ triangle soups)
+
+    Args:
+        mesh: Mesh object
+        epsilon: Distance tolerance (<= 0 merges only identical positions)
+        num_threads: Worker threads (0 = automatic)
+
+    Returns:
+        tuple: (welded Mesh, remap) - remap[i] is the welded vertex of input vertex i
+    """
+    uvs = mesh.uvs
+    c_mesh, _keep = _hash_view(mesh.vertices, mesh.triangles, mesh.num_vertices)
+    if uvs is not None:
+        uvs_flat = np.ascontiguousarray(uvs, dtype=np.float32).ravel()
+        c_mesh.uvs = uvs_flat.ctypes.data_as(ctypes.POINTER(ctypes.c_float))
+        _keep.append(uvs_flat)
+    remap = np.empty(mesh.num_vertices, dtype=np.int32)
+    stats = CMeshWeldStats()
+    c_out = _lib.weld_vertices(ctypes.byref(c_mesh), epsilon, num_threads,
+                               remap.ctypes.data_as(ctypes.POINTER(ctypes.c_int)), ctypes.byref(stats))
+    if not c_out:
+        raise RuntimeError("Failed to weld mesh")
+    return _take_mesh(c_out), remap
+
+
+_lib.reorder_mesh.argtypes = [ctypes.POINTER(CMesh), ctypes.c_int,
+                              ctypes.POINTER(ctypes.c_int), ctypes.POINTER(ctypes.c_int)]
+_lib.reorder_mesh.restype = ctypes.POINTER(CMesh)
+
+
+def reorder(mesh, order='rcm'):
+    """
+    Renumber vertices and faces for cache locality (same geometry and winding)
+
+    Args:
+        mesh: Mesh object
+        order: Key of VERTEX_ORDERS ('rcm', 'morton' or 'cache' for GPU
+               vertex-cache order; 'input' copies)
+
+    Returns:
+        tuple: (reordered Mesh, vertex_remap, face_remap) - vertex_remap[i] /
+        face_remap[i] is the output vertex / face of input vertex / face i
+    """
+    uvs = mesh.uvs
+    c_mesh, _keep = _hash_view(mesh.vertices, mesh.triangles, mesh.num_vertices)
+    if uvs is not None:
+        uvs_flat = np.ascontiguousarray(uvs, dtype=np.float32).ravel()
+        c_mesh.uvs = uvs_flat.ctypes.data_as(ctypes.POINTER(ctypes.c_float))
+        _keep.append(uvs_flat)
+    vertex_remap = np.empty(mesh.num_vertices, dtype=np.int32)
+    face_remap = np.empty(mesh.num_triangles, dtype=np.int32)
+    c_out = _lib.reorder_mesh(ctypes.byref(c_mesh), VERTEX_ORDERS[order],
+                              vertex_remap.ctypes.data_as(ctypes.POINTER(ctypes.c_int)),
+                              face_remap.ctypes.data_as(ctypes.POINTER(ctypes.c_int)))
+    if not c_out:
+        raise RuntimeError("Failed to reorder mesh")
+    return _take_mesh(c_out), vertex_remap, face_remap
+
+
+class CManifoldReport(ctypes.Structure):
+    _fields_ = [
+        ('num_nonmanifold_edges', ctypes.c_int),
+        ('num_nonmanifold_vertices', ctypes.c_int),
+        ('num_split_vertices', ctypes.c_int),
+    ]
+
+
+_lib.check_manifold.argtypes = [ctypes.POINTER(CMesh), ctypes.POINTER(CManifoldReport)]
+_lib.check_manifold.restype = ctypes.c_int
+
+_lib.repair_nonmanifold.argtypes = [ctypes.POINTER(CMesh), ctypes.POINTER(CManifoldReport)]
+_lib.repair_nonmanifold.restype = ctypes.POINTER(CMesh)
+
+
+def _report_dict(report):
+    return {name: getattr(report, name) for name, _ in CManifoldReport._fields_}
+
+
+def check_manifold(mesh):
+    """
+    Count non-manifold edges (more than two faces) and vertices (faces
+    forming more than one fan)
+
+    Returns:
+        dict: num_nonmanifold_edges, num_nonmanifold_vertices, num_split_vertices (0)
+    """
+    c_mesh, _keep = _hash_view(mesh.vertices, mesh.triangles, mesh.num_vertices)
+    report = CManifoldReport()
+    if _lib.check_manifold(ctypes.byref(c_mesh), ctypes.byref(report)) < 0:
+        raise RuntimeError("Invalid mesh")
+    return _report_dict(report)
+
+
+def repair_nonmanifold(mesh):
+    """
+    Give every extra fan of a non-manifold vertex its own vertex copy
+
+    Copies are appended after the input vertices and triangles keep their
+    order, so the source of output vertex repaired.triangles[i, k] is
+    mesh.triangles[i, k].
+
+    Returns:
+        tuple: (repaired Mesh, report dict as check_manifold())
+    """
+    c_mesh, _keep = _hash_view(mesh.vertices, mesh.triangles, mesh.num_vertices)
+    if mesh.uvs is not None:
+        uvs_flat = np.ascontiguousarray(mesh.uvs, dtype=np.float32).ravel()
+        c_mesh.uvs = uvs_flat.ctypes.data_as(ctypes.POINTER(ctypes.c_float))
+        _keep.append(uvs_flat)
+    report = CManifoldReport()
+    c_out = _lib.repair_nonmanifold(ctypes.byref(c_mesh), ctypes.byref(report))
+    if not c_out:
+        raise RuntimeError("Invalid mesh")
+    return _take_mesh(c_out), _report_dict(report)
+
+
+FACE_FLAG_DUPLICATE_INDEX = 1
+FACE_FLAG_ZERO_AREA = 2
+FACE_FLAG_SLIVER = 4
+
+_lib.classify_faces.argtypes = [ctypes.POINTER(CMesh), ctypes.POINTER(ctypes.c_ubyte), ctypes.c_int]
+_lib.classify_faces.restype = ctypes.c_int
+
+
+def classify_faces(mesh, num_threads=0):
+    """
+    Flag degenerate faces (repeated corner, zero area, sliver)
+
+    Returns:
+        np.ndarray: uint8 FACE_FLAG_* bits per triangle (0 = usable)
+    """
+    c_mesh, _keep = _hash_view(mesh.vertices, mesh.triangles, mesh.num_vertices)
+    flags = np.zeros(mesh.num_triangles, dtype=np.uint8)
+    if _lib.classify_faces(ctypes.byref(c_mesh), flags.ctypes.data_as(ctypes.POINTER(ctypes.c_ubyte)),
+                           num_threads) < 0:
+        raise RuntimeError("Invalid mesh")
+    return flags
+
+def _stats_dict(c_result):
+    """
+    Copy UnwrapStats into a dict; per-island and per-stage arrays become
+    lists (stages in UnwrapStage order: topology, seams, islands, solve,
+    packing, metrics)
+    """
+    c_stats = c_result.stats
+    per_island = ('island_solve_ns', 'island_peak_bytes')
+    stats = {name: getattr(c_stats, name)
+             for name, _ in CUnwrapStats._fields_ if name not in per_island}
+    for name in per_island:
+        values = getattr(c_stats, name)
+        stats[name] = values[:c_result.num_islands] if values else []
+    for name in ('stage_peak_bytes', 'stage_end_bytes'):
+        stats[name] = list(stats[name])
+    return stats
+
+
+def _c_params(params, plan=None):
+    """
+    CUnwrapParams from a parameter dict (missing keys take the defaults)
     """
-    # Default parameters
     if params is None:
         params = {}
-    
-    # Create C parameters
+
     c_params = CUnwrapParams()
     c_params.angle_threshold = params.get('angle_threshold', 30.0)
     c_params.min_island_faces = params.get('min_island_faces', 5)
     c_params.pack_islands = int(params.get('pack_islands', True))
     c_params.island_margin = params.get('island_margin', 0.02)
-    
-    # Create C input mesh
-    c_mesh_in = CMesh()
-    c_mesh_in.num_vertices = mesh.num_vertices
-    c_mesh_in.num_triangles = mesh.num_triangles
-    
-    verts_flat = mesh.vertices.flatten().astype(np.float32)
-    tris_flat = mesh.triangles.flatten().astype(np.int32)
-    
-    c_mesh_in.vertices = verts_flat.ctypes.data_as(ctypes.POINTER(ctypes.c_float))
-    c_mesh_in.triangles = tris_flat.ctypes.data_as(ctypes.POINTER(ctypes.c_int))
-    c_mesh_in.uvs = None
-    
-    # Call C library
-    c_result_ptr = ctypes.POINTER(CUnwrapResult)()
-    c_mesh_out = _lib.unwrap_mesh(
-        ctypes.byref(c_mesh_in),
-        ctypes.byref(c_params),
-        ctypes.byref(c_result_ptr)
-    )
-    
-    if not c_mesh_out:
-        raise RuntimeError("UV unwrapping failed")
+    c_params.seam_method = SEAM_METHODS[params.get('seam_method', 'bfs')]
+    c_params.num_threads = int(params.get('num_threads', 0))
+    c_params.solver = SOLVERS[params.get('solver', 'auto')]
+    c_params.cg_threshold = int(params.get('cg_threshold', 0))
+    c_params.cg_max_iterations = int(params.get('cg_max_iterations', 0))
+    c_params.cg_tolerance = float(params.get('cg_tolerance', 0.0))
+    c_params.cg_preconditioner = PRECONDITIONERS[params.get('cg_preconditioner', 'jacobi')]
+    c_params.lscm_plan = plan._handle if plan is not None else None
+    c_params.pack_method = PACK_METHODS[params.get('pack_method', 'shelf')]
+    c_params.pack_rotation = PACK_ROTATIONS[str(params.get('pack_rotation', 'none'))]
+    c_params.texel_density = float(params.get('texel_density', 0.0))
+    c_params.udim_tiles = int(params.get('udim_tiles', 0))
+    c_params.udim_resolution = int(params.get('udim_resolution', 0))
+    c_params.pin_method = PIN_METHODS[params.get('pin_method', 'auto')]
+    pins = params.get('pinned_vertices')
+    if pins is not None and len(pins) > 0:
+        # Kept on the struct so the array outlives the call
+        c_params._pins = (ctypes.c_int * len(pins))(*[int(v) for v in pins])
+        c_params.pinned_vertices = c_params._pins
+        c_params.num_pinned_vertices = len(pins)
+    c_params.lscm_precision = PRECISIONS[params.get('lscm_precision', 'double')]
+    c_params.max_chart_faces = int(params.get('max_chart_faces', 0))
+    c_params.max_chart_angle = float(params.get('max_chart_angle', 0.0))
+    c_params.uv_output = UV_OUTPUTS[params.get('uv_output', 'shared')]
+    c_params.lscm_method = LSCM_METHODS[params.get('lscm_method', 'pinned')]
+    c_params.arap_iterations = int(params.get('arap_iterations', 0))
+    c_params.arap_time_limit = float(params.get('arap_time_limit', 0.0))
+    c_params.sort_policy = SORT_POLICIES[params.get('sort_policy', 'auto')]
+    c_params.memory_budget = int(params.get('memory_budget', 0))
+    c_params.lscm_ordering = ORDERINGS[params.get('lscm_ordering', 'auto')]
+    c_params.vertex_order = VERTEX_ORDERS[params.get('vertex_order', 'input')]
+    c_params.output_order = VERTEX_ORDERS[params.get('output_order', 'input')]
+    c_params.compute_backend = COMPUTE_BACKENDS[params.get('compute_backend', 'auto')]
+    c_params.island_instancing = ISLAND_INSTANCING[params.get('island_instancing', 'none')]
+    seams = params.get('seam_edges')
+    if seams is not None:
+        # User seams as (k, 2) vertex pairs; an empty list means no seams at all
+        pairs = np.ascontiguousarray(seams, dtype=np.int32).reshape(-1, 2)
+        c_params._seams = (ctypes.c_int * max(pairs.size, 1))(*pairs.ravel().tolist())
+        c_params.seam_edges = c_params._seams
+        c_params.num_seam_edges = len(pairs)
+    c_params.island_scale = ISLAND_SCALES[params.get('island_scale', 'normalized')]
+    importance = params.get('face_importance')
+    if importance is not None:
+        # Per input face; kept on the struct so the array outlives the call
+        c_params._importance = np.ascontiguousarray(importance, dtype=np.float32).ravel()
+        c_params.face_importance = c_params._importance.ctypes.data_as(ctypes.POINTER(ctypes.c_float))
+    on_progress = params.get('progress')
+    if on_progress is not None:
+        def progress(stage, islands_done, num_islands, fraction, _user):
+            try:
+                stop = bool(on_progress(UNWRAP_STAGES[stage], islands_done, num_islands, fraction))
+            except Exception:
+                # Exceptions cannot cross the C call; stop instead
+                stop = True
+            if stop:
+                c_params._cancel_requested = True
+            return int(stop)
+        # Kept on the struct so the callback outlives the call
+        c_params._progress = _UnwrapProgress(progress)
+        c_params.progress = c_params._progress
+    cancel = params.get('cancel')
+    if cancel is not None:
+        c_params._cancel = cancel
+        c_params.cancel = ctypes.pointer(cancel)
+    return c_params
+
+
+def _cancel_requested(c_params):
+    """
+    Whether a failed call was cancelled through c_params
+    """
+    cancel = getattr(c_params, '_cancel', None)
+    return getattr(c_params, '_cancel_requested', False) or (cancel is not None and cancel.value != 0)
+
+
+def _take_unwrap_output(c_mesh_out, c_result_ptr):
+    """
+    Copy an unwrap_mesh()-style output into Python and free it
+
+    Returns:
+        tuple: (unwrapped_mesh, result_dict)
+    """
+    if not c_mesh_out:
+        raise RuntimeError("UV unwrapping failed")
     
     # Convert result mesh
     num_verts = c_mesh_out.contents.num_vertices
@@ -300,7 +1159,25 @@ def unwrap(mesh, params=None):
         'avg_stretch': c_result_ptr.contents.avg_stretch,
         'max_stretch': c_result_ptr.contents.max_stretch,
         'coverage': c_result_ptr.contents.coverage,
+        'overlap': c_result_ptr.contents.overlap,
+        'num_tiles': c_result_ptr.contents.num_tiles,
+        'uv_density': c_result_ptr.contents.uv_density,
+        'solver_iterations': c_result_ptr.contents.solver_iterations,
+        'solver_residual': c_result_ptr.contents.solver_residual,
+        'stretch_l2': c_result_ptr.contents.stretch_l2,
+        'stretch_linf': c_result_ptr.contents.stretch_linf,
+        'angle_distortion': c_result_ptr.contents.angle_distortion,
+        'max_angle_distortion': c_result_ptr.contents.max_angle_distortion,
+        'stats': _stats_dict(c_result_ptr.contents),
+        'face_island_ids': np.ctypeslib.as_array(c_result_ptr.contents.face_island_ids,
+                                                 shape=(num_tris,)).copy(),
     }
+    if c_result_ptr.contents.vertex_remap:
+        result_dict['vertex_remap'] = np.ctypeslib.as_array(c_result_ptr.contents.vertex_remap,
+                                                            shape=(num_verts,)).copy()
+    if c_result_ptr.contents.face_remap:
+        result_dict['face_remap'] = np.ctypeslib.as_array(c_result_ptr.contents.face_remap,
+                                                          shape=(num_tris,)).copy()
     
     # Free C memory
     _lib.free_unwrap_result(c_result_ptr)
@@ -309,6 +1186,1000 @@ def unwrap(mesh, params=None):
     return Mesh(vertices, triangles, uvs), result_dict
 
 
+def unwrap(mesh, params=None, plan=None, context=None):
+    """
+    Unwrap mesh using LSCM
+
+    Args:
+        mesh: Mesh object
+        params: Dictionary of parameters. 'progress' may be a
+                callable(stage, islands_done, num_islands, fraction),
+                called from library threads with a name from UNWRAP_STAGES;
+                a truthy return cancels. 'cancel' may be a ctypes.c_int
+                that another thread sets to 1 to cancel.
+        plan: Optional LscmPlan reused across calls
+        context: Optional UnwrapContext reused across calls
+
+    Returns:
+        tuple: (unwrapped_mesh, result_dict)
+
+    Raises:
+        UnwrapCancelled: The unwrap was cancelled
+    """
+    c_params = _c_params(params, plan)
+
+    if _native is not None:
+        try:
+            vertices, triangles, uvs, island_ids, result_dict = _native.unwrap(
+                mesh.vertices, mesh.triangles, c_params,
+                (context._handle or 0) if context is not None else 0)
+        except RuntimeError:
+            if _cancel_requested(c_params):
+                raise UnwrapCancelled("UV unwrapping cancelled") from None
+            raise
+        result_dict['face_island_ids'] = island_ids
+        return Mesh._wrap(vertices, triangles, uvs), result_dict
+    
+    # Create C input mesh
+    c_mesh_in = CMesh()
+    c_mesh_in.num_vertices = mesh.num_vertices
+    c_mesh_in.num_triangles = mesh.num_triangles
+    
+    verts_flat = np.ascontiguousarray(mesh.vertices, dtype=np.float32).ravel()
+    tris_flat = np.ascontiguousarray(mesh.triangles, dtype=np.int32).ravel()
+    
+    c_mesh_in.vertices = verts_flat.ctypes.data_as(ctypes.POINTER(ctypes.c_float))
+    c_mesh_in.triangles = tris_flat.ctypes.data_as(ctypes.POINTER(ctypes.c_int))
+    c_mesh_in.uvs = None
+    
+    # Call C library
+    c_result_ptr = ctypes.POINTER(CUnwrapResult)()
+    if context is not None:
+        c_mesh_out = _lib.unwrap_mesh_ctx(
+            context._handle,
+            ctypes.byref(c_mesh_in),
+            ctypes.byref(c_params),
+            ctypes.byref(c_result_ptr)
+        )
+    else:
+        c_mesh_out = _lib.unwrap_mesh(
+            ctypes.byref(c_mesh_in),
+            ctypes.byref(c_params),
+            ctypes.byref(c_result_ptr)
+        )
+    if not c_mesh_out and _cancel_requested(c_params):
+        raise UnwrapCancelled("UV unwrapping cancelled")
+    
+    return _take_unwrap_output(c_mesh_out, c_result_ptr)
+
+
+class CUnwrapCacheStats(ctypes.Structure):
+    """
+    Matches UnwrapCacheStats struct in unwrap_cache.h
+    """
+    _fields_ = [
+        ('hits', ctypes.c_longlong),
+        ('misses', ctypes.c_longlong),
+        ('stores', ctypes.c_longlong),
+        ('evictions', ctypes.c_longlong),
+        ('num_entries', ctypes.c_int),
+        ('total_bytes', ctypes.c_longlong),
+        ('max_bytes', ctypes.c_longlong),
+    ]
+
+
+_lib.unwrap_cache_configure.argtypes = [ctypes.c_char_p, ctypes.c_longlong]
+_lib.unwrap_cache_configure.restype = ctypes.c_int
+
+_lib.unwrap_cache_stats.argtypes = [ctypes.POINTER(CUnwrapCacheStats)]
+_lib.unwrap_cache_stats.restype = ctypes.c_int
+
+_lib.unwrap_cache_clear.argtypes = []
+_lib.unwrap_cache_clear.restype = ctypes.c_int
+
+
+def configure_cache(directory, max_bytes=0):
+    """
+    Cache unwrap results on disk for every later unwrap in this process
+
+    unwrap(), unwrap_batch() and the processor then return a stored result
+    when the same mesh is unwrapped with the same parameters (the result's
+    stats['cache_hit'] is 1). Processes may share the directory; without
+    this call the UVUNWRAP_CACHE_DIR environment variable is used.
+
+    Args:
+        directory: Cache directory (created if missing), or None to disable
+        max_bytes: Byte budget, least recently used entries are evicted
+                   (0 = 1 GiB)
+    """
+    path = str(directory).encode('utf-8') if directory is not None else None
+    if _lib.unwrap_cache_configure(path, max_bytes) != 0:
+        raise RuntimeError(f"Cannot open unwrap cache in {directory}")
+
+
+def cache_stats():
+    """
+    Counters of the configured cache, or None if caching is off
+
+    Returns:
+        dict: hits, misses, stores, evictions (this process) and
+              num_entries, total_bytes, max_bytes (the directory)
+    """
+    c_stats = CUnwrapCacheStats()
+    if _lib.unwrap_cache_stats(ctypes.byref(c_stats)) != 0:
+        return None
+    return {name: getattr(c_stats, name) for name, _ in CUnwrapCacheStats._fields_}
+
+
+def clear_cache():
+    """
+    Remove every entry of the configured cache
+
+    Returns:
+        int: Entries removed (0 if caching is off)
+    """
+    return max(_lib.unwrap_cache_clear(), 0)
+
+
+class CUnwrapIslandCacheStats(ctypes.Structure):
+    """
+    Matches UnwrapIslandCacheStats struct in unwrap_cache.h
+    """
+    _fields_ = [
+        ('hits', ctypes.c_longlong),
+        ('disk_hits', ctypes.c_longlong),
+        ('misses', ctypes.c_longlong),
+        ('stores', ctypes.c_longlong),
+        ('disk_stores', ctypes.c_longlong),
+        ('evictions', ctypes.c_longlong),
+        ('num_entries', ctypes.c_int),
+        ('total_bytes', ctypes.c_longlong),
+        ('max_bytes', ctypes.c_longlong),
+    ]
+
+
+_lib.unwrap_island_cache_configure.argtypes = [ctypes.c_longlong, ctypes.c_int]
+_lib.unwrap_island_cache_configure.restype = ctypes.c_int
+
+_lib.unwrap_island_cache_stats.argtypes = [ctypes.POINTER(CUnwrapIslandCacheStats)]
+_lib.unwrap_island_cache_stats.restype = ctypes.c_int
+
+_lib.unwrap_island_cache_clear.argtypes = []
+_lib.unwrap_island_cache_clear.restype = ctypes.c_int
+
+
+def configure_island_cache(max_bytes, persist_faces=0):
+    """
+    Remember solved islands for every later unwrap in this process
+
+    An island whose geometry and solver options match an earlier solve
+    takes its UVs without running LSCM (stats['num_cached_islands']), so
+    re-unwrapping an edited mesh only solves the islands that changed.
+    Without this call UVUNWRAP_ISLAND_CACHE_MAX_BYTES is used.
+
+    Args:
+        max_bytes: Memory budget, least recently used islands are dropped
+                   (0 turns the island cache off)
+        persist_faces: Islands of at least this many faces also go to the
+                       on-disk cache while one is configured (0 = 512,
+                       negative = never)
+    """
+    if _lib.unwrap_island_cache_configure(max_bytes, persist_faces) != 0:
+        raise ValueError(f"Invalid island cache budget {max_bytes}")
+
+
+def island_cache_stats():
+    """
+    Counters of the island cache, or None if it is off
+
+    Returns:
+        dict: hits, disk_hits, misses, stores, disk_stores, evictions and
+              num_entries, total_bytes, max_bytes
+    """
+    c_stats = CUnwrapIslandCacheStats()
+    if _lib.unwrap_island_cache_stats(ctypes.byref(c_stats)) != 0:
+        return None
+    return {name: getattr(c_stats, name) for name, _ in CUnwrapIslandCacheStats._fields_}
+
+
+def clear_island_cache():
+    """
+    Drop every island the island cache holds in memory
+
+    Returns:
+        int: Islands dropped (0 if the island cache is off)
+    """
+    return max(_lib.unwrap_island_cache_clear(), 0)
+
+
+class CUnwrapBatchFileStats(ctypes.Structure):
+    """
+    Matches UnwrapBatchFileStats struct in unwrap_batch.h
+    """
+    _fields_ = [
+        ('status', ctypes.c_int),
+        ('num_vertices', ctypes.c_int),
+        ('num_triangles', ctypes.c_int),
+        ('num_islands', ctypes.c_int),
+        ('avg_stretch', ctypes.c_float),
+        ('max_stretch', ctypes.c_float),
+        ('coverage', ctypes.c_float),
+        ('overlap', ctypes.c_float),
+        ('load_ns', ctypes.c_longlong),
+        ('unwrap_ns', ctypes.c_longlong),
+        ('save_ns', ctypes.c_longlong),
+    ]
+
+
+# UnwrapBatchStatus values from unwrap_batch.h, by value
+BATCH_STATUS = ('ok', 'load_failed', 'unwrap_failed', 'save_failed')
+
+_UnwrapBatchProgress = ctypes.CFUNCTYPE(None, ctypes.c_int, ctypes.c_int, ctypes.c_int,
+                                        ctypes.c_int, ctypes.c_void_p)
+
+class CUnwrapBatchOptions(ctypes.Structure):
+    """
+    Matches UnwrapBatchOptions struct in unwrap_batch.h
+    """
+    _fields_ = [
+        ('num_threads', ctypes.c_int),
+        ('prefetch', ctypes.c_int),
+        ('memory_budget', ctypes.c_longlong),
+        ('progress', _UnwrapBatchProgress),
+        ('user_data', ctypes.c_void_p),
+        ('histograms', ctypes.c_void_p),
+        ('numa', ctypes.c_int),
+    ]
+
+
+# Bucket layout from uv_histogram.h
+UV_HISTOGRAM_BUCKETS = (44 - (-20)) * 16 + 2
+
+class CUvHistogram(ctypes.Structure):
+    """
+    Matches UvHistogram struct in uv_histogram.h
+    """
+    _fields_ = [
+        ('count', ctypes.c_longlong),
+        ('sum', ctypes.c_double),
+        ('min', ctypes.c_double),
+        ('max', ctypes.c_double),
+        ('buckets', ctypes.c_longlong * UV_HISTOGRAM_BUCKETS),
+    ]
+
+
+class CUnwrapBatchHistograms(ctypes.Structure):
+    """
+    Matches UnwrapBatchHistograms struct in unwrap_batch.h
+    """
+    _fields_ = [
+        ('stretch', CUvHistogram),
+        ('angle_distortion', CUvHistogram),
+        ('island_faces', CUvHistogram),
+        ('load_ns', CUvHistogram),
+        ('unwrap_ns', CUvHistogram),
+        ('save_ns', CUvHistogram),
+        ('stage_ns', CUvHistogram * 6),
+    ]
+
+
+_lib.unwrap_batch_histograms_clear.argtypes = [ctypes.POINTER(CUnwrapBatchHistograms)]
+_lib.unwrap_batch_histograms_clear.restype = None
+
+_lib.unwrap_batch_histograms_to_json.argtypes = [
+    ctypes.POINTER(CUnwrapBatchHistograms),
+    ctypes.c_char_p,
+    ctypes.c_size_t
+]
+_lib.unwrap_batch_histograms_to_json.restype = ctypes.c_size_t
+
+
+_lib.unwrap_batch_options_default.argtypes = [ctypes.POINTER(CUnwrapBatchOptions)]
+_lib.unwrap_batch_options_default.restype = None
+
+_lib.unwrap_batch_with_options.argtypes = [
+    ctypes.POINTER(ctypes.c_char_p),
+    ctypes.POINTER(ctypes.c_char_p),
+    ctypes.c_int,
+    ctypes.POINTER(CUnwrapParams),
+    ctypes.POINTER(CUnwrapBatchOptions),
+    ctypes.POINTER(CUnwrapBatchFileStats)
+]
+_lib.unwrap_batch_with_options.restype = ctypes.c_int
+
+
+def unwrap_batch(inputs, outputs, params=None, num_threads=0, on_progress=None,
+                 prefetch=0, memory_budget=0, histograms=False, numa='none'):
+    """
+    Unwrap many files in one native call
+
+    Parsing, solving and writing are pipelined on library threads, one
+    unwrap context per worker. Paths ending in .uvmb use the binary mesh
+    format, .ply and .glb binary PLY and GLB, anything else OBJ.
+
+    Args:
+        inputs: Input paths
+        outputs: Output paths (same length)
+        params: Dictionary of parameters, shared by every file
+        num_threads: Compute workers (0 = one per core)
+        on_progress: Optional callable(done, total, index, status) called
+                     from a library thread as files finish
+        prefetch: Parsed inputs queued ahead of the workers (0 = one per
+                  worker)
+        memory_budget: Bytes of input and output meshes the pipeline may
+                       hold before the reader waits (0 = no limit)
+        histograms: Also return the batch's distributions (per-face
+                    stretch and angle error, island sizes, per-file and
+                    per-stage times), as parsed from
+                    unwrap_batch_histograms_to_json()
+        numa: Key of NUMA_POLICIES; 'spread' pins compute workers to the
+              nodes in turn and keeps each file's island workers on its
+              worker's node
+
+    Returns:
+        list: Per-file dicts with 'status' (see BATCH_STATUS), sizes,
+              metrics and 'load_time' / 'unwrap_time' / 'save_time' seconds;
+              with histograms, a (list, dict) tuple
+    """
+    if len(inputs) != len(outputs):
+        raise ValueError("inputs and outputs differ in length")
+    n = len(inputs)
+    c_inputs = (ctypes.c_char_p * n)(*[str(p).encode('utf-8') for p in inputs])
+    c_outputs = (ctypes.c_char_p * n)(*[str(p).encode('utf-8') for p in outputs])
+    c_params = _c_params(params)
+    c_stats = (CUnwrapBatchFileStats * n)()
+
+    def progress(done, total, index, status, _user):
+        if on_progress is not None:
+            on_progress(done, total, index, BATCH_STATUS[status])
+
+    # c_options keeps the callback object alive for the whole call
+    c_options = CUnwrapBatchOptions()
+    _lib.unwrap_batch_options_default(ctypes.byref(c_options))
+    c_options.num_threads = int(num_threads)
+    c_options.prefetch = int(prefetch)
+    c_options.memory_budget = int(memory_budget)
+    c_options.numa = NUMA_POLICIES[numa]
+    c_options.progress = _UnwrapBatchProgress(progress)
+    c_histograms = None
+    if histograms:
+        c_histograms = CUnwrapBatchHistograms()
+        _lib.unwrap_batch_histograms_clear(ctypes.byref(c_histograms))
+        c_options.histograms = ctypes.cast(ctypes.byref(c_histograms), ctypes.c_void_p)
+    failed = _lib.unwrap_batch_with_options(c_inputs, c_outputs, n, ctypes.byref(c_params),
+                                            ctypes.byref(c_options), c_stats)
+    if failed < 0:
+        raise RuntimeError("unwrap_batch rejected its arguments")
+
+    files = [_batch_stats_dict(s) for s in c_stats]
+    if c_histograms is None:
+        return files
+    size = _lib.unwrap_batch_histograms_to_json(ctypes.byref(c_histograms), None, 0)
+    text = ctypes.create_string_buffer(size + 1)
+    _lib.unwrap_batch_histograms_to_json(ctypes.byref(c_histograms), text, size + 1)
+    return files, json.loads(text.value.decode('utf-8'))
+
+
+def _batch_stats_dict(s):
+    """
+    CUnwrapBatchFileStats as a dict
+    """
+    return {
+        'status': BATCH_STATUS[s.status],
+        'vertices': s.num_vertices,
+        'triangles': s.num_triangles,
+        'num_islands': s.num_islands,
+        'avg_stretch': s.avg_stretch,
+        'max_stretch': s.max_stretch,
+        'coverage': s.coverage,
+        'overlap': s.overlap,
+        'load_time': s.load_ns * 1e-9,
+        'unwrap_time': s.unwrap_ns * 1e-9,
+        'save_time': s.save_ns * 1e-9,
+    }
+
+
+_lib.unwrap_daemon_connect.argtypes = [ctypes.c_char_p]
+_lib.unwrap_daemon_connect.restype = ctypes.c_void_p
+
+_lib.unwrap_daemon_disconnect.argtypes = [ctypes.c_void_p]
+_lib.unwrap_daemon_disconnect.restype = None
+
+_lib.unwrap_daemon_unwrap_file.argtypes = [
+    ctypes.c_void_p,
+    ctypes.c_char_p,
+    ctypes.c_char_p,
+    ctypes.POINTER(CUnwrapParams),
+    ctypes.POINTER(CUnwrapBatchFileStats)
+]
+_lib.unwrap_daemon_unwrap_file.restype = ctypes.c_int
+
+_lib.unwrap_daemon_unwrap.argtypes = [
+    ctypes.c_void_p,
+    ctypes.POINTER(CMesh),
+    ctypes.POINTER(CUnwrapParams),
+    ctypes.POINTER(CUnwrapBatchFileStats)
+]
+_lib.unwrap_daemon_unwrap.restype = ctypes.c_void_p
+
+_lib.mesh_bin_mesh.argtypes = [ctypes.c_void_p]
+_lib.mesh_bin_mesh.restype = ctypes.POINTER(CMesh)
+
+_lib.mesh_bin_result.argtypes = [ctypes.c_void_p]
+_lib.mesh_bin_result.restype = ctypes.POINTER(CUnwrapResult)
+
+_lib.free_mesh_bin.argtypes = [ctypes.c_void_p]
+_lib.free_mesh_bin.restype = None
+
+
+class DaemonClient:
+    """
+    Connection to a running uvunwrapd (see unwrap_daemon.h)
+
+    The daemon keeps warm workers, scratch arenas and the result cache,
+    so small meshes skip the per-process startup cost. Meshes travel
+    through shared memory in the binary mesh layout. Callbacks, 'cancel',
+    'pinned_vertices', 'seam_edges' and 'face_importance' in params are not sent.
+
+    Args:
+        socket_path: Daemon socket (None = the default path)
+
+    Raises:
+        ConnectionError: No daemon listens there
+    """
+
+    def __init__(self, socket_path=None):
+        path = str(socket_path).encode('utf-8') if socket_path is not None else None
+        self._handle = _lib.unwrap_daemon_connect(path)
+        if not self._handle:
+            raise ConnectionError(f"no uvunwrapd listening on {socket_path or 'the default socket'}")
+
+    def unwrap_file(self, input_path, output_path, params=None):
+        """
+        Unwrap one file into another (paths are opened by the daemon)
+
+        Returns:
+            dict: As one entry of unwrap_batch()
+        """
+        c_params = _c_params(params)
+        c_stats = CUnwrapBatchFileStats()
+        status = _lib.unwrap_daemon_unwrap_file(self._handle, str(input_path).encode('utf-8'),
+                                                str(output_path).encode('utf-8'), ctypes.byref(c_params),
+                                                ctypes.byref(c_stats))
+        if status < 0:
+            raise ConnectionError("lost the connection to uvunwrapd")
+        return _batch_stats_dict(c_stats)
+
+    def unwrap(self, mesh, params=None):
+        """
+        Unwrap a mesh in the daemon
+
+        Returns:
+            tuple: (unwrapped_mesh, result_dict) with the fields the binary
+                   mesh format stores (metrics and face_island_ids)
+        """
+        c_params = _c_params(params)
+        c_mesh, _keep = _c_mesh_view(mesh, np.zeros((0, 2), dtype=np.float32))
+        c_mesh.uvs = None
+        c_stats = CUnwrapBatchFileStats()
+        bin_handle = _lib.unwrap_daemon_unwrap(self._handle, ctypes.byref(c_mesh), ctypes.byref(c_params),
+                                               ctypes.byref(c_stats))
+        if not bin_handle:
+            raise RuntimeError(f"UV unwrapping in uvunwrapd failed ({BATCH_STATUS[c_stats.status]})")
+        try:
+            out = _lib.mesh_bin_mesh(bin_handle).contents
+            result = _lib.mesh_bin_result(bin_handle).contents
+            nv, nt = out.num_vertices, out.num_triangles
+            vertices = np.ctypeslib.as_array(out.vertices, shape=(nv * 3,)).reshape(-1, 3).copy()
+            triangles = np.ctypeslib.as_array(out.triangles, shape=(nt * 3,)).reshape(-1, 3).copy()
+            uvs = np.ctypeslib.as_array(out.uvs, shape=(nv * 2,)).reshape(-1, 2).copy()
+            result_dict = {
+                'num_islands': result.num_islands,
+                'avg_stretch': result.avg_stretch,
+                'max_stretch': result.max_stretch,
+                'coverage': result.coverage,
+                'overlap': result.overlap,
+                'num_tiles': result.num_tiles,
+                'solver_iterations': result.solver_iterations,
+                'solver_residual': result.solver_residual,
+                'stretch_l2': result.stretch_l2,
+                'stretch_linf': result.stretch_linf,
+                'angle_distortion': result.angle_distortion,
+                'max_angle_distortion': result.max_angle_distortion,
+                'face_island_ids': np.ctypeslib.as_array(result.face_island_ids, shape=(nt,)).copy(),
+                'daemon': _batch_stats_dict(c_stats),
+            }
+        finally:
+            _lib.free_mesh_bin(bin_handle)
+        return Mesh(vertices, triangles, uvs), result_dict
+
+    def close(self):
+        if self._handle:
+            _lib.unwrap_daemon_disconnect(self._handle)
+            self._handle = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def __del__(self):
+        self.close()
+
+
+_lib.unwrap_cluster_connect.argtypes = [ctypes.POINTER(ctypes.c_char_p), ctypes.c_int]
+_lib.unwrap_cluster_connect.restype = ctypes.c_void_p
+
+_lib.unwrap_cluster_disconnect.argtypes = [ctypes.c_void_p]
+_lib.unwrap_cluster_disconnect.restype = None
+
+_lib.unwrap_cluster_num_workers.argtypes = [ctypes.c_void_p]
+_lib.unwrap_cluster_num_workers.restype = ctypes.c_int
+
+_lib.unwrap_mesh_distributed.argtypes = [
+    ctypes.c_void_p,
+    ctypes.POINTER(CMesh),
+    ctypes.POINTER(CUnwrapParams),
+    ctypes.POINTER(ctypes.POINTER(CUnwrapResult))
+]
+_lib.unwrap_mesh_distributed.restype = ctypes.POINTER(CMesh)
+
+
+class Cluster:
+    """
+    Connections to cluster workers (uvunwrap_worker, see unwrap_cluster.h)
+
+    unwrap() runs topology, seams, packing and metrics here and ships the
+    island solves to the workers; the result is identical to unwrap().
+    Islands of a worker that fails are solved here instead.
+
+    Args:
+        addresses: "host:port" strings; unreachable ones are left out
+
+    Raises:
+        ConnectionError: No worker answered
+    """
+
+    def __init__(self, addresses):
+        encoded = [str(a).encode('utf-8') for a in addresses]
+        c_addresses = (ctypes.c_char_p * max(len(encoded), 1))(*encoded)
+        self._handle = _lib.unwrap_cluster_connect(c_addresses, len(encoded))
+        if not self._handle:
+            raise ConnectionError(f"no unwrap cluster worker answered at {', '.join(map(str, addresses))}")
+
+    @property
+    def num_workers(self):
+        """Workers still in use"""
+        return _lib.unwrap_cluster_num_workers(self._handle) if self._handle else 0
+
+    def unwrap(self, mesh, params=None, plan=None):
+        """
+        Unwrap a mesh across the cluster; same arguments and result as unwrap()
+
+        Raises:
+            UnwrapCancelled: The unwrap was cancelled
+        """
+        c_params = _c_params(params, plan)
+        c_mesh_in, _keep = _c_mesh_view(mesh, np.zeros((0, 2), dtype=np.float32))
+        c_mesh_in.uvs = None
+        c_result_ptr = ctypes.POINTER(CUnwrapResult)()
+        c_mesh_out = _lib.unwrap_mesh_distributed(self._handle, ctypes.byref(c_mesh_in), ctypes.byref(c_params),
+                                                  ctypes.byref(c_result_ptr))
+        if not c_mesh_out and _cancel_requested(c_params):
+            raise UnwrapCancelled("UV unwrapping cancelled")
+        return _take_unwrap_output(c_mesh_out, c_result_ptr)
+
+    def close(self):
+        if self._handle:
+            _lib.unwrap_cluster_disconnect(self._handle)
+            self._handle = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def __del__(self):
+        self.close()
+
+
+class CUnwrapSweepPoint(ctypes.Structure):
+    """
+    Matches UnwrapSweepPoint struct in unwrap_sweep.h
+    """
+    _fields_ = [
+        ('angle_threshold', ctypes.c_float),
+        ('min_island_faces', ctypes.c_int),
+        ('island_margin', ctypes.c_float),
+    ]
+
+
+class CUnwrapSweepResult(ctypes.Structure):
+    """
+    Matches UnwrapSweepResult struct in unwrap_sweep.h
+    """
+    _fields_ = [
+        ('num_islands', ctypes.c_int),
+        ('avg_stretch', ctypes.c_float),
+        ('max_stretch', ctypes.c_float),
+        ('stretch_l2', ctypes.c_float),
+        ('stretch_linf', ctypes.c_float),
+        ('angle_distortion', ctypes.c_float),
+        ('max_angle_distortion', ctypes.c_float),
+        ('coverage', ctypes.c_float),
+        ('overlap', ctypes.c_float),
+    ]
+
+
+class CUnwrapSweepStats(ctypes.Structure):
+    """
+    Matches UnwrapSweepStats struct in unwrap_sweep.h
+    """
+    _fields_ = [
+        ('num_seam_sets', ctypes.c_int),
+        ('num_island_solves', ctypes.c_int),
+        ('total_ns', ctypes.c_longlong),
+    ]
+
+
+# Parameters unwrap_sweep() can vary per combination
+SWEEP_PARAMS = tuple(name for name, _ in CUnwrapSweepPoint._fields_)
+
+_lib.unwrap_sweep.argtypes = [
+    ctypes.POINTER(CMesh),
+    ctypes.POINTER(CUnwrapParams),
+    ctypes.POINTER(CUnwrapSweepPoint),
+    ctypes.c_int,
+    ctypes.POINTER(CUnwrapSweepResult),
+    ctypes.POINTER(CUnwrapSweepStats)
+]
+_lib.unwrap_sweep.restype = ctypes.c_int
+
+
+def unwrap_sweep(mesh, combinations, params=None, plan=None):
+    """
+    Evaluate many parameter combinations natively, sharing the work
+
+    Topology is built once, seams once per angle, and each island is
+    solved once; combinations differing only in margin just re-pack.
+
+    Args:
+        mesh: Mesh object
+        combinations: List of dicts over SWEEP_PARAMS; missing keys come
+                      from params
+        params: Dictionary of the other parameters (num_threads sets
+                the sweep's workers)
+        plan: Optional LscmPlan
+
+    Returns:
+        list: Per-combination dicts with 'num_islands' and the same
+              metric keys as unwrap()
+    """
+    base = params or {}
+    c_params = _c_params(base, plan)
+    n = len(combinations)
+    c_points = (CUnwrapSweepPoint * n)()
+    for c_point, combo in zip(c_points, combinations):
+        c_point.angle_threshold = float(combo.get('angle_threshold', c_params.angle_threshold))
+        c_point.min_island_faces = int(combo.get('min_island_faces', c_params.min_island_faces))
+        c_point.island_margin = float(combo.get('island_margin', c_params.island_margin))
+
+    c_mesh, _keep = _c_mesh_view(mesh, np.zeros((0, 2), dtype=np.float32))
+    c_mesh.uvs = None
+    c_results = (CUnwrapSweepResult * n)()
+    if _lib.unwrap_sweep(ctypes.byref(c_mesh), ctypes.byref(c_params), c_points, n,
+                         c_results, None) != 0:
+        raise RuntimeError("unwrap_sweep failed")
+    return [{name: getattr(r, name) for name, _ in CUnwrapSweepResult._fields_}
+            for r in c_results]
+
+
+_lib.unwrap_session_create.argtypes = [ctypes.POINTER(CMesh), ctypes.POINTER(CUnwrapParams)]
+_lib.unwrap_session_create.restype = ctypes.c_void_p
+
+_lib.unwrap_session_create_frames.argtypes = [ctypes.POINTER(CMesh), ctypes.POINTER(CUnwrapParams), ctypes.c_int]
+_lib.unwrap_session_create_frames.restype = ctypes.c_void_p
+
+_lib.unwrap_session_free.argtypes = [ctypes.c_void_p]
+_lib.unwrap_session_free.restype = None
+
+_lib.unwrap_session_set_seams.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_int),
+                                          ctypes.c_int, ctypes.c_int]
+_lib.unwrap_session_set_seams.restype = ctypes.c_int
+
+_lib.unwrap_session_get_seams.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_int), ctypes.c_int]
+_lib.unwrap_session_get_seams.restype = ctypes.c_int
+
+_lib.unwrap_session_move_vertices.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_int),
+                                              ctypes.POINTER(ctypes.c_float), ctypes.c_int]
+_lib.unwrap_session_move_vertices.restype = ctypes.c_int
+
+_lib.unwrap_session_set_frame.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_float)]
+_lib.unwrap_session_set_frame.restype = ctypes.c_int
+
+_lib.unwrap_session_unwrap.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.POINTER(CUnwrapResult))]
+_lib.unwrap_session_unwrap.restype = ctypes.POINTER(CMesh)
+
+
+class UnwrapSession:
+    """
+    Incremental unwrap of one mesh across seam edits and vertex moves
+
+    Seams start as unwrap() would detect them. unwrap() then solves only
+    the islands an edit changed and repacks; the triangles are fixed.
+    Not thread-safe.
+
+    With frames=True the mesh is frame 0 of an animation: later frames
+    (set_frame()) reuse its pins, orderings and symbolic factorisations
+    and only refactor numerically; warm_start starts CG solves from the
+    previous frame's UVs.
+    """
+
+    def __init__(self, mesh, params=None, plan=None, frames=False, warm_start=False):
+        c_mesh, _keep = _c_mesh_view(mesh, np.zeros((0, 2), dtype=np.float32))
+        c_mesh.uvs = None
+        self._plan = plan
+        self._params = _c_params(params, plan)
+        if frames:
+            self._handle = _lib.unwrap_session_create_frames(ctypes.byref(c_mesh), ctypes.byref(self._params),
+                                                             int(warm_start))
+        else:
+            self._handle = _lib.unwrap_session_create(ctypes.byref(c_mesh), ctypes.byref(self._params))
+        self._num_vertices = c_mesh.num_vertices
+        if not self._handle:
+            raise RuntimeError("unwrap_session_create failed")
+
+    def set_seams(self, edges, is_seam=True):
+        """
+        Mark or clear seams on edges given as (k, 2) vertex pairs
+
+        Returns:
+            int: Number of edges whose seam flag changed
+        """
+        pairs = np.ascontiguousarray(edges, dtype=np.int32).reshape(-1, 2)
+        changed = _lib.unwrap_session_set_seams(
+            self._handle, pairs.ctypes.data_as(ctypes.POINTER(ctypes.c_int)), len(pairs), int(is_seam))
+        if changed < 0:
+            raise ValueError("edge list contains a vertex pair that is not an edge")
+        return changed
+
+    def seams(self):
+        """Current seams as a (k, 2) array of vertex pairs"""
+        count = _lib.unwrap_session_get_seams(self._handle, None, 0)
+        pairs = np.zeros((count, 2), dtype=np.int32)
+        _lib.unwrap_session_get_seams(self._handle, pairs.ctypes.data_as(ctypes.POINTER(ctypes.c_int)), count)
+        return pairs
+
+    def move_vertices(self, indices, positions):
+        """Move vertices (k,) to positions (k, 3)"""
+        idx = np.ascontiguousarray(indices, dtype=np.int32).ravel()
+        pos = np.ascontiguousarray(positions, dtype=np.float32).reshape(-1, 3)
+        if len(idx) != len(pos):
+            raise ValueError("indices and positions differ in length")
+        if _lib.unwrap_session_move_vertices(self._handle, idx.ctypes.data_as(ctypes.POINTER(ctypes.c_int)),
+                                             pos.ctypes.data_as(ctypes.POINTER(ctypes.c_float)),
+                                             len(idx)) != 0:
+            raise ValueError("vertex index out of range")
+
+    def set_frame(self, positions):
+        """Replace every vertex position (num_vertices, 3), e.g. with the next frame"""
+        pos = np.ascontiguousarray(positions, dtype=np.float32).reshape(-1, 3)
+        if len(pos) != self._num_vertices:
+            raise ValueError("expected %d positions, got %d" % (self._num_vertices, len(pos)))
+        if _lib.unwrap_session_set_frame(self._handle, pos.ctypes.data_as(ctypes.POINTER(ctypes.c_float))) != 0:
+            raise RuntimeError("unwrap_session_set_frame failed")
+
+    def unwrap(self):
+        """
+        Unwrap with the current seams and positions
+
+        Returns:
+            tuple: (unwrapped_mesh, result_dict) as from unwrap();
+                   result_dict['stats']['num_solved_islands'] counts the
+                   islands this call solved
+        """
+        c_result_ptr = ctypes.POINTER(CUnwrapResult)()
+        c_mesh_out = _lib.unwrap_session_unwrap(self._handle, ctypes.byref(c_result_ptr))
+        return _take_unwrap_output(c_mesh_out, c_result_ptr)
+
+    def close(self):
+        if self._handle:
+            _lib.unwrap_session_free(self._handle)
+            self._handle = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def __del__(self):
+        self.close()
+
+class CTopologyInfo(ctypes.Structure):
+    """
+    Matches TopologyInfo struct in topology.h
+    """
+    _fields_ = [
+        ('edges', ctypes.POINTER(ctypes.c_int)),
+        ('num_edges', ctypes.c_int),
+        ('edge_faces', ctypes.POINTER(ctypes.c_int)),
+    ]
+
+
+class CIslandInfo(ctypes.Structure):
+    """
+    Matches IslandInfo struct in unwrap.h
+    """
+    _fields_ = [
+        ('num_islands', ctypes.c_int),
+        ('face_island_ids', ctypes.POINTER(ctypes.c_int)),
+        ('island_face_offsets', ctypes.POINTER(ctypes.c_int)),
+        ('island_faces', ctypes.POINTER(ctypes.c_int)),
+    ]
+
+
+class CMeshViewStats(ctypes.Structure):
+    """
+    Matches MeshViewStats struct in mesh_view.h
+    """
+    _fields_ = [
+        ('face_flag_builds', ctypes.c_int),
+        ('topology_builds', ctypes.c_int),
+        ('adjacency_builds', ctypes.c_int),
+        ('manifold_builds', ctypes.c_int),
+        ('seam_builds', ctypes.c_int),
+        ('island_builds', ctypes.c_int),
+        ('boundary_loop_builds', ctypes.c_int),
+    ]
+
+
+_lib.mesh_view_create.argtypes = [ctypes.POINTER(CMesh), ctypes.c_int]
+_lib.mesh_view_create.restype = ctypes.c_void_p
+
+_lib.mesh_view_free.argtypes = [ctypes.c_void_p]
+_lib.mesh_view_free.restype = None
+
+_lib.mesh_view_face_flags.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_int)]
+_lib.mesh_view_face_flags.restype = ctypes.POINTER(ctypes.c_ubyte)
+
+_lib.mesh_view_topology.argtypes = [ctypes.c_void_p]
+_lib.mesh_view_topology.restype = ctypes.POINTER(CTopologyInfo)
+
+_lib.mesh_view_defects.argtypes = [ctypes.c_void_p]
+_lib.mesh_view_defects.restype = ctypes.POINTER(CManifoldReport)
+
+_lib.mesh_view_seams.argtypes = [ctypes.c_void_p, ctypes.c_float, ctypes.c_int, ctypes.POINTER(ctypes.c_int)]
+_lib.mesh_view_seams.restype = ctypes.POINTER(ctypes.c_int)
+
+_lib.mesh_view_islands.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_int), ctypes.c_int]
+_lib.mesh_view_islands.restype = ctypes.POINTER(CIslandInfo)
+
+_lib.mesh_view_stats.argtypes = [ctypes.c_void_p, ctypes.POINTER(CMeshViewStats)]
+_lib.mesh_view_stats.restype = None
+
+_lib.unwrap_mesh_view.argtypes = [ctypes.c_void_p, ctypes.c_void_p, ctypes.POINTER(CUnwrapParams),
+                                  ctypes.POINTER(ctypes.POINTER(CUnwrapResult))]
+_lib.unwrap_mesh_view.restype = ctypes.POINTER(CMesh)
+
+
+class MeshView:
+    """
+    Analyses of one mesh built on first use and kept for later calls
+
+    Topology, face flags, defects, seams (per angle and method) and
+    islands are computed once, so marking seams, counting islands and
+    unwrapping the same mesh share that work. The mesh arrays are copied
+    when the view is created; later changes to mesh are not seen.
+    """
+
+    def __init__(self, mesh, num_threads=0):
+        self._c_mesh, self._keep = _c_mesh_view(mesh, np.zeros((0, 2), dtype=np.float32))
+        self._c_mesh.uvs = None
+        self._handle = _lib.mesh_view_create(ctypes.byref(self._c_mesh), num_threads)
+        if not self._handle:
+            raise RuntimeError("mesh_view_create failed")
+
+    def face_flags(self):
+        """classify_faces() output: uint8 FACE_FLAG_* bits per triangle"""
+        flags = _lib.mesh_view_face_flags(self._handle, None)
+        if not flags:
+            raise RuntimeError("Invalid mesh")
+        return np.ctypeslib.as_array(flags, shape=(self._c_mesh.num_triangles,)).copy()
+
+    def edges(self):
+        """Unique edges as an (E, 2) array of vertex pairs, lower vertex first"""
+        topo = self._topology()
+        return np.ctypeslib.as_array(topo.edges, shape=(topo.num_edges, 2)).copy()
+
+    def defects(self):
+        """Non-manifold counts as unwrap() reports them, in check_manifold()'s dict"""
+        report = _lib.mesh_view_defects(self._handle)
+        if not report:
+            raise RuntimeError("Invalid mesh")
+        return _report_dict(report.contents)
+
+    def seams(self, params=None):
+        """
+        Seams unwrap() would cut with params' angle_threshold and seam_method
+
+        Returns:
+            np.ndarray: (k, 2) vertex pairs
+        """
+        topo = self._topology()
+        edges, count = self._seam_edges(params)
+        if count == 0:
+            return np.zeros((0, 2), dtype=np.int32)
+        index = np.ctypeslib.as_array(edges, shape=(count,))
+        return np.ctypeslib.as_array(topo.edges, shape=(topo.num_edges, 2))[index].copy()
+
+    def islands(self, params=None):
+        """
+        Islands after cutting the seams of params
+
+        Returns:
+            np.ndarray: island id per triangle, islands numbered by lowest face
+        """
+        edges, count = self._seam_edges(params)
+        islands = _lib.mesh_view_islands(self._handle, edges, count)
+        if not islands:
+            raise RuntimeError("mesh_view_islands failed")
+        return np.ctypeslib.as_array(islands.contents.face_island_ids,
+                                     shape=(self._c_mesh.num_triangles,)).copy()
+
+    def stats(self):
+        """How many times each analysis has been built"""
+        stats = CMeshViewStats()
+        _lib.mesh_view_stats(self._handle, ctypes.byref(stats))
+        return {name: getattr(stats, name) for name, _ in CMeshViewStats._fields_}
+
+    def unwrap(self, params=None, plan=None, context=None):
+        """
+        unwrap() of the view's mesh, reusing its topology and seams
+
+        Returns:
+            tuple: (unwrapped_mesh, result_dict) as from unwrap()
+        """
+        c_params = _c_params(params, plan)
+        c_result_ptr = ctypes.POINTER(CUnwrapResult)()
+        c_mesh_out = _lib.unwrap_mesh_view(context._handle if context is not None else None, self._handle,
+                                           ctypes.byref(c_params), ctypes.byref(c_result_ptr))
+        if not c_mesh_out and _cancel_requested(c_params):
+            raise UnwrapCancelled("UV unwrapping cancelled")
+        return _take_unwrap_output(c_mesh_out, c_result_ptr)
+
+    def _topology(self):
+        topo = _lib.mesh_view_topology(self._handle)
+        if not topo:
+            raise RuntimeError("Invalid mesh")
+        return topo.contents
+
+    def _seam_edges(self, params):
+        c_params = _c_params(params)
+        count = ctypes.c_int(0)
+        edges = _lib.mesh_view_seams(self._handle, c_params.angle_threshold, c_params.seam_method,
+                                     ctypes.byref(count))
+        if not edges:
+            raise RuntimeError("mesh_view_seams failed")
+        return edges, count.value
+
+    def close(self):
+        if self._handle:
+            _lib.mesh_view_free(self._handle)
+            self._handle = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def __del__(self):
+        self.close()
+
+
 # Example usage (for testing)
 if __name__ == "__main__":
     # Test loading
@@ -36,13 +36,23 @@ class ParameterOptimizer:
         
         best_value = float('inf') if metric == 'stretch' else 0.0
         best_params = None
+
+        if metric not in ('stretch', 'coverage'):
+            raise ValueError(f"Unknown metric: {metric}")
+
+        # Grids over angle / island size / margin run as one native sweep
+        if set(param_names) <= set(bindings.SWEEP_PARAMS):
+            return self._optimize_sweep(param_names, combinations, metric, verbose)
+        
+        # Islands that recur across combinations reuse their factorisation
+        plan = bindings.LscmPlan()
         
         for i, combo in enumerate(combinations):
             params = dict(zip(param_names, combo))
             
             try:
                 # Unwrap with these parameters
-                unwrapped, _ = bindings.unwrap(self.mesh, params)
+                unwrapped, _ = bindings.unwrap(self.mesh, params, plan=plan)
                 
                 # Compute metric
                 if metric == 'stretch':
@@ -65,4 +75,29 @@ class ParameterOptimizer:
                 if verbose:
                     print(f"[{i+1}/{len(combinations)}] Failed: {e}")
         
+        plan.close()
+        return best_params, best_value
+
+    def _optimize_sweep(self, param_names, combinations, metric, verbose):
+        """optimize() through bindings.unwrap_sweep()"""
+        grid = [dict(zip(param_names, combo)) for combo in combinations]
+        results = bindings.unwrap_sweep(self.mesh, grid)
+
+        best_value = float('inf') if metric == 'stretch' else 0.0
+        best_params = None
+        for i, (params, result) in enumerate(zip(grid, results)):
+            if metric == 'stretch':
+                value = result['max_stretch']
+                is_better = value < best_value
+            else:
+                value = result['coverage']
+                is_better = value > best_value
+
+            if verbose:
+                print(f"[{i+1}/{len(grid)}] Params: {params} -> {metric}={value:.4f}")
+
+            if is_better:
+                best_value = value
+                best_params = params.copy()
+
         return best_params, best_value
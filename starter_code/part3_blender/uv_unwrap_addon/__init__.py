@@ -63,6 +63,12 @@ def register():
         default=True,
     )
     
+    bpy.types.Scene.unwrap_per_corner_uvs = BoolProperty(
+        name="Per-Corner UVs",
+        description="Split seam vertices per island and write each face corner its own UV",
+        default=False,
+    )
+    
     print("UV Unwrap addon registered")
 
 
@@ -76,6 +82,7 @@ def unregister():
     del bpy.types.Scene.unwrap_min_island_faces
     del bpy.types.Scene.unwrap_island_margin
     del bpy.types.Scene.unwrap_pack_islands
+    del bpy.types.Scene.unwrap_per_corner_uvs
     
     print("UV Unwrap addon unregistered")
 
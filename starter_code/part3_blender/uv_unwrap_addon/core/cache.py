@@ -15,6 +15,9 @@ import json
 import hashlib
 from pathlib import Path
 
+_native_configured = False
+
+
 def cache_dir():
     """Return the base cache directory"""
     base = Path.home() / ".cache" / "uv_unwrap_addon"
@@ -22,12 +25,49 @@ def cache_dir():
     return base
 
 
+def _native_bindings():
+    """uvwrap.bindings, or None when the native library cannot be loaded"""
+    try:
+        from uvwrap import bindings
+        return bindings
+    except (ImportError, OSError):
+        return None
+
+
+def _params_digest(params):
+    param_str = json.dumps(params, sort_keys=True)
+    return hashlib.sha256(param_str.encode("utf-8")).hexdigest()[:16]
+
+
+def configure_native_cache(bindings):
+    """
+    Point libuvunwrap's own result cache at ~/.cache/uvunwrap, which the
+    CLI and batch processor can share (unless UVUNWRAP_CACHE_DIR already
+    chooses a directory)
+    """
+    global _native_configured
+    if _native_configured or os.environ.get("UVUNWRAP_CACHE_DIR"):
+        return
+    try:
+        bindings.configure_cache(Path.home() / ".cache" / "uvunwrap")
+    except RuntimeError:
+        pass
+    _native_configured = True
+
+
 def compute_mesh_hash(vertices, triangles, params):
     """
     Create a unique hash for:
       - geometry (verts + faces)
       - unwrap parameters
+
+    Geometry is hashed natively (uv_mesh_hash) when the library is
+    available; only the small parameter string goes through SHA-256.
     """
+    bindings = _native_bindings()
+    if bindings is not None:
+        mesh = bindings.Mesh._wrap(vertices, triangles, None)
+        return f"{bindings.mesh_hash(mesh):016x}-{_params_digest(params)}"
 
     h = hashlib.sha256()
 
@@ -43,6 +83,21 @@ def compute_mesh_hash(vertices, triangles, params):
 
     return h.hexdigest()
 
+
+def compute_topology_hash(triangles, num_vertices):
+    """
+    Hash of connectivity only, for data that survives vertex moves
+    (seams, LSCM plans)
+    """
+    bindings = _native_bindings()
+    if bindings is not None:
+        return f"{bindings.topology_hash(triangles, num_vertices):016x}"
+
+    h = hashlib.sha256()
+    h.update(str(num_vertices).encode("utf-8"))
+    h.update(triangles.tobytes())
+    return h.hexdigest()
+
 def cache_exists(hash_value):
     """Check if cache entry exists"""
     target = cache_dir() / f"{hash_value}.npz"
@@ -7,31 +7,207 @@ Blender operators for UV unwrapping with:
 
 import bpy
 import bmesh
-import tempfile
 import numpy as np
-from pathlib import Path
 
 from .core import cache   # ← NEW
 
 
+# LSCM factorisation cache kept across re-unwraps in this session
+_lscm_plan = None
+
+
+def get_lscm_plan(bindings):
+    global _lscm_plan
+    if _lscm_plan is None:
+        _lscm_plan = bindings.LscmPlan()
+    return _lscm_plan
+
+
+# Incremental unwrap session per object, with the state it last unwrapped
+_sessions = {}
+
+
+# Memoised analyses of each object's last seen geometry
+_views = {}
+
+
+def get_mesh_view(bindings, obj, vertices, triangles):
+    """The object's MeshView, recreated when its geometry changed"""
+    entry = _views.get(obj.name)
+    if entry is not None and (not np.array_equal(entry['vertices'], vertices) or
+                              not np.array_equal(entry['triangles'], triangles)):
+        entry['view'].close()
+        entry = None
+    if entry is None:
+        entry = {
+            'view': bindings.MeshView(bindings.Mesh(vertices, triangles)),
+            'vertices': vertices.copy(),
+            'triangles': triangles.copy(),
+        }
+        _views[obj.name] = entry
+    return entry['view']
+
+
+def extract_seam_edges(obj):
+    """Edges marked as seams in Blender, as a set of (lo, hi) vertex pairs"""
+    return {tuple(sorted(e.vertices[:])) for e in obj.data.edges if e.use_seam}
+
+
+def _pairs(edges):
+    return np.array(sorted(edges), dtype=np.int32).reshape(-1, 2)
+
+
+def session_unwrap(bindings, obj, py_mesh, params):
+    """
+    Unwrap through the object's session, re-solving only what changed
+
+    Seams marked in Blender are cut exactly, without seam detection; an
+    object without any gets detected seams. The session is reused while
+    the triangles and parameters match its last unwrap; vertices moved and
+    seams marked or cleared in Blender since then are passed to it as
+    edits.
+    """
+    seams = extract_seam_edges(obj)
+    entry = _sessions.get(obj.name)
+    if entry is not None and (entry['params'] != params or
+                              not np.array_equal(entry['triangles'], py_mesh.triangles)):
+        entry['session'].close()
+        entry = None
+
+    if entry is None:
+        # Hand-authored seams replace seam detection outright
+        session_params = dict(params, seam_edges=_pairs(seams)) if seams else params
+        session = bindings.UnwrapSession(py_mesh, session_params, plan=get_lscm_plan(bindings))
+    else:
+        session = entry['session']
+        moved = np.nonzero(np.any(entry['vertices'] != py_mesh.vertices, axis=1))[0]
+        if len(moved):
+            session.move_vertices(moved, py_mesh.vertices[moved])
+        session.set_seams(_pairs(seams - entry['seams']), True)
+        session.set_seams(_pairs(entry['seams'] - seams), False)
+
+    _sessions[obj.name] = {
+        'session': session,
+        'params': dict(params),
+        'triangles': py_mesh.triangles.copy(),
+        'vertices': py_mesh.vertices.copy(),
+        'seams': seams,
+    }
+    return session.unwrap()
+
+
 # =========================================================
 # Utility: Extract mesh arrays from Blender object
 # =========================================================
 
-def extract_mesh_data(obj):
-    """Extract vertices and triangles as numpy arrays"""
+def extract_mesh_data(obj, depsgraph=None, with_loops=False):
+    """
+    Vertices and loop triangles as numpy arrays
 
-    mesh = obj.data
-    bm = bmesh.new()
-    bm.from_mesh(mesh)
-    bm.verts.ensure_lookup_table()
-    bm.faces.ensure_lookup_table()
+    Read with foreach_get straight into preallocated float32 / int32
+    buffers, which bindings.Mesh wraps without copying. Topology is always
+    the original mesh's, the one UVs are written to; with a depsgraph the
+    positions come from the evaluated object (shape keys, armatures and
+    other deforming modifiers) while it keeps the vertex count.
 
-    vertices = np.array([v.co[:] for v in bm.verts], dtype=np.float32)
-    triangles = np.array([[v.index for v in f.verts] for f in bm.faces], dtype=np.int32)
+    Returns:
+        (vertices, triangles), plus the (T, 3) loop of every triangle
+        corner with with_loops
+    """
+    mesh = obj.data
+    mesh.calc_loop_triangles()
+
+    source, evaluated = mesh, None
+    if depsgraph is not None:
+        evaluated = obj.evaluated_get(depsgraph)
+        deformed = evaluated.to_mesh()
+        if len(deformed.vertices) == len(mesh.vertices):
+            source = deformed
+    vertices = np.empty((len(mesh.vertices), 3), dtype=np.float32)
+    source.vertices.foreach_get("co", vertices.ravel())
+    if evaluated is not None:
+        evaluated.to_mesh_clear()
+
+    loop_triangles = mesh.loop_triangles
+    triangles = np.empty((len(loop_triangles), 3), dtype=np.int32)
+    loop_triangles.foreach_get("vertices", triangles.ravel())
+    if not with_loops:
+        return vertices, triangles
+    loops = np.empty((len(loop_triangles), 3), dtype=np.int32)
+    loop_triangles.foreach_get("loops", loops.ravel())
+    return vertices, triangles, loops
+
+
+def corner_uvs(unwrapped):
+    """(T, 3, 2) UV of every triangle corner of an unwrap result"""
+    return unwrapped.uvs[unwrapped.triangles]
+
+
+def apply_uvs(obj, uvs, loops=None):
+    """
+    Write UVs to the active UV map with one foreach_set
+
+    uvs is either per vertex of the mesh (loops of vertices it lacks keep
+    their UVs), or per corner, (T, 3, 2) from corner_uvs(), with loops
+    from extract_mesh_data(): each corner then keeps its own island's UV,
+    so seams stay cut.
+    """
+    mesh = obj.data
 
-    bm.free()
-    return vertices, triangles
+    if not mesh.uv_layers:
+        mesh.uv_layers.new(name="UVMap")
+
+    uv_layer = mesh.uv_layers.active
+    loop_uvs = np.empty((len(mesh.loops), 2), dtype=np.float32)
+    uv_layer.data.foreach_get("uv", loop_uvs.ravel())
+
+    uvs = np.asarray(uvs, dtype=np.float32)
+    if loops is not None:
+        loop_uvs[loops.ravel()] = uvs.reshape(-1, 2)
+    else:
+        vertex_index = np.empty(len(mesh.loops), dtype=np.int32)
+        mesh.loops.foreach_get("vertex_index", vertex_index)
+        has_uv = vertex_index < len(uvs)
+        loop_uvs[has_uv] = uvs[vertex_index[has_uv]]
+
+    uv_layer.data.foreach_set("uv", loop_uvs.ravel())
+    mesh.update()
+
+
+def unwrap_object(bindings, obj, params, vertices, triangles, loops):
+    """
+    Unwrap obj straight from its mesh buffers
+
+    vertices, triangles and loops are extract_mesh_data(..., with_loops=True)
+    of obj, read once by the caller for the cache hash. With the scene's
+    per-corner option, seam vertices are split per
+    island (uv_output='split') and the UVs come back per corner;
+    otherwise through the object's session (see session_unwrap()).
+
+    Returns:
+        (uvs, loops, metrics): uvs and loops as apply_uvs() takes them
+    """
+    py_mesh = bindings.Mesh._wrap(vertices, triangles, None)
+    if params.get("uv_output") == "split":
+        seams = extract_seam_edges(obj)
+        unwrap_params = dict(params, seam_edges=_pairs(seams)) if seams else params
+        unwrapped, metrics = bindings.unwrap(py_mesh, unwrap_params, plan=get_lscm_plan(bindings))
+        return corner_uvs(unwrapped), loops, metrics
+    unwrapped, metrics = session_unwrap(bindings, obj, py_mesh, params)
+    return unwrapped.uvs, None, metrics
+
+
+def scene_params(scene):
+    """Unwrap parameters from the scene's add-on settings"""
+    params = {
+        "angle_threshold": scene.unwrap_angle_threshold,
+        "min_island_faces": scene.unwrap_min_island_faces,
+        "pack_islands": scene.unwrap_pack_islands,
+        "island_margin": scene.unwrap_island_margin,
+    }
+    if scene.unwrap_per_corner_uvs:
+        params["uv_output"] = "split"
+    return params
 
 
 # =========================================================
@@ -51,19 +227,18 @@ class UVUNWRAP_OT_unwrap(bpy.types.Operator):
     def execute(self, context):
         try:
             from uvwrap import bindings
+            cache.configure_native_cache(bindings)
 
             obj = context.active_object
+            if obj.mode == 'EDIT':
+                obj.update_from_editmode()
 
             # --------------------------------------------------------------
             # Extract mesh & settings → generate cache hash
             # --------------------------------------------------------------
-            vertices, triangles = extract_mesh_data(obj)
-            params = {
-                "angle_threshold": context.scene.unwrap_angle_threshold,
-                "min_island_faces": context.scene.unwrap_min_island_faces,
-                "pack_islands": context.scene.unwrap_pack_islands,
-                "island_margin": context.scene.unwrap_island_margin,
-            }
+            depsgraph = context.evaluated_depsgraph_get()
+            vertices, triangles, loops = extract_mesh_data(obj, depsgraph, with_loops=True)
+            params = scene_params(context.scene)
 
             h = cache.compute_mesh_hash(vertices, triangles, params)
 
@@ -73,65 +248,30 @@ class UVUNWRAP_OT_unwrap(bpy.types.Operator):
             if cache.cache_exists(h):
                 data = cache.load_cache(h)
                 if data is not None:
-                    self.apply_uvs(obj, data["uvs"])
+                    uvs = data["uvs"]
+                    apply_uvs(obj, uvs, loops if uvs.ndim == 3 else None)
                     self.report({'INFO'}, "Loaded UVs from cache")
                     return {'FINISHED'}
 
             # --------------------------------------------------------------
-            # Otherwise run unwrap normally
+            # Otherwise run unwrap on the mesh buffers, no file round trip
             # --------------------------------------------------------------
-            # Export mesh temporarily
-            with tempfile.TemporaryDirectory() as tmpdir:
-                input_path = Path(tmpdir) / "input.obj"
-                output_path = Path(tmpdir) / "output.obj"
-
-                bpy.ops.object.select_all(action='DESELECT')
-                obj.select_set(True)
+            uvs, loops, metrics = unwrap_object(bindings, obj, params, vertices, triangles, loops)
+            apply_uvs(obj, uvs, loops)
 
-                bpy.ops.export_scene.obj(
-                    filepath=str(input_path),
-                    use_selection=True,
-                    use_materials=False,
-                    use_uvs=False,
-                )
+            # Save to cache
+            cache.save_cache(h, uvs, metrics)
 
-                # Run unwrap using C++ → Python bindings
-                py_mesh = bindings.load_mesh(str(input_path))
-                unwrapped, metrics = bindings.unwrap(py_mesh, params)
+            self.report({'INFO'},
+                        f"Unwrapped (computed): {metrics['num_islands']} islands, "
+                        f"coverage {metrics['coverage'] * 100:.1f}%")
 
-                # Apply back to Blender mesh
-                self.apply_uvs(obj, unwrapped.uvs)
-
-                # Save to cache
-                cache.save_cache(h, unwrapped.uvs, metrics)
-
-                self.report({'INFO'},
-                            f"Unwrapped (computed): {metrics['num_islands']} islands, "
-                            f"coverage {metrics['coverage'] * 100:.1f}%")
-
-                return {'FINISHED'}
+            return {'FINISHED'}
 
         except Exception as e:
             self.report({'ERROR'}, f"Unwrap failed: {e}")
             return {'CANCELLED'}
 
-    # --------------------------------------------------------------
-    # Apply UVs back to Blender mesh
-    # --------------------------------------------------------------
-    def apply_uvs(self, obj, uvs):
-        mesh = obj.data
-
-        if not mesh.uv_layers:
-            mesh.uv_layers.new(name="UVMap")
-
-        uv_layer = mesh.uv_layers.active
-
-        for poly in mesh.polygons:
-            for li in poly.loop_indices:
-                v = mesh.loops[li].vertex_index
-                if v < len(uvs):
-                    uv_layer.data[li].uv = uvs[v]
-
 
 # =========================================================
 # SEAM EDIT OPERATORS
@@ -142,21 +282,31 @@ class UVUNWRAP_OT_mark_seams(bpy.types.Operator):
     bl_label = "Mark Sharp Edges as Seams"
 
     def execute(self, context):
+        from uvwrap import bindings
+
         obj = context.active_object
         mesh = obj.data
 
+        # The seams unwrap would cut at the scene's angle threshold
+        vertices, triangles = extract_mesh_data(obj, context.evaluated_depsgraph_get())
+        view = get_mesh_view(bindings, obj, vertices, triangles)
+        sharp = {tuple(pair) for pair in view.seams({"angle_threshold": context.scene.unwrap_angle_threshold})}
+
         bm = bmesh.new()
         bm.from_mesh(mesh)
         bm.edges.ensure_lookup_table()
 
+        marked = 0
         for e in bm.edges:
-            e.smooth = False   # mark sharp visually
-            e.seam = True      # mark seam UV
+            if tuple(sorted(v.index for v in e.verts)) in sharp:
+                e.smooth = False   # mark sharp visually
+                e.seam = True      # mark seam UV
+                marked += 1
 
         bm.to_mesh(mesh)
         bm.free()
 
-        self.report({'INFO'}, "Marked seams along sharp edges")
+        self.report({'INFO'}, f"Marked {marked} seams along sharp edges")
         return {'FINISHED'}
 
 
@@ -192,6 +342,7 @@ class UVUNWRAP_OT_batch_unwrap(bpy.types.Operator):
 
     def execute(self, context):
         from uvwrap import bindings
+        cache.configure_native_cache(bindings)
 
         meshes = [obj for obj in bpy.data.objects if obj.type == "MESH"]
 
@@ -199,48 +350,36 @@ class UVUNWRAP_OT_batch_unwrap(bpy.types.Operator):
             self.report({'ERROR'}, "No meshes found in scene")
             return {'CANCELLED'}
 
-        params = {
-            "angle_threshold": context.scene.unwrap_angle_threshold,
-            "min_island_faces": context.scene.unwrap_min_island_faces,
-            "pack_islands": context.scene.unwrap_pack_islands,
-            "island_margin": context.scene.unwrap_island_margin,
-        }
+        params = scene_params(context.scene)
 
         processed = 0
+        depsgraph = context.evaluated_depsgraph_get()
 
         for obj in meshes:
-            vertices, triangles = extract_mesh_data(obj)
+            vertices, triangles, loops = extract_mesh_data(obj, depsgraph, with_loops=True)
             h = cache.compute_mesh_hash(vertices, triangles, params)
 
             if cache.cache_exists(h):
                 data = cache.load_cache(h)
                 if data:
-                    self.apply_uvs(obj, data["uvs"])
+                    uvs = data["uvs"]
+                    apply_uvs(obj, uvs, loops if uvs.ndim == 3 else None)
                     processed += 1
                     continue
 
             # Otherwise compute unwrap
-            with tempfile.TemporaryDirectory() as tmpdir:
-                input_path = Path(tmpdir) / "input.obj"
-
-                bpy.ops.object.select_all(action='DESELECT')
-                obj.select_set(True)
-
-                bpy.ops.export_scene.obj(
-                    filepath=str(input_path),
-                    use_selection=True,
-                    use_materials=False,
-                    use_uvs=False,
-                )
-
-                py_mesh = bindings.load_mesh(str(input_path))
-                unwrapped, metrics = bindings.unwrap(py_mesh, params)
+            py_mesh = bindings.Mesh._wrap(vertices, triangles, None)
+            unwrapped, metrics = bindings.unwrap(py_mesh, params, plan=get_lscm_plan(bindings))
+            if params.get("uv_output") == "split":
+                uvs = corner_uvs(unwrapped)
+            else:
+                uvs, loops = unwrapped.uvs, None
 
-                self.apply_uvs(obj, unwrapped.uvs)
+            apply_uvs(obj, uvs, loops)
 
-                cache.save_cache(h, unwrapped.uvs, metrics)
+            cache.save_cache(h, uvs, metrics)
 
-                processed += 1
+            processed += 1
 
         self.report({'INFO'}, f"Batch unwrap completed for {processed} meshes.")
         return {'FINISHED'}
@@ -4,7 +4,7 @@ Blender UI panels for UV unwrapping (with caching, seam tools, batch unwrap)
 
 import bpy
 from .core import cache
-from .operators import extract_mesh_data
+from .operators import extract_mesh_data, scene_params
 
 
 class UVUNWRAP_PT_main(bpy.types.Panel):
@@ -28,6 +28,7 @@ class UVUNWRAP_PT_main(bpy.types.Panel):
         box.prop(scene, "unwrap_min_island_faces")
         box.prop(scene, "unwrap_island_margin")
         box.prop(scene, "unwrap_pack_islands")
+        box.prop(scene, "unwrap_per_corner_uvs")
 
         layout.separator()
 
@@ -78,13 +79,9 @@ class UVUNWRAP_PT_main(bpy.types.Panel):
         box.label(text="Cache Status", icon='FILE_CACHE')
 
         if obj and obj.type == "MESH":
-            verts, tris = extract_mesh_data(obj)
-            params = {
-                "angle_threshold": scene.unwrap_angle_threshold,
-                "min_island_faces": scene.unwrap_min_island_faces,
-                "pack_islands": scene.unwrap_pack_islands,
-                "island_margin": scene.unwrap_island_margin,
-            }
+            # Same positions as the unwrap operator hashes
+            verts, tris = extract_mesh_data(obj, context.evaluated_depsgraph_get())
+            params = scene_params(scene)
 
             h = cache.compute_mesh_hash(verts, tris, params)
 
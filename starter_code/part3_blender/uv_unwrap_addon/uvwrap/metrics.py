@@ -1,100 +1,125 @@
 """
-Quality metrics for UV mappings - Simplified implementation
+Quality metrics for UV mappings
+
+Stretch and angle distortion come from the native kernel
+(bindings.compute_metrics), coverage from the native rasteriser
+(bindings.compute_coverage). Without the native library (not built, or
+built before these entry points existed) stretch and angle distortion
+fall back to whole-mesh NumPy arrays: one batched SVD and one einsum per
+corner, no per-triangle Python loop.
 """
 
 import numpy as np
 
+try:
+    from . import bindings
+except (ImportError, OSError, AttributeError):
+    bindings = None
+
+# Faces below these thresholds are degenerate and skipped, as natively
+_DEGENERATE_UV_DET = 1e-10
+_DEGENERATE_SIGMA = 1e-10
+
+
+def native_available():
+    """True if the metrics run in the native library"""
+    return bindings is not None
+
+
+def _corner_angles(a, b):
+    """Angles (k,) between the rows of two (k, d) edge arrays"""
+    dot = np.einsum('ij,ij->i', a, b)
+    length = np.sqrt(np.einsum('ij,ij->i', a, a) * np.einsum('ij,ij->i', b, b))
+    cos = np.divide(dot, length, out=np.ones_like(dot), where=length > 0.0)
+    return np.arccos(np.clip(cos, -1.0, 1.0))
+
+
+def _face_metrics_numpy(mesh, uvs):
+    """
+    Per-face stretch and angle distortion without the native library
+
+    The same formulas as the native kernel, in double: the Jacobian of
+    the UV→3D map of every face at once, its singular values from one
+    batched SVD, and the corner angles of both triangles.
+    """
+    vertices = np.asarray(mesh.vertices, dtype=np.float64).reshape(-1, 3)
+    tris = np.asarray(mesh.triangles, dtype=np.int64).reshape(-1, 3)
+    uvs = np.asarray(uvs, dtype=np.float64).reshape(-1, 2)
+
+    p0 = vertices[tris[:, 0]]
+    p1 = vertices[tris[:, 1]] - p0
+    p2 = vertices[tris[:, 2]] - p0
+    t0 = uvs[tris[:, 0]]
+    t1 = uvs[tris[:, 1]] - t0
+    t2 = uvs[tris[:, 2]] - t0
+
+    # J = [p1 p2] [t1 t2]^-1, a (3, 2) matrix per face
+    det = t1[:, 0] * t2[:, 1] - t1[:, 1] * t2[:, 0]
+    ok = np.abs(det) >= _DEGENERATE_UV_DET
+    inv_det = np.divide(1.0, det, out=np.zeros_like(det), where=ok)
+    inverse = np.empty((len(tris), 2, 2))
+    inverse[:, 0, 0] = t2[:, 1]
+    inverse[:, 0, 1] = -t2[:, 0]
+    inverse[:, 1, 0] = -t1[:, 1]
+    inverse[:, 1, 1] = t1[:, 0]
+    inverse *= inv_det[:, None, None]
+    edges = np.stack([p1, p2], axis=2)
+    jacobian = np.einsum('fij,fjk->fik', edges, inverse)
+    sigma = np.linalg.svd(jacobian, compute_uv=False)
+    ok &= sigma[:, 1] >= _DEGENERATE_SIGMA
+    stretch = np.divide(sigma[:, 0], sigma[:, 1], out=np.zeros(len(tris)), where=ok)
+
+    # Two corners per space; the third is π minus both
+    a0 = _corner_angles(p1, p2)
+    a1 = _corner_angles(-p1, p2 - p1)
+    u0 = _corner_angles(t1, t2)
+    u1 = _corner_angles(-t1, t2 - t1)
+    error = np.maximum(np.abs(a0 - u0), np.abs(a1 - u1))
+    error = np.maximum(error, np.abs((np.pi - a0 - a1) - (np.pi - u0 - u1)))
+    angle = np.where(ok, error, 0.0)
+
+    return {'stretch': stretch.astype(np.float32), 'angle_distortion': angle.astype(np.float32),
+            'valid': ok}
+
+
+def compute_face_metrics(mesh, uvs=None):
+    """
+    Per-face stretch (σmax/σmin) and angle distortion (radians)
+
+    Returns:
+        dict: 'stretch' and 'angle_distortion', float32 arrays
+              (num_triangles,); degenerate faces get 0
+    """
+    if uvs is None:
+        uvs = mesh.uvs
+    if uvs is None:
+        raise ValueError("Mesh has no UVs")
+    if bindings is None:
+        faces = _face_metrics_numpy(mesh, uvs)
+        return {'stretch': faces['stretch'], 'angle_distortion': faces['angle_distortion']}
+    result = bindings.compute_metrics(mesh, uvs, per_face=True)
+    return {'stretch': result['face_stretch'], 'angle_distortion': result['face_angle_distortion']}
+
 
 def compute_stretch(mesh, uvs):
-    """Compute maximum stretch across all triangles"""
-    max_stretch = 1.0
-    
-    for tri_idx in range(mesh.num_triangles):
-        # Get triangle vertices
-        v0_idx, v1_idx, v2_idx = mesh.triangles[tri_idx]
-        
-        # 3D positions
-        p0 = mesh.vertices[v0_idx]
-        p1 = mesh.vertices[v1_idx]
-        p2 = mesh.vertices[v2_idx]
-        
-        # UV positions
-        uv0 = uvs[v0_idx]
-        uv1 = uvs[v1_idx]
-        uv2 = uvs[v2_idx]
-        
-        # Edge vectors
-        dp1 = p1 - p0
-        dp2 = p2 - p0
-        duv1 = uv1 - uv0
-        duv2 = uv2 - uv0
-        
-        # Build Jacobian matrix
-        try:
-            # UV->3D mapping: J = [dp1, dp2] @ inv([[duv1], [duv2]])
-            uv_mat = np.column_stack([duv1, duv2])
-            if np.linalg.det(uv_mat) == 0:
-                continue
-            
-            pos_mat = np.column_stack([dp1, dp2])
-            J = pos_mat @ np.linalg.inv(uv_mat)
-            
-            # Compute SVD
-            _, s, _ = np.linalg.svd(J, full_matrices=False)
-            if len(s) >= 2 and s[1] > 1e-8:
-                stretch = max(s[0] / s[1], s[1] / s[0])
-                max_stretch = max(max_stretch, stretch)
-        except:
-            pass
-    
-    return float(max_stretch)
+    """Compute maximum stretch (σmax/σmin) across all triangles"""
+    if bindings is None:
+        faces = _face_metrics_numpy(mesh, uvs)
+        return float(faces['stretch'].max()) if faces['valid'].any() else 1.0
+    return float(bindings.compute_metrics(mesh, uvs)['max_stretch'])
 
 
 def compute_coverage(uvs, triangles, resolution=256):
-    """Compute UV coverage percentage"""
-    grid = np.zeros((resolution, resolution), dtype=bool)
-    
-    for tri in triangles:
-        uv0 = np.clip(uvs[tri[0]] * resolution, 0, resolution-1).astype(int)
-        uv1 = np.clip(uvs[tri[1]] * resolution, 0, resolution-1).astype(int)
-        uv2 = np.clip(uvs[tri[2]] * resolution, 0, resolution-1).astype(int)
-        
-        # Simple bounding box rasterization
-        min_x = max(0, min(uv0[0], uv1[0], uv2[0]))
-        max_x = min(resolution-1, max(uv0[0], uv1[0], uv2[0]))
-        min_y = max(0, min(uv0[1], uv1[1], uv2[1]))
-        max_y = min(resolution-1, max(uv0[1], uv1[1], uv2[1]))
-        
-        # Mark pixels in bounding box
-        grid[min_y:max_y+1, min_x:max_x+1] = True
-    
-    return float(np.sum(grid) / (resolution * resolution))
+    """Compute UV coverage (fraction of [0,1]² texels covered)"""
+    if bindings is None:
+        raise RuntimeError("UV coverage needs the native uvunwrap library")
+    uvs = np.asarray(uvs, dtype=np.float32)
+    mesh = bindings.Mesh(np.zeros((len(uvs), 3), dtype=np.float32), triangles, uvs)
+    return float(bindings.compute_coverage(mesh, resolution=resolution)['coverage'])
 
 
 def compute_angle_distortion(mesh, uvs):
-    """Compute maximum angle distortion"""
-    max_distortion = 0.0
-    
-    for tri_idx in range(mesh.num_triangles):
-        v0_idx, v1_idx, v2_idx = mesh.triangles[tri_idx]
-        
-        # 3D triangle
-        p0, p1, p2 = mesh.vertices[v0_idx], mesh.vertices[v1_idx], mesh.vertices[v2_idx]
-        e0_3d = p1 - p0
-        e1_3d = p2 - p0
-        
-        # UV triangle
-        uv0, uv1, uv2 = uvs[v0_idx], uvs[v1_idx], uvs[v2_idx]
-        e0_2d = uv1 - uv0
-        e1_2d = uv2 - uv0
-        
-        # Compute angle at vertex 0
-        try:
-            angle_3d = np.arccos(np.clip(np.dot(e0_3d, e1_3d) / (np.linalg.norm(e0_3d) * np.linalg.norm(e1_3d)), -1, 1))
-            angle_2d = np.arccos(np.clip(np.dot(e0_2d, e1_2d) / (np.linalg.norm(e0_2d) * np.linalg.norm(e1_2d)), -1, 1))
-            distortion = abs(angle_3d - angle_2d)
-            max_distortion = max(max_distortion, distortion)
-        except:
-            pass
-    
-    return float(max_distortion)
+    """Compute maximum angle distortion (radians) over all corners"""
+    if bindings is None:
+        return float(_face_metrics_numpy(mesh, uvs)['angle_distortion'].max(initial=0.0))
+    return float(bindings.compute_metrics(mesh, uvs)['max_angle_distortion'])
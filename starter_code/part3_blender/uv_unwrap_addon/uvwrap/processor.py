@@ -1,93 +1,238 @@
 """
-Multi-threaded batch processor - Simplified implementation
+Batch processor: the native unwrap_batch() pipeline, or a process pool
 """
 
-from concurrent.futures import ThreadPoolExecutor, as_completed
+import concurrent.futures
+import multiprocessing
 import threading
 import time
 import os
+from multiprocessing import resource_tracker, shared_memory
 from pathlib import Path
+
+import numpy as np
+
 from . import bindings, metrics
 
+EXECUTORS = ('native', 'process')
+
+# Shared-memory mesh block, laid out like a binary mesh file (mesh_bin.h):
+# an int64 header (num_vertices, num_triangles), then float32 vertices and
+# int32 triangles, each section starting on a 64-byte boundary
+_SECTION_ALIGN = 64
+
+# Parameters that hold callables or ctypes objects and cannot be sent
+_LOCAL_PARAMS = ('progress', 'cancel')
+
+# Per-process worker state, set up once by _worker_init()
+_worker = None
+
+
+def _align(offset):
+    return (offset + _SECTION_ALIGN - 1) // _SECTION_ALIGN * _SECTION_ALIGN
+
+
+def _mesh_sections(num_vertices, num_triangles):
+    """Byte offsets of the vertices and triangles, and the block size"""
+    vertices_at = _SECTION_ALIGN
+    triangles_at = _align(vertices_at + num_vertices * 12)
+    return vertices_at, triangles_at, _align(triangles_at + num_triangles * 12)
+
+
+def _share_mesh(mesh):
+    """Copy mesh into a new shared-memory block; the caller unlinks it"""
+    nv, nt = mesh.num_vertices, mesh.num_triangles
+    vertices_at, triangles_at, size = _mesh_sections(nv, nt)
+    shm = shared_memory.SharedMemory(create=True, size=size)
+    np.ndarray((2,), np.int64, shm.buf)[:] = (nv, nt)
+    np.ndarray((nv, 3), np.float32, shm.buf, vertices_at)[:] = mesh.vertices
+    np.ndarray((nt, 3), np.int32, shm.buf, triangles_at)[:] = mesh.triangles
+    return shm
+
+
+def _worker_init():
+    """Process pool initializer: load libuvunwrap and keep warm state"""
+    global _worker
+    _worker = {'plan': bindings.LscmPlan(), 'context': bindings.UnwrapContext()}
+
+
+def _worker_unwrap(name, output_path, params):
+    """Unwrap the shared mesh called name and save it; returns batch stats"""
+    shm = shared_memory.SharedMemory(name=name)
+    if os.name == 'posix':
+        # The parent owns the block; only it may unlink it
+        resource_tracker.unregister(shm._name, 'shared_memory')
+    try:
+        nv, nt = (int(n) for n in np.ndarray((2,), np.int64, shm.buf))
+        vertices_at, triangles_at, _ = _mesh_sections(nv, nt)
+        mesh = bindings.Mesh._wrap(np.ndarray((nv, 3), np.float32, shm.buf, vertices_at),
+                                   np.ndarray((nt, 3), np.int32, shm.buf, triangles_at), None)
+        start = time.perf_counter()
+        try:
+            out, result = bindings.unwrap(mesh, params, _worker['plan'], _worker['context'])
+        except RuntimeError:
+            return {'status': 'unwrap_failed'}
+        finally:
+            del mesh  # the views must go before the mapping closes
+        unwrapped = time.perf_counter()
+        try:
+            bindings.save_mesh(out, output_path)
+        except RuntimeError:
+            return {'status': 'save_failed'}
+        return {
+            'status': 'ok',
+            'vertices': nv,
+            'triangles': nt,
+            'unwrap_time': unwrapped - start,
+            'save_time': time.perf_counter() - unwrapped,
+            'num_islands': result['num_islands'],
+            'avg_stretch': result['avg_stretch'],
+            'max_stretch': result['max_stretch'],
+            'coverage': result['coverage'],
+        }
+    finally:
+        shm.close()
+
 
 class UnwrapProcessor:
-    """Multi-threaded UV unwrapping batch processor"""
+    """UV unwrapping batch processor"""
 
     def __init__(self, num_threads=None):
         self.num_threads = num_threads or os.cpu_count()
         self.progress_lock = threading.Lock()
         self.completed = 0
 
-    def process_batch(self, input_files, output_dir, params, on_progress=None):
-        """Process multiple meshes in parallel"""
+    def process_batch(self, input_files, output_dir, params, on_progress=None,
+                      prefetch=0, memory_budget=0, executor='native', mp_context=None,
+                      histograms=False, numa='none'):
+        """Process multiple meshes in parallel
+
+        prefetch and memory_budget bound the native pipeline, and numa
+        places its workers, see bindings.unwrap_batch(). With histograms the result also holds the
+        native pipeline's distributions under 'histograms' (None with the
+        process executor, which does not collect them).
+
+        executor='process' unwraps in a pool of num_threads worker
+        processes instead, each loading libuvunwrap once and keeping its
+        LSCM plan and scratch context between meshes. This process loads
+        the meshes and hands them over in shared memory, at most
+        num_threads + prefetch at a time; the workers unwrap and save.
+        'progress' and 'cancel' in params stay here, and each worker
+        solves single-threaded unless params sets 'num_threads'.
+        mp_context is a multiprocessing context (default: spawn).
+        """
+        if executor not in EXECUTORS:
+            raise ValueError(f"executor must be one of {EXECUTORS}, not {executor!r}")
         os.makedirs(output_dir, exist_ok=True)
         
-        results = []
         total = len(input_files)
         self.completed = 0
         start_time = time.time()
-        
-        with ThreadPoolExecutor(max_workers=self.num_threads) as executor:
-            # Submit all tasks
-            futures = {
-                executor.submit(self._process_single, f, output_dir, params): f
-                for f in input_files
-            }
-            
-            # Collect results as they complete
-            for future in as_completed(futures):
-                filename = futures[future]
-                try:
-                    result = future.result()
-                    results.append(result)
-                except Exception as e:
-                    results.append({'file': filename, 'error': str(e)})
-                
-                # Update progress (thread-safe)
-                with self.progress_lock:
-                    self.completed += 1
-                    if on_progress:
-                        on_progress(self.completed, total, Path(filename).name)
+
+        outputs = [str(Path(output_dir) / Path(f).name) for f in input_files]
+
+        def progress(done, total, index, status):
+            with self.progress_lock:
+                self.completed = done
+                if on_progress:
+                    on_progress(done, total, Path(input_files[index]).name)
+
+        distributions = None
+        if executor == 'process':
+            files = self._process_pool(input_files, outputs, params, progress, prefetch, mp_context)
+        else:
+            # Loading, unwrapping and saving are pipelined natively; only
+            # the progress callback comes back into Python
+            files = bindings.unwrap_batch(input_files, outputs, params,
+                                          num_threads=self.num_threads, on_progress=progress,
+                                          prefetch=prefetch, memory_budget=memory_budget,
+                                          histograms=histograms, numa=numa)
+            if histograms:
+                files, distributions = files
+        results = [self._file_result(f, stats) for f, stats in zip(input_files, files)]
         
         total_time = time.time() - start_time
         summary = self._compute_summary(results, total_time)
         
-        return {
+        batch = {
             'summary': summary,
             'files': results
         }
+        if histograms:
+            batch['histograms'] = distributions
+        return batch
 
-    def _process_single(self, input_path, output_dir, params):
-        """Process single file"""
-        start_time = time.time()
-        
-        # Load mesh
-        mesh = bindings.load_mesh(input_path)
-        
-        # Unwrap
-        unwrapped, result_metrics = bindings.unwrap(mesh, params)
-        
-        # Compute detailed metrics
-        stretch = metrics.compute_stretch(unwrapped, unwrapped.uvs)
-        coverage = metrics.compute_coverage(unwrapped.uvs, unwrapped.triangles)
-        
-        # Save output
-        output_path = Path(output_dir) / Path(input_path).name
-        bindings.save_mesh(unwrapped, str(output_path))
-        
-        elapsed = time.time() - start_time
-        
+    def _process_pool(self, input_files, outputs, params, progress, prefetch, mp_context):
+        """Per-file batch stats from a pool of worker processes"""
+        params = {k: v for k, v in (params or {}).items() if k not in _LOCAL_PARAMS}
+        params.setdefault('num_threads', 1)
+        total = len(input_files)
+        files = [None] * total
+        in_flight = {}
+        max_in_flight = self.num_threads + max(prefetch, 0)
+        done = 0
+
+        def finish(index, stats):
+            nonlocal done
+            files[index] = stats
+            done += 1
+            progress(done, total, index, stats['status'])
+
+        def drain():
+            # Wait for at least one mesh, then release its block
+            ready, _ = concurrent.futures.wait(in_flight, return_when=concurrent.futures.FIRST_COMPLETED)
+            for future in ready:
+                index, shm, load_time = in_flight.pop(future)
+                shm.close()
+                shm.unlink()
+                try:
+                    stats = future.result()
+                except Exception:
+                    # The worker died; the pool is broken for the rest too
+                    stats = {'status': 'unwrap_failed'}
+                stats['load_time'] = load_time
+                finish(index, stats)
+
+        context = mp_context or multiprocessing.get_context('spawn')
+        with concurrent.futures.ProcessPoolExecutor(self.num_threads, mp_context=context,
+                                                    initializer=_worker_init) as pool:
+            try:
+                for index, (input_path, output_path) in enumerate(zip(input_files, outputs)):
+                    while len(in_flight) >= max_in_flight:
+                        drain()
+                    start = time.perf_counter()
+                    try:
+                        mesh = bindings.load_mesh(input_path)
+                    except RuntimeError:
+                        finish(index, {'status': 'load_failed'})
+                        continue
+                    shm = _share_mesh(mesh)
+                    load_time = time.perf_counter() - start
+                    future = pool.submit(_worker_unwrap, shm.name, output_path, params)
+                    in_flight[future] = (index, shm, load_time)
+                while in_flight:
+                    drain()
+            finally:
+                for _, shm, _ in in_flight.values():
+                    shm.close()
+                    shm.unlink()
+        return files
+
+    def _file_result(self, input_path, stats):
+        """Per-file entry from the native batch statistics"""
+        if stats['status'] != 'ok':
+            return {'file': str(input_path), 'error': stats['status']}
         return {
             'file': str(input_path),
-            'vertices': mesh.num_vertices,
-            'triangles': mesh.num_triangles,
-            'time': elapsed,
+            'vertices': stats['vertices'],
+            'triangles': stats['triangles'],
+            'time': stats['load_time'] + stats['unwrap_time'] + stats['save_time'],
             'metrics': {
-                'num_islands': result_metrics['num_islands'],
-                'stretch': stretch,
-                'coverage': coverage,
-                'avg_stretch': result_metrics['avg_stretch'],
-                'max_stretch': result_metrics['max_stretch'],
+                'num_islands': stats['num_islands'],
+                'stretch': stats['max_stretch'],
+                'coverage': stats['coverage'],
+                'avg_stretch': stats['avg_stretch'],
+                'max_stretch': stats['max_stretch'],
             }
         }
 